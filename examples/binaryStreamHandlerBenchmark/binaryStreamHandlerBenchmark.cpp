@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ */
+
+/**
+ * \file   binaryStreamHandlerBenchmark.cpp
+ *         Measure the time to write and load a large matrix and a trained
+ *         kd-tree with lti::lispStreamHandler and lti::binaryStreamHandler,
+ *         and the size of the files.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include <ltiLispStreamHandler.h>
+#include <ltiBinaryStreamHandler.h>
+#include <ltiMatrix.h>
+#include <ltiKdTree.h>
+#include <ltiTimer.h>
+#include <ltiMath.h>
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+
+typedef lti::kdTree<lti::dvector,int> tree_type;
+
+/**
+ * Fill the matrix with random values in [0,1]
+ */
+void randomFill(lti::dmatrix& m) {
+  for (int i=0;i<m.rows();++i) {
+    for (int j=0;j<m.columns();++j) {
+      m.at(i,j)=static_cast<double>(std::rand())/RAND_MAX;
+    }
+  }
+}
+
+/**
+ * Write the object into the given file with the given handler type, and
+ * return the time in ms
+ */
+template<class H,class T>
+double save(const T& obj,const std::string& file,bool& ok) {
+  lti::timer chron(lti::timer::Wall);
+  chron.start();
+  std::ofstream out(file.c_str(),std::ios::out | std::ios::binary);
+  H handler(out);
+  ok = obj.write(handler);
+  out.close();
+  chron.stop();
+  return chron.getTime()/1000.0;
+}
+
+/**
+ * Load the object from the given file with the given handler type, and
+ * return the time in ms
+ */
+template<class H,class T>
+double load(T& obj,const std::string& file,bool& ok) {
+  lti::timer chron(lti::timer::Wall);
+  chron.start();
+  std::ifstream in(file.c_str(),std::ios::in | std::ios::binary);
+  H handler(in);
+  ok = obj.read(handler);
+  chron.stop();
+  return chron.getTime()/1000.0;
+}
+
+/**
+ * Size of the given file in MB
+ */
+double fileSize(const std::string& file) {
+  std::ifstream in(file.c_str(),std::ios::in | std::ios::binary);
+  in.seekg(0,std::ios::end);
+  return static_cast<double>(in.tellg())/(1024.0*1024.0);
+}
+
+/**
+ * Largest difference between the elements of the original matrix and the
+ * loaded one.  The lisp handler writes doubles with 16 significant digits.
+ */
+double difference(const lti::dmatrix& a,const lti::dmatrix& b,
+                  const lti::dmatrix&) {
+  if (a.size() != b.size()) {
+    return -1.0;
+  }
+  double diff = 0.0;
+  for (int i=0;i<a.rows();++i) {
+    for (int j=0;j<a.columns();++j) {
+      diff = lti::max(diff,lti::abs(a.at(i,j)-b.at(i,j)));
+    }
+  }
+  return diff;
+}
+
+/**
+ * Largest difference between the distances to the nearest neighbors of the
+ * keys found in the original tree and in the loaded one
+ */
+double difference(const tree_type& a,const tree_type& b,
+                  const lti::dmatrix& keys) {
+  if (a.size() != b.size()) {
+    return -1.0;
+  }
+  double diff = 0.0;
+  for (int i=0;i<keys.rows();++i) {
+    tree_type::element* ea;
+    tree_type::element* eb;
+    double da,db;
+    if (!a.searchNearest(keys.getRow(i),ea,da) ||
+        !b.searchNearest(keys.getRow(i),eb,db)) {
+      return -1.0;
+    }
+    diff = lti::max(diff,lti::abs(da-db));
+  }
+  return diff;
+}
+
+/**
+ * Write and load the object reps times with the handler type H and report
+ * the mean times, the size of the file and the largest difference of the
+ * loaded copies (-1 if the copy could not be loaded)
+ */
+template<class H,class T>
+void benchmark(const char* object,
+               const char* handler,
+               const T& obj,
+               const lti::dmatrix& keys,
+               const std::string& file,
+               const int reps) {
+  double writeTime = 0.0;
+  double loadTime = 0.0;
+  double diff = 0.0;
+  for (int i=0;(i<reps) && (diff >= 0.0);++i) {
+    bool w,r;
+    T copy;
+    writeTime += save<H>(obj,file,w);
+    loadTime += load<H>(copy,file,r);
+    diff = (w && r) ? lti::max(diff,difference(obj,copy,keys)) : -1.0;
+  }
+
+  std::cout << std::setw(8) << object
+            << std::setw(8) << handler
+            << std::setprecision(1) << std::fixed
+            << std::setw(12) << writeTime/reps
+            << std::setw(12) << loadTime/reps
+            << std::setw(10) << fileSize(file)
+            << std::setw(10) << std::setprecision(1) << std::scientific
+            << diff << std::endl;
+
+  std::remove(file.c_str());
+}
+
+void usage() {
+  std::cout << "Usage: binaryStreamHandlerBenchmark [-r rows] [-c columns] "
+            << "[-p points] [-d dimensions] [-n repetitions] "
+            << "[-o directory]\n"
+            << "  -r rows         rows of the matrix (default 2000)\n"
+            << "  -c columns      columns of the matrix (default 500)\n"
+            << "  -p points       points in the kd-tree (default 20000)\n"
+            << "  -d dimensions   dimension of the points (default 16)\n"
+            << "  -n repetitions  writes and loads of each object "
+            << "(default 3)\n"
+            << "  -o directory    where the files are written "
+            << "(default .)\n"
+            << "  -h              this help" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  int rows = 2000;
+  int cols = 500;
+  int points = 20000;
+  int dim = 16;
+  int reps = 3;
+  std::string dir = ".";
+
+  int c;
+  while ((c = getopt(argc,argv,"r:c:p:d:n:o:h")) != -1) {
+    switch (c) {
+    case 'r':
+      rows = std::atoi(optarg);
+      break;
+    case 'c':
+      cols = std::atoi(optarg);
+      break;
+    case 'p':
+      points = std::atoi(optarg);
+      break;
+    case 'd':
+      dim = std::atoi(optarg);
+      break;
+    case 'n':
+      reps = std::atoi(optarg);
+      break;
+    case 'o':
+      dir = optarg;
+      break;
+    default:
+      usage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  if ((rows < 1) || (cols < 1) || (points < 1) || (dim < 1) || (reps < 1)) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  lti::dmatrix mat(rows,cols);
+  randomFill(mat);
+
+  lti::dmatrix pts(points,dim);
+  randomFill(pts);
+  tree_type tree;
+  for (int i=0;i<pts.rows();++i) {
+    tree.add(pts.getRow(i),i);
+  }
+  tree.build(16);
+
+  lti::dmatrix keys(100,dim);
+  randomFill(keys);
+
+  std::cout << rows << "x" << cols << " matrix, kd-tree with " << points
+            << " points of dimension " << dim << ", " << reps
+            << " repetitions" << std::endl << std::endl;
+  std::cout << std::setw(8) << "object"
+            << std::setw(8) << "handler"
+            << std::setw(12) << "write ms"
+            << std::setw(12) << "load ms"
+            << std::setw(10) << "MB"
+            << std::setw(10) << "diff" << std::endl;
+
+  const std::string file = dir + "/binaryStreamHandlerBenchmark.tmp";
+
+  benchmark<lti::lispStreamHandler>("matrix","lisp",mat,keys,file,reps);
+  benchmark<lti::binaryStreamHandler>("matrix","binary",mat,keys,file,reps);
+  benchmark<lti::lispStreamHandler>("kdTree","lisp",tree,keys,file,reps);
+  benchmark<lti::binaryStreamHandler>("kdTree","binary",tree,keys,file,reps);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ */
+
+/**
+ * \file   kdTreeBenchmark.cpp
+ *         Measure the build time, query latency and memory consumption of
+ *         the linked and flat layouts of lti::kdTree.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include <ltiKdTree.h>
+#include <ltiTimer.h>
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <malloc.h>
+#include <getopt.h>
+
+typedef lti::kdTree<lti::fvector,int> tree_type;
+
+/**
+ * Bytes currently allocated on the heap
+ */
+double heapInUse() {
+#if defined(__GLIBC__) && \
+    ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33)))
+  return static_cast<double>(mallinfo2().uordblks);
+#else
+  return static_cast<double>(mallinfo().uordblks);
+#endif
+}
+
+/**
+ * Fill the matrix with random values in [0,1]
+ */
+void randomFill(lti::fmatrix& m) {
+  for (int i=0;i<m.rows();++i) {
+    for (int j=0;j<m.columns();++j) {
+      m.at(i,j)=static_cast<float>(std::rand())/RAND_MAX;
+    }
+  }
+}
+
+/**
+ * Build a tree with the given layout and report its statistics
+ */
+void benchmark(const char* name,
+               const tree_type::eLayoutType layout,
+               const lti::fmatrix& points,
+               const lti::fmatrix& keys,
+               const int k,
+               const int bucketSize) {
+  lti::timer chron(lti::timer::Wall);
+  const int n = keys.rows();
+
+  const double heapBefore = heapInUse();
+  tree_type* tree = new tree_type;
+  for (int i=0;i<points.rows();++i) {
+    tree->add(points.getRow(i),i);
+  }
+
+  chron.start();
+  tree->build(bucketSize,layout);
+  chron.stop();
+  const double buildTime = chron.getTime()/1000.0;
+  const double bytes = (heapInUse()-heapBefore)/points.rows();
+
+  // the radius that contains on average about k points
+  tree_type::mmap_type neighbors;
+  double radius = 0.0;
+  int i;
+  for (i=0;i<n;++i) {
+    tree->searchNearest(k,keys.getRow(i),neighbors);
+    radius += neighbors.rbegin()->first;
+  }
+  radius /= n;
+
+  chron.start();
+  for (i=0;i<n;++i) {
+    tree->searchNearest(k,keys.getRow(i),neighbors);
+  }
+  chron.stop();
+  const double knnTime = chron.getTime()/n;
+
+  chron.start();
+  for (i=0;i<n;++i) {
+    tree->searchBestBinFirst(k,keys.getRow(i),100,neighbors);
+  }
+  chron.stop();
+  const double bbfTime = chron.getTime()/n;
+
+  std::list<tree_type::element*> within;
+  chron.start();
+  for (i=0;i<n;++i) {
+    tree->searchWithin(keys.getRow(i),radius,within);
+  }
+  chron.stop();
+  const double withinTime = chron.getTime()/n;
+
+  delete tree;
+
+  std::cout << std::setw(8) << name
+            << std::setw(12) << std::setprecision(4) << buildTime
+            << std::setw(12) << knnTime
+            << std::setw(12) << bbfTime
+            << std::setw(12) << withinTime
+            << std::setw(12) << bytes << std::endl;
+}
+
+void usage() {
+  std::cout << "Usage: kdTreeBenchmark [-n points] [-d dim] [-k neighbors] "
+            << "[-b bucket] [-q queries]\n"
+            << "  -n points     number of points in the tree (default 100000)\n"
+            << "  -d dim        dimension of the points (default 16)\n"
+            << "  -k neighbors  number of neighbors searched (default 5)\n"
+            << "  -b bucket     bucket size of the leaves (default 16)\n"
+            << "  -q queries    number of queries (default 2000)\n"
+            << "  -h            this help" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  int numPoints = 100000;
+  int dim = 16;
+  int k = 5;
+  int bucketSize = 16;
+  int numQueries = 2000;
+
+  int c;
+  while ((c = getopt(argc,argv,"n:d:k:b:q:h")) != -1) {
+    switch (c) {
+    case 'n':
+      numPoints = std::atoi(optarg);
+      break;
+    case 'd':
+      dim = std::atoi(optarg);
+      break;
+    case 'k':
+      k = std::atoi(optarg);
+      break;
+    case 'b':
+      bucketSize = std::atoi(optarg);
+      break;
+    case 'q':
+      numQueries = std::atoi(optarg);
+      break;
+    default:
+      usage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  if ((numPoints < k) || (dim < 1) || (k < 1) || (bucketSize < 1) ||
+      (numQueries < 1)) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  lti::fmatrix points(numPoints,dim);
+  lti::fmatrix keys(numQueries,dim);
+  randomFill(points);
+  randomFill(keys);
+
+  std::cout << numPoints << " points of dimension " << dim
+            << ", " << k << " neighbors, bucket size " << bucketSize
+            << std::endl << std::endl;
+  std::cout << std::setw(8) << "layout"
+            << std::setw(12) << "build ms"
+            << std::setw(12) << "knn us"
+            << std::setw(12) << "bbf us"
+            << std::setw(12) << "within us"
+            << std::setw(12) << "bytes/pt" << std::endl;
+
+  benchmark("linked",tree_type::Linked,points,keys,k,bucketSize);
+  benchmark("flat",tree_type::Flat,points,keys,k,bucketSize);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ */
+
+/**
+ * \file   matrixMultiplyBenchmark.cpp
+ *         Measure the GFLOP/s of lti::matrix<T>::multiply() against the
+ *         former implementation (transpose the second factor and compute
+ *         the dot products of the rows).
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include <ltiMatrix.h>
+#include <ltiGemm.h>
+#include <ltiTimer.h>
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <cmath>
+#include <getopt.h>
+
+/**
+ * Former implementation of the matrix product for large matrices
+ */
+template<typename T>
+void referenceMultiply(const lti::matrix<T>& a,
+                       const lti::matrix<T>& b,
+                       lti::matrix<T>& c) {
+  lti::matrix<T> bt;
+  bt.transpose(b);
+  c.allocate(a.rows(),b.columns());
+  for (int i=0;i<c.rows();++i) {
+    for (int j=0;j<c.columns();++j) {
+      c.at(i,j)=a.getRow(i).dot(bt.getRow(j));
+    }
+  }
+}
+
+/**
+ * Fill the matrix with random values in [-1,1]
+ */
+template<typename T>
+void randomFill(lti::matrix<T>& m) {
+  for (int i=0;i<m.rows();++i) {
+    for (int j=0;j<m.columns();++j) {
+      m.at(i,j)=static_cast<T>(2.0*std::rand()/RAND_MAX-1.0);
+    }
+  }
+}
+
+/**
+ * Repeat the product until at least 0.2 seconds have elapsed and
+ * return the time per product in microseconds.
+ */
+template<typename T>
+double measure(const lti::matrix<T>& a,
+               const lti::matrix<T>& b,
+               lti::matrix<T>& c,
+               const bool reference) {
+  lti::timer chron(lti::timer::Wall);
+  int reps = 0;
+  chron.start();
+  do {
+    if (reference) {
+      referenceMultiply(a,b,c);
+    } else {
+      c.multiply(a,b);
+    }
+    ++reps;
+  } while (chron.getTime() < 200000.0);
+  chron.stop();
+  return chron.getTime()/reps;
+}
+
+/**
+ * Run the benchmark for one type
+ */
+template<typename T>
+void benchmark(const std::string& typeName,
+               const int maxSize,
+               const int maxReferenceSize) {
+  std::cout << std::endl << typeName << std::endl;
+  std::cout << std::setw(6) << "size"
+            << std::setw(14) << "former GF/s"
+            << std::setw(14) << "new GF/s"
+            << std::setw(10) << "speedup"
+            << std::setw(14) << "max. rel.err" << std::endl;
+
+  for (int n=32;n<=maxSize;n*=2) {
+    lti::matrix<T> a(n,n),b(n,n),c,r;
+    randomFill(a);
+    randomFill(b);
+
+    const double flops = 2.0*n*n*n;
+    const double tnew = measure(a,b,c,false);
+
+    std::cout << std::setw(6) << n;
+    if (n <= maxReferenceSize) {
+      const double tref = measure(a,b,r,true);
+      double err = 0.0;
+      for (int i=0;i<n;++i) {
+        for (int j=0;j<n;++j) {
+          const double d = std::fabs(double(c.at(i,j))-double(r.at(i,j)))/
+                           (1.0+std::fabs(double(r.at(i,j))));
+          if (d>err) {
+            err = d;
+          }
+        }
+      }
+      std::cout << std::setw(14) << std::setprecision(4)
+                << flops/(tref*1000.0)
+                << std::setw(14) << flops/(tnew*1000.0)
+                << std::setw(10) << tref/tnew
+                << std::setw(14) << err << std::endl;
+    } else {
+      std::cout << std::setw(14) << "-"
+                << std::setw(14) << std::setprecision(4)
+                << flops/(tnew*1000.0)
+                << std::setw(10) << "-"
+                << std::setw(14) << "-" << std::endl;
+    }
+  }
+}
+
+void usage() {
+  std::cout << "Usage: matrixMultiplyBenchmark [-s max] [-r max] [-t n]\n"
+            << "  -s max  largest matrix size (default 4096)\n"
+            << "  -r max  largest size for the former implementation "
+            << "(default 1024)\n"
+            << "  -t n    number of threads (default: all)\n"
+            << "  -h      this help" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  int maxSize = 4096;
+  int maxReferenceSize = 1024;
+  lti::internal::gemmConfiguration cfg;
+
+  int c;
+  while ((c = getopt(argc,argv,"s:r:t:h")) != -1) {
+    switch (c) {
+    case 's':
+      maxSize = std::atoi(optarg);
+      break;
+    case 'r':
+      maxReferenceSize = std::atoi(optarg);
+      break;
+    case 't':
+      cfg.threads = std::atoi(optarg);
+      break;
+    default:
+      usage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  lti::internal::setGemmConfiguration(cfg);
+
+  int mc,kc,nc;
+  lti::internal::getGemmBlocking(sizeof(double),mc,kc,nc);
+  std::cout << "Blocking for double: mc=" << mc << " kc=" << kc
+            << " nc=" << nc << std::endl;
+
+  benchmark<float>("float",maxSize,maxReferenceSize);
+  benchmark<double>("double",maxSize,maxReferenceSize);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,359 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ */
+
+/**
+ * \file   pixelFormatBenchmark.cpp
+ *         Measure the conversion of raw camera frames into images and
+ *         channels with the vectorized converters of ltiPixelFormatKernels.h
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include <ltiPixelFormatKernels.h>
+#include <ltiBilinearDemosaicing.h>
+#include <ltiTimer.h>
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <getopt.h>
+
+using lti::ubyte;
+
+// -------------------------------------------------------------------------
+// reference implementation
+// -------------------------------------------------------------------------
+
+/**
+ * Look-up tables of the former per-pixel conversion of lti::v4l2
+ */
+struct lookUpTables {
+  ubyte saturation[1024];
+  int ug[256];
+  int ub[256];
+  int vg[256];
+  int vr[256];
+
+  lookUpTables() {
+    for (int i=-256;i<512;++i) {
+      saturation[i & 0x3FF] = lti::within(i,0,255);
+    }
+    for (int i=0;i<256;++i) {
+      ug[i] = (i-128)*88;
+      ub[i] = (i-128)*454;
+      vg[i] = (i-128)*183;
+      vr[i] = (i-128)*359;
+    }
+  }
+};
+
+static const lookUpTables luts;
+
+/**
+ * Convert one row with the look-up tables.  The luminance of the pixel x is
+ * at y[x*ys], its chroma values at u[(x/2)*cs] and v[(x/2)*cs].  The pixels
+ * are written at dest, dest+step, dest+2*step, etc.
+ */
+void lutRow(const ubyte* y,const int ys,
+            const ubyte* u,const ubyte* v,const int cs,
+            const int cols,lti::rgbaPixel* dest,const int step) {
+  for (int x=0;x<cols;x+=2,u+=cs,v+=cs) {
+    for (int k=0;k<2;++k,y+=ys,dest+=step) {
+      const int yy = (*y) << 8;
+      dest->set(luts.saturation[((yy+luts.vr[*v]) >> 8) & 0x3FF],
+                luts.saturation[((yy-luts.ug[*u]-luts.vg[*v]) >> 8) & 0x3FF],
+                luts.saturation[((yy+luts.ub[*u]) >> 8) & 0x3FF],
+                0);
+    }
+  }
+}
+
+/**
+ * Pointer to the destination pixel of the first pixel of the row y, and
+ * the step to the next one
+ */
+lti::rgbaPixel* refRow(lti::image& img,const int y,const bool turnAround,
+                       int& step) {
+  if (turnAround) {
+    step = -1;
+    return &img.at(img.rows()-1-y,img.columns()-1);
+  }
+  step = 1;
+  return &img.at(y,0);
+}
+
+bool refYUYV(const ubyte* data,const unsigned int,const bool turnAround,
+             lti::image& img) {
+  const int cols = img.columns();
+  int step;
+  for (int y=0;y<img.rows();++y) {
+    const ubyte* row = data+2*cols*y;
+    lti::rgbaPixel* d = refRow(img,y,turnAround,step);
+    lutRow(row,2,row+1,row+3,4,cols,d,step);
+  }
+  return true;
+}
+
+bool refUYVY(const ubyte* data,const unsigned int,const bool turnAround,
+             lti::image& img) {
+  const int cols = img.columns();
+  int step;
+  for (int y=0;y<img.rows();++y) {
+    const ubyte* row = data+2*cols*y;
+    lti::rgbaPixel* d = refRow(img,y,turnAround,step);
+    lutRow(row+1,2,row,row+2,4,cols,d,step);
+  }
+  return true;
+}
+
+bool refYUV420(const ubyte* data,const unsigned int,const bool turnAround,
+               lti::image& img) {
+  const int cols = img.columns();
+  const int rows = img.rows();
+  const ubyte* u = data+cols*rows;
+  const ubyte* v = u+(cols/2)*(rows/2);
+  int step;
+  for (int y=0;y<rows;++y) {
+    const int c = (cols/2)*(y/2);
+    lti::rgbaPixel* d = refRow(img,y,turnAround,step);
+    lutRow(data+cols*y,1,u+c,v+c,1,cols,d,step);
+  }
+  return true;
+}
+
+bool refNV12(const ubyte* data,const unsigned int,const bool turnAround,
+             lti::image& img) {
+  const int cols = img.columns();
+  const int rows = img.rows();
+  int step;
+  for (int y=0;y<rows;++y) {
+    const ubyte* uv = data+cols*rows+cols*(y/2);
+    lti::rgbaPixel* d = refRow(img,y,turnAround,step);
+    lutRow(data+cols*y,1,uv,uv+1,2,cols,d,step);
+  }
+  return true;
+}
+
+bool refGREY(const ubyte* data,const unsigned int,const bool turnAround,
+             lti::image& img) {
+  int step;
+  for (int y=0;y<img.rows();++y) {
+    const ubyte* src = data+img.columns()*y;
+    lti::rgbaPixel* d = refRow(img,y,turnAround,step);
+    for (int x=0;x<img.columns();++x,d+=step) {
+      d->set(src[x],src[x],src[x],0);
+    }
+  }
+  return true;
+}
+
+/**
+ * Bayer patterns are converted by lti::v4l2 with a demosaicing functor,
+ * bilinear by default
+ */
+bool refBayer(const ubyte* data,const unsigned int,const bool turnAround,
+              lti::image& img) {
+  static lti::bilinearDemosaicing demosaicing;
+  lti::matrix<ubyte> src(img.rows(),img.columns(),data);
+  demosaicing.apply(src,img);
+  if (turnAround) {
+    lti::image tmp(img.size());
+    lti::image::const_iterator sit = img.inverseBegin();
+    for (lti::image::iterator it=tmp.begin();it!=tmp.end();++it,--sit) {
+      *it = *sit;
+    }
+    tmp.detach(img);
+  }
+  return true;
+}
+
+// -------------------------------------------------------------------------
+// benchmark
+// -------------------------------------------------------------------------
+
+typedef bool (*image_converter)(const ubyte*,const unsigned int,const bool,
+                                lti::image&);
+typedef bool (*channel_converter)(const ubyte*,const unsigned int,
+                                  const bool,lti::channel8&);
+
+/**
+ * A pixel format with its converters.  The null ones are not available.
+ */
+struct pixelFormat {
+  const char* name;
+  int bytesPerFour; // buffer bytes per four pixels
+  image_converter reference;
+  image_converter toImage;
+  channel_converter toChannel;
+};
+
+/**
+ * Time per conversion in ms
+ */
+template<class C,class T>
+double timeOf(C convert,const std::vector<ubyte>& buffer,
+              const bool turnAround,T& dest,const int reps) {
+  lti::timer chron(lti::timer::Wall);
+  chron.start();
+  for (int i=0;i<reps;++i) {
+    convert(&buffer[0],buffer.size(),turnAround,dest);
+  }
+  chron.stop();
+  return chron.getTime()/(1000.0*reps);
+}
+
+/**
+ * Reference conversion to a channel8: to an image and cast
+ */
+struct referenceChannel {
+  image_converter reference;
+  lti::image* tmp;
+  bool operator()(const ubyte* data,const unsigned int bsize,
+                  const bool turnAround,lti::channel8& chnl) const {
+    tmp->allocate(chnl.size());
+    reference(data,bsize,turnAround,*tmp);
+    chnl.castFrom(*tmp);
+    return true;
+  }
+};
+
+/**
+ * Largest difference of any color component
+ */
+int maxDifference(const lti::image& a,const lti::image& b) {
+  int diff = 0;
+  lti::image::const_iterator ait = a.begin();
+  lti::image::const_iterator bit = b.begin();
+  for (;ait!=a.end();++ait,++bit) {
+    diff = lti::max(diff,
+                    lti::abs(int((*ait).getRed())-int((*bit).getRed())),
+                    lti::abs(int((*ait).getGreen())-int((*bit).getGreen())));
+    diff = lti::max(diff,
+                    lti::abs(int((*ait).getBlue())-int((*bit).getBlue())));
+  }
+  return diff;
+}
+
+/**
+ * Convert the buffer with the given format and report the times
+ */
+void benchmark(const pixelFormat& fmt,
+               const std::vector<ubyte>& buffer,
+               const int rows,
+               const int cols,
+               const int reps) {
+  lti::image ref(rows,cols);
+  lti::image img(rows,cols);
+  lti::image tmp;
+  lti::channel8 chnl(rows,cols);
+  referenceChannel refChnl = { fmt.reference, &tmp };
+
+  const double refTime = timeOf(fmt.reference,buffer,false,ref,reps);
+  const double refChnlTime = timeOf(refChnl,buffer,false,chnl,reps);
+  const double chnlTime = timeOf(fmt.toChannel,buffer,false,chnl,reps);
+
+  std::cout << std::setw(8) << fmt.name
+            << std::setprecision(3) << std::fixed
+            << std::setw(10) << refTime;
+
+  if (fmt.toImage != 0) {
+    const double imgTime = timeOf(fmt.toImage,buffer,false,img,reps);
+
+    // compare both orientations with the reference
+    int diff = maxDifference(ref,img);
+    fmt.reference(&buffer[0],buffer.size(),true,ref);
+    fmt.toImage(&buffer[0],buffer.size(),true,img);
+    diff = lti::max(diff,maxDifference(ref,img));
+
+    std::cout << std::setw(10) << imgTime
+              << std::setw(10) << std::setprecision(1) << refTime/imgTime
+              << std::setw(8) << diff;
+  } else {
+    std::cout << std::setw(10) << "-"
+              << std::setw(10) << "-"
+              << std::setw(8) << "-";
+  }
+
+  std::cout << std::setprecision(3)
+            << std::setw(10) << refChnlTime
+            << std::setw(10) << chnlTime
+            << std::setw(10) << std::setprecision(1) << refChnlTime/chnlTime
+            << std::endl;
+}
+
+void usage() {
+  std::cout << "Usage: pixelFormatBenchmark [-c columns] [-r rows] "
+            << "[-n repetitions]\n"
+            << "  -c columns      columns of the frames (default 1920)\n"
+            << "  -r rows         rows of the frames (default 1080)\n"
+            << "  -n repetitions  conversions of each frame (default 100)\n"
+            << "  -h              this help" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  int cols = 1920;
+  int rows = 1080;
+  int reps = 100;
+
+  int c;
+  while ((c = getopt(argc,argv,"c:r:n:h")) != -1) {
+    switch (c) {
+    case 'c':
+      cols = std::atoi(optarg);
+      break;
+    case 'r':
+      rows = std::atoi(optarg);
+      break;
+    case 'n':
+      reps = std::atoi(optarg);
+      break;
+    default:
+      usage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  // all formats need an even number of columns and rows
+  if ((cols < 2) || (rows < 2) || ((cols & 1) != 0) || ((rows & 1) != 0) ||
+      (reps < 1)) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  using namespace lti::internal;
+  const pixelFormat formats[] = {
+    { "YUYV",   8, refYUYV,   yuyvToImage,   yuyvToChannel  },
+    { "UYVY",   8, refUYVY,   uyvyToImage,   uyvyToChannel  },
+    { "YUV420", 6, refYUV420, yuv420ToImage, greyToChannel  },
+    { "NV12",   6, refNV12,   nv12ToImage,   greyToChannel  },
+    { "GREY",   4, refGREY,   greyToImage,   greyToChannel  },
+    { "Bayer",  4, refBayer,  0,             bayerToChannel }
+  };
+  const int numFormats = sizeof(formats)/sizeof(formats[0]);
+
+  std::cout << cols << "x" << rows << " frames, " << reps
+            << " repetitions" << std::endl << std::endl;
+  std::cout << std::setw(8) << "format"
+            << std::setw(10) << "ref ms"
+            << std::setw(10) << "image ms"
+            << std::setw(10) << "speedup"
+            << std::setw(8) << "diff"
+            << std::setw(10) << "ref ms"
+            << std::setw(10) << "chnl ms"
+            << std::setw(10) << "speedup" << std::endl;
+
+  for (int i=0;i<numFormats;++i) {
+    std::vector<ubyte> buffer(formats[i].bytesPerFour*cols*rows/4);
+    for (unsigned int j=0;j<buffer.size();++j) {
+      buffer[j] = static_cast<ubyte>(std::rand());
+    }
+    benchmark(formats[i],buffer,rows,cols,reps);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -40,16 +40,23 @@ namespace lti {
   // ----------------------------
 
   functor::parameters::parameters() 
-    : parametersManager::parameters() {
+    : parametersManager::parameters(), numberOfThreads(1) {
   }
 
   functor::parameters::parameters(const parameters& other) 
-    : parametersManager::parameters(other) {
+    : parametersManager::parameters(other),
+      numberOfThreads(other.numberOfThreads) {
   }
   
   functor::parameters::~parameters() {
   }
 
+  functor::parameters& functor::parameters::copy(const parameters& other) {
+    parametersManager::parameters::copy(other);
+    numberOfThreads = other.numberOfThreads;
+    return *this;
+  }
+
   // ----------------------------
   // functor
   // ----------------------------
@@ -64,7 +64,9 @@ namespace lti  {
 
   public:
     /**
-     * Parameters class of functor is empty and abstract
+     * Parameters class of functor is abstract.
+     *
+     * It only contains the attributes shared by all functors.
      */
     class parameters : public parametersManager::parameters {
     public:
@@ -83,6 +85,11 @@ namespace lti  {
        */
       virtual ~parameters();
       
+      /**
+       * Copy data of "other" parameters
+       */
+      parameters& copy(const parameters& other);
+
       /**
        * Returns the name of this class
        */
@@ -97,6 +104,28 @@ namespace lti  {
        * Returns a pointer to a clone of the parameters.
        */
       virtual parameters* newInstance() const = 0;
+
+      /**
+       * Maximum number of threads the functor may use.
+       *
+       * Functors that support a parallel execution (for instance
+       * lti::convolution or lti::medianFilter) split their data into bands
+       * of rows, which are processed by the shared lti::threadPool.  The
+       * results are identical to the ones of the sequential execution.
+       * Other functors just ignore this attribute.
+       *
+       * - 1 means the functor works only in the calling thread.
+       * - 0 (or any negative value) means "automatic": as many threads as
+       *   the shared thread pool has (usually the number of processors).
+       * - n > 1 uses at most n threads.
+       *
+       * This attribute describes the execution environment and not the
+       * algorithm, and therefore it is neither written nor read by the
+       * write() and read() methods.
+       *
+       * Default value: 1
+       */
+      int numberOfThreads;
     };
 
     /**
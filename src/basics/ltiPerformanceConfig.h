@@ -39,7 +39,8 @@
 /**
  * Multiplication of two matrices in lti::matrix is faster if the
  * second matrix is transposed first when that matrix is large. Large
- * is defined below.
+ * is defined below.  For float and double matrices the large ones are
+ * multiplied with the blocked kernels in ltiGemm.h instead.
  */
 #define _LTI_PERFORMANCE_MATRIX_MATRIX_MULTIPLY 65
 
@@ -72,9 +72,13 @@ namespace lti {
     reliabilityThreshold = 10.0;
     maxUnreliableNeighborhood = 20;
 
+    indexType = KdTree;
     bestBinFirst = false;
     eMax = 100;
     bucketSize = 5;
+    graphLinks = 16;
+    graphConstructionBreadth = 100;
+    graphSearchBreadth = 40;
 
   }
 
@@ -106,9 +110,13 @@ namespace lti {
     reliabilityMode       = other.reliabilityMode;
     reliabilityThreshold  = other.reliabilityThreshold;
     maxUnreliableNeighborhood = other.maxUnreliableNeighborhood;
+    indexType             = other.indexType;
     bestBinFirst          = other.bestBinFirst;
     eMax                  = other.eMax;
     bucketSize            = other.bucketSize;
+    graphLinks            = other.graphLinks;
+    graphConstructionBreadth = other.graphConstructionBreadth;
+    graphSearchBreadth    = other.graphSearchBreadth;
 
     return *this;
   }
@@ -168,9 +176,26 @@ namespace lti {
       b=b && lti::write(handler, "maxUnreliableNeighborhood",
                         maxUnreliableNeighborhood);
 
+      switch(indexType) {
+        case KdTree:
+          b=b && lti::write(handler, "indexType","KdTree");
+          break;
+        case SmallWorldGraph:
+          b=b && lti::write(handler, "indexType","SmallWorldGraph");
+          break;
+        default:
+          b=b && lti::write(handler, "indexType","KdTree");
+          handler.setStatusString("Index type unknown!");
+          b=false;
+      }
+
       b=b && lti::write(handler, "bestBinFirst",bestBinFirst);
       b=b && lti::write(handler, "eMax",eMax);
       b=b && lti::write(handler, "bucketSize",bucketSize);
+      b=b && lti::write(handler, "graphLinks",graphLinks);
+      b=b && lti::write(handler, "graphConstructionBreadth",
+                        graphConstructionBreadth);
+      b=b && lti::write(handler, "graphSearchBreadth",graphSearchBreadth);
 
     }
 
@@ -222,9 +247,25 @@ namespace lti {
       b=lti::read(handler, "maxUnreliableNeighborhood",
                   maxUnreliableNeighborhood) && b;
 
+      b=lti::read(handler,"indexType",str) && b;
+      if (str == "SmallWorldGraph") {
+        indexType = SmallWorldGraph;
+      } else if (str == "KdTree") {
+        indexType = KdTree;
+      } else {
+        indexType = KdTree;
+        handler.setStatusString("Index type symbol not recognized:");
+        handler.appendStatusString(str.c_str());
+        b=false;
+      }
+
       b=lti::read(handler, "bestBinFirst",bestBinFirst) && b;
       b=lti::read(handler, "eMax",eMax) && b;
       b=lti::read(handler, "bucketSize",bucketSize) && b;
+      b=lti::read(handler, "graphLinks",graphLinks) && b;
+      b=lti::read(handler, "graphConstructionBreadth",
+                  graphConstructionBreadth) && b;
+      b=lti::read(handler, "graphSearchBreadth",graphSearchBreadth) && b;
 
     }
 
@@ -271,6 +312,7 @@ namespace lti {
   // destructor
   knnClassifier::~knnClassifier() {
     databaseTree_.clear();
+    databaseGraph_.clear();
   }
 
   // returns the name of this type
@@ -283,6 +325,7 @@ namespace lti {
     supervisedInstanceClassifier::copy(other);
 
     databaseTree_.copy(other.databaseTree_);
+    databaseGraph_.copy(other.databaseGraph_);
     nClasses_=other.nClasses_;
     idMap_=other.idMap_;
     rIdMap_=other.rIdMap_;
@@ -374,7 +417,7 @@ namespace lti {
       intId = idMap_[ids[i]];
       // since no id for each point is specified, use just the row
       // index at the input matrix
-      databaseTree_.add(input[i], std::make_pair(intId,pointIds[i]) );
+      addSample(input[i], std::make_pair(intId,pointIds[i]) );
       classWeight_[intId] += 1.0;
     }
 
@@ -435,7 +478,7 @@ namespace lti {
     // insert the "points" (rows of the matrix) as points in the kd-Tree
     int j;
     for (j=0; j<input.rows(); ++j) {
-      databaseTree_.add(input[j], std::make_pair(nClasses_,pointIds.at(j)));
+      addSample(input[j], std::make_pair(nClasses_,pointIds.at(j)));
     }
     classWeight_.push_back(1.0/double(input.rows()));
 
@@ -487,7 +530,7 @@ namespace lti {
     // insert the "points" (rows of the matrix) as points in the kd-Tree
     int j;
     for (j=0; j<input.rows(); ++j) {
-      databaseTree_.add(input[j], std::make_pair(intId,pointIds.at(j)));
+      addSample(input[j], std::make_pair(intId,pointIds.at(j)));
     }
 
     j = input.rows();
@@ -573,7 +616,7 @@ namespace lti {
     const parameters& par = getParameters();
 
     const int n = features.rows();
-    const int newKnn = min(par.kNN,databaseTree_.size());
+    const int newKnn = min(par.kNN,databaseSize());
 
     int i;
 
@@ -584,14 +627,7 @@ namespace lti {
 
       for (i = 0; i < n; ++i) {
         // get the k nearest neighbors
-        if (par.bestBinFirst) {
-          databaseTree_.searchBestBinFirst(newKnn,
-                                           features[i],
-                                           par.eMax,
-                                           resList);
-        } else {
-          databaseTree_.searchNearest(newKnn,features[i], resList);          
-        }
+        searchNearest(newKnn,features[i],resList);
 
         if (par.normalizeData) {
           for (itr = resList.begin(); itr != resList.end(); ++itr) {
@@ -625,7 +661,7 @@ namespace lti {
       // at least 1 element belongs to another class.
       const int newK = min(max(min(maxPointsPerClass_+1,
                                    par.maxUnreliableNeighborhood),par.kNN),
-                           databaseTree_.size());
+                           databaseSize());
 
       double winner;    // distance to the winner sample.
       double nextOther; // distance to the first sample of a different class
@@ -638,11 +674,7 @@ namespace lti {
         resList.clear(); 
         
         // ensure to get at least 1 element of another class
-        if (par.bestBinFirst) {
-          databaseTree_.searchBestBinFirst(newK,features[i],par.eMax,resList);
-        } else {
-          databaseTree_.searchNearest(newK,features[i], resList);          
-        }
+        searchNearest(newK,features[i],resList);
 
         itr = resList.begin();
         const int resultID = (*itr).second->data.first;    // the best hit
@@ -733,7 +765,7 @@ namespace lti {
     const parameters& par = getParameters();
 
     const int n = features.rows();
-    const int newKnn = min(par.kNN,databaseTree_.size());
+    const int newKnn = min(par.kNN,databaseSize());
 
     res.assign(n,nClasses_,0.0);
 
@@ -747,12 +779,7 @@ namespace lti {
 
       for (i = 0; i < n; ++i) {
         // get the k nearest neighbors
-        if (par.bestBinFirst) {
-          databaseTree_.searchBestBinFirst(newKnn,features[i],
-                                           par.eMax,resList);
-        } else {
-          databaseTree_.searchNearest(newKnn,features[i], resList);          
-        }
+        searchNearest(newKnn,features[i],resList);
 
         if (par.normalizeData) {
           for (itr = resList.begin(); itr != resList.end(); ++itr) {
@@ -787,7 +814,7 @@ namespace lti {
       // at least 1 element belongs to another class.
       const int newK = min(max(min(maxPointsPerClass_+1,
                                    par.maxUnreliableNeighborhood),par.kNN),
-                           databaseTree_.size());
+                           databaseSize());
 
       double winner;    // distance to the winner sample.
       double nextOther; // distance to the first sample of a different class
@@ -800,11 +827,7 @@ namespace lti {
         resList.clear(); 
         
         // ensure to get at least 1 element of another class
-        if (par.bestBinFirst) {
-          databaseTree_.searchBestBinFirst(newK,features[i],par.eMax,resList);
-        } else {
-          databaseTree_.searchNearest(newK,features[i], resList);          
-        }
+        searchNearest(newK,features[i],resList);
 
         itr = resList.begin();
         const int resultID = (*itr).second->data.first;    // the best hit
@@ -888,7 +911,11 @@ namespace lti {
   bool knnClassifier::nearest(const dvector& feature, 
                               pointInfo& nearestPoint) const {
     tree_type::element* elem;
-    if (databaseTree_.searchNearest(feature,elem,nearestPoint.distance)) {
+    const parameters& par = getParameters();
+    if ((par.indexType == SmallWorldGraph) ?
+        databaseGraph_.searchNearest(feature,elem,nearestPoint.distance,
+                                     par.graphSearchBreadth) :
+        databaseTree_.searchNearest(feature,elem,nearestPoint.distance)) {
 
       nearestPoint.point = &(elem->point);
       nearestPoint.classId = elem->data.first;
@@ -939,7 +966,7 @@ namespace lti {
     _lti_debug("Classifying: " << feature << "\n");
     const parameters& par = getParameters();
     dvector res(nClasses_,0.0);
-    const int newKnn = min(par.kNN,databaseTree_.size());
+    const int newKnn = min(par.kNN,databaseSize());
 
     resList.clear();
     std::multimap<double,tree_type::element*>::iterator itr;
@@ -949,11 +976,7 @@ namespace lti {
       // don't use the reliability measure: simple kNN classifier
 
       // get the k nearest neighbors
-      if (par.bestBinFirst) {
-        databaseTree_.searchBestBinFirst(newKnn,feature,par.eMax,resList);
-      } else {
-        databaseTree_.searchNearest(newKnn,feature, resList);          
-      }
+      searchNearest(newKnn,feature,resList);
       
       if (par.normalizeData) {
         for (itr = resList.begin(); itr != resList.end(); ++itr) {
@@ -985,7 +1008,7 @@ namespace lti {
       // at least 1 element belongs to another class.
       const int newK = min(max(min(maxPointsPerClass_+1,
                                    par.maxUnreliableNeighborhood),par.kNN),
-                           databaseTree_.size());
+                           databaseSize());
 
       double winner;    // distance to the winner sample.
       double nextOther; // distance to the first sample of a different class
@@ -993,11 +1016,7 @@ namespace lti {
       bool foundOther;
       
       // ensure to get at least 1 element of another class
-      if (par.bestBinFirst) {
-        databaseTree_.searchBestBinFirst(newK,feature,par.eMax,resList);
-      } else {
-        databaseTree_.searchNearest(newK,feature, resList);          
-      }
+      searchNearest(newK,feature,resList);
 
       itr = resList.begin();
       const int resultID = (*itr).second->data.first;    // the best hit
@@ -1082,6 +1101,7 @@ namespace lti {
 
   void knnClassifier::clear() {
     databaseTree_.clear();
+    databaseGraph_.clear();
     classWeight_.clear();
     nClasses_=0;
     idMap_.clear();
@@ -1091,6 +1111,50 @@ namespace lti {
     maxPointsPerClass_ = 0;
   }
 
+  // -------------------------------------------------------------------------
+  // index access
+  // -------------------------------------------------------------------------
+
+  int knnClassifier::databaseSize() const {
+    return (getParameters().indexType == SmallWorldGraph) ?
+      databaseGraph_.size() : databaseTree_.size();
+  }
+
+  void knnClassifier::addSample(const dvector& point,
+                                const std::pair<int,int>& data) {
+    if (getParameters().indexType == SmallWorldGraph) {
+      databaseGraph_.add(point,data);
+    } else {
+      databaseTree_.add(point,data);
+    }
+  }
+
+  bool knnClassifier::searchNearest(const int k,
+                                    const dvector& feature,
+                           std::list<tree_type::element*>& resList) const {
+    const parameters& par = getParameters();
+    if (par.indexType == SmallWorldGraph) {
+      return databaseGraph_.searchNearest(k,feature,par.graphSearchBreadth,
+                                          resList);
+    } else if (par.bestBinFirst) {
+      return databaseTree_.searchBestBinFirst(k,feature,par.eMax,resList);
+    }
+    return databaseTree_.searchNearest(k,feature,resList);
+  }
+
+  bool knnClassifier::searchNearest(const int k,
+                                    const dvector& feature,
+               std::multimap<double,tree_type::element*>& resList) const {
+    const parameters& par = getParameters();
+    if (par.indexType == SmallWorldGraph) {
+      return databaseGraph_.searchNearest(k,feature,par.graphSearchBreadth,
+                                          resList);
+    } else if (par.bestBinFirst) {
+      return databaseTree_.searchBestBinFirst(k,feature,par.eMax,resList);
+    }
+    return databaseTree_.searchNearest(k,feature,resList);
+  }
+
   // parameter shortcuts
 
   //
@@ -1117,6 +1181,9 @@ namespace lti {
       b=b && lti::write(handler, "minPointsPerClass",minPointsPerClass_);
       b=b && lti::write(handler, "maxPointsPerClass",maxPointsPerClass_);
       b=b && databaseTree_.write(handler);
+      if (getParameters().indexType == SmallWorldGraph) {
+        b=b && databaseGraph_.write(handler);
+      }
     }
 
     if (complete) {
@@ -1143,6 +1210,9 @@ namespace lti {
       b=b && lti::read(handler, "maxPointsPerClass",maxPointsPerClass_);
 
       b=b && databaseTree_.read(handler);
+      if (getParameters().indexType == SmallWorldGraph) {
+        b=b && databaseGraph_.read(handler);
+      }
 
       defineOutputTemplate();
     } 
@@ -1166,7 +1236,13 @@ namespace lti {
     }
     
     defineOutputTemplate();
-    databaseTree_.build(getParameters().bucketSize);
+
+    const parameters& par = getParameters();
+    if (par.indexType == SmallWorldGraph) {
+      databaseGraph_.build(par.graphLinks,par.graphConstructionBreadth);
+    } else {
+      databaseTree_.build(par.bucketSize);
+    }
   }
 
 }
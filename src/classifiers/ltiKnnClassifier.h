@@ -34,6 +34,7 @@
 
 #include "ltiSupervisedInstanceClassifier.h"
 #include "ltiKdTree.h"
+#include "ltiHnswGraph.h"
 
 #include <map>
 #include <vector>
@@ -57,12 +58,16 @@ namespace lti {
    *
    * At this point, only the use of Euclidean distance is allowed.
    *
-   * This classifier uses a kd-Tree to perform the search in an efficient
-   * manner, but shows therefore also the drawbacks of a normal kd-Tree: it is
-   * not suitable for higher dimensional spaces.  If you use high-dimensional
-   * spaces, maybe you should try increasing the bucket size, or activating
-   * the best-bin-first mode, which is a suggestion of David Lowe to get
-   * an aproximative solution (accurate enough) in much less time.
+   * This classifier uses by default a kd-Tree to perform the search in an
+   * efficient manner, but shows therefore also the drawbacks of a normal
+   * kd-Tree: it is not suitable for higher dimensional spaces.  If you use
+   * high-dimensional spaces, maybe you should try increasing the bucket
+   * size, or activating the best-bin-first mode, which is a suggestion of
+   * David Lowe to get an aproximative solution (accurate enough) in much
+   * less time.  For spaces with dozens or hundreds of dimensions (e.g. SIFT
+   * or SURF descriptors) and large training sets, the approximate search
+   * in a lti::hnswGraph (see parameters::indexType) is usually orders of
+   * magnitude faster than both.
    *
    * This classificator differs a little bit from the other LTI-Lib
    * classificators.  Since the whole training set is stored as sample points,
@@ -166,6 +171,15 @@ namespace lti {
                       1.0 - exp(-(d2/d1 - 1)/threshold) */
     };
 
+    /**
+     * Data structures used to search the nearest neighbors of a point
+     */
+    enum eIndexType {
+      KdTree,         /**< Exact search in a lti::kdTree, or approximate
+                           one if parameters::bestBinFirst is true */
+      SmallWorldGraph /**< Approximate search in a lti::hnswGraph */
+    };
+
 
     /**
      * The parameters for the class knnClassifier
@@ -338,11 +352,21 @@ namespace lti {
       /**
        * @name Nearest neighbor search options
        *
-       * The search is optimized using a kd-Tree.  The parameters in
-       * this group control how the tree is organized or how to search
-       * for the data therein.
+       * The search is optimized using a kd-Tree or a small world graph.
+       * The parameters in this group control how the tree or graph is
+       * organized or how to search for the data therein.
        */
       //@{
+      /**
+       * Index used to search the nearest neighbors.
+       *
+       * The index is created while training, so that this parameter
+       * must not be changed between the training and the classification.
+       *
+       * Default value: KdTree
+       */
+      eIndexType indexType;
+
       /**
        * Best Bin First.
        *
@@ -386,6 +410,40 @@ namespace lti {
        * Default value: 5
        */
       int bucketSize;
+
+      /**
+       * Number of links per node of the graph.
+       *
+       * Used only if indexType is SmallWorldGraph.  More links increase the
+       * recall in high dimensional spaces, but also the memory and the
+       * training time.  Values between 12 and 48 are adequate for 64 to 128
+       * dimensions.
+       *
+       * Default value: 16
+       */
+      int graphLinks;
+
+      /**
+       * Breadth of the search while building the graph.
+       *
+       * Used only if indexType is SmallWorldGraph.  Larger values produce
+       * better graphs at the cost of a longer training.
+       *
+       * Default value: 100
+       */
+      int graphConstructionBreadth;
+
+      /**
+       * Breadth of the search while classifying.
+       *
+       * Used only if indexType is SmallWorldGraph.  This is the knob to
+       * trade recall against classification time: the search time grows
+       * roughly linearly with it.  Values smaller than the number of
+       * searched neighbors are replaced by it.
+       *
+       * Default value: 40
+       */
+      int graphSearchBreadth;
       //@}
     };
 
@@ -900,6 +958,19 @@ namespace lti {
      */
     tree_type databaseTree_;
 
+    /**
+     * Small world graph type used for the database.
+     *
+     * It uses the same elements as the tree_type.
+     */
+    typedef hnswGraph< dvector, std::pair<int,int> > graph_type;
+
+    /**
+     * The database with approximate nearest neighbor search, used instead
+     * of databaseTree_ if the parameters::indexType is SmallWorldGraph.
+     */
+    graph_type databaseGraph_;
+
     /**
      * Optionally, a scalar weight for each can be applied, as a-priori value.
      *
@@ -930,6 +1001,32 @@ namespace lti {
                         result& output,
                      std::multimap<double,tree_type::element*>& resList) const;
 
+    /**
+     * Number of samples in the database
+     */
+    int databaseSize() const;
+
+    /**
+     * Add a sample to the index selected in the parameters
+     */
+    void addSample(const dvector& point,const std::pair<int,int>& data);
+
+    /**
+     * Search the k nearest samples to the feature in the index selected
+     * in the parameters.
+     */
+    bool searchNearest(const int k,
+                       const dvector& feature,
+                       std::list<tree_type::element*>& resList) const;
+
+    /**
+     * Search the k nearest samples to the feature in the index selected
+     * in the parameters.
+     */
+    bool searchNearest(const int k,
+                       const dvector& feature,
+                       std::multimap<double,tree_type::element*>& resList) const;
+
   };
 
 }
@@ -33,6 +33,8 @@
 #include "ltiScramble.h"
 #include "ltiFactory.h"
 #include "ltiSTLIoInterface.h"
+#include "ltiGemm.h"
+#include "ltiThreadPool.h"
 
 #include <cstdio>
 #include <limits>
@@ -44,6 +46,386 @@
 
 namespace lti {
 
+  namespace internal {
+
+    /**
+     * Maximal number of patterns propagated together through the network.
+     * It bounds the memory used by the intermediate results of each thread.
+     */
+    static const int MlpBlockRows = 256;
+
+    /**
+     * Propagation of a block of patterns through the layers of a mlp,
+     * using matrix products.
+     *
+     * The weight matrices of the mlp have one row per unit, with the
+     * bias in the first column.  The patterns of a block are the rows of
+     * a matrix, so that the net values of a layer are the product of the
+     * block with the transposed weights (without bias).  The type T is
+     * the precision used in the computations (float or double).
+     */
+    template<typename T>
+    class mlpBlockPropagation {
+    public:
+      /**
+       * Weights of the network converted to the type T
+       */
+      struct layers {
+        /**
+         * Weights of each layer, one row per unit with the bias in the
+         * first column
+         */
+        std::vector< matrix<T> > weights;
+
+        /**
+         * Transposed weights of each layer without the bias, one column
+         * per unit
+         */
+        std::vector< matrix<T> > transposed;
+
+        /**
+         * Index of the first weight of each layer in the weights vector
+         */
+        ivector offsets;
+
+        /**
+         * Convert the given weights
+         */
+        void convert(const std::vector<dmatrix>& mWeights) {
+          const int numLayers = static_cast<int>(mWeights.size());
+          weights.resize(numLayers);
+          transposed.resize(numLayers);
+          offsets.allocate(numLayers);
+          int l,j,c,idx=0;
+          for (l=0;l<numLayers;++l) {
+            const dmatrix& w = mWeights[l];
+            weights[l].castFrom(w);
+            matrix<T>& t = transposed[l];
+            t.allocate(w.columns()-1,w.rows());
+            for (j=0;j<w.rows();++j) {
+              for (c=1;c<w.columns();++c) {
+                t.at(c-1,j)=static_cast<T>(w.at(j,c));
+              }
+            }
+            offsets.at(l)=idx;
+            idx+=w.rows()*w.columns();
+          }
+        }
+      };
+
+      /**
+       * Constructor
+       */
+      mlpBlockPropagation(const layers& lay,
+                          const std::vector<mlp::activationFunctor*>& acts)
+        : layers_(lay), acts_(acts), net_(lay.weights.size()),
+          out_(lay.weights.size()), x0_(0), ldx0_(0), rows_(0) {
+      }
+
+      /**
+       * Propagate the n rows of \a data beginning at \a from.
+       */
+      void forward(const dmatrix& data,const int from,const int n) {
+        rows_ = n;
+        x0_ = blockInput(data,from,n,input_,ldx0_);
+
+        const T* x = x0_;
+        int ldx = ldx0_;
+        int i,j;
+        for (unsigned int l=0;l<net_.size();++l) {
+          const matrix<T>& t = layers_.transposed[l];
+          const matrix<T>& w = layers_.weights[l];
+          const int h = t.columns();
+          matrix<T>& net = net_[l];
+          net.allocate(n,h);
+          gemm(n,h,t.rows(),x,ldx,t.data(),h,net.data(),h);
+          for (i=0;i<n;++i) {
+            T* row = &net.at(i,0);
+            for (j=0;j<h;++j) {
+              row[j]+=w.at(j,0);
+            }
+          }
+          out_[l].copy(net);
+          acts_[l]->apply(out_[l]);
+          x = out_[l].data();
+          ldx = h;
+        }
+      }
+
+      /**
+       * Values of the output units for the last propagated block
+       */
+      const matrix<T>& output() const {
+        return out_.back();
+      }
+
+      /**
+       * Error of the last propagated block, whose patterns have the ids
+       * beginning at \a from.
+       */
+      double error(const ivector& ids,const int from,
+                   const double on,const double off) const {
+        const matrix<T>& out = out_.back();
+        double err = 0.0;
+        double tmp;
+        int i,j;
+        for (i=0;i<rows_;++i) {
+          const int id = ids.at(from+i);
+          const T* row = &out.at(i,0);
+          for (j=0;j<out.columns();++j) {
+            tmp = static_cast<double>(row[j])-((j==id)?on:off);
+            err+=tmp*tmp;
+          }
+        }
+        return 0.5*err;
+      }
+
+      /**
+       * Back-propagate the error of the last propagated block, whose
+       * patterns have the ids beginning at \a from.  The negative
+       * gradient is accumulated in \a grad and the error in \a err.
+       */
+      void backward(const ivector& ids,const int from,
+                    const double on,const double off,
+                    dvector& grad,double& err) {
+        int l = static_cast<int>(net_.size())-1;
+        int i,j;
+        double tmp,e=0.0;
+
+        // deltas of the output layer
+        acts_[l]->deriv(net_[l]);
+        const matrix<T>& out = out_[l];
+        delta_.allocate(rows_,out.columns());
+        for (i=0;i<rows_;++i) {
+          const int id = ids.at(from+i);
+          const T* orow = &out.at(i,0);
+          const T* drow = &net_[l].at(i,0);
+          T* row = &delta_.at(i,0);
+          for (j=0;j<out.columns();++j) {
+            tmp = ((j==id)?on:off)-static_cast<double>(orow[j]);
+            e+=tmp*tmp;
+            row[j] = static_cast<T>(tmp)*drow[j];
+          }
+        }
+        err+=0.5*e;
+
+        for (;l>=0;--l) {
+          const matrix<T>& w = layers_.weights[l];
+          const int h = w.rows();
+          const int k = w.columns()-1;
+          const T* x = (l>0) ? out_[l-1].data() : x0_;
+          const int ldx = (l>0) ? k : ldx0_;
+
+          // gradient of the weights: delta' * [1 x]
+          deltaT_.transpose(delta_);
+          layerGrad_.allocate(h,k+1);
+          gemm(h,k,rows_,deltaT_.data(),rows_,x,ldx,&layerGrad_.at(0,1),k+1);
+          for (j=0;j<h;++j) {
+            const T* drow = &deltaT_.at(j,0);
+            T sum(0);
+            for (i=0;i<rows_;++i) {
+              sum+=drow[i];
+            }
+            layerGrad_.at(j,0)=sum;
+          }
+
+          double* g = &grad.at(layers_.offsets.at(l));
+          const T* lg = layerGrad_.data();
+          const T* const elg = lg+h*(k+1);
+          for (;lg!=elg;++lg,++g) {
+            (*g)+=static_cast<double>(*lg);
+          }
+
+          if (l>0) {
+            // deltas of the previous layer: (delta * W) .* f'(net)
+            newDelta_.allocate(rows_,k);
+            gemm(rows_,k,h,delta_.data(),h,&w.at(0,1),k+1,
+                 newDelta_.data(),k);
+            acts_[l-1]->deriv(net_[l-1]);
+            newDelta_.emultiply(net_[l-1]);
+            delta_.swap(newDelta_);
+          }
+        }
+      }
+
+    private:
+      /**
+       * Pointer to the rows [from,from+n) of data in the type T.  The
+       * double precision rows of a connected matrix are used directly,
+       * all other cases are copied into \a buffer.
+       */
+      static const T* blockInput(const dmatrix& data,
+                                 const int from,const int n,
+                                 matrix<T>& buffer,int& ld) {
+        buffer.allocate(n,data.columns());
+        for (int i=0;i<n;++i) {
+          const dvector& src = data.getRow(from+i);
+          T* dest = &buffer.at(i,0);
+          for (int j=0;j<src.size();++j) {
+            dest[j]=static_cast<T>(src.at(j));
+          }
+        }
+        ld = data.columns();
+        return buffer.data();
+      }
+
+      const layers& layers_;
+      const std::vector<mlp::activationFunctor*>& acts_;
+
+      /**
+       * Net values and outputs of each layer, one row per pattern
+       */
+      std::vector< matrix<T> > net_;
+      std::vector< matrix<T> > out_;
+
+      /**
+       * Input block, if the data had to be converted
+       */
+      matrix<T> input_;
+
+      /**
+       * Input block and its leading dimension
+       */
+      const T* x0_;
+      int ldx0_;
+
+      /**
+       * Number of patterns in the last block
+       */
+      int rows_;
+
+      /**
+       * Temporary matrices of the back-propagation
+       */
+      matrix<T> delta_,deltaT_,newDelta_,layerGrad_;
+    };
+
+    template<>
+    const double*
+    mlpBlockPropagation<double>::blockInput(const dmatrix& data,
+                                            const int from,const int n,
+                                            dmatrix& buffer,int& ld) {
+      if (data.getMode() == dmatrix::Connected) {
+        ld = data.columns();
+        return &data.at(from,0);
+      }
+      buffer.copy(data,from,0,from+n-1);
+      ld = buffer.columns();
+      return buffer.data();
+    }
+
+    /**
+     * Job that propagates the patterns of a matrix through a mlp, splitting
+     * them in contiguous ranges of rows, one per task.
+     */
+    template<typename T>
+    class mlpBlockJob : public threadPool::job {
+    public:
+      /**
+       * Constructor.  See mlp::propagateBlock() for the meaning of the
+       * arguments.
+       */
+      mlpBlockJob(const std::vector<dmatrix>& mWeights,
+                  const std::vector<mlp::activationFunctor*>& acts,
+                  const dmatrix& inputs,
+                  const ivector* ids,
+                  const double on,
+                  const double off,
+                  const bool computeGrad,
+                  const bool computeError,
+                  dmatrix* outputs,
+                  const int tasks)
+        : acts_(acts), inputs_(inputs), ids_(ids), on_(on), off_(off),
+          computeGrad_(computeGrad), computeError_(computeError),
+          outputs_(outputs), tasks_(tasks), grads_(tasks), errors_(tasks) {
+        layers_.convert(mWeights);
+        weightsSize_ = 0;
+        for (unsigned int l=0;l<mWeights.size();++l) {
+          weightsSize_+=mWeights[l].rows()*mWeights[l].columns();
+        }
+      }
+
+      /**
+       * Propagate the range of rows of the given task
+       */
+      virtual void execute(const int task) {
+        const int n = inputs_.rows();
+        const int from = static_cast<int>((static_cast<double>(n)*task)/
+                                          tasks_);
+        const int to = static_cast<int>((static_cast<double>(n)*(task+1))/
+                                        tasks_);
+
+        mlpBlockPropagation<T> prop(layers_,acts_);
+        dvector& grad = grads_[task];
+        double& err = errors_[task];
+        err = 0.0;
+        if (computeGrad_) {
+          grad.assign(weightsSize_,0.0);
+        }
+
+        int i,r,j,m;
+        for (i=from;i<to;i+=MlpBlockRows) {
+          m = min(MlpBlockRows,to-i);
+          prop.forward(inputs_,i,m);
+          if (notNull(outputs_)) {
+            const matrix<T>& out = prop.output();
+            for (r=0;r<m;++r) {
+              const T* src = &out.at(r,0);
+              double* dest = &outputs_->at(i+r,0);
+              for (j=0;j<out.columns();++j) {
+                dest[j]=static_cast<double>(src[j]);
+              }
+            }
+          }
+          if (computeGrad_) {
+            prop.backward(*ids_,i,on_,off_,grad,err);
+          } else if (computeError_) {
+            err+=prop.error(*ids_,i,on_,off_);
+          }
+        }
+      }
+
+      /**
+       * Execute all tasks and add the partial results
+       */
+      void run(dvector* grad,double* totalError) {
+        if (tasks_ > 1) {
+          threadPool::getShared().run(*this,tasks_,tasks_);
+        } else {
+          execute(0);
+        }
+
+        if (notNull(grad)) {
+          grad->swap(grads_[0]);
+          for (int t=1;t<tasks_;++t) {
+            grad->add(grads_[t]);
+          }
+        }
+        if (notNull(totalError)) {
+          *totalError = 0.0;
+          for (int t=0;t<tasks_;++t) {
+            *totalError += errors_[t];
+          }
+        }
+      }
+
+    private:
+      typename mlpBlockPropagation<T>::layers layers_;
+      const std::vector<mlp::activationFunctor*>& acts_;
+      const dmatrix& inputs_;
+      const ivector* ids_;
+      const double on_;
+      const double off_;
+      const bool computeGrad_;
+      const bool computeError_;
+      dmatrix* outputs_;
+      const int tasks_;
+      int weightsSize_;
+      std::vector<dvector> grads_;
+      std::vector<double> errors_;
+    };
+  }
+
   // ----------------------------------------------
   // activation functor
   // ----------------------------------------------
@@ -79,6 +461,44 @@ namespace lti {
     return b;
   }
 
+  bool mlp::activationFunctor::apply(dmatrix& output) const {
+    bool b = true;
+    for (int i=0;i<output.rows();++i) {
+      b = apply(output.getRow(i)) && b;
+    }
+    return b;
+  }
+
+  bool mlp::activationFunctor::apply(fmatrix& output) const {
+    bool b = true;
+    dvector tmp;
+    for (int i=0;i<output.rows();++i) {
+      tmp.castFrom(output.getRow(i));
+      b = apply(tmp) && b;
+      output.getRow(i).castFrom(tmp);
+    }
+    return b;
+  }
+
+  bool mlp::activationFunctor::deriv(dmatrix& output) const {
+    bool b = true;
+    for (int i=0;i<output.rows();++i) {
+      b = deriv(output.getRow(i)) && b;
+    }
+    return b;
+  }
+
+  bool mlp::activationFunctor::deriv(fmatrix& output) const {
+    bool b = true;
+    dvector tmp;
+    for (int i=0;i<output.rows();++i) {
+      tmp.castFrom(output.getRow(i));
+      b = deriv(tmp) && b;
+      output.getRow(i).castFrom(tmp);
+    }
+    return b;
+  }
+
   // ----------------------------------------------
   // linearActFunctor
   // ----------------------------------------------
@@ -98,6 +518,15 @@ namespace lti {
     return true;
   }
 
+  bool mlp::linearActFunctor::apply(fmatrix&) const {
+    return true;
+  }
+
+  bool mlp::linearActFunctor::deriv(fmatrix& output) const {
+    output.fill(1.0f);
+    return true;
+  }
+
   const double& mlp::linearActFunctor::onValue() const {
     static const double theOnValue = +1.0;
     return theOnValue;
@@ -159,6 +588,26 @@ namespace lti {
     return true;
   }
 
+  /**
+   * The functor operator for a block of patterns in single precision
+   */
+  bool mlp::signFunctor::apply(fmatrix& output) const {
+    fmatrix::iterator it,eit;
+    for (it=output.begin(),eit=output.end();it!=eit;++it) {
+      (*it) = (*it) >= 0 ? 1.0f : -1.0f;
+    }
+    return true;
+  }
+
+  /**
+   * The derivative of the functor for a block of patterns in single
+   * precision
+   */
+  bool mlp::signFunctor::deriv(fmatrix& output) const {
+    output.fill(1.0f);
+    return true;
+  }
+
   /**
    * Return value used to represent "true" or "on"
    */
@@ -249,6 +698,32 @@ namespace lti {
     }
     return true;
   }
+
+  /**
+   * The functor operator for a block of patterns in single precision
+   */
+  bool mlp::sigmoidFunctor::apply(fmatrix& output) const {
+    const float slope = static_cast<float>(slope_);
+    fmatrix::iterator it,eit;
+    for (it=output.begin(),eit=output.end();it!=eit;++it) {
+      (*it) = 1.0f/(1.0f+exp(-(*it)*slope));
+    }
+    return true;
+  }
+
+  /**
+   * The derivative of the functor for a block of patterns in single
+   * precision
+   */
+  bool mlp::sigmoidFunctor::deriv(fmatrix& output) const {
+    const float slope = static_cast<float>(slope_);
+    fmatrix::iterator it,eit;
+    for (it=output.begin(),eit=output.end();it!=eit;++it) {
+      (*it) = 1.0f/(1.0f+exp(-(*it)*slope));
+      (*it) = (*it)*(1.0f-(*it))*slope;
+    }
+    return true;
+  }
   
   /**
    * Return a copy of this functor
@@ -334,6 +809,7 @@ namespace lti {
 
     trainingMode = ConjugateGradients;
     batchMode = bool(true);
+    batchSize = int(0);
     momentum = double(0.0);
     hiddenUnits = ivector(1,4);
     learnrate = float(0.1);
@@ -341,6 +817,9 @@ namespace lti {
     stopError = double(0.005);
 
     activationFunctions.resize(hiddenUnits.size()+1,"sigmoidFunctor");
+
+    singlePrecision = bool(false);
+    numberOfThreads = int(1);
     
   }
 
@@ -438,6 +917,7 @@ namespace lti {
 
     trainingMode = other.trainingMode;
     batchMode = other.batchMode;
+    batchSize = other.batchSize;
     momentum = other.momentum;
     hiddenUnits = other.hiddenUnits;
     learnrate = other.learnrate;
@@ -445,6 +925,9 @@ namespace lti {
     stopError = other.stopError;
 
     activationFunctions = other.activationFunctions;
+    rndConfig.copy(other.rndConfig);
+    singlePrecision = other.singlePrecision;
+    numberOfThreads = other.numberOfThreads;
 
     return *this;
   }
@@ -481,6 +964,7 @@ namespace lti {
     if (b) {
       lti::write(handler,"trainingMode",trainingMode);
       lti::write(handler,"batchMode",batchMode);
+      lti::write(handler,"batchSize",batchSize);
       lti::write(handler,"momentum",momentum);
       lti::write(handler,"hiddenUnits",hiddenUnits);
       lti::write(handler,"learnrate",learnrate);
@@ -488,6 +972,7 @@ namespace lti {
       lti::write(handler,"stopError",stopError);
       lti::write(handler,"activationFunctions",activationFunctions);
       lti::write(handler,"rndConfig",rndConfig);
+      lti::write(handler,"singlePrecision",singlePrecision);
     }
 
     b = b && supervisedInstanceClassifier::parameters::write(handler,false);
@@ -516,6 +1001,7 @@ namespace lti {
     if (b) {
       lti::read(handler,"trainingMode",trainingMode);
       lti::read(handler,"batchMode",batchMode);
+      lti::read(handler,"batchSize",batchSize);
       lti::read(handler,"momentum",momentum);
       lti::read(handler,"hiddenUnits",hiddenUnits);
       lti::read(handler,"learnrate",learnrate);
@@ -523,6 +1009,7 @@ namespace lti {
       lti::read(handler,"stopError",stopError);
       lti::read(handler,"activationFunctions",activationFunctions);
       lti::read(handler,"rndConfig",rndConfig);
+      lti::read(handler,"singlePrecision",singlePrecision);
     }
 
     b = b && supervisedInstanceClassifier::parameters::read(handler,false);
@@ -815,7 +1302,11 @@ namespace lti {
       b = trainConjugateGradients(data,newIds);
     } else {
       if (param.batchMode) { // batch training mode:
-        b = trainSteepestBatch(data,newIds);
+        if ((param.batchSize > 0) && (param.batchSize < data.rows())) {
+          b = trainSteepestMiniBatch(data,newIds);
+        } else {
+          b = trainSteepestBatch(data,newIds);
+        }
       } else { // sequential training mode:
         b = trainSteepestSequential(data,newIds);
       }
@@ -957,6 +1448,66 @@ namespace lti {
     return true;
   }
 
+  bool mlp::trainSteepestMiniBatch(const dmatrix& data,
+                                   const ivector& internalIds) {
+
+    const parameters& param = getParameters();
+    char buffer[256];
+    bool abort = false;
+    scramble::parameters rnd;
+    // copy the generator settings (and the seed) into rnd itself
+    static_cast<randomDistribution::parameters&>(rnd.randomParams).
+      copy(param.rndConfig);
+    scramble scrambler(rnd);
+    int i,j,k,m;
+    double epochError;
+    ivector idx;
+    idx.allocate(data.rows());
+    for (i=0;i<idx.size();++i) {
+      idx.at(i)=i;
+    }
+
+    const int size = min(param.batchSize,data.rows());
+    dmatrix batch;
+    ivector batchIds;
+    dvector grad,delta(weights_.size(),0.0);
+
+    for (i=0; !abort && (i<param.maxNumberOfEpochs); ++i) {
+      scrambler.apply(idx); // present the pattern in a random sequence
+      epochError = 0;
+      for (j=0;j<idx.size();j+=size) {
+        // collect the patterns of the mini-batch
+        m=min(size,idx.size()-j);
+        batch.allocate(m,data.columns());
+        batchIds.allocate(m);
+        for (k=0;k<m;++k) {
+          batch.getRow(k).fill(data.getRow(idx.at(j+k)));
+          batchIds.at(k)=internalIds.at(idx.at(j+k));
+        }
+
+        calcGradient(batch,batchIds,grad);
+        epochError+=totalError_;
+
+        if (param.momentum > 0) {
+          delta.addScaled(param.learnrate,grad,param.momentum,delta);
+          weights_.add(delta);
+        } else {
+          weights_.addScaled(param.learnrate,grad);
+        }
+      }
+      totalError_=epochError;
+
+      // update progress info object
+      if (haveValidProgressObject()) {
+        sprintf(buffer,"Error=%f",totalError_/errorNorm_);
+        getProgressObject().step(buffer);
+        abort = abort || (totalError_/errorNorm_ <= param.stopError);
+        abort = abort || getProgressObject().breakRequested();
+      }
+    }
+    return true;
+  }
+
   bool mlp::trainConjugateGradients(const dmatrix& data,
                                     const ivector& internalIds) {
 
@@ -1336,6 +1887,38 @@ namespace lti {
     return false;
   }
 
+  bool mlp::classify(const dmatrix& features,
+                     dmatrix& res) const {
+    if (features.columns() != inputs_) {
+      setStatusString("Dimensionality of the features does not match the " \
+                      "number of inputs of the network");
+      return false;
+    }
+
+    propagateBlock(matWeights_,features,0,0,0,&res);
+    return true;
+  }
+
+  bool mlp::classify(const dmatrix& features,
+                     std::vector<result>& res) const {
+    dmatrix outUnits;
+    if (!classify(features,outUnits)) {
+      return false;
+    }
+
+    bool b = true;
+    res.resize(features.rows());
+    for (int i=0;i<outUnits.rows();++i) {
+      if (outTemplate_.apply(outUnits.getRow(i),res[i])) {
+        res[i].setWinnerAtMax();
+      } else {
+        b = false;
+      }
+    }
+
+    return b;
+  }
+
   /*
    * initialize weights with random values
    *
@@ -1513,22 +2096,44 @@ namespace lti {
       return false;
     }
 
-    dvector tmp;
-    int i;
-    double tmpError;
+    propagateBlock(matWeights_,inputs,&ids,&grad,&totalError_,0);
 
-    totalError_ = 0;
-    calcGradient(inputs.getRow(0),ids.at(0),grad);
-    computeActualError(ids.at(0),totalError_);
+    return true;
+  }
+
+  /*
+   * propagate a block of patterns through the network, computing the
+   * required results with one job per thread
+   */
+  void mlp::propagateBlock(const std::vector<dmatrix>& mWeights,
+                           const dmatrix& inputs,
+                           const ivector* ids,
+                           dvector* grad,
+                           double* totalError,
+                           dmatrix* outputs) const {
+    const parameters& param = getParameters();
+    const int n = inputs.rows();
 
-    for (i=1;i<inputs.rows();++i) {
-      calcGradient(inputs.getRow(i),ids.at(i),tmp);
-      computeActualError(ids.at(i),tmpError);
-      grad.add(tmp);
-      totalError_+=tmpError;
+    if (notNull(outputs)) {
+      outputs->allocate(n,mWeights.back().rows());
     }
 
-    return true;
+    // do not start more threads than blocks of patterns
+    const int tasks =
+      max(1,min(threadPool::computeThreads(param.numberOfThreads),
+                (n+internal::MlpBlockRows-1)/internal::MlpBlockRows));
+
+    if (param.singlePrecision) {
+      internal::mlpBlockJob<float> job(mWeights,activationFunctions_,inputs,
+                                       ids,on_,off_,notNull(grad),
+                                       notNull(totalError),outputs,tasks);
+      job.run(grad,totalError);
+    } else {
+      internal::mlpBlockJob<double> job(mWeights,activationFunctions_,inputs,
+                                        ids,on_,off_,notNull(grad),
+                                        notNull(totalError),outputs,tasks);
+      job.run(grad,totalError);
+    }
   }
 
    /*
@@ -1574,17 +2179,7 @@ namespace lti {
       return false;
     }
 
-    const parameters& param = getParameters();
-    const int layers = param.hiddenUnits.size()+1;
-    std::vector<dvector> uNet(layers),uOut(layers);
-    int i;
-    double tmp;
-    totalError=0.0;
-    for (i=0;i<ids.size();++i) {
-      propagate(inputs.getRow(i),mWeights,uNet,uOut);
-      computePatternError(ids.at(i),uOut.back(),tmp);
-      totalError+=tmp;
-    }
+    propagateBlock(mWeights,inputs,&ids,0,&totalError,0);
 
     return true;
   }
@@ -167,6 +167,39 @@ namespace lti {
        */
       virtual bool deriv(dvector& output) const = 0;
 
+      /**
+       * The functor operator for a block of patterns, one per row.
+       * Operates on place.
+       *
+       * The default implementation applies the vector version on each row.
+       */
+      virtual bool apply(dmatrix& output) const;
+
+      /**
+       * The functor operator for a block of patterns in single precision,
+       * one per row.  Operates on place.
+       *
+       * The default implementation converts each row to double precision
+       * and applies the vector version.
+       */
+      virtual bool apply(fmatrix& output) const;
+
+      /**
+       * The derivative of the functor for a block of patterns, one per row.
+       *
+       * The default implementation applies the vector version on each row.
+       */
+      virtual bool deriv(dmatrix& output) const;
+
+      /**
+       * The derivative of the functor for a block of patterns in single
+       * precision, one per row.
+       *
+       * The default implementation converts each row to double precision
+       * and applies the vector version.
+       */
+      virtual bool deriv(fmatrix& output) const;
+
       /**
        * Return a copy of this functor
        */
@@ -231,6 +264,17 @@ namespace lti {
        */
       virtual bool deriv(dvector& output) const;
 
+      /**
+       * The functor operator for a block of patterns in single precision
+       */
+      virtual bool apply(fmatrix& output) const;
+
+      /**
+       * The derivative of the functor for a block of patterns in single
+       * precision
+       */
+      virtual bool deriv(fmatrix& output) const;
+
       /**
        * Return value used to represent "true" or "on"
        */
@@ -277,6 +321,17 @@ namespace lti {
        */
       virtual bool deriv(dvector& output) const;
 
+      /**
+       * The functor operator for a block of patterns in single precision
+       */
+      virtual bool apply(fmatrix& output) const;
+
+      /**
+       * The derivative of the functor for a block of patterns in single
+       * precision
+       */
+      virtual bool deriv(fmatrix& output) const;
+
       /**
        * Return value used to represent "true" or "on"
        */
@@ -340,6 +395,17 @@ namespace lti {
        */
       virtual bool deriv(dvector& output) const;
 
+      /**
+       * The functor operator for a block of patterns in single precision
+       */
+      virtual bool apply(fmatrix& output) const;
+
+      /**
+       * The derivative of the functor for a block of patterns in single
+       * precision
+       */
+      virtual bool deriv(fmatrix& output) const;
+
       /**
        * Return a copy of this functor
        */
@@ -529,6 +595,21 @@ namespace lti {
        */
       bool batchMode;
 
+      /**
+       * Number of patterns in each mini-batch.
+       *
+       * If greater than zero and the steepest descent method is used in
+       * batch mode, the training set is presented in a random sequence
+       * and split in mini-batches of this size.  The weights are adapted
+       * after each mini-batch, using the gradient accumulated over its
+       * patterns.  Zero or negative values use the whole training set as
+       * one single batch.  This value is ignored by the conjugate gradients
+       * method and in the sequential mode.
+       *
+       * Default value: 0 (whole training set)
+       */
+      int batchSize;
+
       /**
        * Value for the momentum used in the steepest descent methods.
        * Should be between 0.0 and 1.0.
@@ -599,6 +680,49 @@ namespace lti {
        * Default value: default configuration
        */
       randomDistribution::parameters rndConfig;
+
+      /**
+       * If true, the patterns are propagated through the network in single
+       * precision (float) while computing the gradients and errors of a
+       * whole batch, and while classifying a matrix of patterns.  The
+       * weights themselves and the accumulated gradients are always kept in
+       * double precision.
+       *
+       * Single precision doubles the throughput of the matrix products
+       * used to propagate the patterns, which usually dominate the training
+       * time of large networks.
+       *
+       * In double precision the patterns are propagated in blocks as well.
+       * The bias is added after the matrix product and the gradients are
+       * summed block by block, so the results equal those of a pattern by
+       * pattern propagation only up to rounding.
+       *
+       * Default value: false
+       */
+      bool singlePrecision;
+
+      /**
+       * Number of threads used to compute the gradients and errors of a
+       * batch, and to classify a matrix of patterns.
+       *
+       * The patterns are split in as many contiguous blocks as threads, and
+       * the partial gradients of all blocks are added in a fixed order.
+       * Therefore, the results do not depend on the scheduling of the
+       * threads, but may differ in the last bits for different numbers of
+       * threads.
+       *
+       * - 1 means the work is done only in the calling thread.
+       * - 0 (or any negative value) means "automatic": as many threads as
+       *   the shared lti::threadPool has.
+       * - n > 1 uses at most n threads.
+       *
+       * This attribute describes the execution environment and not the
+       * network, and therefore it is neither written nor read by the
+       * write() and read() methods.
+       *
+       * Default value: 1
+       */
+      int numberOfThreads;
     };
 
     /**
@@ -708,6 +832,42 @@ namespace lti {
      */
     virtual bool classify(const dvector& feature, result& res) const;
 
+    /**
+     * Classification of a block of patterns.
+     *
+     * Classifies each row of the \a features matrix and returns in the
+     * respective row of \a res the values of the output units of the
+     * network.  The column j of \a res corresponds to the output unit
+     * j, whose id can be obtained with
+     * <code>getOutputTemplate().getIds().at(j)</code>.
+     *
+     * All patterns are propagated together through each layer with
+     * matrix products, and the rows are split among the threads given
+     * in parameters::numberOfThreads.  This is much faster than calling
+     * classify(const dvector&,result&) for each row.
+     *
+     * @param features patterns to be classified, each row is one pattern
+     * @param res output units for each pattern
+     * @return true if successful, false otherwise
+     */
+    virtual bool classify(const dmatrix& features, dmatrix& res) const;
+
+    /**
+     * Classification of a block of patterns.
+     *
+     * Classifies each row of the \a features matrix and returns the
+     * respective classifier::result in \a res, as
+     * classify(const dvector&,result&) would do.  The network is
+     * evaluated for all patterns at once, as in
+     * classify(const dmatrix&,dmatrix&).
+     *
+     * @param features patterns to be classified, each row is one pattern
+     * @param res one result for each pattern
+     * @return true if successful, false otherwise
+     */
+    virtual bool classify(const dmatrix& features,
+                          std::vector<result>& res) const;
+
     /**
      * Write the rbf classifier in the given ioHandler
      * @param handler the ioHandler to be used
@@ -915,9 +1075,14 @@ namespace lti {
      * calculate negative gradient of error surface using
      * back-propagation algorithm for all patterns in an epoch.
      *
-     * @param input input vector
-     * @param outputId desired output.  This value must be between 0 and
-     *                 the number of output elements-1.
+     * The patterns are propagated in blocks through each layer with matrix
+     * products, split among several threads (see
+     * parameters::numberOfThreads).  The total error of the patterns is
+     * left in totalError_.
+     *
+     * @param inputs input vectors, one per row
+     * @param ids desired outputs.  These values must be between 0 and
+     *            the number of output elements-1.
      * @param grad computed gradient of the error surface
      * @return true if successful, or false otherwise.
      */
@@ -925,6 +1090,30 @@ namespace lti {
                       const ivector& ids,
                       dvector& grad);
 
+    /**
+     * Propagate a block of patterns through the network given by
+     * \a mWeights.
+     *
+     * Depending on the given pointers, the gradient of the error surface
+     * (accumulated over all patterns), the total error and the values of
+     * the output units for each pattern are computed.  Null pointers
+     * indicate that the respective value is not required.
+     *
+     * @param mWeights weights in matrix form
+     * @param inputs input vectors, one per row
+     * @param ids internal ids of the patterns (only required if grad or
+     *            totalError are given)
+     * @param grad negative gradient of the error surface
+     * @param totalError error accumulated over all patterns
+     * @param outputs values of the output units, one row per pattern
+     */
+    void propagateBlock(const std::vector<dmatrix>& mWeights,
+                        const dmatrix& inputs,
+                        const ivector* ids,
+                        dvector* grad,
+                        double* totalError,
+                        dmatrix* outputs) const;
+
 
     /**
      * train the network with steepest descent method (batch mode)
@@ -941,6 +1130,13 @@ namespace lti {
     bool trainSteepestSequential(const dmatrix& inputs,
                                  const ivector& internalIds);
 
+    /**
+     * train the network with steepest descent method (mini-batch mode)
+     * Weights must be initialized previously
+     */
+    bool trainSteepestMiniBatch(const dmatrix& inputs,
+                                const ivector& internalIds);
+
 
     /**
      * train the network with steepest descent method (batch mode)
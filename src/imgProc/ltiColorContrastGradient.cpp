@@ -35,6 +35,7 @@
 #include "ltiSplitImageToRGB.h"
 #include "ltiArctanLUT.h"
 #include "ltiRGBPixel.h"
+#include "ltiParallelBands.h"
 #include  <limits>
 
 namespace lti {
@@ -249,6 +250,61 @@ namespace lti {
     return *par;
   }
 
+  namespace internal {
+    /**
+     * Operation of parallelBands used by colorContrastGradient to compute
+     * the polar gradient of three channels.  The maximum magnitude is
+     * computed row-wise from the valid rows of each band only, since the
+     * halo rows at the band borders may differ from the ones of the whole
+     * channel.
+     */
+    class contrastGradientBandOp {
+    public:
+      typedef parallelBands<colorContrastGradient> bands_type;
+
+      contrastGradientBandOp(const channel& c1,
+                             const channel& c2,
+                             const channel& c3,
+                             channel& mag,
+                             channel& arg)
+        : rowMax(c1.rows(),0.0f),
+          c1_(c1),c2_(c2),c3_(c3),mag_(mag),arg_(arg) {
+      }
+
+      bool operator()(colorContrastGradient& theFunctor,
+                      const bandPartition::band& b) {
+        channel i1,i2,i3,mag,arg;
+        float maxmag;
+        bands_type::window(c1_,b,i1);
+        bands_type::window(c2_,b,i2);
+        bands_type::window(c3_,b,i3);
+        if (!(theFunctor.apply(i1,i2,i3,mag,arg,maxmag) &&
+              bands_type::store(mag,b,mag_) &&
+              bands_type::store(arg,b,arg_))) {
+          return false;
+        }
+
+        for (int y=b.from;y<b.to;++y) {
+          const vector<float>& row = mag_.getRow(y);
+          rowMax[y]=*std::max_element(row.begin(),row.end());
+        }
+        return true;
+      }
+
+      /**
+       * Maximum magnitude of each row
+       */
+      std::vector<float> rowMax;
+
+    private:
+      const channel& c1_;
+      const channel& c2_;
+      const channel& c3_;
+      channel& mag_;
+      channel& arg_;
+    };
+  }
+
   // -------------------------------------------------------------------
   // The apply-methods!
   // -------------------------------------------------------------------
@@ -292,6 +348,26 @@ namespace lti {
                                     float& maxmag) const {
 
     if (getParameters().format == Polar) {
+      // the derivative kernels reach at most 2 rows, besides OGD
+      const parameters& par = getParameters();
+      parallelBands<colorContrastGradient>
+        bands(*this,c1.size(),max(par.gradientKernelSize,5)/2+1);
+      if ((bands.getNumberOfBands() > 1) &&
+          (c1.size() == c2.size()) && (c1.size() == c3.size()) &&
+          (c1.getMode() == channel::Connected) &&
+          (c2.getMode() == channel::Connected) &&
+          (c3.getMode() == channel::Connected)) {
+        xOrMag.allocate(c1.size());
+        yOrArg.allocate(c1.size());
+        internal::contrastGradientBandOp op(c1,c2,c3,xOrMag,yOrArg);
+        if (!bands.run(op)) {
+          return false;
+        }
+        maxmag = max(0.0f,*std::max_element(op.rowMax.begin(),
+                                            op.rowMax.end()));
+        return true;
+      }
+
       return computeGradientPolar(c1,c2,c3,xOrMag,yOrArg,maxmag);
     } else {
       return computeColorGradientCart(c1,c2,c3,xOrMag,yOrArg,maxmag);      
@@ -33,6 +33,7 @@
 
 #include "ltiMinimizeBasis.h"
 #include "ltiConvolutionHelper.h"
+#include "ltiParallelBands.h"
 #include "ltiFactory.h"
 
 #include <list>
@@ -352,6 +353,14 @@ namespace lti {
       throw invalidParametersException(name());
     }
 
+    // a periodic boundary requires the whole data in each band
+    parallelBands<convolution> bands(*this,src.size(),
+                                     (param.boundaryType == Periodic) ?
+                                     src.rows() : conv.getVerticalReach());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.apply(src,dest);
+    }
+
     if (conv.isKernelSeparable()) {
       conv.applySep(src,dest,param.boundaryType);
     } else {
@@ -376,6 +385,14 @@ namespace lti {
       throw invalidParametersException(name());
     }
 
+    // a periodic boundary requires the whole data in each band
+    parallelBands<convolution> bands(*this,src.size(),
+                                     (param.boundaryType == Periodic) ?
+                                     src.rows() : conv.getVerticalReach());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.apply(src,dest);
+    }
+
     if (conv.isKernelSeparable()) {
       conv.applySep(src,dest,param.boundaryType);
     } else {
@@ -400,6 +417,14 @@ namespace lti {
       throw invalidParametersException(name());
     }
 
+    // a periodic boundary requires the whole data in each band
+    parallelBands<convolution> bands(*this,src.size(),
+                                     (param.boundaryType == Periodic) ?
+                                     src.rows() : conv.getVerticalReach());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.apply(src,dest);
+    }
+
     if (conv.isKernelSeparable()) {
       conv.applySep(src,dest,param.boundaryType);
     } else {
@@ -411,6 +411,15 @@ namespace lti {
     template<class T,class U=T>
     class accumulator {
     public:
+      /**
+       * Type used to accumulate the products.
+       *
+       * Its existence tells the convolution helpers that this accumulator
+       * computes a plain linear convolution, which can be done with the
+       * vectorized kernels of ltiConvolutionKernels.h.
+       */
+      typedef U linear_accumulator_type;
+
       /**
        * Default constructor
        */
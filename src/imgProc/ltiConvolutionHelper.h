@@ -42,6 +42,7 @@
 #include "ltiInvalidParametersException.h"
 #include "ltiPointList.h"
 #include "ltiAreaPoints.h"
+#include "ltiConvolutionKernels.h"
 #include "ltiInvalidParametersException.h"
 
 namespace lti {
@@ -324,6 +325,14 @@ namespace lti {
      */
     inline bool isKernelSeparable() const;
 
+    /**
+     * Number of rows above or below each pixel that the current kernel
+     * reaches, i.e. the largest absolute row index of the kernel (or of
+     * the column filters of a separable kernel).  Returns 0 if no kernel
+     * has been set.
+     */
+    int getVerticalReach() const;
+
     /**
      * Convolve the matrix src with the filter kernel and
      * leaves the result in dest.
@@ -150,6 +150,12 @@ namespace lti {
   void lti::convHelper1D<T,A>::apply(const vector<T>& src,
                                      vector<T>& dest,
                                      const eBoundaryType& boundaryType) {
+    if (internal::isLinearAccumulator<A>::value &&
+        internal::convolveVector(src,*kernel_,kernelSymmetry_,
+                                 boundaryType,dest)) {
+      return;
+    }
+
     if (kernelSymmetry_ == lti::Default) {
       applyAny(src,dest,boundaryType);
     } else {
@@ -766,6 +772,12 @@ namespace lti {
   void lti::convHelper1D<T,A>::applyCol(const matrix<T>& src,
                                         matrix<T>& dest,
                                         const eBoundaryType& boundaryType) {
+    if (internal::isLinearAccumulator<A>::value &&
+        internal::convolveColumns(src,*kernel_,kernelSymmetry_,
+                                  boundaryType,dest)) {
+      return;
+    }
+
     if (kernelSymmetry_ == lti::Default) {
       applyAnyCol(src,dest,boundaryType);
     } else {
@@ -1359,6 +1371,12 @@ namespace lti {
                                               matrix<T>& dest,
                                         const eBoundaryType& boundaryType){
 
+    if (internal::isLinearAccumulator<A>::value &&
+        internal::convolveRows(src,*kernel_,kernelSymmetry_,
+                               boundaryType,dest)) {
+      return;
+    }
+
     int i;
 
     dest.allocate(src.rows(),src.columns());
@@ -1556,6 +1574,20 @@ namespace lti {
     return notNull(sKernel_);
   }
 
+  template<class T,class A>
+  int lti::convHelper2D<T,A>::getVerticalReach() const {
+    int reach = 0;
+    if (notNull(sKernel_)) {
+      for (int i=0;i<sKernel_->getNumberOfPairs();++i) {
+        const kernel1D<T>& col = sKernel_->getColFilter(i);
+        reach = max(reach,max(abs(col.firstIdx()),abs(col.lastIdx())));
+      }
+    } else if (notNull(kernel_)) {
+      reach = max(abs(kernel_->firstRow()),abs(kernel_->lastRow()));
+    }
+    return reach;
+  }
+
   template<class T,class A>
   void lti::convHelper2D<T,A>::apply(const matrix<T>& src,
                                            matrix<T>& dest,
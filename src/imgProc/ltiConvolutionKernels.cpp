@@ -0,0 +1,561 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiConvolutionKernels.cpp
+ *         Vectorized one-dimensional linear convolution of the rows and
+ *         columns of matrices, used by lti::convHelper1D and
+ *         lti::convHelper2D for linear accumulators.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include "ltiConvolutionKernels.h"
+#include "ltiSimd.h"
+#include <vector>
+
+namespace lti {
+  namespace internal {
+
+    // ------------------------------------------------------------------
+    // Type adaptors
+    // ------------------------------------------------------------------
+
+    /*
+     * Load simd<U>::width elements of type T into a register of the
+     * accumulation type U.
+     */
+    inline simd<float>::reg loadAs(const float* p) {
+      return simd<float>::load(p);
+    }
+
+    inline simd<double>::reg loadAs(const double* p) {
+      return simd<double>::load(p);
+    }
+
+    inline simd<int32>::reg loadAs(const ubyte* p) {
+      return simd<int32>::widen(p);
+    }
+
+    /*
+     * Store the accumulated values as T.  The integer accumulation of
+     * ubyte values is divided by the kernel norm, as the accumulator of
+     * lti::convolution does.
+     */
+    inline void storeAs(const simd<float>::reg& acc,const float,float* d) {
+      simd<float>::store(d,acc);
+    }
+
+    inline void storeAs(const simd<double>::reg& acc,const double,double* d) {
+      simd<double>::store(d,acc);
+    }
+
+    inline void storeAs(const simd<int32>::reg& acc,const int32 norm,
+                        ubyte* d) {
+      int32 tmp[simd<int32>::width];
+      simd<int32>::store(tmp,acc);
+      for (int k=0;k<simd<int32>::width;++k) {
+        d[k]=static_cast<ubyte>(tmp[k]/norm);
+      }
+    }
+
+    /*
+     * Scalar versions of the adaptors, used for the last elements of a
+     * row that do not fill a complete register.
+     */
+    inline float scalarResult(const float acc,const float) {
+      return acc;
+    }
+
+    inline double scalarResult(const double acc,const double) {
+      return acc;
+    }
+
+    inline ubyte scalarResult(const int32 acc,const int32 norm) {
+      return static_cast<ubyte>(acc/norm);
+    }
+
+    /*
+     * Norm used by the result adaptors.  Only integer types need it.
+     */
+    template<typename U,typename T>
+    inline U normOf(const kernel1D<T>& kern) {
+      return static_cast<U>(kern.getNorm());
+    }
+
+    // ------------------------------------------------------------------
+    // Boundary handling
+    // ------------------------------------------------------------------
+
+    /*
+     * Map the index q, which may lie outside [0,n), to a valid index
+     * according to the boundary type.  Returns -1 if the value has to
+     * be taken as zero.
+     *
+     * The mirror boundary of the original helper code differs for
+     * rows and columns at the right/bottom border: the rows repeat the
+     * last element (mirrorBase = 2n-1) and the columns do not
+     * (mirrorBase = 2n-2).  Both variants are kept here.
+     */
+    inline int mapIndex(const int q,const int n,
+                        const eBoundaryType boundaryType,
+                        const int mirrorBase) {
+      if ((q >= 0) && (q < n)) {
+        return q;
+      }
+
+      int r;
+      switch (boundaryType) {
+      case Mirror:
+        r = (q < 0) ? -q : mirrorBase-q;
+        break;
+      case Periodic:
+        r = (q < 0) ? n+q : q-n;
+        break;
+      case Constant:
+        r = (q < 0) ? 0 : n-1;
+        break;
+      default: // Zero and NoBoundary
+        return -1;
+      }
+
+      // the kernel is never larger than the data, but just in case
+      return (r < 0) ? 0 : ((r >= n) ? n-1 : r);
+    }
+
+    /*
+     * Check if the boundary type can be handled here.
+     */
+    inline bool knownBoundary(const eBoundaryType boundaryType) {
+      switch (boundaryType) {
+      case NoBoundary:
+      case Zero:
+      case Mirror:
+      case Periodic:
+      case Constant:
+        return true;
+      default:
+        return false;
+      }
+    }
+
+    // ------------------------------------------------------------------
+    // Linear convolution
+    // ------------------------------------------------------------------
+
+    /*
+     * Implementation of the linear convolution for source/destination
+     * type T and accumulation type U.
+     *
+     * With n the kernel size and L the last index of the kernel, the
+     * result at position i is
+     *
+     *   dest(i) = sum_{j=0}^{n-1} filter(n-1-j) * src(i-L+j)
+     *
+     * which is exactly what the helper classes compute.  Symmetric and
+     * asymmetric kernels add or subtract the pairs of samples first, as
+     * the accumulateSym() and accumulateASym() methods of the
+     * accumulator do.  All lanes of a SIMD register compute neighbouring
+     * output elements with the same sequence of operations.
+     */
+    template<typename T,typename U>
+    class linearConvolution {
+    public:
+      typedef simd<U> S;
+      typedef typename S::reg reg;
+
+      /*
+       * Constructor extracts the kernel values in the accumulation type
+       */
+      linearConvolution(const kernel1D<T>& kern,
+                        const eKernelSymmetry symmetry)
+        : n_(kern.size()),last_(kern.lastIdx()),symmetry_(symmetry),
+          norm_(normOf<U>(kern)),filter_(kern.size()) {
+        for (int j=0;j<n_;++j) {
+          filter_[j]=static_cast<U>(kern.at(kern.firstIdx()+j));
+        }
+        half_ = (n_-1)/2;
+      }
+
+      /*
+       * Convolve the line ext, which already contains the n-1
+       * additional boundary elements, and write size elements into
+       * dest.
+       */
+      void line(const T* ext,const int size,T* dest) const {
+        const int W = S::width;
+        const int vend = size-(size%W);
+        const U* f = &filter_[0];
+        const int nm1 = n_-1;
+        int i,j;
+
+        switch (symmetry_) {
+        case Symmetric:
+          for (i=0;i<vend;i+=W) {
+            const T* e = ext+i;
+            reg acc = S::zero();
+            for (j=0;j<half_;++j) {
+              acc = S::add(acc,S::mul(S::set1(f[nm1-j]),
+                                      S::add(loadAs(e+j),
+                                             loadAs(e+nm1-j))));
+            }
+            acc = S::add(acc,S::mul(S::set1(f[half_]),loadAs(e+half_)));
+            storeAs(acc,norm_,dest+i);
+          }
+          for (;i<size;++i) {
+            const T* e = ext+i;
+            U acc(0);
+            for (j=0;j<half_;++j) {
+              acc += (static_cast<U>(e[j])+static_cast<U>(e[nm1-j]))*f[nm1-j];
+            }
+            acc += static_cast<U>(e[half_])*f[half_];
+            dest[i]=scalarResult(acc,norm_);
+          }
+          break;
+
+        case Asymmetric:
+          for (i=0;i<vend;i+=W) {
+            const T* e = ext+i;
+            reg acc = S::zero();
+            for (j=0;j<half_;++j) {
+              acc = S::add(acc,S::mul(S::set1(f[nm1-j]),
+                                      S::sub(loadAs(e+j),
+                                             loadAs(e+nm1-j))));
+            }
+            storeAs(acc,norm_,dest+i);
+          }
+          for (;i<size;++i) {
+            const T* e = ext+i;
+            U acc(0);
+            for (j=0;j<half_;++j) {
+              acc += (static_cast<U>(e[j])-static_cast<U>(e[nm1-j]))*f[nm1-j];
+            }
+            dest[i]=scalarResult(acc,norm_);
+          }
+          break;
+
+        default:
+          for (i=0;i<vend;i+=W) {
+            const T* e = ext+i;
+            reg acc = S::zero();
+            for (j=0;j<n_;++j) {
+              acc = S::add(acc,S::mul(S::set1(f[nm1-j]),loadAs(e+j)));
+            }
+            storeAs(acc,norm_,dest+i);
+          }
+          for (;i<size;++i) {
+            const T* e = ext+i;
+            U acc(0);
+            for (j=0;j<n_;++j) {
+              acc += static_cast<U>(e[j])*f[nm1-j];
+            }
+            dest[i]=scalarResult(acc,norm_);
+          }
+        }
+      }
+
+      /*
+       * Fill ext with the size elements of src and the boundary elements
+       * required by line().
+       */
+      void extend(const T* src,const int size,
+                  const eBoundaryType boundaryType,T* ext) const {
+        const int total = size+n_-1;
+        for (int p=0;p<total;++p) {
+          const int q = mapIndex(p-last_,size,boundaryType,2*size-1);
+          ext[p] = (q<0) ? T(0) : src[q];
+        }
+      }
+
+      /*
+       * Convolve the columns c0 to c1-1 of one destination row, taking
+       * the n source rows from the given pointer table.
+       */
+      void strip(const T* const* rows,const int c0,const int c1,
+                 T* dest) const {
+        const int W = S::width;
+        const int vend = c1-((c1-c0)%W);
+        const U* f = &filter_[0];
+        const int nm1 = n_-1;
+        int c,j;
+
+        switch (symmetry_) {
+        case Symmetric:
+          for (c=c0;c<vend;c+=W) {
+            reg acc = S::zero();
+            for (j=0;j<half_;++j) {
+              acc = S::add(acc,S::mul(S::set1(f[nm1-j]),
+                                      S::add(loadAs(rows[j]+c),
+                                             loadAs(rows[nm1-j]+c))));
+            }
+            acc = S::add(acc,S::mul(S::set1(f[half_]),loadAs(rows[half_]+c)));
+            storeAs(acc,norm_,dest+c);
+          }
+          for (;c<c1;++c) {
+            U acc(0);
+            for (j=0;j<half_;++j) {
+              acc += (static_cast<U>(rows[j][c])+
+                      static_cast<U>(rows[nm1-j][c]))*f[nm1-j];
+            }
+            acc += static_cast<U>(rows[half_][c])*f[half_];
+            dest[c]=scalarResult(acc,norm_);
+          }
+          break;
+
+        case Asymmetric:
+          for (c=c0;c<vend;c+=W) {
+            reg acc = S::zero();
+            for (j=0;j<half_;++j) {
+              acc = S::add(acc,S::mul(S::set1(f[nm1-j]),
+                                      S::sub(loadAs(rows[j]+c),
+                                             loadAs(rows[nm1-j]+c))));
+            }
+            storeAs(acc,norm_,dest+c);
+          }
+          for (;c<c1;++c) {
+            U acc(0);
+            for (j=0;j<half_;++j) {
+              acc += (static_cast<U>(rows[j][c])-
+                      static_cast<U>(rows[nm1-j][c]))*f[nm1-j];
+            }
+            dest[c]=scalarResult(acc,norm_);
+          }
+          break;
+
+        default:
+          for (c=c0;c<vend;c+=W) {
+            reg acc = S::zero();
+            for (j=0;j<n_;++j) {
+              acc = S::add(acc,S::mul(S::set1(f[nm1-j]),loadAs(rows[j]+c)));
+            }
+            storeAs(acc,norm_,dest+c);
+          }
+          for (;c<c1;++c) {
+            U acc(0);
+            for (j=0;j<n_;++j) {
+              acc += static_cast<U>(rows[j][c])*f[nm1-j];
+            }
+            dest[c]=scalarResult(acc,norm_);
+          }
+        }
+      }
+
+      /*
+       * Convolve the rows of src
+       */
+      bool rows(const matrix<T>& src,const eBoundaryType boundaryType,
+                matrix<T>& dest) const {
+        const int size = src.columns();
+        if ((size < n_) || !knownBoundary(boundaryType)) {
+          return false;
+        }
+
+        std::vector<T> ext(size+n_-1);
+        dest.allocate(src.size());
+
+        for (int y=0;y<src.rows();++y) {
+          extend(src.getRow(y).data(),size,boundaryType,&ext[0]);
+          line(&ext[0],size,dest.getRow(y).data());
+        }
+        return true;
+      }
+
+      /*
+       * Convolve the columns of src
+       */
+      bool columns(const matrix<T>& src,const eBoundaryType boundaryType,
+                   matrix<T>& dest) const {
+        const int rowsN = src.rows();
+        const int cols = src.columns();
+        if ((rowsN < n_) || !knownBoundary(boundaryType) ||
+            (&src == &dest)) {
+          return false;
+        }
+
+        dest.allocate(src.size());
+
+        // a row of zeros replaces the rows outside a zero boundary
+        const std::vector<T> zeroRow(cols,T(0));
+
+        // strips of columns small enough to keep the n rows of the
+        // kernel in the first level cache
+        const int W = S::width;
+        int stripWidth = (16*1024)/(n_*static_cast<int>(sizeof(U)));
+        stripWidth = (stripWidth < 4*W) ? 4*W : (stripWidth/W)*W;
+
+        std::vector<const T*> rowp(n_);
+        int c0,c1,i,j;
+
+        for (c0=0;c0<cols;c0=c1) {
+          c1 = (c0+stripWidth < cols) ? c0+stripWidth : cols;
+          for (i=0;i<rowsN;++i) {
+            for (j=0;j<n_;++j) {
+              const int q = mapIndex(i-last_+j,rowsN,boundaryType,
+                                     2*rowsN-2);
+              rowp[j] = (q<0) ? &zeroRow[0] : src.getRow(q).data();
+            }
+            strip(&rowp[0],c0,c1,dest.getRow(i).data());
+          }
+        }
+        return true;
+      }
+
+      /*
+       * Convolve a vector
+       */
+      bool vectors(const vector<T>& src,const eBoundaryType boundaryType,
+                   vector<T>& dest) const {
+        const int size = src.size();
+        if ((size < n_) || !knownBoundary(boundaryType)) {
+          return false;
+        }
+
+        std::vector<T> ext(size+n_-1);
+        extend(src.data(),size,boundaryType,&ext[0]);
+        if (dest.size() != size) {
+          dest.allocate(size);
+        }
+        line(&ext[0],size,dest.data());
+        return true;
+      }
+
+    private:
+      /*
+       * Kernel size
+       */
+      const int n_;
+
+      /*
+       * Last index of the kernel
+       */
+      const int last_;
+
+      /*
+       * Symmetry
+       */
+      const eKernelSymmetry symmetry_;
+
+      /*
+       * Norm (only used for integer types)
+       */
+      const U norm_;
+
+      /*
+       * Kernel values in the accumulation type
+       */
+      std::vector<U> filter_;
+
+      /*
+       * Index of the kernel center in filter_ for symmetric kernels
+       */
+      int half_;
+    };
+
+    // ------------------------------------------------------------------
+    // Public overloads
+    // ------------------------------------------------------------------
+
+    bool convolveRows(const matrix<ubyte>& src,
+                      const kernel1D<ubyte>& kern,
+                      const eKernelSymmetry symmetry,
+                      const eBoundaryType boundaryType,
+                      matrix<ubyte>& dest) {
+      return linearConvolution<ubyte,int32>(kern,symmetry).
+        rows(src,boundaryType,dest);
+    }
+
+    bool convolveRows(const matrix<float>& src,
+                      const kernel1D<float>& kern,
+                      const eKernelSymmetry symmetry,
+                      const eBoundaryType boundaryType,
+                      matrix<float>& dest) {
+      return linearConvolution<float,float>(kern,symmetry).
+        rows(src,boundaryType,dest);
+    }
+
+    bool convolveRows(const matrix<double>& src,
+                      const kernel1D<double>& kern,
+                      const eKernelSymmetry symmetry,
+                      const eBoundaryType boundaryType,
+                      matrix<double>& dest) {
+      return linearConvolution<double,double>(kern,symmetry).
+        rows(src,boundaryType,dest);
+    }
+
+    bool convolveColumns(const matrix<ubyte>& src,
+                         const kernel1D<ubyte>& kern,
+                         const eKernelSymmetry symmetry,
+                         const eBoundaryType boundaryType,
+                         matrix<ubyte>& dest) {
+      return linearConvolution<ubyte,int32>(kern,symmetry).
+        columns(src,boundaryType,dest);
+    }
+
+    bool convolveColumns(const matrix<float>& src,
+                         const kernel1D<float>& kern,
+                         const eKernelSymmetry symmetry,
+                         const eBoundaryType boundaryType,
+                         matrix<float>& dest) {
+      return linearConvolution<float,float>(kern,symmetry).
+        columns(src,boundaryType,dest);
+    }
+
+    bool convolveColumns(const matrix<double>& src,
+                         const kernel1D<double>& kern,
+                         const eKernelSymmetry symmetry,
+                         const eBoundaryType boundaryType,
+                         matrix<double>& dest) {
+      return linearConvolution<double,double>(kern,symmetry).
+        columns(src,boundaryType,dest);
+    }
+
+    bool convolveVector(const vector<ubyte>& src,
+                        const kernel1D<ubyte>& kern,
+                        const eKernelSymmetry symmetry,
+                        const eBoundaryType boundaryType,
+                        vector<ubyte>& dest) {
+      return linearConvolution<ubyte,int32>(kern,symmetry).
+        vectors(src,boundaryType,dest);
+    }
+
+    bool convolveVector(const vector<float>& src,
+                        const kernel1D<float>& kern,
+                        const eKernelSymmetry symmetry,
+                        const eBoundaryType boundaryType,
+                        vector<float>& dest) {
+      return linearConvolution<float,float>(kern,symmetry).
+        vectors(src,boundaryType,dest);
+    }
+
+    bool convolveVector(const vector<double>& src,
+                        const kernel1D<double>& kern,
+                        const eKernelSymmetry symmetry,
+                        const eBoundaryType boundaryType,
+                        vector<double>& dest) {
+      return linearConvolution<double,double>(kern,symmetry).
+        vectors(src,boundaryType,dest);
+    }
+
+  }
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiConvolutionKernels.h
+ *         Vectorized one-dimensional linear convolution of the rows and
+ *         columns of matrices, used by lti::convHelper1D and
+ *         lti::convHelper2D for linear accumulators.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#ifndef _LTI_CONVOLUTION_KERNELS_H_
+#define _LTI_CONVOLUTION_KERNELS_H_
+
+#include "ltiMatrix.h"
+#include "ltiVector.h"
+#include "ltiKernel1D.h"
+#include "ltiKernelSymmetry.h"
+#include "ltiBoundaryType.h"
+
+namespace lti {
+  namespace internal {
+
+    /**
+     * Detect if the accumulator class A of the convolution helpers
+     * computes a plain linear convolution.
+     *
+     * Accumulators declare it with a public type
+     * \c linear_accumulator_type, which is the type used to accumulate the
+     * products.  Only for those accumulators the helpers use the
+     * vectorized kernels below; all other ones (erosion, dilation, etc.)
+     * keep the generic code.
+     */
+    template<class A>
+    struct isLinearAccumulator {
+      typedef char yes;
+      struct no {
+        char dummy[2];
+      };
+
+      template<class X>
+      static yes test(typename X::linear_accumulator_type*);
+
+      template<class X>
+      static no test(...);
+
+      enum { value = (sizeof(test<A>(0)) == sizeof(yes)) };
+    };
+
+    /**
+     * Convolve each row of \p src with the kernel.
+     *
+     * The result is the same as accumulating the products with
+     * lti::convolution's accumulator: floating point types accumulate in
+     * their own precision, and ubyte in integers whose sum is divided by
+     * the norm of the kernel.
+     *
+     * This generic version does nothing and returns false, meaning that
+     * the caller has to use the generic helper code.  The overloads for
+     * ubyte, float and double return false only if the kernel is larger
+     * than the rows or the boundary type is unknown.
+     *
+     * @param src matrix whose rows will be filtered
+     * @param kern kernel
+     * @param symmetry symmetry of the kernel
+     * @param boundaryType boundary type
+     * @param dest result
+     */
+    template<typename T>
+    inline bool convolveRows(const matrix<T>& src,
+                             const kernel1D<T>& kern,
+                             const eKernelSymmetry symmetry,
+                             const eBoundaryType boundaryType,
+                             matrix<T>& dest) {
+      return false;
+    }
+
+    /**
+     * Convolve each column of \p src with the kernel.
+     *
+     * The columns are processed in strips, so that the rows within the
+     * reach of the kernel are read contiguously.  \p src and \p dest must
+     * be different objects.
+     *
+     * @see convolveRows()
+     */
+    template<typename T>
+    inline bool convolveColumns(const matrix<T>& src,
+                                const kernel1D<T>& kern,
+                                const eKernelSymmetry symmetry,
+                                const eBoundaryType boundaryType,
+                                matrix<T>& dest) {
+      return false;
+    }
+
+    /**
+     * Convolve a vector with the kernel.
+     *
+     * @see convolveRows()
+     */
+    template<typename T>
+    inline bool convolveVector(const vector<T>& src,
+                               const kernel1D<T>& kern,
+                               const eKernelSymmetry symmetry,
+                               const eBoundaryType boundaryType,
+                               vector<T>& dest) {
+      return false;
+    }
+
+    bool convolveRows(const matrix<ubyte>& src,
+                      const kernel1D<ubyte>& kern,
+                      const eKernelSymmetry symmetry,
+                      const eBoundaryType boundaryType,
+                      matrix<ubyte>& dest);
+
+    bool convolveRows(const matrix<float>& src,
+                      const kernel1D<float>& kern,
+                      const eKernelSymmetry symmetry,
+                      const eBoundaryType boundaryType,
+                      matrix<float>& dest);
+
+    bool convolveRows(const matrix<double>& src,
+                      const kernel1D<double>& kern,
+                      const eKernelSymmetry symmetry,
+                      const eBoundaryType boundaryType,
+                      matrix<double>& dest);
+
+    bool convolveColumns(const matrix<ubyte>& src,
+                         const kernel1D<ubyte>& kern,
+                         const eKernelSymmetry symmetry,
+                         const eBoundaryType boundaryType,
+                         matrix<ubyte>& dest);
+
+    bool convolveColumns(const matrix<float>& src,
+                         const kernel1D<float>& kern,
+                         const eKernelSymmetry symmetry,
+                         const eBoundaryType boundaryType,
+                         matrix<float>& dest);
+
+    bool convolveColumns(const matrix<double>& src,
+                         const kernel1D<double>& kern,
+                         const eKernelSymmetry symmetry,
+                         const eBoundaryType boundaryType,
+                         matrix<double>& dest);
+
+    bool convolveVector(const vector<ubyte>& src,
+                        const kernel1D<ubyte>& kern,
+                        const eKernelSymmetry symmetry,
+                        const eBoundaryType boundaryType,
+                        vector<ubyte>& dest);
+
+    bool convolveVector(const vector<float>& src,
+                        const kernel1D<float>& kern,
+                        const eKernelSymmetry symmetry,
+                        const eBoundaryType boundaryType,
+                        vector<float>& dest);
+
+    bool convolveVector(const vector<double>& src,
+                        const kernel1D<double>& kern,
+                        const eKernelSymmetry symmetry,
+                        const eBoundaryType boundaryType,
+                        vector<double>& dest);
+  }
+}
+
+#endif
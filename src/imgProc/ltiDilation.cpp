@@ -53,9 +53,65 @@
 #include "ltiDilation_template.h"
 
 #include "ltiConvolutionHelper.h"
+#include "ltiSlidingExtremum.h"
 
 namespace lti {
 
+  // --------------------------------------------------
+  // flat rectangular structuring elements
+  // --------------------------------------------------
+
+  namespace {
+    /*
+     * GrayFlat dilation with a flat rectangular structuring element.
+     * The maximum is taken over src(x-s) for all indices s of the
+     * window, as in a convolution.
+     *
+     * Returns false if the window cannot be processed this way, in which
+     * case the convolution helpers have to be used.
+     */
+    template<typename T>
+    bool flatDilation(const irectangle& window,
+                      const eBoundaryType boundaryType,
+                      const matrix<T>& src,
+                     matrix<T>& dest) {
+      typedef internal::maximumOperator<T> op_type;
+      internal::slidingExtremum<T,op_type>
+        rows(window.ul.x,window.br.x,boundaryType,
+             op_type::neutral(),false);
+      internal::slidingExtremum<T,op_type>
+        cols(window.ul.y,window.br.y,boundaryType,
+             op_type::neutral(),false);
+      if (!rows.canProcess(src.columns()) || !cols.canProcess(src.rows())) {
+        return false;
+      }
+      matrix<T> tmp;
+      rows.applyRows(src,tmp);
+      cols.applyColumns(tmp,dest);
+      return true;
+    }
+
+    /*
+     * GrayFlat dilation of a vector with a flat structuring element.
+     */
+    template<typename T>
+    bool flatDilation(const int first,
+                      const int last,
+                      const eBoundaryType boundaryType,
+                      const vector<T>& src,
+                     vector<T>& dest) {
+      typedef internal::maximumOperator<T> op_type;
+      internal::slidingExtremum<T,op_type> elems(first,last,boundaryType,
+                                                 op_type::neutral(),false);
+      if ((&src == &dest) || !elems.canProcess(src.size())) {
+        return false;
+      }
+      dest.allocate(src.size());
+      elems.apply(src.data(),src.size(),dest.data());
+      return true;
+    }
+  }
+
   // --------------------------------------------------
   // dilation
   // --------------------------------------------------
@@ -186,6 +242,11 @@ namespace lti {
       }
     } break;
     case GrayFlat: {
+      irectangle window;
+      if (isFlatRectangle<float>(window) &&
+          flatDilation(window,param.boundaryType,src,dest)) {
+        break;
+      }
       convHelper2D<float, accumulatorGrayFlat<float,float> > conv;
       if (!conv.setKernel(&param.getStructuringElement())) {
         setStatusString("Wrong kernel type");
@@ -240,6 +301,11 @@ namespace lti {
       }
     } break;
     case GrayFlat: {
+      irectangle window;
+      if (isFlatRectangle<ubyte>(window) &&
+          flatDilation(window,param.boundaryType,src,dest)) {
+        break;
+      }
       convHelper2D<ubyte, accumulatorGrayFlat<ubyte,int> > conv;
       if (!conv.setKernel(&param.getStructuringElement())) {
         setStatusString("Wrong kernel type");
@@ -285,13 +351,18 @@ namespace lti {
       conv.apply(src,dest,param.boundaryType);
     } break;
     case GrayFlat: {
+      int first,last;
+      if (isFlatSegment<float>(first,last) &&
+          flatDilation(first,last,param.boundaryType,src,dest)) {
+        break;
+      }
       convHelper1D<float, accumulatorGrayFlat<float,float> > conv;
       if (!conv.setKernel(&param.getStructuringElement())) {
         setStatusString("Wrong kernel type");
         return false;
       }
       conv.apply(src,dest,param.boundaryType);
-    }
+    } break;
     default:
       setStatusString("Unknown morphology mode");
       return false;
@@ -327,6 +398,11 @@ namespace lti {
       conv.apply(src,dest,param.boundaryType);
     } break;
     case GrayFlat: {
+      int first,last;
+      if (isFlatSegment<ubyte>(first,last) &&
+          flatDilation(first,last,param.boundaryType,src,dest)) {
+        break;
+      }
       convHelper1D<ubyte, accumulatorGrayFlat<ubyte,int> > conv;
       if (!conv.setKernel(&param.getStructuringElement())) {
         setStatusString("Wrong kernel type");
@@ -334,7 +410,7 @@ namespace lti {
       }
       
       conv.apply(src,dest,param.boundaryType);
-    }
+    } break;
     default:
       setStatusString("Unknown morphology mode");
       return false;
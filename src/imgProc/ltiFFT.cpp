@@ -50,7 +50,8 @@
  */
 
 #include "ltiFFT.h"
-#include "ltiFFTinit.h"
+#include "ltiFFTPlan.h"
+#include "ltiThreadPool.h"
 
 namespace lti {
   // --------------------------------------------------
@@ -62,6 +63,7 @@ namespace lti {
     : functor::parameters() {
     
     mode = Cartesian;
+    padToPowerOfTwo = true;
   }
 
   // copy constructor
@@ -82,6 +84,7 @@ namespace lti {
 
     
     mode = other.mode;
+    padToPowerOfTwo = other.padToPowerOfTwo;
 
     return *this;
   }
@@ -125,6 +128,7 @@ namespace lti {
 
     if (b) {
       lti::write(handler,"mode",mode);
+      lti::write(handler,"padToPowerOfTwo",padToPowerOfTwo);
     }
 
     b = b && functor::parameters::write(handler,false);
@@ -152,6 +156,7 @@ namespace lti {
 
     if (b) {
       lti::read(handler,"mode",mode);
+      lti::read(handler,"padToPowerOfTwo",padToPowerOfTwo);
     }
 
     b = b && functor::parameters::read(handler,false);
@@ -240,6 +245,34 @@ namespace lti {
   // The apply() member functions
   // -------------------------------------------------------------------
 
+  /*
+   * Number of threads used for a transform with the given number of
+   * elements.  Small transforms are not worth the synchronization.
+   */
+  static int fftThreads(const int numberOfThreads,const int elements) {
+    if ((numberOfThreads == 1) || (elements < 16384)) {
+      return 1;
+    }
+    return threadPool::computeThreads(numberOfThreads);
+  }
+
+  /*
+   * Convert the n2h+1 cartesian coefficients of the spectrum of a real
+   * vector into polar coordinates.  The DC component keeps its sign.
+   */
+  template<typename T>
+  static void vectorToPolar(const int n2h,T* re,T* im) {
+    im[0] = T(0); // the angle at w=0 must always be zero (is odd)
+    for (int k=1; k<n2h; k++) {
+      const T r = re[k];
+      const T i = im[k];
+      re[k] = sqrt(r*r+i*i);
+      im[k] = atan2(i,r);
+    }
+    im[n2h] = (re[n2h] < 0) ? static_cast<T>(Pi) : T(0);
+    re[n2h] = abs(re[n2h]);
+  }
+
   /// apply real FFT to real vectors
   //  size of output is N/2+1 !
   template<typename T>
@@ -247,18 +280,15 @@ namespace lti {
                    const eCoordinateSystem mode,
                    vector<T>& realOutput,
                    vector<T>& imagOutput) const {
-    int originalSize, ldn;
-    int *ip,  n, m, k;
-    T  *w;
-    vector<T> help;
-
-    // size must have a size with the size = 2^n
-    originalSize = realInput.size();
+    const int originalSize = realInput.size();
 
-    ldn = static_cast<int>(ceil(log(double(originalSize))/log(2.0)));
-    n   = 1 << ldn;
+    // the size must be even, and is a power of 2 if so required
+    const int n = getParameters().padToPowerOfTwo ?
+      max(2,internal::fftPowerOfTwo(originalSize)) :
+      internal::fftFastSize(originalSize,true);
     const int n2h = n/2;
 
+    vector<T> help;
     if (n!=originalSize) {
       help.assign(n, T(0));
       help.fill(realInput, (n-originalSize)/2, n);
@@ -266,62 +296,65 @@ namespace lti {
       help.copy(realInput);
     }
 
-    // initialize fft
-
-    // ip: work area for bit reversal
-    ip = internal::fft::alloc_1d<int>(2 + (int) sqrt(n + 0.5));
-    m = n * 5 / 4 + n / 4;
-
-    // w: cos/sin table
-    w = internal::fft::alloc_1d<T>(m);
-    ip[0] = 0; // flag to indicate initialization
+    // FFT
+    vector<T> spectrum(n+2);
+    typename internal::fftPlan<T>::workspace ws;
+    internal::fftPlan<T>::get(n).realForward(help.data(),spectrum.data(),ws);
 
     //resize output data
     realOutput.allocate(1+n2h);
     imagOutput.allocate(1+n2h);
 
-    // FFT
-    internal::fft::vrdft(n, 1, help, ip, w); // FFT
+    for(int k=0; k<=n2h; k++) {
+      const int k2 = (k << 1); // k*2
+      realOutput[k] = spectrum[k2];
+      imagOutput[k] = spectrum[k2+1];
+    }
 
     // generate output data
     if(mode != lti::Cartesian) {
-      // POLAR
-      realOutput[0] = help[0];
-      imagOutput[0] = 0.0f; // the angle at w=0 must always be zero (is odd)
+      vectorToPolar(n2h,realOutput.data(),imagOutput.data());
+    }
 
-      for(k=1; k<n2h; k++) {
-        const int k2 = (k << 1); // k*2
-        const T& re = help[k2];
-        const T& im = help[k2+1];
+    return true;
+  } //apply for vectors
 
-        realOutput[k] = sqrt(re*re+im*im);
-        imagOutput[k] = atan2(im,re);
-      }
+  template<typename T>
+  bool fft::rowsWorker(const matrix<T>& realInput,
+                       matrix<T>& realOutput,
+                       matrix<T>& imagOutput) const {
+    const parameters& par = getParameters();
+    const int originalSize = realInput.columns();
+
+    // rows are padded as vectors
+    const int n = par.padToPowerOfTwo ?
+      max(2,internal::fftPowerOfTwo(originalSize)) :
+      internal::fftFastSize(originalSize,true);
+    const int n2h = n/2;
 
-      realOutput[n2h] = abs(help[1]);
-      imagOutput[n2h] = (help[1] < 0) ? static_cast<T>(Pi) : 0.0f;
-    } else {
-      // CARTESIC
-      realOutput[0] = help[0];
-      imagOutput[0] = 0.0f;
-
-      for(k=1; k<n2h; k++){
-        const int k2 = (k << 1); // k*2
-        realOutput[k] = help[k2];
-        imagOutput[k] = help[k2+1];
+    const int threads = fftThreads(par.numberOfThreads,
+                                   realInput.rows()*n);
+    if (n != originalSize) {
+      matrix<T> help(realInput.rows(),n,T(0));
+      const int from = (n-originalSize)/2;
+      for (int y=0;y<realInput.rows();++y) {
+        help.getRow(y).fill(realInput.getRow(y),from,n);
       }
-
-      realOutput[n2h] = help[1];
-      imagOutput[n2h] = 0.0f;
+      internal::fftRowsForward(help,threads,realOutput,imagOutput);
+    } else {
+      internal::fftRowsForward(realInput,threads,realOutput,imagOutput);
     }
 
-    // delete memory in the heap!
-
-    internal::fft::free_1d<T>(w);
-    internal::fft::free_1d<int>(ip);
+    if (par.mode != lti::Cartesian) {
+      for (int y=0;y<realOutput.rows();++y) {
+        vectorToPolar(n2h,
+                      realOutput.getRow(y).data(),
+                      imagOutput.getRow(y).data());
+      }
+    }
 
     return true;
-  } //apply for vectors
+  }
 
   bool fft::apply(const fvector& realInput,
                   fvector& realOutput,
@@ -358,6 +391,18 @@ namespace lti {
     return apply(realInput,getParameters().mode,realOutput,imagOutput);
   }
 
+  bool fft::applyRows(const fmatrix& realInput,
+                      fmatrix& realOutput,
+                      fmatrix& imagOutput) const {
+    return rowsWorker(realInput,realOutput,imagOutput);
+  }
+
+  bool fft::applyRows(const dmatrix& realInput,
+                      dmatrix& realOutput,
+                      dmatrix& imagOutput) const {
+    return rowsWorker(realInput,realOutput,imagOutput);
+  }
+
 
   /// apply real FFT to real matrix<float>s
   bool fft::apply(const fmatrix& realInput,
@@ -365,210 +410,48 @@ namespace lti {
                   fmatrix& realOutput,
                   fmatrix& imagOutput) const{
 
-    int originalXsize, originalYsize, ldn;
-    int k1, k2 ;
-
-    // buffers needed by rdft2d
-    int *ip, ny, nx, n;
-    float *t, *w;
-    lti::matrix<float> help;
+    const parameters& par = getParameters();
 
-    // size must always be as 2^n
-    originalXsize = realInput.columns();
-    originalYsize = realInput.rows();
+    if (realInput.empty()) {
+      realOutput.clear();
+      imagOutput.clear();
+      return true;
+    }
 
-    // ny and nx always are powers of two
-    ldn = static_cast<int>(ceil(log(double(originalYsize))/log(2.0)));
-    ny   = 1 << ldn; // n = 2^ldn
+    // size of the transform in each dimension
+    int ny,nx;
+    if (par.padToPowerOfTwo) {
+      ny = internal::fftPowerOfTwo(realInput.rows());
+      nx = internal::fftPowerOfTwo(realInput.columns());
+    } else {
+      ny = internal::fftFastSize(realInput.rows(),false);
+      nx = internal::fftFastSize(realInput.columns(),false);
+    }
 
-    ldn = static_cast<int>(ceil(log(double(originalXsize))/log(2.0)));
-    nx   = 1 << ldn; // n = 2^ldn
+    const int threads = fftThreads(par.numberOfThreads,nx*ny);
 
-    if ((ny != help.rows()) || (nx != help.columns())) {
-      help.assign(ny, nx, 0.0f);
+    if ((ny != realInput.rows()) || (nx != realInput.columns())) {
+      fmatrix help(ny, nx, 0.0f);
       help.fill(realInput,0,0); // copy the original image at(0,0)
+      internal::fft2DForward(help,threads,realOutput,imagOutput);
     } else {
-      help.copy(realInput);
+      internal::fft2DForward(realInput,threads,realOutput,imagOutput);
     }
 
-    // initialize fft
-    const int nxh = nx/2;
-    const int nyh = ny/2;
-
-    // twice the height to store complex values
-    t = internal::fft::alloc_1d<float>(2 * ny);
-
-    n = lti::max(ny, nxh);
-    ip = internal::fft::alloc_1d<int>(2 + (int) sqrt(n + 0.5));
-    n = lti::max(ny * 5 / 4, nx * 5 / 4) + nx / 4;
-    w = internal::fft::alloc_1d<float>(n);
-
-    // resize output buffer
-    realOutput.allocate(ny, nx);
-    imagOutput.allocate(ny, nx);
-
-    // FFT
-    ip[0] = 0; // flag for initialization required of ip and w
-    internal::fft::rdft2d(ny, nx, 1, help, t, ip, w); // FFT
-
     // generate output matrices
     if(mode != lti::Cartesian) {
-
       // Polar coordinates
-      float im,re;
-
-      // first half rows (except the first)
-      for(k1=1; k1 < nyh; k1++) {
-        const int mny = ny-k1;
-
-        const fvector& h = help.getRow(k1);
-        fvector& reOut = realOutput.getRow(k1);
-        fvector& imOut = imagOutput.getRow(k1);
-        fvector& creOut = realOutput.getRow(mny);
-        fvector& cimOut = imagOutput.getRow(mny);
-
-        for (k2 = 1; k2 < nxh; k2++) {
-          const int k22 = (k2 << 1); // x2
-          const int ck2 = nx-k2;
-          re = h[k22];
-          im = h[k22+1];
-
-          creOut[ck2] =   reOut[k2] = sqrt(re*re+im*im);
-          cimOut[ck2] = -(imOut[k2] = atan2(im,re));
+      for (int y=0;y<ny;++y) {
+        fvector& reOut = realOutput.getRow(y);
+        fvector& imOut = imagOutput.getRow(y);
+        for (int x=0;x<nx;++x) {
+          const float re = reOut[x];
+          const float im = imOut[x];
+          reOut[x] = sqrt(re*re+im*im);
+          imOut[x] = atan2(im,re);
         }
-
-        re = h[0];
-        im = h[1];
-        reOut[0]  = creOut[0] = sqrt(re*re+im*im);
-        cimOut[0] = -(imOut[0] = atan2(im,re));
-
-        re = help[mny][1];
-        im = help[mny][0];
-        reOut[nxh] = creOut[nxh] = sqrt(re*re+im*im);
-        imOut[nxh] = -(cimOut[nxh] = atan2(im,re));
       }
-
-      // next half rows without the last four columns
-      for(; k1 < ny; k1++) {
-        const int mny = ny-k1;
-
-        const fvector& h = help.getRow(k1);
-        fvector& reOut = realOutput.getRow(k1);
-        fvector& imOut = imagOutput.getRow(k1);
-        fvector& creOut = realOutput.getRow(mny);
-        fvector& cimOut = imagOutput.getRow(mny);
-
-        for(k2 = 1; k2 < nxh; k2++) {
-          const int k22 = (k2 << 1); // x2
-          const int ck2 = nx-k2;
-
-          re = h[k22];
-          im = h[k22+1];
-
-          creOut[ck2] =   reOut[k2] = sqrt(re*re+im*im);
-          cimOut[ck2] = -(imOut[k2] = atan2(im,re));
-        }
-      }
-
-      // very first row
-      for(k2=1; k2 < nxh; k2++){
-        const int k22 = (k2 << 1); // x2
-        const int ck2 = nx-k2;
-
-        re = help[0][k22];
-        im = help[0][k22+1];
-        realOutput[0][k2]  =   realOutput[0][ck2] = sqrt(re*re+im*im);
-        imagOutput[0][ck2] = -(imagOutput[0][k2]  = atan2(im,re));
-      }
-
-      realOutput[0][0] = abs(help[0][0]);
-      imagOutput[0][0] = (help[0][0]<0) ? static_cast<float>(Pi) : 0.0f;
-
-      realOutput[0][nxh] = abs(help[0][1]);
-      imagOutput[0][nxh] = (help[0][1]<0) ? static_cast<float>(Pi) : 0.0f;
-
-      realOutput[nyh][0] = abs(help[nyh][0]);
-      imagOutput[nyh][0] = (help[nyh][0]<0) ? static_cast<float>(Pi) : 0.0f;
-
-      realOutput[nyh][nxh] = abs(help[nyh][1]);
-      imagOutput[nyh][nxh] = (help[nyh][1]<0) ? static_cast<float>(Pi) : 0.0f;
-
-    } else { //Cartesic
-
-      // the first half of the rows (except the first)
-      for(k1=1; k1 < nyh; k1++) {
-        const int mny = ny-k1;
-        const fvector& h= help.getRow(k1);
-        fvector& reOut  = realOutput.getRow(k1);
-        fvector& imOut  = imagOutput.getRow(k1);
-        fvector& creOut = realOutput.getRow(mny);
-        fvector& cimOut = imagOutput.getRow(mny);
-
-        /*
-         * a[k1][2*k2] = R[k1][k2] = R[n1-k1][n2-k2], 
-         * a[k1][2*k2+1] = I[k1][k2] = -I[n1-k1][n2-k2], 
-         *    0<k1<n1, 0<k2<n2/2, 
-         */
-        for(k2 = 1; k2 < nxh; k2++) {
-          const int k22 = (k2 << 1); // x2
-          const int ck2 = nx-k2;
-          creOut[ck2] =   reOut[k2] = h[k22];
-          cimOut[ck2] = -(imOut[k2] = h[k22+1]);
-        }
-
-        reOut[0]   =   creOut[0]   = h[0];
-        cimOut[0]  = -(imOut[0]    = h[1]);
-        reOut[nxh] =   creOut[nxh] = help[mny][1];
-        imOut[nxh] = -(cimOut[nxh] = help[mny][0]);
-      }
-
-      // the next half (the last four lines of the previous half not required)
-      for(; k1 < ny; k1++) {
-        const int mny = ny-k1;
-
-        const fvector& h = help.getRow(k1);
-        fvector& reOut  = realOutput.getRow(k1);
-        fvector& imOut  = imagOutput.getRow(k1);
-        fvector& creOut = realOutput.getRow(mny);
-        fvector& cimOut = imagOutput.getRow(mny);
-
-        for(k2 = 1; k2 < nxh; k2++) {
-          const int k22 = (k2 << 1); // x2
-          const int ck2 = nx-k2;
-
-          creOut[ck2] =   reOut[k2] = h[k22];
-          cimOut[ck2] = -(imOut[k2] = h[k22+1]);
-        }
-      }
-
-      // The very first row
-      for(k2=1; k2 < nxh; k2++){
-        const int k22 = (k2 << 1); // x2
-        const int ck2 = nx-k2;
-
-        realOutput[0][k2]  =   realOutput[0][ck2] = help[0][k22];
-        imagOutput[0][ck2] = -(imagOutput[0][k2]  = help[0][k22+1]);
-      }
-
-      realOutput[0][0] = help[0][0];
-      imagOutput[0][0] = 0;
-
-      realOutput[0][nxh] = help[0][1];
-      imagOutput[0][nxh] = 0;
-
-      realOutput[nyh][0] = help[nyh][0];
-      imagOutput[nyh][0] = 0;
-
-      realOutput[nyh][nxh] = help[nyh][1];
-      imagOutput[nyh][nxh] = 0;
-
-    } // end else if polar
-
-    // Delete arrays
-
-    internal::fft::free_1d<float>(w);
-    internal::fft::free_1d<int>(ip);
-    internal::fft::free_1d<float>(t);
+    }
 
     return true;
 
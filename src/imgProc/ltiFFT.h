@@ -76,7 +76,13 @@ namespace lti {
    * done this way to simplify visualization of the spectrum.
    *
    * In both versions (for vector and matrix), the output data is automatically
-   * padded to a power of 2.
+   * padded to a power of 2, or to the next size with only the prime factors
+   * 2, 3, 5 and 7 (see parameters::padToPowerOfTwo).
+   *
+   * The transforms are computed with plans (see lti::internal::fftPlan)
+   * which are created once for each size and kept for all later transforms.
+   * The two dimensional transforms and applyRows() use the number of threads
+   * given in the parameters.
    *
    * In the case of channels, the DC component of the signal is in the
    * upper-left corner of the two-dimensional FFT, and in the case of vectors
@@ -211,6 +217,24 @@ namespace lti {
        */
       eCoordinateSystem mode;
 
+      /**
+       * Pad the data to a power of two.
+       *
+       * If true, the data is padded with zeros to the next power of two in
+       * each dimension, as done by previous versions of this class.
+       *
+       * If false, the data is padded only to the next size whose prime
+       * factors are 2, 3, 5 or 7, which the mixed radix transforms compute
+       * without further padding.  A 640x480 image, for example, is then
+       * transformed with its own size instead of 1024x512.  The vector
+       * transforms additionally require an even size.  Note that the size of
+       * the spectrum depends on this attribute, so that the lti::ifft must
+       * use the same value.
+       *
+       * Default: true
+       */
+      bool padToPowerOfTwo;
+
     };
 
     /**
@@ -342,6 +366,29 @@ namespace lti {
                      fmatrix& real,
                      fmatrix& imag) const;
 
+    /**
+     * Transform each row of \c src into the two components FFT
+     * (real/imaginary or magnitude/angle), depending on parameters settings.
+     *
+     * This computes a batch of one-dimensional transforms: each row of the
+     * outputs is the result of apply() on the corresponding row of
+     * \c src, i.e. the rows are padded as a vector, and the outputs have
+     * the padded number of columns divided by 2 plus one.
+     *
+     * @param src the real input data, one vector per row
+     * @param real the real output data (e.g. FFT: the real part)
+     * @param imag the imaginary output data (e.g. FFT: the imaginary part)
+     */
+    bool applyRows(const fmatrix& src,fmatrix& real,fmatrix& imag) const;
+
+    /**
+     * Transform each row of \c src into the two components FFT
+     * (real/imaginary or magnitude/angle), depending on parameters settings.
+     *
+     * @see applyRows(const fmatrix&,fmatrix&,fmatrix&)
+     */
+    bool applyRows(const dmatrix& src,dmatrix& real,dmatrix& imag) const;
+
     /**
      * Copy data of "other" functor.
      * @param other the functor to be copied
@@ -385,6 +432,14 @@ namespace lti {
                 const eCoordinateSystem mode,
                 vector<T>& real,
                 vector<T>& imag) const;
+
+    /**
+     * This worker does the real job for the rows of matrices
+     */
+    template <typename T>
+    bool rowsWorker(const matrix<T>& src,
+                    matrix<T>& real,
+                    matrix<T>& imag) const;
   };
 }
 
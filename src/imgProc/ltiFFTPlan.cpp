@@ -0,0 +1,910 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiFFTPlan.cpp
+ *         Contains the class lti::internal::fftPlan, which holds the
+ *         precomputed tables of a one-dimensional FFT of a given size, and
+ *         the row/column drivers used by lti::fft and lti::ifft.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include "ltiFFTPlan.h"
+#include "ltiFFTinit.h"
+#include "ltiMutex.h"
+#include "ltiThreadPool.h"
+#include "ltiConstants.h"
+#include "ltiMath.h"
+#include <map>
+#include <cmath>
+
+namespace lti {
+  namespace internal {
+
+    // ------------------------------------------------------------------
+    // sizes
+    // ------------------------------------------------------------------
+
+    int fftPowerOfTwo(const int n) {
+      int p = 1;
+      while (p < n) {
+        p <<= 1;
+      }
+      return p;
+    }
+
+    int fftFastSize(const int n, const bool even) {
+      int m = max(n,1);
+      if (even && ((m & 1) != 0)) {
+        ++m;
+      }
+      for (;;m += (even ? 2 : 1)) {
+        int r = m;
+        while ((r % 2) == 0) r/=2;
+        while ((r % 3) == 0) r/=3;
+        while ((r % 5) == 0) r/=5;
+        while ((r % 7) == 0) r/=7;
+        if (r == 1) {
+          return m;
+        }
+      }
+    }
+
+    static inline bool isPowerOfTwo(const int n) {
+      return ((n & (n-1)) == 0);
+    }
+
+    // ------------------------------------------------------------------
+    // mixedRadixFFT
+    // ------------------------------------------------------------------
+
+    /**
+     * Complex value with the layout of the interleaved data
+     */
+    template<typename T>
+    struct fftComplex {
+      T r;
+      T i;
+    };
+
+    /**
+     * Mixed radix forward transform of n complex values.
+     *
+     * The data is recursively decimated in time by the factors of n; the
+     * butterflies combine the partial transforms with the twiddle factors
+     * exp(2 pi i k/n), which are computed once.
+     */
+    template<typename T>
+    class mixedRadixFFT {
+    public:
+      typedef fftComplex<T> cpx;
+
+      explicit mixedRadixFFT(const int n);
+
+      /**
+       * Out-of-place forward transform. \a in and \a out must not overlap.
+       */
+      void transform(const cpx* in,cpx* out) const;
+
+    private:
+      void work(cpx* out,const cpx* in,const int fstride,
+                const int* factors) const;
+
+      void butterfly2(cpx* out,const int fstride,const int m) const;
+      void butterfly3(cpx* out,const int fstride,const int m) const;
+      void butterfly4(cpx* out,const int fstride,const int m) const;
+      void butterfly5(cpx* out,const int fstride,const int m) const;
+      void butterfly(cpx* out,const int fstride,const int m,
+                     const int p) const;
+
+      int n_;
+
+      /**
+       * Pairs of radix and remaining size
+       */
+      std::vector<int> factors_;
+
+      /**
+       * exp(2 pi i k/n)
+       */
+      std::vector<cpx> twiddles_;
+    };
+
+    template<typename T>
+    mixedRadixFFT<T>::mixedRadixFFT(const int n)
+      : n_(n),twiddles_(max(n,1)) {
+
+      for (int k=0;k<n;++k) {
+        const double a = 2.0*Pi*k/n;
+        twiddles_[k].r = static_cast<T>(cos(a));
+        twiddles_[k].i = static_cast<T>(sin(a));
+      }
+
+      // radix 4 first, since it has the cheapest butterfly per element
+      int r = n;
+      int p = 4;
+      while (r > 1) {
+        while ((r % p) != 0) {
+          switch (p) {
+            case 4: p = 2; break;
+            case 2: p = 3; break;
+            default: p += 2; break;
+          }
+          if (p*p > r) {
+            p = r;
+          }
+        }
+        r /= p;
+        factors_.push_back(p);
+        factors_.push_back(r);
+      }
+
+      if (factors_.empty()) {
+        factors_.push_back(1);
+        factors_.push_back(1);
+      }
+    }
+
+    template<typename T>
+    void mixedRadixFFT<T>::transform(const cpx* in,cpx* out) const {
+      work(out,in,1,&factors_[0]);
+    }
+
+    template<typename T>
+    void mixedRadixFFT<T>::work(cpx* out,
+                                const cpx* in,
+                                const int fstride,
+                                const int* factors) const {
+      const int p = factors[0];
+      const int m = factors[1];
+      int q;
+
+      if (m == 1) {
+        for (q=0;q<p;++q,in+=fstride) {
+          out[q] = *in;
+        }
+      } else {
+        for (q=0;q<p;++q,in+=fstride) {
+          work(out+q*m,in,fstride*p,factors+2);
+        }
+      }
+
+      switch (p) {
+        case 1:
+          break;
+        case 2:
+          butterfly2(out,fstride,m);
+          break;
+        case 3:
+          butterfly3(out,fstride,m);
+          break;
+        case 4:
+          butterfly4(out,fstride,m);
+          break;
+        case 5:
+          butterfly5(out,fstride,m);
+          break;
+        default:
+          butterfly(out,fstride,m,p);
+          break;
+      }
+    }
+
+    template<typename T>
+    void mixedRadixFFT<T>::butterfly2(cpx* out,
+                                      const int fstride,
+                                      const int m) const {
+      cpx* out2 = out+m;
+      const cpx* tw = &twiddles_[0];
+      for (int k=0;k<m;++k,tw+=fstride) {
+        cpx t;
+        t.r = out2[k].r*tw->r - out2[k].i*tw->i;
+        t.i = out2[k].r*tw->i + out2[k].i*tw->r;
+        out2[k].r = out[k].r - t.r;
+        out2[k].i = out[k].i - t.i;
+        out[k].r += t.r;
+        out[k].i += t.i;
+      }
+    }
+
+    template<typename T>
+    void mixedRadixFFT<T>::butterfly3(cpx* out,
+                                      const int fstride,
+                                      const int m) const {
+      const T epi3 = twiddles_[fstride*m].i; // sin(2 pi/3)
+      const cpx* tw1 = &twiddles_[0];
+      const cpx* tw2 = tw1;
+      for (int k=0;k<m;++k,tw1+=fstride,tw2+=2*fstride) {
+        cpx& f0 = out[k];
+        cpx& f1 = out[k+m];
+        cpx& f2 = out[k+2*m];
+        cpx s0,s1,s2,s3;
+        s1.r = f1.r*tw1->r - f1.i*tw1->i;
+        s1.i = f1.r*tw1->i + f1.i*tw1->r;
+        s2.r = f2.r*tw2->r - f2.i*tw2->i;
+        s2.i = f2.r*tw2->i + f2.i*tw2->r;
+        s3.r = s1.r+s2.r;
+        s3.i = s1.i+s2.i;
+        s0.r = (s1.r-s2.r)*epi3;
+        s0.i = (s1.i-s2.i)*epi3;
+
+        f1.r = f0.r - s3.r*T(0.5);
+        f1.i = f0.i - s3.i*T(0.5);
+        f0.r += s3.r;
+        f0.i += s3.i;
+        f2.r = f1.r + s0.i;
+        f2.i = f1.i - s0.r;
+        f1.r -= s0.i;
+        f1.i += s0.r;
+      }
+    }
+
+    template<typename T>
+    void mixedRadixFFT<T>::butterfly4(cpx* out,
+                                      const int fstride,
+                                      const int m) const {
+      const cpx* tw1 = &twiddles_[0];
+      const cpx* tw2 = tw1;
+      const cpx* tw3 = tw1;
+      for (int k=0;k<m;++k,tw1+=fstride,tw2+=2*fstride,tw3+=3*fstride) {
+        cpx& f0 = out[k];
+        cpx& f1 = out[k+m];
+        cpx& f2 = out[k+2*m];
+        cpx& f3 = out[k+3*m];
+        cpx s0,s1,s2,s3,s4,s5;
+        s0.r = f1.r*tw1->r - f1.i*tw1->i;
+        s0.i = f1.r*tw1->i + f1.i*tw1->r;
+        s1.r = f2.r*tw2->r - f2.i*tw2->i;
+        s1.i = f2.r*tw2->i + f2.i*tw2->r;
+        s2.r = f3.r*tw3->r - f3.i*tw3->i;
+        s2.i = f3.r*tw3->i + f3.i*tw3->r;
+
+        s5.r = f0.r - s1.r;
+        s5.i = f0.i - s1.i;
+        f0.r += s1.r;
+        f0.i += s1.i;
+        s3.r = s0.r + s2.r;
+        s3.i = s0.i + s2.i;
+        s4.r = s0.r - s2.r;
+        s4.i = s0.i - s2.i;
+        f2.r = f0.r - s3.r;
+        f2.i = f0.i - s3.i;
+        f0.r += s3.r;
+        f0.i += s3.i;
+        // multiplication with +i and -i (positive exponent)
+        f1.r = s5.r - s4.i;
+        f1.i = s5.i + s4.r;
+        f3.r = s5.r + s4.i;
+        f3.i = s5.i - s4.r;
+      }
+    }
+
+    template<typename T>
+    void mixedRadixFFT<T>::butterfly5(cpx* out,
+                                      const int fstride,
+                                      const int m) const {
+      const cpx ya = twiddles_[fstride*m];
+      const cpx yb = twiddles_[2*fstride*m];
+      for (int u=0;u<m;++u) {
+        cpx& f0 = out[u];
+        cpx& f1 = out[u+m];
+        cpx& f2 = out[u+2*m];
+        cpx& f3 = out[u+3*m];
+        cpx& f4 = out[u+4*m];
+        const cpx& t1 = twiddles_[u*fstride];
+        const cpx& t2 = twiddles_[2*u*fstride];
+        const cpx& t3 = twiddles_[3*u*fstride];
+        const cpx& t4 = twiddles_[4*u*fstride];
+
+        cpx s0,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11,s12;
+        s0 = f0;
+        s1.r = f1.r*t1.r - f1.i*t1.i;
+        s1.i = f1.r*t1.i + f1.i*t1.r;
+        s2.r = f2.r*t2.r - f2.i*t2.i;
+        s2.i = f2.r*t2.i + f2.i*t2.r;
+        s3.r = f3.r*t3.r - f3.i*t3.i;
+        s3.i = f3.r*t3.i + f3.i*t3.r;
+        s4.r = f4.r*t4.r - f4.i*t4.i;
+        s4.i = f4.r*t4.i + f4.i*t4.r;
+
+        s7.r = s1.r+s4.r;  s7.i = s1.i+s4.i;
+        s10.r = s1.r-s4.r; s10.i = s1.i-s4.i;
+        s8.r = s2.r+s3.r;  s8.i = s2.i+s3.i;
+        s9.r = s2.r-s3.r;  s9.i = s2.i-s3.i;
+
+        f0.r = s0.r + s7.r + s8.r;
+        f0.i = s0.i + s7.i + s8.i;
+
+        s5.r = s0.r + s7.r*ya.r + s8.r*yb.r;
+        s5.i = s0.i + s7.i*ya.r + s8.i*yb.r;
+        s6.r = s10.i*ya.i + s9.i*yb.i;
+        s6.i = -s10.r*ya.i - s9.r*yb.i;
+        f1.r = s5.r - s6.r;
+        f1.i = s5.i - s6.i;
+        f4.r = s5.r + s6.r;
+        f4.i = s5.i + s6.i;
+
+        s11.r = s0.r + s7.r*yb.r + s8.r*ya.r;
+        s11.i = s0.i + s7.i*yb.r + s8.i*ya.r;
+        s12.r = -s10.i*yb.i + s9.i*ya.i;
+        s12.i = s10.r*yb.i - s9.r*ya.i;
+        f2.r = s11.r + s12.r;
+        f2.i = s11.i + s12.i;
+        f3.r = s11.r - s12.r;
+        f3.i = s11.i - s12.i;
+      }
+    }
+
+    template<typename T>
+    void mixedRadixFFT<T>::butterfly(cpx* out,
+                                     const int fstride,
+                                     const int m,
+                                     const int p) const {
+      std::vector<cpx> scratch(p);
+      for (int u=0;u<m;++u) {
+        int q,q1,k;
+        for (q1=0,k=u;q1<p;++q1,k+=m) {
+          scratch[q1] = out[k];
+        }
+
+        for (q1=0,k=u;q1<p;++q1,k+=m) {
+          int twidx = 0;
+          cpx acc = scratch[0];
+          for (q=1;q<p;++q) {
+            twidx += fstride*k;
+            if (twidx >= n_) {
+              twidx -= n_;
+            }
+            const cpx& t = twiddles_[twidx];
+            acc.r += scratch[q].r*t.r - scratch[q].i*t.i;
+            acc.i += scratch[q].r*t.i + scratch[q].i*t.r;
+          }
+          out[k] = acc;
+        }
+      }
+    }
+
+    // ------------------------------------------------------------------
+    // plan cache
+    // ------------------------------------------------------------------
+
+    /**
+     * All plans created for one type
+     */
+    template<typename T>
+    class fftPlanCache {
+    public:
+      ~fftPlanCache() {
+        typename std::map<int,fftPlan<T>*>::iterator it;
+        for (it=plans.begin();it!=plans.end();++it) {
+          delete (*it).second;
+        }
+      }
+
+      mutex lock;
+      std::map<int,fftPlan<T>*> plans;
+    };
+
+    static fftPlanCache<float> floatPlans;
+    static fftPlanCache<double> doublePlans;
+
+    static inline fftPlanCache<float>& getCache(const float&) {
+      return floatPlans;
+    }
+
+    static inline fftPlanCache<double>& getCache(const double&) {
+      return doublePlans;
+    }
+
+    // ------------------------------------------------------------------
+    // fftPlan
+    // ------------------------------------------------------------------
+
+    template<typename T>
+    const fftPlan<T>& fftPlan<T>::get(const int n) {
+      fftPlanCache<T>& cache = getCache(T());
+      cache.lock.lock();
+      typename std::map<int,fftPlan<T>*>::iterator it = cache.plans.find(n);
+      if (it == cache.plans.end()) {
+        fftPlan<T>* plan = 0;
+        try {
+          plan = new fftPlan<T>(n);
+        } catch (...) {
+          cache.lock.unlock();
+          throw;
+        }
+        it = cache.plans.insert(std::make_pair(n,plan)).first;
+      }
+      const fftPlan<T>& plan = *(*it).second;
+      cache.lock.unlock();
+      return plan;
+    }
+
+    template<typename T>
+    fftPlan<T>::fftPlan(const int n)
+      : n_(n),full_(0),half_(0) {
+
+      if ((n >= 4) && isPowerOfTwo(n)) {
+        // Ooura's routines initialize their tables on the first call
+        const int ipSize = 3 + static_cast<int>(sqrt(n + 0.5));
+        std::vector<T> zeros(2*n,T(0));
+
+        ipReal_.resize(ipSize,0);
+        wReal_.resize(n,T(0));
+        fft::rdft(n,1,&zeros[0],&ipReal_[0],&wReal_[0]);
+
+        ipComplex_.resize(ipSize,0);
+        wComplex_.resize(n,T(0));
+        fft::cdft(2*n,1,&zeros[0],&ipComplex_[0],&wComplex_[0]);
+      } else {
+        full_ = new mixedRadixFFT<T>(n);
+
+        if ((n % 2) == 0) {
+          const int h = n/2;
+          half_ = new mixedRadixFFT<T>(h);
+          realTwiddles_.resize(2*(h+1));
+          for (int k=0;k<=h;++k) {
+            const double a = 2.0*Pi*k/n;
+            realTwiddles_[2*k]   = static_cast<T>(cos(a));
+            realTwiddles_[2*k+1] = static_cast<T>(sin(a));
+          }
+        }
+      }
+    }
+
+    template<typename T>
+    fftPlan<T>::~fftPlan() {
+      delete full_;
+      full_ = 0;
+      delete half_;
+      half_ = 0;
+    }
+
+    template<typename T>
+    void fftPlan<T>::prepare(workspace& ws,const std::vector<int>& ip) const {
+      if (isNull(full_)) {
+        ws.ip = ip;
+      } else if (static_cast<int>(ws.data.size()) < 4*n_) {
+        ws.data.resize(4*n_);
+      }
+    }
+
+    template<typename T>
+    void fftPlan<T>::realForward(const T* in,T* out,workspace& ws) const {
+      typedef fftComplex<T> cpx;
+      const int n = n_;
+      const int h = n/2;
+      prepare(ws,ipReal_);
+
+      if (isNull(full_)) {
+        // Ooura: X[n/2] is stored in the imaginary part of X[0]
+        std::copy(in,in+n,out);
+        fft::rdft(n,1,out,&ws.ip[0],const_cast<T*>(&wReal_[0]));
+        out[n]   = out[1];
+        out[n+1] = T(0);
+        out[1]   = T(0);
+      } else if (notNull(half_)) {
+        // even size: transform of the n/2 complex values x[2j]+i*x[2j+1]
+        cpx* z = reinterpret_cast<cpx*>(&ws.data[0]);
+        half_->transform(reinterpret_cast<const cpx*>(in),z);
+        const cpx* tw = reinterpret_cast<const cpx*>(&realTwiddles_[0]);
+        cpx* x = reinterpret_cast<cpx*>(out);
+        for (int k=0;k<=h;++k) {
+          const cpx& zk  = z[(k == h) ? 0 : k];
+          const cpx& zmk = z[(k == 0) ? 0 : h-k];
+          // even and odd parts of the spectrum
+          const T er = (zk.r + zmk.r)*T(0.5);
+          const T ei = (zk.i - zmk.i)*T(0.5);
+          const T or_ = (zk.i + zmk.i)*T(0.5);
+          const T oi = (zmk.r - zk.r)*T(0.5);
+          x[k].r = er + tw[k].r*or_ - tw[k].i*oi;
+          x[k].i = ei + tw[k].r*oi + tw[k].i*or_;
+        }
+        x[0].i = T(0);
+        x[h].i = T(0);
+      } else {
+        // odd size: complex transform with zero imaginary parts
+        cpx* a = reinterpret_cast<cpx*>(&ws.data[0]);
+        cpx* b = a + n;
+        for (int j=0;j<n;++j) {
+          a[j].r = in[j];
+          a[j].i = T(0);
+        }
+        full_->transform(a,b);
+        std::copy(&b[0].r,&b[0].r+2*(h+1),out);
+        out[1] = T(0);
+      }
+    }
+
+    template<typename T>
+    void fftPlan<T>::realInverse(const T* in,
+                                 T* out,
+                                 const T scale,
+                                 workspace& ws) const {
+      typedef fftComplex<T> cpx;
+      const int n = n_;
+      const int h = n/2;
+      int j,k;
+      prepare(ws,ipReal_);
+
+      if (isNull(full_)) {
+        // Ooura computes n/2 times the inverse
+        const T f = T(2)*scale;
+        out[0] = f*in[0];
+        out[1] = f*in[n];
+        for (k=2;k<n;++k) {
+          out[k] = f*in[k];
+        }
+        fft::rdft(n,-1,out,&ws.ip[0],const_cast<T*>(&wReal_[0]));
+      } else if (notNull(half_)) {
+        // even size: build the transform of x[2j]+i*x[2j+1] and invert it
+        // as the conjugate of the forward transform of the conjugate
+        const cpx* x = reinterpret_cast<const cpx*>(in);
+        const cpx* tw = reinterpret_cast<const cpx*>(&realTwiddles_[0]);
+        cpx* z = reinterpret_cast<cpx*>(&ws.data[0]);
+        for (k=0;k<h;++k) {
+          const cpx& xk  = x[k];
+          const cpx& xmk = x[h-k];
+          const T er = xk.r + xmk.r;
+          const T ei = xk.i - xmk.i;
+          const T dr = xk.r - xmk.r;
+          const T di = xk.i + xmk.i;
+          // o = d * conj(tw)
+          const T or_ = dr*tw[k].r + di*tw[k].i;
+          const T oi = di*tw[k].r - dr*tw[k].i;
+          // conj(e + i*o)
+          z[k].r = er - oi;
+          z[k].i = -(ei + or_);
+        }
+        cpx* y = reinterpret_cast<cpx*>(out);
+        half_->transform(z,y);
+        for (j=0;j<h;++j) {
+          y[j].r *= scale;
+          y[j].i *= -scale;
+        }
+      } else {
+        // odd size: complex transform of the conjugated hermitian spectrum
+        cpx* a = reinterpret_cast<cpx*>(&ws.data[0]);
+        cpx* b = a + n;
+        const cpx* x = reinterpret_cast<const cpx*>(in);
+        a[0].r = x[0].r;
+        a[0].i = T(0);
+        for (k=1;k<=h;++k) {
+          a[k].r = a[n-k].r = x[k].r;
+          a[n-k].i = x[k].i;
+          a[k].i = -x[k].i;
+        }
+        full_->transform(a,b);
+        for (j=0;j<n;++j) {
+          out[j] = scale*b[j].r;
+        }
+      }
+    }
+
+    template<typename T>
+    void fftPlan<T>::complexForward(T* data,workspace& ws) const {
+      typedef fftComplex<T> cpx;
+      prepare(ws,ipComplex_);
+
+      if (isNull(full_)) {
+        fft::cdft(2*n_,1,data,&ws.ip[0],const_cast<T*>(&wComplex_[0]));
+      } else {
+        T* tmp = &ws.data[0];
+        std::copy(data,data+2*n_,tmp);
+        full_->transform(reinterpret_cast<const cpx*>(tmp),
+                         reinterpret_cast<cpx*>(data));
+      }
+    }
+
+    template<typename T>
+    void fftPlan<T>::complexInverse(T* data,workspace& ws) const {
+      typedef fftComplex<T> cpx;
+      prepare(ws,ipComplex_);
+
+      if (isNull(full_)) {
+        fft::cdft(2*n_,-1,data,&ws.ip[0],const_cast<T*>(&wComplex_[0]));
+      } else {
+        const int n2 = 2*n_;
+        T* tmp = &ws.data[0];
+        int j;
+        for (j=0;j<n2;j+=2) {
+          tmp[j]   =  data[j];
+          tmp[j+1] = -data[j+1];
+        }
+        full_->transform(reinterpret_cast<const cpx*>(tmp),
+                         reinterpret_cast<cpx*>(data));
+        for (j=1;j<n2;j+=2) {
+          data[j] = -data[j];
+        }
+      }
+    }
+
+    // ------------------------------------------------------------------
+    // row and column drivers
+    // ------------------------------------------------------------------
+
+    /**
+     * Tasks of the drivers: each task processes a range of rows or
+     * columns.
+     */
+    template<typename T>
+    class fftJob : public threadPool::job {
+    public:
+      enum eStep {
+        RowsForward,
+        RowsInverse,
+        ColumnsForward,
+        ColumnsInverse
+      };
+
+      fftJob(const eStep step,const int items,const int threads)
+        : step_(step),items_(items),tasks_(max(1,min(items,threads))),
+          src(0),spectrum(0),dest(0),scale(T(1)) {
+      }
+
+      /**
+       * Execute all tasks
+       */
+      void run() {
+        if (tasks_ > 1) {
+          threadPool::getShared().run(*this,tasks_,tasks_);
+        } else {
+          execute(0);
+        }
+      }
+
+      virtual void execute(const int task) {
+        const int from = (task*items_)/tasks_;
+        const int to   = ((task+1)*items_)/tasks_;
+        typename fftPlan<T>::workspace ws;
+        int i;
+
+        switch (step_) {
+          case RowsForward: {
+            const fftPlan<T>& plan = fftPlan<T>::get(src->columns());
+            for (i=from;i<to;++i) {
+              plan.realForward(src->getRow(i).data(),
+                               spectrum->getRow(i).data(),ws);
+            }
+          } break;
+          case RowsInverse: {
+            const fftPlan<T>& plan = fftPlan<T>::get(dest->columns());
+            for (i=from;i<to;++i) {
+              plan.realInverse(spectrum->getRow(i).data(),
+                               dest->getRow(i).data(),scale,ws);
+            }
+          } break;
+          case ColumnsForward:
+          case ColumnsInverse: {
+            const int rows = spectrum->rows();
+            const fftPlan<T>& plan = fftPlan<T>::get(rows);
+            std::vector<T> col(2*rows);
+            int y;
+            for (i=from;i<to;++i) {
+              const int x = 2*i;
+              for (y=0;y<rows;++y) {
+                const T* s = &spectrum->at(y,x);
+                col[2*y]   = s[0];
+                col[2*y+1] = s[1];
+              }
+              if (step_ == ColumnsForward) {
+                plan.complexForward(&col[0],ws);
+              } else {
+                plan.complexInverse(&col[0],ws);
+              }
+              for (y=0;y<rows;++y) {
+                T* s = &spectrum->at(y,x);
+                s[0] = col[2*y];
+                s[1] = col[2*y+1];
+              }
+            }
+          } break;
+        }
+      }
+
+    private:
+      const eStep step_;
+      const int items_;
+      const int tasks_;
+
+    public:
+      const matrix<T>* src;
+      matrix<T>* spectrum;
+      matrix<T>* dest;
+      T scale;
+    };
+
+    template<typename T>
+    void fftRowsForward(const matrix<T>& src,
+                        const int threads,
+                        matrix<T>& real,
+                        matrix<T>& imag) {
+      const int rows = src.rows();
+      const int n = src.columns();
+      const int h = n/2;
+      matrix<T> spectrum(rows,2*(h+1));
+
+      fftJob<T> job(fftJob<T>::RowsForward,rows,threads);
+      job.src = &src;
+      job.spectrum = &spectrum;
+      job.run();
+
+      real.allocate(rows,h+1);
+      imag.allocate(rows,h+1);
+      for (int y=0;y<rows;++y) {
+        const T* s = spectrum.getRow(y).data();
+        T* re = real.getRow(y).data();
+        T* im = imag.getRow(y).data();
+        for (int k=0;k<=h;++k,s+=2) {
+          re[k] = s[0];
+          im[k] = s[1];
+        }
+      }
+    }
+
+    template<typename T>
+    void fftRowsInverse(const matrix<T>& real,
+                        const matrix<T>& imag,
+                        const int n,
+                        const int threads,
+                        matrix<T>& dest) {
+      const int rows = real.rows();
+      const int h = n/2;
+      const int cols = min(h+1,real.columns());
+      matrix<T> spectrum(rows,2*(h+1),T(0));
+      for (int y=0;y<rows;++y) {
+        const T* re = real.getRow(y).data();
+        const T* im = imag.getRow(y).data();
+        T* s = spectrum.getRow(y).data();
+        for (int k=0;k<cols;++k,s+=2) {
+          s[0] = re[k];
+          s[1] = im[k];
+        }
+      }
+
+      dest.allocate(rows,n);
+      fftJob<T> job(fftJob<T>::RowsInverse,rows,threads);
+      job.spectrum = &spectrum;
+      job.dest = &dest;
+      job.scale = T(1)/T(n);
+      job.run();
+    }
+
+    template<typename T>
+    void fft2DForward(const matrix<T>& src,
+                      const int threads,
+                      matrix<T>& real,
+                      matrix<T>& imag) {
+      const int ny = src.rows();
+      const int nx = src.columns();
+      const int h = nx/2;
+      matrix<T> spectrum(ny,2*(h+1));
+
+      // rows
+      fftJob<T> rowJob(fftJob<T>::RowsForward,ny,threads);
+      rowJob.src = &src;
+      rowJob.spectrum = &spectrum;
+      rowJob.run();
+
+      // columns of the half spectrum
+      fftJob<T> colJob(fftJob<T>::ColumnsForward,h+1,threads);
+      colJob.spectrum = &spectrum;
+      colJob.run();
+
+      // the other half is hermitian symmetric
+      real.allocate(ny,nx);
+      imag.allocate(ny,nx);
+      int y,x;
+      for (y=0;y<ny;++y) {
+        const T* s = spectrum.getRow(y).data();
+        const T* c = spectrum.getRow((ny-y)%ny).data();
+        T* re = real.getRow(y).data();
+        T* im = imag.getRow(y).data();
+        for (x=0;x<=h;++x) {
+          re[x] = s[2*x];
+          im[x] = s[2*x+1];
+        }
+        for (;x<nx;++x) {
+          const int cx = 2*(nx-x);
+          re[x] =  c[cx];
+          im[x] = -c[cx+1];
+        }
+      }
+
+      // purely real coefficients
+      imag.at(0,0) = T(0);
+      if ((nx % 2) == 0) {
+        imag.at(0,h) = T(0);
+      }
+      if ((ny % 2) == 0) {
+        imag.at(ny/2,0) = T(0);
+        if ((nx % 2) == 0) {
+          imag.at(ny/2,h) = T(0);
+        }
+      }
+    }
+
+    template<typename T>
+    void fft2DInverse(const matrix<T>& real,
+                      const matrix<T>& imag,
+                      const int threads,
+                      matrix<T>& dest) {
+      const int ny = real.rows();
+      const int nx = real.columns();
+      const int h = nx/2;
+      matrix<T> spectrum(ny,2*(h+1));
+      int y,x;
+      for (y=0;y<ny;++y) {
+        const T* re = real.getRow(y).data();
+        const T* im = imag.getRow(y).data();
+        T* s = spectrum.getRow(y).data();
+        for (x=0;x<=h;++x,s+=2) {
+          s[0] = re[x];
+          s[1] = im[x];
+        }
+      }
+
+      // columns
+      fftJob<T> colJob(fftJob<T>::ColumnsInverse,h+1,threads);
+      colJob.spectrum = &spectrum;
+      colJob.run();
+
+      // rows
+      dest.allocate(ny,nx);
+      fftJob<T> rowJob(fftJob<T>::RowsInverse,ny,threads);
+      rowJob.spectrum = &spectrum;
+      rowJob.dest = &dest;
+      rowJob.scale = T(1)/(T(nx)*T(ny));
+      rowJob.run();
+    }
+
+    // ------------------------------------------------------------------
+    // explicit instantiations
+    // ------------------------------------------------------------------
+
+    template class fftPlan<float>;
+    template class fftPlan<double>;
+
+    template void fftRowsForward(const matrix<float>&,const int,
+                                 matrix<float>&,matrix<float>&);
+    template void fftRowsForward(const matrix<double>&,const int,
+                                 matrix<double>&,matrix<double>&);
+
+    template void fftRowsInverse(const matrix<float>&,const matrix<float>&,
+                                 const int,const int,matrix<float>&);
+    template void fftRowsInverse(const matrix<double>&,const matrix<double>&,
+                                 const int,const int,matrix<double>&);
+
+    template void fft2DForward(const matrix<float>&,const int,
+                               matrix<float>&,matrix<float>&);
+    template void fft2DForward(const matrix<double>&,const int,
+                               matrix<double>&,matrix<double>&);
+
+    template void fft2DInverse(const matrix<float>&,const matrix<float>&,
+                               const int,matrix<float>&);
+    template void fft2DInverse(const matrix<double>&,const matrix<double>&,
+                               const int,matrix<double>&);
+  }
+}
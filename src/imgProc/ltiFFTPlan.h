@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiFFTPlan.h
+ *         Contains the class lti::internal::fftPlan, which holds the
+ *         precomputed tables of a one-dimensional FFT of a given size, and
+ *         the row/column drivers used by lti::fft and lti::ifft.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#ifndef _LTI_FFT_PLAN_H_
+#define _LTI_FFT_PLAN_H_
+
+#include "ltiMatrix.h"
+#include "ltiVector.h"
+#include <vector>
+
+namespace lti {
+  namespace internal {
+
+    /**
+     * Smallest power of two greater or equal \a n.
+     */
+    int fftPowerOfTwo(const int n);
+
+    /**
+     * Smallest size greater or equal \a n whose prime factors are only 2, 3,
+     * 5 and 7.  The transforms of these sizes are computed without padding
+     * by fftPlan.
+     *
+     * @param n minimum size
+     * @param even if true, the returned size is also even, as required by
+     *        the vector transforms, whose spectrum only stores n/2+1 values.
+     */
+    int fftFastSize(const int n, const bool even);
+
+    template<typename T>
+    class mixedRadixFFT;
+
+    /**
+     * Plan of a one-dimensional discrete Fourier transform of size n.
+     *
+     * A plan contains all tables required to transform data of one size
+     * (twiddle factors, bit reversal tables) and is created only once per
+     * size and type: get() returns a reference to a plan kept in a global
+     * cache, which can be used concurrently by several threads, as long as
+     * each one uses its own workspace.
+     *
+     * Sizes that are powers of two are transformed with the routines of
+     * Takuya Ooura (see ltiFFTinit.h).  All other sizes use a mixed radix
+     * algorithm with specialized butterflies for the factors 2, 3, 4 and 5,
+     * and a generic one for all other factors, which is efficient for
+     * small primes like 7.
+     *
+     * All transforms follow the sign convention of Ooura's routines, which
+     * the lti::fft has always used:
+     * \f$X[k] = \sum_j x[j] e^{2\pi i jk/n}\f$ for the forward transform, and
+     * the conjugated exponent for the inverse one.  Complex values are
+     * stored interleaved (real part followed by the imaginary one).
+     */
+    template<typename T>
+    class fftPlan {
+    public:
+      /**
+       * Work memory of a thread using a plan
+       */
+      class workspace {
+      public:
+        /**
+         * Data buffer
+         */
+        std::vector<T> data;
+
+        /**
+         * Bit reversal table of Ooura's routines, which is used as work
+         * area by them.
+         */
+        std::vector<int> ip;
+      };
+
+      /**
+       * Get the plan for transforms of size n.
+       *
+       * The plan is created the first time it is requested, and it is kept
+       * until the end of the program.
+       */
+      static const fftPlan<T>& get(const int n);
+
+      /**
+       * Destructor
+       */
+      ~fftPlan();
+
+      /**
+       * Size of the transform
+       */
+      inline int size() const;
+
+      /**
+       * Forward transform of the \a n real values in \a in.
+       *
+       * The result are the n/2+1 complex values (2*(n/2+1) elements)
+       * X[0] to X[n/2] left in \a out.  The other half of the spectrum is
+       * given by the hermitian symmetry X[n-k] = conj(X[k]).
+       */
+      void realForward(const T* in,T* out,workspace& ws) const;
+
+      /**
+       * Inverse of realForward().
+       *
+       * The n/2+1 complex values in \a in are transformed into the \a n real
+       * values in \a out, multiplied by \a scale.  Use scale = 1/n to get
+       * the normalized inverse.
+       */
+      void realInverse(const T* in,T* out,const T scale,workspace& ws) const;
+
+      /**
+       * In-place forward transform of \a n complex values.
+       */
+      void complexForward(T* data,workspace& ws) const;
+
+      /**
+       * In-place unnormalized inverse transform of \a n complex values.
+       */
+      void complexInverse(T* data,workspace& ws) const;
+
+    private:
+      /**
+       * Plans are only created by get()
+       */
+      explicit fftPlan(const int n);
+
+      /**
+       * Plans are not copied
+       */
+      fftPlan(const fftPlan<T>& other);
+
+      /**
+       * Plans are not copied
+       */
+      fftPlan<T>& operator=(const fftPlan<T>& other);
+
+      /**
+       * Prepare the workspace for this plan
+       */
+      void prepare(workspace& ws,const std::vector<int>& ip) const;
+
+      /**
+       * Size
+       */
+      int n_;
+
+      /**
+       * Ooura tables for the real transform of n values
+       */
+      std::vector<int> ipReal_;
+      std::vector<T> wReal_;
+
+      /**
+       * Ooura tables for the complex transform of n values
+       */
+      std::vector<int> ipComplex_;
+      std::vector<T> wComplex_;
+
+      /**
+       * Mixed radix transform of n complex values, if n is not a power of
+       * two
+       */
+      mixedRadixFFT<T>* full_;
+
+      /**
+       * Mixed radix transform of n/2 complex values, used for the real
+       * transforms of even sizes which are not powers of two.
+       */
+      mixedRadixFFT<T>* half_;
+
+      /**
+       * Twiddle factors exp(2 pi i k/n), k=0..n/2 for the real transforms
+       * computed through half_.
+       */
+      std::vector<T> realTwiddles_;
+    };
+
+    /**
+     * Two dimensional forward transform of \a src, whose size must be the
+     * size of the transform.
+     *
+     * The full complex spectrum is left in \a real and \a imag, which have
+     * the size of \a src.  The rows and then the columns are transformed
+     * using \a threads threads of the shared lti::threadPool.
+     */
+    template<typename T>
+    void fft2DForward(const matrix<T>& src,
+                      const int threads,
+                      matrix<T>& real,
+                      matrix<T>& imag);
+
+    /**
+     * Two dimensional normalized inverse transform of a complex spectrum.
+     *
+     * Only the columns 0 to columns/2 of the spectrum are used, the rest is
+     * assumed to be hermitian symmetric to them, since the result is real.
+     */
+    template<typename T>
+    void fft2DInverse(const matrix<T>& real,
+                      const matrix<T>& imag,
+                      const int threads,
+                      matrix<T>& dest);
+
+    /**
+     * Forward transform of each row of \a src, which must have \a n
+     * columns.  The rows of \a real and \a imag get n/2+1 columns each.
+     */
+    template<typename T>
+    void fftRowsForward(const matrix<T>& src,
+                        const int threads,
+                        matrix<T>& real,
+                        matrix<T>& imag);
+
+    /**
+     * Normalized inverse transform of each row of the half spectra given
+     * in \a real and \a imag.  The rows of \a dest get n columns.
+     */
+    template<typename T>
+    void fftRowsInverse(const matrix<T>& real,
+                        const matrix<T>& imag,
+                        const int n,
+                        const int threads,
+                        matrix<T>& dest);
+
+    template<typename T>
+    inline int fftPlan<T>::size() const {
+      return n_;
+    }
+
+  }
+}
+
+#endif
@@ -969,6 +969,12 @@ namespace lti {
       template void rdft2d<double>(int, int, int, matrix<double>&,
                                    double*, int*, double*);
 
+      template void rdft<float>(int, int, float*, int*, float*);
+      template void rdft<double>(int, int, double*, int*, double*);
+
+      template void cdft<float>(int, int, float*, int*, float*);
+      template void cdft<double>(int, int, double*, int*, double*);
+
     } // end namespace fft
   } // end namespace internal
 } // end namespace lti
@@ -267,6 +267,8 @@ namespace lti {
   // fastHessianDetection
   // --------------------------------------------------
 
+  const int fastHessianDetection::TileRows = 64;
+
   // default constructor
   fastHessianDetection::fastHessianDetection()
     : locationDetection() {
@@ -430,21 +432,8 @@ namespace lti {
         viewers[v]->show(levels.at(v));
       }      
 #endif      
-      for (int i=1;i<kernelSizes.lastIdx();++i) {
-        _lti_debug4("Search Level " << i << std::endl);
-
-        // Find the maxima
-        searchLevelExtremes(kernelSizes[i-1]*1.2f/9.0f,
-                            kernelSizes[i]*1.2f/9.0f,
-                            kernelSizes[i+1]*1.2f/9.0f,
-                            levels[i-1],
-                            levels[i],
-                            levels[i+1],
-                            sampleSteps.at(i),
-                            locs,
-                            strength,
-                            numLocs);
-      }
+      // Find the extrema
+      searchExtremes(levels,kernelSizes,sampleSteps,locs,strength,numLocs);
 
       return (selectLocations(locs,strength,numLocs) && 
               computeOrientations(intImg,locs));
@@ -512,19 +501,8 @@ namespace lti {
       getchar();
 #endif      
 
-      for (int i=1;i<kernelSizes.lastIdx();++i) {
-        // Find the maxima
-        searchLevelExtremes(kernelSizes[i-1]*1.2f/9.0f,
-                            kernelSizes[i]*1.2f/9.0f,
-                            kernelSizes[i+1]*1.2f/9.0f,
-                            levels[i-1],
-                            levels[i],
-                            levels[i+1],
-                            sampleSteps.at(i),
-                            locs,
-                            strength,
-                            numLocs);
-      }
+      // Find the extrema
+      searchExtremes(levels,kernelSizes,sampleSteps,locs,strength,numLocs);
 
       return (selectLocations(locs,strength,numLocs) && 
               computeOrientations(intImg,locs));
@@ -555,6 +533,8 @@ namespace lti {
                                                  const fmatrix& level,
                                                  const fmatrix& nextLevel,
                                                  const int sampleStep,
+                                                 const int fromRow,
+                                                 const int toRow,
                                                  list<location>& locs,
                                                  list<float>& strength,
                                                  int& numLocs) const {
@@ -566,9 +546,14 @@ namespace lti {
     
     // we run over the "internal" image, leaving one pixel border
     int x,y;
-    const int rows = level.rows()-sampleStep;
+    const int rows = min(level.rows()-sampleStep,toRow);
     const int cols = level.columns()-sampleStep;
 
+    // first sampled row in the given range
+    const int firstRow = max(sampleStep,fromRow);
+    const int tmp = firstRow%sampleStep;
+    const int startRow = (tmp != 0) ? firstRow+(sampleStep-tmp) : firstRow;
+
     location loc;
 
     fmatrix hessian(3,3,0.0f);
@@ -633,7 +618,7 @@ namespace lti {
     const float sqrstepi = 1.0f/sqr(fstep);
     const float sqrstep4 = sqrstepi/4.0f;
 
-    for (y=sampleStep;y<rows;y+=sampleStep) {
+    for (y=startRow;y<rows;y+=sampleStep) {
       for (x=sampleStep;x<cols;x+=sampleStep) {
 
         const float val    = level.at(y,x);
@@ -779,6 +764,118 @@ namespace lti {
     return true;
   }
 
+  /*
+   * Job searching the extrema in a tile of rows of one level per task.  Each
+   * task keeps its own lists, which are appended in the order of the tasks.
+   */
+  class fastHessianDetection::extremaJob : public threadPool::job {
+  public:
+    /**
+     * Constructor
+     */
+    extremaJob(const fastHessianDetection& owner,
+               const std::vector<fmatrix>& levels,
+               const ivector& kernelSizes,
+               const ivector& sampleSteps)
+      : owner_(owner),levels_(levels),kernelSizes_(kernelSizes),
+        sampleSteps_(sampleSteps),tasks_() {
+      // the first and last levels are only used as neighbours
+      for (int i=1;i<kernelSizes.lastIdx();++i) {
+        const int tiles = (levels[i].rows() + TileRows - 1)/TileRows;
+        for (int t=0;t<tiles;++t) {
+          tasks_.push_back(ipoint(i,t));
+        }
+      }
+      locs_.resize(tasks_.size());
+      strength_.resize(tasks_.size());
+      numLocs_.assign(tasks_.size(),0);
+    }
+
+    /**
+     * Number of tasks
+     */
+    int size() const {
+      return static_cast<int>(tasks_.size());
+    }
+
+    /**
+     * Search the tile of the task with the given index
+     */
+    virtual void execute(const int task) {
+      const int i = tasks_[task].x;
+      const int fromRow = tasks_[task].y*TileRows;
+      locs_[task].clear();
+      strength_[task].clear();
+      numLocs_[task]=0;
+      owner_.searchLevelExtremes(kernelSizes_[i-1]*1.2f/9.0f,
+                                 kernelSizes_[i]*1.2f/9.0f,
+                                 kernelSizes_[i+1]*1.2f/9.0f,
+                                 levels_[i-1],
+                                 levels_[i],
+                                 levels_[i+1],
+                                 sampleSteps_.at(i),
+                                 fromRow,fromRow+TileRows,
+                                 locs_[task],
+                                 strength_[task],
+                                 numLocs_[task]);
+    }
+
+    /**
+     * Move the locations of all tasks to the given lists, in the order of
+     * the tasks
+     */
+    void collect(list<location>& locs,
+                 list<float>& strength,
+                 int& numLocs) {
+      for (unsigned int t=0;t<tasks_.size();++t) {
+        locs.splice(locs.end(),locs_[t]);
+        strength.splice(strength.end(),strength_[t]);
+        numLocs+=numLocs_[t];
+      }
+    }
+
+  private:
+    const fastHessianDetection& owner_;
+    const std::vector<fmatrix>& levels_;
+    const ivector& kernelSizes_;
+    const ivector& sampleSteps_;
+
+    /**
+     * Level (x) and tile (y) of each task
+     */
+    std::vector<ipoint> tasks_;
+
+    /**
+     * Results of each task
+     */
+    std::vector< list<location> > locs_;
+    std::vector< list<float> > strength_;
+    std::vector<int> numLocs_;
+  };
+
+  bool fastHessianDetection::searchExtremes(const std::vector<fmatrix>& levels,
+                                            const ivector& kernelSizes,
+                                            const ivector& sampleSteps,
+                                            list<location>& locs,
+                                            list<float>& strength,
+                                            int& numLocs) const {
+    const parameters& param = getParameters();
+
+    extremaJob theJob(*this,levels,kernelSizes,sampleSteps);
+    const int threads = min(theJob.size(),
+                            threadPool::computeThreads(param.numberOfThreads));
+    if (threads > 1) {
+      threadPool::getShared().run(theJob,theJob.size(),threads);
+    } else {
+      for (int t=0;t<theJob.size();++t) {
+        theJob.execute(t);
+      }
+    }
+    theJob.collect(locs,strength,numLocs);
+
+    return true;
+  }
+
   bool fastHessianDetection::selectLocations(list<location>& locs,
                                              list<float>& strength,
                                              int& numLocs) const {
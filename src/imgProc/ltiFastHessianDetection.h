@@ -82,6 +82,15 @@ namespace lti {
    * The implementation here provides some configuration possibilities, but is
    * limited to provide the authors concept as reliable as the paper allowed.
    *
+   * The box filter responses of each level are evaluated for several
+   * neighbouring samples at once with the SIMD instructions available at
+   * compile time.  The levels are split into tiles of rows, which are
+   * processed in parallel according to parameters::numberOfThreads, both
+   * for the computation of the determinants and for the search of their
+   * extrema.  The locations found in each tile are concatenated in the
+   * order of the levels and rows, so that the result does not depend on the
+   * number of threads.
+   *
    * @see fastHessianDetection::parameters.
    * @see surfLocalDescriptor
    *
@@ -744,12 +753,20 @@ namespace lti {
      * @param kernelSize size of the kernel used.  The associated variance
      *                   can be computed as 1.2*kernelSize/9
      * @param intImg the integral image of the input image
+     * @param integrator functor used to compute the box sums
+     * @param sampleStep distance between the computed samples
+     * @param fromRow first row to be computed
+     * @param toRow row after the last one to be computed
+     * @param det determinants, which must already have the size of intImg.
+     *            Only the samples in the given rows are written.
      */
     template<typename T>
     bool computeDeterminant(const int kernelSize,
                             const matrix<T>& intImg,
                             const integralImage& integrator,
                             const int sampleStep,
+                            const int fromRow,
+                            const int toRow,
                             matrix<float>& det) const;
 
     /**
@@ -783,11 +800,15 @@ namespace lti {
      * @param level current level, corresponding to the given scale
      * @param nextLevel "next" level, with a lower degree of detail (higher
      *                  index in the pseudo-pyramid
+     * @param sampleStep distance between the samples of the levels
+     * @param fromRow first row of the level to be searched
+     * @param toRow row after the last one to be searched
      * @param locs list of detected locations.
      * @param strength determinant of the hessian matrix for the given location
      *                 Since this should not take much time, the value stored
      *                 is the one at the center of the 3x3x3 neighborhood, and
      *                 \e not the interpolated value for the maximum.
+     * @param numLocs incremented by the number of locations found
      */
     bool searchLevelExtremes(const float scalePrev,
                              const float scale,
@@ -796,10 +817,24 @@ namespace lti {
                              const fmatrix& level,
                              const fmatrix& nextLevel,
                              const int sampleStep,
+                             const int fromRow,
+                             const int toRow,
                              list<location>& locs,
                              list<float>& strength,
                              int& numLocs) const;
 
+    /**
+     * Search the extrema of all levels, calling searchLevelExtremes() for
+     * tiles of rows in parallel.  The locations are appended to the lists
+     * in the order of the levels and rows.
+     */
+    bool searchExtremes(const std::vector<fmatrix>& levels,
+                        const ivector& kernelSizes,
+                        const ivector& sampleSteps,
+                        list<location>& locs,
+                        list<float>& strength,
+                        int& numLocs) const;
+
     /**
      * This method removes weak locations, depending on the parameter settings
      * @param locs list of detected locations.
@@ -829,6 +864,25 @@ namespace lti {
      * Internal class used to manage the orientation windows.
      */
     class orientationAccumulator;
+
+    /**
+     * Job computing the determinants of a tile of rows of one level per task
+     */
+    template<typename T>
+    class determinantJob;
+    template<typename T>
+    friend class determinantJob;
+
+    /**
+     * Job searching the extrema in a tile of rows of one level per task
+     */
+    class extremaJob;
+    friend class extremaJob;
+
+    /**
+     * Number of rows of the tiles in which the levels are processed
+     */
+    static const int TileRows;
     
     /**
      * Circle boundary LUT.
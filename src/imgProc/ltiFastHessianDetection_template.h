@@ -53,21 +53,101 @@
 #include "ltiArctanLUT.h"
 #include "ltiInterval.h"
 #include "ltiConstants.h"
+#include "ltiSimd.h"
+#include "ltiThreadPool.h"
 #include <vector>
 
 namespace lti {
 
+  namespace internal {
+
+    /**
+     * Sums of the elements of a box, computed from an integral image at
+     * simd<float>::width positions separated by a constant step.
+     *
+     * The sums are computed with the same operations as
+     * integralImage::internalSum() and returned as floats.  This generic
+     * version is used only if no SIMD instructions are available for the
+     * type T of the integral image.
+     */
+    template<typename T>
+    struct fastHessianBox {
+      /**
+       * True if the specialization for T uses SIMD instructions
+       */
+      static const bool accelerated = false;
+
+      /**
+       * Box sums at the positions 0, step, 2*step, ... of the given rows.
+       *
+       * @param top row of the integral image just above the box
+       * @param bottom last row of the box in the integral image
+       * @param left column offset just left of the box
+       * @param right column offset of the last column of the box
+       * @param step distance between the positions
+       */
+      static inline simd<float>::reg sum(const T*,const T*,
+                                         const int,const int,const int) {
+        return simd<float>::zero();
+      }
+    };
+
+    template<>
+    struct fastHessianBox<float> {
+      typedef simd<float> S;
+      static const bool accelerated = S::accelerated;
+
+      static inline S::reg fetch(const float* p,const int step) {
+        return (step == 1) ? S::load(p) : S::gather(p,step);
+      }
+
+      static inline S::reg sum(const float* top,const float* bottom,
+                               const int left,const int right,
+                               const int step) {
+        return S::sub(S::add(fetch(bottom+right,step),fetch(top+left,step)),
+                      S::add(fetch(top+right,step),fetch(bottom+left,step)));
+      }
+    };
+
+#if defined(__AVX2__) || (defined(__SSE4_1__) && !defined(__AVX__))
+
+    // only if the registers for int32 and float have the same width
+    template<>
+    struct fastHessianBox<int32> {
+      typedef simd<int32> S;
+      static const bool accelerated = true;
+
+      static inline S::reg fetch(const int32* p,const int step) {
+        return (step == 1) ? S::load(p) : S::gather(p,step);
+      }
+
+      static inline simd<float>::reg sum(const int32* top,const int32* bottom,
+                                         const int left,const int right,
+                                         const int step) {
+        const S::reg s =
+          S::sub(S::add(fetch(bottom+right,step),fetch(top+left,step)),
+                 S::add(fetch(top+right,step),fetch(bottom+left,step)));
+#  if defined(__AVX2__)
+        return _mm256_cvtepi32_ps(s);
+#  else
+        return _mm_cvtepi32_ps(s);
+#  endif
+      }
+    };
+
+#endif
+
+  }
 
   template<typename T> bool 
   fastHessianDetection::computeDeterminant(const int kernelSize,
                                            const matrix<T>& intImg,
                                            const integralImage& integrator,
                                            const int sampleStep,
+                                           const int fromRow,
+                                           const int toRow,
                                            matrix<float>& det) const {
 
-    det.allocate(intImg.size());
-//     det.assign(intImg.size(),std::numeric_limits<float>::max()); // debug
-    
     // According to the paper the 9x9 kernels are build as follow
     // Dxx and Dyy (just Dyy shown) and Dxx
 
@@ -116,12 +196,10 @@ namespace lti {
                 frobRatio << std::endl);
 
     // To efficienty compute the filters, we have to avoid computing the
-    // boundary conditions for maximal number of pixels.  So, we have first the
-    // main loop, where the internalSum() methods can be used
-
-    // -------------
-    // The main loop
-    // -------------
+    // boundary conditions for maximal number of pixels.  So, we have first
+    // the main block of each row, where the internalSum() methods can be
+    // used, and the boundary parts of the row afterwards.  The rows above
+    // and below the main block are completely boundary.
 
     int val = (hSide+1);
     int tmp = val%sampleStep;
@@ -131,8 +209,27 @@ namespace lti {
     const int lastMainLoopRow = det.rows()    - hSide;
     const int lastMainLoopCol = det.columns() - hSide;
 
-    for (y=startPos;y<lastMainLoopRow;y+=sampleStep) {
-      for (x=startPos;x<lastMainLoopCol;x+=sampleStep) {
+    const int xLeft = min(startPos,det.columns());
+    val = max(xLeft,lastMainLoopCol);
+    tmp = val%sampleStep;
+    const int xRight = (tmp != 0) ? val + (sampleStep-tmp) : val;
+
+    const bool boundary = (param.boundaryType != NoBoundary);
+
+    // samples computed at once in the main block
+    typedef internal::fastHessianBox<T> box;
+    typedef internal::simd<float> S;
+    const int span = S::width*sampleStep;
+    const S::reg three = S::set1(3.0f);
+    const S::reg frobRatioS = S::set1(frobRatio);
+    const S::reg normS = S::set1(norm);
+    float buffer[S::width];
+
+    // first sampled row in the given range
+    tmp = fromRow%sampleStep;
+    y = (tmp != 0) ? fromRow + (sampleStep-tmp) : fromRow;
+
+    for (;y<toRow;y+=sampleStep) {
 
   // Define a macro to have this code just once
 
@@ -177,53 +274,89 @@ namespace lti {
 
   // END OF MACRO DEFINITION
 
-        _LTI_INTERNAL_COMPUTE_DETERMINANT_BLOCK(internalSum);
+      if ((y < startPos) || (y >= lastMainLoopRow)) {
+        // upper or bottom part
+        if (boundary) {
+          for (x=0;x<det.columns();x+=sampleStep) {
+            _LTI_INTERNAL_COMPUTE_DETERMINANT_BLOCK(sum);
+          }
+        }
+        continue;
       }
-    }
-
-    // ------------------
-    // The Boundary Loops
-    // ------------------
-
-    if (param.boundaryType == NoBoundary) {
-      return true;
-    }
 
-    // upper part
-    const int yTop = min(startPos,det.rows());
-    for (y=0;y<yTop;y+=sampleStep) {
-      for (x=0;x<det.columns();x+=sampleStep) {
-        _LTI_INTERNAL_COMPUTE_DETERMINANT_BLOCK(sum);
+      // -------------------------------
+      // The main block, vectorized part
+      // -------------------------------
+
+      x = startPos;
+      if (box::accelerated) {
+        // rows of the integral image just above and at the bottom of the
+        // boxes
+        const T *const dxxTop = intImg[y-dxx1Height-1].data();
+        const T *const dxxBot = intImg[y+dxx1Height].data();
+        const T *const dyy1Top = intImg[y-hSide-1].data();
+        const T *const dyy1Bot = intImg[y+hSide].data();
+        const T *const dyy2Top = intImg[y-dxx2Width-1].data();
+        const T *const dyy2Bot = intImg[y+dxx2Width].data();
+        const T *const dxyUTop = intImg[y-dxyEx-1].data();
+        const T *const dxyUBot = intImg[y-dxyIn].data();
+        const T *const dxyLTop = intImg[y+dxyIn-1].data();
+        const T *const dxyLBot = intImg[y+dxyEx].data();
+
+        float* const detRow = det[y].data();
+
+        for (;x+span-sampleStep<lastMainLoopCol;x+=span) {
+          const S::reg vdxx =
+            S::sub(box::sum(dxxTop+x,dxxBot+x,-hSide-1,hSide,sampleStep),
+                   S::mul(three,box::sum(dxxTop+x,dxxBot+x,
+                                         -dxx2Width-1,dxx2Width,
+                                         sampleStep)));
+          const S::reg vdyy =
+            S::sub(box::sum(dyy1Top+x,dyy1Bot+x,
+                            -dxx1Height-1,dxx1Height,sampleStep),
+                   S::mul(three,box::sum(dyy2Top+x,dyy2Bot+x,
+                                         -dxx1Height-1,dxx1Height,
+                                         sampleStep)));
+          const S::reg vdxy =
+            S::sub(S::sub(S::add(box::sum(dxyUTop+x,dxyUBot+x,
+                                          -dxyEx-1,-dxyIn,sampleStep),
+                                 box::sum(dxyLTop+x,dxyLBot+x,
+                                          dxyIn-1,dxyEx,sampleStep)),
+                          box::sum(dxyLTop+x,dxyLBot+x,
+                                   -dxyEx-1,-dxyIn,sampleStep)),
+                   box::sum(dxyUTop+x,dxyUBot+x,dxyIn-1,dxyEx,sampleStep));
+
+          S::store(buffer,
+                   S::mul(S::sub(S::mul(vdxx,vdyy),
+                                 S::mul(S::mul(frobRatioS,vdxy),vdxy)),
+                          normS));
+
+          float* d = detRow+x;
+          for (int k=0;k<S::width;++k,d+=sampleStep) {
+            *d = buffer[k];
+          }
+        }
       }
-    }
-    
-    val = max(yTop,lastMainLoopRow);
-    tmp = val%sampleStep;
-    const int startBottom = (tmp != 0) ? val + (sampleStep-tmp) : val;
 
-    // bottom part
-    for (y=startBottom;y<det.rows();y+=sampleStep) {
-      for (x=0;x<det.columns();x+=sampleStep) {
-        _LTI_INTERNAL_COMPUTE_DETERMINANT_BLOCK(sum);
+      // the remaining samples of the main block
+      for (;x<lastMainLoopCol;x+=sampleStep) {
+        _LTI_INTERNAL_COMPUTE_DETERMINANT_BLOCK(internalSum);
       }
-    }
 
-    // sides
-    const int xLeft = min(startPos,det.columns());
+      // ----------------
+      // The Boundary Parts
+      // ----------------
 
-    val = max(xLeft,lastMainLoopCol);
-    tmp = val%sampleStep;
-    const int xRight = (tmp != 0) ? val + (sampleStep-tmp) : val;
-
-    for (y=startPos;y<lastMainLoopRow;y+=sampleStep) {
-      // the left side
-      for (x=0;x<xLeft;x+=sampleStep) {
-        _LTI_INTERNAL_COMPUTE_DETERMINANT_BLOCK(sum);
-      }
+      if (boundary) {
+        // the left side
+        for (x=0;x<xLeft;x+=sampleStep) {
+          _LTI_INTERNAL_COMPUTE_DETERMINANT_BLOCK(sum);
+        }
 
-      // the right side
-      for (x=xRight;x<det.columns();x+=sampleStep) {
-        _LTI_INTERNAL_COMPUTE_DETERMINANT_BLOCK(sum);
+        // the right side
+        for (x=xRight;x<det.columns();x+=sampleStep) {
+          _LTI_INTERNAL_COMPUTE_DETERMINANT_BLOCK(sum);
+        }
       }
     }
 
@@ -232,6 +365,67 @@ namespace lti {
     return true;
   }
 
+  /*
+   * Job computing the determinants of a tile of rows of one level per task.
+   */
+  template<typename T>
+  class fastHessianDetection::determinantJob : public threadPool::job {
+  public:
+    /**
+     * Constructor
+     */
+    determinantJob(const fastHessianDetection& owner,
+                   const matrix<T>& intImg,
+                   const integralImage& integrator,
+                   const ivector& kernelSizes,
+                   const ivector& sampleSteps,
+                   std::vector<fmatrix>& levels)
+      : owner_(owner),intImg_(intImg),integrator_(integrator),
+        kernelSizes_(kernelSizes),sampleSteps_(sampleSteps),levels_(levels),
+        tasks_() {
+      const int tiles = (intImg.rows() + TileRows - 1)/TileRows;
+      for (int i=0;i<kernelSizes.size();++i) {
+        for (int t=0;t<tiles;++t) {
+          tasks_.push_back(ipoint(i,t));
+        }
+      }
+    }
+
+    /**
+     * Number of tasks
+     */
+    int size() const {
+      return static_cast<int>(tasks_.size());
+    }
+
+    /**
+     * Compute the tile of the task with the given index
+     */
+    virtual void execute(const int task) {
+      const int level = tasks_[task].x;
+      const int fromRow = tasks_[task].y*TileRows;
+      const int toRow = min(fromRow+TileRows,intImg_.rows());
+      owner_.computeDeterminant(kernelSizes_.at(level),
+                                intImg_,
+                                integrator_,
+                                sampleSteps_.at(level),
+                                fromRow,toRow,
+                                levels_[level]);
+    }
+
+  private:
+    const fastHessianDetection& owner_;
+    const matrix<T>& intImg_;
+    const integralImage& integrator_;
+    const ivector& kernelSizes_;
+    const ivector& sampleSteps_;
+    std::vector<fmatrix>& levels_;
+
+    /**
+     * Level (x) and tile (y) of each task
+     */
+    std::vector<ipoint> tasks_;
+  };
   
   /*
    * Compute the "pseudo-pyramid".
@@ -314,13 +508,26 @@ namespace lti {
     integralImage integrator(param.boundaryType);    
     integrator.apply(chnl,intImg);
 
-    // initialize the levels
+    // initialize the levels, each one with the sampling step of the
+    // previous one
+    ivector detSteps(kernelSizes.size());
     for (int i=0;i<kernelSizes.size();++i) {
-      computeDeterminant(kernelSizes.at(i),
-                         intImg,
-                         integrator,
-                         (i<1)?param.initialSamplingStep:sampleSteps.at(i-1),
-                         levels.at(i));
+      levels[i].allocate(intImg.size());
+      detSteps.at(i) = (i<1)?param.initialSamplingStep:sampleSteps.at(i-1);
+    }
+
+    // the tiles do not depend on the number of threads, and neither do the
+    // results
+    determinantJob<typename typeInfo<T>::accumulation_type>
+      theJob(*this,intImg,integrator,kernelSizes,detSteps,levels);
+    const int threads = min(theJob.size(),
+                            threadPool::computeThreads(param.numberOfThreads));
+    if (threads > 1) {
+      threadPool::getShared().run(theJob,theJob.size(),threads);
+    } else {
+      for (int t=0;t<theJob.size();++t) {
+        theJob.execute(t);
+      }
     }
 
     return true;
@@ -33,6 +33,8 @@
 #define _LTI_GAUSSIAN_PYRAMID_H_
 
 #include "ltiPyramid.h"
+#include "ltiPyramidReduction.h"
+#include "ltiVector.h"
 #include "ltiTypes.h"
 #include "ltiContainer.h"
 
@@ -51,6 +53,16 @@ namespace lti {
    *
    * The template type T is the type of the elements in the pyramid.
    *
+   * The object is meant to be kept and reused for a sequence of images,
+   * like the frames of a video: the memory of the levels and of the
+   * internal buffers is reused if the size of the images does not change.
+   * For channels of scalar elements the smoothing and downsampling of each
+   * level are done in one pass, which only computes the retained pixels
+   * (see lti::internal::pyramidReduction), optionally in parallel bands of
+   * rows (see setNumberOfThreads()).  The results are the same as those of
+   * lti::downsampling.  The time spent on each level and the memory used can
+   * be queried with getLevelTimes() and getMemoryUsage().
+   *
    * Example:
    *
    * \code
@@ -120,6 +132,33 @@ namespace lti {
                              const bool gaussian = true);
 
 
+    /**
+     * Set the number of threads used to compute each level (see
+     * lti::functor::parameters::numberOfThreads).  Zero or negative values
+     * use as many threads as processors are available.  The result does
+     * not depend on the number of threads.
+     *
+     * Default value: 1
+     */
+    void setNumberOfThreads(const int numberOfThreads);
+
+    /**
+     * Return the number of threads used to compute each level.
+     */
+    int getNumberOfThreads() const;
+
+    /**
+     * Wall time in microseconds spent on each level in the last call of
+     * generate().  The time of level 0 is the one needed to copy the source.
+     */
+    const dvector& getLevelTimes() const;
+
+    /**
+     * Number of bytes used by the levels of the pyramid and by the buffers
+     * kept for the next call of generate().
+     */
+    int getMemoryUsage() const;
+
     /**
      * Returns the complete name of the functor class
      */
@@ -221,6 +260,21 @@ namespace lti {
      * rectangular(false)
      */
     bool gaussian_;
+
+    /**
+     * number of threads used to compute each level
+     */
+    int numberOfThreads_;
+
+    /**
+     * time spent on each level in the last generate()
+     */
+    dvector levelTimes_;
+
+    /**
+     * fused smoothing and downsampling, with its buffers
+     */
+    internal::pyramidReduction<typename T::value_type> reduction_;
   };
 
 } // namespace lti
@@ -38,6 +38,7 @@
 #include "ltiKernel1D.h"
 #include "ltiKernel2D.h"
 #include "ltiSeparableKernel.h"
+#include "ltiTimer.h"
 
 namespace lti {
 
@@ -68,7 +69,8 @@ namespace lti {
                                       const double& variance,
                                       const bool upsampleWithGaussian)
     : pyramid<T>(resolutions),kernelSize_(gaussianSize),
-      kernelVariance_(variance),gaussian_(upsampleWithGaussian) {
+      kernelVariance_(variance),gaussian_(upsampleWithGaussian),
+      numberOfThreads_(1) {
   }
 
   /*
@@ -77,7 +79,7 @@ namespace lti {
    */
   template <class T>
   gaussianPyramid<T>::gaussianPyramid(const gaussianPyramid<T>& other) 
-    : pyramid<T>() {
+    : pyramid<T>(),numberOfThreads_(1) {
     copy(other);
   }
 
@@ -121,6 +123,31 @@ namespace lti {
     gaussian_ = useGaussian;
   }
 
+  template <class T>
+  void gaussianPyramid<T>::setNumberOfThreads(const int numberOfThreads) {
+    numberOfThreads_ = numberOfThreads;
+  }
+
+  template <class T>
+  int gaussianPyramid<T>::getNumberOfThreads() const {
+    return numberOfThreads_;
+  }
+
+  template <class T>
+  const dvector& gaussianPyramid<T>::getLevelTimes() const {
+    return levelTimes_;
+  }
+
+  template <class T>
+  int gaussianPyramid<T>::getMemoryUsage() const {
+    int bytes = reduction_.getBufferBytes();
+    for (int i=0;i<this->size();++i) {
+      bytes += this->at(i).rows()*this->at(i).columns()*
+               sizeof(typename T::value_type);
+    }
+    return bytes;
+  }
+
   /*
    * assigment operator.
    * copy the contents of <code>other</code> in this %object.
@@ -135,6 +162,8 @@ namespace lti {
     gaussian_ = other.gaussian_;
     kernelVariance_ = other.kernelVariance_;
     kernelSize_ = other.kernelSize_;
+    numberOfThreads_ = other.numberOfThreads_;
+    levelTimes_.copy(other.levelTimes_);
 
     return *this;
   }
@@ -169,7 +198,14 @@ namespace lti {
       return;
     }
 
+    timer chron(timer::Wall);
+    levelTimes_.assign(this->size(),0.0);
+
+    // the memory of the level is reused if the size does not change
+    chron.start();
     this->at(0).copy(src);
+    chron.stop();
+    levelTimes_.at(0) = chron.getTime();
 
     downsampling downsampler;
     downsampling::parameters dParam;
@@ -183,9 +219,21 @@ namespace lti {
 
     downsampler.setParameters(dParam);
 
+    // the fused smoothing and downsampling requires a separable kernel and
+    // levels not smaller than the kernel.  Otherwise (or for images) the
+    // downsampling functor is used.
+    const bool fused = reduction_.setKernel(kern);
+
     int i;
     for (i=1;i<this->size();++i) {
-      downsampler.apply(this->at(i-1),this->at(i));
+      chron.start();
+      if (fused && reduction_.canProcess(this->at(i-1).size())) {
+        reduction_.apply(this->at(i-1),2,numberOfThreads_,this->at(i));
+      } else {
+        downsampler.apply(this->at(i-1),this->at(i));
+      }
+      chron.stop();
+      levelTimes_.at(i) = chron.getTime();
     }
   }
 
@@ -195,7 +243,8 @@ namespace lti {
   template <class T>
   void gaussianPyramid<T>::generate(const T& src, const int theResolutions) {
 
-    this->resize(theResolutions,false);
+    // keep the existing levels, whose memory will be reused
+    this->resize(theResolutions,true);
     generate(src);
   }
 
@@ -302,7 +351,7 @@ namespace lti {
       }
     } else {
 
-      if (gaussian) {
+      if (gaussian_) {
         upsampling upsampler;
         upsampling::parameters uParam;
 
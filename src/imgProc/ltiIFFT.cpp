@@ -50,7 +50,8 @@
  */
 
 #include "ltiIFFT.h"
-#include "ltiFFTinit.h"
+#include "ltiFFTPlan.h"
+#include "ltiThreadPool.h"
 
 namespace lti {
 
@@ -132,84 +133,135 @@ namespace lti {
   // -------------------------------------------------------------------
 
 
+  /*
+   * Number of threads used for a transform with the given number of
+   * elements.  Small transforms are not worth the synchronization.
+   */
+  static int ifftThreads(const int numberOfThreads,const int elements) {
+    if ((numberOfThreads == 1) || (elements < 16384)) {
+      return 1;
+    }
+    return threadPool::computeThreads(numberOfThreads);
+  }
+
+  /*
+   * Pack the n2h+1 coefficients of a half spectrum into the interleaved
+   * complex array used by internal::fftPlan<T>::realInverse().
+   */
+  template<typename T>
+  static void packHalfSpectrum(const int n2h,
+                               const T* re,
+                               const T* im,
+                               const eCoordinateSystem mode,
+                               T* spectrum) {
+    int k;
+    if (mode == lti::Polar) {
+      T sina, cosa;
+      for (k=0; k<=n2h; k++) {
+        const int k2 = (k << 1); // 2*k
+        sincos(im[k], sina, cosa);
+        spectrum[k2]   = re[k]*cosa;
+        spectrum[k2+1] = re[k]*sina;
+      }
+    } else { // Cartesic
+      for (k=0; k<=n2h; k++) {
+        const int k2 = (k << 1); // 2*k
+        spectrum[k2]   = re[k];
+        spectrum[k2+1] = im[k];
+      }
+    }
+    // the transform of a real signal has a real DC and Nyquist component
+    spectrum[1] = spectrum[2*n2h+1] = T(0);
+  }
+
   template<typename T>
   bool ifft::worker(const vector<T>& realInput,
                     const vector<T>& imagInput,
                     const eCoordinateSystem mode,
                     vector<T>& realOutput) const {
 
-    int ldn, originalSize;
-    int  k ;
-
-    // buffers needed by rdft2d
-    int *ip, n, m;
-    T* w;
-
     if(realInput.size() != imagInput.size() ) {
       setStatusString("Input vector sizes do not match");
       return false;
     }
 
-    // size must follow size = 2^n+1
-    originalSize = realInput.size();
+    if (realInput.size() < 2) {
+      setStatusString("Input vectors must contain at least two elements");
+      return false;
+    }
 
     // input data is just one half of the original spectrum
     // the original data are twice the size
+    const int originalSize = realInput.size();
+    const int n2h = getParameters().padToPowerOfTwo ?
+      internal::fftPowerOfTwo(originalSize-1) : originalSize-1;
+    const int n = 2*n2h;
 
-    // n is always a power of 2
-    ldn = static_cast<int>(ceil(log(double(originalSize-1))/log(2.0)));
-    n = (1 << ldn); // n = 2^ldn
-
-    // vector size 2x in space-domain
-    realOutput.assign(n*2, T(0));
+    // coefficients not given in the input are zero
+    vector<T> spectrum(n+2,T(0));
+    packHalfSpectrum(min(n2h,originalSize-1),
+                     realInput.data(),imagInput.data(),mode,
+                     spectrum.data());
 
-    const T factor = T(2)/T(n);
+    realOutput.allocate(n);
 
-    // if input data polar:
-    if(mode == lti::Polar) {
-
-      realOutput[0] = factor*realInput[0]*cos(imagInput[0]);
-      
-      T sina, cosa;
-
-      for (k =1; k < n; k++){
-        const int k2 = (k << 1); // 2*k
-        sincos(imagInput[k], sina, cosa);
-        realOutput[k2]   = factor*realInput[k]*cosa;
-        realOutput[k2+1] = factor*realInput[k]*sina;
-      }
+    // inverse FFT
+    typename internal::fftPlan<T>::workspace ws;
+    internal::fftPlan<T>::get(n).realInverse(spectrum.data(),
+                                             realOutput.data(),
+                                             T(1)/T(n),ws);
 
-      realOutput[1] = factor*realInput[n]*cos(imagInput[n]);
+    return true;
 
-    } else { // Cartesic
-      realOutput[0] = factor*realInput[0];
+  } //apply for vectors
 
-      for (k =1; k < n; k++){
-        const int k2 = (k << 1); // 2*k
-        realOutput[k2]   = factor*realInput[k];
-        realOutput[k2+1] = factor*imagInput[k];
-      }
+  template<typename T>
+  bool ifft::rowsWorker(const matrix<T>& realInput,
+                        const matrix<T>& imagInput,
+                        matrix<T>& realOutput) const {
+    if (realInput.size() != imagInput.size()) {
+      setStatusString("Input matrices sizes do not match");
+      return false;
+    }
 
-      realOutput[1] = factor*realInput[n];
+    if (realInput.columns() < 2) {
+      setStatusString("Input matrices must contain at least two columns");
+      return false;
     }
 
-    // initialize fft
-    ip = internal::fft::alloc_1d<int>(2 + (int) sqrt(2*n + 0.5));
-    m = 2*n * 5 / 4 + (2*n) / 4;
-    w = internal::fft::alloc_1d<T>(m);
-    ip[0] = 0;
+    const parameters& par = getParameters();
+    const int originalSize = realInput.columns();
+    const int n2h = par.padToPowerOfTwo ?
+      internal::fftPowerOfTwo(originalSize-1) : originalSize-1;
+    const int n = 2*n2h;
+    const int threads = ifftThreads(par.numberOfThreads,realInput.rows()*n);
 
-    // inverse FFT
-    internal::fft::vrdft(2*n, -1, realOutput,  ip, w);
+    if ((par.mode == lti::Cartesian) && (n2h+1 == originalSize)) {
+      internal::fftRowsInverse(realInput,imagInput,n,threads,realOutput);
+      return true;
+    }
 
-    // delete arrays
-    internal::fft::free_1d<T>(w);
-    internal::fft::free_1d<int>(ip);
+    // convert the spectra to the cartesian half spectra of size n
+    matrix<T> re(realInput.rows(),n2h+1,T(0));
+    matrix<T> im(realInput.rows(),n2h+1,T(0));
+    vector<T> spectrum(n+2,T(0));
+    const int last = min(n2h,originalSize-1);
+    for (int y=0;y<realInput.rows();++y) {
+      packHalfSpectrum(last,
+                       realInput.getRow(y).data(),
+                       imagInput.getRow(y).data(),
+                       par.mode,spectrum.data());
+      vector<T>& reRow = re.getRow(y);
+      vector<T>& imRow = im.getRow(y);
+      for (int k=0;k<=last;++k) {
+        reRow[k] = spectrum[2*k];
+        imRow[k] = spectrum[2*k+1];
+      }
+    }
 
+    internal::fftRowsInverse(re,im,n,threads,realOutput);
     return true;
-
-  } //apply for vectors
-
+  }
 
   /// apply Real Inv FFT to real vectors
   //  size of output is N !
@@ -254,165 +306,83 @@ namespace lti {
     return apply(realInput,imagInput,getParameters().mode,realOutput);
   }
 
+  bool ifft::applyRows(const fmatrix& realInput,
+                       const fmatrix& imagInput,
+                       fmatrix& realOutput) const {
+    return rowsWorker(realInput,imagInput,realOutput);
+  }
+
+  bool ifft::applyRows(const dmatrix& realInput,
+                       const dmatrix& imagInput,
+                       dmatrix& realOutput) const {
+    return rowsWorker(realInput,imagInput,realOutput);
+  }
+
   /// apply Real FFT to real fmatrices
   bool ifft::apply(const fmatrix & realInput,
                    const fmatrix & imagInput,
                    const eCoordinateSystem mode,
                    fmatrix & realOutput) const{
 
-    int originalXsize, originalYsize, ldn;
-
-    // buffers needed by rdft2d
-    int *ip, ny, nx, n, j1, j2;
-    float *t, *w;
-
     if (realInput.rows() != imagInput.rows() ||
         realInput.columns() != imagInput.columns()) {
       setStatusString("Input fmatrices sizes do not match");
       return false;
     }
 
-    // size must be always be 2^n
-    originalXsize = realInput.columns();
-    originalYsize = realInput.rows();
+    if (realInput.empty()) {
+      realOutput.clear();
+      return true;
+    }
 
-    // ny und nx are always powers of 2
-    ldn = static_cast<int>(ceil(log(double(originalYsize))/log(2.0)));
-    ny   = 1 << ldn; // n = 2^ldn
+    const parameters& par = getParameters();
 
-    ldn = static_cast<int>(ceil(log(double(originalXsize))/log(2.0)));
-    nx   = 1 << ldn; // n = 2^ldn
+    // size of the transform
+    int ny,nx;
+    if (par.padToPowerOfTwo) {
+      ny = internal::fftPowerOfTwo(realInput.rows());
+      nx = internal::fftPowerOfTwo(realInput.columns());
+    } else {
+      ny = realInput.rows();
+      nx = realInput.columns();
+    }
 
-    const float factor = 2.0f/(nx*ny);
+    const int threads = ifftThreads(par.numberOfThreads,nx*ny);
 
-    realOutput.assign(ny, nx, 0.0f);
+    if ((mode == lti::Cartesian) &&
+        (ny == realInput.rows()) && (nx == realInput.columns())) {
+      internal::fft2DInverse(realInput,imagInput,threads,realOutput);
+      return true;
+    }
 
-    const int nyh = ny/2;
-    const int nxh = nx/2;
+    // only the columns 0..nx/2 of the spectrum are used
+    const int lastRow = realInput.rows();
+    const int lastCol = min(nx/2+1,realInput.columns());
+    fmatrix re(ny,nx,0.0f);
+    fmatrix im(ny,nx,0.0f);
 
-    // for polar input data...
     if (mode != lti::Cartesian) {
-      
-      // Polar coordinates (this is very slow!)
+      // Polar coordinates
       float sina, cosa;
-      
-      // First half of rows (except the first)
-      for(j1=1; j1<nyh; j1++) {
-        const fvector& reIn = realInput.getRow(j1);
-        const fvector& imIn = imagInput.getRow(j1);
-        fvector& out = realOutput[j1];
-        
-        for(j2=1; j2<nxh;j2++){
-          const int j22 = (j2 << 1); // x2
-          sincos(imIn[j2], sina, cosa);
-          const float mag = factor*reIn[j2];
-          out[j22]   = mag*cosa;
-          out[j22+1] = mag*sina;
-        }
-
-        sincos(imIn[0], sina, cosa);
-        const float mag = factor*reIn[0];
-        out[0] = mag*cosa;
-        out[1] = mag*sina;
-        sincos(-imIn[nxh], sina, cosa);
-        const float magh = factor*reIn[nxh];
-        realOutput[ny-j1][1] = magh*cosa;
-        realOutput[ny-j1][0] = magh*sina;
-      }
-      
-      // keep on with the rows, without the last lines
-      for(; j1<ny; j1++){
-        const fvector& reIn = realInput.getRow(j1);
-        const fvector& imIn = imagInput.getRow(j1);
-        fvector& out = realOutput[j1];
-        for(j2=1; j2<nxh;j2++){
-          const int j22 = j2 << 1; // x2
-          sincos(imIn[j2], sina, cosa);
-          const float mag = factor*reIn[j2];
-          out[j22]   = mag*cosa;
-          out[j22+1] = mag*sina;
-        }
-      }
-      
-      // very first row
-      for(j2=1; j2<nxh;j2++){
-        const int j22 = j2 << 1; // x2
-        sincos(imagInput[0][j2], sina, cosa);
-        const float mag = factor*realInput[0][j2];
-        realOutput[0][j22]   = mag*cosa;
-        realOutput[0][j22+1] = mag*sina;
-      }
-
-      realOutput[0][0]   = factor*realInput[0][0]*cos(imagInput[0][0]);
-      realOutput[0][1]   = factor*realInput[0][nxh]*cos(imagInput[0][nxh]);
-      realOutput[nyh][0] = factor*realInput[nyh][0]*cos(imagInput[nyh][0]);
-      realOutput[nyh][1] = factor*realInput[nyh][nxh]*cos(imagInput[nyh][nxh]);
-
-    } else { //Cartesic
-
-      // First half or the rows, except the first one
-      for(j1=1; j1<nyh; j1++){
-        const fvector& reIn = realInput.getRow(j1);
-        const fvector& imIn = imagInput.getRow(j1);
-        fvector& out = realOutput[j1];
-
-        for(j2=1; j2<nxh;j2++){
-          const int j22 = (j2 << 1); // x2
-          out[j22]   = factor*reIn[j2]; // =  R[ny-j1][nx-j2],
-          out[j22+1] = factor*imIn[j2]; // = -I[ny-j1][nx-j2],
-        }
-
-        out[0] = factor*reIn[0];// = realInput[ny-j1][0],
-        out[1] = factor*imIn[0];// = -imagInput[ny-j1][0],
-        const int cj1 = ny-j1;
-        realOutput[cj1][1] =  factor*reIn[nxh];//=realInput[ny-j1][nxh],
-        realOutput[cj1][0] = -factor*imIn[nxh];//=imagInput[ny-j1][nxh],
-      }
-
-      // next half of rows, without the last lines
-      for(; j1<ny; j1++){
-        const fvector& reIn = realInput.getRow(j1);
-        const fvector& imIn = imagInput.getRow(j1);
-        fvector& out = realOutput[j1];
-
-        for(j2=1; j2<nxh;j2++){
-          const int j22 = (j2 << 1); // x2
-          out[j22]   = factor*reIn[j2];// = R[ny-j1][nx-j2],
-          out[j22+1] = factor*imIn[j2];// = -I[ny-j1][nx-j2],
+      for (int y=0;y<lastRow;++y) {
+        const fvector& reIn = realInput.getRow(y);
+        const fvector& imIn = imagInput.getRow(y);
+        fvector& reOut = re.getRow(y);
+        fvector& imOut = im.getRow(y);
+        for (int x=0;x<lastCol;++x) {
+          sincos(imIn[x], sina, cosa);
+          reOut[x] = reIn[x]*cosa;
+          imOut[x] = reIn[x]*sina;
         }
       }
-
-      // very first row
-      for(j2=1; j2<nxh;j2++){
-        const int j22 = (j2 << 1); // x2
-        realOutput[0][j22]   = factor*realInput[0][j2]; // =  R[0][nx-j2],
-        realOutput[0][j22+1] = factor*imagInput[0][j2]; // = -I[0][nx-j2],
+    } else {
+      for (int y=0;y<lastRow;++y) {
+        re.getRow(y).fill(realInput.getRow(y),0,lastCol-1);
+        im.getRow(y).fill(imagInput.getRow(y),0,lastCol-1);
       }
-
-      realOutput[0][0]   = factor*realInput[0][0];
-      realOutput[0][1]   = factor*realInput[0][nxh];
-      realOutput[nyh][0] = factor*realInput[nyh][0];
-      realOutput[nyh][1] = factor*realInput[nyh][nxh];
     }
 
-    ////////////////////////////////////////////////////////////////////
-    // initialize fft
-
-    t = internal::fft::alloc_1d<float>(2 * ny);
-    n = max(ny, nx / 2);
-    ip = internal::fft::alloc_1d<int>(2 + (int) sqrt(n + 0.5));
-    n = max(ny * 5 / 4, nx * 5 / 4) + nx / 4;
-    w = internal::fft::alloc_1d<float>(n);
-    ip[0] = 0; // flag to indicate "initialization required!"
-
-    // inverse FFT
-    internal::fft::rdft2d(ny, nx, -1, realOutput, t, ip, w);
-
-    // delete arrays
-    internal::fft::free_1d<float>(w);
-    internal::fft::free_1d<int>(ip);
-    internal::fft::free_1d<float>(t);
-
+    internal::fft2DInverse(re,im,threads,realOutput);
     return true;
   } //apply for fmatrices
   
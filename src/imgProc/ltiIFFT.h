@@ -77,7 +77,10 @@ namespace lti {
    * of the output data) even though only half of the size would be required.
    *
    * In both versions (for vector and matrix), the input data must be of a
-   * power of 2 size.
+   * power of 2 size, if parameters::padToPowerOfTwo is true.  Otherwise any
+   * size is accepted: a vector spectrum with n/2+1 elements produces n
+   * values, and a matrix spectrum is transformed with its own size, which is
+   * fastest for sizes whose prime factors are 2, 3, 5 and 7.
    *
    * In the case of channels, the DC component of the signal is in the
    * upper-left corner of the two-dimensional FFT, and in the case of vectors
@@ -260,6 +263,31 @@ namespace lti {
                const eCoordinateSystem mode,
                fmatrix& dest) const;
 
+    /**
+     * Compute the inverse FFT of each row of the given half spectra, as
+     * returned by fft::applyRows().
+     *
+     * Each row of \c dest is the result of apply() on the corresponding
+     * rows of \c real and \c imag.
+     *
+     * @param real the real part (or magnitude) of the spectra
+     * @param imag the imaginary part (or angle) of the spectra
+     * @param dest the real output data, one vector per row
+     */
+    bool applyRows(const fmatrix& real,
+                   const fmatrix& imag,
+                   fmatrix& dest) const;
+
+    /**
+     * Compute the inverse FFT of each row of the given half spectra, as
+     * returned by fft::applyRows().
+     *
+     * @see applyRows(const fmatrix&,const fmatrix&,fmatrix&)
+     */
+    bool applyRows(const dmatrix& real,
+                   const dmatrix& imag,
+                   dmatrix& dest) const;
+
     /**
      * Copy data of "other" functor.
      * @param other the functor to be copied
@@ -304,6 +332,13 @@ namespace lti {
                 const eCoordinateSystem mode,
                 vector<T>& dest) const;
 
+    /**
+     * Worker for the rows of matrices
+     */
+    template<typename T>
+    bool rowsWorker(const matrix<T>& real,
+                    const matrix<T>& imag,
+                    matrix<T>& dest) const;
   };
 }
 
@@ -0,0 +1,501 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiMatrixTransform.cpp
+ *         Contains the class lti::internal::matrixTransformKernels, with the
+ *         non-template row kernels of lti::matrixTransform.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include "ltiMatrixTransform.h"
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX__)
+#  include <immintrin.h>
+#elif defined(__SSE4_1__)
+#  include <smmintrin.h>
+#endif
+
+namespace lti {
+  namespace internal {
+
+    const int32 matrixTransformKernels::Invalid =
+      std::numeric_limits<int32>::min();
+
+    const float matrixTransformKernels::Limit = 262144.0f;
+
+    typedef matrixTransformKernels kernels;
+
+    // fixed-point value of the coordinate c, clipped to +/-Limit (NaN is
+    // mapped to -Limit, as the vectorized version does)
+    static inline int32 toFixed(const float c) {
+      const float l = kernels::Limit;
+      const float v = (c > -l) ? ((c < l) ? c : l) : -l;
+      return static_cast<int32>(std::lrint(v*kernels::One));
+    }
+
+#if defined(__AVX__)
+    // vectorized version of toFixed()
+    static inline __m256i toFixed(const __m256 c) {
+      const __m256 v = _mm256_min_ps(_mm256_max_ps(c,
+                                       _mm256_set1_ps(-kernels::Limit)),
+                                     _mm256_set1_ps(kernels::Limit));
+      return _mm256_cvtps_epi32(_mm256_mul_ps(v,
+                                  _mm256_set1_ps(float(kernels::One))));
+    }
+#endif
+
+    // -----------------------------------------------------------------
+    // Coordinates
+    // -----------------------------------------------------------------
+
+    matrixTransformCoordinates::matrixTransformCoordinates()
+      : projective(false) {
+    }
+
+    void matrixTransformCoordinates::accumulate(const int n,
+                                                const float first,
+                                                const float step,
+                                                fvector& terms) {
+      terms.allocate(n);
+      float acc = first;
+      for (int i=0;i<n;++i) {
+        terms[i] = acc;
+        acc += step;
+      }
+    }
+
+    void matrixTransformCoordinates::fixedRow(const int row,
+                                              const int n,
+                                              int32* cx,
+                                              int32* cy) const {
+      const float rx = rowX[row];
+      const float ry = rowY[row];
+      const float* const px = colX.data();
+      const float* const py = colY.data();
+      int i=0;
+
+      if (!projective) {
+#if defined(__AVX__)
+        for (;i+8<=n;i+=8) {
+          const __m256 vx = _mm256_add_ps(_mm256_loadu_ps(px+i),
+                                          _mm256_set1_ps(rx));
+          const __m256 vy = _mm256_add_ps(_mm256_loadu_ps(py+i),
+                                          _mm256_set1_ps(ry));
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(cx+i),toFixed(vx));
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(cy+i),toFixed(vy));
+        }
+#endif
+        for (;i<n;++i) {
+          cx[i] = toFixed(px[i] + rx);
+          cy[i] = toFixed(py[i] + ry);
+        }
+        return;
+      }
+
+      const float ra = rowA[row];
+      const float* const pa = colA.data();
+#if defined(__AVX__)
+      const __m256 invalid =
+        _mm256_castsi256_ps(_mm256_set1_epi32(kernels::Invalid));
+      for (;i+8<=n;i+=8) {
+        const __m256 va = _mm256_add_ps(_mm256_loadu_ps(pa+i),
+                                        _mm256_set1_ps(ra));
+        const __m256 ai = _mm256_div_ps(_mm256_set1_ps(1.0f),va);
+        const __m256 vx = _mm256_add_ps(_mm256_loadu_ps(px+i),
+                                        _mm256_set1_ps(rx));
+        const __m256 vy = _mm256_add_ps(_mm256_loadu_ps(py+i),
+                                        _mm256_set1_ps(ry));
+        const __m256 zero = _mm256_cmp_ps(va,_mm256_setzero_ps(),_CMP_EQ_OQ);
+        const __m256 fx =
+          _mm256_castsi256_ps(toFixed(_mm256_mul_ps(vx,ai)));
+        const __m256 fy =
+          _mm256_castsi256_ps(toFixed(_mm256_mul_ps(vy,ai)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(cx+i),
+                      _mm256_castps_si256(_mm256_blendv_ps(fx,invalid,zero)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(cy+i),
+                      _mm256_castps_si256(_mm256_blendv_ps(fy,
+                                                           _mm256_setzero_ps(),
+                                                           zero)));
+      }
+#endif
+      for (;i<n;++i) {
+        const float a = pa[i] + ra;
+        if (a == 0.0f) {
+          cx[i] = kernels::Invalid;
+          cy[i] = 0;
+        } else {
+          const float ai = 1.0f/a;
+          cx[i] = toFixed((px[i] + rx)*ai);
+          cy[i] = toFixed((py[i] + ry)*ai);
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------
+    // Single pixels
+    // -----------------------------------------------------------------
+
+    static const float fracScale = 1.0f/kernels::One;
+
+    static inline bool bilinearPixel(const float* src,
+                                     const int columns,const int rows,
+                                     const int32 cx,const int32 cy,
+                                     float& dest) {
+      if (!kernels::insideBilinear(cx,cy,columns,rows)) {
+        return false;
+      }
+      const float* p = src + (cy >> kernels::FracBits)*columns +
+                             (cx >> kernels::FracBits);
+      const float fx = (cx & kernels::FracMask)*fracScale;
+      const float fy = (cy & kernels::FracMask)*fracScale;
+      const float tmp1 = p[0] + (p[1]-p[0])*fx;
+      const float tmp2 = p[columns] + (p[columns+1]-p[columns])*fx;
+      dest = tmp1 + (tmp2-tmp1)*fy;
+      return true;
+    }
+
+    static inline bool bilinearPixel(const ubyte* src,
+                                     const int columns,const int rows,
+                                     const int32 cx,const int32 cy,
+                                     ubyte& dest) {
+      if (!kernels::insideBilinear(cx,cy,columns,rows)) {
+        return false;
+      }
+      const ubyte* p = src + (cy >> kernels::FracBits)*columns +
+                             (cx >> kernels::FracBits);
+      const float fx = (cx & kernels::FracMask)*fracScale;
+      const float fy = (cy & kernels::FracMask)*fracScale;
+      const int a = p[0];
+      const int b = p[1];
+      const int c = p[columns];
+      const int d = p[columns+1];
+      const float tmp1 = a + (b-a)*fx;
+      const float tmp2 = c + (d-c)*fx;
+      dest = static_cast<ubyte>(tmp1 + (tmp2-tmp1)*fy);
+      return true;
+    }
+
+    // as bilinearInterpolation<rgbaPixel>, the alpha channel is set to zero
+    static inline bool bilinearPixel(const rgbaPixel* src,
+                                     const int columns,const int rows,
+                                     const int32 cx,const int32 cy,
+                                     rgbaPixel& dest) {
+      if (!kernels::insideBilinear(cx,cy,columns,rows)) {
+        return false;
+      }
+      const rgbaPixel* p = src + (cy >> kernels::FracBits)*columns +
+                                 (cx >> kernels::FracBits);
+      const float fx = (cx & kernels::FracMask)*fracScale;
+      const float fy = (cy & kernels::FracMask)*fracScale;
+#if defined(__SSE4_1__)
+      const __m128i r0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+      const __m128i r1 =
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p+columns));
+      const __m128 a = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(r0));
+      const __m128 b = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(r0,4)));
+      const __m128 c = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(r1));
+      const __m128 d = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(r1,4)));
+      const __m128 vfx = _mm_set1_ps(fx);
+      const __m128 tmp1 = _mm_add_ps(a,_mm_mul_ps(_mm_sub_ps(b,a),vfx));
+      const __m128 tmp2 = _mm_add_ps(c,_mm_mul_ps(_mm_sub_ps(d,c),vfx));
+      __m128i r = _mm_cvttps_epi32(_mm_add_ps(tmp1,
+                                    _mm_mul_ps(_mm_sub_ps(tmp2,tmp1),
+                                               _mm_set1_ps(fy))));
+      r = _mm_packus_epi32(r,r);
+      r = _mm_packus_epi16(r,r);
+      dest.getValue() = static_cast<uint32>(_mm_cvtsi128_si32(r)) & 0x00ffffff;
+#else
+      const rgbaPixel* q = p+columns;
+      float tmp1,tmp2;
+      tmp1 = p[0].red + (p[1].red-p[0].red)*fx;
+      tmp2 = q[0].red + (q[1].red-q[0].red)*fx;
+      const ubyte red = static_cast<ubyte>(tmp1 + (tmp2-tmp1)*fy);
+      tmp1 = p[0].green + (p[1].green-p[0].green)*fx;
+      tmp2 = q[0].green + (q[1].green-q[0].green)*fx;
+      const ubyte green = static_cast<ubyte>(tmp1 + (tmp2-tmp1)*fy);
+      tmp1 = p[0].blue + (p[1].blue-p[0].blue)*fx;
+      tmp2 = q[0].blue + (q[1].blue-q[0].blue)*fx;
+      const ubyte blue = static_cast<ubyte>(tmp1 + (tmp2-tmp1)*fy);
+      dest.set(red,green,blue,0);
+#endif
+      return true;
+    }
+
+    template<typename T>
+    static inline bool nearestPixel(const T* src,
+                                    const int columns,const int rows,
+                                    const int32 cx,const int32 cy,
+                                    T& dest) {
+      if (!kernels::insideNearest(cx,cy,columns,rows)) {
+        return false;
+      }
+      dest = src[((cy + kernels::One/2) >> kernels::FracBits)*columns +
+                 ((cx + kernels::One/2) >> kernels::FracBits)];
+      return true;
+    }
+
+    // process the pixels of [from,to) one by one and return the number of
+    // pixels left
+    template<typename T>
+    static inline int bilinearPixels(const T* src,
+                                     const int columns,const int rows,
+                                     const int32* cx,const int32* cy,
+                                     const int from,const int to,
+                                     T* dest) {
+      int left=0;
+      for (int i=from;i<to;++i) {
+        if (!bilinearPixel(src,columns,rows,cx[i],cy[i],dest[i])) {
+          ++left;
+        }
+      }
+      return left;
+    }
+
+    template<typename T>
+    static inline int nearestPixels(const T* src,
+                                    const int columns,const int rows,
+                                    const int32* cx,const int32* cy,
+                                    const int from,const int to,
+                                    T* dest) {
+      int left=0;
+      for (int i=from;i<to;++i) {
+        if (!nearestPixel(src,columns,rows,cx[i],cy[i],dest[i])) {
+          ++left;
+        }
+      }
+      return left;
+    }
+
+    // -----------------------------------------------------------------
+    // Rows
+    // -----------------------------------------------------------------
+
+#if defined(__AVX2__)
+    // true if all 0<=x<=lastX and 0<=y<=lastY
+    static inline bool inside(const __m256i x,const __m256i lastX,
+                              const __m256i y,const __m256i lastY) {
+      const __m256i ok =
+        _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_max_epu32(x,lastX),lastX),
+                         _mm256_cmpeq_epi32(_mm256_max_epu32(y,lastY),lastY));
+      return (_mm256_movemask_epi8(ok) == -1);
+    }
+
+    static inline __m256i loadFixed(const int32* p) {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    static inline __m256 fraction(const __m256i c) {
+      return _mm256_mul_ps(_mm256_cvtepi32_ps(
+                             _mm256_and_si256(c,
+                               _mm256_set1_epi32(kernels::FracMask))),
+                           _mm256_set1_ps(fracScale));
+    }
+
+    static inline __m256 lerp(const __m256 a,const __m256 b,const __m256 f) {
+      return _mm256_add_ps(a,_mm256_mul_ps(_mm256_sub_ps(b,a),f));
+    }
+
+    // store the lowest byte of each element
+    static inline void storeBytes(ubyte* p,const __m256i v) {
+      const __m128i w = _mm_packus_epi32(_mm256_castsi256_si128(v),
+                                         _mm256_extracti128_si256(v,1));
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(p),_mm_packus_epi16(w,w));
+    }
+#endif
+
+    int kernels::bilinear(const float* src,const int columns,const int rows,
+                          const int32* cx,const int32* cy,const int n,
+                          float* dest) {
+      int left=0;
+      int i=0;
+#if defined(__AVX2__)
+      if ((columns >= 2) && (rows >= 2)) {
+        const __m256i lastX = _mm256_set1_epi32(columns-2);
+        const __m256i lastY = _mm256_set1_epi32(rows-2);
+        const __m256i width = _mm256_set1_epi32(columns);
+        for (;i+8<=n;i+=8) {
+          const __m256i vx = loadFixed(cx+i);
+          const __m256i vy = loadFixed(cy+i);
+          const __m256i x0 = _mm256_srai_epi32(vx,FracBits);
+          const __m256i y0 = _mm256_srai_epi32(vy,FracBits);
+          if (!inside(x0,lastX,y0,lastY)) {
+            left += bilinearPixels(src,columns,rows,cx,cy,i,i+8,dest);
+            continue;
+          }
+          const __m256i idx =
+            _mm256_add_epi32(_mm256_mullo_epi32(y0,width),x0);
+          const __m256 a = _mm256_i32gather_ps(src,idx,4);
+          const __m256 b = _mm256_i32gather_ps(src+1,idx,4);
+          const __m256 c = _mm256_i32gather_ps(src+columns,idx,4);
+          const __m256 d = _mm256_i32gather_ps(src+columns+1,idx,4);
+          const __m256 fx = fraction(vx);
+          _mm256_storeu_ps(dest+i,lerp(lerp(a,b,fx),lerp(c,d,fx),
+                                       fraction(vy)));
+        }
+      }
+#endif
+      return left + bilinearPixels(src,columns,rows,cx,cy,i,n,dest);
+    }
+
+    int kernels::bilinear(const ubyte* src,const int columns,const int rows,
+                          const int32* cx,const int32* cy,const int n,
+                          ubyte* dest) {
+      int left=0;
+      int i=0;
+#if defined(__AVX2__)
+      // four bytes are gathered at once, which must not leave the row
+      if ((columns >= 4) && (rows >= 2)) {
+        const __m256i lastX = _mm256_set1_epi32(columns-4);
+        const __m256i lastY = _mm256_set1_epi32(rows-2);
+        const __m256i width = _mm256_set1_epi32(columns);
+        const __m256i mask = _mm256_set1_epi32(0xff);
+        const int* row0 = reinterpret_cast<const int*>(src);
+        const int* row1 = reinterpret_cast<const int*>(src+columns);
+        for (;i+8<=n;i+=8) {
+          const __m256i vx = loadFixed(cx+i);
+          const __m256i vy = loadFixed(cy+i);
+          const __m256i x0 = _mm256_srai_epi32(vx,FracBits);
+          const __m256i y0 = _mm256_srai_epi32(vy,FracBits);
+          if (!inside(x0,lastX,y0,lastY)) {
+            left += bilinearPixels(src,columns,rows,cx,cy,i,i+8,dest);
+            continue;
+          }
+          const __m256i idx =
+            _mm256_add_epi32(_mm256_mullo_epi32(y0,width),x0);
+          const __m256i w0 = _mm256_i32gather_epi32(row0,idx,1);
+          const __m256i w1 = _mm256_i32gather_epi32(row1,idx,1);
+          const __m256 a = _mm256_cvtepi32_ps(_mm256_and_si256(w0,mask));
+          const __m256 b = _mm256_cvtepi32_ps(
+                             _mm256_and_si256(_mm256_srli_epi32(w0,8),mask));
+          const __m256 c = _mm256_cvtepi32_ps(_mm256_and_si256(w1,mask));
+          const __m256 d = _mm256_cvtepi32_ps(
+                             _mm256_and_si256(_mm256_srli_epi32(w1,8),mask));
+          const __m256 fx = fraction(vx);
+          storeBytes(dest+i,
+                     _mm256_cvttps_epi32(lerp(lerp(a,b,fx),lerp(c,d,fx),
+                                              fraction(vy))));
+        }
+      }
+#endif
+      return left + bilinearPixels(src,columns,rows,cx,cy,i,n,dest);
+    }
+
+    int kernels::bilinear(const rgbaPixel* src,
+                          const int columns,const int rows,
+                          const int32* cx,const int32* cy,const int n,
+                          rgbaPixel* dest) {
+      // each pixel is already a vector of four channels
+      return bilinearPixels(src,columns,rows,cx,cy,0,n,dest);
+    }
+
+    // nearest neighbor of elements of four bytes
+    static int nearest32(const int32* src,const int columns,const int rows,
+                         const int32* cx,const int32* cy,const int n,
+                         int32* dest) {
+      int left=0;
+      int i=0;
+#if defined(__AVX2__)
+      if ((columns >= 1) && (rows >= 1)) {
+        const __m256i lastX = _mm256_set1_epi32(columns-1);
+        const __m256i lastY = _mm256_set1_epi32(rows-1);
+        const __m256i width = _mm256_set1_epi32(columns);
+        const __m256i half = _mm256_set1_epi32(kernels::One/2);
+        const int* base = reinterpret_cast<const int*>(src);
+        for (;i+8<=n;i+=8) {
+          const __m256i x =
+            _mm256_srai_epi32(_mm256_add_epi32(loadFixed(cx+i),half),
+                              kernels::FracBits);
+          const __m256i y =
+            _mm256_srai_epi32(_mm256_add_epi32(loadFixed(cy+i),half),
+                              kernels::FracBits);
+          if (!inside(x,lastX,y,lastY)) {
+            left += nearestPixels(src,columns,rows,cx,cy,i,i+8,dest);
+            continue;
+          }
+          const __m256i idx =
+            _mm256_add_epi32(_mm256_mullo_epi32(y,width),x);
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest+i),
+                              _mm256_i32gather_epi32(base,idx,4));
+        }
+      }
+#endif
+      return left + nearestPixels(src,columns,rows,cx,cy,i,n,dest);
+    }
+
+    int kernels::nearest(const ubyte* src,const int columns,const int rows,
+                         const int32* cx,const int32* cy,const int n,
+                         ubyte* dest) {
+      int left=0;
+      int i=0;
+#if defined(__AVX2__)
+      // four bytes are gathered at once, which must not leave the row
+      if ((columns >= 4) && (rows >= 1)) {
+        const __m256i lastX = _mm256_set1_epi32(columns-4);
+        const __m256i lastY = _mm256_set1_epi32(rows-1);
+        const __m256i width = _mm256_set1_epi32(columns);
+        const __m256i half = _mm256_set1_epi32(One/2);
+        const int* base = reinterpret_cast<const int*>(src);
+        for (;i+8<=n;i+=8) {
+          const __m256i x =
+            _mm256_srai_epi32(_mm256_add_epi32(loadFixed(cx+i),half),
+                              FracBits);
+          const __m256i y =
+            _mm256_srai_epi32(_mm256_add_epi32(loadFixed(cy+i),half),
+                              FracBits);
+          if (!inside(x,lastX,y,lastY)) {
+            left += nearestPixels(src,columns,rows,cx,cy,i,i+8,dest);
+            continue;
+          }
+          const __m256i idx =
+            _mm256_add_epi32(_mm256_mullo_epi32(y,width),x);
+          storeBytes(dest+i,
+                     _mm256_and_si256(_mm256_i32gather_epi32(base,idx,1),
+                                      _mm256_set1_epi32(0xff)));
+        }
+      }
+#endif
+      return left + nearestPixels(src,columns,rows,cx,cy,i,n,dest);
+    }
+
+    int kernels::nearest(const float* src,const int columns,const int rows,
+                         const int32* cx,const int32* cy,const int n,
+                         float* dest) {
+      return nearest32(reinterpret_cast<const int32*>(src),columns,rows,
+                       cx,cy,n,reinterpret_cast<int32*>(dest));
+    }
+
+    int kernels::nearest(const rgbaPixel* src,
+                         const int columns,const int rows,
+                         const int32* cx,const int32* cy,const int n,
+                         rgbaPixel* dest) {
+      return nearest32(reinterpret_cast<const int32*>(src),columns,rows,
+                       cx,cy,n,reinterpret_cast<int32*>(dest));
+    }
+
+  }
+}
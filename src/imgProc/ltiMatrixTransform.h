@@ -36,7 +36,10 @@
 #include "ltiMatrix.h"
 #include "ltiPoint3D.h"
 #include "ltiGeometricTransform.h"
+#include "ltiNearestNeighborInterpolation.h"
+#include "ltiRGBAPixel.h"
 #include "ltiPointList.h"
+#include "ltiThreadPool.h"
 
 namespace lti {
 
@@ -229,6 +232,212 @@ namespace lti {
   template<typename T>
   matrix<T> projection(const T& f);
 
+  namespace internal {
+    /**
+     * Source coordinates of the pixels of a matrix transformed with a 2x2,
+     * 2x3 or 3x3 matrix.
+     *
+     * The coordinates are built with the same incremental floating point
+     * sums as the per-pixel loops of matrixTransform always did: the source
+     * column of the pixel (row,col) is colX[col]+rowX[row], and its source
+     * row colY[col]+rowY[row].  For projective transformations both are
+     * divided by colA[col]+rowA[row], and pixels where this is zero have no
+     * source.
+     */
+    class matrixTransformCoordinates {
+    public:
+      /**
+       * Default constructor
+       */
+      matrixTransformCoordinates();
+
+      /**
+       * Terms of the source column, row and divisor that depend on the
+       * column of the transformed pixel
+       */
+      fvector colX,colY,colA;
+
+      /**
+       * Terms of the source column, row and divisor that depend on the
+       * row of the transformed pixel
+       */
+      fvector rowX,rowY,rowA;
+
+      /**
+       * True if the divisor terms are used
+       */
+      bool projective;
+
+      /**
+       * Resize \a terms to n elements with the values first, first+step,
+       * (first+step)+step, etc.
+       */
+      static void accumulate(const int n,
+                             const float first,
+                             const float step,
+                             fvector& terms);
+
+      /**
+       * Source coordinates of the pixel (row,col).
+       *
+       * @return false if the pixel has no source
+       */
+      inline bool at(const int row,const int col,float& x,float& y) const {
+        x = colX[col] + rowX[row];
+        y = colY[col] + rowY[row];
+        if (projective) {
+          const float alpha = colA[col] + rowA[row];
+          if (alpha == 0.0f) {
+            return false;
+          }
+          const float ai = 1.0f/alpha;
+          x *= ai;
+          y *= ai;
+        }
+        return true;
+      }
+
+      /**
+       * Fixed-point source coordinates (see matrixTransformKernels) of the
+       * first n pixels of the given row.
+       */
+      void fixedRow(const int row,const int n,int32* cx,int32* cy) const;
+    };
+
+    /**
+     * Row kernels of the fixed-point warping used by matrixTransform.
+     *
+     * The source coordinates of each destination pixel are given with
+     * FracBits fractional bits.  A column coordinate equal to Invalid
+     * denotes a pixel without source (singular projection), which is set
+     * to zero.
+     *
+     * The bilinear() and nearest() kernels only compute the pixels whose
+     * neighborhood lies completely within the source, and return the
+     * number of pixels left for the interpolator (see insideBilinear() and
+     * insideNearest()).  The source has to be a connected matrix.
+     *
+     * The fixed point format limits the precision of the source
+     * coordinates of these pixels to 1/4096 of a pixel.  All other pixels,
+     * types and interpolators use the floating point coordinates of
+     * matrixTransformCoordinates.
+     */
+    class matrixTransformKernels {
+    public:
+      /**
+       * Fixed-point format
+       */
+      enum {
+        FracBits = 12,           /**< Number of fractional bits   */
+        One = 1 << FracBits,     /**< Fixed-point representation of 1 */
+        FracMask = One - 1       /**< Mask of the fractional bits */
+      };
+
+      /**
+       * Column coordinate of pixels without source
+       */
+      static const int32 Invalid;
+
+      /**
+       * Coordinates farther than this (in pixels) are clipped to it
+       */
+      static const float Limit;
+
+      /**
+       * @name Types supported by the kernels
+       */
+      //@{
+      static inline bool supports(const ubyte*) {
+        return true;
+      }
+      static inline bool supports(const float*) {
+        return true;
+      }
+      static inline bool supports(const rgbaPixel*) {
+        return true;
+      }
+      template<typename T>
+      static inline bool supports(const T*) {
+        return false;
+      }
+      //@}
+
+      /**
+       * Test if the bilinear neighborhood of the coordinate lies within a
+       * source of the given size.
+       */
+      static inline bool insideBilinear(const int32 cx,const int32 cy,
+                                        const int columns,const int rows) {
+        return ((static_cast<unsigned int>(cx >> FracBits) <
+                 static_cast<unsigned int>(columns-1)) &&
+                (static_cast<unsigned int>(cy >> FracBits) <
+                 static_cast<unsigned int>(rows-1)));
+      }
+
+      /**
+       * Test if the nearest pixel of the coordinate lies within a source of
+       * the given size.
+       */
+      static inline bool insideNearest(const int32 cx,const int32 cy,
+                                       const int columns,const int rows) {
+        return ((static_cast<unsigned int>((cx + One/2) >> FracBits) <
+                 static_cast<unsigned int>(columns)) &&
+                (static_cast<unsigned int>((cy + One/2) >> FracBits) <
+                 static_cast<unsigned int>(rows)));
+      }
+
+      /**
+       * @name Bilinear interpolation of the inner pixels
+       */
+      //@{
+      static int bilinear(const ubyte* src,const int columns,const int rows,
+                          const int32* cx,const int32* cy,const int n,
+                          ubyte* dest);
+      static int bilinear(const float* src,const int columns,const int rows,
+                          const int32* cx,const int32* cy,const int n,
+                          float* dest);
+      static int bilinear(const rgbaPixel* src,
+                          const int columns,const int rows,
+                          const int32* cx,const int32* cy,const int n,
+                          rgbaPixel* dest);
+      //@}
+
+      /**
+       * @name Nearest neighbor of the inner pixels
+       */
+      //@{
+      static int nearest(const ubyte* src,const int columns,const int rows,
+                         const int32* cx,const int32* cy,const int n,
+                         ubyte* dest);
+      static int nearest(const float* src,const int columns,const int rows,
+                         const int32* cx,const int32* cy,const int n,
+                         float* dest);
+      static int nearest(const rgbaPixel* src,
+                         const int columns,const int rows,
+                         const int32* cx,const int32* cy,const int n,
+                         rgbaPixel* dest);
+      //@}
+
+      /**
+       * The kernels do not support other types (return -1)
+       */
+      template<typename T>
+      static int bilinear(const T*,const int,const int,
+                          const int32*,const int32*,const int,T*) {
+        return -1;
+      }
+
+      /**
+       * The kernels do not support other types (return -1)
+       */
+      template<typename T>
+      static int nearest(const T*,const int,const int,
+                         const int32*,const int32*,const int,T*) {
+        return -1;
+      }
+    };
+  }
+
   /**
    * Class matrixTransform.
    *
@@ -484,6 +693,33 @@ namespace lti {
    *   }
    * \endcode
    *
+   * \section mtmaps Precomputed coordinate maps
+   *
+   * For the 2x2, 2x3, 3x3 and 3x4 matrices the rows of the transformed
+   * matrix are distributed among parameters::numberOfThreads threads.
+   * Nearest neighbor and bilinear interpolation of \c ubyte, \c float and
+   * \c rgbaPixel matrices use vectorized inner loops for all pixels not
+   * touching the boundary.  These loops take the source coordinates in
+   * fixed point with 1/4096 pixel resolution, clipped to +/-262144 pixels.
+   * All other pixels, types and interpolators get the same floating point
+   * coordinates as always.
+   *
+   * If the same transformation is applied to many images of the same size
+   * (camera rectification, stabilization, etc.), prepareMap() computes the
+   * coordinates once, and all following apply() calls for that size just
+   * reuse them.  The map is discarded whenever the parameters change.  The
+   * map keeps the coordinates in the same fixed point format, so with a map
+   * all types and interpolators get coordinates with 1/4096 pixel
+   * resolution.
+   *
+   * \code
+   *   transformer.setMatrix(mat);
+   *   transformer.prepareMap(img.size());
+   *   while (grabber.apply(img)) {
+   *     transformer.apply(img,img2); // the coordinates are not recomputed
+   *   }
+   * \endcode
+   *
    * \section tparams Template parameter
    *
    * The template parameter I indicates the interpolator type to be used. 
@@ -578,6 +814,11 @@ namespace lti {
        * The transformation matrix have to be invertible, and need to have 
        * size 2x2, 2x3, 3x3, 4x4 or 4x3.
        *
+       * The nearest neighbor and bilinear interpolation of \c ubyte,
+       * \c float and \c rgbaPixel matrices, and all warps using a map of
+       * prepareMap(), resolve the source coordinates to 1/4096 pixel
+       * (see \ref mtmaps).
+       *
        * Default value: 2x2 identity matrix
        */
       fmatrix transformation;
@@ -983,6 +1224,39 @@ namespace lti {
      */
     bool setMatrix(const fmatrix& transMat);
 
+    /**
+     * @name Precomputed coordinate maps
+     */
+    //@{
+    /**
+     * Compute and keep the source coordinates of all pixels of the
+     * transformed matrix, for sources of the given size.
+     *
+     * All following apply() calls with sources of this size (which do not
+     * request the z component) reuse the coordinates, until the parameters
+     * are changed or releaseMap() is called.
+     *
+     * The map stores the coordinates in fixed point with 1/4096 pixel
+     * resolution, clipped to +/-262144 pixels, for all types and
+     * interpolators (see \ref mtmaps).
+     *
+     * @param size size of the matrices to be transformed.
+     * @return \c true if successful, or \c false if the matrix is not
+     *         valid or its size does not support maps (4x4 and 4x3).
+     */
+    bool prepareMap(const ipoint& size);
+
+    /**
+     * Release the map computed with prepareMap().
+     */
+    void releaseMap();
+
+    /**
+     * Return \c true if a map for sources of the given size is available.
+     */
+    bool hasMap(const ipoint& size) const;
+    //@}
+
   protected:
 
     /**
@@ -1116,6 +1390,27 @@ namespace lti {
                                   ipoint& res,
                                   fpoint& offset) const = 0;
 
+      /**
+       * Compute the source coordinates of the pixels of a transformed
+       * matrix of the given size.
+       *
+       * @return \c false if this helper does not support it (the default).
+       */
+      virtual bool coordinates(const ipoint& size,
+                               const fpoint& offset,
+                               internal::matrixTransformCoordinates& c) const;
+
+      /**
+       * Fill the already allocated \a dest, distributing its rows among
+       * the threads.  The source coordinates are taken from the given
+       * fixed-point maps, or from \a coords if the map pointers are null.
+       */
+      void warp(const matrix<value_type>& src,
+                      matrix<value_type>& dest,
+                const internal::matrixTransformCoordinates* coords,
+                const imatrix* mapX,
+                const imatrix* mapY) const;
+
     protected:
       /**
        * Reference to the interpolator object
@@ -1183,6 +1478,13 @@ namespace lti {
                                   ipoint& res,
                                   fpoint& offset) const;
 
+      /**
+       * Source coordinates of the pixels of the transformed matrix
+       */
+      virtual bool coordinates(const ipoint& size,
+                               const fpoint& offset,
+                               internal::matrixTransformCoordinates& c) const;
+
       /**
        * Transform the given point coordinates.
        *
@@ -1268,6 +1570,13 @@ namespace lti {
       virtual bool evalDims(const ipoint& orig,
                                   ipoint& res,
                                   fpoint& offset) const;
+
+      /**
+       * Source coordinates of the pixels of the transformed matrix
+       */
+      virtual bool coordinates(const ipoint& size,
+                               const fpoint& offset,
+                               internal::matrixTransformCoordinates& c) const;
       /**
        * Transform the given point coordinates.
        *
@@ -1349,6 +1658,13 @@ namespace lti {
                                   ipoint& res,
                                   fpoint& offset) const;
 
+      /**
+       * Source coordinates of the pixels of the transformed matrix
+       */
+      virtual bool coordinates(const ipoint& size,
+                               const fpoint& offset,
+                               internal::matrixTransformCoordinates& c) const;
+
       /**
        * Transform the given point coordinates.
        *
@@ -1581,6 +1897,12 @@ namespace lti {
       bool trans(const fmatrix& m,const ipoint& p,fpoint& res) const;
     };
 
+    /**
+     * Job transforming a band of rows per task
+     */
+    class warpJob;
+    friend class warpJob;
+
     /**
      * Pointer to the actual helper being used.
      *
@@ -1598,6 +1920,31 @@ namespace lti {
      */
     ipoint usedSize_;
 
+    /**
+     * @name Precomputed coordinate map (see prepareMap())
+     */
+    //@{
+    /**
+     * Fixed-point source columns of each pixel of the transformed matrix
+     */
+    imatrix mapX_;
+
+    /**
+     * Fixed-point source rows of each pixel of the transformed matrix
+     */
+    imatrix mapY_;
+
+    /**
+     * Size of the sources the map was computed for
+     */
+    ipoint mapSize_;
+
+    /**
+     * Offset of the transformed matrix computed with the map
+     */
+    fpoint mapOffset_;
+    //@}
+
   }; // class matrixTransform<I<T> >
 
 } // namespace lti
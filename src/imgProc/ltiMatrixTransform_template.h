@@ -32,6 +32,7 @@
 
 #include <limits>
 #include "ltiRound.h"
+#include "ltiParallelBands.h"
 
 namespace lti {
 
@@ -286,6 +287,197 @@ namespace lti {
     return m;
   }
 
+  namespace internal {
+
+    /**
+     * Interpolate the source at the fixed-point coordinate (cx,cy)
+     */
+    template<typename T,class I>
+    inline T matrixTransformInterpolate(const I& interpolator,
+                                        const matrix<T>& src,
+                                        const int32 cx,
+                                        const int32 cy) {
+      static const float scale = 1.0f/matrixTransformKernels::One;
+      if (cx == matrixTransformKernels::Invalid) {
+        return static_cast<T>(0);
+      }
+      return interpolator.interpolate(src,cy*scale,cx*scale);
+    }
+
+    /**
+     * Interpolate the source at the floating point coordinates of the
+     * pixel (row,col)
+     */
+    template<typename T,class I>
+    inline T matrixTransformInterpolate(const I& interpolator,
+                                        const matrix<T>& src,
+                                        const matrixTransformCoordinates& c,
+                                        const int row,
+                                        const int col) {
+      float x,y;
+      if (!c.at(row,col,x,y)) {
+        return static_cast<T>(0);
+      }
+      return interpolator.interpolate(src,y,x);
+    }
+
+    /**
+     * Transform a row, with the source coordinates given in fixed point
+     * (from a map) or as floating point coordinates.
+     *
+     * The general case calls the interpolator for each pixel.
+     */
+    template<typename T,template<class> class I>
+    class matrixTransformRow {
+    public:
+      static void apply(const I<T>& interpolator,
+                        const matrix<T>& src,
+                        const int32* cx,
+                        const int32* cy,
+                        const int n,
+                              T* dest) {
+        for (int i=0;i<n;++i) {
+          dest[i]=matrixTransformInterpolate(interpolator,src,cx[i],cy[i]);
+        }
+      }
+
+      static void apply(const I<T>& interpolator,
+                        const matrix<T>& src,
+                        const matrixTransformCoordinates& c,
+                        const int row,
+                        int32*,
+                        int32*,
+                        const int n,
+                              T* dest) {
+        for (int i=0;i<n;++i) {
+          dest[i]=matrixTransformInterpolate(interpolator,src,c,row,i);
+        }
+      }
+    };
+
+    /**
+     * Bilinear kernels of matrixTransformKernels
+     */
+    class matrixTransformBilinear {
+    public:
+      template<typename T>
+      static inline int run(const T* src,const int columns,const int rows,
+                            const int32* cx,const int32* cy,const int n,
+                            T* dest) {
+        return matrixTransformKernels::bilinear(src,columns,rows,
+                                                cx,cy,n,dest);
+      }
+
+      static inline bool inside(const int32 cx,const int32 cy,
+                                const int columns,const int rows) {
+        return matrixTransformKernels::insideBilinear(cx,cy,columns,rows);
+      }
+    };
+
+    /**
+     * Nearest neighbor kernels of matrixTransformKernels
+     */
+    class matrixTransformNearest {
+    public:
+      template<typename T>
+      static inline int run(const T* src,const int columns,const int rows,
+                            const int32* cx,const int32* cy,const int n,
+                            T* dest) {
+        return matrixTransformKernels::nearest(src,columns,rows,
+                                               cx,cy,n,dest);
+      }
+
+      static inline bool inside(const int32 cx,const int32 cy,
+                                const int columns,const int rows) {
+        return matrixTransformKernels::insideNearest(cx,cy,columns,rows);
+      }
+    };
+
+    /**
+     * Transform a row with the kernels K for the inner pixels, if they
+     * support the type T.  The remaining pixels are computed by the
+     * interpolator.
+     */
+    template<typename T,class I,class K>
+    class matrixTransformKernelRow {
+    public:
+      static void apply(const I& interpolator,
+                        const matrix<T>& src,
+                        const int32* cx,
+                        const int32* cy,
+                        const int n,
+                              T* dest) {
+        const int columns = src.columns();
+        const int rows = src.rows();
+        if (!useKernels(src,dest)) {
+          for (int i=0;i<n;++i) {
+            dest[i]=matrixTransformInterpolate(interpolator,src,cx[i],cy[i]);
+          }
+        } else if (K::run(src[0].data(),columns,rows,cx,cy,n,dest) > 0) {
+          for (int i=0;i<n;++i) {
+            if (!K::inside(cx[i],cy[i],columns,rows)) {
+              dest[i]=matrixTransformInterpolate(interpolator,src,
+                                                 cx[i],cy[i]);
+            }
+          }
+        }
+      }
+
+      static void apply(const I& interpolator,
+                        const matrix<T>& src,
+                        const matrixTransformCoordinates& c,
+                        const int row,
+                        int32* cx,
+                        int32* cy,
+                        const int n,
+                              T* dest) {
+        const int columns = src.columns();
+        const int rows = src.rows();
+        if (!useKernels(src,dest)) {
+          for (int i=0;i<n;++i) {
+            dest[i]=matrixTransformInterpolate(interpolator,src,c,row,i);
+          }
+          return;
+        }
+
+        // only the inner pixels use the fixed-point coordinates
+        c.fixedRow(row,n,cx,cy);
+        if (K::run(src[0].data(),columns,rows,cx,cy,n,dest) > 0) {
+          for (int i=0;i<n;++i) {
+            if (!K::inside(cx[i],cy[i],columns,rows)) {
+              dest[i]=matrixTransformInterpolate(interpolator,src,c,row,i);
+            }
+          }
+        }
+      }
+
+    private:
+      static inline bool useKernels(const matrix<T>& src,const T* dest) {
+        return (matrixTransformKernels::supports(dest) &&
+                (src.getMode() == matrix<T>::Connected) &&
+                (src.rows() > 0));
+      }
+    };
+
+    /**
+     * Bilinear interpolation uses the kernels for the inner pixels
+     */
+    template<typename T>
+    class matrixTransformRow<T,bilinearInterpolation>
+      : public matrixTransformKernelRow<T,bilinearInterpolation<T>,
+                                        matrixTransformBilinear> {
+    };
+
+    /**
+     * Nearest neighbor interpolation uses the kernels for the inner pixels
+     */
+    template<typename T>
+    class matrixTransformRow<T,nearestNeighborInterpolation>
+      : public matrixTransformKernelRow<T,nearestNeighborInterpolation<T>,
+                                        matrixTransformNearest> {
+    };
+  }
+
   // --------------------------------------------------
   // matrixTransform<T,I>::parameters
   // --------------------------------------------------
@@ -413,7 +605,7 @@ namespace lti {
   // default constructor
   template <typename T, template<class> class I>
   matrixTransform<T,I>::matrixTransform() :
-    geometricTransform<T,I>(),helper_(0) {
+    geometricTransform<T,I>(),helper_(0),mapSize_(-1,-1) {
 
     // create an instance of the parameters with the default values
     parameters defaultParameters;
@@ -424,7 +616,7 @@ namespace lti {
   // default constructor
   template <typename T, template<class> class I>
   matrixTransform<T,I>::matrixTransform(const parameters& par)
-    : geometricTransform<T,I>(),helper_(0) {
+    : geometricTransform<T,I>(),helper_(0),mapSize_(-1,-1) {
 
 
     // set the given parameters
@@ -435,7 +627,7 @@ namespace lti {
   // copy constructor
   template <typename T, template<class> class I>
   matrixTransform<T,I>::matrixTransform(const matrixTransform<T,I>& other)
-    : geometricTransform<T,I>(),helper_(0) {
+    : geometricTransform<T,I>(),helper_(0),mapSize_(-1,-1) {
     copy(other);
   }
 
@@ -458,6 +650,12 @@ namespace lti {
     offset_ = other.offset_;
     usedSize_ = other.usedSize_;
 
+    // the map of the other functor corresponds to the same parameters
+    mapX_.copy(other.mapX_);
+    mapY_.copy(other.mapY_);
+    mapSize_ = other.mapSize_;
+    mapOffset_ = other.mapOffset_;
+
     return (*this);
   }
 
@@ -516,6 +714,7 @@ namespace lti {
     if (geometricTransform<T,I>::updateParameters()) {
       delete helper_;
       helper_ = 0;
+      releaseMap();
       
       const parameters& par = getParameters();
       const fmatrix& mat = par.transformation;
@@ -583,12 +782,69 @@ namespace lti {
                                    fpoint& offset) const {
 
     if (notNull(helper_)) {
+      if (hasMap(src.size())) {
+        dest.allocate(mapX_.size());
+        offset.copy(mapOffset_);
+        helper_->warp(src,dest,0,&mapX_,&mapY_);
+        return true;
+      }
       return helper_->apply(src,dest,offset);
     }
 
     return false;
   }
 
+  // -------------------------------------------------------------------
+  // Precomputed coordinate maps
+  // -------------------------------------------------------------------
+
+  template <typename T, template<class> class I>
+  bool matrixTransform<T,I>::prepareMap(const ipoint& size) {
+    releaseMap();
+
+    if (isNull(helper_)) {
+      this->setStatusString("Invalid transformation matrix");
+      return false;
+    }
+
+    ipoint destSize;
+    fpoint offset;
+    if (!helper_->evalDims(size,destSize,offset)) {
+      this->setStatusString("Invalid size of the transformed matrix");
+      return false;
+    }
+
+    internal::matrixTransformCoordinates coords;
+    if (!helper_->coordinates(destSize,offset,coords)) {
+      this->setStatusString("Coordinate maps not supported for this "
+                            "matrix size");
+      return false;
+    }
+
+    mapX_.allocate(destSize);
+    mapY_.allocate(destSize);
+    for (int y=0;y<destSize.y;++y) {
+      coords.fixedRow(y,destSize.x,mapX_[y].data(),mapY_[y].data());
+    }
+
+    mapSize_.copy(size);
+    mapOffset_.copy(offset);
+    return true;
+  }
+
+  template <typename T, template<class> class I>
+  void matrixTransform<T,I>::releaseMap() {
+    mapX_.clear();
+    mapY_.clear();
+    mapSize_.set(-1,-1);
+    mapOffset_.set(0.0f,0.0f);
+  }
+
+  template <typename T, template<class> class I>
+  bool matrixTransform<T,I>::hasMap(const ipoint& size) const {
+    return (size == mapSize_);
+  }
+
   template <typename T, template<class> class I>
   bool matrixTransform<T,I>::apply(const matrix<T>& src,
                                    matrix<T>& dest,
@@ -625,6 +881,90 @@ namespace lti {
     return b;
   }
 
+  template <typename T, template<class> class I>
+  bool matrixTransform<T,I>::helperBase::coordinates(
+                                const ipoint&,
+                                const fpoint&,
+                                internal::matrixTransformCoordinates&) const {
+    return false;
+  }
+
+  /*
+   * Job transforming a band of rows per task
+   */
+  template <typename T, template<class> class I>
+  class matrixTransform<T,I>::warpJob : public threadPool::job {
+  public:
+    /**
+     * Constructor
+     */
+    warpJob(const interpolator_type& interpolator,
+            const matrix<value_type>& src,
+                  matrix<value_type>& dest,
+            const internal::matrixTransformCoordinates* coords,
+            const imatrix* mapX,
+            const imatrix* mapY,
+            const bandPartition& bands)
+      : interpolator_(interpolator),src_(src),dest_(dest),
+        coords_(coords),mapX_(mapX),mapY_(mapY),bands_(bands) {
+    }
+
+    /**
+     * Transform the rows of one band
+     */
+    virtual void execute(const int task) {
+      const bandPartition::band& b = bands_.getBand(task);
+      const int columns = dest_.columns();
+
+      if (notNull(mapX_)) {
+        for (int y=b.from;y<b.to;++y) {
+          internal::matrixTransformRow<T,I>::apply(interpolator_,src_,
+                                                   (*mapX_)[y].data(),
+                                                   (*mapY_)[y].data(),
+                                                   columns,
+                                                   dest_[y].data());
+        }
+        return;
+      }
+
+      // buffers for the fixed-point coordinates used by the kernels
+      ivector cx(columns),cy(columns);
+      for (int y=b.from;y<b.to;++y) {
+        internal::matrixTransformRow<T,I>::apply(interpolator_,src_,
+                                                 *coords_,y,
+                                                 cx.data(),cy.data(),
+                                                 columns,
+                                                 dest_[y].data());
+      }
+    }
+
+  private:
+    const interpolator_type& interpolator_;
+    const matrix<value_type>& src_;
+    matrix<value_type>& dest_;
+    const internal::matrixTransformCoordinates* coords_;
+    const imatrix* mapX_;
+    const imatrix* mapY_;
+    const bandPartition& bands_;
+  };
+
+  template <typename T, template<class> class I>
+  void matrixTransform<T,I>::helperBase::warp(const matrix<value_type>& src,
+                                                    matrix<value_type>& dest,
+                          const internal::matrixTransformCoordinates* coords,
+                                              const imatrix* mapX,
+                                              const imatrix* mapY) const {
+    const bandPartition bands(params_.numberOfThreads,dest.size(),0);
+    const int numBands = bands.getNumberOfBands();
+
+    warpJob theJob(interpolator_,src,dest,coords,mapX,mapY,bands);
+    if (numBands <= 1) {
+      theJob.execute(0);
+    } else {
+      threadPool::getShared().run(theJob,numBands,numBands);
+    }
+  }
+
   template <typename T, template<class> class I> bool 
   matrixTransform<T,I>::helperBase::getDimsFromCorners(const fpoint& tl,
                                                        const fpoint& tr,
@@ -693,40 +1033,15 @@ namespace lti {
 
   template <typename T, template<class> class I> bool 
   matrixTransform<T,I>::helper2x2::apply(const matrix<value_type>& src,
-                                               matrix<value_type>& dest,
-                                               fpoint& offset) const {
+                                         matrix<value_type>& dest,
+                                         fpoint& offset) const {
     ipoint destSize;
     if (evalDims(src.size(),destSize,offset)) {
       // dimensions valid: let's transform...
-
       dest.allocate(destSize);
-      
-      const int ex=destSize.x;
-      const int ey=destSize.y;
-      int x,y;
-      
-      // in principle, we have to compute m10_*x+m11_*y,m00_*x+m01_*y
-      // but due to the constant change of x and y in steps of 1, this
-      // can be much more efficiently computed using sums
-      float xm10,xm00,ym11(offset.y*m11_),ym01(offset.y*m01_);
-
-      const float m10 = offset.x*m10_;
-      const float m00 = offset.x*m00_;
-
-      for (y=0;y<ey;++y) {
-        xm10=m10;
-        xm00=m00;
-        for (x=0;x<ex;++x) {
-          dest.at(y,x)=this->interpolator_.interpolate(src,
-                                                       xm10+ym11,
-                                                       xm00+ym01);
-          xm10+=m10_;
-          xm00+=m00_;
-        }
-        ym11+=m11_;
-        ym01+=m01_;
-      }
-
+      internal::matrixTransformCoordinates coords;
+      coordinates(destSize,offset,coords);
+      this->warp(src,dest,&coords,0,0);
     } else {
       // wrong dimensions: just clean the image, as there is nothing to do
       dest.clear();
@@ -735,10 +1050,24 @@ namespace lti {
     return true;
   }
 
-  /*
-   * After the matrix has been analyzed, this method can be used to
-   * compute the dimensions of the resulting image and the offset.
-   */
+  template <typename T, template<class> class I>
+  bool matrixTransform<T,I>::helper2x2::coordinates(
+                           const ipoint& size,
+                           const fpoint& offset,
+                           internal::matrixTransformCoordinates& c) const {
+    typedef internal::matrixTransformCoordinates coords_type;
+
+    // in principle, we have to compute m10_*x+m11_*y,m00_*x+m01_*y
+    // but due to the constant change of x and y in steps of 1, this
+    // can be much more efficiently computed using sums
+    coords_type::accumulate(size.x,offset.x*m00_,m00_,c.colX);
+    coords_type::accumulate(size.x,offset.x*m10_,m10_,c.colY);
+    coords_type::accumulate(size.y,offset.y*m01_,m01_,c.rowX);
+    coords_type::accumulate(size.y,offset.y*m11_,m11_,c.rowY);
+    c.projective = false;
+    return true;
+  }
+
   template <typename T, template<class> class I>
   bool matrixTransform<T,I>::helper2x2::evalDims(const ipoint& orig,
                                                        ipoint& res,
@@ -825,34 +1154,11 @@ namespace lti {
                                          fpoint& offset) const {
     ipoint destSize;
     if (evalDims(src.size(),destSize,offset)) {
-
       // dimensions valid: let's transform...
-
       dest.allocate(destSize);
-      
-      // We can avoid an addition renaming the effect of the offset
-      const float m12 = m12_ + m10_*offset.x + m11_*offset.y;
-      const float m02 = m02_ + m00_*offset.x + m01_*offset.y;
-
-      const int ex = destSize.x;
-      const int ey = destSize.y;
-
-      int x,y;
-      float xm10,xm00,ym11(0.0f),ym01(0.0f);
-      for (y=0;y<ey;++y) {
-        xm10=m12;
-        xm00=m02;
-        for (x=0;x<ex;++x) {
-          dest.at(y,x)=this->interpolator_.interpolate(src,
-                                                       xm10+ym11,
-                                                       xm00+ym01);
-          xm10+=m10_;
-          xm00+=m00_;
-        }
-        ym11+=m11_;
-        ym01+=m01_;
-      }
-
+      internal::matrixTransformCoordinates coords;
+      coordinates(destSize,offset,coords);
+      this->warp(src,dest,&coords,0,0);
     } else {
       // wrong dimensions: just clean the image, as there is nothing to do
       dest.clear();
@@ -861,6 +1167,25 @@ namespace lti {
     return true;
   }
 
+  template <typename T, template<class> class I>
+  bool matrixTransform<T,I>::helper2x3::coordinates(
+                           const ipoint& size,
+                           const fpoint& offset,
+                           internal::matrixTransformCoordinates& c) const {
+    typedef internal::matrixTransformCoordinates coords_type;
+
+    // We can avoid an addition renaming the effect of the offset
+    const float m12 = m12_ + m10_*offset.x + m11_*offset.y;
+    const float m02 = m02_ + m00_*offset.x + m01_*offset.y;
+
+    coords_type::accumulate(size.x,m02,m00_,c.colX);
+    coords_type::accumulate(size.x,m12,m10_,c.colY);
+    coords_type::accumulate(size.y,0.0f,m01_,c.rowX);
+    coords_type::accumulate(size.y,0.0f,m11_,c.rowY);
+    c.projective = false;
+    return true;
+  }
+
   template <typename T, template<class> class I>
   bool matrixTransform<T,I>::helper2x3::evalDims(const ipoint& orig,
                                                  ipoint& res,
@@ -981,58 +1306,41 @@ namespace lti {
   matrixTransform<T,I>::helper3x3::apply(const matrix<value_type>& src,
                                          matrix<value_type>& dest,
                                          fpoint& offset) const {
-
     ipoint destSize;
     if (evalDims(src.size(),destSize,offset)) {
-
       // dimensions valid: let's transform...
-
       dest.allocate(destSize);
-
-      // We can avoid an addition renaming the effect of the offset
-      const float m22 = m22_ + m20_*offset.x + m21_*offset.y;
-      const float m12 = m12_ + m10_*offset.x + m11_*offset.y;
-      const float m02 = m02_ + m00_*offset.x + m01_*offset.y;
-
-      const int ex = destSize.x;
-      const int ey = destSize.y;
-
-      // in principle, we have to compute m10_*x+m11_*y+m12,m00_*x+m01_*y+m02
-      // but due to the constant change of x and y in steps of 1, this
-      // can be much more efficiently computed using sums
-      float xm10,xm00,ym11(0.0f),ym01(0.0f);
-      float xm20,ym21(0.0f);
-      int x,y;
-      for (y=0;y<ey;++y) {
-        xm00=m02;
-        xm10=m12;
-        xm20=m22;
-        for (x=0;x<ex;++x) {
-          const float alpha =  xm20 + ym21;
-          if (alpha == 0.0f) {
-            dest.at(y,x)=static_cast<value_type>(0);
-          } else {
-            const float ai=1.0f/alpha;
-            dest.at(y,x) =
-              this->interpolator_.interpolate(src,
-                                              (xm10+ym11)*ai,
-                                              (xm00+ym01)*ai);
-          }
-          xm20+=m20_;
-          xm10+=m10_;
-          xm00+=m00_;
-        }
-        ym21+=m21_;
-        ym11+=m11_;
-        ym01+=m01_;
-      }
+      internal::matrixTransformCoordinates coords;
+      coordinates(destSize,offset,coords);
+      this->warp(src,dest,&coords,0,0);
     } else {
       // wrong dimensions: just clean the image, as there is nothing to do
       dest.clear();
       return false;
     }
     return true;
+  }
 
+  template <typename T, template<class> class I>
+  bool matrixTransform<T,I>::helper3x3::coordinates(
+                           const ipoint& size,
+                           const fpoint& offset,
+                           internal::matrixTransformCoordinates& c) const {
+    typedef internal::matrixTransformCoordinates coords_type;
+
+    // We can avoid an addition renaming the effect of the offset
+    const float m22 = m22_ + m20_*offset.x + m21_*offset.y;
+    const float m12 = m12_ + m10_*offset.x + m11_*offset.y;
+    const float m02 = m02_ + m00_*offset.x + m01_*offset.y;
+
+    coords_type::accumulate(size.x,m02,m00_,c.colX);
+    coords_type::accumulate(size.x,m12,m10_,c.colY);
+    coords_type::accumulate(size.x,m22,m20_,c.colA);
+    coords_type::accumulate(size.y,0.0f,m01_,c.rowX);
+    coords_type::accumulate(size.y,0.0f,m11_,c.rowY);
+    coords_type::accumulate(size.y,0.0f,m21_,c.rowA);
+    c.projective = true;
+    return true;
   }
 
   template <typename T, template<class> class I>
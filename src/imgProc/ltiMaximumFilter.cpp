@@ -50,6 +50,8 @@
 #include "ltiMacroSymbols.h"
 
 #include "ltiMaximumFilter.h"
+#include "ltiParallelBands.h"
+#include "ltiSlidingExtremum.h"
 #include "ltiMaximumFilter_template.h"
 
 namespace lti {
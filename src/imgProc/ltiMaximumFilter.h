@@ -67,6 +67,14 @@ namespace lti {
    * The template parameter T defines the type of the matrix or vector
    * to be filtered.
    *
+   * If the window contains the origin, it is computed with the van
+   * Herk/Gil-Werman algorithm (see lti::internal::slidingExtremum), which
+   * requires about three comparisons per element in each direction,
+   * independently of the window size.  Other windows, the Mirror and
+   * Periodic boundaries on data smaller than the window, and the
+   * NoBoundary type, which leaves the border unchanged, use a sorted
+   * buffer of the elements within the window.
+   *
    * An instance of this class cannot be used from different threads (not
    * thread-save).  If you have multiple threads, use simply one functor for
    * each thread.
@@ -293,6 +301,15 @@ namespace lti {
      */
     parameters& getRWParameters();
 
+    /**
+     * Applies the horizontal part of the kernel to the matrix
+     *
+     * @param src matrix<T> with the source data.
+     * @param dest matrix<T> where the result will be left.
+     * @result a reference to the <code>dest</code>.
+     */
+    bool applyRow(const matrix<T>& src,matrix<T>& dest);
+
     /**
      * Applies the vertical part of the kernel to the matrix
      *
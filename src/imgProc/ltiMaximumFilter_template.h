@@ -403,12 +403,7 @@ namespace lti {
   bool maximumFilter<T>::apply(matrix<T>& srcdest) {
 
     matrix<T> tmp;
-    tmp.allocate(srcdest.size());
-
-    int y;
-    for (y=0;y<srcdest.rows();y++) {
-      apply(srcdest.getRow(y),tmp.getRow(y));
-    }
+    applyRow(srcdest,tmp);
 
     return applyCol(tmp,srcdest);
   }
@@ -429,14 +424,19 @@ namespace lti {
   template<class T>
   bool maximumFilter<T>::apply(const matrix<T>& src,
                                      matrix<T>& dest) {
-    matrix<T> tmp;
-    tmp.allocate(src.size());
-
-    int y;
-    for (y=0;y<src.rows();y++) {
-      apply(src.getRow(y),tmp.getRow(y));
+    const parameters& param = getParameters();
+    const int reach = max(abs(param.maskWindow.ul.y),
+                          abs(param.maskWindow.br.y));
+    parallelBands< maximumFilter<T> > bands(*this,src.size(),
+                                   (param.boundaryType == Periodic) ?
+                                   src.rows() : reach);
+    if (bands.getNumberOfBands() > 1) {
+      return bands.apply(src,dest);
     }
 
+    matrix<T> tmp;
+    applyRow(src,tmp);
+
     dest.allocate(src.size());
     return applyCol(tmp,dest);
   }
@@ -457,6 +457,16 @@ namespace lti {
       return true;
     }
 
+    // windows containing the origin: van Herk/Gil-Werman algorithm
+    internal::slidingExtremum<T,internal::maximumOperator<T> >
+      extremum(param.maskWindow.ul.x,kernLastIdx,param.boundaryType,
+               T(0),true);
+    if ((&src != &dest) && extremum.canProcess(src.size())) {
+      dest.allocate(src.size());
+      extremum.apply(src.data(),src.size(),dest.data());
+      return true;
+    }
+
     int i;
     int begin,end;
     vector<T> firstResult;
@@ -846,6 +856,28 @@ namespace lti {
     return true;
   }
 
+  // Horizontal part of the kernel
+  template<class T>
+  bool maximumFilter<T>::applyRow(const matrix<T>& src,
+                                   matrix<T>& dest) {
+    const parameters& param = getParameters();
+
+    // windows containing the origin: van Herk/Gil-Werman algorithm
+    internal::slidingExtremum<T,internal::maximumOperator<T> >
+      extremum(param.maskWindow.ul.x,param.maskWindow.br.x,
+               param.boundaryType,T(0),true);
+    if (extremum.canProcess(src.columns())) {
+      extremum.applyRows(src,dest);
+      return true;
+    }
+
+    dest.allocate(src.size());
+    for (int y=0;y<src.rows();y++) {
+      apply(src.getRow(y),dest.getRow(y));
+    }
+    return true;
+  }
+
   // On copy apply for type matrix<T>!
   template<class T>
   bool maximumFilter<T>::applyCol(const matrix<T>& src,
@@ -862,6 +894,15 @@ namespace lti {
       return true;
     }
 
+    // windows containing the origin: van Herk/Gil-Werman algorithm
+    internal::slidingExtremum<T,internal::maximumOperator<T> >
+      extremum(param.maskWindow.ul.y,kernLastIdx,param.boundaryType,
+               T(0),true);
+    if (extremum.canProcess(src.rows())) {
+      extremum.applyColumns(src,dest);
+      return true;
+    }
+
     int x,i,f,xx,endxx,endi,col,t,s;
     int begin,end;
 
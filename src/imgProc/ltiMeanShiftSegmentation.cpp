@@ -53,6 +53,7 @@
 #include "ltiMeanShiftSegmentation.h"
 #include "ltiSTLIoInterface.h"
 #include "ltiRound.h"
+#include "ltiThreadPool.h"
 #include <ctime> 
 #include <cstring> // for memcpy and similar functions
 
@@ -334,12 +335,7 @@ namespace lti {
     }
 
     // Filter image 
-    if (param.speedup == NoSpeedup) {
-      nonOptimizedFilter(data);
-    }
-    else {
-      optimizedFilter(data);
-    }
+    meanShiftFilter(data);
     
     // connect neighbour pixel with the same color to a region
     connect(data);
@@ -389,11 +385,7 @@ namespace lti {
     rgbToLuv(src,data);
 
     // Filter image 
-    if (param.speedup == NoSpeedup){
-      nonOptimizedFilter(data);
-    } else {
-      optimizedFilter(data);
-    }
+    meanShiftFilter(data);
 
     // connect neighbour pixel with the same color to a region
     connect(data);
@@ -452,11 +444,7 @@ namespace lti {
     rgbToLuv(src,data);
 
     //Filter image 
-    if (param.speedup == NoSpeedup){
-      nonOptimizedFilter(data);
-    } else {
-      optimizedFilter(data);
-    }
+    meanShiftFilter(data);
     
     //convert image from luv to rgb 
     luvToRgb(data.imageLuvFilteredF,dest,data);
@@ -477,7 +465,7 @@ namespace lti {
   meanShiftSegmentation::internals::internals() {
     width=height=imageSize=regionCount=0;
     dimensionRange=dimensionSpace=dimensionFeatureSpace=0;
-    imageLuvOrgF=imageLuvFilteredF=weightMap=0;
+    imageLuvOrgF=imageLuvFilteredF=weightMap=samples=0;
     imageLuvFilteredI=labels=0;
   }
 
@@ -511,6 +499,7 @@ namespace lti {
     for(i = 0; i < imageSize; i++){
       weightMap[i] = 1.0;
     }
+    samples = new float[imageSize*(dimensionSpace+dimensionRange)];
     vecTrialsToConverge.resize(pars.maxTrial,0);
   }
 
@@ -527,186 +516,266 @@ namespace lti {
     modes.clear();
     delete[] weightMap;
     weightMap=0;
+    delete[] samples;
+    samples=0;
    }
 
 
-  void  meanShiftSegmentation::nonOptimizedFilter(internals& data) const {
+  // -------------------------------------------------------------------
+  // Mean shift filtering
+  // -------------------------------------------------------------------
 
-    const parameters& param = getParameters();
+  const int meanShiftSegmentation::TileRows = 64;
+
+  namespace {
+    /*
+     * Store the given luv color in the filtered images at the pixel with
+     * index pos (rounded integers computed faster than with round())
+     */
+    inline void storeMode(const float* luv,
+                          const int pos,
+                          float* filteredF,
+                          int* filteredI) {
+      float* f = filteredF + 3*pos;
+      int* n = filteredI + 3*pos;
+      for (int k=0;k<3;++k) {
+        f[k] = luv[k];
+        n[k] = (luv[k] < 0) ? int(luv[k] - 0.5f) : int(luv[k] + 0.5f);
+      }
+    }
+  }
 
-    float center[5], newCenter[5]; // , meanshiftVector[5];
-    int lowerBoundX,lowerBoundY,upperBoundX,upperBoundY;
-    int pos, pos1, pos2;
-    float msAbs = 0; //magnitude of meanshift vector
-    float weightSum, sqrRadius = 0;
-    int i,j;
+  /*
+   * Job filtering one tile of rows per task.  Each task keeps its own
+   * histogram of iterations, which are added in the order of the tiles.
+   */
+  class meanShiftSegmentation::filterJob : public threadPool::job {
+  public:
+    /**
+     * Constructor
+     *
+     * @param owner the functor whose filter methods are used
+     * @param data internal data with the packed samples
+     * @param modeTable mode table for the speed-up techniques, or null
+     *                  if each pixel has to be filtered (NoSpeedup)
+     * @param numTiles number of tiles
+     */
+    filterJob(const meanShiftSegmentation& owner,
+              internals& data,
+              int* modeTable,
+              const int numTiles)
+      : owner_(owner),data_(data),modeTable_(modeTable),trials_(numTiles) {
+    }
 
-    //initialize vectors
-    for(i = 0; i < data.dimensionFeatureSpace; i++){
-      center[i] = 0.0f;
-      newCenter[i] = 0.0f;
-      // meanshiftVector[i] = 0.0f;
-    } 
+    /**
+     * Filter the tile with the given index
+     */
+    virtual void execute(const int task) {
+      const int fromRow = task*TileRows;
+      const int toRow = min(fromRow+TileRows,data_.height);
+      vector<int>& trials = trials_[task];
+      trials.assign(data_.vecTrialsToConverge.size(),0);
+      if (isNull(modeTable_)) {
+        owner_.nonOptimizedFilter(data_,fromRow,toRow,trials);
+      } else {
+        owner_.optimizedFilter(data_,fromRow,toRow,modeTable_,trials);
+      }
+    }
 
-    //traverse image
-    for(i = 0; i < data.imageSize; i++) {
+    /**
+     * Add the iteration histograms of all tiles to vecTrialsToConverge
+     */
+    void accumulateTrials() {
+      for (unsigned int t=0;t<trials_.size();++t) {
+        data_.vecTrialsToConverge.add(trials_[t]);
+      }
+    }
 
-      // assign window center 
-      center[0] = static_cast<float>(i%data.width); //column x
-      center[1] = static_cast<float>(i/data.width); //row y
+  private:
+    const meanShiftSegmentation& owner_;
+    internals& data_;
+    int* modeTable_;
+    std::vector< vector<int> > trials_;
+  };
 
-      const int drxi = data.dimensionRange*i;
+  void meanShiftSegmentation::meanShiftFilter(internals& data) const {
+    const parameters& param = getParameters();
 
-      for(j = 0; j < data.dimensionRange; j++){
-        center[j+2] = data.imageLuvOrgF[drxi+j];//luv colors
+    // pack the samples of the feature space
+    const float* luv = data.imageLuvOrgF;
+    float* s = data.samples;
+    int x,y;
+    for (y = 0; y < data.height; ++y) {
+      const float fy = static_cast<float>(y);
+      for (x = 0; x < data.width; ++x, s+=5, luv+=3) {
+        s[0] = static_cast<float>(x);
+        s[1] = fy;
+        s[2] = luv[0];
+        s[3] = luv[1];
+        s[4] = luv[2];
       }
-  
-      int iterationCount = 0;
-      
-      //determine by this loop the new center by following the meanshift vector
-      do{
-        //determine lower and upper bounds on grid
-        lowerBoundX = int(center[0] - param.sigmaS);
-        if (lowerBoundX < 0) {
-          lowerBoundX = 0;
-        }
+    }
 
-        lowerBoundY = int(center[1] - param.sigmaS);
-        if (lowerBoundY < 0) {
-          lowerBoundY = 0; 
-        }
+    // one entry for each pixel: 
+    // 0 means no mode yet assigned
+    // 1 means mode already assigned  
+    // 2 means the mode another pixel is now converging to should be assigned
+    //        to this one too once the mode is determined
+    int* modeTable = 0;
+    if (param.speedup != NoSpeedup) {
+      modeTable = new int[data.imageSize];
+      memset(modeTable,0,data.imageSize*sizeof(int));
+    }
 
-        upperBoundX = int(center[0] + param.sigmaS);
-        if (upperBoundX >= data.width) {
-          upperBoundX = data.width - 1;
-        }
+    // the tiles do not depend on the number of threads, and neither do the
+    // results
+    const int numTiles = (data.height + TileRows - 1)/TileRows;
+    const int threads = min(numTiles,
+                            threadPool::computeThreads(param.numberOfThreads));
+    filterJob theJob(*this,data,modeTable,numTiles);
+    if (threads > 1) {
+      threadPool::getShared().run(theJob,numTiles,threads);
+    } else {
+      for (int t = 0; t < numTiles; ++t) {
+        theJob.execute(t);
+      }
+    }
+    theJob.accumulateTrials();
 
-        upperBoundY = int(center[1] + param.sigmaS);
-        if (upperBoundY >= data.height) {
-          upperBoundY = data.height - 1;
-        }
+    delete[] modeTable;
+  }
 
-        for (j = 0; j < data.dimensionFeatureSpace; j++) {
-          newCenter[j] = 0;
-        }
-        weightSum = 0;
-
-        //iterate once through a window of size sigmaS
-        for(int y = lowerBoundY; y <= upperBoundY; y++) {
-          const int yw = y*data.width;
-          for(int x = lowerBoundX; x <= upperBoundX; x++) {
-
-            pos1 = (yw+x);
-            pos2 = pos1*data.dimensionRange;
-
-            //test if feature point is within sphere of radius sigmaS / sigmaR
-            sqrRadius += static_cast<float>(sqr((x - center[0])/param.sigmaS));
-            sqrRadius += static_cast<float>(sqr((y - center[1])/param.sigmaS));
-            sqrRadius += static_cast<float>(sqr((data.imageLuvOrgF[pos2]
-                                                 - center[2]) / param.sigmaR));
-            sqrRadius += static_cast<float>(sqr((data.imageLuvOrgF[pos2+1]
-                                                 - center[3]) / param.sigmaR));
-            sqrRadius += static_cast<float>(sqr((data.imageLuvOrgF[pos2+2]
-                                                 - center[4]) / param.sigmaR));
-    
-            // considered point is within sphere => accumulate to mean
-            // for newCenter
-            if (sqrRadius < 1.0) {
-              newCenter[0] += data.weightMap[pos1] * x;
-              newCenter[1] += data.weightMap[pos1] * y;
-              newCenter[2] += data.weightMap[pos1] * data.imageLuvOrgF[pos2];
-              newCenter[3] += data.weightMap[pos1] * data.imageLuvOrgF[pos2+1];
-              newCenter[4] += data.weightMap[pos1] * data.imageLuvOrgF[pos2+2];
-              weightSum    += data.weightMap[pos1];
-            }
+  float meanShiftSegmentation::meanShiftStep(const internals& data,
+                                             float* center,
+                                             const int fromRow,
+                                             const int toRow,
+                                             int* modeTable,
+                                             int* pointList,
+                                             int& pointCount) const {
+    const parameters& param = getParameters();
+    const float sqrInvSigmaS = static_cast<float>(1.0/sqr(param.sigmaS));
+    const float sqrInvSigmaR = static_cast<float>(1.0/sqr(param.sigmaR));
+    const int width = data.width;
+
+    // determine lower and upper bounds on grid
+    const int lowerBoundX = max(0,int(center[0] - param.sigmaS));
+    const int lowerBoundY = max(0,int(center[1] - param.sigmaS));
+    const int upperBoundX = min(width-1,int(center[0] + param.sigmaS));
+    const int upperBoundY = min(data.height-1,int(center[1] + param.sigmaS));
+
+    float newCenter[5] = {0.0f,0.0f,0.0f,0.0f,0.0f};
+    float weightSum = 0.0f;
+
+    // iterate once through window of size sigmaS, row by row, and
+    // accumulate the points within the sphere of radius sigmaS / sigmaR
+    for (int y = lowerBoundY; y <= upperBoundY; ++y) {
+      const int yw = y*width;
+      const float dy = static_cast<float>(y) - center[1];
+      const float sqrDy = dy*dy;
+      if (sqrDy*sqrInvSigmaS >= 1.0f) {
+        continue;
+      }
 
-            sqrRadius = 0;
+      // highSpeedup: points within sphere get the same mode assigned even
+      // though they might have converged to another mode (inaccuracy)
+      const bool mark = notNull(pointList) && (y >= fromRow) && (y < toRow);
+
+      const float* s = data.samples + 5*(yw+lowerBoundX);
+      const float* w = data.weightMap + (yw+lowerBoundX);
+      for (int x = lowerBoundX; x <= upperBoundX; ++x, s+=5, ++w) {
+        const float d0 = s[0] - center[0];
+        const float d2 = s[2] - center[2];
+        const float d3 = s[3] - center[3];
+        const float d4 = s[4] - center[4];
+        if ((sqrDy + d0*d0)*sqrInvSigmaS +
+            (d2*d2 + d3*d3 + d4*d4)*sqrInvSigmaR < 1.0f) {
+          const float weight = *w;
+          newCenter[0] += weight*s[0];
+          newCenter[1] += weight*s[1];
+          newCenter[2] += weight*s[2];
+          newCenter[3] += weight*s[3];
+          newCenter[4] += weight*s[4];
+          weightSum += weight;
+
+          if (mark && (modeTable[yw+x] == 0)) {
+            pointList[pointCount++] = yw+x;
+            modeTable[yw+x] = 2;
           }
         }
-  
-        msAbs = 0;
-  
-        //determine the new center and the magnitude of the meanshift vector
-        //meanshiftVector = newCenter - center;
-        for(j = 0; j < data.dimensionFeatureSpace; j++){
-          newCenter[j] /= weightSum;
-          msAbs += sqr(newCenter[j] - center[j]);
-          center[j] = newCenter[j];
-        }
+      }
+    }
+
+    // determine the new center and the magnitude of the meanshift vector
+    float msAbs = 0.0f;
+    for (int j = 0; j < 5; ++j) {
+      newCenter[j] /= weightSum;
+      msAbs += sqr(newCenter[j] - center[j]);
+      center[j] = newCenter[j];
+    }
+
+    return msAbs;
+  }
 
+  void meanShiftSegmentation::nonOptimizedFilter(internals& data,
+                                                 const int fromRow,
+                                                 const int toRow,
+                                                 vector<int>& trials) const {
+
+    const parameters& param = getParameters();
+    float center[5];
+    int dummy = 0;
+
+    // traverse tile
+    const int last = toRow*data.width;
+    for (int i = fromRow*data.width; i < last; i++) {
+
+      // assign window center 
+      const float* s = data.samples + 5*i;
+      for (int j = 0; j < 5; j++) {
+        center[j] = s[j];
+      }
+
+      int iterationCount = 0;
+      float msAbs;
+      
+      //determine by this loop the new center by following the meanshift vector
+      do {
+        msAbs = meanShiftStep(data,center,fromRow,toRow,0,0,dummy);
         iterationCount++;
       } while( msAbs > param.thresholdConverged && 
                iterationCount < param.maxTrial );
-      //shifting window
 
       //for debug only
-      data.vecTrialsToConverge[iterationCount-1]++;
+      trials[iterationCount-1]++;
 
       //store result
-      pos = i*data.dimensionRange;
-      data.imageLuvFilteredF[pos] = center[2];
-      data.imageLuvFilteredF[pos+1] = center[3];
-      data.imageLuvFilteredF[pos+2] = center[4];
-
-      //store rounded result (faster than round())
-      if (center[2] < 0) {
-        data.imageLuvFilteredI[pos] = int(center[2] - 0.5f); 
-      } else {
-        data.imageLuvFilteredI[pos] = int(center[2] + 0.5f);
-      }
-
-      if (center[3] < 0) {
-        data.imageLuvFilteredI[pos+1] = int(center[3] - 0.5f); 
-      } else {
-        data.imageLuvFilteredI[pos+1] = int(center[3] + 0.5f);
-      }
-
-      if (center[4] < 0) {
-        data.imageLuvFilteredI[pos+2] = int(center[4] - 0.5f); 
-      } else {
-        data.imageLuvFilteredI[pos+2] = int(center[4] + 0.5f);
-      }
+      storeMode(center+2,i,data.imageLuvFilteredF,data.imageLuvFilteredI);
     }
   }
   
-  void  meanShiftSegmentation::optimizedFilter(internals& data) const {
+  void meanShiftSegmentation::optimizedFilter(internals& data,
+                                              const int fromRow,
+                                              const int toRow,
+                                              int* modeTable,
+                                              vector<int>& trials) const {
 
     const parameters& param = getParameters();
+    const float sqrInvSigmaR = static_cast<float>(1.0/sqr(param.sigmaR));
+    const int first = fromRow*data.width;
+    const int last = toRow*data.width;
 
-    float center[5], newCenter[5]; //, meanshiftVector[5];
-    float diff = 0, msAbs = 0, weightSum = 0, sqrRadius = 0;
-    int lowerBoundX, lowerBoundY, upperBoundX, upperBoundY;
-    int pos, pos1, pos2, pointCount;
+    float center[5];
     int modeCandidateX, modeCandidateY, modeCandidate_i;
-    int i,j;
-    
-    // one entry for each pixel: 
-    // 0 means no mode yet assigned
-    // 1 means mode already assigned  
-    // 2 means the mode another pixel is now converging to should be assigned
-    //        to this one too once the mode is determined
-    int * modeTable = new int[data.imageSize];
+    int pointCount, j;
 
-    // stores the mode candidates that get the same mode assigned
-    int * pointList = new int[data.imageSize]; 
+    // stores the mode candidates that get the same mode assigned, which
+    // are always pixels of this tile
+    vector<int> pointList(last-first,0);
+    int* const points = pointList.data();
+    int* const highList = (param.speedup == HighSpeedup) ? points : 0;
 
-    // the luv color of a mode candidate
-    float* modeCandidatePoint = new float[data.dimensionRange];
-
-    // initialize with 0
-    memset(modeTable,0,data.imageSize*sizeof(int));
-    memset(pointList,0,data.imageSize*sizeof(int));
-    
-    // initialize vectors
-    for(j = 0; j < data.dimensionFeatureSpace; j++){
-      center[j] = 0.0;
-      newCenter[j] = 0.0;
-      // meanshiftVector[j] = 0.0;
-    } 
-
-
-    // traverse image
-    for(i = 0; i < data.imageSize; i++) {
+    // traverse tile
+    for (int i = first; i < last; i++) {
 
       // if a mode is already assigned to this data point then skip this 
       // point, otherwise proceed to find its mode by applying mean shift
@@ -714,65 +783,51 @@ namespace lti {
         continue;
       }
       pointCount = 0;
-   
+
       // assign window center 
-      center[0] = static_cast<float>(i%data.width);
-      center[1] = static_cast<float>(i/data.width);
-      for(j = 0; j < data.dimensionRange; j++){
-        center[j+2] = data.imageLuvOrgF[data.dimensionRange*i+j];
+      const float* s = data.samples + 5*i;
+      for (j = 0; j < 5; j++) {
+        center[j] = s[j];
       }
-  
+
+      // pixel whose mode is taken, if the mean shift can be stopped
+      int modeSource = -1;
       int iterationCount = 0;
+      float msAbs;
   
       // determine by this loop the new center by following the meanshift
       // vector
-      do{
+      do {
         // calculate the location of center on the lattice
         modeCandidateX  = int(center[0] + 0.5f);
         modeCandidateY  = int(center[1] + 0.5f);
         modeCandidate_i = modeCandidateY * data.width + modeCandidateX;
 
-        if((modeTable[modeCandidate_i] != 2) && (modeCandidate_i != i)) {
+        // only the points of this tile are considered, since the other
+        // tiles may be being filtered at the same time
+        if ((modeCandidate_i >= first) && (modeCandidate_i < last) &&
+            (modeTable[modeCandidate_i] != 2) && (modeCandidate_i != i)) {
           // obtain the data point at basin_i to see if it is within h* 0.5 of
           // of center
-          for (j = 0; j < data.dimensionRange; j++){
-            modeCandidatePoint[j] = 
-              data.imageLuvOrgF[data.dimensionRange * modeCandidate_i + j];
-          }
-    
-          diff = 0.0f;
-          diff += static_cast<float>(sqr((modeCandidatePoint[0] - center[2]) /
-                                         param.sigmaR));
-          diff += static_cast<float>(sqr((modeCandidatePoint[1] - center[3]) /
-                                         param.sigmaR));
-          diff += static_cast<float>(sqr((modeCandidatePoint[2] - center[4]) /
-                                         param.sigmaR));
-    
+          const float* m = data.samples + 5*modeCandidate_i;
+          const float diff = (sqr(m[2] - center[2]) +
+                              sqr(m[3] - center[3]) +
+                              sqr(m[4] - center[4]))*sqrInvSigmaR;
+
           // if the color is within radius of sigmaR than the same
           // mode is assigned
-          if(diff < 0.5f){
+          if (diff < 0.5f) {
             // if the data point at basin_i has not been associated to a mode 
             // then associate it with the mode that this one will converge to
-            if (modeTable[modeCandidate_i] == 0){
-              pointList[pointCount++] = modeCandidate_i;
+            if (modeTable[modeCandidate_i] == 0) {
+              points[pointCount++] = modeCandidate_i;
               modeTable[modeCandidate_i] = 2;
-            } 
-            else{
+            } else {
               // the mode has already been associated with another
               // mode, therefore associate this one mode and the modes
               // in the point list with the mode associated with
               // data[basin_i]...
-
-              // store the mode info into center using imageLuvFilteredF
-              for (j = 0; j < data.dimensionRange; j++){
-                center[j+2] = 
-                  data.imageLuvFilteredF[modeCandidate_i*data.dimensionRange +
-                                         j];
-              }
-        
-              // update mode table for this data point indicating that a mode
-              // has been associated with it
-              modeTable[i] = 1;
+              modeSource = modeCandidate_i;
 
               // stop mean shift calculation...
               break;
@@ -780,84 +835,8 @@ namespace lti {
           }
         }
 
-        // determine lower and upper bounds on grid
-        lowerBoundX = int(center[0] - param.sigmaS);
-        if (lowerBoundX < 0) {
-          lowerBoundX = 0;
-        }
-        lowerBoundY = int(center[1] - param.sigmaS);
-        if (lowerBoundY < 0) {
-          lowerBoundY = 0;
-        }
-        upperBoundX = int(center[0] + param.sigmaS);
-        if (upperBoundX >= data.width) {
-          upperBoundX = data.width - 1;
-        }
-        upperBoundY = int(center[1] + param.sigmaS);
-        if (upperBoundY >= data.height) {
-          upperBoundY = data.height - 1;
-        }
-
-        for(int l = 0; l < data.dimensionFeatureSpace; l++){
-          newCenter[l] = 0;
-        }
-        weightSum = 0;
-
-        // iterate once through window of size sigmaS and determine the
-        // newCenter
-        for(int x = lowerBoundX; x <= upperBoundX; x++){
-          for(int y = lowerBoundY; y <= upperBoundY; y++){
-
-            pos1 = (y*data.width+x);
-            pos2 = (y*data.width+x)*data.dimensionRange;
-
-            // test if feature point is within sphere of radius sigmaS / sigmaR
-            sqrRadius += static_cast<float>(sqr((x - center[0]) / 
-                                                param.sigmaS));
-            sqrRadius += static_cast<float>(sqr((y - center[1]) /
-                                                param.sigmaS));
-            sqrRadius += static_cast<float>(sqr((data.imageLuvOrgF[pos2] -
-                                                 center[2]) / param.sigmaR));
-            sqrRadius += static_cast<float>(sqr((data.imageLuvOrgF[pos2+1] -
-                                                 center[3]) / param.sigmaR));
-            sqrRadius += static_cast<float>(sqr((data.imageLuvOrgF[pos2+2] -
-                                                 center[4]) / param.sigmaR));
-    
-            // considered point is within sphere => accumulate to mean
-            // for newCenter
-            if(sqrRadius < 1.0f){
-        
-              newCenter[0] += data.weightMap[pos1] * x;
-              newCenter[1] += data.weightMap[pos1] * y;
-              newCenter[2] += data.weightMap[pos1] * data.imageLuvOrgF[pos2];
-              newCenter[3] += data.weightMap[pos1] * data.imageLuvOrgF[pos2+1];
-              newCenter[4] += data.weightMap[pos1] * data.imageLuvOrgF[pos2+2];
-              weightSum += data.weightMap[pos1];
-
-              // highSpeedup: point within sphere => the same mode is
-              // assigned to it even though it might have converged to
-              // another mode (inaccuracy) the only difference to
-              // mediumSpeedup
-              if(param.speedup == HighSpeedup && 
-                 modeTable[pos1] == 0) {
-                pointList[pointCount++]  = pos1;
-                modeTable[pos1]  = 2;
-              }
-            }
-
-            sqrRadius = 0;
-          }
-        }
-  
-        msAbs = 0;
-  
-        // determine the new center and the magnitude of the meanshift vector
-        // meanshiftvector = newCenter - center
-        for(j = 0; j < data.dimensionFeatureSpace; j++){
-          newCenter[j] /= weightSum;
-          msAbs += sqr(newCenter[j] - center[j]);
-          center[j] = newCenter[j];
-        }
+        msAbs = meanShiftStep(data,center,fromRow,toRow,
+                              modeTable,highList,pointCount);
 
         iterationCount++;
         _lti_debug3("itCount: "<<iterationCount<<"   meanshift magnitude: "<<
@@ -868,63 +847,25 @@ namespace lti {
                (iterationCount < param.maxTrial));
 
       // for debug only
-      data.vecTrialsToConverge[iterationCount-1]++;
+      trials[max(iterationCount,1)-1]++;
 
-      // associate the data point indexed by the point list with the mode
-      // stored by center
-      for (j = 0; j < pointCount; j++){
-  
-        // obtain the point location from the point list
-        modeCandidate_i = pointList[j];
-
-        // store result into imageLuvFilteredF and imageLuvFilteredI
-        for(int k = 0; k < data.dimensionRange; k++){
-          pos =  modeCandidate_i * data.dimensionRange + k;
-          data.imageLuvFilteredF[pos] = center[k+2];
-          if(center[k+2] < 0) {
-            data.imageLuvFilteredI[pos] = int(center[k+2] - 0.5f); 
-          } else {
-            data.imageLuvFilteredI[pos] = int(center[k+2] + 0.5f);
-          }
-        }
+      // the mode info is taken from the already filtered pixel, if the
+      // mean shift was stopped
+      const float* luv = (modeSource >= 0) ?
+        data.imageLuvFilteredF + 3*modeSource : center+2;
 
-        // update the mode table for this point
-        modeTable[modeCandidate_i] = 1;
+      // associate the data point indexed by the point list with the mode
+      // stored by center, and update the mode table
+      for (j = 0; j < pointCount; j++) {
+        storeMode(luv,points[j],data.imageLuvFilteredF,data.imageLuvFilteredI);
+        modeTable[points[j]] = 1;
       }
       
-      // store result for point i
-      pos = i*data.dimensionRange;
-      data.imageLuvFilteredF[pos] = center[2];
-      data.imageLuvFilteredF[pos+1] = center[3];
-      data.imageLuvFilteredF[pos+2] = center[4];
-
-      if(center[2] < 0) {
-        data.imageLuvFilteredI[pos] = int(center[2] - 0.5f); 
-      } else {
-        data.imageLuvFilteredI[pos] = int(center[2] + 0.5f);
-      }
-
-      if(center[3] < 0) {
-        data.imageLuvFilteredI[pos+1] = int(center[3] - 0.5f); 
-      } else {
-        data.imageLuvFilteredI[pos+1] = int(center[3] + 0.5f);
-      }
-
-      if(center[4] < 0) {
-        data.imageLuvFilteredI[pos+2] = int(center[4] - 0.5f); 
-      } else {
-        data.imageLuvFilteredI[pos+2] = int(center[4] + 0.5f);
-      }
-
-      // update mode table for this data point indicating that a mode has been 
+      // store result for point i, and indicate that a mode has been 
       // associated with it
+      storeMode(luv,i,data.imageLuvFilteredF,data.imageLuvFilteredI);
       modeTable[i] = 1;
-     
     }
-
-    delete[] modeTable;
-    delete[] pointList; 
-    delete[] modeCandidatePoint;
   }
 
 
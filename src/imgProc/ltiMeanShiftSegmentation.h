@@ -84,6 +84,16 @@ namespace lti {
    * parameters::sigmaR, parameters::sigmaS,
    * parameters::maxNeighbourColorDistance, and the parameters::speedup.
    *
+   * The mean shift filtering stage, which is by far the most expensive one,
+   * works on a packed copy of the five dimensional samples (x,y,L,u,v),
+   * which are traversed row by row.  The image is
+   * processed in tiles of a fixed number of rows.  The speed-up techniques
+   * reuse the modes found for other pixels of the same tile only, so that
+   * the tiles can be filtered independently on several threads (see
+   * functor::parameters::numberOfThreads), with results that do not depend
+   * on the number of threads.  The modes of neighbour tiles are merged
+   * afterwards, when the regions of the whole image are connected and fused.
+   *
    * @ingroup gSegmentation
    *
    * @see meanShiftSegmentation::parameters
@@ -529,6 +539,12 @@ namespace lti {
        * Contains for each pixel a weight factor
        */
       float* weightMap;
+
+      /**
+       * Packed feature space samples: for each pixel the five values
+       * (x,y,L,u,v) are stored consecutively.
+       */
+      float* samples;
       
       /**
        * Assigns a label to each data point associating it to a mode in modes
@@ -587,16 +603,78 @@ namespace lti {
 
 
     /**
-     * Filters the image applying mean shift to each point advantage: most
-     * accurate disadvantage : time expensive
+     * Job filtering the tiles of the image
+     */
+    class filterJob;
+    friend class filterJob;
+
+    /**
+     * Number of rows of the tiles in which the image is filtered
+     */
+    static const int TileRows;
+
+    /**
+     * Filters the image (imageLuvOrgF) with the technique indicated by
+     * parameters::speedup, splitting it into tiles of TileRows rows which
+     * are processed in parallel.
+     * -input: imageLuvOrgF
+     * -output: imageLuvFilteredF, imageLuvFilteredI, vecTrialsToConverge
      */
-    void nonOptimizedFilter(internals& data) const;
+    void meanShiftFilter(internals& data) const;
 
     /**
-     * Filters the image using previous mode information to avoid re-applying
-     * mean shift to some data points speedup depends on parameter speed
+     * Shift the given center once to the mean of the packed samples within
+     * the sphere of radius sigmaS / sigmaR around it.
+     *
+     * @param data internal data, with the packed samples already computed
+     * @param center center (x,y,L,u,v), replaced by the mean
+     * @param fromRow first row of the tile being filtered
+     * @param toRow row after the last one of the tile being filtered
+     * @param modeTable mode state of each pixel
+     * @param pointList if not null, the pixels of the tile within the sphere
+     *                  without mode are appended here (HighSpeedup)
+     * @param pointCount number of elements in the pointList
+     * @return the squared magnitude of the mean shift vector
+     */
+    float meanShiftStep(const internals& data,
+                        float* center,
+                        const int fromRow,
+                        const int toRow,
+                        int* modeTable,
+                        int* pointList,
+                        int& pointCount) const;
+
+    /**
+     * Filters the rows [fromRow,toRow) of the image applying mean shift to
+     * each point advantage: most accurate disadvantage : time expensive
+     *
+     * @param data internal data, with the packed samples already computed
+     * @param fromRow first row of the tile
+     * @param toRow row after the last one of the tile
+     * @param trials histogram of the number of iterations required
+     */
+    void nonOptimizedFilter(internals& data,
+                            const int fromRow,
+                            const int toRow,
+                            vector<int>& trials) const;
+
+    /**
+     * Filters the rows [fromRow,toRow) of the image using previous mode
+     * information of the same tile to avoid re-applying mean shift to some
+     * data points speedup depends on parameter speed
+     *
+     * @param data internal data, with the packed samples already computed
+     * @param fromRow first row of the tile
+     * @param toRow row after the last one of the tile
+     * @param modeTable mode state of each pixel of the image.  Only the
+     *                  entries of the tile are accessed.
+     * @param trials histogram of the number of iterations required
      */
-    void optimizedFilter(internals& data) const;
+    void optimizedFilter(internals& data,
+                         const int fromRow,
+                         const int toRow,
+                         int* modeTable,
+                         vector<int>& trials) const;
 
     /**
      * Connect neighbouring pixels having the same color values to a region
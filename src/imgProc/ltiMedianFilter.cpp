@@ -52,6 +52,8 @@
 
 #include "ltiMedianFilter.h"
 #include "ltiMedianFilter_template.h"
+#include "ltiParallelBands.h"
+#include "ltiBoundaryExpansion.h"
 
 namespace lti {
   // --------------------------------------------------
@@ -61,6 +63,7 @@ namespace lti {
   medianFilter::parameters::parameters()
     : denoising::parameters() {
     kernelSize = int(3);
+    quantize = false;
   }
 
   // copy constructor
@@ -85,6 +88,7 @@ namespace lti {
     denoising::parameters::copy(other);
 
     kernelSize = other.kernelSize;
+    quantize = other.quantize;
 
     return *this;
   }
@@ -122,6 +126,7 @@ namespace lti {
     if (b) {
 
       lti::write(handler,"kernelSize",kernelSize);
+      lti::write(handler,"quantize",quantize);
     }
 
     // This is the standard C++ code, which MS Visual C++ 6 is not able to
@@ -153,6 +158,7 @@ namespace lti {
     if (b) {
 
       lti::read(handler,"kernelSize",kernelSize);
+      lti::read(handler,"quantize",quantize);
     }
 
     // This is the standard C++ code, which MS Visual C++ 6 is not able to
@@ -270,11 +276,32 @@ namespace lti {
 
   // filters src with the median filter and gives the result to dest
   bool medianFilter::apply(const fmatrix& src,fmatrix& dest) const {
+    const parameters& param = getParameters();
+    if (param.quantize) {
+      // the quantization must be the same for all bands
+      return quantizedMethod(src,dest);
+    }
+
+    parallelBands<medianFilter> bands(*this,src.size(),
+                                      (param.boundaryType == Periodic) ?
+                                      src.rows() : param.kernelSize/2);
+    if (bands.getNumberOfBands() > 1) {
+      return bands.apply(src,dest);
+    }
+
     return realMedian(src,dest);
   }
 
   // On copy apply for type matrix<ubyte>!
   bool medianFilter::apply(const matrix<ubyte>& src,matrix<ubyte>& dest) const {
+    const parameters& param = getParameters();
+    parallelBands<medianFilter> bands(*this,src.size(),
+                                      (param.boundaryType == Periodic) ?
+                                      src.rows() : param.kernelSize/2);
+    if (bands.getNumberOfBands() > 1) {
+      return bands.apply(src,dest);
+    }
+
     return histogramMethod(src,dest);
   }
 
@@ -301,1024 +328,195 @@ namespace lti {
                  static_cast<matrix<ubyte>&>(dest));
   }
 
-  // the kernel runs inside the image
-  void medianFilter::histogramMethodMiddle(const matrix<ubyte>& src,
-                                           matrix<ubyte>& dest,
-					   ivector& histogram,
-                                           int& lessThanMedian,
-                                           int row,int& col,
-                                           ubyte& median,
-                                           int sizeOfKernel) const {
-    int i,j;//index
-    int tmp;
-    ubyte value;
-    const int limit = sizeOfKernel/2;   //half size of the kernel
-    const int halfKernelSize = (sizeOfKernel*sizeOfKernel)/2;
-    const int lastCol = src.lastColumn()-limit;
-    const int r = row+limit;
-    col = limit;
-    while(col <= (lastCol-1)) {
-      j = col-limit;
-      // 3. Step
-      for(i=row-limit;i<=r;++i) {
-        value=src[i][j];       // for each pixel in the leftmost
-        --histogram[value];    // column of intensity,take off in the histogram
-        if(value < median)    // the number of the corresponding pixels
-          --lessThanMedian;
-      }
-      // 4. Step:
-      ++col;
-      j = col+limit;               // for each pixel in the rightmost column
-      for(i=row-limit;i<=r;++i) {  // of intensity,add in the histogram
-        value=src[i][j];         // the number of the corresponding pixels
-        ++histogram[value];
-        if(value < median)
-          ++lessThanMedian;
-      }
-      if (lessThanMedian > halfKernelSize) {
-        // 6. Step
-        do {
-          --median;
-          lessThanMedian -= histogram[median];
-        } while(lessThanMedian > halfKernelSize);
-        dest.at(row,col) = median;
-      }
-      else { //if(lessThanMedian<=halfKernelSize) {
-        // 5. Step
-        tmp = lessThanMedian + histogram[median];
-        while (tmp <= halfKernelSize) {
-          lessThanMedian = tmp;
-          ++median;
-          tmp+=histogram[median];
-        }
-        dest.at(row,col) = median;
-      }
+  /*
+   * Add (delta=1) or remove (delta=0xFFFF) the pixels of a row in the
+   * column histograms.  The coarse histogram of column x, with 16 bins for
+   * the upper 4 bits of the values, starts at coarse[16*x].  The fine
+   * histograms are grouped by coarse bin, so that the fine histograms of all
+   * columns for the coarse bin b are contiguous starting at
+   * fine[16*columns*b].
+   */
+  static void updateColumnHistograms(const ubyte* row,
+                                     const int columns,
+                                     const uint16 delta,
+                                     uint16* coarse,
+                                     uint16* fine) {
+    for (int x=0;x<columns;++x) {
+      const int b = row[x] >> 4;
+      coarse[16*x+b] += delta;
+      fine[16*(columns*b + x) + (row[x] & 0x0F)] += delta;
     }
-
   }
 
-   // applies the histogramMethod for the type boundary Constant
-  bool medianFilter::histogramMethodConstant(const matrix<ubyte>& src,
-                                             matrix<ubyte>& dest,
-                                             int sizeOfKernel) const {
-    const int limit = sizeOfKernel/2;   //half size of the kernel
-        // Median Filter
-    int i,j,row,col,z;//index
-    int tmp;
-    int lessThanMedian = 0;
-    ubyte median;
-    quickMedian quickmedia;
-
-    ivector histogram(256,int(0));  //the histogram for a matrix<ubyte>
-    vector<ubyte> vect(sizeOfKernel*sizeOfKernel,ubyte(0));
-    const int rowSize = src.rows();
-    const int columnSize = src.columns();
+  // constant time median for any kernel size
+  bool medianFilter::constantTimeMethod(const matrix<ubyte>& src,
+                                        matrix<ubyte>& dest,
+                                        int sizeOfKernel) const {
+    const parameters& param = getParameters();
+    const int limit = sizeOfKernel/2;
+    const int last  = sizeOfKernel-1;
     const int halfKernelSize = (sizeOfKernel*sizeOfKernel)/2;
-    //resizes the matrix destination
-    dest.allocate(rowSize, columnSize);
-
-    const int lastCol = src.lastColumn()-limit;
-    const int lastRow = src.lastRow()-limit;
 
-    ubyte value;
-    //runs through the src's columns,inside the image
-    for(row=limit;row<=lastRow;++row) {
-      const int r = row+limit;
-      histogram.fill(int(0));
-
-      col=0;
-      z=0;
-      const int c=col+limit;
-      for(i=row-limit;i<=r;++i)
-        for(j=col-limit;j<=c;++j) {
-	  if(j<0)
-            value=src[i][0];
-	  else// if(j>=0)
-            value=src[i][j];
-	  vect.at(z)=value;
-	  ++histogram[value];
-	  ++z;
-        }
-
-      quickmedia.apply(vect, median);
-      dest.at(row,col)=median;
-
-      lessThanMedian=0;
-      for(i=0;i<vect.size();++i)
-        if(vect[i] < median)
-          ++lessThanMedian;
-
-      while(col < limit) {
-        for(i=row-limit;i<=r;++i) {
-          value = src[i][0];
-          --histogram[value];
-          if(value < median)
-            --lessThanMedian;
-	}
-        ++col;
-        j=col+limit;
-
-        for(i=row-limit;i<=r;++i) {
-          value=src[i][j];
-          ++histogram[value];
-          if(value < median) {
-            ++lessThanMedian;
-          }
-        }
-        if (lessThanMedian>halfKernelSize) {
-          // 6. Step
-          do {
-            --median;
-            lessThanMedian-=histogram[median];
-          } while(lessThanMedian>halfKernelSize);
-          dest.at(row,col)=median;
-        }
-        else { //if(lessThanMedian<=halfKernelSize) {
-              // 5. Step
-          tmp = lessThanMedian + histogram[median];
-          while (tmp <= halfKernelSize) {
-            lessThanMedian = tmp;
-            ++median;
-            tmp+=histogram[median];
-          }
-          dest.at(row,col)=median;
-        }
-      }
-      // runs inside the image
-      histogramMethodMiddle(src, dest,histogram,lessThanMedian,
-                            row,col,median,sizeOfKernel);
-      col=lastCol;
-      while(col < (columnSize-1)) {
-        j=col-limit;
-        for(i=row-limit;i<=r;++i) {
-          value=src[i][j];
-          --histogram[value];
-          if(value < median)
-            --lessThanMedian;
-        }
-        ++col;
-
-        for(i=row-limit;i<=r;++i) {
-          value=src[i][columnSize-1];
-          ++histogram[value];
-          if(value < median)
-            ++lessThanMedian;
-        }
-        if (lessThanMedian > halfKernelSize) {
-          // 6. Step
-          do {
-            --median;
-            lessThanMedian -= histogram[median];
-          } while(lessThanMedian > halfKernelSize);
-          dest.at(row,col) = median;
-        }
-        else { //if(lessThanMedian<=halfKernelSize) {
-          // 5. Step
-          tmp = lessThanMedian + histogram[median];
-          while (tmp <= halfKernelSize) {
-            lessThanMedian = tmp;
-            ++median;
-            tmp+=histogram[median];
-          }
-          dest.at(row,col) = median;
-        }
-      }
+    // with boundaries, the filter runs on all internal pixels of the
+    // expanded image, otherwise just on the internal pixels of src
+    matrix<ubyte> expanded;
+    const matrix<ubyte>* img = &src;
+    int offset = limit;
+    if (param.boundaryType != lti::NoBoundary) {
+      boundaryExpansion expander(limit,param.boundaryType);
+      if (!expander.apply(src,expanded)) {
+        setStatusString(expander.getStatusString());
+        return false;
+      }
+      img = &expanded;
+      offset = 0;
     }
-    for(row=0;row<limit;++row) {     //runs the rows at the top
-      const int r=row+limit;
-      // runs the rows at the top in the middle
-      for(col=limit;col<=lastCol;++col) {
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-	  for(j=col-limit;j<=c;++j) {
-	    if(i<0)
-              vect.at(z)=src[0][j];
-	    else//if(i>=0) {
-              vect.at(z)=src[i][j];
-	    ++z;
-          }
-	quickmedia.apply(vect, dest.at(row,col));
-      }
-      for(col=0;col<limit;++col) {   // runs at the top,left in the corner
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-	  for(j=col-limit;j<=c;++j) {
-            if(i<0 && j<0)
-              vect.at(z)=src[0][0];
-            else if(i>=0 && j<0)
-              vect.at(z)=src[i][0];
-            else if(i<0 && j>=0)
-              vect.at(z)=src[0][j];
-            else //if(i>=0 && j>=0)
-              vect.at(z)=src[i][j];
-	    ++z;
-          }
-	quickmedia.apply(vect, dest.at(row,col));
-      }
-      //runs at the top,right in the corner
-      for(col=lastCol+1;col<columnSize;++col) {
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-          for(j=col-limit;j<=c;++j) {
-            if(i<0 && j<=columnSize-1)
-              vect.at(z)=src[0][j];
-            else if(i<0 && j>columnSize-1)
-              vect.at(z)=src[0][columnSize-1];
-            else if(i>=0 && j>columnSize-1)
-              vect.at(z)=src[i][columnSize-1];
-            else //if(i>=0 && j<=columnSize-1)
-              vect.at(z)=src[i][j];
-	    ++z;
-	  }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-    }
-    for(row=lastRow+1;row<=rowSize-1;++row) {  //runs the rows at the bottom
-      const int r=row+limit;
-      //runs the rows at the bottom in the middle
-      for(col=limit;col<=lastCol;++col) {
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-          for(j=col-limit;j<=c;++j) {
-            if(i<=rowSize-1)
-              vect.at(z)=src[i][j];
-            else // if(i>rowSize-1)
-              vect.at(z)=src[rowSize-1][j];
-	    ++z;
-          }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-      //runs at the bottom,left in the corner
-      for(col=0;col<limit;++col) {
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-          for(j=col-limit;j<=c;++j) {
-            if(i<=rowSize-1 && j<0)
-              vect.at(z)=src[i][0];
-            else if(i<=rowSize-1 && j>=0)
-              vect.at(z)=src[i][j];
-            else if(i>rowSize-1 && j<0)
-              vect.at(z)=src[rowSize-1][0];
-            else //if(i>rowSize-1 && j>=0)
-              vect.at(z)=src[rowSize-1][j];
-	    ++z;
-          }
-	quickmedia.apply(vect, dest.at(row,col));
-      }
-      //runs at the bottom,right in the corner
-      for(col=lastCol+1;col<columnSize;++col){
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-          for(j=col-limit;j<=c;++j) {
-            if(i<=rowSize-1 && j<=columnSize-1)
-              vect.at(z)=src[i][j];
-            else if(i<=rowSize-1 && j>columnSize-1)
-              vect.at(z)=src[i][columnSize-1];
-            else if(i>rowSize-1 && j<=columnSize-1)
-              vect.at(z)=src[rowSize-1][j];
-            else //if(i>rowSize-1 && j>columnSize-1)
-              vect.at(z)=src[rowSize-1][columnSize-1];
-	    ++z;
-          }
-	quickmedia.apply(vect, dest.at(row,col));
-      }
-    }
-    return true;
-  }
 
-  // applies the histogramMethod for the type boundary Periodic
-  bool medianFilter::histogramMethodPeriodic(const matrix<ubyte>& src,
-                                             matrix<ubyte>& dest,
-                                             int sizeOfKernel) const {
-    const int limit = sizeOfKernel/2;   //half size of the kernel
-    int i,j,row,col,z;//index
-    int tmp;
-    int lessThanMedian = 0;
-    ubyte median;
-    quickMedian quickmedia;
+    dest.allocate(src.rows(),src.columns());
 
-    vector<ubyte> vect(sizeOfKernel*sizeOfKernel,ubyte(0));
-    ivector histogram(256,int(0));  //the histogram for a matrix<ubyte>
+    const int columns = img->columns();
+    const int outRows = img->rows()-last;
+    const int outCols = columns-last;
+    if ((outRows <= 0) || (outCols <= 0)) {
+      return true;
+    }
 
-    const int rowSize = src.rows();
-    const int columnSize = src.columns();
-    const int halfKernelSize = (sizeOfKernel*sizeOfKernel)/2;
-    //resizes the matrix destination
-    dest.allocate(src.rows(),src.columns());
+    vector<uint16> colCoarse(16*columns,uint16(0));
+    vector<uint16> colFine(256*columns,uint16(0));
+    ivector kernelCoarse(16);
+    ivector kernelFine(256);
+    // for each coarse bin, column after the last one included in its fine
+    // histogram, which is updated only when the median falls in that bin
+    ivector lastUpdate(16);
+
+    uint16* const cc = colCoarse.data();
+    uint16* const cf = colFine.data();
+    int* const hc = kernelCoarse.data();
+    int* const hf = kernelFine.data();
+    int* const luc = lastUpdate.data();
+
+    int x,y,b,f,c;
+    for (y=0;y<last;++y) {
+      updateColumnHistograms(img->getRow(y).data(),columns,1,cc,cf);
+    }
 
-    const int lastCol = src.lastColumn()-limit;
-    const int lastRow = src.lastRow()-limit;
+    for (y=0;y<outRows;++y) {
+      updateColumnHistograms(img->getRow(y+last).data(),columns,1,cc,cf);
 
-    ubyte value;
-    //runs through the src's columns,inside the image
-    for(row=limit;row<=lastRow;++row) {
-      const int r = row+limit;
-      histogram.fill(int(0));
-
-      z=0;
-      col=0;
-      const int c=col+limit;
-      for(i=row-limit;i<=r;++i)
-	for(j=col-limit;j<=c;++j) {
-          if(j<0)
-            value=src[i][j+columnSize];
-          else // if(j>=0)
-            value=src[i][j];
-	  vect.at(z)=value;
-	  ++histogram[value];
-	  ++z;
-        }
-      quickmedia.apply(vect, median);
-      dest.at(row,col)=median;
-
-      lessThanMedian = 0;
-      for(i=0;i<vect.size();++i)   // count the number of pixels with intensity
-        if(vect[i] < median)       // can be optimized for Zero boundary type
-          ++lessThanMedian;        // less than or equal to median
-
-      while(col < limit) {
-	j = col-limit;
-        for(i=row-limit;i<=r;++i){
-          value=src[i][j+columnSize];
-          --histogram[value];
-          if(value < median)
-            --lessThanMedian;
-        }
-        ++col;
-        j=col+limit;
-        for(i=row-limit;i<=r;++i) {
-          value=src[i][j];
-          ++histogram[value];
-          if(value < median)
-            ++lessThanMedian;
-        }
-        if (lessThanMedian > halfKernelSize) {
-          // 6. Step
-          do {
-            --median;
-            lessThanMedian-=histogram[median];
-          } while(lessThanMedian>halfKernelSize);
-          dest.at(row,col)=median;
-        }
-        else { //if(lessThanMedian<=halfKernelSize) {
-          // 5. Step
-          tmp = lessThanMedian + histogram[median];
-          while (tmp <= halfKernelSize) {
-            lessThanMedian = tmp;
-            ++median;
-            tmp+=histogram[median];
-          }
-          dest.at(row,col) = median;
+      kernelCoarse.fill(0);
+      lastUpdate.fill(0);
+      for (x=0;x<last;++x) {
+        const uint16* const col = cc+16*x;
+        for (b=0;b<16;++b) {
+          hc[b] += col[b];
         }
       }
-      //runs inside the image
-      histogramMethodMiddle(src,dest,histogram,lessThanMedian,
-			    row,col,median,sizeOfKernel);
-      col=lastCol;
-      while(col < (columnSize-1)) {
-        j = col-limit;
-
-        for(i=row-limit;i<=r;++i) {
-          value=src[i][j];     // for each pixel in the leftmost
-          --histogram[value];  // column of intensity,take off in the histogram
-          if(value < median) // the number of the corresponding pixels
-            --lessThanMedian;
-	}
-        ++col;
-        j=col+limit;
-        for(i=row-limit;i<=r;++i) {
-          value = src[i][j-columnSize];
-          ++histogram[value];
-          if(value < median)
-            ++lessThanMedian;
-	}
-        if (lessThanMedian>halfKernelSize) {
-          // 6. Step
-          do {
-            --median;
-            lessThanMedian-=histogram[median];
-          } while(lessThanMedian>halfKernelSize);
-          dest.at(row,col)=median;
+
+      ubyte* const out = dest.getRow(y+offset).data()+offset;
+      for (x=0;x<outCols;++x) {
+        const uint16* col = cc+16*(x+last);
+        for (b=0;b<16;++b) {
+          hc[b] += col[b];
         }
-        else { //if(lessThanMedian<=halfKernelSize) {
-              // 5. Step
-          tmp = lessThanMedian + histogram[median];
-          while (tmp <= halfKernelSize) {
-            lessThanMedian = tmp;
-            ++median;
-            tmp+=histogram[median];
-          }
-          dest.at(row,col)=median;
+
+        // coarse bin containing the median
+        int lessThanMedian = 0;
+        for (b=0;lessThanMedian+hc[b] <= halfKernelSize;++b) {
+          lessThanMedian += hc[b];
         }
-      }
-    }
-    for(row=0;row<limit;++row) {          //runs the rows at the top
-      const int r=row+limit;
-      // runs the rows at the top in the middle
-      for(col=limit;col<=lastCol;++col) {
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-	  for(j=col-limit;j<=c;++j) {
-	    if(i<0)
-              vect.at(z)=src[i+rowSize][j];
-            else //if(i>=0)
-              vect.at(z)=src[i][j];
-	    ++z;
-          }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-      for(col=0;col<limit;++col) {       // runs at the top,left in the corner
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-	  for(j=col-limit;j<=c;++j) {
-            if(i<0 && j<0)
-              vect.at(z)=src[rowSize+i][columnSize+j];
-            else if(i>=0 && j<0)
-              vect.at(z)=src[i][columnSize+j];
-            else if(i<0 && j>=0)
-              vect.at(z)=src[rowSize+i][j];
-            else //if(i>=0 && j>=0)
-              vect.at(z)=src[i][j];
-	    ++z;
+
+        // bring the fine histogram of that bin up to date
+        int* const h = hf+16*b;
+        const uint16* const fine = cf+16*columns*b;
+        if (luc[b] <= x) {
+          // no overlap with the last window: compute it from scratch
+          for (f=0;f<16;++f) {
+            h[f] = 0;
           }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-      //runs at the top,right in the corner
-      for(col=lastCol+1;col<columnSize;++col) {
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-          for(j=col-limit;j<=c;++j) {
-            if(i<0 && j<=columnSize-1)
-              vect.at(z)=src[rowSize+i][j];
-            else if(i<0 && j>columnSize-1)
-              vect.at(z)=src[rowSize+i][j-columnSize];
-            else if(i>=0 && j>columnSize-1)
-              vect.at(z)=src[i][j-columnSize];
-            else //if(i>=0 && j<=columnSize-1)
-              vect.at(z)=src[i][j];
-	    ++z;
+          for (c=x;c<x+sizeOfKernel;++c) {
+            const uint16* const fc = fine+16*c;
+            for (f=0;f<16;++f) {
+              h[f] += fc[f];
+            }
           }
-	quickmedia.apply(vect, dest.at(row,col));
-      }
-    }
-    for(row=lastRow+1;row<=rowSize-1;++row) {  //runs the rows at the bottom
-      const int r=row+limit;
-      //runs the rows at the bottom in the middle
-      for(col=limit;col<=lastCol;++col) {
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-          for(j=col-limit;j<=c;++j) {
-            if(i<=rowSize-1)
-              vect.at(z)=src[i][j];
-            else // if(i>rowSize-1)
-              vect.at(z)=src[i-rowSize][j];
-	    ++z;
-	  }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-      for(col=0;col<limit;++col) {    //runs at the bottom,left in the corner
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-          for(j=col-limit;j<=c;++j) {
-            if(i<=rowSize-1 && j<0)
-              vect.at(z)=src[i][columnSize+j];
-            else if(i<=rowSize-1 && j>=0)
-              vect.at(z)=src[i][j];
-            else if(i>rowSize-1 && j<0)
-              vect.at(z)=src[i-rowSize][columnSize+j];
-            else //if(i>rowSize-1 && j>=0)
-              vect.at(z)=src[i-rowSize][j];
-	    ++z;
+        } else {
+          for (c=luc[b];c<x+sizeOfKernel;++c) {
+            const uint16* const fa = fine+16*c;
+            const uint16* const fr = fine+16*(c-sizeOfKernel);
+            for (f=0;f<16;++f) {
+              h[f] += fa[f] - fr[f];
+            }
           }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-      //runs at the bottom,right in the corner
-      for(col=lastCol+1;col<columnSize;++col) {
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-          for(j=col-limit;j<=c;++j) {
-            if(i<=rowSize-1 && j<=columnSize-1)
-              vect.at(z)=src[i][j];
-            else if(i<=rowSize-1 && j>columnSize-1)
-              vect.at(z)=src[i][j-columnSize];
-            else if(i>rowSize-1 && j<=columnSize-1)
-              vect.at(z)=src[i-rowSize][j];
-            else //if(i>rowSize-1 && j>columnSize-1)
-              vect.at(z)=src[i-rowSize][j-columnSize];
-	    ++z;
-          }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-    }
-    return true;
-  }
-
-  // applies the histogramMethod for the type boundary Mirror
-  bool medianFilter::histogramMethodMirror(const matrix<ubyte>& src,
-                                           matrix<ubyte>& dest,
-                                           int sizeOfKernel) const {
-    const int limit = sizeOfKernel/2;   //half size of the kernel
-
-    // Median Filter
-    int i,j,row,col,z;//index
-    int tmp;
-    int lessThanMedian = 0;
-    ubyte median;
-    quickMedian quickmedia;
-
-    vector<ubyte> vect(sizeOfKernel*sizeOfKernel,ubyte(0));
-    ivector histogram(256,int(0));  //the histogram for a matrix<ubyte>
-
-    const int rowSize = src.rows();
-    const int columnSize = src.columns();
-    const int halfKernelSize = (sizeOfKernel*sizeOfKernel)/2;
-    //resizes the matrix destination
-    dest.allocate(src.rows(),src.columns());
-
-    const int lastCol = src.lastColumn()-limit;
-    const int lastRow = src.lastRow()-limit;
-    ubyte value;
-
-    //runs through the src's columns,inside the image
-    for(row=limit;row<=lastRow;++row) {
-      const int r = row+limit;
-      histogram.fill(int(0));
-
-      z=0;
-      col=0;
-      const int c=col+limit;
-      for(i=row-limit;i<=r;++i)
-	for(j=col-limit;j<=c;++j) {
-          if(j<0)
-            value=src[i][-j-1];
-          else // if(j>=0)
-            value=src[i][j];
-	  vect.at(z)=value;
-	  ++histogram[value];
-	  ++z;
-	}
-      quickmedia.apply(vect, median);
-      dest.at(row,col)=median;
-
-      lessThanMedian = 0;
-      for(i=0;i<vect.size();++i)  // count the number of pixels with intensity
-        if(vect[i] < median)     // less than median
-          ++lessThanMedian;
-
-      while(col < limit) {
-        j = col-limit;
-        for(i=row-limit;i<=r;++i) {
-          value=src[i][-j-1];
-          --histogram[value];
-          if(value < median)
-            --lessThanMedian;
-        }
-        ++col;
-        j=col+limit;
-        for(i=row-limit;i<=r;++i) {
-          value=src[i][j];
-          ++histogram[value];
-          if(value < median)
-            ++lessThanMedian;
-        }
-        if (lessThanMedian > halfKernelSize) {
-          // 6. Step
-          do {
-            --median;
-            lessThanMedian-=histogram[median];
-          } while(lessThanMedian>halfKernelSize);
-          dest.at(row,col)=median;
-        }
-        else { //if(lessThanMedian<=halfKernelSize) {
-          // 5. Step
-          tmp = lessThanMedian + histogram[median];
-          while (tmp <= halfKernelSize) {
-            lessThanMedian = tmp;
-            ++median;
-            tmp+=histogram[median];
-          }
-          dest.at(row,col)=median;
-        }
-      }
-      // runs inside the image
-      histogramMethodMiddle(src,dest,histogram,lessThanMedian,
-                            row,col,median,sizeOfKernel);
-      col=lastCol;
-      while(col < (columnSize-1)) {
-        j = col-limit;
-
-        for(i=row-limit;i<=r;++i) {
-          value=src[i][j];     // for each pixel in the leftmost
-          --histogram[value];  // column of intensity,take off in the histogram
-	  if(value < median)   // the number of the corresponding pixels
-            --lessThanMedian;
-        }
-        ++col;
-        j=col+limit;
-        for(i=row-limit;i<=r;++i) {
-          value = src[i][columnSize-1+(columnSize-j)];
-          ++histogram[value];
-          if(value < median)
-            ++lessThanMedian;
         }
-        if (lessThanMedian>halfKernelSize) {
-          // 6. Step
-          do {
-            --median;
-            lessThanMedian-=histogram[median];
-          } while(lessThanMedian>halfKernelSize);
-          dest.at(row,col)=median;
+        luc[b] = x+sizeOfKernel;
+
+        for (f=0;lessThanMedian+h[f] <= halfKernelSize;++f) {
+          lessThanMedian += h[f];
         }
-        else { //if(lessThanMedian<=halfKernelSize) {
-          // 5. Step
-          tmp = lessThanMedian + histogram[median];
-          while (tmp <= halfKernelSize) {
-            lessThanMedian = tmp;
-            ++median;
-            tmp+=histogram[median];
-          }
-          dest.at(row,col)=median;
+        out[x] = static_cast<ubyte>((b << 4) + f);
+
+        col = cc+16*x;
+        for (b=0;b<16;++b) {
+          hc[b] -= col[b];
         }
       }
 
+      updateColumnHistograms(img->getRow(y).data(),columns,0xFFFF,cc,cf);
     }
-    for(row=0;row<limit;++row) {      //runs the rows at the top
-      const int r=row+limit;          // runs the rows at the top in the middle
-      for(col=limit;col<=lastCol;++col) {
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-	  for(j=col-limit;j<=c;++j) {
-	    if(i<0)
-              vect.at(z)=src[-i-1][j];
-            else //if(i>=0)
-              vect.at(z)=src[i][j];
-	    ++z;
-	  }
-	quickmedia.apply(vect, dest.at(row,col));
-      }
 
-      for(col=0;col<limit;++col) {      // runs at the top,left in the corner
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-	  for(j=col-limit;j<=c;++j) {
-            if(i<0 && j<0)
-              vect.at(z)=src[-i-1][-j-1];
-            else if(i>=0 && j<0)
-              vect.at(z)=src[i][-j-1];
-            else if(i<0 && j>=0)
-              vect.at(z)=src[-i-1][j];
-            else //if(i>=0 && j>=0)
-              vect.at(z)=src[i][j];
-	    ++z;
-          }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-      //runs at the top,right in the corner
-      for(col=lastCol+1;col<columnSize;++col) {
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-          for(j=col-limit;j<=c;++j) {
-            if(i<0 && j<=columnSize-1)
-              vect.at(z)=src[-i-1][j];
-            else if(i<0 && j>columnSize-1)
-              vect.at(z)=src[-i-1][columnSize-1+(columnSize-j)];
-            else if(i>=0 && j>columnSize-1)
-              vect.at(z)=src[i][columnSize-1+(columnSize-j)];
-            else //if(i>=0 && j<=columnSize-1)
-              vect.at(z)=src[i][j];
-	    ++z;
-          }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-    }
-    for(row=lastRow+1;row<=rowSize-1;++row) {  //runs the rows at the bottom
-      const int r=row+limit;
-      //runs the rows at the bottom in the middle
-      for(col=limit;col<=lastCol;++col) {
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-          for(j=col-limit;j<=c;++j) {
-            if(i<=rowSize-1)
-              vect.at(z)=src[i][j];
-            else // if(i>rowSize-1)
-              vect.at(z)=src[rowSize-1+(rowSize-i)][j];
-	    ++z;
-	  }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-      for(col=0;col<limit;++col) {    //runs at the bottom,left in the corner
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-          for(j=col-limit;j<=c;++j) {
-            if(i<=rowSize-1 && j<0)
-              vect.at(z)=src[i][-j-1];
-            else if(i<=rowSize-1 && j>=0)
-              vect.at(z)=src[i][j];
-            else if(i>rowSize-1 && j<0)
-              vect.at(z)=src[rowSize-1+(rowSize-i)][-j-1];
-            else //if(i>rowSize-1 && j>=0)
-              vect.at(z)=src[rowSize-1+(rowSize-i)][j];
-	    ++z;
-	  }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-      //runs at the bottom,right in the corner
-      for(col=lastCol+1;col<columnSize;++col) {
-        const int c=col+limit;
-        z=0;
-        for(i=row-limit;i<=r;++i)
-          for(j=col-limit;j<=c;++j) {
-            if(i<=rowSize-1 && j<=columnSize-1)
-              vect.at(z)=src[i][j];
-            else if(i<=rowSize-1 && j>columnSize-1)
-              vect.at(z)=src[i][columnSize-1+(columnSize-j)];
-            else if(i>rowSize-1 && j<=columnSize-1)
-              vect.at(z)=src[rowSize-1+(rowSize-i)][j];
-            else //if(i>rowSize-1 && j>columnSize-1)
-              vect.at(z)
-                =src[rowSize-1+(rowSize-i)][columnSize-1+(columnSize-j)];
-	    ++z;
-	  }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-    }
     return true;
   }
 
-  // applies the histogramMethod for the type boundary Zero
-  bool medianFilter::histogramMethodZero(const matrix<ubyte>& src,
-                                          matrix<ubyte>& dest,
-                                          int sizeOfKernel) const {
-    const int limit = sizeOfKernel/2;   //half size of the kernel
-        // Median Filter
-    int i,j,row,col,z;//index
-    int tmp;
-    int lessThanMedian = 0;
-    ubyte median;
-    quickMedian quickmedia;
-
-    vector<ubyte> vect(sizeOfKernel*sizeOfKernel,ubyte(0));
-    ivector histogram(256,int(0));  //the histogram for a matrix<ubyte>
-
-    const int rowSize = src.rows();
-    const int columnSize = src.columns();
-    const int halfKernelSize = (sizeOfKernel*sizeOfKernel)/2;
-    //resizes the matrix destination
-    dest.allocate(src.rows(),src.columns());
-
-    const int lastCol = src.lastColumn()-limit;
-    const int lastRow = src.lastRow()-limit;
-    ubyte value;
-
-    //runs through the src's columns,inside the image
-    for(row=limit;row<=lastRow;++row) {
-      const int r = row+limit;
-      histogram.fill(int(0));
-      col=0;
-
-      z = sizeOfKernel*(sizeOfKernel-limit-1);
-      vect.fill(ubyte(0),0,z-1);
-      histogram[0] = z;  //the number of 0's are known
-
-      for(i=row-limit;i<=r;++i)  // fills the vector to calculate the median
-                                 // and fills the histogram
-        for(j=0;j<=limit;++j) {
-          value=src[i][j];
-          vect.at(z)=value;
-          ++z;
-          ++histogram[value];
-        }
-      quickmedia.apply(vect, median);    //here is the median
-      dest.at(row,0) = median;
-
-      lessThanMedian = 0;
-      for(i=0;i<vect.size();++i)  // count the number of pixels with intensity
-        if(vect[i] < median)      // less than or equal to median
-          ++lessThanMedian;       // this can be optimized for Zero boundary type
-
-      //  col=0;
-      // the kernel at the position between the border and the image
-      while(col < limit) {
-        histogram[0] -= sizeOfKernel;   // cut all the 0 in the leftmost column
-                                // because 0 is the smallest value
-        if(median != 0) {
-          lessThanMedian -= sizeOfKernel;
-        }
-        ++col;
-        j = col+limit;              // for each pixel in the rightmost column
-        for(i=row-limit;i<=r;++i) { // of intensity,add the value
-                                    //in the histogram
-          value=src[i][j];       // and increment the number of pixels less
-          ++histogram[value];    // than the median
-          if(value < median)
-            ++lessThanMedian;
-        }
-        if (lessThanMedian > halfKernelSize) {
-          // 6. Step
-          do {
-            --median;
-            lessThanMedian-=histogram[median];
-          } while(lessThanMedian>halfKernelSize);
-          dest.at(row,col)=median;
-        }
-        else { //if(lessThanMedian<=halfKernelSize) {
-          // 5. Step
-          tmp = lessThanMedian + histogram[median];
-          while (tmp <= halfKernelSize) {
-            lessThanMedian = tmp;
-            ++median;
-            tmp+=histogram[median];
-          }
-          dest.at(row,col)=median;
-        }
-      }
-      //runs inside the image
-      histogramMethodMiddle(src,dest,histogram,lessThanMedian,
-                            row,col,median,sizeOfKernel);
-      col = lastCol;
-      while(col < (columnSize-1)) {
-        j = col-limit;
-        for(i=row-limit;i<=r;++i) {
-          value=src[i][j];     // for each pixel in the leftmost
-          --histogram[value];  // column of intensity,take off in the histogram
-          if(value < median) { // the number of the corresponding pixels
-            --lessThanMedian;
-          }
-        }
-        ++col;
-        histogram[0] += sizeOfKernel;
-
-        if(median != 0) {
-          lessThanMedian += sizeOfKernel;
-        }
-        if (lessThanMedian > halfKernelSize) {
-          // 6. Step
-          do {
-            --median;
-            lessThanMedian -= histogram[median];
-          } while(lessThanMedian > halfKernelSize);
-          dest.at(row,col) = median;
-        }
-        else { //if(lessThanMedian<=halfKernelSize) {
-          // 5. Step
-          tmp = lessThanMedian + histogram[median];
-          while (tmp <= halfKernelSize) {
-            lessThanMedian = tmp;
-            ++median;
-            tmp+=histogram[median];
-          }
-          dest.at(row,col) = median;
-        }
-      }
+  // median of quantized float data
+  bool medianFilter::quantizedMethod(const fmatrix& src,
+                                     fmatrix& dest) const {
+    if (src.empty()) {
+      dest.clear();
+      return true;
     }
-    for(row=0;row<limit;++row) {  //runs the rows at the top
-      z=sizeOfKernel*(sizeOfKernel-limit-1);
-      vect.fill(ubyte(0),0,z-1);
-      const int r=row+limit;
-      // runs the rows at the top in the middle
-      for(col=limit;col<=lastCol;++col) {
-        const int c=col+limit;
-        z=sizeOfKernel*(sizeOfKernel-(limit+1)-row);
-
-        for(i=0;i<=r;++i)
-          for(j=col-limit;j<=c;++j) {
-	    vect.at(z)=src[i][j];
-            ++z;
-          }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-      for(col=0;col<limit;++col) {    // runs at the top,left in the corner
-        const int c=col+limit;
-        z=sizeOfKernel*sizeOfKernel-(limit+1)*(limit+1+row+col)-col*row;
-        vect.fill(ubyte(0),0,z-1);
-        for(i=0;i<=r;++i)
-	  for(j=0;j<=c;++j) {
-	    vect.at(z)=src[i][j];
-            ++z;
-	  }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-      //runs at the top,right in the corner
-      for(col=lastCol+1;col<=columnSize-1;++col) {
-        z=sizeOfKernel*sizeOfKernel-(limit+1)*(limit+1+row+(columnSize-1-col))-
-          row*(columnSize-1-col);
-        vect.fill(ubyte(0),0,z-1);
-        for(i=0;i<=r;++i) {
-          for(j=col-limit;j<=columnSize-1;++j) {
-            vect.at(z)=src[i][j];
-            ++z;
-          }
+
+    // quantization interval
+    float lo = 0.0f;
+    float hi = 1.0f;
+    int y,x;
+    for (y=0;y<src.rows();++y) {
+      const fvector& row = src.getRow(y);
+      for (x=0;x<row.size();++x) {
+        if (row[x] < lo) {
+          lo = row[x];
+        } else if (row[x] > hi) {
+          hi = row[x];
         }
-        quickmedia.apply(vect, dest.at(row,col));
       }
     }
-    for(row=lastRow+1;row<=rowSize-1;++row) {  //runs the rows at the bottom
-      z=sizeOfKernel*(sizeOfKernel-limit-1);
-      vect.fill(ubyte(0),0,z-1);
-      //runs the rows at the bottom in the middle
-      for(col=limit;col<=lastCol;++col) {
-        const int c=col+limit;
-        z=sizeOfKernel*(sizeOfKernel-(limit+1)-(rowSize-1-row));
-        vect.fill(ubyte(0),0,z-1);
-        for(i=row-limit;i<=rowSize-1;++i)
-          for(j=col-limit;j<=c;++j) {
-            vect.at(z)=src[i][j];
-            ++z;
-          }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-      for(col=0;col<limit;++col) {   //runs at the bottom,left in the corner
-        const int c=col+limit;
-        z=sizeOfKernel*sizeOfKernel-(limit+1)*
-          (limit+1+(rowSize-1-row)+col)-col*(rowSize-1-row);
-        vect.fill(ubyte(0),0,z-1);
-        for(i=row-limit;i<=rowSize-1;++i)
-          for(j=0;j<=c;++j) {
-            vect.at(z)=src[i][j];
-            ++z;
-          }
-        quickmedia.apply(vect, dest.at(row,col));
-      }
-      //runs at the bottom,right in the corner
-      for(col=lastCol+1;col<=columnSize-1;++col) {
-        z=sizeOfKernel*sizeOfKernel-(limit+1)*(limit+1+(rowSize-1-row)+
-           (columnSize-1-col))-
-          (rowSize-1-row)*(columnSize-1-col);
-        vect.fill(ubyte(0),0,z-1);
-        for(i=row-limit;i<=rowSize-1;++i)
-          for(j=col-limit;j<=columnSize-1;++j) {
-            vect.at(z)=src[i][j];
-            ++z;
-          }
-        quickmedia.apply(vect, dest.at(row,col));
+
+    const float range = hi-lo;
+    const float scale = 255.0f/range;
+    matrix<ubyte> q(src.rows(),src.columns());
+    for (y=0;y<src.rows();++y) {
+      const fvector& row = src.getRow(y);
+      vector<ubyte>& qrow = q.getRow(y);
+      for (x=0;x<row.size();++x) {
+        qrow[x] = static_cast<ubyte>((row[x]-lo)*scale + 0.5f);
       }
     }
-    return true;
-  }
 
-  // applies the histogramMethod for the type boundary NoBoundary
-  bool medianFilter::histogramMethodNoBoundary(const matrix<ubyte>& src,
-					       matrix<ubyte>& dest,
-					       int sizeOfKernel) const {
-    const int limit = sizeOfKernel/2;   //half size of the kernel
-    int i,j,row,col,z;
-    int lessThanMedian = 0;
-    ubyte median;
-    quickMedian quickmedia;
-
-    vector<ubyte> vect(sizeOfKernel*sizeOfKernel,ubyte(0));
-    ivector histogram(256,int(0));   // the histogram for a matrix<ubyte>
-
-    const int lastRow = src.lastRow()-limit;
+    matrix<ubyte> qdest;
+    if (!apply(q,qdest)) {
+      return false;
+    }
 
-    //resizes the destination matrix
     dest.allocate(src.rows(),src.columns());
-    ubyte value;
-    //runs through the src's columns,inside the image
-    for(row=limit;row<=lastRow;++row) {
-      const int r = row+limit;
-      histogram.fill(int(0));
-
-      z=0;
-      for(i=row-limit;i<=r;++i)
-	for(j=0;j<sizeOfKernel;++j) {    // determinate the median
-                                         // at the beginning
-          value = src[i][j];
-          vect.at(z) = value; // of each rows and fill the histogram
-          ++z;
-          ++histogram[value];
-        }
-      quickmedia.apply(vect, median);
-      dest.at(row,limit) = median;
-
-      lessThanMedian=0;
-      for(i=0;i<vect.size();++i) // count the number of pixels with intensity
-        if(vect[i] < median)     // less than or equal to median
-          ++lessThanMedian;
-
-      // runs inside the image
-      histogramMethodMiddle(src,dest,histogram,lessThanMedian,
-			    row,col,median,sizeOfKernel);
+    for (y=0;y<src.rows();++y) {
+      const vector<ubyte>& qrow = qdest.getRow(y);
+      fvector& row = dest.getRow(y);
+      for (x=0;x<row.size();++x) {
+        row[x] = lo + (range*static_cast<float>(qrow[x]))/255.0f;
+      }
     }
+
     return true;
- }
+  }
 
   // apply especially with a histogram,only for type matrix<ubyte>
   bool medianFilter::histogramMethod(const matrix<ubyte>& src,
@@ -1337,30 +535,8 @@ namespace lti {
     }
 
     const int sizeOfKernel = param.kernelSize + ((param.kernelSize%2 == 0) ? 1:0);
-    bool control = false;   // return variable
 
-    // 2. Step
-    switch(param.boundaryType) {
-      case lti::Zero:
-        control = histogramMethodZero(src,dest,sizeOfKernel);
-        break;
-      case lti::Mirror:
-        control = histogramMethodMirror(src,dest,sizeOfKernel);
-        break;
-      case lti::Constant:
-        control = histogramMethodConstant(src,dest,sizeOfKernel);
-        break;
-      case lti::Periodic:
-        control = histogramMethodPeriodic(src,dest,sizeOfKernel);
-        break;
-      case lti::NoBoundary:
-        control = histogramMethodNoBoundary(src,dest,sizeOfKernel);
-        break;
-      default:
-        setStatusString("Unknown boundary type");
-        break;
-    }
-    return control;
+    return constantTimeMethod(src,dest,sizeOfKernel);
   }
 
 
@@ -76,8 +76,18 @@ namespace lti {
    * The median value of an n x n kernel window is left in its center
    * position.
    *
-   * The algorithm for lti::fmatrix uses the straightforward method, and
-   * is not as fast as the histogram-based method used for lti::matrix<ubyte>.
+   * For lti::matrix<ubyte> (and lti::channel8) the column histogram method
+   * of Perreault and Hebert ("Median Filtering in Constant Time", IEEE
+   * Trans. on Image Processing, 16(9), 2007) is used, whose cost per pixel
+   * does not depend on the kernel size.  The vectors use a sliding
+   * histogram.
+   *
+   * The algorithm for lti::fmatrix uses by default the straightforward
+   * method, which sorts each window and is much slower than the
+   * histogram-based methods, especially for large kernels.  If
+   * parameters::quantize is set, the float data is quantized to 256
+   * levels and filtered with the histogram methods instead (see the
+   * parameter for the resulting error).
    *
    * \code 
    * matrix<ubyte> src;          //obtained from somewhere
@@ -183,6 +193,27 @@ namespace lti {
        */
       int kernelSize;
 
+      /**
+       * Quantize float data.
+       *
+       * If \c true, the apply methods for lti::fmatrix and lti::channel
+       * quantize the data to 256 levels and use the histogram-based methods
+       * of lti::channel8, whose time per pixel does not depend on the kernel
+       * size.  The quantization interval is [0,1], the usual range of
+       * channels, extended to the minimum and maximum of the data if they
+       * lie outside it.  Since the quantization is monotonic, the median of
+       * the quantized data is the quantized median, and the result differs
+       * from the exact one at most by half a quantization step, i.e. by
+       * (max-min)/510 for the interval [min,max].  A channel created from
+       * a channel8 is filtered exactly, producing the same result as the
+       * channel8 itself.
+       *
+       * If \c false, the exact median of the float values is computed,
+       * which is much slower for large kernels.
+       *
+       * Default: false
+       */
+      bool quantize;
     };
 
     /**
@@ -379,51 +410,17 @@ namespace lti {
     //@{
 
     /**
-     * Runs inside the image src
+     * Constant time median (Perreault and Hebert) for all boundary types.
      */
-    void histogramMethodMiddle(const matrix<ubyte>& src,
-                               matrix<ubyte>& dest,
-                               ivector& histogram,
-                               int& lessThanMedian,
-                               int row,
-                               int& col,
-                               ubyte& median,
-                               int sizeOfKernel) const;
-
-    /**
-     * applies the histogramMethod for the type boundary Zero
-     */
-    bool histogramMethodZero(const matrix<ubyte>& src,
-                              matrix<ubyte>& dest,
-                              int sizeOfKernel) const;
+    bool constantTimeMethod(const matrix<ubyte>& src,
+                            matrix<ubyte>& dest,
+                            int sizeOfKernel) const;
 
     /**
-     * applies the histogramMethod for the type boundary Constant
+     * Median of float data quantized to 256 levels.
+     * @see parameters::quantize
      */
-    bool histogramMethodConstant(const matrix<ubyte>& src,
-                                 matrix<ubyte>& dest,
-                                 int sizeOfKernel) const;
-
-    /**
-     * applies the histogramMethod for the type boundary Periodic
-     */
-    bool histogramMethodPeriodic(const matrix<ubyte>& src,
-                                 matrix<ubyte>& dest,
-                                 int sizeOfKernel) const;
-
-    /**
-     * applies the histogramMethod for the type boundary Mirror
-     */
-    bool histogramMethodMirror(const matrix<ubyte>& src,
-                               matrix<ubyte>& dest,
-                               int sizeOfKernel) const;
-
-    /**
-     * applies the histogramMethod for the type boundary NoBoundary
-     */
-    bool histogramMethodNoBoundary(const matrix<ubyte>& src,
-                                   matrix<ubyte>& dest,
-                                   int sizeOfKernel) const;
+    bool quantizedMethod(const fmatrix& src, fmatrix& dest) const;
 
     /**
      * the histogramMethod apply the median filter to a matrix
@@ -32,6 +32,7 @@
  */
 
 #include "ltiMergeHSIToImage.h"
+#include "ltiParallelBands.h"
 #include "ltiChannel8.h"
 #include "ltiRound.h"
 #include "ltiFactory.h"
@@ -115,6 +116,11 @@ namespace lti {
                               const matrix<float>& c2,
                               const matrix<float>& c3,
                               image& img) const {
+    parallelBands<mergeHSIToImage> bands(*this,c1.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.merge(c1,c2,c3,img);
+    }
+
     int xSize,ySize;
     ipoint p;            // coordinates
     int h;
@@ -189,6 +195,11 @@ namespace lti {
                               const matrix<ubyte>& c2,
                               const matrix<ubyte>& c3,
                               image& img) const {
+    parallelBands<mergeHSIToImage> bands(*this,c1.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.merge(c1,c2,c3,img);
+    }
+
     int xSize,ySize;
     ipoint p;            // coordinates
     int h,s,I;
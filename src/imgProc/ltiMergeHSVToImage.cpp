@@ -32,6 +32,7 @@
  */
 
 #include "ltiMergeHSVToImage.h"
+#include "ltiParallelBands.h"
 #include "ltiChannel8.h"
 #include "ltiRound.h"
 #include "ltiFactory.h"
@@ -66,6 +67,11 @@ namespace lti {
                               const matrix<float>& c2,
                               const matrix<float>& c3,
                               image& img) const {
+    parallelBands<mergeHSVToImage> bands(*this,c1.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.merge(c1,c2,c3,img);
+    }
+
     int xSize,ySize;
     ipoint p;
     int i,r,q,t,v; // auxiliary for transformation
@@ -141,6 +147,11 @@ namespace lti {
                               const matrix<ubyte>& c2,
                               const matrix<ubyte>& c3,
                               image& img) const {
+    parallelBands<mergeHSVToImage> bands(*this,c1.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.merge(c1,c2,c3,img);
+    }
+
     int xSize,ySize;
     ipoint p;
     int i,r,q,t,v;     // auxiliary for transformation
@@ -33,15 +33,81 @@
  */
 
 #include "ltiMergeImage.h"
+#include "ltiException.h"
 
 namespace lti {
 
+  // --------------------------------------------------
+  // mergeImage::parameters
+  // --------------------------------------------------
+
+  // default constructor
+  mergeImage::parameters::parameters()
+    : functor::parameters() {
+  }
+
+  // copy constructor
+  mergeImage::parameters::parameters(const parameters& other)
+    : functor::parameters() {
+    copy(other);
+  }
+
+  // destructor
+  mergeImage::parameters::~parameters() {
+  }
+
+  // copy member
+  mergeImage::parameters&
+  mergeImage::parameters::copy(const parameters& other) {
+    functor::parameters::copy(other);
+
+    return *this;
+  }
+
+  // alias for copy member
+  mergeImage::parameters&
+  mergeImage::parameters::operator=(const parameters& other) {
+    return copy(other);
+  }
+
+  // class name
+  const std::string& mergeImage::parameters::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone member
+  mergeImage::parameters* mergeImage::parameters::clone() const {
+    return new parameters(*this);
+  }
+
+  // new instance
+  mergeImage::parameters* mergeImage::parameters::newInstance() const {
+    return new parameters();
+  }
+
+  // --------------------------------------------------
+  // mergeImage
+  // --------------------------------------------------
+
   // mergeImage is the base class of all merging classes...
   mergeImage::mergeImage() : functor() {
+    parameters defaultParameters;
+    setParameters(defaultParameters);
   }
 
   mergeImage::~mergeImage() {
   }
 
+  // return parameters
+  const mergeImage::parameters&
+  mergeImage::getParameters() const {
+    const parameters* par =
+      dynamic_cast<const parameters*>(&functor::getParameters());
+    if(isNull(par)) {
+      throw invalidParametersException(name());
+    }
+    return *par;
+  }
+
 } // end of namespace
 
@@ -52,6 +52,61 @@ namespace lti {
    */
   class mergeImage : public functor {
   public:
+    /**
+     * The parameters for the class mergeImage.
+     *
+     * The color space conversions have no parameters of their own.  This
+     * class exists to provide the attributes of functor::parameters, like
+     * the number of threads used on large images.
+     */
+    class parameters : public functor::parameters {
+    public:
+      /**
+       * default constructor
+       */
+      parameters();
+
+      /**
+       * copy constructor
+       * @param other the parameters object to be copied
+       */
+      parameters(const parameters& other);
+
+      /**
+       * destructor
+       */
+      ~parameters();
+
+      /**
+       * Returns name of this type ("lti::mergeImage::parameters")
+       */
+      const std::string& name() const;
+
+      /**
+       * copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& copy(const parameters& other);
+
+      /**
+       * copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& operator=(const parameters& other);
+
+      /**
+       * returns a pointer to a clone of the parameters
+       */
+      virtual parameters* clone() const;
+
+      /**
+       * returns a pointer to a new instance of the parameters
+       */
+      virtual parameters* newInstance() const;
+    };
+
     /**
      * default constructor
      */
@@ -72,6 +127,11 @@ namespace lti {
      */
     virtual mergeImage* newInstance() const = 0;
 
+    /**
+     * Returns used parameters
+     */
+    const parameters& getParameters() const;
+
     /**
      * on-copy operator for 32-bit "floating-point" channels
      */
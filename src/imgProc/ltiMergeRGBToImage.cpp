@@ -32,6 +32,7 @@
 
 
 #include "ltiMergeRGBToImage.h"
+#include "ltiParallelBands.h"
 #include "ltiFactory.h"
 
 namespace lti {
@@ -64,6 +65,11 @@ namespace lti {
                               const matrix<float>& c2,
                               const matrix<float>& c3,
                               image& img) const {
+    parallelBands<mergeRGBToImage> bands(*this,c1.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.merge(c1,c2,c3,img);
+    }
+
     int xSize,ySize;
     ipoint p;               // coordinates
 
@@ -124,6 +130,11 @@ namespace lti {
                               const matrix<ubyte>& c2,
                               const matrix<ubyte>& c3,
                               image& img) const {
+    parallelBands<mergeRGBToImage> bands(*this,c1.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.merge(c1,c2,c3,img);
+    }
+
     int xSize,ySize;
     ipoint p;            // coordinates
 
@@ -34,6 +34,7 @@
 // merge YCbCr channels to image
 
 #include "ltiMergeYCbCrToImage.h"
+#include "ltiParallelBands.h"
 
 
 namespace lti {
@@ -91,6 +92,11 @@ namespace lti {
                                 const matrix<float>& c2,
                                 const matrix<float>& c3,
                                 image& img) const {
+    parallelBands<mergeYCbCrToImage> bands(*this,c1.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.merge(c1,c2,c3,img);
+    }
+
  
     const int xSize=c1.columns();
     const int ySize=c1.rows();
@@ -134,6 +140,11 @@ namespace lti {
                                 const matrix<ubyte>& c2,
                                 const matrix<ubyte>& c3,
                                 image& img) const {
+    parallelBands<mergeYCbCrToImage> bands(*this,c1.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.merge(c1,c2,c3,img);
+    }
+
  
     //point p;            // coordinates
     //rgbaPixel pix;       // pixel structure
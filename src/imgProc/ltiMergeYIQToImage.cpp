@@ -34,6 +34,7 @@
 
 
 #include "ltiMergeYIQToImage.h"
+#include "ltiParallelBands.h"
 #include "ltiFactory.h"
 
 namespace lti {
@@ -64,6 +65,11 @@ namespace lti {
                               const matrix<float>& c2,
                               const matrix<float>& c3,
                               image& img) const {
+    parallelBands<mergeYIQToImage> bands(*this,c1.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.merge(c1,c2,c3,img);
+    }
+
     int xSize,ySize;
     ipoint p;              // coordinates
     float Y, I, Q;
@@ -116,6 +122,11 @@ namespace lti {
                               const matrix<ubyte>& c2,
                               const matrix<ubyte>& c3,
                               image& img) const {
+    parallelBands<mergeYIQToImage> bands(*this,c1.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.merge(c1,c2,c3,img);
+    }
+
     int xSize,ySize;
     ipoint p;              // coordinates
     float Y, I, Q,r, g, b;
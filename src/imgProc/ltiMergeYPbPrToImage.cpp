@@ -34,6 +34,7 @@
 // merge YPbPr channels to image
 
 #include "ltiMergeYPbPrToImage.h"
+#include "ltiParallelBands.h"
 #include "ltiFactory.h"
 
 namespace lti {
@@ -98,6 +99,11 @@ namespace lti {
                                 const matrix<float>& c2,
                                 const matrix<float>& c3,
                                 image& img) const {
+    parallelBands<mergeYPbPrToImage> bands(*this,c1.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.merge(c1,c2,c3,img);
+    }
+
  
     const int xSize=c1.columns();
     const int ySize=c1.rows();
@@ -141,6 +147,11 @@ namespace lti {
                                 const matrix<ubyte>& c2,
                                 const matrix<ubyte>& c3,
                                 image& img) const {
+    parallelBands<mergeYPbPrToImage> bands(*this,c1.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.merge(c1,c2,c3,img);
+    }
+
  
     //point p;            // coordinates
     //rgbaPixel pix;       // pixel structure
@@ -35,6 +35,7 @@
 // merge YUV channels to image
 
 #include "ltiMergeYUVToImage.h"
+#include "ltiParallelBands.h"
 #include "ltiFactory.h"
 
 namespace lti {
@@ -87,6 +88,11 @@ namespace lti {
                               const matrix<float>& c2,
                               const matrix<float>& c3,
                               image& img) const {
+    parallelBands<mergeYUVToImage> bands(*this,c1.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.merge(c1,c2,c3,img);
+    }
+
  
     const int xSize=c1.columns();
     const int ySize=c1.rows();
@@ -130,6 +136,11 @@ namespace lti {
                               const matrix<ubyte>& c2,
                               const matrix<ubyte>& c3,
                               image& img) const {
+    parallelBands<mergeYUVToImage> bands(*this,c1.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.merge(c1,c2,c3,img);
+    }
+
  
     //point p;            // coordinates
     //rgbaPixel pix;       // pixel structure
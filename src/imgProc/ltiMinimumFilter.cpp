@@ -50,6 +50,8 @@
 #include "ltiMacroSymbols.h"
 
 #include "ltiMinimumFilter.h"
+#include "ltiParallelBands.h"
+#include "ltiSlidingExtremum.h"
 #include "ltiMinimumFilter_template.h"
 
 namespace lti {
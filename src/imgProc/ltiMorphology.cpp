@@ -265,6 +265,89 @@ namespace lti {
     setParameters(tmpParam);
   }
 
+  /*
+   * Helpers to check if all elements of a kernel are non-zero when casted
+   * to the type T
+   */
+  namespace {
+    template<typename T,typename K>
+    bool nonZero(const kernel1D<K>& kern) {
+      for (int i=kern.firstIdx();i<=kern.lastIdx();++i) {
+        if (static_cast<T>(kern.at(i)) == T(0)) {
+          return false;
+        }
+      }
+      return !kern.empty();
+    }
+
+    template<typename T,typename K>
+    bool nonZero(const kernel2D<K>& kern) {
+      for (int y=kern.firstRow();y<=kern.lastRow();++y) {
+        for (int x=kern.firstColumn();x<=kern.lastColumn();++x) {
+          if (static_cast<T>(kern.at(y,x)) == T(0)) {
+            return false;
+          }
+        }
+      }
+      return !kern.empty();
+    }
+
+    template<typename T,typename K>
+    bool flatRectangle(const container* se,irectangle& window) {
+      if (const kernel2D<K>* k2 = dynamic_cast<const kernel2D<K>*>(se)) {
+        window.set(k2->firstColumn(),k2->firstRow(),
+                   k2->lastColumn(),k2->lastRow());
+        return nonZero<T>(*k2);
+      }
+      if (const separableKernel<K>* sk =
+          dynamic_cast<const separableKernel<K>*>(se)) {
+        if (sk->getNumberOfPairs() != 1) {
+          return false;
+        }
+        const kernel1D<K>& row = sk->getRowFilter(0);
+        const kernel1D<K>& col = sk->getColFilter(0);
+        window.set(row.firstIdx(),col.firstIdx(),
+                   row.lastIdx(),col.lastIdx());
+        return nonZero<T>(row) && nonZero<T>(col);
+      }
+      return false;
+    }
+
+    template<typename T,typename K>
+    bool flatSegment(const container* se,int& first,int& last) {
+      if (const kernel1D<K>* k1 = dynamic_cast<const kernel1D<K>*>(se)) {
+        first = k1->firstIdx();
+        last  = k1->lastIdx();
+        return nonZero<T>(*k1);
+      }
+      return false;
+    }
+  }
+
+  template<typename T>
+  bool morphology::isFlatRectangle(irectangle& window) const {
+    const container* se = &getParameters().getStructuringElement();
+    return (flatRectangle<T,float>(se,window)  ||
+            flatRectangle<T,double>(se,window) ||
+            flatRectangle<T,int>(se,window)    ||
+            flatRectangle<T,ubyte>(se,window));
+  }
+
+  template<typename T>
+  bool morphology::isFlatSegment(int& first,int& last) const {
+    const container* se = &getParameters().getStructuringElement();
+    return (flatSegment<T,float>(se,first,last)  ||
+            flatSegment<T,double>(se,first,last) ||
+            flatSegment<T,int>(se,first,last)    ||
+            flatSegment<T,ubyte>(se,first,last));
+  }
+
+  // explicit instantiations for the types processed by the operators
+  template bool morphology::isFlatRectangle<float>(irectangle&) const;
+  template bool morphology::isFlatRectangle<ubyte>(irectangle&) const;
+  template bool morphology::isFlatSegment<float>(int&,int&) const;
+  template bool morphology::isFlatSegment<ubyte>(int&,int&) const;
+
   // read function for eMorphologyMode.
   bool read(ioHandler& handler,morphology::eMorphologyMode& data) {
 
@@ -55,6 +55,7 @@
 #include "ltiContainer.h"
 #include "ltiMatrixProcessingInterface.h"
 #include "ltiBoundaryType.h"
+#include "ltiRectangle.h"
 #include "ltiTypes.h"
 #include "ltiMatrix.h"
 #include "ltiFunctor.h"
@@ -341,6 +342,38 @@ namespace lti {
      * The other parameters remain unchanged.
      */
     void setStructuringElement(const container& se);
+
+  protected:
+    /**
+     * Check if the structuring element is a flat rectangle, i.e. a kernel2D
+     * without zero elements or a separableKernel with just one pair of
+     * such filters (like lti::squareKernel and lti::rectangularKernel).
+     * The elements are checked after casting them to the type T of the
+     * processed data, as done by the convolution helpers.
+     *
+     * The GrayFlat operators of such elements are computed with the van
+     * Herk/Gil-Werman algorithm (see lti::internal::slidingExtremum), which
+     * needs a constant number of comparisons per element regardless of the
+     * size of the structuring element.  The NoBoundary type keeps using
+     * the convolution helpers.
+     *
+     * @param window the indices of the structuring element
+     * @return true if the structuring element is a flat rectangle
+     */
+    template<typename T>
+    bool isFlatRectangle(irectangle& window) const;
+
+    /**
+     * Check if the structuring element is a kernel1D without zero elements
+     * (after casting them to T).  This is the one-dimensional counterpart of
+     * isFlatRectangle().
+     *
+     * @param first the first index of the structuring element
+     * @param last the last index of the structuring element
+     * @return true if the structuring element is a flat kernel1D
+     */
+    template<typename T>
+    bool isFlatSegment(int& first,int& last) const;
   };
 
   /**
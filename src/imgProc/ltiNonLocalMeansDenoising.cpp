@@ -36,6 +36,7 @@
 #include "ltiGaussKernels.h"
 #include "ltiKernel2D.h"
 #include "ltiBoundaryExpansion.h"
+#include "ltiParallelBands.h"
 #include "ltiMath.h"
 
 namespace lti {
@@ -52,6 +53,8 @@ namespace lti {
     variance = 5.0;
     filterDegree = 0.006f;
     boundaryType = Mirror;
+    gaussianWindow = true;
+    algorithm = Fast;
   }
 
   // copy constructor
@@ -74,6 +77,8 @@ namespace lti {
     subregionSize = other.subregionSize;
     variance = other.variance;
     filterDegree = other.filterDegree;
+    gaussianWindow = other.gaussianWindow;
+    algorithm = other.algorithm;
 
     return *this;
   }
@@ -120,6 +125,8 @@ namespace lti {
       lti::write(handler,"subregionSize",subregionSize);
       lti::write(handler,"variance",variance);
       lti::write(handler,"filterDegree",filterDegree);
+      lti::write(handler,"gaussianWindow",gaussianWindow);
+      lti::write(handler,"algorithm",algorithm);
     }
 
     b = b && denoising::parameters::write(handler,false);
@@ -151,6 +158,8 @@ namespace lti {
       lti::read(handler,"subregionSize",subregionSize);
       lti::read(handler,"variance",variance);
       lti::read(handler,"filterDegree",filterDegree);
+      lti::read(handler,"gaussianWindow",gaussianWindow);
+      lti::read(handler,"algorithm",algorithm);
     }
 
     b = b && denoising::parameters::read(handler,false);
@@ -281,6 +290,9 @@ namespace lti {
     gaussKernel2D<float> gauss(sizeOfWindow,variance);
     kernel2D<float>      kern;
     kern.castFrom(gauss);
+    if (!param.gaussianWindow) {
+      kern.fill(1.0f/(sizeOfWindow*sizeOfWindow));
+    }
 
     // need kernel as matrix
     //const matrix<float>& filter = kern;
@@ -438,6 +450,218 @@ namespace lti {
     return true;
   }
 
+  // Apply the NL-means algorithm processing one offset at a time
+  bool nonLocalMeansDenoising::denoiseFast(const channel& src,
+                                           channel& dest) const {
+
+    if (src.empty()) {
+      dest.clear();
+      return true;
+    }
+
+    // get parameters
+    const parameters& param = getParameters();
+    const float filterDegree = param.filterDegree;
+
+    // the same (odd) sizes used by the direct algorithm
+    const int subregionSize = param.subregionSize +
+      ((param.subregionSize%2 == 0) ? 1:0);
+    const int halfSubregion = subregionSize/2;
+
+    const int sizeOfWindow = param.windowSize +
+      ((param.windowSize%2 == 0) ? 1:0);
+    const int halfWindow = sizeOfWindow/2;
+
+    // The 2D kernel of the direct algorithm is the outer product of a 1D
+    // kernel with itself, so that the weighted sum of the squared
+    // differences in a window can be computed with a horizontal and a
+    // vertical pass.
+    fvector weights(sizeOfWindow);
+    if (param.gaussianWindow) {
+      gaussKernel1D<float> gauss(sizeOfWindow,param.variance);
+      for (int k=0;k<sizeOfWindow;++k) {
+        weights.at(k)=gauss.at(k-halfWindow);
+      }
+    }
+
+    channel srcExp;  // src with boundary expanded
+    boundaryExpansion expander(halfWindow,param.boundaryType,false);
+    if (!expander.apply(src,srcExp)) {
+      setStatusString(expander.getStatusString());
+      return false;
+    }
+
+    const int rows = src.rows();
+    const int cols = src.columns();
+
+    // accumulators of the direct algorithm for each pixel
+    fmatrix average(rows,cols,0.0f);
+    fmatrix totalWeight(rows,cols,0.0f);
+    fmatrix weightMax(rows,cols,0.0f);
+
+    // The rows are processed in blocks, so that the intermediate results
+    // of all offsets stay in the cache.
+    static const int blockRows = 32;
+    fmatrix sqrDiff(blockRows+2*halfWindow,cols+2*halfWindow);
+    fmatrix hsum;   // horizontal pass (gaussian window)
+    dmatrix hbox;   // horizontal pass (uniform window)
+    dvector vbox;   // vertical running sums (uniform window)
+    if (param.gaussianWindow) {
+      hsum.allocate(blockRows+2*halfWindow,cols);
+    } else {
+      hbox.allocate(blockRows+2*halfWindow,cols);
+      vbox.allocate(cols);
+    }
+    fvector dist(cols);
+    const double boxNorm = 1.0/(sizeOfWindow*sizeOfWindow);
+
+    int i,j,k;
+    for (int by=0;by<rows;by+=blockRows) {
+      const int byEnd = min(rows,by+blockRows);
+
+      // the offsets in the same order as the direct algorithm visits them,
+      // so that the accumulated values are the same
+      for (int dy=-halfSubregion;dy<halfSubregion;++dy) {
+        // rows of the block with the offset row inside the image
+        const int y0 = max(by,-dy);
+        const int y1 = min(byEnd,rows-dy);
+        if (y0 >= y1) {
+          continue;
+        }
+        const int outRows = y1-y0;
+        const int diffRows = outRows+2*halfWindow;
+
+        for (int dx=-halfSubregion;dx<halfSubregion;++dx) {
+          if ((dx == 0) && (dy == 0)) {
+            continue;
+          }
+
+          const int x0 = max(0,-dx);
+          const int x1 = min(cols,cols-dx);
+          if (x0 >= x1) {
+            continue;
+          }
+          const int outCols = x1-x0;
+          const int diffCols = outCols+2*halfWindow;
+
+          // squared differences between the image and its shifted version,
+          // in the coordinates of the expanded image
+          for (i=0;i<diffRows;++i) {
+            const float* a = &srcExp.at(y0+i,x0);
+            const float* b = &srcExp.at(y0+i+dy,x0+dx);
+            float* d = &sqrDiff.at(i,0);
+            for (j=0;j<diffCols;++j) {
+              d[j] = sqr(a[j]-b[j]);
+            }
+          }
+
+          if (param.gaussianWindow) {
+            // horizontal pass
+            for (i=0;i<diffRows;++i) {
+              const float* d = &sqrDiff.at(i,0);
+              float* h = &hsum.at(i,0);
+              for (j=0;j<outCols;++j) {
+                h[j] = weights.at(0)*d[j];
+              }
+              for (k=1;k<sizeOfWindow;++k) {
+                const float w = weights.at(k);
+                const float* dk = d+k;
+                for (j=0;j<outCols;++j) {
+                  h[j] += w*dk[j];
+                }
+              }
+            }
+          } else {
+            // horizontal running sums
+            for (i=0;i<diffRows;++i) {
+              const float* d = &sqrDiff.at(i,0);
+              double* h = &hbox.at(i,0);
+              double acc = 0.0;
+              for (k=0;k<sizeOfWindow;++k) {
+                acc += d[k];
+              }
+              h[0] = acc;
+              for (j=1;j<outCols;++j) {
+                acc += d[j+sizeOfWindow-1];
+                acc -= d[j-1];
+                h[j] = acc;
+              }
+            }
+            for (j=0;j<outCols;++j) {
+              vbox.at(j) = 0.0;
+            }
+            for (k=0;k<sizeOfWindow-1;++k) {
+              const double* h = &hbox.at(k,0);
+              for (j=0;j<outCols;++j) {
+                vbox.at(j) += h[j];
+              }
+            }
+          }
+
+          for (i=0;i<outRows;++i) {
+            // vertical pass: window distance of each pixel in the row
+            if (param.gaussianWindow) {
+              const float* h = &hsum.at(i,0);
+              float* d = &dist.at(0);
+              for (j=0;j<outCols;++j) {
+                d[j] = weights.at(0)*h[j];
+              }
+              for (k=1;k<sizeOfWindow;++k) {
+                const float w = weights.at(k);
+                h = &hsum.at(i+k,0);
+                for (j=0;j<outCols;++j) {
+                  d[j] += w*h[j];
+                }
+              }
+            } else {
+              const double* add = &hbox.at(i+sizeOfWindow-1,0);
+              for (j=0;j<outCols;++j) {
+                vbox.at(j) += add[j];
+                dist.at(j) = static_cast<float>(vbox.at(j)*boxNorm);
+              }
+              const double* sub = &hbox.at(i,0);
+              for (j=0;j<outCols;++j) {
+                vbox.at(j) -= sub[j];
+              }
+            }
+
+            // accumulate the weights of the window pairs
+            const int y = y0+i;
+            const float* q = &srcExp.at(y+dy+halfWindow,x0+dx+halfWindow);
+            float* avg = &average.at(y,x0);
+            float* tw  = &totalWeight.at(y,x0);
+            float* wm  = &weightMax.at(y,x0);
+            for (j=0;j<outCols;++j) {
+              const float weight = exp(-dist.at(j)/filterDegree);
+              if (weight>wm[j]) {
+                wm[j] = weight;
+              }
+              tw[j] += weight;
+              avg[j] += weight*q[j];
+            }
+          }
+        }
+      }
+    }
+
+    // the pixel itself gets the largest weight of all other ones
+    dest.allocate(rows,cols);
+    for (i=0;i<rows;++i) {
+      for (j=0;j<cols;++j) {
+        const float wm = weightMax.at(i,j);
+        const float tw = totalWeight.at(i,j) + wm;
+        const float p  = src.at(i,j);
+        if (tw>0.0f) { // to prevent the zero division
+          dest.at(i,j) = (average.at(i,j) + wm*p)/tw;
+        } else {
+          dest.at(i,j) = p;
+        }
+      }
+    }
+
+    return true;
+  }
+
   // On place apply for type channel!
   bool nonLocalMeansDenoising::apply(channel& srcdest) const {
 
@@ -463,7 +687,27 @@ namespace lti {
   // Denoise src with the NL-means and gives the result to dest for type
   // channel!
   bool nonLocalMeansDenoising::apply(const channel& src, channel& dest) const {
-    return denoise(src,dest);
+    const parameters& param = getParameters();
+
+    if (src.empty()) {
+      dest.clear();
+      return true;
+    }
+
+    // each row depends on the rows of the search subregion and on their
+    // similarity windows.  A periodic boundary requires the whole data.
+    const int halo = (param.subregionSize/2) + (param.windowSize/2);
+    parallelBands<nonLocalMeansDenoising>
+      bands(*this,src.size(),(param.boundaryType == Periodic) ?
+                             src.rows() : halo);
+    if (bands.getNumberOfBands() > 1) {
+      return bands.apply(src,dest);
+    }
+
+    if (param.algorithm == Direct) {
+      return denoise(src,dest);
+    }
+    return denoiseFast(src,dest);
   }
 
   // Denoise src with the NL-means and gives the result to dest for type
@@ -472,11 +716,57 @@ namespace lti {
     
     channel srcTmp, destTmp;
     srcTmp.castFrom(src);
-    if (denoise(srcTmp,destTmp)) {
+    if (apply(srcTmp,destTmp)) {
       dest.castFrom(destTmp);
       return true;
     }
     return false;
   }
-}
 
+  /*
+   * Read a nonLocalMeansDenoising::eAlgorithm
+   */
+  bool read(ioHandler& handler,
+            nonLocalMeansDenoising::eAlgorithm& data) {
+    std::string str;
+
+    if (handler.read(str)) {
+      if (str.find("irect") != std::string::npos) {
+        data = nonLocalMeansDenoising::Direct;
+      } else if (str.find("ast") != std::string::npos) {
+        data = nonLocalMeansDenoising::Fast;
+      } else {
+        data = nonLocalMeansDenoising::Fast;
+        handler.setStatusString("Unknown nonLocalMeansDenoising::eAlgorithm");
+        return false;
+      }
+
+      return true;
+    }
+
+    return false;
+  }
+
+  /*
+   * Write a nonLocalMeansDenoising::eAlgorithm
+   */
+  bool write(ioHandler& handler,
+             const nonLocalMeansDenoising::eAlgorithm& data) {
+    bool b = false;
+    switch(data) {
+      case nonLocalMeansDenoising::Direct:
+        b = handler.write("Direct");
+        break;
+      case nonLocalMeansDenoising::Fast:
+        b = handler.write("Fast");
+        break;
+      default:
+        handler.write("Unknown");
+        b = false;
+        handler.setStatusString("Undefined nonLocalMeansDenoising::eAlgorithm");
+        break;
+    }
+
+    return b;
+  }
+}
@@ -79,12 +79,36 @@ namespace lti {
    * of the exponential function and therefore the decay of the weights as a
    * function of the Euclidean distances.
    *
+   * Two implementations of the same estimator are provided (see
+   * parameters::algorithm).  The Direct one computes the distance of each
+   * pair of windows separately, with a cost proportional to the number of
+   * pixels, times the size of the search subregion, times the size of the
+   * similarity window.  The Fast one processes the image once per offset
+   * within the search subregion: the squared differences between the
+   * image and its shifted version are filtered with the (separable)
+   * window weights, so that the cost of each window distance is
+   * proportional to the window width, or even constant for uniform
+   * windows, which are then computed like with integral images.  Both
+   * produce the same results up to floating point rounding.
+   *
+   * The image is split into bands of rows processed in parallel according
+   * to the parameter numberOfThreads.  The result does not depend on the
+   * number of threads.
+   *
    * @see nonLocalMeansDenoising::parameters.
    *
    * @ingroup gDenoising
    */
   class nonLocalMeansDenoising : public denoising {
   public:
+    /**
+     * Implementations of the non-local means
+     */
+    enum eAlgorithm {
+      Direct, /**< Compute each window distance separately */
+      Fast    /**< Compute the window distances of each offset at once */
+    };
+
     /**
      * The parameters for the class nonLocalMeansDenoising
      */
@@ -192,6 +216,29 @@ namespace lti {
        * Default value: 0.006f
        */
       float filterDegree;
+
+      /**
+       * Weighting of the pixels in the similarity window.
+       *
+       * If true, the squared differences of the pixels are weighted with a
+       * gaussian kernel of the given \a variance.  If false, all pixels in
+       * the window have the same weight, which makes the Fast algorithm
+       * considerably faster.
+       *
+       * Default value: true
+       */
+      bool gaussianWindow;
+
+      /**
+       * Implementation to be used.
+       *
+       * Both implementations compute the same result, but the Fast one is
+       * orders of magnitude faster for the usual window sizes.  Direct is
+       * kept as reference.
+       *
+       * Default value: Fast
+       */
+      eAlgorithm algorithm;
     };
 
     /**
@@ -291,7 +338,32 @@ namespace lti {
      */
     bool denoise(const channel& src, channel& dest) const;
 
+    /**
+     * This method implements the non-local means processing all pixels for
+     * one offset at a time (the Fast algorithm).
+     *
+     * @param src the input image, to be denoise.
+     * @param dest the output image, denoise.
+     * @return true if successful, false otherwise.
+     */
+    bool denoiseFast(const channel& src, channel& dest) const;
   };
+
+  /**
+   * Read a nonLocalMeansDenoising::eAlgorithm
+   *
+   * @ingroup gStorable
+   */
+  bool read(ioHandler& handler,
+            nonLocalMeansDenoising::eAlgorithm& data);
+
+  /**
+   * Write a nonLocalMeansDenoising::eAlgorithm
+   *
+   * @ingroup gStorable
+   */
+  bool write(ioHandler& handler,
+             const nonLocalMeansDenoising::eAlgorithm& data);
 }
 
 #endif
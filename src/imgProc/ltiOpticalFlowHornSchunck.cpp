@@ -52,6 +52,11 @@
 #include "ltiOpticalFlowHornSchunck.h"
 //#include "ltiLaplacianKernel.h"
 #include "ltiGaussKernels.h"
+#include "ltiGaussianPyramid.h"
+#include "ltiDownsampling.h"
+#include "ltiParallelBands.h"
+#include "ltiThreadPool.h"
+#include <cmath>
 
 #undef _LTI_DEBUG
 //#define _LTI_DEBUG 1
@@ -81,6 +86,11 @@ namespace lti {
     variance = float(1.3);
     gradient.format = lti::gradientFunctor::Cartesian;
     gradient.kernelType = lti::gradientFunctor::Ando;
+    solver = Jacobi;
+    relaxation = 1.5f;
+    multigridLevels = 4;
+    smoothingSteps = 2;
+    residualThreshold = 0.0f;
   }
 
   // copy constructor
@@ -105,6 +115,11 @@ namespace lti {
     maxError = other.maxError;
     variance = other.variance;
     gradient   = other.gradient;
+    solver = other.solver;
+    relaxation = other.relaxation;
+    multigridLevels = other.multigridLevels;
+    smoothingSteps = other.smoothingSteps;
+    residualThreshold = other.residualThreshold;
 
     return *this;
   }
@@ -154,6 +169,11 @@ namespace lti {
       lti::write(handler,"maxError",maxError);
       lti::write(handler,"variance",variance);
       lti::write(handler,"gradient",gradient);
+      lti::write(handler,"solver",solver);
+      lti::write(handler,"relaxation",relaxation);
+      lti::write(handler,"multigridLevels",multigridLevels);
+      lti::write(handler,"smoothingSteps",smoothingSteps);
+      lti::write(handler,"residualThreshold",residualThreshold);
     }
 
     b = b && opticalFlow::parameters::write(handler,false);
@@ -187,6 +207,11 @@ namespace lti {
       lti::read(handler,"maxError",maxError);
       lti::read(handler,"variance",variance);
       lti::read(handler,"gradient",gradient);
+      lti::read(handler,"solver",solver);
+      lti::read(handler,"relaxation",relaxation);
+      lti::read(handler,"multigridLevels",multigridLevels);
+      lti::read(handler,"smoothingSteps",smoothingSteps);
+      lti::read(handler,"residualThreshold",residualThreshold);
     }
 
     b = b && opticalFlow::parameters::read(handler,false);
@@ -342,7 +367,7 @@ namespace lti {
         const float fit = itrow.at(j);
         const float fu_ = u_row.at(j);
         const float fv_ = v_row.at(j);
-        const float a =(fix*fu_+fiy*fv_+fit)/(lambda+fix*fix+fiy*fiy);
+        const float a =(fit-fix*fu_-fiy*fv_)/(lambda+fix*fix+fiy*fiy);
         urow.at(j)=fu_+fix*a;
         vrow.at(j)=fv_+fiy*a;
       }
@@ -381,12 +406,29 @@ namespace lti {
                                            const channel& next,
                                            channel& u,
                                            channel& v) {
+    // computation of space gradient and time derivative
+    channel ix,iy,it;
+    grad_.apply(next,ix,iy);
+    it.subtract(last,next);
+
+    if (getParameters().solver == Jacobi) {
+      return solveJacobi(ix,iy,it,u,v);
+    }
+    return solveRedBlack(ix,iy,it,u,v);
+  }
+
+  bool opticalFlowHornSchunck::solveJacobi(const channel& ix,
+                                           const channel& iy,
+                                           const channel& it,
+                                           channel& u,
+                                           channel& v) {
     const parameters& par = getParameters();
-    const int rows=next.rows();
-    const int cols=next.columns();
+    const int rows=ix.rows();
+    const int cols=ix.columns();
     const int maxIt=par.maxIterations;
     const float maxE=par.maxError;
     const float lambda=par.lambda;
+    const bool checkResidual = (par.residualThreshold > 0.0f);
     float error=maxE;
     float eu,ev;
     int k=0;
@@ -398,17 +440,28 @@ namespace lti {
     static viewer2D view2("IntegralImage2::debug");
 #endif
 
-    // computation of space gradient and time derivative
-    channel ix,iy,it;
-    grad_.apply(next,ix,iy);
-    it.subtract(last,next);
-    
     // creation of filter to compute the velocity average 
     gaussKernel2D<channel::value_type> gaussKernel(par.kernelSize,par.variance);
-    convolution filter(gaussKernel);
+    convolution::parameters filterPar;
+    filterPar.setKernel(gaussKernel);
+    filterPar.boundaryType = lti::Zero;
+    filterPar.numberOfThreads = par.numberOfThreads;
+    convolution filter(filterPar);
     
     u.assign(rows,cols,0);
     v.assign(rows,cols,0);
+
+    // norm of the right hand side, for the residual criterion
+    double bnorm = 0.0;
+    if (checkResidual) {
+      for (int i=0;i<rows;++i) {
+        for (int j=0;j<cols;++j) {
+          const double fit = it.at(i,j);
+          bnorm += fit*fit*(ix.at(i,j)*ix.at(i,j) + iy.at(i,j)*iy.at(i,j));
+        }
+      }
+      bnorm = sqrt(bnorm);
+    }
     
     while (error>=maxE && k<maxIt) {
       error=0;
@@ -419,6 +472,9 @@ namespace lti {
       _lti_if_debug(canvas.copy(u_));
       _lti_if_debug(view.show(canvas));
 
+      // residual of the flow before this iteration
+      double rnorm = 0.0;
+
       for(int i=0;i<rows;++i){
         // get each row to avoid unnecessary repeated row accesses
         const vector<float>& ixrow = ix.getRow(i);
@@ -439,7 +495,15 @@ namespace lti {
           const float fv_ = v_row.at(j);
           const float fuant = urow.at(j);
           const float fvant = vrow.at(j);
-          const float a =(fix*fu_+fiy*fv_+fit)/(lambda+fix*fix+fiy*fiy);
+
+          if (checkResidual) {
+            const float d = fit - fix*fuant - fiy*fvant;
+            const double ru = fix*d - lambda*(fuant-fu_);
+            const double rv = fiy*d - lambda*(fvant-fv_);
+            rnorm += ru*ru + rv*rv;
+          }
+
+          const float a =(fit-fix*fu_-fiy*fv_)/(lambda+fix*fix+fiy*fiy);
           urow.at(j)=fu_+fix*a;
           vrow.at(j)=fv_+fiy*a;
           const float fu = urow.at(j);
@@ -462,8 +526,394 @@ namespace lti {
           _lti_showVar(fv_);
         }
       } 
+
+      if (checkResidual &&
+          (sqrt(rnorm) <= par.residualThreshold*bnorm)) {
+        break;
+      }
+    }
+
+    return true;
+  }
+
+  namespace internal {
+    /*
+     * One grid of the linear system of Horn and Schunck:
+     *
+     * (Jxx + k*n)*u + Jxy*v - k*sum(u of neighbours) = bu
+     * Jxy*u + (Jyy + k*n)*v - k*sum(v of neighbours) = bv
+     *
+     * with n the number of neighbours of each pixel (less than four at the
+     * borders) and k the weight of the smoothness term.
+     */
+    struct hornSchunckGrid {
+      channel jxx,jxy,jyy; // data term
+      channel bu,bv;       // right hand side
+      channel u,v;         // solution
+      channel ru,rv;       // residual
+      dvector norms;       // squared norm of the residual of each row
+      float kappa;         // weight of the smoothness term
+    };
+
+    /*
+     * Gauss-Seidel update (relaxed with omega) of the pixels of the given
+     * color in the rows from to to-1.  The pixel (i,j) has the color
+     * (i+j)%2 and its neighbours the other one, so all pixels of one color
+     * can be updated in any order.
+     */
+    void hornSchunckSweep(hornSchunckGrid& g,
+                          const int color,
+                          const float omega,
+                          const int from,
+                          const int to) {
+      const int rows = g.u.rows();
+      const int lastCol = g.u.lastColumn();
+      const float kappa = g.kappa;
+
+      for (int i=from;i<to;++i) {
+        float* const ur = g.u[i].data();
+        float* const vr = g.v[i].data();
+        const float* const uup = (i > 0) ? g.u[i-1].data() : 0;
+        const float* const vup = (i > 0) ? g.v[i-1].data() : 0;
+        const float* const udn = (i+1 < rows) ? g.u[i+1].data() : 0;
+        const float* const vdn = (i+1 < rows) ? g.v[i+1].data() : 0;
+        const float* const xx = g.jxx[i].data();
+        const float* const xy = g.jxy[i].data();
+        const float* const yy = g.jyy[i].data();
+        const float* const bu = g.bu[i].data();
+        const float* const bv = g.bv[i].data();
+        const int nv = ((uup != 0) ? 1 : 0) + ((udn != 0) ? 1 : 0);
+
+        for (int j=(i+color)&1;j<=lastCol;j+=2) {
+          float su = 0.0f;
+          float sv = 0.0f;
+          int n = nv;
+          if (uup != 0) {
+            su += uup[j];
+            sv += vup[j];
+          }
+          if (udn != 0) {
+            su += udn[j];
+            sv += vdn[j];
+          }
+          if (j > 0) {
+            su += ur[j-1];
+            sv += vr[j-1];
+            ++n;
+          }
+          if (j < lastCol) {
+            su += ur[j+1];
+            sv += vr[j+1];
+            ++n;
+          }
+
+          // solve the 2x2 system of the pixel
+          const float kn = kappa*n;
+          const float a = xx[j]+kn;
+          const float b = xy[j];
+          const float c = yy[j]+kn;
+          const float det = a*c-b*b;
+          if (det > 0.0f) {
+            const float pu = bu[j]+kappa*su;
+            const float pv = bv[j]+kappa*sv;
+            ur[j] += omega*((c*pu-b*pv)/det - ur[j]);
+            vr[j] += omega*((a*pv-b*pu)/det - vr[j]);
+          }
+        }
+      }
+    }
+
+    /*
+     * Residual of the rows from to to-1, and its squared norm in g.norms
+     */
+    void hornSchunckResidual(hornSchunckGrid& g,
+                             const int from,
+                             const int to) {
+      const int rows = g.u.rows();
+      const int lastCol = g.u.lastColumn();
+      const float kappa = g.kappa;
+
+      for (int i=from;i<to;++i) {
+        const float* const ur = g.u[i].data();
+        const float* const vr = g.v[i].data();
+        const float* const uup = (i > 0) ? g.u[i-1].data() : 0;
+        const float* const vup = (i > 0) ? g.v[i-1].data() : 0;
+        const float* const udn = (i+1 < rows) ? g.u[i+1].data() : 0;
+        const float* const vdn = (i+1 < rows) ? g.v[i+1].data() : 0;
+        const float* const xx = g.jxx[i].data();
+        const float* const xy = g.jxy[i].data();
+        const float* const yy = g.jyy[i].data();
+        const float* const bu = g.bu[i].data();
+        const float* const bv = g.bv[i].data();
+        float* const ru = g.ru[i].data();
+        float* const rv = g.rv[i].data();
+
+        double norm = 0.0;
+        for (int j=0;j<=lastCol;++j) {
+          // kappa times the negative Laplacian
+          float lu = 0.0f;
+          float lv = 0.0f;
+          if (uup != 0) {
+            lu += ur[j]-uup[j];
+            lv += vr[j]-vup[j];
+          }
+          if (udn != 0) {
+            lu += ur[j]-udn[j];
+            lv += vr[j]-vdn[j];
+          }
+          if (j > 0) {
+            lu += ur[j]-ur[j-1];
+            lv += vr[j]-vr[j-1];
+          }
+          if (j < lastCol) {
+            lu += ur[j]-ur[j+1];
+            lv += vr[j]-vr[j+1];
+          }
+
+          ru[j] = bu[j] - xx[j]*ur[j] - xy[j]*vr[j] - kappa*lu;
+          rv[j] = bv[j] - xy[j]*ur[j] - yy[j]*vr[j] - kappa*lv;
+          norm += static_cast<double>(ru[j])*ru[j] +
+                  static_cast<double>(rv[j])*rv[j];
+        }
+        g.norms.at(i) = norm;
+      }
+    }
+
+    /*
+     * Job running a sweep or the residual computation on bands of rows.
+     */
+    class hornSchunckJob : public threadPool::job {
+    public:
+      /*
+       * Constructor.  A negative color computes the residual.
+       */
+      hornSchunckJob(hornSchunckGrid& grid,
+                     const bandPartition& bands,
+                     const int color,
+                     const float omega)
+        : grid_(grid),bands_(bands),color_(color),omega_(omega) {
+      }
+
+      /*
+       * Process one band
+       */
+      virtual void execute(const int task) {
+        const bandPartition::band& b = bands_.getBand(task);
+        if (color_ < 0) {
+          hornSchunckResidual(grid_,b.from,b.to);
+        } else {
+          hornSchunckSweep(grid_,color_,omega_,b.from,b.to);
+        }
+      }
+
+    private:
+      hornSchunckGrid& grid_;
+      const bandPartition& bands_;
+      const int color_;
+      const float omega_;
+    };
+
+    /*
+     * Run the job with the given color on all bands
+     */
+    void hornSchunckRun(hornSchunckGrid& grid,
+                        const int numberOfThreads,
+                        const int color,
+                        const float omega) {
+      const bandPartition bands(numberOfThreads,grid.u.size(),1);
+      hornSchunckJob job(grid,bands,color,omega);
+      const int numBands = bands.getNumberOfBands();
+      if (numBands > 1) {
+        threadPool::getShared().run(job,numBands,numBands);
+      } else {
+        job.execute(0);
+      }
+    }
+
+    /*
+     * One red-black sweep
+     */
+    inline void hornSchunckSweep(hornSchunckGrid& grid,
+                                 const int numberOfThreads,
+                                 const float omega) {
+      hornSchunckRun(grid,numberOfThreads,0,omega);
+      hornSchunckRun(grid,numberOfThreads,1,omega);
+    }
+
+    /*
+     * Compute the residual and return the squared norm.  The sum is done
+     * always in the same order, independently of the bands.
+     */
+    double hornSchunckResidual(hornSchunckGrid& grid,
+                               const int numberOfThreads) {
+      grid.ru.allocate(grid.u.size());
+      grid.rv.allocate(grid.u.size());
+      grid.norms.allocate(grid.u.rows());
+      hornSchunckRun(grid,numberOfThreads,-1,1.0f);
+      return grid.norms.computeSumOfElements();
+    }
+
+    /*
+     * Add the bilinear interpolation of the coarse correction to the fine
+     * solution.  The pixel (i,j) of the coarse grid lies on the pixel
+     * (2i,2j) of the fine one.
+     */
+    void hornSchunckProlongate(const channel& coarse,channel& fine) {
+      const int lastRow = coarse.lastRow();
+      const int lastCol = coarse.lastColumn();
+      for (int i=0;i<fine.rows();++i) {
+        const int i0 = i/2;
+        const int i1 = (i & 1) ? min(i0+1,lastRow) : i0;
+        const float* const r0 = coarse[i0].data();
+        const float* const r1 = coarse[i1].data();
+        float* const f = fine[i].data();
+        for (int j=0;j<fine.columns();++j) {
+          const int j0 = j/2;
+          const int j1 = (j & 1) ? min(j0+1,lastCol) : j0;
+          f[j] += 0.25f*(r0[j0]+r0[j1]+r1[j0]+r1[j1]);
+        }
+      }
+    }
+
+    /*
+     * Multigrid V-cycle starting at the given grid
+     */
+    void hornSchunckCycle(std::vector<hornSchunckGrid>& grids,
+                          const int level,
+                          const int steps,
+                          const int numberOfThreads,
+                          const downsampling& restriction) {
+      hornSchunckGrid& g = grids[level];
+
+      if (level+1 == static_cast<int>(grids.size())) {
+        // the coarsest grid is small: just smooth it much more
+        for (int k=0;k<8*steps;++k) {
+          hornSchunckSweep(g,numberOfThreads,1.0f);
+        }
+        return;
+      }
+
+      for (int k=0;k<steps;++k) {
+        hornSchunckSweep(g,numberOfThreads,1.0f);
+      }
+
+      // coarse grid correction
+      hornSchunckResidual(g,numberOfThreads);
+      hornSchunckGrid& c = grids[level+1];
+      restriction.apply(g.ru,c.bu);
+      restriction.apply(g.rv,c.bv);
+      c.u.assign(c.bu.size(),0.0f);
+      c.v.assign(c.bv.size(),0.0f);
+      hornSchunckCycle(grids,level+1,steps,numberOfThreads,restriction);
+      hornSchunckProlongate(c.u,g.u);
+      hornSchunckProlongate(c.v,g.v);
+
+      for (int k=0;k<steps;++k) {
+        hornSchunckSweep(g,numberOfThreads,1.0f);
+      }
+    }
+  }
+
+  bool opticalFlowHornSchunck::solveRedBlack(const channel& ix,
+                                             const channel& iy,
+                                             const channel& it,
+                                             channel& u,
+                                             channel& v) {
+    const parameters& par = getParameters();
+    const int rows = ix.rows();
+    const int cols = ix.columns();
+    const int threads = par.numberOfThreads;
+    const bool checkResidual = (par.residualThreshold > 0.0f);
+
+    // number of grids, none of them smaller than 8x8
+    int levels = 1;
+    if (par.solver == Multigrid) {
+      ipoint size(cols,rows);
+      while ((levels < par.multigridLevels) &&
+             ((size.x+1)/2 >= 8) && ((size.y+1)/2 >= 8)) {
+        size.x = (size.x+1)/2;
+        size.y = (size.y+1)/2;
+        ++levels;
+      }
+    }
+
+    std::vector<internal::hornSchunckGrid> grids(levels);
+    internal::hornSchunckGrid& g = grids[0];
+    g.kappa = 0.25f*par.lambda;
+    g.jxx.allocate(rows,cols);
+    g.jxy.allocate(rows,cols);
+    g.jyy.allocate(rows,cols);
+    g.bu.allocate(rows,cols);
+    g.bv.allocate(rows,cols);
+    double bnorm = 0.0;
+    for (int i=0;i<rows;++i) {
+      const float* const xr = ix[i].data();
+      const float* const yr = iy[i].data();
+      const float* const tr = it[i].data();
+      for (int j=0;j<cols;++j) {
+        g.jxx.at(i,j) = xr[j]*xr[j];
+        g.jxy.at(i,j) = xr[j]*yr[j];
+        g.jyy.at(i,j) = yr[j]*yr[j];
+        g.bu.at(i,j) = xr[j]*tr[j];
+        g.bv.at(i,j) = yr[j]*tr[j];
+        bnorm += static_cast<double>(g.bu.at(i,j))*g.bu.at(i,j) +
+                 static_cast<double>(g.bv.at(i,j))*g.bv.at(i,j);
+      }
+    }
+    g.u.assign(rows,cols,0.0f);
+    g.v.assign(rows,cols,0.0f);
+
+    downsampling restriction;
+    if (levels > 1) {
+      // data terms of the coarse grids
+      gaussianPyramid<channel> pxx(levels),pxy(levels),pyy(levels);
+      pxx.setNumberOfThreads(threads);
+      pxy.setNumberOfThreads(threads);
+      pyy.setNumberOfThreads(threads);
+      pxx.generate(g.jxx);
+      pxy.generate(g.jxy);
+      pyy.generate(g.jyy);
+      for (int l=1;l<levels;++l) {
+        grids[l].kappa = 0.25f*grids[l-1].kappa;
+        grids[l].jxx.swap(pxx.at(l));
+        grids[l].jxy.swap(pxy.at(l));
+        grids[l].jyy.swap(pyy.at(l));
+      }
+
+      // the residuals are restricted as the pyramid levels are generated
+      int kernelSize;
+      double kernelVariance;
+      bool gaussian;
+      pxx.getKernelParameters(kernelSize,kernelVariance,gaussian);
+      downsampling::parameters dPar;
+      dPar.setKernel(gaussKernel2D<float>(kernelSize,kernelVariance));
+      dPar.boundaryType = lti::Constant;
+      dPar.factor = ipoint(2,2);
+      restriction.setParameters(dPar);
+    }
+
+    if (bnorm > 0.0) {
+      const double threshold = checkResidual ?
+        par.residualThreshold*par.residualThreshold*bnorm : 0.0;
+
+      for (int k=0;k<par.maxIterations;++k) {
+        if (par.solver == Multigrid) {
+          internal::hornSchunckCycle(grids,0,max(1,par.smoothingSteps),
+                                     threads,restriction);
+        } else {
+          internal::hornSchunckSweep(g,threads,par.relaxation);
+        }
+
+        if (checkResidual &&
+            (internal::hornSchunckResidual(g,threads) <= threshold)) {
+          break;
+        }
+      }
     }
 
+    u.swap(g.u);
+    v.swap(g.v);
+
     return true;
   }
 
@@ -515,5 +965,42 @@ namespace lti {
     
   }
 
-}
+  // read function for eSolverType.
+  bool read(ioHandler& handler,opticalFlowHornSchunck::eSolverType& data) {
+    std::string str;
+    if (handler.read(str)) {
+      if (str.find("ultigrid") != std::string::npos) {
+        data = opticalFlowHornSchunck::Multigrid;
+      } else if (str.find("ed") != std::string::npos) {
+        data = opticalFlowHornSchunck::RedBlack;
+      } else {
+        data = opticalFlowHornSchunck::Jacobi;
+      }
+      return true;
+    }
+    return false;
+  }
+
+  // write function for eSolverType.
+  bool write(ioHandler& handler,
+             const opticalFlowHornSchunck::eSolverType& data) {
+    bool b = false;
+    switch(data) {
+      case opticalFlowHornSchunck::Jacobi:
+        b = handler.write("Jacobi");
+        break;
+      case opticalFlowHornSchunck::RedBlack:
+        b = handler.write("RedBlack");
+        break;
+      case opticalFlowHornSchunck::Multigrid:
+        b = handler.write("Multigrid");
+        break;
+      default:
+        b=false;
+        handler.setStatusString("undefined eSolverType");
+        handler.write("Unknown");
+    }
+    return b;
+  }
 
+}
@@ -75,12 +75,51 @@ namespace lti {
    * B.K.P. Horn and B.G. Schunck, "Determining optical flow." 
    * Artificial Intelligence, vol 17, pp 185-203, 1981
    *
+   * The flow (u,v) minimizes, for the spatial derivatives Ix, Iy and the
+   * temporal difference It of the channels, the energy
+   * \f[ \sum (I_x u + I_y v - I_t)^2 +
+   *     \frac{\lambda}{4} (\|\nabla u\|^2 + \|\nabla v\|^2) \f]
+   * where the factor 1/4 lets the regularization term of each pixel be
+   * \f$\lambda(u - \bar{u})\f$, with the mean \f$\bar{u}\f$ of its four
+   * neighbours, as in the original formulation.
+   * Three solvers for the resulting linear system are provided (see
+   * parameters::solver):
+   *
+   * - Jacobi: the original iteration of Horn and Schunck, which replaces
+   *   the local averages of the flow with a Gaussian filter.  It needs many
+   *   iterations to propagate the flow into regions without texture.
+   * - RedBlack: successive over-relaxation (SOR) on the five point
+   *   Laplacian.  The pixels are updated in a checkerboard order: all
+   *   "red" pixels depend only on "black" ones and vice versa, so that each
+   *   half sweep can be split into bands of rows computed in parallel, with
+   *   results independent of the number of threads.
+   * - Multigrid: V-cycles with red-black Gauss-Seidel smoothing.  The data
+   *   terms of the coarse grids are built with lti::gaussianPyramid, the
+   *   residuals are restricted with the same kernel and the corrections are
+   *   interpolated bilinearly.  Each cycle reduces the error in all
+   *   frequencies, and reaches the residual of hundreds of SOR sweeps in a
+   *   few cycles.
+   *
+   * All solvers stop after parameters::maxIterations iterations (sweeps or
+   * cycles) or when the norm of the residual, relative to the norm of the
+   * right hand side, falls below parameters::residualThreshold.  The number
+   * of threads is given by functor::parameters::numberOfThreads.
+   *
    * @see opticalFlowHornSchunck::parameters.
    *
    * @ingroup gOpticalFlow
    */
   class opticalFlowHornSchunck : public opticalFlow {
   public:
+    /**
+     * Solver for the linear system of Horn and Schunck
+     */
+    enum eSolverType {
+      Jacobi,   /**< Jacobi iteration with Gaussian averages of the flow */
+      RedBlack, /**< Red-black successive over-relaxation */
+      Multigrid /**< Multigrid V-cycles with red-black smoothing */
+    };
+
     /**
      * The parameters for the class opticalFlowHornSchunck
      */
@@ -177,6 +216,9 @@ namespace lti {
       /**
        * Maximum number of iterations.
        *
+       * For the RedBlack solver an iteration is a sweep over all pixels, for
+       * the Multigrid solver a V-cycle.
+       *
        * Default value: 20
        */
       int maxIterations;
@@ -184,6 +226,9 @@ namespace lti {
       /**
        * Maximum error permited.
        *
+       * The Jacobi solver stops when the relative change of the flow in an
+       * iteration is smaller than this value.  The other solvers ignore it.
+       *
        * Default value: 0.01
        */
       float maxError;
@@ -196,6 +241,51 @@ namespace lti {
        * Default kernel: lti::gradientFunctor::Ando
        */
       lti::gradientFunctor::parameters gradient;
+
+      /**
+       * Solver used for the linear system.
+       *
+       * Default value: Jacobi
+       */
+      eSolverType solver;
+
+      /**
+       * Relaxation factor of the RedBlack solver.
+       *
+       * A value of 1 is the Gauss-Seidel iteration.  Values between 1 and 2
+       * (over-relaxation) converge faster; the optimal value approaches 2
+       * for large images and large lambda values.  The smoother of the
+       * Multigrid solver always uses 1.
+       *
+       * Default value: 1.5
+       */
+      float relaxation;
+
+      /**
+       * Maximum number of grids used by the Multigrid solver, including the
+       * original one.  Grids smaller than 8x8 are not used.
+       *
+       * Default value: 4
+       */
+      int multigridLevels;
+
+      /**
+       * Number of red-black Gauss-Seidel sweeps done before and after the
+       * coarse grid correction on each grid of the Multigrid solver.
+       *
+       * Default value: 2
+       */
+      int smoothingSteps;
+
+      /**
+       * The iterations stop when the norm of the residual of the linear
+       * system, divided by the norm of its right hand side, is smaller than
+       * this value.  Computing the residual costs about as much as one
+       * sweep.  Zero or negative values disable this criterion.
+       *
+       * Default value: 0
+       */
+      float residualThreshold;
     };
 
     /**
@@ -345,6 +435,18 @@ namespace lti {
      * Gradient functor
      */
     gradientFunctor grad_;
+
+    /**
+     * Solve the system with the Jacobi iteration of Horn and Schunck
+     */
+    bool solveJacobi(const channel& ix,const channel& iy,const channel& it,
+                     channel& u,channel& v);
+
+    /**
+     * Solve the system with red-black SOR or with multigrid V-cycles
+     */
+    bool solveRedBlack(const channel& ix,const channel& iy,const channel& it,
+                       channel& u,channel& v);
      
     /**
      * Last velocity averages
@@ -411,6 +513,21 @@ namespace lti {
 
 	
   };
+
+  /**
+   * Read a opticalFlowHornSchunck::eSolverType
+   *
+   * @ingroup gStorable
+   */
+  bool read(ioHandler& handler, opticalFlowHornSchunck::eSolverType& data);
+
+  /**
+   * Write a opticalFlowHornSchunck::eSolverType
+   *
+   * @ingroup gStorable
+   */
+  bool write(ioHandler& handler,
+             const opticalFlowHornSchunck::eSolverType& data);
 }
 
 #endif
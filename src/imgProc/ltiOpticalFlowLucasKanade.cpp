@@ -50,7 +50,9 @@
 
 #include "ltiOpticalFlowLucasKanade.h"
 #include "ltiGaussKernels.h"
+#include "ltiMath.h"
 #include <limits>
+#include <cmath>
 
 namespace lti {
   // --------------------------------------------------
@@ -64,6 +66,11 @@ namespace lti {
     kernelSize = int(5);
     gradient.format = lti::gradientFunctor::Cartesian;
     gradient.kernelType = lti::gradientFunctor::Ando;
+    pyramidLevels = 3;
+    maxIterations = 20;
+    epsilon = 0.01f;
+    minEigenvalue = 1.0e-4f;
+    useInitialEstimate = false;
   }
 
   // copy constructor
@@ -86,6 +93,11 @@ namespace lti {
     variance   = other.variance;
     kernelSize = other.kernelSize;
     gradient   = other.gradient;
+    pyramidLevels      = other.pyramidLevels;
+    maxIterations      = other.maxIterations;
+    epsilon            = other.epsilon;
+    minEigenvalue      = other.minEigenvalue;
+    useInitialEstimate = other.useInitialEstimate;
 
     return *this;
   }
@@ -132,6 +144,11 @@ namespace lti {
       lti::write(handler,"variance",variance);
       lti::write(handler,"kernelSize",kernelSize);
       lti::write(handler,"gradient",gradient);
+      lti::write(handler,"pyramidLevels",pyramidLevels);
+      lti::write(handler,"maxIterations",maxIterations);
+      lti::write(handler,"epsilon",epsilon);
+      lti::write(handler,"minEigenvalue",minEigenvalue);
+      lti::write(handler,"useInitialEstimate",useInitialEstimate);
     }
 
     b = b && opticalFlow::parameters::write(handler,false);
@@ -162,6 +179,11 @@ namespace lti {
       lti::read(handler,"variance",variance);
       lti::read(handler,"kernelSize",kernelSize);
       lti::read(handler,"gradient",gradient);
+      lti::read(handler,"pyramidLevels",pyramidLevels);
+      lti::read(handler,"maxIterations",maxIterations);
+      lti::read(handler,"epsilon",epsilon);
+      lti::read(handler,"minEigenvalue",minEigenvalue);
+      lti::read(handler,"useInitialEstimate",useInitialEstimate);
     }
 
     b = b && opticalFlow::parameters::read(handler,false);
@@ -179,7 +201,7 @@ namespace lti {
 
   // default constructor
   opticalFlowLucasKanade::opticalFlowLucasKanade()
-    : opticalFlow() {
+    : opticalFlow(), next_(0), validPyramids_(0) {
 
     // create an instance of the parameters with the default values
     parameters defaultParameters;
@@ -189,7 +211,7 @@ namespace lti {
 
   // default constructor
   opticalFlowLucasKanade::opticalFlowLucasKanade(const parameters& par)
-    : opticalFlow() {
+    : opticalFlow(), next_(0), validPyramids_(0) {
 
     // set the given parameters
     setParameters(par);
@@ -198,7 +220,7 @@ namespace lti {
 
   // copy constructor
   opticalFlowLucasKanade::opticalFlowLucasKanade(const opticalFlowLucasKanade& other)
-    : opticalFlow() {
+    : opticalFlow(), next_(0), validPyramids_(0) {
     copy(other);
   }
 
@@ -211,6 +233,11 @@ namespace lti {
   opticalFlowLucasKanade::copy(const opticalFlowLucasKanade& other) {
     opticalFlow::copy(other);
 
+    pyramids_[0].copy(other.pyramids_[0]);
+    pyramids_[1].copy(other.pyramids_[1]);
+    next_ = other.next_;
+    validPyramids_ = other.validPyramids_;
+
     return (*this);
   }
 
@@ -273,6 +300,14 @@ namespace lti {
      convPar.boundaryType = lti::Constant;
      success = filter_.setParameters(convPar);
 
+     // separable weights of the tracking window, with the same variance
+     const int half = max(0,par.kernelSize/2);
+     weights_.resize(2*half+1);
+     for (int i=-half;i<=half;++i) {
+       weights_[i+half] =
+         static_cast<float>(exp(-0.5*double(i*i)/par.variance));
+     }
+
      // return true only if everything was ok.
      return success;
   }
@@ -482,5 +517,371 @@ namespace lti {
     return true;
   }
 
-}
+  // -------------------------------------------------------------------
+  // Sparse pyramidal tracking
+  // -------------------------------------------------------------------
+
+  namespace internal {
+    /*
+     * Bilinear sampling of the square window with side 2*half+1 centered at
+     * (px,py).  All samples share the same fractional position.  Outside the
+     * channel the border pixels are replicated.
+     */
+    void lucasKanadeWindow(const channel& chnl,
+                           const float px,
+                           const float py,
+                           const int half,
+                           float* dest) {
+      const int side = 2*half+1;
+      const float fx = std::floor(px);
+      const float fy = std::floor(py);
+      const float ax = px-fx;
+      const float ay = py-fy;
+      const float w00 = (1.0f-ax)*(1.0f-ay);
+      const float w01 = ax*(1.0f-ay);
+      const float w10 = (1.0f-ax)*ay;
+      const float w11 = ax*ay;
+      const int x0 = static_cast<int>(fx)-half;
+      const int y0 = static_cast<int>(fy)-half;
+      const int lastCol = chnl.lastColumn();
+      const int lastRow = chnl.lastRow();
+
+      if ((x0 >= 0) && (y0 >= 0) &&
+          (x0+side <= lastCol) && (y0+side <= lastRow)) {
+        // the whole window lies within the channel
+        for (int r=0;r<side;++r) {
+          const float* r0 = chnl[y0+r].data()+x0;
+          const float* r1 = chnl[y0+r+1].data()+x0;
+          for (int c=0;c<side;++c) {
+            dest[c] = w00*r0[c] + w01*r0[c+1] + w10*r1[c] + w11*r1[c+1];
+          }
+          dest+=side;
+        }
+      } else {
+        for (int r=0;r<side;++r) {
+          const float* r0 = chnl[max(0,min(lastRow,y0+r))].data();
+          const float* r1 = chnl[max(0,min(lastRow,y0+r+1))].data();
+          for (int c=0;c<side;++c) {
+            const int c0 = max(0,min(lastCol,x0+c));
+            const int c1 = max(0,min(lastCol,x0+c+1));
+            dest[c] = w00*r0[c0] + w01*r0[c1] + w10*r1[c0] + w11*r1[c1];
+          }
+          dest+=side;
+        }
+      }
+    }
+  }
+
+  /*
+   * Job tracking a range of points in each task
+   */
+  class opticalFlowLucasKanade::trackJob : public threadPool::job {
+  public:
+    /*
+     * Constructor
+     */
+    trackJob(const opticalFlowLucasKanade& owner,
+             const std::vector<fpoint>& pts1,
+             const std::vector<fpoint>& guesses,
+             const int numTasks,
+             std::vector<fpoint>& pts2,
+             ivector& status)
+      : owner_(owner),pts1_(pts1),guesses_(guesses),numTasks_(numTasks),
+        pts2_(pts2),status_(status) {
+    }
+
+    /*
+     * Track the points of the task
+     */
+    virtual void execute(const int task) {
+      const int numPts = static_cast<int>(pts1_.size());
+      const int from = (task*numPts)/numTasks_;
+      const int to = ((task+1)*numPts)/numTasks_;
+
+      const int side = static_cast<int>(owner_.weights_.size());
+      std::vector<float> buffer((side+2)*(side+2)+3*side*side);
+      for (int i=from;i<to;++i) {
+        status_.at(i) = owner_.trackPoint(pts1_[i],guesses_[i],pts2_[i],
+                                          &buffer[0]);
+      }
+    }
+
+  private:
+    const opticalFlowLucasKanade& owner_;
+    const std::vector<fpoint>& pts1_;
+    const std::vector<fpoint>& guesses_;
+    const int numTasks_;
+    std::vector<fpoint>& pts2_;
+    ivector& status_;
+  };
+
+  void opticalFlowLucasKanade::buildPyramid(const channel& chnl,
+                                            const int idx) {
+    const parameters& par = getParameters();
+    const int side = static_cast<int>(weights_.size());
+
+    // the coarsest level must still contain a whole window
+    int levels = 1;
+    ipoint size = chnl.size();
+    while ((levels < par.pyramidLevels) &&
+           (size.x/2 >= side) && (size.y/2 >= side)) {
+      size.x/=2;
+      size.y/=2;
+      ++levels;
+    }
+
+    pyramids_[idx].setNumberOfThreads(par.numberOfThreads);
+    pyramids_[idx].generate(chnl,levels);
+  }
+
+  opticalFlowLucasKanade::eTrackingStatus
+  opticalFlowLucasKanade::trackPoint(const fpoint& pt,
+                                     const fpoint& guess,
+                                     fpoint& tracked,
+                                     float* buffer) const {
+    const parameters& par = getParameters();
+    const gaussianPyramid<channel>& prev = pyramids_[1-next_];
+    const gaussianPyramid<channel>& next = pyramids_[next_];
+
+    const int side = static_cast<int>(weights_.size());
+    const int half = side/2;
+    const int wide = side+2;
+    const int levels = prev.size();
+    const float eps2 = par.epsilon*par.epsilon;
+
+    float* const win = buffer;        // window of prev with a 1 pixel margin
+    float* const gx = win+wide*wide;  // weighted gradients of prev
+    float* const gy = gx+side*side;
+    float* const jwin = gy+side*side; // window of next
+
+    // displacement at the coarsest level
+    float scale = 1.0f/static_cast<float>(1 << (levels-1));
+    float dx = (guess.x-pt.x)*scale;
+    float dy = (guess.y-pt.y)*scale;
+    bool converged = false;
+
+    for (int level=levels-1;level>=0;--level) {
+      const channel& I = prev.at(level);
+      const channel& J = next.at(level);
+      const float px = pt.x*scale;
+      const float py = pt.y*scale;
+
+      // spatial gradient matrix of the window in the previous frame
+      internal::lucasKanadeWindow(I,px,py,half+1,win);
+      double gxx=0.0,gxy=0.0,gyy=0.0,wsum=0.0;
+      for (int r=0,k=0;r<side;++r) {
+        const float* wr = win+(r+1)*wide+1;
+        for (int c=0;c<side;++c,++k) {
+          const float w = weights_[r]*weights_[c];
+          const float ix = 0.5f*(wr[c+1]-wr[c-1]);
+          const float iy = 0.5f*(wr[c+wide]-wr[c-wide]);
+          gx[k] = w*ix;
+          gy[k] = w*iy;
+          gxx += gx[k]*ix;
+          gxy += gx[k]*iy;
+          gyy += gy[k]*iy;
+          wsum += w;
+        }
+      }
+
+      const double det = gxx*gyy-gxy*gxy;
+      const double minEig =
+        0.5*(gxx+gyy-sqrt((gxx-gyy)*(gxx-gyy)+4.0*gxy*gxy))/wsum;
+      if ((minEig < par.minEigenvalue) ||
+          (det <= std::numeric_limits<double>::epsilon())) {
+        tracked.set(pt.x+dx/scale,pt.y+dy/scale);
+        return SmallEigenvalue;
+      }
+
+      // Newton-Raphson iterations
+      converged = false;
+      for (int it=0;it<par.maxIterations;++it) {
+        const float qx = px+dx;
+        const float qy = py+dy;
+        if ((qx < 0.0f) || (qy < 0.0f) ||
+            (qx > static_cast<float>(J.lastColumn())) ||
+            (qy > static_cast<float>(J.lastRow()))) {
+          tracked.set(qx/scale,qy/scale);
+          return OutOfImage;
+        }
+
+        internal::lucasKanadeWindow(J,qx,qy,half,jwin);
+        double bx=0.0,by=0.0;
+        for (int r=0,k=0;r<side;++r) {
+          const float* wr = win+(r+1)*wide+1;
+          for (int c=0;c<side;++c,++k) {
+            const float diff = wr[c]-jwin[k];
+            bx += gx[k]*diff;
+            by += gy[k]*diff;
+          }
+        }
+
+        const float ex = static_cast<float>((gyy*bx-gxy*by)/det);
+        const float ey = static_cast<float>((gxx*by-gxy*bx)/det);
+        dx+=ex;
+        dy+=ey;
+        if (ex*ex+ey*ey < eps2) {
+          converged = true;
+          break;
+        }
+      }
+
+      if (level > 0) {
+        dx*=2.0f;
+        dy*=2.0f;
+        scale*=2.0f;
+      }
+    }
+
+    tracked.set(pt.x+dx,pt.y+dy);
+    const channel& J = next.at(0);
+    if ((tracked.x < 0.0f) || (tracked.y < 0.0f) ||
+        (tracked.x > static_cast<float>(J.lastColumn())) ||
+        (tracked.y > static_cast<float>(J.lastRow()))) {
+      return OutOfImage;
+    }
+
+    return converged ? Tracked : NotConverged;
+  }
+
+  bool opticalFlowLucasKanade::trackPyramids(const std::vector<fpoint>& pts1,
+                                             std::vector<fpoint>& pts2,
+                                             ivector& status) {
+    const parameters& par = getParameters();
+    const int numPts = static_cast<int>(pts1.size());
+
+    // the initial estimations are taken before pts2 is overwritten
+    std::vector<fpoint> guesses;
+    if (par.useInitialEstimate && (static_cast<int>(pts2.size()) == numPts)) {
+      guesses.swap(pts2);
+    } else {
+      guesses = pts1;
+    }
+
+    pts2.resize(numPts);
+    status.allocate(numPts);
+    if (numPts == 0) {
+      return true;
+    }
+
+    const int threads = threadPool::computeThreads(par.numberOfThreads);
+    const int tasks = min(numPts,(threads > 1) ? 8*threads : 1);
+
+    trackJob job(*this,pts1,guesses,tasks,pts2,status);
+    threadPool::getShared().run(job,tasks,threads);
+
+    return true;
+  }
+
+  bool opticalFlowLucasKanade::track(const channel& last,
+                                     const channel& next,
+                                     const std::vector<fpoint>& pts1,
+                                     std::vector<fpoint>& pts2,
+                                     ivector& status) {
+    if (last.size() != next.size()) {
+      setStatusString("The channels must have the same size");
+      return false;
+    }
+    if (next.empty()) {
+      setStatusString("Empty channels");
+      return false;
+    }
 
+    buildPyramid(last,1-next_);
+    buildPyramid(next,next_);
+    validPyramids_ = 2;
+
+    return trackPyramids(pts1,pts2,status);
+  }
+
+  bool opticalFlowLucasKanade::track(const channel& next,
+                                     const std::vector<fpoint>& pts1,
+                                     std::vector<fpoint>& pts2,
+                                     ivector& status) {
+    if (next.empty()) {
+      setStatusString("Empty channel");
+      return false;
+    }
+
+    if (validPyramids_ == 0) {
+      // no previous frame: nothing can have moved
+      buildPyramid(next,next_);
+      validPyramids_ = 1;
+      pts2 = pts1;
+      status.assign(static_cast<int>(pts1.size()),Tracked);
+      return true;
+    }
+
+    if (pyramids_[next_].at(0).size() != next.size()) {
+      // start a new sequence with this frame
+      buildPyramid(next,next_);
+      validPyramids_ = 1;
+      setStatusString("The channel has not the size of the previous frame");
+      return false;
+    }
+
+    // the next frame of the last call is now the previous one
+    next_ = 1-next_;
+    buildPyramid(next,next_);
+    validPyramids_ = 2;
+
+    gaussianPyramid<channel>& prev = pyramids_[1-next_];
+    if (prev.size() != pyramids_[next_].size()) {
+      // the parameters have changed since the previous frame
+      const channel tmp(prev.at(0));
+      buildPyramid(tmp,1-next_);
+    }
+
+    return trackPyramids(pts1,pts2,status);
+  }
+
+  bool opticalFlowLucasKanade::track(const channel& last,
+                                     const channel& next,
+                                     const ipointList& pts1,
+                                     std::vector<fpoint>& pts2,
+                                     ivector& status) {
+    std::vector<fpoint> pts1f;
+    pts1f.reserve(pts1.size());
+    for (ipointList::const_iterator it=pts1.begin();it!=pts1.end();++it) {
+      pts1f.push_back(fpoint(static_cast<float>((*it).x),
+                             static_cast<float>((*it).y)));
+    }
+
+    return track(last,next,pts1f,pts2,status);
+  }
+
+  bool opticalFlowLucasKanade::track(const channel& last,
+                                     const channel& next,
+                                     const list<location>& locs1,
+                                     list<location>& locs2,
+                                     ivector& status) {
+    std::vector<fpoint> pts1f,pts2f;
+    pts1f.reserve(locs1.size());
+    list<location>::const_iterator it;
+    for (it=locs1.begin();it!=locs1.end();++it) {
+      pts1f.push_back((*it).position);
+    }
+
+    if (getParameters().useInitialEstimate &&
+        (locs2.size() == locs1.size())) {
+      pts2f.reserve(locs2.size());
+      for (it=locs2.begin();it!=locs2.end();++it) {
+        pts2f.push_back((*it).position);
+      }
+    }
+
+    if (!track(last,next,pts1f,pts2f,status)) {
+      return false;
+    }
+
+    locs2 = locs1;
+    int i=0;
+    list<location>::iterator lit;
+    for (lit=locs2.begin();lit!=locs2.end();++lit,++i) {
+      (*lit).position = pts2f[i];
+    }
+
+    return true;
+  }
+
+}
@@ -56,6 +56,10 @@
 #include "ltiGradientFunctor.h"
 #include "ltiConvolution.h"
 #include "ltiLocation.h"
+#include "ltiPointList.h"
+#include "ltiGaussianPyramid.h"
+#include "ltiThreadPool.h"
+#include <vector>
 
 namespace lti {
 
@@ -74,12 +78,73 @@ namespace lti {
    * equations for all the pixels in that neighbourhood, by the least squares
    * criterion.
    *
+   * The apply() methods compute a dense flow field at the resolution of the
+   * given channels, and therefore only small displacements can be found.
+   *
+   * \section lkTrack Sparse pyramidal tracking
+   *
+   * If the flow is only required at a few points (for instance some hundred
+   * corners), the track() methods follow the iterative, coarse-to-fine
+   * scheme described in
+   *
+   * J.-Y. Bouguet, Pyramidal Implementation of the Lucas Kanade Feature
+   * Tracker. Intel Corporation, Microprocessor Research Labs, 2000
+   *
+   * A lti::gaussianPyramid with parameters::pyramidLevels levels is built for
+   * each channel.  The displacement of each point is estimated first at the
+   * coarsest level and then refined at each finer one, so that motions much
+   * larger than the window are found.  At each level the displacement is
+   * refined with Newton-Raphson iterations on a window of
+   * parameters::kernelSize x parameters::kernelSize pixels, sampled with
+   * bilinear interpolation, until the update is smaller than
+   * parameters::epsilon or parameters::maxIterations are done.  Only the
+   * windows around the points are ever touched, and the points are tracked
+   * in parallel by the shared lti::threadPool, as indicated by
+   * functor::parameters::numberOfThreads.  The result of each point does not
+   * depend on the number of threads.
+   *
+   * Each point receives an eTrackingStatus.  The pyramid of the second
+   * channel is kept, so that for a sequence of frames only the pyramid of
+   * the new frame has to be computed:
+   *
+   * \code
+   * lti::opticalFlowLucasKanade::parameters par;
+   * par.pyramidLevels = 4;
+   * par.kernelSize = 15;
+   * par.numberOfThreads = 0; // use all processors
+   * lti::opticalFlowLucasKanade tracker(par);
+   *
+   * std::vector<lti::fpoint> pts,tracked;
+   * lti::ivector status;
+   *
+   * // ... detect the points in the first frame ...
+   * tracker.track(frame0,frame1,pts,tracked,status);
+   *
+   * // the next frames reuse the pyramid of the previous one
+   * pts.swap(tracked);
+   * tracker.track(frame2,pts,tracked,status);
+   * \endcode
+   *
    * @see opticalFlowLucasKanade::parameters.
    *
    * @ingroup gOpticalFlow
    */
   class opticalFlowLucasKanade : public opticalFlow {
   public:
+    /**
+     * Result of the tracking of one point with track()
+     */
+    enum eTrackingStatus {
+      Tracked,         /**< The point was found and the iterations converged
+                        *   at the finest level */
+      NotConverged,    /**< The point was found, but the iterations at the
+                        *   finest level did not converge in
+                        *   parameters::maxIterations steps */
+      SmallEigenvalue, /**< The window around the point has not enough
+                        *   texture (see parameters::minEigenvalue) */
+      OutOfImage       /**< The point left the image */
+    };
+
     /**
      * The parameters for the class opticalFlowLucasKanade
      */
@@ -178,6 +243,51 @@ namespace lti {
        */
       lti::gradientFunctor::parameters gradient;
 
+      /**
+       * Number of levels of the pyramids used by track().
+       *
+       * A value of 1 tracks the points at the original resolution only.
+       * Each additional level doubles the largest displacement that can be
+       * found.  Levels smaller than the window are not used.
+       *
+       * Default value: 3
+       */
+      int pyramidLevels;
+
+      /**
+       * Maximum number of iterations at each level of the pyramid in
+       * track().
+       *
+       * Default value: 20
+       */
+      int maxIterations;
+
+      /**
+       * The iterations of track() at one level stop when the update of the
+       * displacement is smaller than this value (in pixels of that level).
+       *
+       * Default value: 0.01
+       */
+      float epsilon;
+
+      /**
+       * Minimum eigenvalue of the spatial gradient matrix of a window,
+       * normalized by the sum of the window weights, required to track it.
+       * The channel values are assumed to be in the range 0 to 1.
+       *
+       * Default value: 1e-4
+       */
+      float minEigenvalue;
+
+      /**
+       * If true, the positions given in the second point vector of track()
+       * are used as initial estimation for the tracked points, if they have
+       * as many elements as the points to be tracked.  Otherwise the
+       * initial displacement is zero.
+       *
+       * Default value: false
+       */
+      bool useInitialEstimate;
     };
 
     /**
@@ -242,6 +352,86 @@ namespace lti {
      */
     virtual bool updateParameters();
 
+    /**
+     * @name Sparse pyramidal tracking
+     */
+    //@{
+    /**
+     * Track the given points from the channel \a last to the channel \a next.
+     *
+     * @param last channel with the previous frame
+     * @param next channel with the next frame
+     * @param pts1 positions (x,y) of the points in \a last
+     * @param pts2 positions of the points in \a next.  It will have as many
+     *             elements as \a pts1.  If parameters::useInitialEstimate is
+     *             true, its initial content is used as initial estimation.
+     * @param status eTrackingStatus of each point
+     * @return true if successful, false otherwise (if the channels have
+     *         different sizes)
+     */
+    bool track(const channel& last,
+               const channel& next,
+               const std::vector<fpoint>& pts1,
+               std::vector<fpoint>& pts2,
+               ivector& status);
+
+    /**
+     * Track the given points from the channel given as \a next in the
+     * previous call of a track() method to the channel \a next.
+     *
+     * Only the pyramid of \a next has to be computed.  If there is no
+     * previous frame, \a next is taken as such, and all points are
+     * returned unchanged.
+     *
+     * @param next channel with the next frame
+     * @param pts1 positions (x,y) of the points in the previous frame
+     * @param pts2 positions of the points in \a next
+     * @param status eTrackingStatus of each point
+     * @return true if successful, false otherwise
+     */
+    bool track(const channel& next,
+               const std::vector<fpoint>& pts1,
+               std::vector<fpoint>& pts2,
+               ivector& status);
+
+    /**
+     * Track the given points from the channel \a last to the channel \a next.
+     *
+     * @param last channel with the previous frame
+     * @param next channel with the next frame
+     * @param pts1 positions of the points in \a last
+     * @param pts2 positions of the points in \a next, in the same order as
+     *             \a pts1
+     * @param status eTrackingStatus of each point
+     * @return true if successful, false otherwise
+     */
+    bool track(const channel& last,
+               const channel& next,
+               const ipointList& pts1,
+               std::vector<fpoint>& pts2,
+               ivector& status);
+
+    /**
+     * Track the given locations from the channel \a last to the channel
+     * \a next.
+     *
+     * The locations in \a locs2 are copies of the ones in \a locs1, in the
+     * same order, with the tracked positions.
+     *
+     * @param last channel with the previous frame
+     * @param next channel with the next frame
+     * @param locs1 locations in \a last
+     * @param locs2 tracked locations in \a next
+     * @param status eTrackingStatus of each location
+     * @return true if successful, false otherwise
+     */
+    bool track(const channel& last,
+               const channel& next,
+               const list<location>& locs1,
+               list<location>& locs2,
+               ivector& status);
+    //@}
+
   private:
     /**
      * Gradient functor
@@ -306,6 +496,61 @@ namespace lti {
      */
     channel Iyy_,Ixx_,Ixy_,Ixt_,Iyt_;
 
+  private:
+    /**
+     * Job tracking a range of points in each task
+     */
+    class trackJob;
+    friend class trackJob;
+
+    /**
+     * Generate the pyramid of the given channel into pyramids_[idx]
+     */
+    void buildPyramid(const channel& chnl,const int idx);
+
+    /**
+     * Track the points from the pyramid pyramids_[1-next_] to the pyramid
+     * pyramids_[next_].
+     */
+    bool trackPyramids(const std::vector<fpoint>& pts1,
+                       std::vector<fpoint>& pts2,
+                       ivector& status);
+
+    /**
+     * Track one point through the pyramids.
+     *
+     * @param pt position of the point in the previous frame
+     * @param guess initial estimation of the position in the next frame
+     * @param tracked tracked position
+     * @param buffer memory for the windows, with at least
+     *               (kernelSize+2)^2 + 3*kernelSize^2 elements
+     * @return eTrackingStatus of the point
+     */
+    eTrackingStatus trackPoint(const fpoint& pt,
+                               const fpoint& guess,
+                               fpoint& tracked,
+                               float* buffer) const;
+
+    /**
+     * Pyramids of the previous and next frames
+     */
+    gaussianPyramid<channel> pyramids_[2];
+
+    /**
+     * Index of the pyramid of the next frame in pyramids_
+     */
+    int next_;
+
+    /**
+     * Number of valid pyramids (0, 1 or 2)
+     */
+    int validPyramids_;
+
+    /**
+     * Separable weights of the tracking window
+     */
+    std::vector<float> weights_;
+
   };
 }
 
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiParallelBands.cpp
+ *         Contains the class lti::bandPartition, the non-template part of
+ *         lti::parallelBands.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include "ltiParallelBands.h"
+#include "ltiMath.h"
+
+namespace lti {
+
+  const int bandPartition::MinimumRows = 16;
+  const int bandPartition::MinimumElements = 16384;
+
+  bandPartition::bandPartition(const int numberOfThreads,
+                               const ipoint& size,
+                               const int halo) {
+    int n = 1;
+
+    if ((numberOfThreads != 1) && (size.y > 0) && (size.x > 0)) {
+      n = threadPool::computeThreads(numberOfThreads);
+
+      // each band must be clearly larger than its halo, or the work done
+      // on the halo rows is not worth it.  A halo as large as the data
+      // results in just one band.
+      const int minRows = (halo < size.y) ? max(MinimumRows,4*halo)
+                                          : size.y+1;
+      n = min(n,size.y/minRows);
+      n = min(n,static_cast<int>((static_cast<double>(size.x)*size.y)/
+                                 MinimumElements));
+    }
+
+    if (n <= 1) {
+      bands_.resize(1);
+      bands_[0].from = bands_[0].srcFrom = 0;
+      bands_[0].to = bands_[0].srcTo = size.y;
+      return;
+    }
+
+    bands_.resize(n);
+    for (int i=0;i<n;++i) {
+      band& b = bands_[i];
+      b.from  = (i*size.y)/n;
+      b.to    = ((i+1)*size.y)/n;
+      b.srcFrom = max(0,b.from-halo);
+      b.srcTo   = min(size.y,b.to+halo);
+    }
+  }
+
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiParallelBands.h
+ *         Contains the class lti::parallelBands, which applies a functor
+ *         on bands of rows of a matrix using the shared thread pool.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#ifndef _LTI_PARALLEL_BANDS_H_
+#define _LTI_PARALLEL_BANDS_H_
+
+#include "ltiFunctor.h"
+#include "ltiPoint.h"
+#include "ltiThreadPool.h"
+#include <vector>
+
+namespace lti {
+
+  /**
+   * Partition of the rows of a matrix into bands.
+   *
+   * This is the non-template part of lti::parallelBands.  It decides,
+   * depending on the functor::parameters::numberOfThreads attribute of a
+   * functor and on the size of the data, into how many bands the rows are
+   * split, and which rows of the source data each band needs.
+   */
+  class bandPartition {
+  public:
+    /**
+     * A band of rows.
+     *
+     * The band computes the result rows \c from to \c to-1 and requires for
+     * that the source rows \c srcFrom to \c srcTo-1.
+     */
+    struct band {
+      /**
+       * First result row
+       */
+      int from;
+
+      /**
+       * One after the last result row
+       */
+      int to;
+
+      /**
+       * First source row
+       */
+      int srcFrom;
+
+      /**
+       * One after the last source row
+       */
+      int srcTo;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param numberOfThreads number of threads requested (see
+     *        functor::parameters::numberOfThreads)
+     * @param size size of the data (x columns, y rows)
+     * @param halo number of rows above and below each band required
+     *        to compute its result.  Use a value greater or equal the
+     *        number of rows if the result of each row depends on all others
+     *        (as with a periodic boundary), to get just one band.
+     */
+    bandPartition(const int numberOfThreads,
+                  const ipoint& size,
+                  const int halo);
+
+    /**
+     * Number of bands.  If 1, the data should be processed as a whole.
+     */
+    inline int getNumberOfBands() const;
+
+    /**
+     * Get the i-th band
+     */
+    inline const band& getBand(const int i) const;
+
+    /**
+     * Minimum number of rows per band
+     */
+    static const int MinimumRows;
+
+    /**
+     * Minimum number of elements per band.  Smaller bands are not worth
+     * the synchronization overhead.
+     */
+    static const int MinimumElements;
+
+  protected:
+    /**
+     * The bands
+     */
+    std::vector<band> bands_;
+  };
+
+  /**
+   * Parallel application of a functor on bands of rows.
+   *
+   * Most image processing functors compute each output row from a few
+   * neighbouring rows of the input.  This class splits the rows of the data
+   * into as many bands as threads are used, extends each band with \a halo
+   * rows above and below, and applies a copy of the functor on each band in
+   * the shared lti::threadPool.  The valid rows of each partial result are
+   * finally copied into the destination.  Since each output row is computed
+   * by exactly the same code and from the same input rows, the result is
+   * identical to the one of the sequential execution, as long as the halo
+   * covers the reach of the functor.  At the top and bottom borders of the
+   * data the bands end exactly where the data does, so that all boundary
+   * types that only depend on the rows near the border are also handled
+   * correctly.
+   *
+   * The functor class F must provide the usual clone() method and an
+   * apply() method for the given data types.  Each band works with its own
+   * clone, whose numberOfThreads parameter is set to 1, so that the
+   * functor itself may use this class in its apply() methods:
+   *
+   * \code
+   * bool myFilter::apply(const channel& src, channel& dest) const {
+   *   parallelBands<myFilter> bands(*this,src.size(),kernelSize/2);
+   *   if (bands.getNumberOfBands() > 1) {
+   *     return bands.apply(src,dest);
+   *   }
+   *
+   *   // sequential implementation
+   *   ...
+   * }
+   * \endcode
+   *
+   * Besides the one-input one-output case, the split() and merge() methods
+   * support the three channel signatures of lti::splitImage and
+   * lti::mergeImage.  Other signatures can be implemented with run() and an
+   * operation class with the method
+   * <code>bool operator()(F& functor,const bandPartition::band& b)</code>.
+   */
+  template<class F>
+  class parallelBands : public bandPartition {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param theFunctor functor to be applied.  The number of threads is
+     *        taken from its parameters.
+     * @param size size of the data to be processed
+     * @param halo number of additional rows required above and below each
+     *        band to compute it.
+     */
+    parallelBands(const F& theFunctor,
+                  const ipoint& size,
+                  const int halo = 0);
+
+    /**
+     * Apply the functor on src and leave the result in dest.
+     *
+     * The result of the functor must have the same size as its input.
+     */
+    template<class S,class D>
+    bool apply(const S& src,D& dest);
+
+    /**
+     * Apply a functor with one input and three outputs, like
+     * lti::splitImage.
+     */
+    template<class S,class D>
+    bool split(const S& src,D& c1,D& c2,D& c3);
+
+    /**
+     * Apply a functor with three inputs and one output, like
+     * lti::mergeImage.
+     */
+    template<class S,class D>
+    bool merge(const S& c1,const S& c2,const S& c3,D& dest);
+
+    /**
+     * Execute the operation op on each band, using a clone of the functor
+     * for each one.
+     *
+     * @return true if the operation was successful for all bands.
+     */
+    template<class Op>
+    bool run(Op& op);
+
+    /**
+     * Make \a view a read-only window on the source rows of the band.
+     *
+     * The matrix \a m must be Connected.
+     */
+    template<class M>
+    static void window(const M& m,const band& b,M& view);
+
+    /**
+     * Copy the result rows of the band from \a result, which was computed
+     * from the window of the band, into \a dest.
+     *
+     * @return false if the result does not have the size of the window.
+     */
+    template<class M,class N>
+    static bool store(const M& result,const band& b,N& dest);
+
+  protected:
+    /**
+     * Job executing op for each band in the thread pool
+     */
+    template<class Op>
+    class bandJob : public threadPool::job {
+    public:
+      /**
+       * Constructor
+       */
+      bandJob(Op& op,
+              std::vector<F*>& functors,
+              const std::vector<band>& bands);
+
+      /**
+       * Execute the operation on one band
+       */
+      virtual void execute(const int task);
+
+      /**
+       * Result of each band (int, since vector<bool> is not thread-safe)
+       */
+      std::vector<int> results;
+
+    private:
+      Op& op_;
+      std::vector<F*>& functors_;
+      const std::vector<band>& bands_;
+    };
+
+    /**
+     * Operation of apply()
+     */
+    template<class S,class D>
+    class applyOp;
+
+    /**
+     * Operation of split()
+     */
+    template<class S,class D>
+    class splitOp;
+
+    /**
+     * Operation of merge()
+     */
+    template<class S,class D>
+    class mergeOp;
+
+    /**
+     * The functor to be applied
+     */
+    const F& functor_;
+  };
+
+}
+
+#include "ltiParallelBands_template.h"
+
+#endif
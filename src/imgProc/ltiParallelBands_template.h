@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiParallelBands_template.h
+ *         Contains the class lti::parallelBands, which applies a functor
+ *         on bands of rows of a matrix using the shared thread pool.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include <algorithm>
+
+namespace lti {
+
+  // --------------------------------------------------------------------
+  // bandPartition
+  // --------------------------------------------------------------------
+
+  inline int bandPartition::getNumberOfBands() const {
+    return static_cast<int>(bands_.size());
+  }
+
+  inline const bandPartition::band& bandPartition::getBand(const int i) const {
+    return bands_[i];
+  }
+
+  // --------------------------------------------------------------------
+  // parallelBands::bandJob
+  // --------------------------------------------------------------------
+
+  template<class F>
+  template<class Op>
+  parallelBands<F>::bandJob<Op>::bandJob(Op& op,
+                                         std::vector<F*>& functors,
+                                         const std::vector<band>& bands)
+    : results(bands.size(),0),op_(op),functors_(functors),bands_(bands) {
+  }
+
+  template<class F>
+  template<class Op>
+  void parallelBands<F>::bandJob<Op>::execute(const int task) {
+    results[task] = op_(*functors_[task],bands_[task]) ? 1 : 0;
+  }
+
+  // --------------------------------------------------------------------
+  // parallelBands operations
+  // --------------------------------------------------------------------
+
+  template<class F>
+  template<class S,class D>
+  class parallelBands<F>::applyOp {
+  public:
+    applyOp(const S& src,D& dest) : src_(src),dest_(dest) {
+    }
+
+    bool operator()(F& theFunctor,const band& b) {
+      S in;
+      D out;
+      window(src_,b,in);
+      return (theFunctor.apply(in,out) && store(out,b,dest_));
+    }
+
+  private:
+    const S& src_;
+    D& dest_;
+  };
+
+  template<class F>
+  template<class S,class D>
+  class parallelBands<F>::splitOp {
+  public:
+    splitOp(const S& src,D& c1,D& c2,D& c3)
+      : src_(src),c1_(c1),c2_(c2),c3_(c3) {
+    }
+
+    bool operator()(F& theFunctor,const band& b) {
+      S in;
+      D o1,o2,o3;
+      window(src_,b,in);
+      return (theFunctor.apply(in,o1,o2,o3) &&
+              store(o1,b,c1_) && store(o2,b,c2_) && store(o3,b,c3_));
+    }
+
+  private:
+    const S& src_;
+    D& c1_;
+    D& c2_;
+    D& c3_;
+  };
+
+  template<class F>
+  template<class S,class D>
+  class parallelBands<F>::mergeOp {
+  public:
+    mergeOp(const S& c1,const S& c2,const S& c3,D& dest)
+      : c1_(c1),c2_(c2),c3_(c3),dest_(dest) {
+    }
+
+    bool operator()(F& theFunctor,const band& b) {
+      S i1,i2,i3;
+      D out;
+      window(c1_,b,i1);
+      window(c2_,b,i2);
+      window(c3_,b,i3);
+      return (theFunctor.apply(i1,i2,i3,out) && store(out,b,dest_));
+    }
+
+  private:
+    const S& c1_;
+    const S& c2_;
+    const S& c3_;
+    D& dest_;
+  };
+
+  // --------------------------------------------------------------------
+  // parallelBands
+  // --------------------------------------------------------------------
+
+  template<class F>
+  parallelBands<F>::parallelBands(const F& theFunctor,
+                                  const ipoint& size,
+                                  const int halo)
+    : bandPartition(theFunctor.getParameters().numberOfThreads,size,halo),
+      functor_(theFunctor) {
+  }
+
+  template<class F>
+  template<class M>
+  void parallelBands<F>::window(const M& m,const band& b,M& view) {
+    typedef typename M::value_type value_type;
+    view.useExternData(b.srcTo-b.srcFrom,m.columns(),
+                       const_cast<value_type*>(m.getRow(b.srcFrom).data()));
+  }
+
+  template<class F>
+  template<class M,class N>
+  bool parallelBands<F>::store(const M& result,const band& b,N& dest) {
+    if ((result.rows() != (b.srcTo-b.srcFrom)) ||
+        (result.columns() != dest.columns())) {
+      return false;
+    }
+
+    for (int y=b.from;y<b.to;++y) {
+      const typename M::value_type* s = result.getRow(y-b.srcFrom).data();
+      std::copy(s,s+result.columns(),dest.getRow(y).data());
+    }
+    return true;
+  }
+
+  template<class F>
+  template<class Op>
+  bool parallelBands<F>::run(Op& op) {
+    const int n = getNumberOfBands();
+    std::vector<F*> functors(n,static_cast<F*>(0));
+
+    // the clones are created here and not in the threads, since some
+    // functors initialize static look-up tables on construction
+    int i;
+    for (i=0;i<n;++i) {
+      functors[i] = static_cast<F*>(functor_.clone());
+      typename F::parameters* par = functors[i]->getParameters().clone();
+      par->numberOfThreads = 1;
+      functors[i]->attachParameters(*par);
+    }
+
+    bandJob<Op> job(op,functors,bands_);
+    bool ok = true;
+    try {
+      threadPool::getShared().run(job,n,n);
+    } catch (...) {
+      for (i=0;i<n;++i) {
+        delete functors[i];
+      }
+      throw;
+    }
+
+    for (i=0;i<n;++i) {
+      if (ok && (job.results[i] == 0)) {
+        functor_.setStatusString(functors[i]->getStatusString());
+        ok = false;
+      }
+      delete functors[i];
+    }
+
+    return ok;
+  }
+
+  template<class F>
+  template<class S,class D>
+  bool parallelBands<F>::apply(const S& src,D& dest) {
+    if ((src.getMode() != S::Connected) ||
+        (static_cast<const void*>(&src) == static_cast<const void*>(&dest))) {
+      // the bands can only be windows of connected data, which must not
+      // be overwritten while the bands are computed
+      const S tmp(src);
+      return apply(tmp,dest);
+    }
+
+    dest.allocate(src.rows(),src.columns());
+    applyOp<S,D> op(src,dest);
+    return run(op);
+  }
+
+  template<class F>
+  template<class S,class D>
+  bool parallelBands<F>::split(const S& src,D& c1,D& c2,D& c3) {
+    if (src.getMode() != S::Connected) {
+      const S tmp(src);
+      return split(tmp,c1,c2,c3);
+    }
+
+    c1.allocate(src.rows(),src.columns());
+    c2.allocate(src.rows(),src.columns());
+    c3.allocate(src.rows(),src.columns());
+    splitOp<S,D> op(src,c1,c2,c3);
+    return run(op);
+  }
+
+  template<class F>
+  template<class S,class D>
+  bool parallelBands<F>::merge(const S& c1,const S& c2,const S& c3,D& dest) {
+    if ((c1.size() != c2.size()) || (c1.size() != c3.size())) {
+      functor_.setStatusString("sizes of channels do not match");
+      return false;
+    }
+
+    if ((c1.getMode() != S::Connected) ||
+        (c2.getMode() != S::Connected) ||
+        (c3.getMode() != S::Connected)) {
+      const S t1(c1),t2(c2),t3(c3);
+      return merge(t1,t2,t3,dest);
+    }
+
+    dest.allocate(c1.rows(),c1.columns());
+    mergeOp<S,D> op(c1,c2,c3,dest);
+    return run(op);
+  }
+
+}
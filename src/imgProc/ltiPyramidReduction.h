@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+
+/**
+ * \file   ltiPyramidReduction.h
+ *         Contains the helper class lti::internal::pyramidReduction, which
+ *         smoothes and subsamples a matrix in one pass.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#ifndef _LTI_PYRAMID_REDUCTION_H_
+#define _LTI_PYRAMID_REDUCTION_H_
+
+#include "ltiMatrix.h"
+#include "ltiSeparableKernel.h"
+#include "ltiRGBAPixel.h"
+#include "ltiTypeInfo.h"
+#include "ltiContainer.h"
+#include <vector>
+
+namespace lti {
+  namespace internal {
+
+    /**
+     * Separable smoothing and subsampling of a matrix in one pass.
+     *
+     * The element (y,x) of the result is the convolution of the source with
+     * a separable kernel with one filter pair, evaluated at the source
+     * position (step*y,step*x), where the Constant boundary is assumed.
+     * With a step of one this is just the convolution.
+     *
+     * Only the source rows required by each result row are filtered
+     * horizontally, and only at the retained columns.  These partial results
+     * are kept in a ring buffer with as many rows as the column filter, so
+     * that no intermediate matrix is needed.  The sums are computed in the
+     * same order as in lti::downsampling, so that both produce exactly the
+     * same results.
+     *
+     * The rows of the result are split into bands processed in parallel
+     * (see lti::bandPartition).  Each band has its own ring buffer, and all
+     * buffers are kept from one call to the next, so that the repeated
+     * processing of images of the same size (like the frames of a video)
+     * does not allocate memory.
+     *
+     * @param T type of the matrix elements.  For integer types the sums are
+     *          divided by the norm of the filters.
+     */
+    template<typename T>
+    class pyramidReduction {
+    public:
+      /**
+       * Type used to accumulate the products
+       */
+      typedef typename typeInfo<T>::accumulation_type acc_type;
+
+      /**
+       * Default constructor
+       */
+      pyramidReduction();
+
+      /**
+       * Set the kernel, which must be a separableKernel<T> with just one
+       * filter pair.
+       *
+       * @return true if the kernel can be used, false otherwise.
+       */
+      bool setKernel(const container& kern);
+
+      /**
+       * Check if matrices of the given size can be processed, i.e. if a
+       * valid kernel was set and the data is not smaller than the filters.
+       */
+      bool canProcess(const ipoint& size) const;
+
+      /**
+       * Compute the result.
+       *
+       * @param src matrix to be smoothed and subsampled
+       * @param step subsampling factor in both directions
+       * @param numberOfThreads number of threads to be used (see
+       *        functor::parameters::numberOfThreads)
+       * @param dest result with (src.rows()+step-1)/step rows and
+       *             (src.columns()+step-1)/step columns.  Its memory is
+       *             reused if it already has that size.  It must not be the
+       *             same object as src.
+       */
+      void apply(const matrix<T>& src,
+                 const int step,
+                 const int numberOfThreads,
+                 matrix<T>& dest);
+
+      /**
+       * Number of bytes used by the buffers
+       */
+      int getBufferBytes() const;
+
+    protected:
+      /**
+       * Job computing one band of the result per task
+       */
+      class bandJob;
+      friend class bandJob;
+
+      /**
+       * Compute the result rows from to to-1 using the given buffers
+       */
+      void reduce(const matrix<T>& src,
+                  const int step,
+                  const int from,
+                  const int to,
+                  matrix<T>& ring,
+                  vector<acc_type>& acc,
+                  matrix<T>& dest) const;
+
+      /**
+       * Filter one row of n elements and keep the retained ones
+       */
+      void filterRow(const T* src,
+                     const int n,
+                     const int step,
+                     T* dest,
+                     const int destSize) const;
+
+      /**
+       * First result index of the middle block, where lti::downsampling
+       * accumulates the products in the order of the source elements.
+       * Before it, the order is reversed.
+       */
+      static int firstForward(const int last,const int step);
+
+      /**
+       * Convert an accumulated value into the result type
+       */
+      static inline T result(const acc_type& acc,const acc_type& norm);
+
+      /**
+       * Row and column filters, reversed, i.e. the first element
+       * corresponds to the last kernel index
+       */
+      vector<T> rowFilter_,colFilter_;
+
+      /**
+       * Last indices of the row and column filters
+       */
+      int rowLast_,colLast_;
+
+      /**
+       * Norms of the row and column filters
+       */
+      acc_type rowNorm_,colNorm_;
+
+      /**
+       * Ring buffers of the bands
+       */
+      std::vector< matrix<T> > rings_;
+
+      /**
+       * Accumulators of the bands
+       */
+      std::vector< vector<acc_type> > accs_;
+    };
+
+    /**
+     * Specialization for rgbaPixel, which is not processed by
+     * pyramidReduction: canProcess() always returns false.
+     */
+    template<>
+    class pyramidReduction<rgbaPixel> {
+    public:
+      /**
+       * Kernels for colors are not supported
+       */
+      inline bool setKernel(const container&) {
+        return false;
+      }
+
+      /**
+       * Images cannot be processed
+       */
+      inline bool canProcess(const ipoint&) const {
+        return false;
+      }
+
+      /**
+       * Does nothing
+       */
+      inline void apply(const matrix<rgbaPixel>&,
+                        const int,
+                        const int,
+                        matrix<rgbaPixel>&) {
+      }
+
+      /**
+       * No buffers are used
+       */
+      inline int getBufferBytes() const {
+        return 0;
+      }
+    };
+
+  }
+}
+
+#include "ltiPyramidReduction_template.h"
+
+#endif
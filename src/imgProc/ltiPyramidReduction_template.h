@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+
+/**
+ * \file   ltiPyramidReduction_template.h
+ *         Contains the helper class lti::internal::pyramidReduction, which
+ *         smoothes and subsamples a matrix in one pass.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include "ltiParallelBands.h"
+#include "ltiThreadPool.h"
+#include "ltiMath.h"
+
+namespace lti {
+  namespace internal {
+
+    /*
+     * Job computing one band of the result per task
+     */
+    template<typename T>
+    class pyramidReduction<T>::bandJob : public threadPool::job {
+    public:
+      bandJob(pyramidReduction<T>& owner,
+              const matrix<T>& src,
+              const int step,
+              const bandPartition& bands,
+              matrix<T>& dest)
+        : owner_(owner),src_(src),step_(step),bands_(bands),dest_(dest) {
+      }
+
+      virtual void execute(const int task) {
+        const bandPartition::band& b = bands_.getBand(task);
+        owner_.reduce(src_,step_,b.from,b.to,
+                      owner_.rings_[task],owner_.accs_[task],dest_);
+      }
+
+    private:
+      pyramidReduction<T>& owner_;
+      const matrix<T>& src_;
+      const int step_;
+      const bandPartition& bands_;
+      matrix<T>& dest_;
+    };
+
+    template<typename T>
+    pyramidReduction<T>::pyramidReduction()
+      : rowLast_(0),colLast_(0),rowNorm_(1),colNorm_(1) {
+    }
+
+    template<typename T>
+    bool pyramidReduction<T>::setKernel(const container& kern) {
+      rowFilter_.clear();
+      colFilter_.clear();
+
+      const separableKernel<T>* sep =
+        dynamic_cast<const separableKernel<T>*>(&kern);
+      if (isNull(sep) || (sep->getNumberOfPairs() != 1)) {
+        return false;
+      }
+
+      const kernel1D<T>& row = sep->getRowFilter(0);
+      const kernel1D<T>& col = sep->getColFilter(0);
+      if (row.empty() || col.empty()) {
+        return false;
+      }
+
+      int m;
+      rowFilter_.allocate(row.size());
+      for (m=0;m<row.size();++m) {
+        rowFilter_.at(m) = row.at(row.lastIdx()-m);
+      }
+      colFilter_.allocate(col.size());
+      for (m=0;m<col.size();++m) {
+        colFilter_.at(m) = col.at(col.lastIdx()-m);
+      }
+
+      rowLast_ = row.lastIdx();
+      colLast_ = col.lastIdx();
+      rowNorm_ = static_cast<acc_type>(row.getNorm());
+      colNorm_ = static_cast<acc_type>(col.getNorm());
+
+      return true;
+    }
+
+    template<typename T>
+    bool pyramidReduction<T>::canProcess(const ipoint& size) const {
+      return (!rowFilter_.empty() &&
+              (size.x >= rowFilter_.size()) &&
+              (size.y >= colFilter_.size()));
+    }
+
+    template<typename T>
+    int pyramidReduction<T>::getBufferBytes() const {
+      int bytes = 0;
+      for (unsigned int i=0;i<rings_.size();++i) {
+        bytes += rings_[i].rows()*rings_[i].columns()*sizeof(T) +
+                 accs_[i].size()*sizeof(acc_type);
+      }
+      return bytes;
+    }
+
+    template<typename T>
+    int pyramidReduction<T>::firstForward(const int last,const int step) {
+      int begin = (last < 0) ? -last : 0;
+      if (((begin+last) % step) != 0) {
+        begin += step - ((begin+last) % step);
+      }
+      return (begin+last)/step;
+    }
+
+    template<typename T>
+    inline T pyramidReduction<T>::result(const acc_type& acc,
+                                         const acc_type& norm) {
+      return typeInfo<T>::isFloatingPointType() ?
+        static_cast<T>(acc) : static_cast<T>(acc/norm);
+    }
+
+    template<typename T>
+    void pyramidReduction<T>::filterRow(const T* src,
+                                        const int n,
+                                        const int step,
+                                        T* dest,
+                                        const int destSize) const {
+      const int size = rowFilter_.size();
+      const T* filter = rowFilter_.data();
+      const int first = min(firstForward(rowLast_,step),destSize);
+      const int lastSrc = n-1;
+
+      int i,m,x;
+      acc_type acc;
+
+      // left border: lti::downsampling accumulates in reversed order
+      for (i=0,x=-rowLast_;i<first;++i,x+=step) {
+        acc = acc_type(0);
+        for (m=size-1;m>=0;--m) {
+          acc += static_cast<acc_type>(filter[m]) *
+                 static_cast<acc_type>(src[max(0,min(x+m,lastSrc))]);
+        }
+        dest[i] = result(acc,rowNorm_);
+      }
+
+      // the whole filter fits in the source
+      for (;(i<destSize) && (x+size <= n);++i,x+=step) {
+        const T* s = src+x;
+        acc = acc_type(0);
+        for (m=0;m<size;++m) {
+          acc += static_cast<acc_type>(filter[m])*static_cast<acc_type>(s[m]);
+        }
+        dest[i] = result(acc,rowNorm_);
+      }
+
+      // right border
+      for (;i<destSize;++i,x+=step) {
+        acc = acc_type(0);
+        for (m=0;m<size;++m) {
+          acc += static_cast<acc_type>(filter[m]) *
+                 static_cast<acc_type>(src[max(0,min(x+m,lastSrc))]);
+        }
+        dest[i] = result(acc,rowNorm_);
+      }
+    }
+
+    template<typename T>
+    void pyramidReduction<T>::reduce(const matrix<T>& src,
+                                     const int step,
+                                     const int from,
+                                     const int to,
+                                     matrix<T>& ring,
+                                     vector<acc_type>& acc,
+                                     matrix<T>& dest) const {
+      const int size = colFilter_.size();
+      const T* filter = colFilter_.data();
+      const int cols = dest.columns();
+      const int lastRow = src.lastRow();
+      const int first = firstForward(colLast_,step);
+
+      if ((ring.rows() != size) || (ring.columns() != cols)) {
+        ring.allocate(size,cols);
+      }
+      if (acc.size() != cols) {
+        acc.allocate(cols);
+      }
+
+      // source row kept in each row of the ring buffer
+      std::vector<int> kept(size,-1);
+
+      int x,y,m,r;
+      for (y=from;y<to;++y) {
+        const int y0 = step*y-colLast_;
+
+        // filter the missing source rows horizontally
+        for (m=0;m<size;++m) {
+          r = max(0,min(y0+m,lastRow));
+          if (kept[r%size] != r) {
+            filterRow(src[r].data(),src.columns(),step,
+                      ring[r%size].data(),cols);
+            kept[r%size] = r;
+          }
+        }
+
+        // filter vertically, in the order used by lti::downsampling
+        acc_type* a = acc.data();
+        for (x=0;x<cols;++x) {
+          a[x] = acc_type(0);
+        }
+        for (int k=0;k<size;++k) {
+          m = (y < first) ? size-1-k : k;
+          const acc_type c = static_cast<acc_type>(filter[m]);
+          const T* row = ring[max(0,min(y0+m,lastRow))%size].data();
+          for (x=0;x<cols;++x) {
+            a[x] += c*static_cast<acc_type>(row[x]);
+          }
+        }
+
+        T* d = dest[y].data();
+        for (x=0;x<cols;++x) {
+          d[x] = result(a[x],colNorm_);
+        }
+      }
+    }
+
+    template<typename T>
+    void pyramidReduction<T>::apply(const matrix<T>& src,
+                                    const int step,
+                                    const int numberOfThreads,
+                                    matrix<T>& dest) {
+      const ipoint newSize((src.columns()+step-1)/step,
+                           (src.rows()+step-1)/step);
+      if (dest.size() != newSize) {
+        dest.allocate(newSize);
+      }
+
+      const bandPartition bands(numberOfThreads,newSize,0);
+      const int numBands = bands.getNumberOfBands();
+      if (static_cast<int>(rings_.size()) < numBands) {
+        rings_.resize(numBands);
+        accs_.resize(numBands);
+      }
+
+      if (numBands <= 1) {
+        reduce(src,step,0,newSize.y,rings_[0],accs_[0],dest);
+      } else {
+        bandJob theJob(*this,src,step,bands,dest);
+        threadPool::getShared().run(theJob,numBands,numBands);
+      }
+    }
+
+  }
+}
@@ -46,6 +46,7 @@
 #include "ltiMath.h"
 
 #include <string>
+#include <vector>
 
 namespace lti {
 
@@ -64,6 +65,14 @@ namespace lti {
    * As with other pyramids, the template type T represents the image type.
    * Usually you will want to use an scaleSpacePyramid<channel>.
    *
+   * The object is meant to be kept and reused for a sequence of images,
+   * like the frames of a video: the memory of the levels and of the
+   * smoothing buffers is reused if the size of the images does not change.
+   * The Gaussian smoothing can be computed in parallel bands of rows (see
+   * parameters::numberOfThreads).  The time spent on
+   * each level and the memory used can be queried with getLevelTimes() and
+   * getMemoryUsage().
+   *
    * For this class the term "level" denotes one of the existent layers of
    * the pyramid.  The term "scale" denotes a real value.  The "levels"
    * have explicit scales, that can be obtaind with getLevelScale().
@@ -215,6 +224,16 @@ namespace lti {
        * but with Constant boundaryType.
        */
       typename Inter<value_type>::parameters interpolationParameters;
+
+      /**
+       * Number of threads used to smooth each level (see
+       * lti::functor::parameters::numberOfThreads).  Zero or negative values
+       * use as many threads as processors are available.  The result does
+       * not depend on the number of threads.
+       *
+       * Default value: 1
+       */
+      int numberOfThreads;
     };
 
     /**
@@ -319,6 +338,18 @@ namespace lti {
      */
     void generate(const T& src, const int numLevels);
 
+    /**
+     * Wall time in microseconds spent on each level in the last call of
+     * generate().  The time of level 0 is the one needed to copy the source.
+     */
+    const dvector& getLevelTimes() const;
+
+    /**
+     * Number of bytes used by the levels of the pyramid and by the buffers
+     * kept for the next call of generate().
+     */
+    int getMemoryUsage() const;
+
     /**
      * @name Scale-space access operators
      *
@@ -618,6 +649,18 @@ namespace lti {
      */
     scaling<value_type, Inter> scaler_;
 
+    /**
+     * Time spent on each level in the last generate()
+     */
+    dvector levelTimes_;
+
+    /**
+     * Smoothed levels.  Each one is swapped with the level of the pyramid
+     * after the next level has been computed, so that the memory of both is
+     * reused in the next generate().
+     */
+    std::vector<T> smoothed_;
+
         
     /**
      * Initialize the values for the levelFactor. 
@@ -33,6 +33,7 @@
  */
 
 #include "ltiRound.h"
+#include "ltiTimer.h"
 
 namespace lti {
 
@@ -51,6 +52,7 @@ namespace lti {
     kernelVariance = double(1.6*1.6);
     gaussian = bool(false);
     factor = double(0.793700526); // (0.5^(1/3))
+    numberOfThreads = int(1);
   }
 
   // copy constructor
@@ -98,6 +100,7 @@ namespace lti {
     kernelVariance = other.kernelVariance;
     gaussian = other.gaussian;
     factor = other.factor;
+    numberOfThreads = other.numberOfThreads;
 
     return *this;
   }
@@ -126,6 +129,7 @@ namespace lti {
       lti::write(handler,"kernelVariance",kernelVariance);
       lti::write(handler,
                  "interpolationParameters",interpolationParameters);
+      lti::write(handler,"numberOfThreads",numberOfThreads);
     }
     
     b = b && parametersManager::parameters::write(handler,false);
@@ -155,6 +159,7 @@ namespace lti {
       b = b && lti::read(handler,"kernelVariance",kernelVariance);
       b = b && lti::read(handler,"interpolationParameters",
                          interpolationParameters);
+      b = b && lti::read(handler,"numberOfThreads",numberOfThreads);
     }
     
     b = b && parametersManager::parameters::read(handler,false);
@@ -185,9 +190,11 @@ namespace lti {
   scaleSpacePyramid<T,Inter>::scaleSpacePyramid(const int levels,
                                                 const parameters& par)
     : pyramid<T>(), parametersManager() {
-    
-    resize(levels);
+    interpol_.setBoundaryType(Constant);
+    scaler_.setBoundaryType(Constant);
+    // the parameters are needed to resize the pyramid
     setParameters(par);
+    resize(levels);
   }
 
   // copy constructor
@@ -218,6 +225,7 @@ namespace lti {
     pyramid<T>::copy(other);
     levelFactor_.resize(this->size(),0.0,AllocateOnly);
     initLevelFactor();
+    levelTimes_.copy(other.levelTimes_);
     return (*this);
   }
 
@@ -254,6 +262,23 @@ namespace lti {
   }
 
 
+  template<typename T, template<class> class Inter>
+  const dvector& scaleSpacePyramid<T,Inter>::getLevelTimes() const {
+    return levelTimes_;
+  }
+
+  template<typename T, template<class> class Inter>
+  int scaleSpacePyramid<T,Inter>::getMemoryUsage() const {
+    int bytes = 0;
+    for (int i=0;i<this->size();++i) {
+      bytes += this->at(i).rows()*this->at(i).columns()*sizeof(value_type);
+    }
+    for (unsigned int i=0;i<smoothed_.size();++i) {
+      bytes += smoothed_[i].rows()*smoothed_[i].columns()*sizeof(value_type);
+    }
+    return bytes;
+  }
+
   // update parameters
   template<typename T, template<class> class Inter>
   bool scaleSpacePyramid<T,Inter>::updateParameters() {
@@ -364,12 +389,23 @@ namespace lti {
     convolution::parameters convPar;
     convPar.setKernel(gaussKernel2D<float>(kernelS,kernelVar));
     convPar.boundaryType = Constant;
+    convPar.numberOfThreads = param.numberOfThreads;
     convolution fil(convPar);
 
-    // get the source at level 0
+    if (smoothed_.size() != static_cast<unsigned int>(this->size())) {
+      smoothed_.resize(this->size());
+    }
+
+    timer chron(timer::Wall);
+    levelTimes_.assign(this->size(),0.0);
+
+    // get the source at level 0 (its memory is reused if the size does not
+    // change)
+    chron.start();
     this->at(0).copy(src);
+    chron.stop();
+    levelTimes_.at(0) = chron.getTime();
 
-    T tmp;
     int i;
     
     // generate each level of the pyramid  
@@ -378,18 +414,29 @@ namespace lti {
     point<float> scalingFactor;
 
     for (i = 1; i < this->size(); i++) {
+      chron.start();
       if (param.gaussian) {
-        fil.apply(this->at(i-1)); // smooth the current channel with a gaussian
+        // smooth the current level into its buffer
+        fil.apply(this->at(i-1),smoothed_[i-1]);
       }
+      const T& level = param.gaussian ? smoothed_[i-1] : this->at(i-1);
 
       scalingFactor.x = static_cast<float>(this->at(0).size().x*
                                            levelFactor_.at(i)/
-                                           this->at(i-1).size().x);
+                                           level.size().x);
       scalingFactor.y = static_cast<float>(this->at(0).size().y*
                                            levelFactor_.at(i)/
-                                           this->at(i-1).size().y);
+                                           level.size().y);
+
+      scaler_.scale(scalingFactor,level,this->at(i));
 
-      scaler_.scale(scalingFactor,this->at(i-1),this->at(i));
+      if (param.gaussian) {
+        // the smoothed level replaces the original one, whose memory is
+        // used for the smoothing in the next call
+        smoothed_[i-1].swap(this->at(i-1));
+      }
+      chron.stop();
+      levelTimes_.at(i) = chron.getTime();
     }
   }
 
@@ -405,7 +452,8 @@ namespace lti {
    */
   template<typename T, template<class> class Inter>
   void scaleSpacePyramid<T,Inter>::generate(const T& src, const int theResolutions) {
-    resize(theResolutions, false);
+    // keep the existing levels, whose memory will be reused
+    resize(theResolutions, true);
     generate(src);
   }
 
@@ -38,6 +38,8 @@
 #include "ltiInterpolatedCyclicHistogramAccumulator.h"
 
 #include "ltiFactory.h"
+#include "ltiGradientFunctor.h"
+#include "ltiThreadPool.h"
 
 #include "ltiLocalSampling_template.h"
 // ^ this include is important, otherwise the compiler cannot compile the right
@@ -66,6 +68,7 @@ namespace lti {
     normalize     = true;
     useClipping   = true;
     clippingValue = 0.2;
+    quantizationFactor = 1275.0f;
   }
 
   // copy constructor
@@ -91,6 +94,7 @@ namespace lti {
     normalize     = other.normalize;
     useClipping   = other.useClipping;
     clippingValue = other.clippingValue;
+    quantizationFactor = other.quantizationFactor;
 
     return *this;
   }
@@ -158,6 +162,7 @@ namespace lti {
       lti::write(handler,"normalize",normalize);
       lti::write(handler,"useClipping",useClipping);
       lti::write(handler,"clippingValue",clippingValue);
+      lti::write(handler,"quantizationFactor",quantizationFactor);
     }
 
     b = b && localDescriptorExtraction::parameters::write(handler,false);
@@ -201,6 +206,7 @@ namespace lti {
       lti::read(handler,"normalize",normalize);
       lti::read(handler,"useClipping",useClipping);
       lti::read(handler,"clippingValue",clippingValue);
+      lti::read(handler,"quantizationFactor",quantizationFactor);
     }
 
     b = b && localDescriptorExtraction::parameters::read(handler,false);
@@ -500,6 +506,245 @@ namespace lti {
     return rc;
   }// apply
 
+  // -------------------------------------------------------------------
+  // Batch computation
+  // -------------------------------------------------------------------
+
+  namespace internal {
+    /*
+     * Store the descriptor in the row.  The float version just casts the
+     * values.
+     */
+    inline void siftStore(const dvector& d,const float,float* row) {
+      for (int i=0;i<d.size();++i) {
+        row[i]=static_cast<float>(d.at(i));
+      }
+    }
+
+    /*
+     * The ubyte version quantizes the values with the given factor.
+     */
+    inline void siftStore(const dvector& d,const float factor,ubyte* row) {
+      for (int i=0;i<d.size();++i) {
+        const double val = factor*d.at(i);
+        row[i]=(val <= 0.0) ? 0 :
+          ((val >= 255.0) ? 255 : static_cast<ubyte>(val+0.5));
+      }
+    }
+  }
+
+  /*
+   * Job computing the descriptors of a range of locations in each task.
+   * Each task uses its own accumulator.
+   */
+  template<class Acc,typename U>
+  class siftDescriptorExtraction::batchJob : public threadPool::job {
+  public:
+    /*
+     * Constructor
+     */
+    batchJob(const siftDescriptorExtraction& owner,
+             const siftSampling& sampling,
+             const Acc& accu,
+             const matrix<float>& keys,
+             const matrix<float>& values,
+             const std::vector<location>& refs,
+             const int numTasks,
+             matrix<U>& dest)
+      : ok(numTasks,1),owner_(owner),sampling_(sampling),accu_(accu),
+        keys_(keys),values_(values),refs_(refs),numTasks_(numTasks),
+        dest_(dest) {
+    }
+
+    /*
+     * Describe the locations of the task
+     */
+    virtual void execute(const int task) {
+      // the first location has already been described
+      const int n = static_cast<int>(refs_.size())-1;
+      const int from = 1+(task*n)/numTasks_;
+      const int to = 1+((task+1)*n)/numTasks_;
+      const float factor = owner_.getParameters().quantizationFactor;
+
+      Acc accu(accu_);
+      dvector d;
+      for (int i=from;i<to;++i) {
+        if (sampling_.apply(accu,keys_,values_,refs_[i],d) &&
+            (d.size() == dest_.columns())) {
+          owner_.normalizeAndClip(d);
+          internal::siftStore(d,factor,dest_[i].data());
+        } else {
+          ok[task]=0;
+        }
+      }
+    }
+
+    /*
+     * Zero for each task in which a location could not be described.
+     *
+     * One char per task and not std::vector<bool>, whose packed bits
+     * would be written concurrently by the tasks.
+     */
+    std::vector<char> ok;
+
+  private:
+    const siftDescriptorExtraction& owner_;
+    const siftSampling& sampling_;
+    const Acc& accu_;
+    const matrix<float>& keys_;
+    const matrix<float>& values_;
+    const std::vector<location>& refs_;
+    const int numTasks_;
+    matrix<U>& dest_;
+  };
+
+  template<class Acc,typename U>
+  bool siftDescriptorExtraction::batch(const Acc& accu,
+                                       const matrix<float>& keys,
+                                       const matrix<float>& values,
+                                       const list<location>& locs,
+                                       matrix<U>& dest) const {
+    const parameters& par = getParameters();
+    localSampling* ls = par.getSampling();
+    
+    // check sampling
+    if (ls == 0) {
+      setStatusString("Invalid sampling (null pointer)\n");
+      return false;
+    }
+
+    if (locs.empty()) {
+      dest.clear();
+      return true;
+    }
+
+    const std::vector<location> refs(locs.begin(),locs.end());
+    const int numLocs = static_cast<int>(refs.size());
+
+    // the first descriptor determines the size of the matrix
+    Acc first(accu);
+    dvector d;
+    if (!ls->apply(first,keys,values,refs[0],d)) {
+      return false;
+    }
+    normalizeAndClip(d);
+    dest.allocate(numLocs,d.size());
+    internal::siftStore(d,par.quantizationFactor,dest[0].data());
+
+    const siftSampling* sift = dynamic_cast<const siftSampling*>(ls);
+    if (isNull(sift)) {
+      // other samplings are not reentrant, use only this thread
+      bool rc = true;
+      for (int i=1;i<numLocs;++i) {
+        Acc acc(accu);
+        if (ls->apply(acc,keys,values,refs[i],d) &&
+            (d.size() == dest.columns())) {
+          normalizeAndClip(d);
+          internal::siftStore(d,par.quantizationFactor,dest[i].data());
+        } else {
+          rc = false;
+        }
+      }
+      return rc;
+    }
+
+    if (numLocs > 1) {
+      const int threads = threadPool::computeThreads(par.numberOfThreads);
+      const int tasks = min(numLocs-1,(threads > 1) ? 8*threads : 1);
+      batchJob<Acc,U> job(*this,*sift,accu,keys,values,refs,tasks,dest);
+      threadPool::getShared().run(job,tasks,threads);
+
+      for (int i=0;i<tasks;++i) {
+        if (job.ok[i] == 0) {
+          setStatusString("Some locations could not be described");
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  template<typename U>
+  bool siftDescriptorExtraction::batch(const matrix<float>& keys,
+                                       const matrix<float>& values,
+                                       const list<location>& locs,
+                                       matrix<U>& dest) const {
+    const parameters& par = getParameters();
+
+    // apply desired template function
+    switch (par.accuType) {
+      case Histogram: {
+        histogramAccumulator<float> accu(par.histogramBins,
+                                         par.histLow,
+                                         par.histHigh);
+        return batch(accu,keys,values,locs,dest);
+      }
+      case InterpolatedHistogram: {
+        interpolatedHistogramAccumulator<float> accu(par.histogramBins,
+                                                     par.histLow,
+                                                     par.histHigh);
+        return batch(accu,keys,values,locs,dest);
+      }
+      case InterpolatedCyclicHistogram: {
+        interpolatedCyclicHistogramAccumulator<float> accu(par.histogramBins,
+                                                           par.histLow,
+                                                           par.histHigh);
+        return batch(accu,keys,values,locs,dest);
+      }
+      default: {
+        // default
+        setStatusString("Invalid accuType (not known)\n");
+      }
+    } // switch
+
+    return false;
+  }
+
+  bool siftDescriptorExtraction::apply(const matrix<float>& keys,
+                                       const matrix<float>& values,
+                                       const list<location>& locs,
+                                       fmatrix& dest) const {
+    return batch(keys,values,locs,dest);
+  }
+
+  bool siftDescriptorExtraction::apply(const matrix<float>& keys,
+                                       const matrix<float>& values,
+                                       const list<location>& locs,
+                                       matrix<ubyte>& dest) const {
+    return batch(keys,values,locs,dest);
+  }
+
+  bool siftDescriptorExtraction::applyGradient(const channel& src,
+                                               const list<location>& locs,
+                                               fmatrix& dest) const {
+    // the gradient is shared by all locations
+    gradientFunctor::parameters gradPar;
+    gradPar.format = gradientFunctor::Polar;
+    gradientFunctor grad(gradPar);
+    channel mag,arg;
+    if (!grad.apply(src,mag,arg)) {
+      setStatusString(grad.getStatusString());
+      return false;
+    }
+    return batch(arg,mag,locs,dest);
+  }
+
+  bool siftDescriptorExtraction::applyGradient(const channel& src,
+                                               const list<location>& locs,
+                                               matrix<ubyte>& dest) const {
+    // the gradient is shared by all locations
+    gradientFunctor::parameters gradPar;
+    gradPar.format = gradientFunctor::Polar;
+    gradientFunctor grad(gradPar);
+    channel mag,arg;
+    if (!grad.apply(src,mag,arg)) {
+      setStatusString(grad.getStatusString());
+      return false;
+    }
+    return batch(arg,mag,locs,dest);
+  }
+
   void siftDescriptorExtraction::normalizeAndClip(dvector& descr) const {
     
     const parameters& param=getParameters();
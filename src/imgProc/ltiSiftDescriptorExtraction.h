@@ -95,6 +95,13 @@ namespace lti {
    *
    * \endcode
    *
+   * To describe many locations of the same image, the batch methods are
+   * more efficient.  They compute the gradient of the image only once,
+   * write the descriptors into the rows of a contiguous float or quantized
+   * ubyte matrix, and distribute the locations among several threads
+   * according to functor::parameters::numberOfThreads.  Only lti::siftSampling
+   * is used in parallel; other samplings are applied in the calling thread.
+   *
    * @see siftDescriptorExtraction::parameters.
    *
    *
@@ -238,6 +245,17 @@ namespace lti {
        * Default: 0.2 (as suggested by Lowe)
        */
       double clippingValue;
+
+      /**
+       * Factor used to quantize the descriptors in the batch methods with
+       * matrix<ubyte> results.  Each element of the (normalized and clipped)
+       * descriptor is multiplied by this factor, rounded and saturated to
+       * the range from 0 to 255.
+       *
+       * Default: 1275 (i.e. 255/0.2, so that the default clipping value is
+       * mapped to the end of the range)
+       */
+      float quantizationFactor;
     };
 
     /**
@@ -315,6 +333,89 @@ namespace lti {
      */
     bool apply(const matrix<float>& src,
                dvector& dest);
+
+    /**
+     * @name Batch descriptor extraction
+     *
+     * These methods write the descriptor of the i-th location of the list
+     * into the i-th row of the given matrix.  If the matrix already has the
+     * right size, its memory is reused.  The locations are distributed among
+     * the threads of the shared lti::threadPool, and the result does not
+     * depend on the number of threads.
+     */
+    //@{
+
+    /**
+     * Compute the descriptors of all locations from the given keys and
+     * values, which are shared by all locations.
+     *
+     * @param keys this channel determines to which bin a particular value
+     * is added. (e.g. gradient orientation).
+     * @param values channel with the values added to a particular bin. 
+     * (e.g. gradient magnitude)
+     * @param locs locations to be described.
+     * @param dest the i-th row contains the descriptor of the i-th location.
+     * @return true if apply successful or false otherwise.
+     */
+    bool apply(const matrix<float>& keys,
+               const matrix<float>& values, 
+               const list<location>& locs,
+               fmatrix& dest) const;
+
+    /**
+     * Compute the quantized descriptors of all locations from the given keys
+     * and values, which are shared by all locations.
+     *
+     * @param keys this channel determines to which bin a particular value
+     * is added. (e.g. gradient orientation).
+     * @param values channel with the values added to a particular bin. 
+     * (e.g. gradient magnitude)
+     * @param locs locations to be described.
+     * @param dest the i-th row contains the descriptor of the i-th location,
+     *             quantized with parameters::quantizationFactor.
+     * @return true if apply successful or false otherwise.
+     */
+    bool apply(const matrix<float>& keys,
+               const matrix<float>& values, 
+               const list<location>& locs,
+               matrix<ubyte>& dest) const;
+
+    /**
+     * Compute the descriptors of all locations of the given channel.
+     *
+     * The gradient orientation (keys) and magnitude (values) of \a src are
+     * computed once with lti::gradientFunctor and shared by all locations.
+     * Unlike apply(const matrix<float>&,const location&,dvector&), which
+     * samples \a src itself, the descriptors describe its gradient.
+     *
+     * @param src channel with source data.
+     * @param locs locations to be described.
+     * @param dest the i-th row contains the descriptor of the i-th location.
+     * @return true if apply successful or false otherwise.
+     */
+    bool applyGradient(const channel& src,
+                       const list<location>& locs,
+                       fmatrix& dest) const;
+
+    /**
+     * Compute the quantized descriptors of all locations of the given
+     * channel.
+     *
+     * The gradient orientation (keys) and magnitude (values) of \a src are
+     * computed once with lti::gradientFunctor and shared by all locations.
+     * Unlike apply(const matrix<float>&,const location&,dvector&), which
+     * samples \a src itself, the descriptors describe its gradient.
+     *
+     * @param src channel with source data.
+     * @param locs locations to be described.
+     * @param dest the i-th row contains the descriptor of the i-th location,
+     *             quantized with parameters::quantizationFactor.
+     * @return true if apply successful or false otherwise.
+     */
+    bool applyGradient(const channel& src,
+                       const list<location>& locs,
+                       matrix<ubyte>& dest) const;
+    //@}
     
 
     /**
@@ -359,6 +460,32 @@ namespace lti {
      */
     void normalizeAndClip(dvector& descriptor) const;
 
+    /**
+     * Dispatch the batch computation according to parameters::accuType
+     */
+    template<typename U>
+    bool batch(const matrix<float>& keys,
+               const matrix<float>& values, 
+               const list<location>& locs,
+               matrix<U>& dest) const;
+
+    /**
+     * Batch computation with the given accumulator
+     */
+    template<class Acc,typename U>
+    bool batch(const Acc& accu,
+               const matrix<float>& keys,
+               const matrix<float>& values, 
+               const list<location>& locs,
+               matrix<U>& dest) const;
+
+    /**
+     * Job computing the descriptors of a range of locations in each task
+     */
+    template<class Acc,typename U>
+    class batchJob;
+    template<class Acc,typename U>
+    friend class batchJob;
 
   };
 } // namespace
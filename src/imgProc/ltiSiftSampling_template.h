@@ -178,7 +178,7 @@ namespace lti {
     const int cy = iround(size.y/2);
 
     //create accumulators
-    static std::vector<Acc> accuVec(bins2);
+    std::vector<Acc> accuVec(bins2);
 
     // resize accuvector
     _lti_debug("resizing...");
@@ -274,7 +274,7 @@ namespace lti {
     const int cy = iround(size.y/2);
 
     //create accumulators
-    static std::vector<Acc> accuVec(bins2);
+    std::vector<Acc> accuVec(bins2);
 
     // resize accuvector
     _lti_debug("resizing...");
@@ -366,7 +366,7 @@ namespace lti {
     const float angle = loc.angle;
 
     //create accumulators
-    static std::vector<Acc> accuVec(bins2);
+    std::vector<Acc> accuVec(bins2);
 
     // resize accuvector
     _lti_debug("resizing...");
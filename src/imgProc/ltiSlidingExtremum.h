@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+
+/**
+ * \file   ltiSlidingExtremum.h
+ *         Contains the helper class lti::internal::slidingExtremum, which
+ *         computes the minimum or maximum within a sliding flat window
+ *         with the van Herk/Gil-Werman algorithm.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#ifndef _LTI_SLIDING_EXTREMUM_H_
+#define _LTI_SLIDING_EXTREMUM_H_
+
+#include "ltiMatrix.h"
+#include "ltiBoundaryType.h"
+#include "ltiSimd.h"
+#include <limits>
+#include <vector>
+#include <cstring>
+
+namespace lti {
+  namespace internal {
+
+    /**
+     * Policy for slidingExtremum computing the maximum
+     */
+    template<typename T>
+    struct maximumOperator {
+      /**
+       * Maximum of two scalars
+       */
+      static inline T scalar(const T a,const T b) {
+        return (a<b) ? b : a;
+      }
+
+      /**
+       * Maximum of two SIMD registers
+       */
+      static inline typename simd<T>::reg
+      packed(const typename simd<T>::reg& a,
+             const typename simd<T>::reg& b) {
+        return simd<T>::max(a,b);
+      }
+
+      /**
+       * Neutral element, i.e. the smallest value of the type
+       */
+      static inline T neutral() {
+        return std::numeric_limits<T>::is_integer ?
+          std::numeric_limits<T>::min() : -std::numeric_limits<T>::max();
+      }
+    };
+
+    /**
+     * Policy for slidingExtremum computing the minimum
+     */
+    template<typename T>
+    struct minimumOperator {
+      /**
+       * Minimum of two scalars
+       */
+      static inline T scalar(const T a,const T b) {
+        return (b<a) ? b : a;
+      }
+
+      /**
+       * Minimum of two SIMD registers
+       */
+      static inline typename simd<T>::reg
+      packed(const typename simd<T>::reg& a,
+             const typename simd<T>::reg& b) {
+        return simd<T>::min(a,b);
+      }
+
+      /**
+       * Neutral element, i.e. the greatest value of the type
+       */
+      static inline T neutral() {
+        return std::numeric_limits<T>::max();
+      }
+    };
+
+    /**
+     * Sliding window minimum or maximum.
+     *
+     * This class computes
+     * \f[
+     * \text{dest}(x) = \mathop{\text{Op}}_{s=\text{first}}^{\text{last}}
+     * \left\{\text{src}(x-s)\right\}
+     * \f]
+     * for a flat window [first,last], which must contain the origin, with the
+     * algorithm of van Herk and Gil-Werman:  the (extended) data is split
+     * into blocks with the size of the window, and the results are
+     * combined from the prefix extrema and the suffix extrema of these
+     * blocks.  It requires about three comparisons per element independently
+     * of the window size.
+     *
+     * The columns of a matrix are processed with whole rows at once, using
+     * the SIMD instructions of lti::internal::simd where available.
+     *
+     * The data outside the boundaries is defined by an eBoundaryType:
+     * - Zero takes a constant value given to the constructor (zero for the
+     *   minimum and maximum filters, or the neutral element of Op for the
+     *   morphological operators, for which the data outside is ignored).
+     * - Constant repeats the first and last elements.
+     * - Periodic assumes a periodic continuation of the data.
+     * - Mirror reflects the data.  If mirrorEdge is true the border
+     *   elements are repeated, i.e. src(-m) = src(m-1) and
+     *   src(n-1+m) = src(n-m), as in the minimum and maximum filters.
+     *   Otherwise the reflection axes are the border elements themselves,
+     *   i.e. src(-m) = src(m) and src(n-1+m) = src(n-1-m), as in the
+     *   two-dimensional kernels of lti::convHelper2D.
+     *
+     * NoBoundary is not supported: the filters leave the border of the
+     * result as it was, which this class cannot do, so they keep their own
+     * code for it (see canProcess()).
+     *
+     * @param T type of the elements
+     * @param Op policy with the operation (maximumOperator or
+     *           minimumOperator)
+     */
+    template<typename T,class Op>
+    class slidingExtremum {
+    public:
+      /**
+       * Constructor
+       *
+       * @param first first index of the window (less or equal zero)
+       * @param last last index of the window (greater or equal zero)
+       * @param boundaryType how to treat the data outside
+       * @param zero value outside the data for the Zero boundary
+       * @param mirrorEdge if true, the Mirror boundary repeats the border
+       *                   elements (see class description)
+       */
+      slidingExtremum(const int first,
+                      const int last,
+                      const eBoundaryType boundaryType,
+                      const T zero,
+                      const bool mirrorEdge);
+
+      /**
+       * Return true if the window is valid (contains the origin) and
+       * sequences of n elements can be processed.  For the Mirror and
+       * Periodic boundaries the window cannot be greater than n.  The
+       * NoBoundary type is never processed.
+       */
+      bool canProcess(const int n) const;
+
+      /**
+       * Compute the extrema of a sequence of n elements.  The src and dest
+       * arrays must not overlap.
+       */
+      void apply(const T* src,const int n,T* dest);
+
+      /**
+       * Compute the extrema along each row of the matrix.
+       */
+      void applyRows(const matrix<T>& src,matrix<T>& dest);
+
+      /**
+       * Compute the extrema along each column of the matrix.
+       */
+      void applyColumns(const matrix<T>& src,matrix<T>& dest);
+
+    protected:
+      /**
+       * Index of the source element used for the extended index i, which
+       * can be outside [0,n).  Returns -1 for the Zero boundary outside.
+       */
+      inline int sourceIndex(int i,const int n) const;
+
+      /**
+       * dest(i) = Op(a(i),b(i)) for n elements
+       */
+      static inline void combine(const T* a,const T* b,T* dest,const int n);
+
+      /**
+       * First index of the window
+       */
+      int first_;
+
+      /**
+       * Last index of the window
+       */
+      int last_;
+
+      /**
+       * Window size
+       */
+      int size_;
+
+      /**
+       * Boundary type
+       */
+      eBoundaryType boundaryType_;
+
+      /**
+       * Value outside for the Zero boundary
+       */
+      T zero_;
+
+      /**
+       * Mirror convention
+       */
+      bool mirrorEdge_;
+
+      /**
+       * Extended data of one row
+       */
+      vector<T> ext_;
+
+      /**
+       * Two rows for the running extrema and one row with the zero value
+       */
+      vector<T> rowBuffer_,zeroRow_;
+    };
+
+  }
+}
+
+#include "ltiSlidingExtremum_template.h"
+
+#endif
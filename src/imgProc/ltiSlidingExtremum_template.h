@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+
+/**
+ * \file   ltiSlidingExtremum_template.h
+ *         Contains the helper class lti::internal::slidingExtremum, which
+ *         computes the minimum or maximum within a sliding flat window
+ *         with the van Herk/Gil-Werman algorithm.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+namespace lti {
+  namespace internal {
+
+    template<typename T,class Op>
+    slidingExtremum<T,Op>::slidingExtremum(const int first,
+                                           const int last,
+                                           const eBoundaryType boundaryType,
+                                           const T zero,
+                                           const bool mirrorEdge)
+      : first_(first),last_(last),size_(last-first+1),
+        boundaryType_(boundaryType),zero_(zero),mirrorEdge_(mirrorEdge) {
+    }
+
+    template<typename T,class Op>
+    bool slidingExtremum<T,Op>::canProcess(const int n) const {
+      if ((first_ > 0) || (last_ < 0) || (n <= 0) ||
+          (boundaryType_ == NoBoundary)) {
+        return false;
+      }
+      if ((boundaryType_ == Mirror) || (boundaryType_ == Periodic)) {
+        return (size_ <= n);
+      }
+      return true;
+    }
+
+    template<typename T,class Op>
+    inline int slidingExtremum<T,Op>::sourceIndex(int i,const int n) const {
+      if (i < 0) {
+        switch (boundaryType_) {
+          case Zero:
+            return -1;
+          case Mirror:
+            return mirrorEdge_ ? -i-1 : -i;
+          case Periodic:
+            return i+n;
+          default: // Constant
+            return 0;
+        }
+      } else if (i >= n) {
+        switch (boundaryType_) {
+          case Zero:
+            return -1;
+          case Mirror:
+            return mirrorEdge_ ? 2*n-1-i : 2*n-2-i;
+          case Periodic:
+            return i-n;
+          default: // Constant
+            return n-1;
+        }
+      }
+      return i;
+    }
+
+    template<typename T,class Op>
+    inline void slidingExtremum<T,Op>::combine(const T* a,
+                                               const T* b,
+                                               T* dest,
+                                               const int n) {
+      typedef simd<T> S;
+      int i=0;
+      if (S::accelerated) {
+        for (;i+S::width<=n;i+=S::width) {
+          S::store(dest+i,Op::packed(S::load(a+i),S::load(b+i)));
+        }
+      }
+      for (;i<n;++i) {
+        dest[i]=Op::scalar(a[i],b[i]);
+      }
+    }
+
+    template<typename T,class Op>
+    void slidingExtremum<T,Op>::apply(const T* src,const int n,T* dest) {
+      // the extended data: ext(t) = src(t-last), for t in [0,n+size-1)
+      const int len = n+size_-1;
+      ext_.allocate(len);
+      T* ext = ext_.data();
+      int t,i;
+      for (t=0;t<last_;++t) {
+        i = sourceIndex(t-last_,n);
+        ext[t] = (i<0) ? zero_ : src[i];
+      }
+      for (i=0;i<n;++i,++t) {
+        ext[t] = src[i];
+      }
+      for (;t<len;++t) {
+        i = sourceIndex(t-last_,n);
+        ext[t] = (i<0) ? zero_ : src[i];
+      }
+
+      // suffix extrema of each block
+      int b,e;
+      T acc;
+      for (b=0;b<len;b+=size_) {
+        e = min(b+size_,len)-1;
+        acc = ext[e];
+        for (t=e;t>=b;--t) {
+          acc = Op::scalar(acc,ext[t]);
+          if (t<n) {
+            dest[t]=acc;
+          }
+        }
+      }
+
+      // combined with the prefix extrema of each block
+      acc = ext[0];
+      for (t=0;t<len;++t) {
+        acc = ((t%size_) == 0) ? ext[t] : Op::scalar(acc,ext[t]);
+        if (t >= size_-1) {
+          dest[t-size_+1] = Op::scalar(dest[t-size_+1],acc);
+        }
+      }
+    }
+
+    template<typename T,class Op>
+    void slidingExtremum<T,Op>::applyRows(const matrix<T>& src,
+                                          matrix<T>& dest) {
+      const int n = src.columns();
+      if (&src == &dest) {
+        vector<T> tmp;
+        for (int y=0;y<src.rows();++y) {
+          tmp.copy(src.getRow(y));
+          apply(tmp.data(),n,dest.getRow(y).data());
+        }
+      } else {
+        dest.allocate(src.size());
+        for (int y=0;y<src.rows();++y) {
+          apply(src.getRow(y).data(),n,dest.getRow(y).data());
+        }
+      }
+    }
+
+    template<typename T,class Op>
+    void slidingExtremum<T,Op>::applyColumns(const matrix<T>& srcMat,
+                                             matrix<T>& dest) {
+      if (&srcMat == &dest) {
+        matrix<T> tmp(srcMat);
+        applyColumns(tmp,dest);
+        return;
+      }
+
+      const int n = srcMat.rows();
+      const int cols = srcMat.columns();
+      const int len = n+size_-1;
+      dest.allocate(srcMat.size());
+      rowBuffer_.allocate(cols);
+      if (boundaryType_ == Zero) {
+        zeroRow_.assign(cols,zero_);
+      }
+
+      // the extended data are the rows ext(t) = src(t-last), for t in
+      // [0,n+size-1), given by pointers to the source rows
+      std::vector<const T*> ext(len);
+      int t,i;
+      for (t=0;t<len;++t) {
+        i = sourceIndex(t-last_,n);
+        ext[t] = (i<0) ? zeroRow_.data() : srcMat.getRow(i).data();
+      }
+
+      // suffix extrema of each block.  The rows beyond the result are
+      // accumulated in the row buffer
+      int b,e;
+      T* acc;
+      T* buf = rowBuffer_.data();
+      for (b=0;b<len;b+=size_) {
+        e = min(b+size_,len)-1;
+        acc = (e<n) ? dest.getRow(e).data() : buf;
+        memcpy(acc,ext[e],cols*sizeof(T));
+        for (t=e-1;t>=b;--t) {
+          T* out = (t<n) ? dest.getRow(t).data() : buf;
+          combine(acc,ext[t],out,cols);
+          acc = out;
+        }
+      }
+
+      // combined with the prefix extrema of each block
+      const T* pre = ext[0];
+      for (t=0;t<len;++t) {
+        if ((t%size_) == 0) {
+          pre = ext[t];
+        } else {
+          combine(pre,ext[t],buf,cols);
+          pre = buf;
+        }
+        if (t >= size_-1) {
+          T* d = dest.getRow(t-size_+1).data();
+          combine(d,pre,d,cols);
+        }
+      }
+    }
+
+  }
+}
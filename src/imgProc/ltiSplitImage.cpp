@@ -40,8 +40,62 @@
 
 namespace lti {
 
+  // --------------------------------------------------
+  // splitImage::parameters
+  // --------------------------------------------------
+
+  // default constructor
+  splitImage::parameters::parameters()
+    : functor::parameters() {
+  }
+
+  // copy constructor
+  splitImage::parameters::parameters(const parameters& other)
+    : functor::parameters() {
+    copy(other);
+  }
+
+  // destructor
+  splitImage::parameters::~parameters() {
+  }
+
+  // copy member
+  splitImage::parameters&
+  splitImage::parameters::copy(const parameters& other) {
+    functor::parameters::copy(other);
+
+    return *this;
+  }
+
+  // alias for copy member
+  splitImage::parameters&
+  splitImage::parameters::operator=(const parameters& other) {
+    return copy(other);
+  }
+
+  // class name
+  const std::string& splitImage::parameters::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone member
+  splitImage::parameters* splitImage::parameters::clone() const {
+    return new parameters(*this);
+  }
+
+  // new instance
+  splitImage::parameters* splitImage::parameters::newInstance() const {
+    return new parameters();
+  }
+
+  // --------------------------------------------------
+  // splitImage
+  // --------------------------------------------------
+
   // default constructor
   splitImage::splitImage() : functor() {
+    parameters defaultParameters;
+    setParameters(defaultParameters);
   }
 
   // copy constructor
@@ -34,6 +34,7 @@
 
 
 #include "ltiSplitImageToCIELab.h"
+#include "ltiParallelBands.h"
 #include "ltiFactory.h"
 
 
@@ -138,6 +139,11 @@ namespace lti {
                                  matrix<float>& c1,
                                  matrix<float>& c2,
                                  matrix<float>& c3) const {
+    parallelBands<splitImageToCIELab> bands(*this,img.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.split(img,c1,c2,c3);
+    }
+
 
     // make the channels size of source image...
     c1.allocate(img.size()); // L
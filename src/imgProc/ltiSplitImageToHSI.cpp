@@ -33,6 +33,7 @@
  */
 
 #include "ltiSplitImageToHSI.h"
+#include "ltiParallelBands.h"
 #include "ltiConstants.h"
 #include "ltiRound.h"
 #include "ltiFactory.h"
@@ -91,6 +92,11 @@ namespace lti {
                               matrix<channel::value_type>& c1,
                               matrix<channel::value_type>& c2,
                               matrix<channel::value_type>& c3) const {
+    parallelBands<splitImageToHSI> bands(*this,img.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.split(img,c1,c2,c3);
+    }
+
     int x,y;      // coords
 
     const int rows = img.rows();
@@ -153,6 +159,11 @@ namespace lti {
                               matrix<channel8::value_type>& c1,
                               matrix<channel8::value_type>& c2,
                               matrix<channel8::value_type>& c3) const {
+    parallelBands<splitImageToHSI> bands(*this,img.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.split(img,c1,c2,c3);
+    }
+
     int x,y;      //coords
 
     const int rows = img.rows();
@@ -51,6 +51,7 @@
  */
 
 #include "ltiSplitImageToHSV.h"
+#include "ltiParallelBands.h"
 #include "ltiConstants.h"
 #include "ltiRound.h"
 #include "ltiFactory.h"
@@ -109,6 +110,11 @@ namespace lti {
                               matrix<channel::value_type>& c1,
                               matrix<channel::value_type>& c2,
                               matrix<channel::value_type>& c3) const {
+    parallelBands<splitImageToHSV> bands(*this,img.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.split(img,c1,c2,c3);
+    }
+
     ipoint p;        // coordinates
     rgbaPixel pix;   // single Pixel Element in RGB-values...
 
@@ -168,6 +174,11 @@ namespace lti {
                               matrix<channel8::value_type>& c1,
                               matrix<channel8::value_type>& c2,
                               matrix<channel8::value_type>& c3) const {
+    parallelBands<splitImageToHSV> bands(*this,img.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.split(img,c1,c2,c3);
+    }
+
     ipoint p;        // coordinates
     rgbaPixel pix;   // single Pixel Element in RGB-values...
 
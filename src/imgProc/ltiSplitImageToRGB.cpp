@@ -35,6 +35,7 @@
  */
 
 #include "ltiSplitImageToRGB.h"
+#include "ltiParallelBands.h"
 #include "ltiFactory.h"
 
 namespace lti {
@@ -106,6 +107,11 @@ namespace lti {
                               matrix<channel::value_type>& c1,
                               matrix<channel::value_type>& c2,
                               matrix<channel::value_type>& c3) const {
+    parallelBands<splitImageToRGB> bands(*this,img.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.split(img,c1,c2,c3);
+    }
+
     const int rows=img.rows();
     const int cols=img.columns();
     int i,j;
@@ -165,6 +171,11 @@ namespace lti {
                               matrix<channel8::value_type>& c1,
                               matrix<channel8::value_type>& c2,
                               matrix<channel8::value_type>& c3) const {
+    parallelBands<splitImageToRGB> bands(*this,img.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.split(img,c1,c2,c3);
+    }
+
     int i,j;
     const int rows=img.rows();
     const int cols=img.columns();
@@ -34,6 +34,7 @@
 
 
 #include "ltiSplitImageToXYZ.h"
+#include "ltiParallelBands.h"
 #include "ltiConstants.h"
 #include "ltiFactory.h"
 
@@ -65,6 +66,11 @@ namespace lti {
                               matrix<float>& c1,
                               matrix<float>& c2,
                               matrix<float>& c3) const {
+    parallelBands<splitImageToXYZ> bands(*this,img.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.split(img,c1,c2,c3);
+    }
+
 
     ipoint p;      // coordinates
 
@@ -105,6 +111,11 @@ namespace lti {
                               matrix<ubyte>& c1,
                               matrix<ubyte>& c2,
                               matrix<ubyte>& c3) const {
+    parallelBands<splitImageToXYZ> bands(*this,img.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.split(img,c1,c2,c3);
+    }
+
     ipoint p;      // coordinates
 
     // make the channels size of source image...
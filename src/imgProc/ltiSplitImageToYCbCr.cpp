@@ -31,6 +31,7 @@
 
 
 #include "ltiSplitImageToYCbCr.h"
+#include "ltiParallelBands.h"
 #include "ltiFactory.h"
 
 namespace lti {
@@ -94,6 +95,11 @@ namespace lti {
                                 matrix<float>& c1,
                                 matrix<float>& c2,
                                 matrix<float>& c3) const {
+    parallelBands<splitImageToYCbCr> bands(*this,img.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.split(img,c1,c2,c3);
+    }
+
 
     // make the channels size of source image...
     // Todo: don't initialize
@@ -134,6 +140,11 @@ namespace lti {
                                 matrix<ubyte>& c1,
                                 matrix<ubyte>& c2,
                                 matrix<ubyte>& c3) const {
+    parallelBands<splitImageToYCbCr> bands(*this,img.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.split(img,c1,c2,c3);
+    }
+
     
     // make the channels size of source image...
     c1.allocate(img.size());
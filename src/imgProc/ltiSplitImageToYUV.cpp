@@ -32,6 +32,7 @@
 
 
 #include "ltiSplitImageToYUV.h"
+#include "ltiParallelBands.h"
 #include "ltiFactory.h"
 
 namespace lti {
@@ -93,6 +94,11 @@ namespace lti {
                               matrix<float>& c1,
                               matrix<float>& c2,
                               matrix<float>& c3) const {
+    parallelBands<splitImageToYUV> bands(*this,img.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.split(img,c1,c2,c3);
+    }
+
 
     // make the channels size of source image...
     // Todo: don't initialize
@@ -130,6 +136,11 @@ namespace lti {
                               matrix<ubyte>& c1,
                               matrix<ubyte>& c2,
                               matrix<ubyte>& c3) const {
+    parallelBands<splitImageToYUV> bands(*this,img.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.split(img,c1,c2,c3);
+    }
+
 
     // make the channels size of source image...
     c1.allocate(img.size());
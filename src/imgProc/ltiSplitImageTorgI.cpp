@@ -35,6 +35,7 @@
  */
 
 #include "ltiSplitImageTorgI.h"
+#include "ltiParallelBands.h"
 #include "ltiConstants.h"
 #include "ltiFactory.h"
 
@@ -91,6 +92,11 @@ namespace lti {
                               matrix<channel::value_type>& c1,
                               matrix<channel::value_type>& c2,
                               matrix<channel::value_type>& c3) const {
+    parallelBands<splitImageTorgI> bands(*this,img.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.split(img,c1,c2,c3);
+    }
+
     float i;
     ipoint p;
     vector<rgbaPixel>::const_iterator imgIt,imgEIt;
@@ -127,6 +133,11 @@ namespace lti {
                               matrix<channel8::value_type>& c1,
                               matrix<channel8::value_type>& c2,
                               matrix<channel8::value_type>& c3) const {
+    parallelBands<splitImageTorgI> bands(*this,img.size());
+    if (bands.getNumberOfBands() > 1) {
+      return bands.split(img,c1,c2,c3);
+    }
+
     int i;
     ipoint p;
     c1.allocate(img.size());
@@ -55,6 +55,7 @@
 
 #include "ltiMatrixTransform.h"
 #include "ltiBilinearInterpolation.h"
+#include "ltiThreadPool.h"
 
 #include <vector>
 #include <limits>
@@ -556,10 +557,10 @@ namespace lti {
     return true;
   }
   
-  template<typename T>
+  template<typename T,typename U>
   bool surfLocalDescriptor::helper(const matrix<T>& src,
                                    const list<location>& locs,
-                                   std::list<dvector>& desc) const {
+                                   matrix<U>& desc) const {
     const parameters& param = getParameters();
     switch(param.orientationMode) {
       case Ignore:
@@ -606,10 +607,10 @@ namespace lti {
     virtual void reset() = 0;
     
     /*
-     * Upload the data into the vector
+     * Upload the data into the descriptor
      */
     virtual void load(int& idx,
-                      dvector& vct) = 0;
+                      float* vct) = 0;
   };
   
   /*
@@ -656,14 +657,14 @@ namespace lti {
     }
     
     /*
-     * Upload the data into the vector
+     * Upload the data into the descriptor
      */
     virtual void load(int& idx,
-                      dvector& vct) {
-      vct.at(idx++)=accdx;
-      vct.at(idx++)=accadx;
-      vct.at(idx++)=accdy;
-      vct.at(idx++)=accady;
+                      float* vct) {
+      vct[idx++]=accdx;
+      vct[idx++]=accadx;
+      vct[idx++]=accdy;
+      vct[idx++]=accady;
     }
   };
   
@@ -735,39 +736,179 @@ namespace lti {
     }
     
     /*
-     * Upload the data into the vector
+     * Upload the data into the descriptor
      */
     virtual void load(int& idx,
-                      dvector& vct) {
-      vct.at(idx++)=paccdx;
-      vct.at(idx++)=paccdy;
-      vct.at(idx++)=paccadx;
-      vct.at(idx++)=paccady;
+                      float* vct) {
+      vct[idx++]=paccdx;
+      vct[idx++]=paccdy;
+      vct[idx++]=paccadx;
+      vct[idx++]=paccady;
       
-      vct.at(idx++)=naccdx;
-      vct.at(idx++)=naccdy;
-      vct.at(idx++)=naccadx;
-      vct.at(idx++)=naccady;
+      vct[idx++]=naccdx;
+      vct[idx++]=naccdy;
+      vct[idx++]=naccadx;
+      vct[idx++]=naccady;
     }
   };
 
+  int surfLocalDescriptor::getDescriptorSize() const {
+    const parameters& param = getParameters();
+    const int blockSize = (param.signSplit) ? 8 : 4 ;
+    return sqr(param.numberOfSubregions) * blockSize;
+  }
+
+  namespace internal {
+    /*
+     * Store the descriptor d of the given size in the row, dividing it by
+     * dnorm.  The double and float versions just cast the values.
+     */
+    template<typename U>
+    inline void surfStore(const float* d,const int size,const double dnorm,
+                          U* row) {
+      for (int i=0;i<size;++i) {
+        row[i]=static_cast<U>(d[i]/dnorm);
+      }
+    }
+
+    /*
+     * The ubyte version maps the range -1..1 to 0..255
+     */
+    template<>
+    inline void surfStore(const float* d,const int size,const double dnorm,
+                          ubyte* row) {
+      for (int i=0;i<size;++i) {
+        const double val = 127.5*(d[i]/dnorm + 1.0);
+        row[i]=(val <= 0.0) ? 0 :
+          ((val >= 255.0) ? 255 : static_cast<ubyte>(val+0.5));
+      }
+    }
+  }
+
+  /*
+   * Job computing the descriptors of a range of locations in each task.
+   */
+  template<typename T,typename U>
+  class surfLocalDescriptor::descriptorJob : public threadPool::job {
+  public:
+    /*
+     * Constructor
+     */
+    descriptorJob(const surfLocalDescriptor& owner,
+                  const matrix<T>& intImg,
+                  const integralImage& integrator,
+                  const std::vector<location>& refs,
+                  const int* indices,
+                  const int numLocs,
+                  const float sina,
+                  const float cosa,
+                  const fpoint& offset,
+                  const int numTasks,
+                  matrix<U>& desc)
+      : owner_(owner),intImg_(intImg),integrator_(integrator),refs_(refs),
+        indices_(indices),numLocs_(numLocs),sina_(sina),cosa_(cosa),
+        offset_(offset),numTasks_(numTasks),desc_(desc) {
+    }
+
+    /*
+     * Describe the locations of the task
+     */
+    virtual void execute(const int task) {
+      const parameters& param = owner_.getParameters();
+      const int from = (task*numLocs_)/numTasks_;
+      const int to = ((task+1)*numLocs_)/numTasks_;
+      const int dSize = desc_.columns();
+
+      std::vector<float> d(dSize); // container for one descriptor
+      for (int i=from;i<to;++i) {
+        const int locPos = (indices_ == 0) ? i : indices_[i];
+        const location& loc = refs_[locPos];
+
+        switch(param.orientationMode) {
+          case Approximate:
+            owner_.describeApprox(intImg_,integrator_,loc,&d[0]);
+            break;
+          case Cluster: {
+            // the rotation has moved the position of the location
+            // we need that new position in the intImg coordinates
+            const int lx = iround(cosa_*loc.position.x+sina_*loc.position.y-
+                                  offset_.x);
+            const int ly = iround(-sina_*loc.position.x+cosa_*loc.position.y-
+                                  offset_.y);
+            owner_.describeAligned(intImg_,integrator_,
+                                   static_cast<float>(lx),
+                                   static_cast<float>(ly),
+                                   loc.radius,&d[0]);
+          } break;
+          default:
+            owner_.describeAligned(intImg_,integrator_,
+                                   loc.position.x,loc.position.y,
+                                   loc.radius,&d[0]);
+        }
+
+        // normalize the vector
+        double dnorm = 1.0;
+        if (param.normalize) {
+          double acc = 0.0;
+          for (int k=0;k<dSize;++k) {
+            acc += static_cast<double>(d[k])*d[k];
+          }
+          dnorm = sqrt(acc);
+        }
+        internal::surfStore(&d[0],dSize,dnorm,desc_[locPos].data());
+      }
+    }
+
+  private:
+    const surfLocalDescriptor& owner_;
+    const matrix<T>& intImg_;
+    const integralImage& integrator_;
+    const std::vector<location>& refs_;
+    const int* indices_;
+    const int numLocs_;
+    const float sina_;
+    const float cosa_;
+    const fpoint offset_;
+    const int numTasks_;
+    matrix<U>& desc_;
+  };
+
+  template<typename T,typename U>
+  void surfLocalDescriptor::describe(const matrix<T>& intImg,
+                                     const integralImage& integrator,
+                                     const std::vector<location>& refs,
+                                     const int* indices,
+                                     const int numLocs,
+                                     const float sina,
+                                     const float cosa,
+                                     const fpoint& offset,
+                                     matrix<U>& desc) const {
+    if (numLocs <= 0) {
+      return;
+    }
+
+    const int threads =
+      threadPool::computeThreads(getParameters().numberOfThreads);
+    const int tasks = min(numLocs,(threads > 1) ? 8*threads : 1);
+
+    descriptorJob<T,U> job(*this,intImg,integrator,refs,indices,numLocs,
+                           sina,cosa,offset,tasks,desc);
+    threadPool::getShared().run(job,tasks,threads);
+  }
+
   template<typename T>
-  bool surfLocalDescriptor::helperIgnore(const matrix<T>& src,
-                                         const list<location>& locs,
-                                         std::list<dvector>& desc) const {
+  void surfLocalDescriptor::describeAligned(const matrix<T>& intImg,
+                                            const integralImage& integrator,
+                                            const float lx,
+                                            const float ly,
+                                            const float radius,
+                                            float* d) const {
     const parameters& param = getParameters();
 
-    // prepare the integral image functor
-    integralImage integrator(param.boundaryType);
-    matrix<typename typeInfo<T>::accumulation_type> intImg;
-    
     // some general geometric information of the locations
     const int wndSize = param.numberOfSubregions * param.subregionSamples;
     const int hSide = wndSize/2;
 
-    // size of the descriptor
-    const int blockSize = (param.signSplit) ? 8 : 4 ;
-    const int dSize = sqr(param.numberOfSubregions) * blockSize;
     block4 acc4;
     block8 acc8;
     block* acc;
@@ -776,111 +917,202 @@ namespace lti {
     } else {
       acc = &acc4;
     }
-    dvector d(dSize); // container for one descriptor
 
-#if defined(_LTI_DEBUG)
-    static matrix<T> canvas;
-    canvas.copy(src);
-    static viewer2D view("helperIgnore::debug");
-#endif
+    const unsigned int rows = intImg.rows();
+    const unsigned int cols = intImg.columns();
+
+    const float lhSide = hSide * radius;
+    const int wlsh = iround(radius*param.waveletSize/2.0f);
+
+    int idx = 0;
+    for (int y=0;y<param.numberOfSubregions;++y) {
+      const int yoff = y*param.subregionSamples;
+      for (int x=0;x<param.numberOfSubregions;++x) {
+        const int xoff = x*param.subregionSamples;
+
+        // for each sub-region of the window
+        acc->reset();
+        float ry = ly - lhSide + yoff*radius; 
+        for (int yy=0;yy<param.subregionSamples;++yy) {
+          const int iry = iround(ry);
+          ry += radius;
+
+          // if we leave the image, go on with the next line
+          if (static_cast<uint32>(iry) >= rows) {
+            continue;
+          }
+
+          float rx = lx - lhSide + xoff*radius;
+
+          for (int xx=0;xx<param.subregionSamples;++xx) {
+            // here rx and ry have the position of the pixel
+            const int irx = iround(rx);
+                    
+            rx += radius;
+              
+            // if we leave the image, go on with the next one
+            if (static_cast<uint32>(irx) >= cols) {
+              continue;
+            }
+
+            const float weight = gaussian_.at(yy+yoff,xx+xoff);
+                    
+            // we are within the image, so let's compute the haar
+            // values
+            const float dx = 
+              weight*(integrator.sum(intImg,
+                                     irx,iry-wlsh,irx+wlsh,iry+wlsh) -
+                      integrator.sum(intImg,
+                                     irx-wlsh,iry-wlsh,irx,iry+wlsh));
+            const float dy =
+              weight*(integrator.sum(intImg,
+                                     irx-wlsh,iry,irx+wlsh,iry+wlsh) -
+                      integrator.sum(intImg,
+                                     irx-wlsh,iry-wlsh,irx+wlsh,iry));
+              
+            acc->acc(dx,dy);
+          }
+        }
+        acc->load(idx,d);
+      }
+    } // end of window loop
+  }
+
+  template<typename T>
+  void surfLocalDescriptor::describeApprox(const matrix<T>& intImg,
+                                           const integralImage& integrator,
+                                           const location& loc,
+                                           float* d) const {
+    const parameters& param = getParameters();
+
+    const uint32 rows = static_cast<uint32>(intImg.rows());
+    const uint32 cols = static_cast<uint32>(intImg.columns());
     
-    desc.clear(); // prepare to insert each descriptor
+    const int wndSize = param.numberOfSubregions * param.subregionSamples;
+    const int hSide = wndSize/2;
 
-    list<location>::const_iterator it,eit;
-   
-    // compute integral image of the src channel
-    integrator.apply(src,intImg);
+    block4 acc4;
+    block8 acc8;
+    block* acc;
+    if (param.signSplit) {
+      acc = &acc8;
+    } else {
+      acc = &acc4;
+    }
 
-    const unsigned int rows = intImg.rows();
-    const unsigned int cols = intImg.columns();
+    // the angles needed for the mapping
+    const float cosa = cos(loc.angle);
+    const float sina = sin(loc.angle);
 
-    for (it=locs.begin(),eit=locs.end();it!=eit;++it) {
-      const location& loc = *it;
-      const float lhSide = hSide * loc.radius;
-      
-      const float lx = loc.position.x;
-      const float ly = loc.position.y;
+    const float rcosa = loc.radius*cosa;
+    const float rsina = loc.radius*sina;
 
-      const int wlsh = iround(loc.radius*param.waveletSize/2.0f);
+    const float tx = loc.position.x - hSide*(rcosa - rsina);
+    const float ty = loc.position.y - hSide*(rcosa + rsina);
 
-      int idx = 0;
-      for (int y=0;y<param.numberOfSubregions;++y) {
-        const int yoff = y*param.subregionSamples;
-        for (int x=0;x<param.numberOfSubregions;++x) {
-          const int xoff = x*param.subregionSamples;
+    const int wlsh = iround(loc.radius*param.waveletSize/2.0f);
+      
+    int idx = 0;      
+    for (int y=0;y<param.numberOfSubregions;++y) {
+      const int yoff = y*param.subregionSamples;
+      for (int x=0;x<param.numberOfSubregions;++x) {
+        const int xoff = x*param.subregionSamples;
+        // for each sub-region of the window
+        acc->reset();
+        for (int yy=0;yy<param.subregionSamples;++yy) {
+          const int yyy = yy+yoff;
+          float rx = xoff*rcosa - yyy*rsina + tx;
+          float ry = xoff*rsina + yyy*rcosa + ty;
+            
+          for (int xx=0;xx<param.subregionSamples;++xx) {
+            // we save the following direct implementation with sums
+            // const int rx = iround(xx*s*cosa - yy*s*sina + s*tx);
+            // const int ry = iround(xx*s*sina + yy*s*cosa + s*ty);
 
-          // for each sub-region of the window
-          acc->reset();
-          float ry = ly - lhSide + yoff*loc.radius; 
-          for (int yy=0;yy<param.subregionSamples;++yy) {
+            // here rx and ry have the position of the pixel
+            const int irx = iround(rx);
             const int iry = iround(ry);
-            ry += loc.radius;
+       
+            // update for next time
+            rx += rcosa;
+            ry += rsina;
+
+            // if we leave the image, go on with the next one
+            if ( (static_cast<uint32>(irx) >= cols) ||
+                 (static_cast<uint32>(iry) >= rows) ) {
 
-            // if we leave the image, go on with the next line
-            if (static_cast<uint32>(iry) >= rows) {
               continue;
             }
 
-            float rx = lx - lhSide + xoff*loc.radius;
-
-            for (int xx=0;xx<param.subregionSamples;++xx) {
-              // here rx and ry have the position of the pixel
-              const int irx = iround(rx);
-                    
-              rx += loc.radius;
+            const float weight=gaussian_.at(yyy,xx+xoff);
+
+            // we are within the image, so let's compute the haar values
+            const float dx = 
+              weight*(integrator.sum(intImg,
+                                     irx,iry-wlsh,irx+wlsh,iry+wlsh) -
+                      integrator.sum(intImg,
+                                     irx-wlsh,iry-wlsh,irx,iry+wlsh));
+            const float dy =
+              weight*(integrator.sum(intImg,
+                                     irx-wlsh,iry,irx+wlsh,iry+wlsh) -
+                      integrator.sum(intImg,
+                                     irx-wlsh,iry-wlsh,irx+wlsh,iry));
+              
+            // here is a trick to avoid the real rotation of the image.  This
+            // is NOT documented in the paper, but since everything is
+            // approximated, a further simplification won't hurt.
+
+            // We can think of this Haar responses as a scale-dependent
+            // approximation of the first gaussian derivatives in a given
+            // direction, which at the same time are steerable filters, with
+            // the cosine and sine of the orientation angle as interpolation
+            // coefficient.
               
-              // if we leave the image, go on with the next one
-              if (static_cast<uint32>(irx) >= cols) {
-                continue;
-              }
+            // this might react somehow chaotical for complex random textures
+            // of fine granularity, but in most cases should work well. (the
+            // real image rotation and computation of the Haar responses
+            // would also react chaotically anyway)
 
-              _lti_if_debug(canvas.at(iry,irx)=255);
+            const float rdx =  dx*cosa + dy*sina;
+            const float rdy =  -dx*sina + dy*cosa;
 
-              const float weight = gaussian_.at(yy+yoff,xx+xoff);
-                    
-              // we are within the image, so let's compute the haar
-              // values
-              const float dx = 
-                weight*(integrator.sum(intImg,
-                                       irx,iry-wlsh,irx+wlsh,iry+wlsh) -
-                        integrator.sum(intImg,
-                                       irx-wlsh,iry-wlsh,irx,iry+wlsh));
-              const float dy =
-                weight*(integrator.sum(intImg,
-                                       irx-wlsh,iry,irx+wlsh,iry+wlsh) -
-                        integrator.sum(intImg,
-                                       irx-wlsh,iry-wlsh,irx+wlsh,iry));
-              
-              acc->acc(dx,dy);
-            }
+            acc->acc(rdx,rdy);
           }
-          acc->load(idx,d);
         }
-      } // end of window loop
-            
-      // normalize the vector
-      if (param.normalize) {
-        const double dnorm = sqrt(d.dot(d));
-        d.divide(dnorm);
+        acc->load(idx,d);
       }
+    }
+  }
 
-      desc.push_back(d);
-    } // end of locations loop
-    
-    _lti_if_debug(view.show(canvas));
+  template<typename T,typename U>
+  bool surfLocalDescriptor::helperIgnore(const matrix<T>& src,
+                                         const list<location>& locs,
+                                         matrix<U>& desc) const {
+    const parameters& param = getParameters();
+
+    // the locations as vector for random access
+    std::vector<location> refs(locs.begin(),locs.end());
+    desc.allocate(static_cast<int>(refs.size()),getDescriptorSize());
+
+    // compute integral image of the src channel
+    integralImage integrator(param.boundaryType);
+    matrix<typename typeInfo<T>::accumulation_type> intImg;
+    integrator.apply(src,intImg);
+
+    describe(intImg,integrator,refs,0,static_cast<int>(refs.size()),
+             0.0f,1.0f,fpoint(0.0f,0.0f),desc);
 
     return true;
   }
 
-  template<typename T>
+  template<typename T,typename U>
   bool surfLocalDescriptor::helperCluster(const matrix<T>& src,
                                           const list<location>& locs,
-                                          std::list<dvector>& desc) const {
+                                          matrix<U>& desc) const {
 
     const parameters& param = getParameters();
 
     // new formats for the locations, clustered according to their values
-    std::vector< list<location> > sortedLocs;
     std::vector<location> refs;
     imatrix clusters;
     fvector angles;
@@ -904,32 +1136,8 @@ namespace lti {
     // get the orientation clusters, and if everything is ok go on...
     if (cluster(locs,refs,clusters,angles,sines,cosines,numLocs)) {
       
-      // some general geometric information of the locations
-      const int wndSize = param.numberOfSubregions * param.subregionSamples;
-      const int hSide = wndSize/2;
-
-      // size of the descriptor
-      const int blockSize = (param.signSplit) ? 8 : 4 ;
-      const int dSize = sqr(param.numberOfSubregions) * blockSize;
-      block4 acc4;
-      block8 acc8;
-      block* acc;
-      if (param.signSplit) {
-        acc = &acc8;
-      } else {
-        acc = &acc4;
-      }
-
-
-#if defined(_LTI_DEBUG)
-      static matrix<T> canvas;
-      static viewer2D view("helperCluster::debug");
-#endif
-
-
-      
       // matrix holding all descriptors
-      dmatrix vcts(static_cast<int>(refs.size()),dSize);
+      desc.allocate(static_cast<int>(refs.size()),getDescriptorSize());
 
       // for each available cluster
       for (int c=0;c<clusters.rows();++c) {
@@ -945,260 +1153,40 @@ namespace lti {
                                                -angles.at(c)));
           transformer.apply(src,chnl,offset);
           
-          _lti_if_debug(canvas.copy(chnl));
-
-          const float sina = sines.at(c);
-          const float cosa = cosines.at(c);
+          _lti_debug("Offset: " << offset << std::endl);
 
           // compute integral image of the rotated channel
           integrator.apply(chnl,intImg);
 
-          const unsigned int rows = intImg.rows();
-          const unsigned int cols = intImg.columns();
-
-          for (int i=0;i<lic;++i) {
-            const int locPos = clusters.at(c,i);
-            const location& loc = refs[locPos];
-            dvector& d = vcts.getRow(locPos);
-            
-            const float lhSide = hSide * loc.radius;
-
-            // the rotation has moved the position of the location
-            // we need that new position in the intImg coordinates
-
-            _lti_debug("Offset: " << offset << std::endl);
-
-            const int lx = iround(cosa*loc.position.x+sina*loc.position.y-
-                                  offset.x);
-            const int ly = iround(-sina*loc.position.x+cosa*loc.position.y-
-                                  offset.y);
-
-            const int wlsh = iround(loc.radius*param.waveletSize/2.0f);
-
-            int idx = 0;
-            for (int y=0;y<param.numberOfSubregions;++y) {
-              const int yoff = y*param.subregionSamples;
-              for (int x=0;x<param.numberOfSubregions;++x) {
-                const int xoff = x*param.subregionSamples;
-
-                // for each sub-region of the window
-                acc->reset();
-                float ry = ly - lhSide + yoff*loc.radius; 
-                for (int yy=0;yy<param.subregionSamples;++yy) {
-                  const int iry = iround(ry);
-                  ry += loc.radius;
-
-                   // if we leave the image, go on with the next line
-                  if (static_cast<uint32>(iry) >= rows) {
-                    continue;
-                  }
-
-                  float rx = lx - lhSide + xoff*loc.radius;
-
-                  for (int xx=0;xx<param.subregionSamples;++xx) {
-                    // we save the following direct implementation with sums
-                    // const int rx = iround(xx*s*cosa - yy*s*sina + s*tx);
-                    // const int ry = iround(xx*s*sina + yy*s*cosa + s*ty);
-                    
-                    // here rx and ry have the position of the pixel
-                    const int irx = iround(rx);
-                    
-                    rx += loc.radius;
-
-                    // if we leave the image, go on with the next one
-                    if (static_cast<uint32>(irx) >= cols) {
-                      continue;
-                    }
-
-                    _lti_if_debug(canvas.at(iry,irx)=255);
-
-                    const float weight = gaussian_.at(yy+yoff,xx+xoff);
-                    
-                    // we are within the image, so let's compute the haar
-                    // values
-                    const float dx = 
-                      weight*(integrator.sum(intImg,
-                                             irx,iry-wlsh,irx+wlsh,iry+wlsh) -
-                              integrator.sum(intImg,
-                                             irx-wlsh,iry-wlsh,irx,iry+wlsh));
-                    const float dy =
-                      weight*(integrator.sum(intImg,
-                                             irx-wlsh,iry,irx+wlsh,iry+wlsh) -
-                              integrator.sum(intImg,
-                                             irx-wlsh,iry-wlsh,irx+wlsh,iry));
-                    
-                    acc->acc(dx,dy);
-                  }
-                }
-                acc->load(idx,d);
-              }
-            }
-            
-            // normalize the vector
-            if (param.normalize) {
-              const double dnorm = sqrt(d.dot(d));
-              d.divide(dnorm);
-            }
-          }          
+          describe(intImg,integrator,refs,&clusters.at(c,0),lic,
+                   sines.at(c),cosines.at(c),offset,desc);
         }
       }
 
-      _lti_if_debug(view.show(canvas));
-
-      // pass the information to the desc list
-      desc.clear();
-      for (int i=0;i<vcts.rows();++i) {
-        desc.push_back(vcts.getRow(i));
-      }
-
       return true;
     }
 
     return false;
   }
 
-  template<typename T>
+  template<typename T,typename U>
   bool surfLocalDescriptor::helperApprox(const matrix<T>& src,
                                          const list<location>& locs,
-                                         std::list<dvector>& desc) const {
-
-
+                                         matrix<U>& desc) const {
     const parameters& param = getParameters();
 
+    // the locations as vector for random access
+    std::vector<location> refs(locs.begin(),locs.end());
+    desc.allocate(static_cast<int>(refs.size()),getDescriptorSize());
+
     // first compute the integral image
     matrix<typename typeInfo<T>::accumulation_type> intImg;
     integralImage integrator(param.boundaryType);
     integrator.apply(src,intImg);
 
-    desc.clear();
-
-    const uint32 rows = static_cast<uint32>(intImg.rows());
-    const uint32 cols = static_cast<uint32>(intImg.columns());
-    
-    const int wndSize = param.numberOfSubregions * param.subregionSamples;
-    const int hSide = wndSize/2;
-
-    // size of the descriptor
-    const int blockSize = (param.signSplit) ? 8 : 4 ;
-    const int dSize = sqr(param.numberOfSubregions) * blockSize;
-    block4 acc4;
-    block8 acc8;
-    block* acc;
-    if (param.signSplit) {
-      acc = &acc8;
-    } else {
-      acc = &acc4;
-    }
-
-    dvector d(dSize);
-
-#if defined(_LTI_DEBUG)
-    static matrix<T> canvas;
-    canvas.copy(src);
-    static viewer2D view("helperApprox::debug");
-#endif
-
-
-    list<location>::const_iterator it,eit;
-    for (it=locs.begin(),eit=locs.end();it!=eit;++it) {
-      const location& loc = (*it);
-      
-      // the angles needed for the mapping
-      const float cosa = cos(loc.angle);
-      const float sina = sin(loc.angle);
-
-      const float rcosa = loc.radius*cosa;
-      const float rsina = loc.radius*sina;
-
-      const float tx = loc.position.x - hSide*(rcosa - rsina);
-      const float ty = loc.position.y - hSide*(rcosa + rsina);
+    describe(intImg,integrator,refs,0,static_cast<int>(refs.size()),
+             0.0f,1.0f,fpoint(0.0f,0.0f),desc);
 
-      const int wlsh = iround(loc.radius*param.waveletSize/2.0f);
-      
-      d.assign(dSize,0); // clear vector
-      int idx = 0;      
-      for (int y=0;y<param.numberOfSubregions;++y) {
-        const int yoff = y*param.subregionSamples;
-        for (int x=0;x<param.numberOfSubregions;++x) {
-          const int xoff = x*param.subregionSamples;
-          // for each sub-region of the window
-          acc->reset();
-          for (int yy=0;yy<param.subregionSamples;++yy) {
-            const int yyy = yy+yoff;
-            float rx = xoff*rcosa - yyy*rsina + tx;
-            float ry = xoff*rsina + yyy*rcosa + ty;
-            
-            for (int xx=0;xx<param.subregionSamples;++xx) {
-              // we save the following direct implementation with sums
-              // const int rx = iround(xx*s*cosa - yy*s*sina + s*tx);
-              // const int ry = iround(xx*s*sina + yy*s*cosa + s*ty);
-
-              // here rx and ry have the position of the pixel
-              const int irx = iround(rx);
-              const int iry = iround(ry);
-       
-              // update for next time
-              rx += rcosa;
-              ry += rsina;
-
-              // if we leave the image, go on with the next one
-              if ( (static_cast<uint32>(irx) >= cols) ||
-                   (static_cast<uint32>(iry) >= rows) ) {
-
-                continue;
-              }
-
-              _lti_if_debug(canvas.at(iry,irx)=255);
-
-              const float weight=gaussian_.at(yyy,xx+xoff);
-
-              // we are within the image, so let's compute the haar values
-              const float dx = 
-                weight*(integrator.sum(intImg,
-                                       irx,iry-wlsh,irx+wlsh,iry+wlsh) -
-                        integrator.sum(intImg,
-                                       irx-wlsh,iry-wlsh,irx,iry+wlsh));
-              const float dy =
-                weight*(integrator.sum(intImg,
-                                       irx-wlsh,iry,irx+wlsh,iry+wlsh) -
-                        integrator.sum(intImg,
-                                       irx-wlsh,iry-wlsh,irx+wlsh,iry));
-              
-              // here is a trick to avoid the real rotation of the image.  This
-              // is NOT documented in the paper, but since everything is
-              // approximated, a further simplification won't hurt.
-
-              // We can think of this Haar responses as a scale-dependent
-              // approximation of the first gaussian derivatives in a given
-              // direction, which at the same time are steerable filters, with
-              // the cosine and sine of the orientation angle as interpolation
-              // coefficient.
-              
-              // this might react somehow chaotical for complex random textures
-              // of fine granularity, but in most cases should work well. (the
-              // real image rotation and computation of the Haar responses
-              // would also react chaotically anyway)
-
-              const float rdx =  dx*cosa + dy*sina;
-              const float rdy =  -dx*sina + dy*cosa;
-
-              acc->acc(rdx,rdy);
-            }
-          }
-          acc->load(idx,d);
-        }
-      }
-
-      // normalize the vector
-      if (param.normalize) {
-        const double dnorm = sqrt(d.dot(d));
-        d.divide(dnorm);
-      }
-      desc.push_back(d);
-    }
-
-    _lti_if_debug(view.show(canvas));
-    
     return true;
   }
 
@@ -1213,7 +1201,15 @@ namespace lti {
   bool surfLocalDescriptor::apply(const channel8& src,
                                   const list<location>& locs,
                                   std::list<dvector>& desc) const {
-    return helper(src,locs,desc);
+    dmatrix vcts;
+    desc.clear();
+    if (helper(src,locs,vcts)) {
+      for (int i=0;i<vcts.rows();++i) {
+        desc.push_back(vcts.getRow(i));
+      }
+      return true;
+    }
+    return false;
   }
   
   /*
@@ -1227,7 +1223,15 @@ namespace lti {
   bool surfLocalDescriptor::apply(const channel& src,
                                   const list<location>& locs,
                                         std::list<dvector>& desc) const {
-    return helper(src,locs,desc);
+    dmatrix vcts;
+    desc.clear();
+    if (helper(src,locs,vcts)) {
+      for (int i=0;i<vcts.rows();++i) {
+        desc.push_back(vcts.getRow(i));
+      }
+      return true;
+    }
+    return false;
   }
 
   /*
@@ -1244,13 +1248,37 @@ namespace lti {
     list<location> locs;
     locs.push_back(loc);
 
-    std::list<dvector> descl;
-    if (helper(src,locs,descl)) {
-      descl.front().detach(desc);
+    dmatrix vcts;
+    if (helper(src,locs,vcts)) {
+      desc.copy(vcts.getRow(0));
       return true;
     } 
     return false;
   }
+
+  bool surfLocalDescriptor::apply(const channel8& src,
+                                  const list<location>& locs,
+                                  fmatrix& desc) const {
+    return helper(src,locs,desc);
+  }
+
+  bool surfLocalDescriptor::apply(const channel& src,
+                                  const list<location>& locs,
+                                  fmatrix& desc) const {
+    return helper(src,locs,desc);
+  }
+
+  bool surfLocalDescriptor::apply(const channel8& src,
+                                  const list<location>& locs,
+                                  matrix<ubyte>& desc) const {
+    return helper(src,locs,desc);
+  }
+
+  bool surfLocalDescriptor::apply(const channel& src,
+                                  const list<location>& locs,
+                                  matrix<ubyte>& desc) const {
+    return helper(src,locs,desc);
+  }
   
   /**
    * Read a fastHessianDetection::eLevelSelectionMethod
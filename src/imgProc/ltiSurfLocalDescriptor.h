@@ -55,6 +55,8 @@
 #include "ltiFunctor.h"
 #include "ltiList.h"
 #include "ltiBoundaryType.h"
+#include "ltiIntegralImage.h"
+#include <vector>
 
 namespace lti {
 
@@ -73,6 +75,13 @@ namespace lti {
    * produce different results than the ones obtained from the closed-source
    * implementation of the authors.  Any suggestions are always welcome.
    *
+   * Besides the methods returning a list of dvector, there are batch methods
+   * that write the descriptors into the rows of a contiguous matrix, either
+   * as float values or quantized to unsigned bytes.  The locations are
+   * distributed among several threads according to
+   * functor::parameters::numberOfThreads, and the result does not depend on
+   * the number of threads.
+   *
    * @see surfLocalDescriptor::parameters.
    *
    * @ingroup gFeatureExtr
@@ -327,6 +336,77 @@ namespace lti {
                const location& loc,
                dvector& desc) const;
 
+    /**
+     * @name Batch descriptor extraction
+     *
+     * These methods write the descriptor of the i-th location of the list
+     * into the i-th row of the given matrix.  The integral image of the
+     * source channel is computed once for all locations, which are
+     * distributed among the threads of the shared lti::threadPool.  If the
+     * matrix already has the size getDescriptorSize() times the number of
+     * locations, its memory is reused.
+     *
+     * The quantized descriptors map the range from -1 to 1 of the
+     * normalized descriptors linearly to the range from 0 to 255.  Values
+     * outside this range, which can only occur if parameters::normalize is
+     * false, are saturated.
+     */
+    //@{
+
+    /**
+     * Compute the descriptors of all locations.
+     *
+     * @param src channel8 with the image to be described.
+     * @param locs list of locations to be described
+     * @param desc the i-th row contains the descriptor of the i-th location.
+     * @return true if apply successful or false otherwise.
+     */
+    bool apply(const channel8& src,
+               const list<location>& locs,
+               fmatrix& desc) const;
+
+    /**
+     * Compute the descriptors of all locations.
+     *
+     * @param src channel with the image to be described.
+     * @param locs list of locations to be described
+     * @param desc the i-th row contains the descriptor of the i-th location.
+     * @return true if apply successful or false otherwise.
+     */
+    bool apply(const channel& src,
+               const list<location>& locs,
+               fmatrix& desc) const;
+
+    /**
+     * Compute the quantized descriptors of all locations.
+     *
+     * @param src channel8 with the image to be described.
+     * @param locs list of locations to be described
+     * @param desc the i-th row contains the descriptor of the i-th location.
+     * @return true if apply successful or false otherwise.
+     */
+    bool apply(const channel8& src,
+               const list<location>& locs,
+               matrix<ubyte>& desc) const;
+
+    /**
+     * Compute the quantized descriptors of all locations.
+     *
+     * @param src channel with the image to be described.
+     * @param locs list of locations to be described
+     * @param desc the i-th row contains the descriptor of the i-th location.
+     * @return true if apply successful or false otherwise.
+     */
+    bool apply(const channel& src,
+               const list<location>& locs,
+               matrix<ubyte>& desc) const;
+    //@}
+
+    /**
+     * Length of the descriptors computed with the current parameters.
+     */
+    int getDescriptorSize() const;
+
     /**
      * Copy data of "other" functor.
      * @param other the functor to be copied
@@ -368,39 +448,75 @@ namespace lti {
 
   private:
     /**
-     * The dispatcherreal computation is done here
+     * The dispatcher.  The real computation is done in the helperX methods,
+     * which write the descriptors into the rows of \a desc.
      */
-    template<typename T>
+    template<typename T,typename U>
     bool helper(const matrix<T>& src,
                 const list<location>& locs,
-                std::list<dvector>& desc) const;
-
+                matrix<U>& desc) const;
 
     /**
      * The real computation is done here, with an approximation of the
      * rotation.
      */
-    template<typename T>
+    template<typename T,typename U>
     bool helperApprox(const matrix<T>& src,
                       const list<location>& locs,
-                      std::list<dvector>& desc) const;
-
+                      matrix<U>& desc) const;
 
     /**
      * The real computation is done here, making a few rotations
      */
-    template<typename T>
+    template<typename T,typename U>
     bool helperCluster(const matrix<T>& src,
                        const list<location>& locs,
-                       std::list<dvector>& desc) const;
+                       matrix<U>& desc) const;
 
     /**
      * The real computation is done here, ignoring the rotation
      */
-    template<typename T>
+    template<typename T,typename U>
     bool helperIgnore(const matrix<T>& src,
                       const list<location>& locs,
-                      std::list<dvector>& desc) const;
+                      matrix<U>& desc) const;
+
+    /**
+     * Compute the descriptors of the given locations with the given job,
+     * using the threads indicated in the parameters.
+     */
+    template<typename T,typename U>
+    void describe(const matrix<T>& intImg,
+                  const integralImage& integrator,
+                  const std::vector<location>& refs,
+                  const int* indices,
+                  const int numLocs,
+                  const float sina,
+                  const float cosa,
+                  const fpoint& offset,
+                  matrix<U>& desc) const;
+
+    /**
+     * Compute the not normalized descriptor of a location whose window is
+     * aligned with the axes of the integral image, centered at (lx,ly).
+     */
+    template<typename T>
+    void describeAligned(const matrix<T>& intImg,
+                         const integralImage& integrator,
+                         const float lx,
+                         const float ly,
+                         const float radius,
+                         float* d) const;
+
+    /**
+     * Compute the not normalized descriptor of a location, steering the
+     * Haar responses with the orientation of the location.
+     */
+    template<typename T>
+    void describeApprox(const matrix<T>& intImg,
+                        const integralImage& integrator,
+                        const location& loc,
+                        float* d) const;
 
     /**
      * Compute the shortest angular distance between to angles
@@ -469,6 +585,14 @@ namespace lti {
     class block;
     class block4;
     class block8;
+
+    /**
+     * Job computing the descriptors of a range of locations in each task
+     */
+    template<typename T,typename U>
+    class descriptorJob;
+    template<typename T,typename U>
+    friend class descriptorJob;
   };
 
   /**
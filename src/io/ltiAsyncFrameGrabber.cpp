@@ -0,0 +1,556 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiAsyncFrameGrabber.cpp
+ *         Contains the class lti::asyncFrameGrabber, which grabs the frames
+ *         of another frame grabber in a background thread.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include "ltiAsyncFrameGrabber.h"
+#include "ltiThread.h"
+#include "ltiMath.h"
+
+namespace lti {
+
+  // --------------------------------------------------
+  // asyncFrameGrabber::parameters
+  // --------------------------------------------------
+
+  // default constructor
+  asyncFrameGrabber::parameters::parameters()
+    : frameGrabber::parameters() {
+    bufferCount = 4;
+    deliveryPolicy = AllFrames;
+    grabChannels = false;
+  }
+
+  // copy constructor
+  asyncFrameGrabber::parameters::parameters(const parameters& other)
+    : frameGrabber::parameters() {
+    copy(other);
+  }
+
+  // destructor
+  asyncFrameGrabber::parameters::~parameters() {
+  }
+
+  // copy member
+  asyncFrameGrabber::parameters&
+  asyncFrameGrabber::parameters::copy(const parameters& other) {
+    frameGrabber::parameters::copy(other);
+
+    bufferCount = other.bufferCount;
+    deliveryPolicy = other.deliveryPolicy;
+    grabChannels = other.grabChannels;
+
+    return *this;
+  }
+
+  // alias for copy member
+  asyncFrameGrabber::parameters&
+  asyncFrameGrabber::parameters::operator=(const parameters& other) {
+    return copy(other);
+  }
+
+  // class name
+  const std::string& asyncFrameGrabber::parameters::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone member
+  asyncFrameGrabber::parameters*
+  asyncFrameGrabber::parameters::clone() const {
+    return new parameters(*this);
+  }
+
+  // new instance
+  asyncFrameGrabber::parameters*
+  asyncFrameGrabber::parameters::newInstance() const {
+    return new parameters;
+  }
+
+  // write function
+  bool asyncFrameGrabber::parameters::write(ioHandler& handler,
+                                            const bool complete) const {
+    bool b = true;
+    if (complete) {
+      b = handler.writeBegin();
+    }
+
+    b = b && frameGrabber::parameters::write(handler,false);
+
+    b = b && lti::write(handler,"bufferCount",bufferCount);
+    b = b && lti::write(handler,"deliveryPolicy",deliveryPolicy);
+    b = b && lti::write(handler,"grabChannels",grabChannels);
+
+    if (complete) {
+      b = b && handler.writeEnd();
+    }
+
+    return b;
+  }
+
+  // read function
+  bool asyncFrameGrabber::parameters::read(ioHandler& handler,
+                                           const bool complete) {
+    bool b = true;
+    if (complete) {
+      b = handler.readBegin();
+    }
+
+    b = b && frameGrabber::parameters::read(handler,false);
+
+    b = b && lti::read(handler,"bufferCount",bufferCount);
+    b = b && lti::read(handler,"deliveryPolicy",deliveryPolicy);
+    b = b && lti::read(handler,"grabChannels",grabChannels);
+
+    if (complete) {
+      b = b && handler.readEnd();
+    }
+
+    return b;
+  }
+
+  // --------------------------------------------------
+  // asyncFrameGrabber::capturer
+  // --------------------------------------------------
+
+  /**
+   * Thread grabbing the frames of an asyncFrameGrabber
+   */
+  class asyncFrameGrabber::capturer : public thread {
+  public:
+    capturer(asyncFrameGrabber& owner) : thread(), owner_(owner) {
+    }
+
+  protected:
+    virtual void run() {
+      owner_.capture();
+    }
+
+    asyncFrameGrabber& owner_;
+  };
+
+  // --------------------------------------------------
+  // asyncFrameGrabber
+  // --------------------------------------------------
+
+  // default constructor
+  asyncFrameGrabber::asyncFrameGrabber()
+    : frameGrabber(), grabber_(0), capacity_(0), grabChannels_(false),
+      available_(0), stop_(false), capturing_(false), dropped_(0),
+      pendingDropped_(0), delivered_(false), clock_(timer::Wall),
+      thread_(0) {
+
+    // create an instance of the parameters with the default values
+    parameters defaultParameters;
+    // set the default parameters
+    setParameters(defaultParameters);
+  }
+
+  asyncFrameGrabber::asyncFrameGrabber(frameGrabber& grabber)
+    : frameGrabber(), grabber_(&grabber), capacity_(0), grabChannels_(false),
+      available_(0), stop_(false), capturing_(false), dropped_(0),
+      pendingDropped_(0), delivered_(false), clock_(timer::Wall),
+      thread_(0) {
+
+    parameters defaultParameters;
+    setParameters(defaultParameters);
+  }
+
+  asyncFrameGrabber::asyncFrameGrabber(frameGrabber& grabber,
+                                       const parameters& par)
+    : frameGrabber(), grabber_(&grabber), capacity_(0), grabChannels_(false),
+      available_(0), stop_(false), capturing_(false), dropped_(0),
+      pendingDropped_(0), delivered_(false), clock_(timer::Wall),
+      thread_(0) {
+
+    setParameters(par);
+  }
+
+  // copy constructor
+  asyncFrameGrabber::asyncFrameGrabber(const asyncFrameGrabber& other)
+    : frameGrabber(), grabber_(0), capacity_(0), grabChannels_(false),
+      available_(0), stop_(false), capturing_(false), dropped_(0),
+      pendingDropped_(0), delivered_(false), clock_(timer::Wall),
+      thread_(0) {
+    copy(other);
+  }
+
+  // destructor
+  asyncFrameGrabber::~asyncFrameGrabber() {
+    stop();
+  }
+
+  // class name
+  const std::string& asyncFrameGrabber::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // copy member
+  asyncFrameGrabber&
+  asyncFrameGrabber::copy(const asyncFrameGrabber& other) {
+    stop();
+    frameGrabber::copy(other);
+    grabber_ = other.grabber_;
+    return *this;
+  }
+
+  // alias for copy member
+  asyncFrameGrabber&
+  asyncFrameGrabber::operator=(const asyncFrameGrabber& other) {
+    return copy(other);
+  }
+
+  // clone member
+  asyncFrameGrabber* asyncFrameGrabber::clone() const {
+    return new asyncFrameGrabber(*this);
+  }
+
+  // create a new instance
+  asyncFrameGrabber* asyncFrameGrabber::newInstance() const {
+    return new asyncFrameGrabber();
+  }
+
+  // return parameters
+  const asyncFrameGrabber::parameters&
+  asyncFrameGrabber::getParameters() const {
+    const parameters* par =
+      dynamic_cast<const parameters*>(&functor::getParameters());
+    if(isNull(par)) {
+      throw invalidParametersException(name());
+    }
+    return *par;
+  }
+
+  bool asyncFrameGrabber::updateParameters() {
+    stop();
+    const parameters& par = getParameters();
+    if ((par.deliveryPolicy == AllFrames) && (par.bufferCount < 1)) {
+      setStatusString("bufferCount must be at least 1");
+      return false;
+    }
+    return true;
+  }
+
+  void asyncFrameGrabber::useGrabber(frameGrabber& grabber) {
+    stop();
+    grabber_ = &grabber;
+  }
+
+  frameGrabber* asyncFrameGrabber::getGrabber() const {
+    return grabber_;
+  }
+
+  bool asyncFrameGrabber::start() {
+    if (notNull(thread_)) {
+      // already started.  If the capture failed, the frames grabbed before
+      // are still to be delivered.
+      return true;
+    }
+
+    if (isNull(grabber_)) {
+      setStatusString("No grabber given");
+      return false;
+    }
+
+    if (!grabber_->isInitialized() && !grabber_->init()) {
+      setStatusString(grabber_->getStatusString());
+      return false;
+    }
+
+    const parameters& par = getParameters();
+    capacity_ = (par.deliveryPolicy == LatestFrame) ?
+      1 : static_cast<unsigned int>(max(1,par.bufferCount));
+    grabChannels_ = par.grabChannels;
+
+    // besides the waiting frames, one is grabbed and one is handed out.
+    // The containers keep their memory between two starts.
+    slots_.resize(capacity_+2);
+    ready_.clear();
+    free_.clear();
+    for (unsigned int i=0;i<slots_.size();++i) {
+      free_.push_back(i);
+    }
+
+    available_.reset();
+    stop_ = false;
+    capturing_ = true;
+    error_.clear();
+    dropped_ = 0;
+    pendingDropped_ = 0;
+    delivered_ = false;
+
+    clock_.start();
+    thread_ = new capturer(*this);
+    thread_->start();
+    return true;
+  }
+
+  void asyncFrameGrabber::stop() {
+    if (isNull(thread_)) {
+      return;
+    }
+
+    lock_.lock();
+    stop_ = true;
+    lock_.unlock();
+
+    thread_->join();
+    delete thread_;
+    thread_ = 0;
+    capturing_ = false;
+
+    ready_.clear();
+    free_.clear();
+  }
+
+  bool asyncFrameGrabber::isCapturing() const {
+    lock_.lock();
+    const bool capturing = capturing_;
+    lock_.unlock();
+    return capturing;
+  }
+
+  void asyncFrameGrabber::capture() {
+    uint32 sequence = 0;
+
+    lock_.lock();
+    int writing = free_.front();
+    free_.pop_front();
+    bool stop = stop_;
+    lock_.unlock();
+
+    while (!stop) {
+      slot& s = slots_[writing];
+      const bool ok = grabChannels_ ?
+        grabber_->apply(s.chnl) : grabber_->apply(s.img);
+
+      if (!ok) {
+        lock_.lock();
+        error_ = grabber_->name() + ": " + grabber_->getStatusString();
+        capturing_ = false;
+        free_.push_back(writing);
+        lock_.unlock();
+        // wake up the consumer, which finds no frame after the remaining
+        // ones
+        available_.post();
+        return;
+      }
+
+      if (!grabber_->getLastFrameInfo(s.info)) {
+        s.info.timestamp = clock_.getTime()/1000000.0;
+        s.info.sequence = sequence;
+        s.info.dropped = 0;
+      }
+      ++sequence;
+
+      lock_.lock();
+      dropped_ += s.info.dropped;
+      ready_.push_back(writing);
+      if (ready_.size() > capacity_) {
+        // the consumer is too slow: discard the oldest frame and grab
+        // into its slot
+        writing = ready_.front();
+        ready_.pop_front();
+        pendingDropped_ += slots_[writing].info.dropped + 1;
+        ++dropped_;
+        stop = stop_;
+        lock_.unlock();
+      } else {
+        writing = free_.front();
+        free_.pop_front();
+        stop = stop_;
+        lock_.unlock();
+        available_.post();
+      }
+    }
+
+    lock_.lock();
+    free_.push_back(writing);
+    lock_.unlock();
+  }
+
+  int asyncFrameGrabber::next() {
+    available_.wait();
+
+    lock_.lock();
+    if (ready_.empty()) {
+      // the capture ended: keep the semaphore posted, so that the next
+      // calls also return immediately
+      setStatusString(error_);
+      lock_.unlock();
+      available_.post();
+      return -1;
+    }
+
+    const int idx = ready_.front();
+    ready_.pop_front();
+    slot& s = slots_[idx];
+    s.info.dropped += pendingDropped_;
+    pendingDropped_ = 0;
+    lastFrame_ = s.info;
+    delivered_ = true;
+    lock_.unlock();
+
+    return idx;
+  }
+
+  void asyncFrameGrabber::release(const int idx) {
+    lock_.lock();
+    free_.push_back(idx);
+    lock_.unlock();
+  }
+
+  void asyncFrameGrabber::take(slot& s,image& dest) const {
+    if (grabChannels_) {
+      dest.castFrom(s.chnl);
+    } else {
+      // the slot keeps the memory of dest for the following frames
+      dest.swap(s.img);
+    }
+  }
+
+  void asyncFrameGrabber::take(slot& s,channel8& dest) const {
+    if (grabChannels_) {
+      dest.swap(s.chnl);
+    } else {
+      dest.castFrom(s.img);
+    }
+  }
+
+  template<class T>
+  bool asyncFrameGrabber::deliver(T& dest,frameInfo& info) {
+    if (!start()) {
+      return false;
+    }
+
+    const int idx = next();
+    if (idx < 0) {
+      return false;
+    }
+
+    slot& s = slots_[idx];
+    take(s,dest);
+    info = s.info;
+    release(idx);
+
+    return true;
+  }
+
+  bool asyncFrameGrabber::apply(image& theImage) {
+    frameInfo info;
+    return deliver(theImage,info);
+  }
+
+  bool asyncFrameGrabber::apply(channel8& theChannel) {
+    frameInfo info;
+    return deliver(theChannel,info);
+  }
+
+  bool asyncFrameGrabber::apply(image& theImage,frameInfo& info) {
+    return deliver(theImage,info);
+  }
+
+  bool asyncFrameGrabber::apply(channel8& theChannel,frameInfo& info) {
+    return deliver(theChannel,info);
+  }
+
+  bool asyncFrameGrabber::getLastFrameInfo(frameInfo& info) const {
+    lock_.lock();
+    const bool delivered = delivered_;
+    if (delivered) {
+      info = lastFrame_;
+    }
+    lock_.unlock();
+    return delivered;
+  }
+
+  int asyncFrameGrabber::getDroppedFrames() const {
+    lock_.lock();
+    const int dropped = dropped_;
+    lock_.unlock();
+    return dropped;
+  }
+
+  bool asyncFrameGrabber::isActive() const {
+    return notNull(grabber_) && grabber_->isActive();
+  }
+
+  bool asyncFrameGrabber::init() {
+    if (isNull(grabber_)) {
+      setStatusString("No grabber given");
+      return false;
+    }
+    // the grabber cannot be initialized while it is grabbing
+    stop();
+    if (!grabber_->init()) {
+      setStatusString(grabber_->getStatusString());
+      return false;
+    }
+    return true;
+  }
+
+  bool asyncFrameGrabber::isInitialized() const {
+    return notNull(grabber_) && grabber_->isInitialized();
+  }
+
+  // -------------------------------------------------------------------
+  // eDeliveryPolicy read and write
+  // -------------------------------------------------------------------
+
+  bool read(ioHandler& handler,asyncFrameGrabber::eDeliveryPolicy& data) {
+    std::string str;
+    if (handler.read(str)) {
+      if (str.find("atest") != std::string::npos) {
+        data = asyncFrameGrabber::LatestFrame;
+      } else {
+        data = asyncFrameGrabber::AllFrames;
+      }
+      return true;
+    }
+    return false;
+  }
+
+  bool write(ioHandler& handler,
+             const asyncFrameGrabber::eDeliveryPolicy& data) {
+    bool b = false;
+    switch(data) {
+      case asyncFrameGrabber::AllFrames:
+        b = handler.write("AllFrames");
+        break;
+      case asyncFrameGrabber::LatestFrame:
+        b = handler.write("LatestFrame");
+        break;
+      default:
+        b = handler.write("AllFrames");
+        break;
+    }
+    return b;
+  }
+
+}
@@ -0,0 +1,546 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiAsyncFrameGrabber.h
+ *         Contains the class lti::asyncFrameGrabber, which grabs the frames
+ *         of another frame grabber in a background thread.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#ifndef _LTI_ASYNC_FRAME_GRABBER_H_
+#define _LTI_ASYNC_FRAME_GRABBER_H_
+
+#include "ltiFrameGrabber.h"
+#include "ltiMutex.h"
+#include "ltiSemaphore.h"
+#include "ltiTimer.h"
+
+#include <vector>
+#include <list>
+
+namespace lti {
+
+  /**
+   * Asynchronous frame grabber.
+   *
+   * The apply() methods of the frame grabbers are synchronous: the caller
+   * waits for the device, and the conversion of the frame to an image or
+   * channel takes place in its thread.  This class grabs the frames of
+   * another frame grabber in a background thread instead, so that the
+   * capture of the next frames overlaps with the processing of the
+   * current one.
+   *
+   * The grabbed frames are kept in a ring of images (or channels) reused
+   * for all frames, and the apply() methods hand out the frames by
+   * swapping the data with the given container, so that no memory is
+   * allocated or copied while capturing as long as the containers given to
+   * apply() have the size of the frames.  The delivery policy decides
+   * which frames are returned:
+   *
+   * - AllFrames: the frames are returned in capture order.  If the
+   *   consumer falls more than parameters::bufferCount frames behind, the
+   *   oldest frames are discarded.
+   * - LatestFrame: only the newest frame is kept, which minimizes the
+   *   latency for consumers that cannot keep up with the device.
+   *
+   * Each frame comes with its capture timestamp and the number of frames
+   * lost before it (see frameGrabber::frameInfo), either by the device
+   * (if the grabber reports them in frameGrabber::getLastFrameInfo()) or
+   * by this class.
+   *
+   * \code
+   * lti::v4l2 camera;
+   * lti::asyncFrameGrabber grabber(camera);
+   * lti::image img;
+   * lti::frameGrabber::frameInfo info;
+   *
+   * while (grabber.apply(img,info)) {
+   *   if (info.dropped > 0) {
+   *     std::cout << info.dropped << " frames lost" << std::endl;
+   *   }
+   *   // process img while the next frames are being captured
+   * }
+   * \endcode
+   *
+   * The capture starts with the first apply() or with start(), and
+   * continues until stop() is called, the parameters are changed or the
+   * grabber fails.  While capturing, the wrapped grabber must not be used
+   * by any other means.  The apply() methods must be called from one
+   * thread only.
+   *
+   * The parameters turnAround and snapShotMode inherited from
+   * frameGrabber::parameters are ignored: those of the wrapped grabber are
+   * used.
+   *
+   * @ingroup gAcquisition
+   */
+  class asyncFrameGrabber : public frameGrabber {
+  public:
+    /**
+     * Policy for the delivery of the grabbed frames
+     */
+    enum eDeliveryPolicy {
+      AllFrames,  /**< Deliver the frames in capture order */
+      LatestFrame /**< Deliver only the newest frame       */
+    };
+
+    /**
+     * The parameters for the class asyncFrameGrabber
+     */
+    class parameters : public frameGrabber::parameters {
+    public:
+      /**
+       * Default constructor
+       */
+      parameters();
+
+      /**
+       * Copy constructor
+       * @param other the parameters object to be copied
+       */
+      parameters(const parameters& other);
+
+      /**
+       * Destructor
+       */
+      ~parameters();
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& copy(const parameters& other);
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& operator=(const parameters& other);
+
+      /**
+       * Returns the name of this class.
+       */
+      virtual const std::string& name() const;
+
+      /**
+       * Returns a pointer to a clone of the parameters
+       */
+      virtual parameters* clone() const;
+
+      /**
+       * Returns a pointer to a new instance of the parameters
+       */
+      virtual parameters* newInstance() const;
+
+      /**
+       * Write the parameters in the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool write(ioHandler& handler,const bool complete=true) const;
+
+      /**
+       * Read the parameters from the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool read(ioHandler& handler,const bool complete=true);
+
+      // ------------------------------------------------
+      // the parameters
+      // ------------------------------------------------
+
+      /**
+       * Maximal number of grabbed frames waiting to be delivered with the
+       * AllFrames policy.
+       *
+       * The ring holds two more frames: the one being grabbed and the one
+       * being handed out.  With the LatestFrame policy only one frame
+       * waits.
+       *
+       * Default value: 4
+       */
+      int bufferCount;
+
+      /**
+       * Policy for the delivery of the frames.
+       *
+       * Default value: AllFrames
+       */
+      eDeliveryPolicy deliveryPolicy;
+
+      /**
+       * Grab channel8 frames instead of color images.
+       *
+       * Many grabbers deliver the gray values much faster than the color
+       * images (e.g. lti::v4l2 for YUV formats).  The apply() methods for
+       * images cast the grabbed channels if this is true, and the ones for
+       * channels cast the grabbed images otherwise.
+       *
+       * Default value: false
+       */
+      bool grabChannels;
+    };
+
+    /**
+     * Default constructor.  A grabber has to be given with useGrabber()
+     * before grabbing.
+     */
+    asyncFrameGrabber();
+
+    /**
+     * Constructor with the grabber to be used
+     */
+    asyncFrameGrabber(frameGrabber& grabber);
+
+    /**
+     * Constructor with the grabber to be used and the parameters
+     */
+    asyncFrameGrabber(frameGrabber& grabber,const parameters& par);
+
+    /**
+     * Copy constructor.  Both instances use the same grabber, but only
+     * one of them may be capturing at a time.
+     * @param other the object to be copied
+     */
+    asyncFrameGrabber(const asyncFrameGrabber& other);
+
+    /**
+     * Destructor.  Stops capturing.
+     */
+    virtual ~asyncFrameGrabber();
+
+    /**
+     * Returns the name of this class.
+     */
+    virtual const std::string& name() const;
+
+    /**
+     * Copy data of "other" functor.  The capture is stopped.
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    asyncFrameGrabber& copy(const asyncFrameGrabber& other);
+
+    /**
+     * Alias for copy member
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    asyncFrameGrabber& operator=(const asyncFrameGrabber& other);
+
+    /**
+     * Returns a pointer to a clone of this functor.
+     */
+    virtual asyncFrameGrabber* clone() const;
+
+    /**
+     * Returns a pointer to a new instance of this functor.
+     */
+    virtual asyncFrameGrabber* newInstance() const;
+
+    /**
+     * Returns used parameters
+     */
+    const parameters& getParameters() const;
+
+    /**
+     * Stops capturing, since the frames being grabbed may not correspond
+     * to the new parameters.
+     */
+    virtual bool updateParameters();
+
+    /**
+     * Use the given grabber.  It is not copied, so it must exist as long
+     * as it is used by this instance.  The capture is stopped.
+     */
+    void useGrabber(frameGrabber& grabber);
+
+    /**
+     * The grabber in use, or null if none was given.
+     */
+    frameGrabber* getGrabber() const;
+
+    /**
+     * Start capturing in the background.
+     *
+     * This is done automatically by the first apply(), but calling it
+     * before allows the first frames to be grabbed in advance.  It does
+     * nothing if already started, even if the grabber failed in between:
+     * call stop() to restart it.
+     *
+     * @return true if successful, false if no grabber was given or it could
+     *         not be initialized.
+     */
+    bool start();
+
+    /**
+     * Stop capturing, discarding all grabbed frames not yet delivered.
+     *
+     * Waits for the grabber to finish the frame it is grabbing.
+     */
+    void stop();
+
+    /**
+     * Returns true if the frames are being captured in the background.
+     *
+     * This becomes false if the grabber failed, even before the remaining
+     * grabbed frames have been delivered.
+     */
+    bool isCapturing() const;
+
+    /**
+     * @name Grabbing
+     *
+     * All methods wait for the next frame according to the delivery
+     * policy, starting the capture if required.  They return false with
+     * the status of the grabber after it failed and all frames grabbed
+     * before have been delivered.
+     */
+    //@{
+
+    /**
+     * Get the next (color) image
+     */
+    virtual bool apply(image& theImage);
+
+    /**
+     * Get the next grey value channel
+     */
+    virtual bool apply(channel8& theChannel);
+
+    /**
+     * Get the next (color) image and its frame information
+     */
+    bool apply(image& theImage,frameInfo& info);
+
+    /**
+     * Get the next grey value channel and its frame information
+     */
+    bool apply(channel8& theChannel,frameInfo& info);
+    //@}
+
+    /**
+     * Information about the last delivered frame.
+     *
+     * The timestamp is the one of the grabber if it provides frame
+     * information, otherwise the time in seconds between the start of the
+     * capture and the moment the frame was grabbed.  The dropped frames
+     * include those discarded by this class.
+     */
+    virtual bool getLastFrameInfo(frameInfo& info) const;
+
+    /**
+     * Total number of frames lost since the capture started, by the device
+     * or by this class.
+     */
+    int getDroppedFrames() const;
+
+    /**
+     * Check if the grabber is active
+     */
+    virtual bool isActive() const;
+
+    /**
+     * Initialize the grabber
+     */
+    virtual bool init();
+
+    /**
+     * Returns true if the grabber has been initialized
+     */
+    virtual bool isInitialized() const;
+
+  private:
+    /**
+     * A frame of the ring
+     */
+    class slot {
+    public:
+      /**
+       * The frame, in the member corresponding to parameters::grabChannels
+       */
+      //@{
+      image img;
+      channel8 chnl;
+      //@}
+
+      /**
+       * Information about the frame
+       */
+      frameInfo info;
+    };
+
+    /**
+     * Capture thread.  Defined in the implementation file.
+     */
+    class capturer;
+    friend class capturer;
+
+    /**
+     * Grab frames until stopped or the grabber fails
+     */
+    void capture();
+
+    /**
+     * Wait for the next frame to be delivered.
+     *
+     * @return the index of its slot, which must be released with
+     *         release(), or -1 if the capture failed.
+     */
+    int next();
+
+    /**
+     * Give the slot back to the ring
+     */
+    void release(const int idx);
+
+    /**
+     * Move the frame in the slot into the destination
+     */
+    //@{
+    void take(slot& s,image& dest) const;
+    void take(slot& s,channel8& dest) const;
+    //@}
+
+    /**
+     * Deliver the next frame
+     */
+    template<class T>
+    bool deliver(T& dest,frameInfo& info);
+
+    /**
+     * The grabber in use (not owned)
+     */
+    frameGrabber* grabber_;
+
+    /**
+     * Ring of frames
+     */
+    std::vector<slot> slots_;
+
+    /**
+     * Slots with frames waiting to be delivered, oldest first
+     */
+    std::list<int> ready_;
+
+    /**
+     * Slots available for grabbing
+     */
+    std::list<int> free_;
+
+    /**
+     * Maximal size of ready_
+     */
+    unsigned int capacity_;
+
+    /**
+     * Copy of parameters::grabChannels for the capture thread
+     */
+    bool grabChannels_;
+
+    /**
+     * Counts the frames in ready_, plus one when the capture ends
+     */
+    semaphore available_;
+
+    /**
+     * Protects the ring, the flags and the counters
+     */
+    mutable mutex lock_;
+
+    /**
+     * Flag to terminate the capture thread
+     */
+    bool stop_;
+
+    /**
+     * True while the capture thread is grabbing
+     */
+    bool capturing_;
+
+    /**
+     * Status string of the grabber when it failed
+     */
+    std::string error_;
+
+    /**
+     * Frames lost since the capture started
+     */
+    int dropped_;
+
+    /**
+     * Frames discarded since the last delivered one, including those lost
+     * by the device before them
+     */
+    int pendingDropped_;
+
+    /**
+     * Information about the last delivered frame
+     */
+    frameInfo lastFrame_;
+
+    /**
+     * True if a frame was delivered since the capture started
+     */
+    bool delivered_;
+
+    /**
+     * Time since the start of the capture, for grabbers without frame
+     * information
+     */
+    timer clock_;
+
+    /**
+     * The capture thread, or null if not started
+     */
+    capturer* thread_;
+  };
+
+  /**
+   * Read an asyncFrameGrabber::eDeliveryPolicy
+   *
+   * @ingroup gStorable
+   */
+  bool read(ioHandler& handler,asyncFrameGrabber::eDeliveryPolicy& data);
+
+  /**
+   * Write an asyncFrameGrabber::eDeliveryPolicy
+   *
+   * @ingroup gStorable
+   */
+  bool write(ioHandler& handler,
+             const asyncFrameGrabber::eDeliveryPolicy& data);
+
+}
+
+#endif
@@ -135,6 +135,18 @@ namespace lti {
   }
 
 
+  // --------------------------------------------------
+  // frameGrabber::frameInfo
+  // --------------------------------------------------
+
+  frameGrabber::frameInfo::frameInfo()
+    : timestamp(0.0), sequence(0), dropped(0) {
+  }
+
+  // --------------------------------------------------
+  // frameGrabber
+  // --------------------------------------------------
+
   // default constructor
   frameGrabber::frameGrabber() : functor() {
   }
@@ -193,6 +205,10 @@ namespace lti {
     return false;
   }
 
+  bool frameGrabber::getLastFrameInfo(frameInfo&) const {
+    return false;
+  }
+
 
 } // namespace lti
 
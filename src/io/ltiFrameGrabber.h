@@ -163,6 +163,38 @@ namespace lti {
       
     };
 
+    /**
+     * Information about a grabbed frame
+     */
+    class frameInfo {
+    public:
+      /**
+       * Default constructor
+       */
+      frameInfo();
+
+      /**
+       * Capture time of the frame in seconds.
+       *
+       * The origin of the time depends on the grabber, so only the
+       * differences between the timestamps of the same grabber are
+       * meaningful.
+       */
+      double timestamp;
+
+      /**
+       * Sequence number of the frame.  It is incremented for each frame
+       * captured by the device, including those which were lost.
+       */
+      uint32 sequence;
+
+      /**
+       * Number of frames lost between the previously delivered frame and
+       * this one.
+       */
+      int dropped;
+    };
+
     /**
      * Default constructor
      */
@@ -219,6 +251,18 @@ namespace lti {
      */
     virtual bool apply(channel& theChannel);
 
+    /**
+     * Get the information about the last grabbed frame.
+     *
+     * The default implementation returns false, since not all grabbers
+     * can provide it.
+     *
+     * @param info the information of the frame returned by the last
+     *             successful apply()
+     * @return true if the information is available, false otherwise
+     */
+    virtual bool getLastFrameInfo(frameInfo& info) const;
+
     /**
      * Check if the frame grabber / camera system is active
      */
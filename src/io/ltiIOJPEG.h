@@ -41,6 +41,7 @@
 #if defined HAVE_LIBJPEG || defined HAVE_LOCALJPEG
 
 #include "ltiIOImageInterface.h"
+#include "ltiRectangle.h"
 #include <fstream>
 
 #ifdef HAVE_LIBJPEG
@@ -100,6 +101,16 @@ namespace lti {
    * correct JPEG-files, and it is faster.  Mianos' implementation is mainly
    * for windows users who do not want to install the jpeglib.
    *
+   * With the libjpeg the loading can be considerably accelerated when only
+   * a smaller version or a part of the image is required (e.g. thumbnails or
+   * coarse pyramid levels): parameters::scaleDenominator lets the decoder
+   * compute the image directly at 1/2, 1/4 or 1/8 of its size, with only a
+   * fraction of the computations of a full decode, parameters::region
+   * restricts the decoding to a window of the image and parameters::fastDCT
+   * chooses a faster but less accurate inverse DCT.  If
+   * parameters::decodeLuminance is set, gray channels are decoded directly
+   * from the luminance component of the file, avoiding the color
+   * conversion.  These parameters are ignored by Mianos' implementation.
    */
   class ioJPEG : public ioImageInterface {
   public:
@@ -189,6 +200,59 @@ namespace lti {
        * Default is 0.
        */
       int rowsPerRestart;
+
+      /**
+       * Denominator of the scale factor used when loading.
+       *
+       * The image is decoded with 1/scaleDenominator of its width and
+       * height.  The scaling is done by the inverse DCT, which is then much
+       * cheaper than decoding the full image and downsampling it
+       * afterwards.  Valid values are 1, 2, 4 and 8.
+       *
+       * Default value: 1 (full size)
+       */
+      int scaleDenominator;
+
+      /**
+       * Use the fast integer inverse DCT when loading.
+       *
+       * It is faster than the default (accurate) integer DCT, at the cost of
+       * slightly less accurate results.
+       *
+       * Default value: false
+       */
+      bool fastDCT;
+
+      /**
+       * Decode gray channels directly from the luminance component.
+       *
+       * If true, the methods loading a matrix<ubyte>, matrix<float> or
+       * matrix<int32> decode only the luminance (Y) component of color
+       * JPEG files, skipping the decoding of the chroma components and the
+       * conversion to RGB.  Note that the luminance is a weighted sum of
+       * R, G and B, while these methods return the mean of R, G and B if
+       * this parameter is false.  Gray valued files produce the same result
+       * in both cases.
+       *
+       * Default value: false
+       */
+      bool decodeLuminance;
+
+      /**
+       * Region of the image to be loaded.
+       *
+       * The coordinates are given in the decoded image, i.e. after the
+       * scaling with scaleDenominator.  The region is clipped to the image
+       * size, and the loaded image has the size of the clipped region.
+       * Rows below the region are not decoded at all, and with
+       * libjpeg-turbo the rows above and the columns outside the region
+       * are mostly skipped too.
+       *
+       * Default value: (0,0,std::numeric_limits<int>::max(),
+       *                     std::numeric_limits<int>::max()),
+       *                i.e. the whole image
+       */
+      irectangle region;
     };
 
     /**
@@ -316,10 +380,20 @@ namespace lti {
   private:
 #ifdef HAVE_LIBJPEG
     /**
-     * method for loading a JPEG image from an already opened
-     * file.
+     * Method for loading a JPEG image from an already opened
+     * file, either as a color image or as a gray channel.
+     *
+     * @param file file to read
+     * @param theImage if not null, the image is stored here
+     * @param theChannel if not null (and theImage is null) only the
+     *        luminance of the image is decoded and stored here
+     * @param isGray will be set with true if the file contains only gray
+     *        values.
      */
-    bool load(FILE* file,image& theImage,bool& isGray);
+    bool load(FILE* file,
+              image* theImage,
+              matrix<ubyte>* theChannel,
+              bool& isGray);
 #endif
   public:
 
@@ -45,8 +45,12 @@
 #include "ltiFactory.h"
 #include "ltiUsePalette.h"
 #include "ltiChannel8.h"
+#include "ltiChannel.h"
+#include "ltiMath.h"
 
 #include <cstdio>
+#include <cstring>
+#include <limits>
 #include <setjmp.h>
 
 extern "C" {
@@ -92,6 +96,12 @@ namespace lti {
     progressive    = false;
     comment        = "";
     rowsPerRestart = 0;
+    scaleDenominator = 1;
+    fastDCT = false;
+    decodeLuminance = false;
+    region = irectangle(0,0,
+                        std::numeric_limits<int>::max(),
+                        std::numeric_limits<int>::max());
   }
   
   ioJPEG::parameters::parameters(const parameters& other) 
@@ -109,6 +119,10 @@ namespace lti {
     progressive = other.progressive;
     comment = other.comment;
     rowsPerRestart = other.rowsPerRestart;
+    scaleDenominator = other.scaleDenominator;
+    fastDCT = other.fastDCT;
+    decodeLuminance = other.decodeLuminance;
+    region.copy(other.region);
     
     return (*this);
   }
@@ -144,6 +158,10 @@ namespace lti {
       lti::write(handler,"progressive",progressive);
       lti::write(handler,"comment",comment);
       lti::write(handler,"rowsPerRestart",rowsPerRestart);
+      lti::write(handler,"scaleDenominator",scaleDenominator);
+      lti::write(handler,"fastDCT",fastDCT);
+      lti::write(handler,"decodeLuminance",decodeLuminance);
+      lti::write(handler,"region",region);
     }
 
     b = b && ioImageInterface::parameters::write(handler,false);
@@ -167,6 +185,10 @@ namespace lti {
       lti::read(handler,"progressive",progressive);
       lti::read(handler,"comment",comment);
       lti::read(handler,"rowsPerRestart",rowsPerRestart);
+      lti::read(handler,"scaleDenominator",scaleDenominator);
+      lti::read(handler,"fastDCT",fastDCT);
+      lti::read(handler,"decodeLuminance",decodeLuminance);
+      lti::read(handler,"region",region);
     }
 
     b = b && ioImageInterface::parameters::read(handler,false);
@@ -236,7 +258,7 @@ namespace lti {
       return false;
     }
 
-    bool res = load(fp,theImage,isGray);
+    bool res = load(fp,&theImage,0,isGray);
 
     fclose(fp);
 
@@ -252,6 +274,24 @@ namespace lti {
   bool ioJPEG::load(const std::string& filename,
                     matrix<ubyte>& theImage,
                     palette& colors) {
+    if (getParameters().decodeLuminance) {
+      FILE* fp;
+      if ((fp = fopen(filename.c_str(), "rb")) == NULL) {
+        setStatusString("File could not be found: ");
+        appendStatusString(filename.c_str());
+        return false;
+      }
+
+      bool isGray;
+      const bool res = load(fp,0,&theImage,isGray);
+      fclose(fp);
+
+      if (res) {
+        colors.copy(getGrayPalette());
+      }
+      return res;
+    }
+
     bool isGray;
     image img;
     if (load(filename,img,isGray)) {
@@ -272,6 +312,16 @@ namespace lti {
 
   bool ioJPEG::load(const std::string& filename,
                     matrix<float>& chnl) {
+    if (getParameters().decodeLuminance) {
+      channel8 chnl8;
+      if (load(filename,chnl8)) {
+        channel tmp;
+        tmp.castFrom(chnl8);
+        chnl.swap(tmp);
+        return true;
+      }
+      return false;
+    }
     return ioImageInterface::load(filename,chnl);
   }
 
@@ -288,9 +338,24 @@ namespace lti {
   
   // load the picture defined in parameters, determine whether a gray
   // scale image was loaded, while using libJPEG
-  bool ioJPEG::load(FILE* fp, image& theImage, bool& isGray) {
+  bool ioJPEG::load(FILE* fp,
+                    image* theImage,
+                    matrix<ubyte>* theChannel,
+                    bool& isGray) {
+    const parameters& par = getParameters();
+
     // clear image:
-    theImage.clear();
+    if (notNull(theImage)) {
+      theImage->clear();
+    } else {
+      theChannel->clear();
+    }
+
+    if ((par.scaleDenominator != 1) && (par.scaleDenominator != 2) &&
+        (par.scaleDenominator != 4) && (par.scaleDenominator != 8)) {
+      setStatusString("Invalid scaleDenominator (valid are 1, 2, 4 and 8)");
+      return false;
+    }
 
     // contains JPEG decompression parameters and pointers to working place
     struct jpeg_decompress_struct compressInfo;
@@ -298,8 +363,6 @@ namespace lti {
     struct my_error_mgr jpegErrorHandler;
     //output row buffer
     JSAMPARRAY outputBuffer;
-    // physical row width in output buffer
-    int rowStride, height, width; //, rowCounter;
 
     // set up the normal JPEG error routines
     compressInfo.err = jpeg_std_error(&jpegErrorHandler.pub);
@@ -320,56 +383,129 @@ namespace lti {
     // read file parameters
     jpeg_read_header(&compressInfo, TRUE);
 
+    isGray = (compressInfo.jpeg_color_space == JCS_GRAYSCALE);
+
+    // for channels only the luminance is decoded (no color conversion)
+    if (isNull(theImage)) {
+      compressInfo.out_color_space = JCS_GRAYSCALE;
+    }
+
+    // the scaling is done by the inverse DCT
+    compressInfo.scale_num = 1;
+    compressInfo.scale_denom = par.scaleDenominator;
+
+    if (par.fastDCT) {
+      compressInfo.dct_method = JDCT_IFAST;
+    }
+
     // Start decompressor
     jpeg_start_decompress(&compressInfo);
 
-    // JSAMPLEs per row in output buffer
-    rowStride = compressInfo.output_width * compressInfo.output_components;
-    // rowCounter = 0;
-    height = compressInfo.output_height;
-    width = compressInfo.output_width;
-    theImage.allocate(height, width);
+    const int components = compressInfo.output_components;
+    if ((components != 1) && (components != 3)) {
+      jpeg_destroy_decompress(&compressInfo);
+      setStatusString("Unknown image format!");
+      return false;
+    }
+
+    // the region to be decoded in the scaled image
+    irectangle area(par.region);
+    area.intersect(irectangle(0,0,
+                              compressInfo.output_width-1,
+                              compressInfo.output_height-1));
+    if (!area.isConsistent()) {
+      jpeg_destroy_decompress(&compressInfo);
+      setStatusString("Region outside the image");
+      return false;
+    }
+    const int width = area.br.x - area.ul.x + 1;
+    const int height = area.br.y - area.ul.y + 1;
+
+    // first column of the region in the decoded rows
+    int offset = area.ul.x;
+
+#ifdef LIBJPEG_TURBO_VERSION_NUMBER
+    // decode only the iMCU columns covering the region (the first column
+    // is moved to an iMCU boundary and the width enlarged accordingly).
+    // One more column is kept on each side, since the upsampling of the
+    // chroma components treats the pixels at the borders of the cropped
+    // rows differently.
+    if (width < static_cast<int>(compressInfo.output_width)) {
+      const int first = max(0,area.ul.x-1);
+      const int last = min(static_cast<int>(compressInfo.output_width)-1,
+                           area.br.x+1);
+      JDIMENSION xoffset = first;
+      JDIMENSION cropWidth = last - first + 1;
+      jpeg_crop_scanline(&compressInfo,&xoffset,&cropWidth);
+      offset = area.ul.x - static_cast<int>(xoffset);
+    }
+
+    // skip the rows above the region (mostly without decoding them)
+    if (area.ul.y > 0) {
+      jpeg_skip_scanlines(&compressInfo,area.ul.y);
+    }
+#endif
 
-    // Make a one-row-high sample array that will go away when done with image
+    // several rows are read at once, which reduces the overhead of the
+    // calls to the library
+    const int bufferRows = min(16,height);
+    const int rowStride = compressInfo.output_width * components;
     outputBuffer = (*compressInfo.mem->alloc_sarray)
-      ((j_common_ptr) &compressInfo,JPOOL_IMAGE, rowStride, 1);
+      ((j_common_ptr) &compressInfo,JPOOL_IMAGE, rowStride, bufferRows);
+
+    // rows above the region not skipped by the library are decoded and
+    // discarded
+    while (static_cast<int>(compressInfo.output_scanline) < area.ul.y) {
+      jpeg_read_scanlines(&compressInfo, outputBuffer,
+                          min(bufferRows,
+                              area.ul.y -
+                              static_cast<int>(compressInfo.output_scanline)));
+    }
+
+    if (notNull(theImage)) {
+      theImage->allocate(height, width);
+    } else {
+      theChannel->allocate(height, width);
+    }
 
     // Use the library's state variable compressInfo.output_scanline
     // as the loop counter
-    image::iterator it = theImage.begin();
-    JSAMPLE *ptr,*eptr;
-
-    if (compressInfo.output_components == 1) {
-      isGray = true;
-      while (compressInfo.output_scanline < compressInfo.output_height) {
-        jpeg_read_scanlines(&compressInfo, outputBuffer, 1);
-        ptr = outputBuffer[0];
-        eptr = ptr+compressInfo.output_width;
-        ubyte val;
-        // in case of grayscale image
-        for (;ptr != eptr;++ptr,++it) {
-          val = *ptr;
-          (*it).set(val,val,val,0);
-        }
-      }
-    } else if (compressInfo.output_components == 3) {
-      isGray = false;
-      while (compressInfo.output_scanline < compressInfo.output_height) {
-        jpeg_read_scanlines(&compressInfo, outputBuffer, 1);
-        ptr = outputBuffer[0];
-        eptr = ptr+(3*compressInfo.output_width);
-        // in case of color image
-        for (;ptr != eptr;++it,ptr+=3) {
-          (*it).set(ptr[0], ptr[1], ptr[2], 0);
+    int y = 0;
+    while (y < height) {
+      const int lines =
+        jpeg_read_scanlines(&compressInfo, outputBuffer,
+                            min(bufferRows,height-y));
+
+      for (int i=0;i<lines;++i,++y) {
+        const JSAMPLE* ptr = outputBuffer[i] + offset*components;
+
+        if (isNull(theImage)) {
+          memcpy(&theChannel->at(y,0),ptr,width);
+        } else {
+          vector<rgbaPixel>::iterator it = theImage->getRow(y).begin();
+          const vector<rgbaPixel>::iterator eit = theImage->getRow(y).end();
+          if (components == 1) {
+            // in case of grayscale image
+            for (;it != eit;++ptr,++it) {
+              (*it).set(*ptr,*ptr,*ptr,0);
+            }
+          } else {
+            // in case of color image
+            for (;it != eit;++it,ptr+=3) {
+              (*it).set(ptr[0], ptr[1], ptr[2], 0);
+            }
+          }
         }
       }
-    } else {
-      setStatusString("Unknown image format!");
-      return false;
     }
 
-    // Finish decompression
-    jpeg_finish_decompress(&compressInfo);
+    if (compressInfo.output_scanline < compressInfo.output_height) {
+      // the rows below the region are not required
+      jpeg_abort_decompress(&compressInfo);
+    } else {
+      // Finish decompression
+      jpeg_finish_decompress(&compressInfo);
+    }
 
     // Release JPEG decompression object, close the file
     jpeg_destroy_decompress(&compressInfo);
@@ -54,6 +54,7 @@
 #include "ltiImage.h"
 #include "ltiFactory.h"
 #include "ltiEndianness.h"
+#include "ltiMappedFileAllocator.h"
 
 #include <fstream>
 #include <vector>
@@ -70,6 +71,8 @@ namespace lti {
 
   ioLTI::parameters::parameters() : ioImageInterface::parameters() {
     codec = "lti::identityCodec";
+    alignData = false;
+    memoryMapping = false;
   }
   
   ioLTI::parameters::parameters(const parameters& other) 
@@ -80,6 +83,8 @@ namespace lti {
   ioLTI::parameters& ioLTI::parameters::copy(const parameters& other) {
     ioImageInterface::parameters::copy(other);
     codec = other.codec;
+    alignData = other.alignData;
+    memoryMapping = other.memoryMapping;
 
     return (*this);
   }
@@ -112,6 +117,8 @@ namespace lti {
     
     if (b) {
       lti::write(handler,"codec",codec);
+      lti::write(handler,"alignData",alignData);
+      lti::write(handler,"memoryMapping",memoryMapping);
     }
     
     b = b && ioImageInterface::parameters::write(handler,false);
@@ -139,6 +146,8 @@ namespace lti {
 
     if (b) {
       lti::read(handler,"codec",codec);
+      lti::read(handler,"alignData",alignData);
+      lti::read(handler,"memoryMapping",memoryMapping);
     }
 
     b = b && ioImageInterface::parameters::read(handler,false);
@@ -155,12 +164,13 @@ namespace lti {
   // -------------------------------------------------------
 
   ioLTI::header::header() : type(0x544c),contents(0),compression(0),size(0),
-                            reserved1(0),reserved2(0),rows(0),columns(0),
+                            padding(0),reserved2(0),rows(0),columns(0),
                             codec("lti::identityCodec") {
   }
 
   int ioLTI::header::length() const {
-    return (compression<3)?24:(24+static_cast<int>(codec.length())+1);
+    return ((compression<3)?24:(24+static_cast<int>(codec.length())+1)) +
+           static_cast<int>(padding);
   }
 
   bool ioLTI::header::read(std::ifstream &in) {
@@ -177,7 +187,7 @@ namespace lti {
     io::read(in,contents);
     io::read(in,compression);
     io::read(in,size);
-    io::read(in,tmpReserved); // just ignore the readed data!
+    io::read(in,padding);
     io::read(in,tmpReserved); // just ignore the readed data!
     io::read(in,rows);
     io::read(in,columns);
@@ -207,7 +217,10 @@ namespace lti {
       }
     }
 
-    return true;
+    // skip the zeros aligning the data section
+    in.ignore(padding);
+
+    return in.good();
   }
 
   bool ioLTI::header::write(std::ofstream &out) const {
@@ -217,7 +230,7 @@ namespace lti {
     io::write(out,contents);
     io::write(out,compression);
     io::write(out,size);
-    io::write(out,reserved1);
+    io::write(out,padding);
     io::write(out,reserved2);
     io::write(out,rows);
     io::write(out,columns);
@@ -229,6 +242,10 @@ namespace lti {
       io::write(out,static_cast<ubyte>(0));
     }
 
+    for (uint32 i=0;i<padding;++i) {
+      io::write(out,static_cast<ubyte>(0));
+    }
+
     return true;
   }
 
@@ -253,13 +270,14 @@ namespace lti {
       return false;
     }
 
-    return loadMatrix(in,theChannel,theHeader);
+    return loadMatrix(in,theChannel,theHeader,filename);
   }
 
   template<typename T>
   bool ioLTI::loadMatrix(std::ifstream& in,
                          matrix<T>& theChannel,
-                         header& theHeader) const {
+                         header& theHeader,
+                         const std::string& filename) const {
     theChannel.clear();
     
     //open failed?
@@ -330,7 +348,16 @@ namespace lti {
       delete codec;
       return false;
     } else {
-      bool flag=loadBody(in,theChannel,theHeader,codec);
+      bool flag=false;
+      if (!filename.empty() && getParameters().memoryMapping &&
+          (theHeader.compression == 0)) {
+        // uncompressed data can be used directly from the file
+        const std::streamoff offset = in.tellg();
+        flag = (offset > 0) &&
+               mapBody(filename,static_cast<size_t>(offset),
+                       theChannel,theHeader);
+      }
+      flag = flag || loadBody(in,theChannel,theHeader,codec);
       in.close();
       delete codec;
       return flag;
@@ -404,6 +431,14 @@ namespace lti {
     theHeader.size = encsize;
     theHeader.rows = theChannel.rows();
     theHeader.columns = theChannel.columns();
+
+    theHeader.padding = 0;
+    if (getParameters().alignData) {
+      const int misalignment = theHeader.length() % DataAlignment;
+      if (misalignment != 0) {
+        theHeader.padding = DataAlignment - misalignment;
+      }
+    }
     
     // write the header
     if (!theHeader.write(out)) {
@@ -445,10 +480,41 @@ namespace lti {
     
   }
   
+  /*
+   * Maps the matrix data at the given offset of the file into memory.
+   */
+  template<typename T>
+  bool ioLTI::mapBody(const std::string& filename,
+                      const size_t offset,
+                      matrix<T>& theChannel,
+                      const header& theHeader) const {
+    const size_t bytes =
+      static_cast<size_t>(theHeader.rows)*theHeader.columns*sizeof(T);
+
+    // the elements of all LTI file types require at most the alignment
+    // of a double
+    if ((bytes == 0) || (theHeader.size != bytes) ||
+        ((offset % sizeof(double)) != 0)) {
+      return false;
+    }
+
+    mappedFileAllocator& alloc = mappedFileAllocator::getShared();
+    T* data = static_cast<T*>(alloc.map(filename,offset,bytes));
+    if (isNull(data)) {
+      return false;
+    }
+
+    // the matrix takes the mapping, which is removed with its data
+    theChannel.attach(theHeader.rows,theHeader.columns,data,&alloc);
+    return true;
+  }
+
   // ----------------------------------------------------------------------
   // ioLTI
   // ----------------------------------------------------------------------
 
+  const int ioLTI::DataAlignment;
+
   // constructor
   ioLTI::ioLTI() : ioImageInterface() {
     parameters par;
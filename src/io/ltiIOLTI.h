@@ -185,6 +185,45 @@ namespace lti {
        * Default value: "lti::identityCodec", i.e. do not compress.
        */
       std::string codec;
+
+      /**
+       * Align the data section to page boundaries when saving.
+       *
+       * If true, the header is padded with zeros, so that the data starts
+       * at a multiple of ioLTI::DataAlignment bytes in the file.  This
+       * allows the operating system to map the data section on its own
+       * (see memoryMapping), and ensures the alignment of the mapped
+       * data for SIMD access.
+       *
+       * Files saved with this option cannot be read by older versions of
+       * the library, which expected no padding.
+       *
+       * Default value: false
+       */
+      bool alignData;
+
+      /**
+       * Map uncompressed files into memory instead of reading them.
+       *
+       * If true, the load() methods taking a file name do not read the
+       * data of uncompressed files (saved with the lti::identityCodec), but
+       * map the file into memory, and the loaded matrix uses the mapped
+       * region as its data (see lti::mappedFileAllocator).  Loading is
+       * therefore almost instantaneous, the pages of the file are read
+       * only when they are accessed, and several processes loading the
+       * same file share the same physical memory.  The mapping is removed
+       * when the matrix releases its data.
+       *
+       * The matrix can be modified as usual, but the modified pages are
+       * copied, and the changes are never written back to the file.  The
+       * file must not be truncated or overwritten while it is mapped.
+       *
+       * Compressed files, or files whose data section is not properly
+       * aligned, are read as usual.
+       *
+       * Default value: false
+       */
+      bool memoryMapping;
     };
 
     /**
@@ -229,10 +268,13 @@ namespace lti {
       uint32 size;
 
       /**
-       * Must be 0
-       * This can be used in the future.
+       * Number of zero bytes between the header and the data section.
+       *
+       * It is used to align the data section to page boundaries (see
+       * ioLTI::parameters::alignData).  Older versions of the format
+       * required 0 here.
        */
-      const uint32 reserved1;
+      uint32 padding;
 
       /**
        * Must be 0
@@ -279,11 +321,17 @@ namespace lti {
       bool write(std::ofstream& out) const;
 
       /**
-       * Size of the header (in bytes)
+       * Size of the header (in bytes), including the padding
        */
       int length() const;
     };
 
+    /**
+     * Alignment in bytes of the data section of the files saved with
+     * parameters::alignData.
+     */
+    static const int DataAlignment = 4096;
+
   public:
     /**
      * Default constructor
@@ -436,14 +484,16 @@ namespace lti {
      * Loads a matrix from the given stream. 
      *
      * The data are written into theChannel, the meta-data are written
-     * into theHeader.  These methods ignore all the parameters in this
-     * objects.  The only reason they are not static is that they
-     * modify the status string.
+     * into theHeader.  If the name of the file of the stream is given,
+     * the data may be mapped into memory instead of read (see
+     * parameters::memoryMapping).  Otherwise these methods ignore all the
+     * parameters in this object.
      */
     template<typename T>
     bool loadMatrix(std::ifstream& in,
                     matrix<T>& theChannel,
-                    header& theHeader) const;
+                    header& theHeader,
+                    const std::string& filename = std::string()) const;
 
     
     /**
@@ -477,6 +527,18 @@ namespace lti {
                   const header& theHeader,
                   dataCodec* codec) const;
 
+    /**
+     * Maps the matrix data at the given offset of the file into memory.
+     * The meta-data must be passed in the given header.
+     *
+     * @return true if successful, false if the data cannot be mapped.
+     */
+    template<typename T>
+    bool mapBody(const std::string& filename,
+                 const size_t offset,
+                 matrix<T>& theChannel,
+                 const header& theHeader) const;
+
     /**
      * Methods used to return the code type
      */
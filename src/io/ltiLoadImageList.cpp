@@ -31,6 +31,10 @@
  */
 
 #include "ltiLoadImageList.h"
+#include "ltiThread.h"
+#include "ltiThreadPool.h"
+#include "ltiMutex.h"
+#include "ltiSemaphore.h"
 
 //includes for reading directory entries. Defaults to *NIX system
 #ifdef _LTI_WIN32
@@ -45,6 +49,7 @@
 #endif
 
 #include <fstream>
+#include <iterator>
 
 namespace lti {
   // --------------------------------------------------
@@ -57,6 +62,8 @@ namespace lti {
     
     continueOnError = false;
     fileType = "ALL";
+    prefetchSize = 0;
+    decoderThreads = 1;
   }
 
   // copy constructor
@@ -77,6 +84,8 @@ namespace lti {
 
       continueOnError = other.continueOnError;
       fileType = other.fileType;
+      prefetchSize = other.prefetchSize;
+      decoderThreads = other.decoderThreads;
 
     return *this;
   }
@@ -120,6 +129,8 @@ namespace lti {
       
       lti::write(handler,"continueOnError",continueOnError);
       lti::write(handler,"fileType",fileType);
+      lti::write(handler,"prefetchSize",prefetchSize);
+      lti::write(handler,"decoderThreads",decoderThreads);
     }
 
     b = b && parametersManager::parameters::write(handler,false);
@@ -149,6 +160,8 @@ namespace lti {
       
       lti::read(handler,"continueOnError",continueOnError);
       lti::read(handler,"fileType",fileType);
+      lti::read(handler,"prefetchSize",prefetchSize);
+      lti::read(handler,"decoderThreads",decoderThreads);
     }
 
     b = b && parametersManager::parameters::read(handler,false);
@@ -164,11 +177,131 @@ namespace lti {
   // loadImageList
   // --------------------------------------------------
 
+  /**
+   * The prefetcher decodes the files from a given list position on in its
+   * decoder threads.  The decoded files are kept in a ring of slots: the
+   * file with index i (counted from the start position) is decoded into the
+   * slot i modulo the number of slots.  The semaphore free_ counts the
+   * slots available for decoding, so that at most as many files as slots
+   * are decoded ahead of the consumer, and each slot has a semaphore
+   * posted when its file is ready.  Files are claimed for decoding in list
+   * order, so that the consumer always waits for the oldest one.
+   */
+  class loadImageList::prefetcher {
+  public:
+    /**
+     * Start decoding the files in [first,last)
+     */
+    prefetcher(const ioImage& loader,
+               const eDataKind kind,
+               const std::list<std::string>::const_iterator& first,
+               const std::list<std::string>::const_iterator& last,
+               const int slots,
+               const int threads);
+
+    /**
+     * Stop decoding and wait for the decoders to terminate
+     */
+    ~prefetcher();
+
+    /**
+     * Wait for the file at the current position
+     */
+    decodedFile& wait();
+
+    /**
+     * Release the file at the current position and advance it
+     */
+    void release();
+
+    /**
+     * Kind of data decoded
+     */
+    const eDataKind kind;
+
+    /**
+     * Position in the list of the file returned by the next wait()
+     */
+    std::list<std::string>::const_iterator position;
+
+  private:
+    /**
+     * Decoding thread with its own ioImage
+     */
+    class decoder : public thread {
+    public:
+      decoder(prefetcher& owner,const ioImage& loader)
+        : thread(), owner_(owner), loader_(loader) {
+      }
+
+    protected:
+      virtual void run() {
+        owner_.work(loader_);
+      }
+
+      prefetcher& owner_;
+      ioImage loader_;
+    };
+    friend class decoder;
+
+    /**
+     * Decode files until all are done or the prefetcher is stopped
+     */
+    void work(ioImage& loader);
+
+    /**
+     * Files to be decoded
+     */
+    std::vector<std::string> files_;
+
+    /**
+     * Ring of decoded files
+     */
+    std::vector<decodedFile> slots_;
+
+    /**
+     * One semaphore for each slot, posted when its file is decoded
+     */
+    std::vector<semaphore*> ready_;
+
+    /**
+     * Number of slots available for decoding
+     */
+    semaphore free_;
+
+    /**
+     * Protects next_ and stop_
+     */
+    mutex lock_;
+
+    /**
+     * Index of the next file to be decoded
+     */
+    int next_;
+
+    /**
+     * Index of the next file to be returned by wait()
+     */
+    int current_;
+
+    /**
+     * Flag to terminate the decoders
+     */
+    bool stop_;
+
+    /**
+     * Decoding threads
+     */
+    std::vector<decoder*> decoders_;
+  };
+
+
   const std::string loadImageList::emptyString_ = "";
 
   // default constructor
   loadImageList::loadImageList()
-    : object(), parametersManager(), status(), loader_() {
+    : object(), parametersManager(), status(), loader_(),
+      lastDecodeTime_(0.0), prefetcher_(0) {
 
     // create an instance of the parameters with the default values
     parameters defaultParameters;
@@ -178,7 +311,8 @@ namespace lti {
 
   // default constructor
   loadImageList::loadImageList(const parameters& par)
-    : object(), parametersManager(), status(), loader_() {
+    : object(), parametersManager(), status(), loader_(),
+      lastDecodeTime_(0.0), prefetcher_(0) {
 
     // set the given parameters
     setParameters(par);
@@ -186,23 +320,30 @@ namespace lti {
 
   // copy constructor
   loadImageList::loadImageList(const loadImageList& other)
-    : object(), parametersManager(), status(), loader_() {
+    : object(), parametersManager(), status(), loader_(),
+      lastDecodeTime_(0.0), prefetcher_(0) {
     copy(other);
   }
 
   // destructor
   loadImageList::~loadImageList() {
+    stopPrefetch();
   }
 
   // copy member
   loadImageList& 
   loadImageList::copy(const loadImageList& other) {
+    stopPrefetch();
     parametersManager::copy(other);
 
     loader_.copy(other.loader_);
     filenames_.assign(other.filenames_.begin(), other.filenames_.end());
+    // same position as in the other list
+    it_ = filenames_.begin();
+    std::advance(it_,std::distance(other.filenames_.begin(),other.it_));
     loadAllImageTypes_ = other.loadAllImageTypes_;
     fileExt_ = other.fileExt_;
+    lastDecodeTime_ = other.lastDecodeTime_;
 
     return (*this);
   }
@@ -241,6 +382,9 @@ namespace lti {
 
   bool loadImageList::updateParameters() {
 
+    // files being decoded may not correspond to the new parameters
+    stopPrefetch();
+
     std::string ext = getParameters().fileType;
 
     std::string::iterator it;
@@ -271,6 +415,7 @@ namespace lti {
   }
 
   void loadImageList::rewind() {
+    stopPrefetch();
     it_ = filenames_.begin();
   }
 
@@ -279,6 +424,10 @@ namespace lti {
   }
 
   void loadImageList::skip() {
+    if (notNull(prefetcher_) && (prefetcher_->position == it_)) {
+      prefetcher_->wait();
+      prefetcher_->release();
+    }
     ++it_;
   }
 
@@ -288,6 +437,7 @@ namespace lti {
 
   bool loadImageList::useDirectory(const std::string& dirname,const bool rec) {
 
+    stopPrefetch();
     filenames_.clear();
 
     std::string err;
@@ -411,6 +561,7 @@ namespace lti {
 
   bool loadImageList::useFileList(const std::string& filename) {
 
+    stopPrefetch();
     filenames_.clear();
     
     std::ifstream is;
@@ -483,6 +634,10 @@ namespace lti {
     }
   }
 
+  double loadImageList::getLastDecodeTime() const {
+    return lastDecodeTime_;
+  }
+
   bool loadImageList::load(image& img) {
     return loadHelp(img);
   }
@@ -545,6 +700,224 @@ namespace lti {
   }
   
 
+  // -------------------------------------------------------------------
+  // prefetching
+  // -------------------------------------------------------------------
+
+  loadImageList::decodedFile::decodedFile()
+    : ok(false), error(), time(0.0) {
+  }
+
+  void loadImageList::decodedFile::decode(ioImage& loader,
+                                          const std::string& filename,
+                                          const eDataKind kind) {
+    timer chron(timer::Wall);
+    chron.start();
+    switch(kind) {
+    case ImageData:
+      ok = loader.load(filename,img_);
+      break;
+    case Channel8Data:
+      ok = loader.load(filename,chnl8_);
+      break;
+    case Channel8PaletteData:
+      ok = loader.load(filename,chnl8_,pal_);
+      break;
+    case ChannelData:
+      ok = loader.load(filename,chnl_);
+      break;
+    case Channel32Data:
+      ok = loader.load(filename,chnl32_);
+      break;
+    case Channel32PaletteData:
+      ok = loader.load(filename,chnl32_,pal_);
+      break;
+    default:
+      ok = false;
+    }
+    time = chron.getTime();
+
+    if (ok) {
+      error.clear();
+    } else {
+      // same message as status::appendStatusString(loader)
+      error = loader.name() + ": " + loader.getStatusString();
+    }
+  }
+
+  void loadImageList::decodedFile::get(image& dest) {
+    dest.swap(img_);
+    img_.clear();
+  }
+
+  void loadImageList::decodedFile::get(matrix<ubyte>& dest) {
+    dest.swap(chnl8_);
+    chnl8_.clear();
+  }
+
+  void loadImageList::decodedFile::get(matrix<float>& dest) {
+    dest.swap(chnl_);
+    chnl_.clear();
+  }
+
+  void loadImageList::decodedFile::get(matrix<int32>& dest) {
+    dest.swap(chnl32_);
+    chnl32_.clear();
+  }
+
+  void loadImageList::decodedFile::get(palette& dest) {
+    dest.swap(pal_);
+    pal_.clear();
+  }
+
+  loadImageList::prefetcher::prefetcher(
+                   const ioImage& loader,
+                   const eDataKind theKind,
+                   const std::list<std::string>::const_iterator& first,
+                   const std::list<std::string>::const_iterator& last,
+                   const int slots,
+                   const int threads)
+    : kind(theKind), position(first), files_(first,last),
+      slots_(slots), ready_(slots), free_(slots),
+      next_(0), current_(0), stop_(false) {
+
+    int i;
+    for (i=0;i<slots;++i) {
+      ready_[i] = new semaphore(0);
+    }
+
+    // more threads than slots or files would have nothing to do
+    const int n = min(threads,slots,static_cast<int>(files_.size()));
+    decoders_.resize(n);
+    for (i=0;i<n;++i) {
+      decoders_[i] = new decoder(*this,loader);
+      decoders_[i]->start();
+    }
+  }
+
+  loadImageList::prefetcher::~prefetcher() {
+    lock_.lock();
+    stop_ = true;
+    lock_.unlock();
+
+    // wake up the decoders waiting for free slots
+    const int n = static_cast<int>(decoders_.size());
+    int i;
+    for (i=0;i<n;++i) {
+      free_.post();
+    }
+    for (i=0;i<n;++i) {
+      decoders_[i]->join();
+      delete decoders_[i];
+    }
+
+    for (i=0;i<static_cast<int>(ready_.size());++i) {
+      delete ready_[i];
+    }
+  }
+
+  void loadImageList::prefetcher::work(ioImage& loader) {
+    const int numFiles = static_cast<int>(files_.size());
+    const int numSlots = static_cast<int>(slots_.size());
+    for (;;) {
+      free_.wait();
+
+      lock_.lock();
+      if (stop_ || (next_ >= numFiles)) {
+        lock_.unlock();
+        // pass the wake up on to the other decoders
+        free_.post();
+        return;
+      }
+      const int idx = next_++;
+      lock_.unlock();
+
+      const int slot = idx % numSlots;
+      slots_[slot].decode(loader,files_[idx],kind);
+      ready_[slot]->post();
+    }
+  }
+
+  loadImageList::decodedFile& loadImageList::prefetcher::wait() {
+    const int slot = current_ % static_cast<int>(slots_.size());
+    ready_[slot]->wait();
+    return slots_[slot];
+  }
+
+  void loadImageList::prefetcher::release() {
+    ++current_;
+    ++position;
+    free_.post();
+  }
+
+  loadImageList::eDataKind loadImageList::dataKind(const image&,
+                                                   const bool) {
+    return ImageData;
+  }
+
+  loadImageList::eDataKind loadImageList::dataKind(const matrix<ubyte>&,
+                                                   const bool withPalette) {
+    return withPalette ? Channel8PaletteData : Channel8Data;
+  }
+
+  loadImageList::eDataKind loadImageList::dataKind(const matrix<float>&,
+                                                   const bool) {
+    return ChannelData;
+  }
+
+  loadImageList::eDataKind loadImageList::dataKind(const matrix<int32>&,
+                                                   const bool withPalette) {
+    return withPalette ? Channel32PaletteData : Channel32Data;
+  }
+
+  void loadImageList::stopPrefetch() {
+    delete prefetcher_;
+    prefetcher_ = 0;
+  }
+
+  loadImageList::decodedFile*
+  loadImageList::nextPrefetched(const eDataKind kind) {
+
+    if (isNull(prefetcher_) ||
+        (prefetcher_->kind != kind) ||
+        (prefetcher_->position != it_)) {
+      // (re)start the look-ahead at the current position
+      stopPrefetch();
+      const parameters& par = getParameters();
+      const int threads = (par.decoderThreads > 0) ?
+        par.decoderThreads : threadPool::getNumberOfProcessors();
+      prefetcher_ = new prefetcher(loader_,kind,it_,filenames_.end(),
+                                   par.prefetchSize,threads);
+    }
+
+    while (it_ != filenames_.end()) {
+      decodedFile& file = prefetcher_->wait();
+      if (file.ok) {
+        return &file;
+      }
+
+      // the slot may be reused as soon as it is released
+      const std::string error(file.error);
+      lastDecodeTime_ = file.time;
+      prefetcher_->release();
+      ++it_;
+
+      if (!getParameters().continueOnError) {
+        setStatusString("Error loading image file:\n");
+        appendStatusString(error);
+        return 0;
+      }
+    }
+
+    setStatusString("No more filenames in list while trying to recover from IO problems (continueOnError is true)");
+    return 0;
+  }
+
+  void loadImageList::releasePrefetched() {
+    prefetcher_->release();
+    ++it_;
+  }
+
   // -------------------------------------------------------------------
   // helper functions
   // -------------------------------------------------------------------
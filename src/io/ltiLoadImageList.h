@@ -41,6 +41,7 @@
 #include "ltiImage.h"
 
 #include "ltiIOImage.h"
+#include "ltiTimer.h"
 #include <list>
 #include <vector>
 #include <string>
@@ -92,6 +93,15 @@ namespace lti {
    * configure via continueOnError that errors while loading a file should be
    * ignored and the next valid image should be returned instead.
    *
+   * Decoding the files is usually much slower than reading them, so that
+   * batch processing loops are bound by the decoding time of the images.
+   * If parameters::prefetchSize is greater than zero, the images are
+   * decoded in advance by parameters::decoderThreads background threads,
+   * while the calling thread processes the previous ones.  The images are
+   * still delivered by load() in the order of the list, and at most
+   * prefetchSize decoded images are kept waiting in memory.  The time
+   * spent decoding each file can be retrieved with getLastDecodeTime().
+   *
    * @see loadImageList::parameters.
    *
    * @ingroup IOImage
@@ -190,6 +200,39 @@ namespace lti {
        */
       std::string fileType;
 
+      /**
+       * Number of images decoded in advance.
+       *
+       * If greater than zero, the files following the current position in
+       * the list are decoded in background threads while the previous images
+       * are processed by the caller.  This is the maximal number of decoded
+       * images waiting to be returned by load(), and therefore bounds the
+       * memory used by the look-ahead.
+       *
+       * The prefetching starts with the first single image load() after
+       * setting the source of the filenames or calling rewind(), and
+       * decodes the files as the type of the image requested there.  Loading
+       * a different type (or the same type with/without palette) restarts
+       * the look-ahead at the current position.
+       *
+       * If zero, the images are decoded in the calling thread when load() is
+       * called.
+       *
+       * Default: 0
+       */
+      int prefetchSize;
+
+      /**
+       * Number of threads decoding images in advance, if prefetchSize is
+       * greater than zero.
+       *
+       * If zero or negative, as many threads as processors are available
+       * are used.
+       *
+       * Default: 1
+       */
+      int decoderThreads;
+
     };
 
     /**
@@ -284,6 +327,9 @@ namespace lti {
      *
      * \warning Note that analogous to load it is your responsibility to check
      * whether the list hasNext().
+     *
+     * If the image is being prefetched, skip() waits until it is decoded
+     * and discards it.
      */
     void skip();
 
@@ -366,6 +412,15 @@ namespace lti {
      * parameters::continueOnError is true.
      */
     const std::string& getLastLoadedFilename() const;
+
+    /**
+     * Returns the time in microseconds (wall-clock) spent decoding the image
+     * file returned by the last call to one of the single image load()
+     * member functions.  With prefetching this is the time the decoding
+     * took in its background thread, and not the (usually much shorter)
+     * time load() had to wait for it.
+     */
+    double getLastDecodeTime() const;
     
     /**
      * Load file as a color image.
@@ -534,6 +589,137 @@ namespace lti {
      */
     bool hasValidFileExtension(const std::string& filename) const;
 
+    /**
+     * Time spent decoding the last loaded file
+     */
+    double lastDecodeTime_;
+
+    /**
+     * @name Prefetching
+     */
+    //@{
+
+    /**
+     * Kind of data decoded by the prefetcher
+     */
+    enum eDataKind {
+      ImageData,            /**< image */
+      Channel8Data,         /**< matrix<ubyte> */
+      Channel8PaletteData,  /**< matrix<ubyte> with palette */
+      ChannelData,          /**< matrix<float> */
+      Channel32Data,        /**< matrix<int32> */
+      Channel32PaletteData  /**< matrix<int32> with palette */
+    };
+
+    /**
+     * A file decoded in advance
+     */
+    class decodedFile {
+    public:
+      /**
+       * Default constructor
+       */
+      decodedFile();
+
+      /**
+       * Decode the given file as the given kind of data
+       */
+      void decode(ioImage& loader,
+                  const std::string& filename,
+                  const eDataKind kind);
+
+      /**
+       * Move the decoded data into the given containers.
+       */
+      //@{
+      void get(image& dest);
+      void get(matrix<ubyte>& dest);
+      void get(matrix<float>& dest);
+      void get(matrix<int32>& dest);
+      void get(palette& dest);
+      //@}
+
+      /**
+       * True if the file was successfully decoded
+       */
+      bool ok;
+
+      /**
+       * Status string of the loader if decoding failed
+       */
+      std::string error;
+
+      /**
+       * Time spent decoding the file in microseconds
+       */
+      double time;
+
+    private:
+      /**
+       * Decoded data.  Only the members corresponding to the kind of data
+       * are used.
+       */
+      //@{
+      image img_;
+      matrix<ubyte> chnl8_;
+      matrix<float> chnl_;
+      matrix<int32> chnl32_;
+      palette pal_;
+      //@}
+    };
+
+    /**
+     * Background decoder of the files following the current position.
+     * Defined in the implementation file.
+     */
+    class prefetcher;
+    friend class prefetcher;
+
+    /**
+     * Prefetcher running for the current position, or null.
+     */
+    prefetcher* prefetcher_;
+
+    /**
+     * Kind of data decoded by load() for the given destination
+     */
+    //@{
+    static eDataKind dataKind(const image&, const bool);
+    static eDataKind dataKind(const matrix<ubyte>&, const bool withPalette);
+    static eDataKind dataKind(const matrix<float>&, const bool);
+    static eDataKind dataKind(const matrix<int32>&, const bool withPalette);
+    //@}
+
+    /**
+     * Wait for the next successfully decoded file of the given kind.
+     *
+     * Starts the prefetcher if required and handles the continueOnError
+     * parameter.  The returned file must be released with
+     * releasePrefetched() after taking its data.
+     *
+     * @return the decoded file or null if an error occurred.
+     */
+    decodedFile* nextPrefetched(const eDataKind kind);
+
+    /**
+     * Release the file returned by nextPrefetched() and advance the
+     * current position.
+     */
+    void releasePrefetched();
+
+    /**
+     * Terminate the prefetcher (if any), discarding all decoded files.
+     */
+    void stopPrefetch();
+
+    /**
+     * Load the next image of type T with the prefetcher
+     */
+    template <class T>
+    bool prefetchHelp(T& dest, palette* pal);
+
+    //@}
+
     /**
      * @name Helper functions for loading
      */
@@ -51,6 +51,7 @@ namespace lti {
     }
 
     it_ = filenames_.begin();
+    stopPrefetch();
 
     if (filenames_.empty()) {
       setStatusString("No valid filenames in range");
@@ -79,7 +80,14 @@ namespace lti {
       return false;
     }
 
+    if (getParameters().prefetchSize > 0) {
+      return prefetchHelp(dest,0);
+    }
+
+    timer chron(timer::Wall);
+    chron.start();
     bool b = loader_.load(*it_, dest);
+    lastDecodeTime_ = chron.getTime();
     ++it_;
 
     if (!b) {
@@ -113,14 +121,20 @@ namespace lti {
       return false;
     }
 
+    if (getParameters().prefetchSize > 0) {
+      return prefetchHelp(dest,&pal);
+    }
 
+    timer chron(timer::Wall);
+    chron.start();
     bool b = loader_.load(*it_, dest, pal);
+    lastDecodeTime_ = chron.getTime();
     ++it_;
 
     if (!b) {
       if (getParameters().continueOnError) {
         if (it_!=filenames_.end()) {
-          return loadHelp(dest);
+          return loadHelp(dest, pal);
         } else {
           setStatusString("No more filenames in list while trying to recover from IO problems (continueOnError is true)");
           return false;
@@ -134,6 +148,23 @@ namespace lti {
     return true;
   }
 
+  template <class T>
+  bool loadImageList::prefetchHelp(T& dest, palette* pal) {
+    decodedFile* file = nextPrefetched(dataKind(dest,notNull(pal)));
+    if (isNull(file)) {
+      return false;
+    }
+
+    file->get(dest);
+    if (notNull(pal)) {
+      file->get(*pal);
+    }
+    lastDecodeTime_ = file->time;
+    releasePrefetched();
+
+    return true;
+  }
+
   template <class T>
   bool loadImageList::loadHelp(std::vector<T*>& dest) {
 
@@ -149,12 +180,14 @@ namespace lti {
       if (!loadHelp(*tmp)) {
         dest.clear();
         it_=itSave;
+        stopPrefetch();
         return false;
       }
       dest.push_back(tmp);
     }
 
     it_=itSave;
+    stopPrefetch();
     return true;
   }
 
@@ -176,6 +209,7 @@ namespace lti {
       if (!loadHelp(*tmp, *p)) {
         dest.clear();
         it_=itSave;
+        stopPrefetch();
         return false;
       }
       dest.push_back(tmp);
@@ -183,6 +217,7 @@ namespace lti {
     }
 
     it_=itSave;
+    stopPrefetch();
     return true;
   }
 }
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiMappedFileAllocator.cpp
+ *         Contains the class lti::mappedFileAllocator, which provides
+ *         memory mapped file regions as data blocks of vectors and matrices.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include "ltiMappedFileAllocator.h"
+#include "ltiMutex.h"
+
+#ifdef _LTI_WIN32
+#  include <windows.h>
+#else
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+namespace lti {
+
+  mappedFileAllocator::mappedFileAllocator()
+    : memoryAllocator(), lock_(new mutex) {
+  }
+
+  mappedFileAllocator::~mappedFileAllocator() {
+    std::map<void*,region>::const_iterator it;
+    for (it=regions_.begin();it!=regions_.end();++it) {
+      unmap((*it).second);
+    }
+    delete lock_;
+  }
+
+  size_t mappedFileAllocator::getGranularity() {
+#ifdef _LTI_WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<size_t>(info.dwAllocationGranularity);
+#else
+    const long size = sysconf(_SC_PAGESIZE);
+    return (size > 0) ? static_cast<size_t>(size) : 4096;
+#endif
+  }
+
+  mappedFileAllocator& mappedFileAllocator::getShared() {
+    static mappedFileAllocator* theAllocator = new mappedFileAllocator;
+    return *theAllocator;
+  }
+
+  void* mappedFileAllocator::map(const std::string& filename,
+                                 const size_t offset,
+                                 const size_t bytes) {
+    if (bytes == 0) {
+      return 0;
+    }
+
+    // the mapping must start at a multiple of the granularity
+    const size_t granularity = getGranularity();
+    const size_t start = offset - (offset % granularity);
+    const size_t length = bytes + (offset - start);
+    region reg;
+
+#ifdef _LTI_WIN32
+    HANDLE file = CreateFileA(filename.c_str(),GENERIC_READ,FILE_SHARE_READ,
+                              0,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,0);
+    if (file == INVALID_HANDLE_VALUE) {
+      return 0;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file,&fileSize) ||
+        (static_cast<uint64>(fileSize.QuadPart) < offset+bytes)) {
+      CloseHandle(file);
+      return 0;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file,0,PAGE_WRITECOPY,0,0,0);
+    CloseHandle(file);
+    if (mapping == 0) {
+      return 0;
+    }
+
+    const uint64 start64 = static_cast<uint64>(start);
+    reg.base = MapViewOfFile(mapping,FILE_MAP_COPY,
+                             static_cast<DWORD>(start64 >> 32),
+                             static_cast<DWORD>(start64 & 0xFFFFFFFF),
+                             length);
+    // the view keeps the mapping object alive
+    CloseHandle(mapping);
+    if (reg.base == 0) {
+      return 0;
+    }
+#else
+    const int fd = open(filename.c_str(),O_RDONLY);
+    if (fd < 0) {
+      return 0;
+    }
+
+    struct stat info;
+    if ((fstat(fd,&info) != 0) ||
+        (static_cast<uint64>(info.st_size) < offset+bytes)) {
+      close(fd);
+      return 0;
+    }
+
+    // private writable mapping: copy-on-write, never written back
+    void* base = mmap(0,length,PROT_READ|PROT_WRITE,MAP_PRIVATE,fd,
+                      static_cast<off_t>(start));
+    // the mapping keeps its own reference to the file
+    close(fd);
+    if (base == MAP_FAILED) {
+      return 0;
+    }
+    reg.base = base;
+#endif
+
+    reg.length = length;
+    void* ptr = static_cast<char*>(reg.base) + (offset - start);
+
+    lock_->lock();
+    regions_[ptr] = reg;
+    ++stats_.allocations;
+    ++stats_.systemAllocations;
+    stats_.bytesInUse += bytes;
+    if (stats_.bytesInUse > stats_.peakBytesInUse) {
+      stats_.peakBytesInUse = stats_.bytesInUse;
+    }
+    lock_->unlock();
+
+    return ptr;
+  }
+
+  void* mappedFileAllocator::allocate(const size_t) {
+    throw allocException();
+    return 0;
+  }
+
+  void mappedFileAllocator::deallocate(void* ptr,const size_t bytes) {
+    region reg;
+    bool found = false;
+
+    lock_->lock();
+    std::map<void*,region>::iterator it = regions_.find(ptr);
+    if (it != regions_.end()) {
+      reg = (*it).second;
+      regions_.erase(it);
+      ++stats_.deallocations;
+      stats_.bytesInUse -= bytes;
+      found = true;
+    }
+    lock_->unlock();
+
+    if (found) {
+      unmap(reg);
+    }
+  }
+
+  void mappedFileAllocator::getStatistics(statistics& stats) const {
+    lock_->lock();
+    stats = stats_;
+    lock_->unlock();
+  }
+
+  void mappedFileAllocator::unmap(const region& reg) {
+#ifdef _LTI_WIN32
+    UnmapViewOfFile(reg.base);
+#else
+    munmap(reg.base,reg.length);
+#endif
+  }
+
+}
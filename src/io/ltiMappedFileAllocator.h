@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiMappedFileAllocator.h
+ *         Contains the class lti::mappedFileAllocator, which provides
+ *         memory mapped file regions as data blocks of vectors and matrices.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#ifndef _LTI_MAPPED_FILE_ALLOCATOR_H_
+#define _LTI_MAPPED_FILE_ALLOCATOR_H_
+
+#include "ltiMemoryAllocator.h"
+#include <string>
+#include <map>
+
+namespace lti {
+
+  /**
+   * Memory allocator for memory mapped file regions.
+   *
+   * This allocator does not allocate memory: its blocks are regions of
+   * files mapped into memory with map().  The returned pointer can be
+   * given to the attach() method of lti::genericVector or
+   * lti::genericMatrix together with this allocator, so that the mapping
+   * is removed as soon as the container releases its data (when it is
+   * destroyed, resized, etc.):
+   *
+   * \code
+   * lti::mappedFileAllocator& alloc = lti::mappedFileAllocator::getShared();
+   * float* data = static_cast<float*>(alloc.map("data.raw",0,rows*cols*4));
+   * if (data != 0) {
+   *   lti::fmatrix mat;
+   *   mat.attach(rows,cols,data,&alloc); // mat owns the mapping
+   * }
+   * \endcode
+   *
+   * The files are mapped copy-on-write: the pages are read from the file
+   * only when they are accessed, and shared with all other processes
+   * mapping the same file until they are modified.  Modifications are
+   * never written back to the file.  The file must not be truncated while
+   * it is mapped.
+   *
+   * The elements of the mapped regions are not constructed, so this is
+   * only suitable for types without constructors or destructors doing
+   * something relevant (like all pixel and numeric types of the library).
+   *
+   * This allocator must never be used as the default allocator
+   * (see memoryAllocator::setDefault()), since allocate() always fails.
+   */
+  class mappedFileAllocator : public memoryAllocator {
+  public:
+    /**
+     * Default constructor
+     */
+    mappedFileAllocator();
+
+    /**
+     * Destructor.
+     *
+     * All regions still mapped are unmapped.
+     */
+    virtual ~mappedFileAllocator();
+
+    /**
+     * Map a region of a file into memory.
+     *
+     * @param filename name of the file
+     * @param offset position of the first byte of the region in the file.
+     *               It does not need to be aligned to any boundary, but
+     *               the returned pointer is only aligned as the offset
+     *               is.
+     * @param bytes size of the region in bytes.  The file must be at least
+     *              offset+bytes long.
+     * @return pointer to the first byte of the region, or null if the file
+     *         could not be mapped.
+     */
+    void* map(const std::string& filename,
+              const size_t offset,
+              const size_t bytes);
+
+    /**
+     * Not supported: blocks can only be created with map().
+     *
+     * @throw allocException always
+     */
+    virtual void* allocate(const size_t bytes);
+
+    /**
+     * Unmap a region returned by map().
+     */
+    virtual void deallocate(void* ptr,const size_t bytes);
+
+    /**
+     * Get the statistics.  The allocation counters refer to the mappings,
+     * and bytesInUse to the mapped bytes.
+     */
+    virtual void getStatistics(statistics& stats) const;
+
+    /**
+     * Granularity of the mappings of the system, i.e. the page size
+     * (or the allocation granularity on Windows).  Data sections in files
+     * that start at a multiple of this value can be mapped on their own.
+     */
+    static size_t getGranularity();
+
+    /**
+     * Allocator shared by all users of memory mapped files.  It is never
+     * destroyed, since containers with static storage may release their
+     * memory at any time during the termination of the program.
+     */
+    static mappedFileAllocator& getShared();
+
+  private:
+    /**
+     * A mapped region
+     */
+    struct region {
+      /**
+       * Start of the mapping, aligned to the granularity
+       */
+      void* base;
+
+      /**
+       * Length of the mapping
+       */
+      size_t length;
+    };
+
+    /**
+     * Unmap the given region
+     */
+    static void unmap(const region& reg);
+
+    /**
+     * Mapped regions indexed by the pointer returned by map()
+     */
+    std::map<void*,region> regions_;
+
+    /**
+     * Counters
+     */
+    statistics stats_;
+
+    /**
+     * Protects regions_ and stats_
+     */
+    mutex* lock_;
+  };
+
+}
+
+#endif
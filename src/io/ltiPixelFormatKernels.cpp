@@ -0,0 +1,584 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiPixelFormatKernels.cpp
+ *         Vectorized conversion of the raw pixel formats delivered by
+ *         cameras (YUV 4:2:2, YUV 4:2:0, gray and Bayer) into images and
+ *         channels, used by the frame grabbers.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include "ltiPixelFormatKernels.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
+namespace lti {
+  namespace internal {
+
+    namespace {
+
+      // -------------------------------------------------------------------
+      // scalar conversion
+      // -------------------------------------------------------------------
+
+      inline ubyte saturate(const int v) {
+        return static_cast<ubyte>((v < 0) ? 0 : ((v > 255) ? 255 : v));
+      }
+
+      /*
+       * Convert one pixel with luminance y and the chroma values u and v
+       * (already shifted by -128)
+       */
+      inline void yuvPixel(const int y,const int u,const int v,
+                           rgbaPixel& px) {
+        px.set(saturate(y + ((359*v) >> 8)),
+               saturate(y + ((-88*u - 183*v) >> 8)),
+               saturate(y + ((454*u) >> 8)),
+               0);
+      }
+
+#if defined(__SSE2__)
+
+      // -------------------------------------------------------------------
+      // SSE2 conversion
+      // -------------------------------------------------------------------
+
+      /*
+       * Store 16 pixels with the given blue, green and red bytes
+       */
+      inline void storePixels(const __m128i& b,
+                              const __m128i& g,
+                              const __m128i& r,
+                              rgbaPixel* dest) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bg0 = _mm_unpacklo_epi8(b,g);
+        const __m128i bg1 = _mm_unpackhi_epi8(b,g);
+        const __m128i ra0 = _mm_unpacklo_epi8(r,zero);
+        const __m128i ra1 = _mm_unpackhi_epi8(r,zero);
+        __m128i* d = reinterpret_cast<__m128i*>(dest);
+        _mm_storeu_si128(d  ,_mm_unpacklo_epi16(bg0,ra0));
+        _mm_storeu_si128(d+1,_mm_unpackhi_epi16(bg0,ra0));
+        _mm_storeu_si128(d+2,_mm_unpacklo_epi16(bg1,ra1));
+        _mm_storeu_si128(d+3,_mm_unpackhi_epi16(bg1,ra1));
+      }
+
+      /*
+       * Chroma term of one color for 16 pixels, i.e. for 8 (u,v) pairs
+       * given as 16-bit values in uv0 and uv1, duplicated for the two
+       * pixels sharing each pair, and added to the luminances.
+       */
+      inline __m128i chromaTerm(const __m128i& y0,const __m128i& y1,
+                                const __m128i& uv0,const __m128i& uv1,
+                                const __m128i& coefficients) {
+        // (u*cu + v*cv) >> 8 for each pair, computed in 32 bits
+        const __m128i c =
+          _mm_packs_epi32(_mm_srai_epi32(_mm_madd_epi16(uv0,coefficients),8),
+                          _mm_srai_epi32(_mm_madd_epi16(uv1,coefficients),8));
+        return _mm_packus_epi16(_mm_add_epi16(y0,_mm_unpacklo_epi16(c,c)),
+                                _mm_add_epi16(y1,_mm_unpackhi_epi16(c,c)));
+      }
+
+      /*
+       * Convert 16 pixels with the 16-bit luminances y0 (pixels 0 to 7)
+       * and y1 (pixels 8 to 15), and the 16-bit chroma pairs uv0 (u0 v0 ..
+       * u3 v3) and uv1 (u4 v4 .. u7 v7), not yet shifted by -128.
+       */
+      inline void yuvPixels(const __m128i& y0,const __m128i& y1,
+                            __m128i uv0,__m128i uv1,
+                            rgbaPixel* dest) {
+        const __m128i offset = _mm_set1_epi16(128);
+        uv0 = _mm_sub_epi16(uv0,offset);
+        uv1 = _mm_sub_epi16(uv1,offset);
+
+        const __m128i kr = _mm_setr_epi16(0,359,0,359,0,359,0,359);
+        const __m128i kg = _mm_setr_epi16(-88,-183,-88,-183,
+                                          -88,-183,-88,-183);
+        const __m128i kb = _mm_setr_epi16(454,0,454,0,454,0,454,0);
+
+        storePixels(chromaTerm(y0,y1,uv0,uv1,kb),
+                    chromaTerm(y0,y1,uv0,uv1,kg),
+                    chromaTerm(y0,y1,uv0,uv1,kr),
+                    dest);
+      }
+
+      inline __m128i load16(const ubyte* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      }
+
+      inline void store16(ubyte* p,const __m128i& r) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p),r);
+      }
+
+#endif
+
+      // -------------------------------------------------------------------
+      // formats
+      // -------------------------------------------------------------------
+
+      /*
+       * Each format provides:
+       * - frameSize(): the minimal buffer size for a frame
+       * - row(): the pointers to the luminance and chroma data of a row
+       * - luma() and chroma(): scalar access to the data of a row, where
+       *   chroma(x) returns the (u,v) pair of the pixels x and x+1
+       * - load(): SSE2 load of the data of 16 pixels of a row as 16-bit
+       *   values: the luminances in y0 and y1 and the chroma pairs in
+       *   uv0 and uv1.
+       */
+
+      /*
+       * Packed YUV 4:2:2, byte order Y0 U Y1 V
+       */
+      struct yuyvFormat {
+        static unsigned int frameSize(const int cols,const int rows) {
+          return 2u*cols*rows;
+        }
+
+        static void row(const ubyte* data,const int cols,const int,
+                        const int y,
+                        const ubyte*& luma,const ubyte*& chroma) {
+          luma = chroma = data + 2*cols*y;
+        }
+
+        static inline int luma(const ubyte* luma,const int x) {
+          return luma[2*x];
+        }
+
+        static inline void chroma(const ubyte* chroma,const int x,
+                                  int& u,int& v) {
+          u = chroma[2*x+1]-128;
+          v = chroma[2*x+3]-128;
+        }
+
+#if defined(__SSE2__)
+        static inline void load(const ubyte* luma,const ubyte*,const int x,
+                                __m128i& y0,__m128i& y1,
+                                __m128i& uv0,__m128i& uv1) {
+          const __m128i a = load16(luma+2*x);
+          const __m128i b = load16(luma+2*x+16);
+          const __m128i mask = _mm_set1_epi16(0x00FF);
+          y0 = _mm_and_si128(a,mask);
+          y1 = _mm_and_si128(b,mask);
+          uv0 = _mm_srli_epi16(a,8);
+          uv1 = _mm_srli_epi16(b,8);
+        }
+#endif
+      };
+
+      /*
+       * Packed YUV 4:2:2, byte order U Y0 V Y1
+       */
+      struct uyvyFormat {
+        static unsigned int frameSize(const int cols,const int rows) {
+          return 2u*cols*rows;
+        }
+
+        static void row(const ubyte* data,const int cols,const int,
+                        const int y,
+                        const ubyte*& luma,const ubyte*& chroma) {
+          luma = chroma = data + 2*cols*y;
+        }
+
+        static inline int luma(const ubyte* luma,const int x) {
+          return luma[2*x+1];
+        }
+
+        static inline void chroma(const ubyte* chroma,const int x,
+                                  int& u,int& v) {
+          u = chroma[2*x]-128;
+          v = chroma[2*x+2]-128;
+        }
+
+#if defined(__SSE2__)
+        static inline void load(const ubyte* luma,const ubyte*,const int x,
+                                __m128i& y0,__m128i& y1,
+                                __m128i& uv0,__m128i& uv1) {
+          const __m128i a = load16(luma+2*x);
+          const __m128i b = load16(luma+2*x+16);
+          const __m128i mask = _mm_set1_epi16(0x00FF);
+          y0 = _mm_srli_epi16(a,8);
+          y1 = _mm_srli_epi16(b,8);
+          uv0 = _mm_and_si128(a,mask);
+          uv1 = _mm_and_si128(b,mask);
+        }
+#endif
+      };
+
+      /*
+       * Planar YUV 4:2:0 (I420): the chroma pointer of a row points to its
+       * U values, the V values are a quarter of the Y plane later.  Only
+       * used by yuv420ToImage(), which handles the two chroma planes.
+       */
+      struct yuv420Format {
+        static unsigned int frameSize(const int cols,const int rows) {
+          return static_cast<unsigned int>(cols*rows + cols*rows/2);
+        }
+
+        static void row(const ubyte* data,const int cols,const int rows,
+                        const int y,
+                        const ubyte*& luma,const ubyte*& chroma) {
+          luma = data + cols*y;
+          chroma = data + cols*rows + (cols/2)*(y/2);
+        }
+      };
+
+      /*
+       * YUV 4:2:0 with interleaved chroma plane (NV12)
+       */
+      struct nv12Format {
+        static unsigned int frameSize(const int cols,const int rows) {
+          return static_cast<unsigned int>(cols*rows + cols*rows/2);
+        }
+
+        static void row(const ubyte* data,const int cols,const int rows,
+                        const int y,
+                        const ubyte*& luma,const ubyte*& chroma) {
+          luma = data + cols*y;
+          chroma = data + cols*rows + cols*(y/2);
+        }
+
+        static inline int luma(const ubyte* luma,const int x) {
+          return luma[x];
+        }
+
+        static inline void chroma(const ubyte* chroma,const int x,
+                                  int& u,int& v) {
+          u = chroma[x]-128;
+          v = chroma[x+1]-128;
+        }
+
+#if defined(__SSE2__)
+        static inline void load(const ubyte* luma,const ubyte* chroma,
+                                const int x,
+                                __m128i& y0,__m128i& y1,
+                                __m128i& uv0,__m128i& uv1) {
+          const __m128i zero = _mm_setzero_si128();
+          const __m128i a = load16(luma+x);
+          const __m128i c = load16(chroma+x);
+          y0 = _mm_unpacklo_epi8(a,zero);
+          y1 = _mm_unpackhi_epi8(a,zero);
+          uv0 = _mm_unpacklo_epi8(c,zero);
+          uv1 = _mm_unpackhi_epi8(c,zero);
+        }
+#endif
+      };
+
+      // -------------------------------------------------------------------
+      // drivers
+      // -------------------------------------------------------------------
+
+      /*
+       * Row of the destination for the source row y, which is reversed
+       * afterwards if the image has to be turned around
+       */
+      template<class T>
+      inline T* destRow(matrix<T>& dest,const int y,const bool turnAround) {
+        return &dest.at(turnAround ? dest.rows()-1-y : y,0);
+      }
+
+      template<class T>
+      inline void finishRow(T* row,const int cols,const bool turnAround) {
+        if (turnAround) {
+          std::reverse(row,row+cols);
+        }
+      }
+
+      /*
+       * Convert one row of a format with 2x1 chroma subsampling.  The
+       * chroma of the pixel pair x,x+1 is at chroma position x.
+       */
+      template<class F>
+      inline void yuvRow(const ubyte* luma,const ubyte* chroma,
+                         const int cols,rgbaPixel* dest) {
+        int x = 0;
+#if defined(__SSE2__)
+        __m128i y0,y1,uv0,uv1;
+        for (;x+16<=cols;x+=16) {
+          F::load(luma,chroma,x,y0,y1,uv0,uv1);
+          yuvPixels(y0,y1,uv0,uv1,dest+x);
+        }
+#endif
+        int u,v;
+        for (;x<cols;x+=2) {
+          F::chroma(chroma,x,u,v);
+          yuvPixel(F::luma(luma,x),u,v,dest[x]);
+          yuvPixel(F::luma(luma,x+1),u,v,dest[x+1]);
+        }
+      }
+
+      /*
+       * Row of the planar YUV 4:2:0 format, which has separate U and V
+       * pointers.
+       */
+      inline void yuv420Row(const ubyte* luma,const ubyte* us,const ubyte* vs,
+                            const int cols,rgbaPixel* dest) {
+        int x = 0;
+#if defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        for (;x+16<=cols;x+=16) {
+          const __m128i a = load16(luma+x);
+          const __m128i c =
+            _mm_unpacklo_epi8(
+              _mm_loadl_epi64(reinterpret_cast<const __m128i*>(us+x/2)),
+              _mm_loadl_epi64(reinterpret_cast<const __m128i*>(vs+x/2)));
+          yuvPixels(_mm_unpacklo_epi8(a,zero),_mm_unpackhi_epi8(a,zero),
+                    _mm_unpacklo_epi8(c,zero),_mm_unpackhi_epi8(c,zero),
+                    dest+x);
+        }
+#endif
+        for (;x<cols;x+=2) {
+          const int u = us[x/2]-128;
+          const int v = vs[x/2]-128;
+          yuvPixel(luma[x],u,v,dest[x]);
+          yuvPixel(luma[x+1],u,v,dest[x+1]);
+        }
+      }
+
+      template<class F>
+      bool yuvToImage(const ubyte* data,
+                      const unsigned int bsize,
+                      const bool turnAround,
+                      image& dest) {
+        const int cols = dest.columns();
+        const int rows = dest.rows();
+        if (((cols & 1) != 0) || (bsize < F::frameSize(cols,rows))) {
+          return false;
+        }
+
+        const ubyte* luma;
+        const ubyte* chroma;
+        for (int y=0;y<rows;++y) {
+          F::row(data,cols,rows,y,luma,chroma);
+          rgbaPixel* d = destRow(dest,y,turnAround);
+          yuvRow<F>(luma,chroma,cols,d);
+          finishRow(d,cols,turnAround);
+        }
+        return true;
+      }
+
+      template<class F>
+      bool packedLumaToChannel(const ubyte* data,
+                               const unsigned int bsize,
+                               const bool turnAround,
+                               channel8& dest) {
+        const int cols = dest.columns();
+        const int rows = dest.rows();
+        if (((cols & 1) != 0) || (bsize < F::frameSize(cols,rows))) {
+          return false;
+        }
+
+        const ubyte* luma;
+        const ubyte* chroma;
+        for (int y=0;y<rows;++y) {
+          F::row(data,cols,rows,y,luma,chroma);
+          ubyte* d = destRow(dest,y,turnAround);
+          int x = 0;
+#if defined(__SSE2__)
+          __m128i y0,y1,uv0,uv1;
+          for (;x+16<=cols;x+=16) {
+            F::load(luma,chroma,x,y0,y1,uv0,uv1);
+            store16(d+x,_mm_packus_epi16(y0,y1));
+          }
+#endif
+          for (;x<cols;++x) {
+            d[x] = static_cast<ubyte>(F::luma(luma,x));
+          }
+          finishRow(d,cols,turnAround);
+        }
+        return true;
+      }
+
+    }
+
+    // ---------------------------------------------------------------------
+    // public interface
+    // ---------------------------------------------------------------------
+
+    bool yuyvToImage(const ubyte* data,
+                     const unsigned int bsize,
+                     const bool turnAround,
+                     image& dest) {
+      return yuvToImage<yuyvFormat>(data,bsize,turnAround,dest);
+    }
+
+    bool yuyvToChannel(const ubyte* data,
+                       const unsigned int bsize,
+                       const bool turnAround,
+                       channel8& dest) {
+      return packedLumaToChannel<yuyvFormat>(data,bsize,turnAround,dest);
+    }
+
+    bool uyvyToImage(const ubyte* data,
+                     const unsigned int bsize,
+                     const bool turnAround,
+                     image& dest) {
+      return yuvToImage<uyvyFormat>(data,bsize,turnAround,dest);
+    }
+
+    bool uyvyToChannel(const ubyte* data,
+                       const unsigned int bsize,
+                       const bool turnAround,
+                       channel8& dest) {
+      return packedLumaToChannel<uyvyFormat>(data,bsize,turnAround,dest);
+    }
+
+    bool yuv420ToImage(const ubyte* data,
+                       const unsigned int bsize,
+                       const bool turnAround,
+                       image& dest) {
+      const int cols = dest.columns();
+      const int rows = dest.rows();
+      if (((cols & 1) != 0) || ((rows & 1) != 0) ||
+          (bsize < yuv420Format::frameSize(cols,rows))) {
+        return false;
+      }
+
+      const int vOffset = (cols/2)*(rows/2);
+      const ubyte* luma;
+      const ubyte* chroma;
+      for (int y=0;y<rows;++y) {
+        yuv420Format::row(data,cols,rows,y,luma,chroma);
+        rgbaPixel* d = destRow(dest,y,turnAround);
+        yuv420Row(luma,chroma,chroma+vOffset,cols,d);
+        finishRow(d,cols,turnAround);
+      }
+      return true;
+    }
+
+    bool nv12ToImage(const ubyte* data,
+                     const unsigned int bsize,
+                     const bool turnAround,
+                     image& dest) {
+      if ((dest.rows() & 1) != 0) {
+        return false;
+      }
+      return yuvToImage<nv12Format>(data,bsize,turnAround,dest);
+    }
+
+    bool greyToImage(const ubyte* data,
+                     const unsigned int bsize,
+                     const bool turnAround,
+                     image& dest) {
+      const int cols = dest.columns();
+      const int rows = dest.rows();
+      if (bsize < static_cast<unsigned int>(cols*rows)) {
+        return false;
+      }
+
+      for (int y=0;y<rows;++y) {
+        const ubyte* src = data + cols*y;
+        rgbaPixel* d = destRow(dest,y,turnAround);
+        int x = 0;
+#if defined(__SSE2__)
+        for (;x+16<=cols;x+=16) {
+          const __m128i g = load16(src+x);
+          storePixels(g,g,g,d+x);
+        }
+#endif
+        for (;x<cols;++x) {
+          d[x].set(src[x],src[x],src[x],0);
+        }
+        finishRow(d,cols,turnAround);
+      }
+      return true;
+    }
+
+    bool greyToChannel(const ubyte* data,
+                       const unsigned int bsize,
+                       const bool turnAround,
+                       channel8& dest) {
+      const int cols = dest.columns();
+      const int rows = dest.rows();
+      if (bsize < static_cast<unsigned int>(cols*rows)) {
+        return false;
+      }
+
+      for (int y=0;y<rows;++y) {
+        ubyte* d = destRow(dest,y,turnAround);
+        memcpy(d,data+cols*y,cols);
+        finishRow(d,cols,turnAround);
+      }
+      return true;
+    }
+
+    bool bayerToChannel(const ubyte* data,
+                        const unsigned int bsize,
+                        const bool turnAround,
+                        channel8& dest) {
+      const int cols = dest.columns();
+      const int rows = dest.rows();
+      if ((cols < 2) || (rows < 2) ||
+          (bsize < static_cast<unsigned int>(cols*rows))) {
+        return false;
+      }
+
+      for (int y=0;y<rows;++y) {
+        const ubyte* r0 = data + cols*y;
+        // the row below, or above for the last one
+        const ubyte* r1 = (y+1 < rows) ? r0+cols : r0-cols;
+        ubyte* d = destRow(dest,y,turnAround);
+        int x = 0;
+#if defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i two = _mm_set1_epi16(2);
+        // the blocks read up to the column x+16
+        for (;x+17<=cols;x+=16) {
+          const __m128i a = load16(r0+x);
+          const __m128i b = load16(r0+x+1);
+          const __m128i c = load16(r1+x);
+          const __m128i e = load16(r1+x+1);
+          const __m128i lo =
+            _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a,zero),
+                                        _mm_unpacklo_epi8(b,zero)),
+                          _mm_add_epi16(_mm_unpacklo_epi8(c,zero),
+                                        _mm_unpacklo_epi8(e,zero)));
+          const __m128i hi =
+            _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a,zero),
+                                        _mm_unpackhi_epi8(b,zero)),
+                          _mm_add_epi16(_mm_unpackhi_epi8(c,zero),
+                                        _mm_unpackhi_epi8(e,zero)));
+          store16(d+x,
+                  _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(lo,two),2),
+                                   _mm_srli_epi16(_mm_add_epi16(hi,two),2)));
+        }
+#endif
+        for (;x<cols;++x) {
+          // the column to the right, or to the left for the last one
+          const int x1 = (x+1 < cols) ? x+1 : x-1;
+          d[x] = static_cast<ubyte>((r0[x]+r0[x1]+r1[x]+r1[x1]+2) >> 2);
+        }
+        finishRow(d,cols,turnAround);
+      }
+      return true;
+    }
+
+  }
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiPixelFormatKernels.h
+ *         Vectorized conversion of the raw pixel formats delivered by
+ *         cameras (YUV 4:2:2, YUV 4:2:0, gray and Bayer) into images and
+ *         channels, used by the frame grabbers.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#ifndef _LTI_PIXEL_FORMAT_KERNELS_H_
+#define _LTI_PIXEL_FORMAT_KERNELS_H_
+
+#include "ltiImage.h"
+#include "ltiChannel8.h"
+
+namespace lti {
+  namespace internal {
+
+    /**
+     * @name Conversion of raw camera buffers
+     *
+     * These functions convert a frame buffer of the given pixel format into
+     * the destination, which must have been already allocated with the
+     * size of the frame.  No memory is allocated while converting.
+     *
+     * The YUV formats are converted to RGB with the coefficients of the
+     * ITU-R BT.601 full range (JFIF) transformation, in fixed point
+     * arithmetic with 8 fractional bits:
+     *
+     * \code
+     * R = Y + (359*(V-128) >> 8)
+     * G = Y + ((-88*(U-128) - 183*(V-128)) >> 8)
+     * B = Y + (454*(U-128) >> 8)
+     * \endcode
+     *
+     * The vectorized (SSE2) and the scalar code produce exactly the same
+     * results.  The channel8 versions take only the luminance of the data
+     * and skip the color conversion altogether.
+     *
+     * If \p turnAround is true, the destination is rotated by 180 degrees.
+     *
+     * All functions return false if the buffer is too small for the size of
+     * the destination, or if the size is not valid for the format (the YUV
+     * formats require an even number of columns, and YUV 4:2:0 also an even
+     * number of rows).
+     */
+    //@{
+
+    /**
+     * Packed YUV 4:2:2 with byte order Y0 U Y1 V (V4L2 YUYV)
+     */
+    bool yuyvToImage(const ubyte* data,
+                     const unsigned int bsize,
+                     const bool turnAround,
+                     image& dest);
+
+    /**
+     * Luminance of packed YUV 4:2:2 with byte order Y0 U Y1 V
+     */
+    bool yuyvToChannel(const ubyte* data,
+                       const unsigned int bsize,
+                       const bool turnAround,
+                       channel8& dest);
+
+    /**
+     * Packed YUV 4:2:2 with byte order U Y0 V Y1 (V4L2 UYVY)
+     */
+    bool uyvyToImage(const ubyte* data,
+                     const unsigned int bsize,
+                     const bool turnAround,
+                     image& dest);
+
+    /**
+     * Luminance of packed YUV 4:2:2 with byte order U Y0 V Y1
+     */
+    bool uyvyToChannel(const ubyte* data,
+                       const unsigned int bsize,
+                       const bool turnAround,
+                       channel8& dest);
+
+    /**
+     * Planar YUV 4:2:0: the Y plane followed by the U and V planes, each
+     * one with half the columns and rows (V4L2 YUV420 or I420)
+     */
+    bool yuv420ToImage(const ubyte* data,
+                       const unsigned int bsize,
+                       const bool turnAround,
+                       image& dest);
+
+    /**
+     * YUV 4:2:0 with the Y plane followed by one plane with interleaved U
+     * and V values, with half the rows of the Y plane (V4L2 NV12)
+     */
+    bool nv12ToImage(const ubyte* data,
+                     const unsigned int bsize,
+                     const bool turnAround,
+                     image& dest);
+
+    /**
+     * Gray values, one byte per pixel (V4L2 GREY)
+     */
+    bool greyToImage(const ubyte* data,
+                     const unsigned int bsize,
+                     const bool turnAround,
+                     image& dest);
+
+    /**
+     * Gray values, one byte per pixel.
+     *
+     * This is also the luminance of the planar YUV formats (YUV420, NV12),
+     * since their buffers start with the Y plane.
+     */
+    bool greyToChannel(const ubyte* data,
+                       const unsigned int bsize,
+                       const bool turnAround,
+                       channel8& dest);
+
+    /**
+     * Luminance of an 8-bit Bayer pattern of any color order.
+     *
+     * Each pixel is the mean of the 2x2 block starting at it, which always
+     * contains one red, two green and one blue values, i.e. it is
+     * (R+2G+B)/4 at half a pixel of displacement.  At the last row and
+     * column the previous ones are used instead of the following.  This is
+     * much faster than demosaicing the pattern and converting the color
+     * image to gray.
+     */
+    bool bayerToChannel(const ubyte* data,
+                        const unsigned int bsize,
+                        const bool turnAround,
+                        channel8& dest);
+
+    //@}
+
+  }
+}
+
+#endif
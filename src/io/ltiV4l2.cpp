@@ -61,6 +61,7 @@
 
 #include "ltiBayerDemosaicing.h"
 #include "ltiFactory.h" // for bayerDemosaicing
+#include "ltiPixelFormatKernels.h"
 
 #include <fcntl.h>
 #include <sys/ioctl.h>
@@ -190,88 +191,15 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
                            const unsigned int bsize,
                            const bool turnAround,
                            channel8& img) const;
-
-    protected:
-      /*
-       * Look-up table to accelerate computation of saturation
-       */
-      static const ubyte* lutSaturation_;
-      
-      /*
-       * Look up tables to accelerate conversion Luv -> RGB
-       */
-      //@{
-      static const int* lutUg_;
-      static const int* lutUb_;
-      static const int* lutVg_;
-      static const int* lutVr_;
-      //@}
-      
-      /*
-       * Initialize the Look-Up-Tables
-       */
-      void initializeLUTs();
-
     };
 
     _LTI_V4L2_REGISTER_(YUV420,convertYUV420);
-      
-    // -----------------------------------------------------------------
-    // v4l2 static members
-    // -----------------------------------------------------------------
-
-    // Static attributes
-    const ubyte* convertYUV420::lutSaturation_ = 0;
-      
-    /*
-     * Look up tables to accelerate conversion Luv -> RGB
-     */
-    //@{
-    const int* convertYUV420::lutUg_ = 0;
-    const int* convertYUV420::lutUb_ = 0;
-    const int* convertYUV420::lutVg_ = 0;
-    const int* convertYUV420::lutVr_ = 0;
-
-    void convertYUV420::initializeLUTs() {
-      if (lutSaturation_ == 0) {
-        int i;
-        /*
-         * look up table to accelerate computation of saturation
-         */
-        static ubyte tmpSat[1024];
-        for (i=-256;i<512;++i) {
-          tmpSat[i & 0x3FF] = lti::within(i,0,255);
-        }
-        lutSaturation_ = tmpSat;
-        
-        /*
-         * look up tables to accelerate conversion Luv -> RGB
-         */
-        static int lutUgTmp[256];
-        static int lutUbTmp[256];
-        static int lutVgTmp[256];
-        static int lutVrTmp[256];      
-        
-        for (i=0;i<256;++i) {
-          lutUgTmp[i] = (i-128)*88;
-          lutUbTmp[i] = (i-128)*454;
-          lutVgTmp[i] = (i-128)*183;
-          lutVrTmp[i] = (i-128)*359;
-        }
-        
-        lutUg_ = lutUgTmp;
-        lutUb_ = lutUbTmp;
-        lutVg_ = lutVgTmp;
-        lutVr_ = lutVrTmp;
-      }
-    }
 
     /*
      * Called when setting the parameters
      */
     bool convertYUV420::init(const v4l2::parameters&) {
-      initializeLUTs();
-      return notNull(lutVr_);
+      return true;
     }
 
     /*
@@ -281,133 +209,21 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
                                 const unsigned int bsize,
                                 const bool turnAround,
                                 image& theImage) const {
-
-      const ipoint& resolution(theImage.size());
-      
-      if (bsize<=0) {
-        return false;
-      }
-      
-      const ubyte* buffer = reinterpret_cast<const ubyte*>(data);
-            
-      const ubyte *Y = buffer;
-      const ubyte *u = &buffer[resolution.x*resolution.y];
-      const ubyte *v = &buffer[5*resolution.x*resolution.y/4];
-      const ubyte *Yend;
-      
-      if (turnAround) {
-        ubyte* pxptr = reinterpret_cast<ubyte*>(theImage.data());
-        pxptr += (resolution.x*resolution.y*4);
-        
-        int yy,sy;
-        
-        const int usize = resolution.x/2;
-        
-        for (sy=0;sy<resolution.y;++sy) {
-          Yend = Y+resolution.x;
-          while (Y != Yend) {
-            yy = (*Y)<<8;
-            
-            // dummy
-            --pxptr;
-            // red
-            --pxptr;
-            (*pxptr) = lutSaturation_[((yy+lutVr_[*v]) >> 8)&0x3FF];
-            // green
-            --pxptr;
-            (*pxptr) = lutSaturation_[((yy-lutUg_[*u]-lutVg_[*v]) >> 8)&0x3FF];
-            // blue
-            --pxptr;
-            (*pxptr) = lutSaturation_[((yy+lutUb_[*u]) >> 8) & 0x3FF];
-            
-            
-            // next pixel doesn't change uv values
-            ++Y;
-            yy = (*Y)<<8;
-            
-            // dummy
-            --pxptr;
-            // red
-            --pxptr;
-            (*pxptr) = lutSaturation_[((yy+lutVr_[*v]) >> 8)&0x3FF];
-            // green
-            --pxptr;
-            (*pxptr) = lutSaturation_[((yy-lutUg_[*u]-lutVg_[*v]) >> 8)&0x3FF];
-            // blue
-            --pxptr;
-            (*pxptr) = lutSaturation_[((yy+lutUb_[*u]) >> 8)&0x3FF];
-            
-            ++Y;
-            ++u;
-            ++v;
-          }
-          if ((sy & 1) == 0) {
-            u-=usize;
-            v-=usize;
-          }
-        }
-      
-      } else {
-        int yy,sy;
-
-        ubyte* pxptr = reinterpret_cast<ubyte*>(theImage.data());      
-        const int usize = resolution.x/2;
-        
-        for (sy=0;sy<resolution.y;++sy) {
-          Yend = Y+resolution.x;
-          while (Y != Yend) {
-            yy = (*Y)<<8;
-            
-            // blue
-            (*pxptr) = lutSaturation_[((yy+lutUb_[*u])>>8)&0x3FF];
-            pxptr++;
-            // green
-            (*pxptr) = lutSaturation_[((yy-lutUg_[*u]-lutVg_[*v])>>8)&0x3FF];
-            pxptr++;
-            // red
-            (*pxptr) = lutSaturation_[((yy+lutVr_[*v])>>8)&0x3FF];
-            pxptr++;
-            // dummy
-            pxptr++;
-            
-            // next pixel doesn't change uv values
-            ++Y;
-            yy = (*Y)<<8;
-            
-            // blue
-            (*pxptr) = lutSaturation_[((yy+lutUb_[*u])>>8)&0x3FF];
-            pxptr++;
-            // green
-            (*pxptr) = lutSaturation_[((yy-lutUg_[*u]-lutVg_[*v])>>8)&0x3FF];
-            pxptr++;
-            // red
-            (*pxptr) = lutSaturation_[((yy+lutVr_[*v])>>8)&0x3FF];
-            pxptr++;
-            // dummy
-            pxptr++;
-            
-            ++Y;
-            ++u;
-            ++v;
-          }
-          if ((sy & 1) == 0) {
-            u-=usize;
-            v-=usize;
-          }
-        }
-      }
-      
-      return true;
+      return internal::yuv420ToImage(reinterpret_cast<const ubyte*>(data),
+                                     bsize,turnAround,theImage);
     }
 
     /*
      * Convert data buffer to an channel8 (grey valued channel)
+     *
+     * The Y plane at the beginning of the buffer is already the channel.
      */
     bool convertYUV420::convert(void* data,
                                 const unsigned int bsize,
                                 const bool turnAround,
                                 channel8& img) const {
-      return ::lti::v4l2::convertBase::convert(data,bsize,turnAround,img);
+      return internal::greyToChannel(reinterpret_cast<const ubyte*>(data),
+                                     bsize,turnAround,img);
     }
 
     // -----------------------------------------------------------------
@@ -417,7 +233,11 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
     /*
      * All format converters will reside on this namespace
      */
-    class convertYUYV : public convertYUV420 {
+    class convertYUYV : public ::lti::v4l2::convertBase {
+      /*
+       * Called when setting the parameters
+       */
+      virtual bool init(const v4l2::parameters& par);
 
       /*
        * Convert data buffer to an image
@@ -438,137 +258,222 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
     };
 
     _LTI_V4L2_REGISTER_(YUYV,convertYUYV);
-      
+
+    /*
+     * Called when setting the parameters
+     */
+    bool convertYUYV::init(const v4l2::parameters&) {
+      return true;
+    }
+
+    /*
+     * Convert data buffer to an image
+     */
+    bool convertYUYV::convert(void* data,
+                              const unsigned int bsize,
+                              const bool turnAround,
+                              image& theImage) const {
+      return internal::yuyvToImage(reinterpret_cast<const ubyte*>(data),
+                                   bsize,turnAround,theImage);
+    }
+
+    /*
+     * Convert data buffer to an channel8 (grey valued channel)
+     */
+    bool convertYUYV::convert(void* data,
+                              const unsigned int bsize,
+                              const bool turnAround,
+                              channel8& img) const {
+      return internal::yuyvToChannel(reinterpret_cast<const ubyte*>(data),
+                                     bsize,turnAround,img);
+    }
+
     // -----------------------------------------------------------------
-    // v4l2 static members
+    //                             UYVY
     // -----------------------------------------------------------------
 
+    /*
+     * Packed YUV 4:2:2 with the chroma values before the luminance
+     */
+    class convertUYVY : public ::lti::v4l2::convertBase {
+      /*
+       * Called when setting the parameters
+       */
+      virtual bool init(const v4l2::parameters& par);
+
+      /*
+       * Convert data buffer to an image
+       */
+      virtual bool convert(void* data,
+                           const unsigned int bsize,
+                           const bool turnAround,
+                           image& img) const;
+
+      /*
+       * Convert data buffer to an channel8 (grey valued channel)
+       */
+      virtual bool convert(void* data,
+                           const unsigned int bsize,
+                           const bool turnAround,
+                           channel8& img) const;
+
+    };
+
+    _LTI_V4L2_REGISTER_(UYVY,convertUYVY);
+
+    /*
+     * Called when setting the parameters
+     */
+    bool convertUYVY::init(const v4l2::parameters&) {
+      return true;
+    }
 
     /*
      * Convert data buffer to an image
      */
-    bool convertYUYV::convert(void* data,
+    bool convertUYVY::convert(void* data,
                               const unsigned int bsize,
                               const bool turnAround,
                               image& theImage) const {
-      
-      const ipoint& resolution(theImage.size());
-      
-      if (bsize<=0) {
-        return false;
-      }
-      
-      const ubyte* buffer = reinterpret_cast<const ubyte*>(data);
-            
-      const ubyte *Y = buffer;
-      const ubyte *u = &buffer[1];
-      const ubyte *v = &buffer[3];
-      const ubyte *Yend;
+      return internal::uyvyToImage(reinterpret_cast<const ubyte*>(data),
+                                   bsize,turnAround,theImage);
+    }
 
-      const int rowBytes = resolution.x*2;
-      
-      if (turnAround) {
-        ubyte* pxptr = reinterpret_cast<ubyte*>(theImage.data());
-        pxptr += (resolution.x*resolution.y*4);
-        
-        int yy,sy;
-        
-        for (sy=0;sy<resolution.y;++sy) {
-          Yend = Y+rowBytes;
-          while (Y != Yend) {
-            yy = (*Y)<<8;
-            
-            // dummy
-            --pxptr;
-            // red
-            --pxptr;
-            (*pxptr) = lutSaturation_[((yy+lutVr_[*v]) >> 8)&0x3FF];
-            // green
-            --pxptr;
-            (*pxptr) = lutSaturation_[((yy-lutUg_[*u]-lutVg_[*v]) >> 8)&0x3FF];
-            // blue
-            --pxptr;
-            (*pxptr) = lutSaturation_[((yy+lutUb_[*u]) >> 8) & 0x3FF];
-            
-            
-            // next pixel doesn't change uv values
-            Y+=2;
-            yy = (*Y)<<8;
-            
-            // dummy
-            --pxptr;
-            // red
-            --pxptr;
-            (*pxptr) = lutSaturation_[((yy+lutVr_[*v]) >> 8)&0x3FF];
-            // green
-            --pxptr;
-            (*pxptr) = lutSaturation_[((yy-lutUg_[*u]-lutVg_[*v]) >> 8)&0x3FF];
-            // blue
-            --pxptr;
-            (*pxptr) = lutSaturation_[((yy+lutUb_[*u]) >> 8)&0x3FF];
-            
-            Y+=2;
-            u+=4;
-            v+=4;
-          }
-        }
-      
-      } else {
-        int yy,sy;
+    /*
+     * Convert data buffer to an channel8 (grey valued channel)
+     */
+    bool convertUYVY::convert(void* data,
+                              const unsigned int bsize,
+                              const bool turnAround,
+                              channel8& img) const {
+      return internal::uyvyToChannel(reinterpret_cast<const ubyte*>(data),
+                                     bsize,turnAround,img);
+    }
 
-        ubyte* pxptr = reinterpret_cast<ubyte*>(theImage.data());      
+    // -----------------------------------------------------------------
+    //                             NV12
+    // -----------------------------------------------------------------
 
-        for (sy=0;sy<resolution.y;++sy) {
-          Yend = Y+rowBytes;
-          while (Y < Yend) {
-            yy = (*Y)<<8;
-            
-            // blue
-            (*pxptr) = lutSaturation_[((yy+lutUb_[*u])>>8)&0x3FF];
-            pxptr++;
-            // green
-            (*pxptr) = lutSaturation_[((yy-lutUg_[*u]-lutVg_[*v])>>8)&0x3FF];
-            pxptr++;
-            // red
-            (*pxptr) = lutSaturation_[((yy+lutVr_[*v])>>8)&0x3FF];
-            pxptr++;
-            // dummy
-            pxptr++;
-            
-            // next pixel doesn't change uv values
-            Y+=2;
-            yy = (*Y)<<8;
-            
-            // blue
-            (*pxptr) = lutSaturation_[((yy+lutUb_[*u])>>8)&0x3FF];
-            pxptr++;
-            // green
-            (*pxptr) = lutSaturation_[((yy-lutUg_[*u]-lutVg_[*v])>>8)&0x3FF];
-            pxptr++;
-            // red
-            (*pxptr) = lutSaturation_[((yy+lutVr_[*v])>>8)&0x3FF];
-            pxptr++;
-            // dummy
-            pxptr++;
-            
-            Y+=2;
-            u+=4;
-            v+=4;
-          }
-        }
-      }
-      
+    /*
+     * YUV 4:2:0 with a Y plane and an interleaved UV plane
+     */
+    class convertNV12 : public ::lti::v4l2::convertBase {
+      /*
+       * Called when setting the parameters
+       */
+      virtual bool init(const v4l2::parameters& par);
+
+      /*
+       * Convert data buffer to an image
+       */
+      virtual bool convert(void* data,
+                           const unsigned int bsize,
+                           const bool turnAround,
+                           image& img) const;
+
+      /*
+       * Convert data buffer to an channel8 (grey valued channel)
+       */
+      virtual bool convert(void* data,
+                           const unsigned int bsize,
+                           const bool turnAround,
+                           channel8& img) const;
+
+    };
+
+    _LTI_V4L2_REGISTER_(NV12,convertNV12);
+
+    /*
+     * Called when setting the parameters
+     */
+    bool convertNV12::init(const v4l2::parameters&) {
       return true;
     }
 
+    /*
+     * Convert data buffer to an image
+     */
+    bool convertNV12::convert(void* data,
+                              const unsigned int bsize,
+                              const bool turnAround,
+                              image& theImage) const {
+      return internal::nv12ToImage(reinterpret_cast<const ubyte*>(data),
+                                   bsize,turnAround,theImage);
+    }
+
     /*
      * Convert data buffer to an channel8 (grey valued channel)
+     *
+     * The Y plane at the beginning of the buffer is already the channel.
      */
-    bool convertYUYV::convert(void* data,
-                                const unsigned int bsize,
-                                const bool turnAround,
-                                channel8& img) const {
-      return ::lti::v4l2::convertBase::convert(data,bsize,turnAround,img);
+    bool convertNV12::convert(void* data,
+                              const unsigned int bsize,
+                              const bool turnAround,
+                              channel8& img) const {
+      return internal::greyToChannel(reinterpret_cast<const ubyte*>(data),
+                                     bsize,turnAround,img);
+    }
+
+    // -----------------------------------------------------------------
+    //                             GREY
+    // -----------------------------------------------------------------
+
+    /*
+     * Gray values, one byte per pixel
+     */
+    class convertGREY : public ::lti::v4l2::convertBase {
+      /*
+       * Called when setting the parameters
+       */
+      virtual bool init(const v4l2::parameters& par);
+
+      /*
+       * Convert data buffer to an image
+       */
+      virtual bool convert(void* data,
+                           const unsigned int bsize,
+                           const bool turnAround,
+                           image& img) const;
+
+      /*
+       * Convert data buffer to an channel8 (grey valued channel)
+       */
+      virtual bool convert(void* data,
+                           const unsigned int bsize,
+                           const bool turnAround,
+                           channel8& img) const;
+
+    };
+
+    _LTI_V4L2_REGISTER_(GREY,convertGREY);
+
+    /*
+     * Called when setting the parameters
+     */
+    bool convertGREY::init(const v4l2::parameters&) {
+      return true;
+    }
+
+    /*
+     * Convert data buffer to an image
+     */
+    bool convertGREY::convert(void* data,
+                              const unsigned int bsize,
+                              const bool turnAround,
+                              image& theImage) const {
+      return internal::greyToImage(reinterpret_cast<const ubyte*>(data),
+                                   bsize,turnAround,theImage);
+    }
+
+    /*
+     * Convert data buffer to an channel8 (grey valued channel)
+     */
+    bool convertGREY::convert(void* data,
+                              const unsigned int bsize,
+                              const bool turnAround,
+                              channel8& img) const {
+      return internal::greyToChannel(reinterpret_cast<const ubyte*>(data),
+                                     bsize,turnAround,img);
     }
 
 
@@ -691,7 +596,9 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
                                 const unsigned int bsize,
                                 const bool turnAround,
                                 channel8& img) const {
-      return ::lti::v4l2::convertBase::convert(data,bsize,turnAround,img);
+      // the luminance does not need the demosaicing
+      return internal::bayerToChannel(reinterpret_cast<const ubyte*>(data),
+                                      bsize,turnAround,img);
     }
 
     // -----------------------------------------------------------------
@@ -1319,6 +1226,7 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
       deviceFile = "/dev/video0";
       selectTimeout = 2.0f;
       selectRetries = 5;
+      numberOfBuffers = 4;
 
     } else {
       // initialize all last used parameters with invalid values to force
@@ -1372,6 +1280,7 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
       deviceFile = "/dev/video0";
       selectTimeout = 2.0f;
       selectRetries = 5;
+      numberOfBuffers = 4;
     }
   }
 
@@ -1422,6 +1331,7 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
     deviceFile = other.deviceFile;
     selectTimeout = other.selectTimeout;
     selectRetries = other.selectRetries;
+    numberOfBuffers = other.numberOfBuffers;
 
     return ( *this );
   }
@@ -1463,6 +1373,7 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
     b = b && lti::write(handler,"deviceFile",deviceFile);
     b = b && lti::write(handler,"selectTimeout",selectTimeout);
     b = b && lti::write(handler,"selectRetries",selectTimeout);
+    b = b && lti::write(handler,"numberOfBuffers",numberOfBuffers);
 
     b = b && frameGrabber::parameters::write(handler,false);
     b = b && camera::parameters::write(handler,false);
@@ -1512,6 +1423,7 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
     b = b && lti::read(handler,"deviceFile",deviceFile);
     b = b && lti::read(handler,"selectTimeout",selectTimeout);
     b = b && lti::read(handler,"selectRetries",selectRetries);
+    b = b && lti::read(handler,"numberOfBuffers",numberOfBuffers);
 
     b = b && frameGrabber::parameters::read(handler,false);
     b = b && camera::parameters::read(handler,false);
@@ -1570,7 +1482,7 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
   v4l2::v4l2()
     : frameGrabber(),camera(),panTiltUnit(),lensUnit(),
       initialized_(false),capturing_(false),cameraHndl_(-1),recursions_(0),
-      lastUsedParams_(false) {
+      lastUsedParams_(false),framesGrabbed_(0) {
 
     // default parameters
     parameters param;
@@ -1580,7 +1492,7 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
   v4l2::v4l2(const std::string& device)
     : frameGrabber(),camera(),panTiltUnit(),lensUnit(),
       initialized_(false),capturing_(false),cameraHndl_(-1),recursions_(0),
-      lastUsedParams_(false) {
+      lastUsedParams_(false),framesGrabbed_(0) {
 
     // default parameters
     parameters param;
@@ -1592,7 +1504,7 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
   v4l2::v4l2( const parameters& theParam )
     : frameGrabber(),camera(),panTiltUnit(),lensUnit(),
       initialized_(false),capturing_(false),cameraHndl_(-1),recursions_(0),
-      lastUsedParams_(false) {
+      lastUsedParams_(false),framesGrabbed_(0) {
 
     setParameters(theParam);
   }
@@ -1600,7 +1512,7 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
   v4l2::v4l2(const v4l2& other)
     : frameGrabber(),camera(),panTiltUnit(),lensUnit(),
       initialized_(false),capturing_(false),cameraHndl_(-1),recursions_(0),
-      lastUsedParams_(false) {
+      lastUsedParams_(false),framesGrabbed_(0) {
     copy(other);
   }
 
@@ -2121,7 +2033,7 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
   bool v4l2::initMemoryMap() {
     struct v4l2_requestbuffers req;
     clear(req);
-    req.count  = 4;
+    req.count  = max(2,getParameters().numberOfBuffers);
     req.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
     req.memory = V4L2_MEMORY_MMAP;
 
@@ -2192,7 +2104,7 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
 
     clear(req);
 
-    req.count  = 4;
+    req.count  = max(2,getParameters().numberOfBuffers);
     req.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
     req.memory = V4L2_MEMORY_USERPTR;
 
@@ -2207,9 +2119,9 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
       }
     }
 
-    buffers_.resize(4);
+    buffers_.resize(req.count);
     
-    for (int i = 0; i < 4; ++i) {
+    for (unsigned int i = 0; i < buffers_.size(); ++i) {
       if (isNull(buffers_[i].reserve(bufferSize,MemoryMap,pageSize))) {
         setStatusString("Out of memory");
         return false;
@@ -5678,6 +5590,25 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
     return true;
   }
 
+  void v4l2::frameCaptured(const timeval& time,const uint32 sequence) {
+    lastFrame_.timestamp = time.tv_sec + time.tv_usec/1000000.0;
+    // the driver increments the sequence number also for the frames it
+    // could not deliver because no buffer was queued
+    lastFrame_.dropped = ((framesGrabbed_ > 0) &&
+                          (sequence > lastFrame_.sequence)) ?
+      static_cast<int>(sequence - lastFrame_.sequence - 1) : 0;
+    lastFrame_.sequence = sequence;
+    ++framesGrabbed_;
+  }
+
+  bool v4l2::getLastFrameInfo(frameInfo& info) const {
+    if (framesGrabbed_ == 0) {
+      return false;
+    }
+    info = lastFrame_;
+    return true;
+  }
+
   template<class I>
   bool v4l2::processImage(void* data,
                           const unsigned int bsize,
@@ -5728,10 +5659,19 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
           }
         }
         
-        return processImage(buffers_[0].ptr(),
-                            buffers_[0].size(),
-                            par.turnAround,
-                            img); 
+        if (!processImage(buffers_[0].ptr(),
+                          buffers_[0].size(),
+                          par.turnAround,
+                          img)) {
+          return false;
+        }
+
+        {
+          // the read() interface does not provide timestamps
+          timeval now;
+          gettimeofday(&now,0);
+          frameCaptured(now,framesGrabbed_);
+        }
         break;
         
       case MemoryMap:
@@ -5774,6 +5714,7 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
                      buffers_[buf.index].size(),
                      par.turnAround,
                      img);
+        frameCaptured(buf.timestamp,buf.sequence);
       
         if (xioctl(cameraHndl_, VIDIOC_QBUF, &buf) == -1) {
           report("VIDIOC_QBUF");
@@ -5819,6 +5760,7 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
                      buf.length,
                      par.turnAround,
                      img);
+        frameCaptured(buf.timestamp,buf.sequence);
         
         if (xioctl (cameraHndl_, VIDIOC_QBUF, &buf) == -1) {
           report("VIDIOC_QBUF");
@@ -6061,6 +6003,7 @@ _LTI_V4L2_REGISTRATION_ ## NAME ## _(::lti::v4l2:: NAME)
         break;
     }
 
+    framesGrabbed_ = 0;
     capturing_ = true;
     return capturing_;
   }
@@ -691,6 +691,21 @@ namespace lti {
        */
       int selectRetries;
 
+      /**
+       * Number of buffers requested to the driver for the MemoryMap and
+       * UserSpace I/O methods.
+       *
+       * The driver fills the queued buffers while the application
+       * processes the previous frames, so that more buffers tolerate longer
+       * delays between two grabs before frames are lost (see also
+       * lti::asyncFrameGrabber).  The driver may grant a different number.
+       *
+       * This value is used only when the device is initialized.
+       *
+       * Default value: 4
+       */
+      int numberOfBuffers;
+
     };
 
     /**
@@ -754,10 +769,24 @@ namespace lti {
     bool apply(image& theImage);
 
     /**
-     * Load a grey value channel from the camera
+     * Load a grey value channel from the camera.
+     *
+     * For the YUV and Bayer pixel formats the channel is taken directly
+     * from the luminance in the buffer, without converting to color first.
      */
     bool apply(channel8& theChannel);
 
+    /**
+     * Get the information about the last grabbed frame.
+     *
+     * With the MemoryMap and UserSpace I/O methods the timestamp and the
+     * sequence number are those given by the driver, so that frames lost
+     * by the driver are detected.  With the Read method the timestamp is
+     * the time of the day at which the frame was read, and no lost frames
+     * can be detected.
+     */
+    virtual bool getLastFrameInfo(frameInfo& info) const;
+
     /**
      * Check if the camera associated with this instance is active (working)
      */
@@ -2059,6 +2088,22 @@ namespace lti {
      * Converter in use.
      */
     convertBase* converter_;
+
+    /**
+     * Information about the last grabbed frame
+     */
+    frameInfo lastFrame_;
+
+    /**
+     * Number of frames grabbed since capturing started
+     */
+    uint32 framesGrabbed_;
+
+    /**
+     * Update lastFrame_ for a frame captured at the given time with the
+     * given sequence number.
+     */
+    void frameCaptured(const timeval& time,const uint32 sequence);
     
   };
 
@@ -0,0 +1,1109 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+
+/**
+ * \file   ltiBinaryStreamHandler.cpp
+ *         Contains lti::binaryStreamHandler a compact binary ioHandler
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include "ltiBinaryStreamHandler.h"
+#include "ltiConfig.h"
+#include <cstring>
+#include <climits>
+#include <vector>
+
+namespace lti {
+
+  namespace {
+    /*
+     * Magic string and format version at the beginning of each stream
+     */
+    const char binaryMagic[4] = {'L','T','I','b'};
+    const ubyte binaryVersion = 1;
+
+    /*
+     * Byte order tags
+     */
+    const char littleEndianTag = 'L';
+    const char bigEndianTag    = 'B';
+
+#ifdef WORDS_BIGENDIAN
+    const char nativeOrder = bigEndianTag;
+#else
+    const char nativeOrder = littleEndianTag;
+#endif
+
+    /*
+     * Size in bytes of the payload of the scalar tags, or -1 for other tags
+     */
+    int tagSize(const ubyte tag) {
+      static const int sizes[] = {
+        -1, // NoTag
+        -1, // BeginTag
+        -1, // EndTag
+        -1, // SymbolTag
+        -1, // StringTag
+         1, // CharTag
+         1, // BoolTag
+         1, // ByteTag
+         1, // UByteTag
+         2, // ShortTag
+         2, // UShortTag
+         4, // IntTag
+         4, // UIntTag
+         8, // LongTag
+         8, // ULongTag
+         4, // FloatTag
+         8, // DoubleTag
+        -1  // ArrayTag
+      };
+      return (tag < sizeof(sizes)/sizeof(int)) ? sizes[tag] : -1;
+    }
+
+    /*
+     * Reverse the bytes of each of the n elements
+     */
+    void swapBytes(void* data,const int elemSize,const int n) {
+      if (elemSize > 1) {
+        char* p = static_cast<char*>(data);
+        char* const end = p + (elemSize*n);
+        for (;p!=end;p+=elemSize) {
+          for (int i=0,j=elemSize-1;i<j;++i,--j) {
+            const char tmp = p[i];
+            p[i]=p[j];
+            p[j]=tmp;
+          }
+        }
+      }
+    }
+
+    /*
+     * Convert the element of type S stored at src into T
+     */
+    template<typename S,typename T>
+    inline void convertElement(const char* src,T& dest) {
+      S tmp;
+      memcpy(&tmp,src,sizeof(S));
+      dest = static_cast<T>(tmp);
+    }
+  }
+
+  // --------------------------------------------------
+  // binaryStreamHandler::stackElement
+  // --------------------------------------------------
+
+  binaryStreamHandler::stackElement::stackElement()
+    : cache(),complete(false),level(0) {
+  }
+
+  // --------------------------------------------------
+  // binaryStreamHandler
+  // --------------------------------------------------
+
+  // default constructor
+  binaryStreamHandler::binaryStreamHandler()
+    : ioHandler(),inStream_(0),outStream_(0),pending_(),pendingPos_(0),
+      swap_(false),validInput_(false),position_(0),inputSize_(-1),
+      tokens_(0),lastBeginLevel_(-1),lastBeginTokens_(-1),restoreTo_(-1) {
+  }
+
+  // output constructor
+  binaryStreamHandler::binaryStreamHandler(std::ostream& aStream)
+    : ioHandler(),inStream_(0),outStream_(0),pending_(),pendingPos_(0),
+      swap_(false),validInput_(false),position_(0),inputSize_(-1),
+      tokens_(0),lastBeginLevel_(-1),lastBeginTokens_(-1),restoreTo_(-1) {
+    use(aStream);
+  }
+
+  // input constructor
+  binaryStreamHandler::binaryStreamHandler(std::istream& aStream)
+    : ioHandler(),inStream_(0),outStream_(0),pending_(),pendingPos_(0),
+      swap_(false),validInput_(false),position_(0),inputSize_(-1),
+      tokens_(0),lastBeginLevel_(-1),lastBeginTokens_(-1),restoreTo_(-1) {
+    use(aStream);
+  }
+
+  // copy constructor
+  binaryStreamHandler::binaryStreamHandler(const binaryStreamHandler& other)
+    : ioHandler() {
+    copy(other);
+  }
+
+  // destructor
+  binaryStreamHandler::~binaryStreamHandler() {
+    inStream_ = 0;
+    outStream_ = 0;
+  }
+
+  void binaryStreamHandler::use(std::istream& aStream) {
+    clear();
+    inStream_ = &aStream;
+    position_ = 0;
+
+    // the length of the stream bounds the sizes found in it.  Pipes and
+    // other streams that cannot seek are only checked against INT_MAX.
+    inputSize_ = -1;
+    const std::streampos start = aStream.tellg();
+    if (start != std::streampos(-1)) {
+      aStream.seekg(0,std::ios_base::end);
+      const std::streampos end = aStream.tellg();
+      aStream.clear();
+      aStream.seekg(start);
+      if (end != std::streampos(-1)) {
+        inputSize_ = static_cast<int64>(end-start);
+      }
+    }
+
+    validInput_ = readHeader();
+  }
+
+  void binaryStreamHandler::use(std::ostream& aStream) {
+    clear();
+    outStream_ = &aStream;
+    writeHeader();
+  }
+
+  void binaryStreamHandler::clear() {
+    resetLevel();
+    pending_.clear();
+    pendingPos_ = 0;
+    stack_.clear();
+    tokens_ = 0;
+    lastBeginLevel_ = -1;
+    lastBeginTokens_ = -1;
+    restoreTo_ = -1;
+  }
+
+  // get type name
+  const std::string& binaryStreamHandler::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // copy member
+  binaryStreamHandler&
+  binaryStreamHandler::copy(const binaryStreamHandler& other) {
+    ioHandler::copy(other);
+    inStream_        = other.inStream_;
+    outStream_       = other.outStream_;
+    pending_         = other.pending_;
+    pendingPos_      = other.pendingPos_;
+    swap_            = other.swap_;
+    validInput_      = other.validInput_;
+    position_        = other.position_;
+    inputSize_       = other.inputSize_;
+    tokens_          = other.tokens_;
+    lastBeginLevel_  = other.lastBeginLevel_;
+    lastBeginTokens_ = other.lastBeginTokens_;
+    restoreTo_       = other.restoreTo_;
+    stack_           = other.stack_;
+    return (*this);
+  }
+
+  binaryStreamHandler&
+  binaryStreamHandler::operator=(const binaryStreamHandler& other) {
+    return copy(other);
+  }
+
+  // clone member
+  binaryStreamHandler* binaryStreamHandler::clone() const {
+    return new binaryStreamHandler(*this);
+  }
+
+  // newInstance member
+  binaryStreamHandler* binaryStreamHandler::newInstance() const {
+    return new binaryStreamHandler();
+  }
+
+  // -------------------------------------------------------------------
+  // low level input/output
+  // -------------------------------------------------------------------
+
+  bool binaryStreamHandler::writeHeader() {
+    if (isNull(outStream_)) {
+      return false;
+    }
+    outStream_->write(binaryMagic,sizeof(binaryMagic));
+    outStream_->put(static_cast<char>(binaryVersion));
+    outStream_->put(nativeOrder);
+    return outStream_->good();
+  }
+
+  bool binaryStreamHandler::readHeader() {
+    char header[sizeof(binaryMagic)+2];
+    inStream_->read(header,sizeof(header));
+    if (inStream_->gcount() != static_cast<int>(sizeof(header))) {
+      setStatusString("Binary stream too short: no header found");
+      return false;
+    }
+    position_ += sizeof(header);
+
+    if (memcmp(header,binaryMagic,sizeof(binaryMagic)) != 0) {
+      setStatusString("Stream is not an LTI-Lib binary stream");
+      return false;
+    }
+    if (static_cast<ubyte>(header[sizeof(binaryMagic)]) > binaryVersion) {
+      setStatusString("Unsupported binary stream version");
+      return false;
+    }
+
+    const char order = header[sizeof(binaryMagic)+1];
+    if ((order != littleEndianTag) && (order != bigEndianTag)) {
+      setStatusString("Invalid byte order in binary stream header");
+      return false;
+    }
+    swap_ = (order != nativeOrder);
+    return true;
+  }
+
+  bool binaryStreamHandler::writeToken(const ubyte tag,
+                                       const void* data,
+                                       const int size) {
+    outStream_->put(static_cast<char>(tag));
+    if (size > 0) {
+      outStream_->write(static_cast<const char*>(data),size);
+    }
+    return outStream_->good();
+  }
+
+  bool binaryStreamHandler::writeText(const ubyte tag,
+                                      const std::string& data) {
+    const uint32 size = static_cast<uint32>(data.size());
+    outStream_->put(static_cast<char>(tag));
+    outStream_->write(reinterpret_cast<const char*>(&size),sizeof(size));
+    outStream_->write(data.data(),size);
+    return outStream_->good();
+  }
+
+  bool binaryStreamHandler::writeBlock(const ubyte elemTag,
+                                       const void* data,
+                                       const int elemSize,
+                                       const int n) {
+    const uint32 size = static_cast<uint32>(n);
+    outStream_->put(static_cast<char>(ArrayTag));
+    outStream_->put(static_cast<char>(elemTag));
+    outStream_->write(reinterpret_cast<const char*>(&size),sizeof(size));
+    if (n > 0) {
+      outStream_->write(static_cast<const char*>(data),
+                        static_cast<std::streamsize>(elemSize)*n);
+    }
+    return outStream_->good();
+  }
+
+  bool binaryStreamHandler::get(void* data,const int size) {
+    char* dest = static_cast<char*>(data);
+    int left = size;
+
+    if (pendingPos_ < pending_.size()) {
+      const int avail = static_cast<int>(pending_.size()-pendingPos_);
+      const int n = (left < avail) ? left : avail;
+      memcpy(dest,pending_.data()+pendingPos_,n);
+      pendingPos_ += n;
+      dest += n;
+      left -= n;
+      if (pendingPos_ >= pending_.size()) {
+        pending_.clear();
+        pendingPos_ = 0;
+      }
+    }
+
+    if (left > 0) {
+      if (isNull(inStream_) || !validInput_) {
+        return false;
+      }
+      inStream_->read(dest,left);
+      const int got = static_cast<int>(inStream_->gcount());
+      position_ += got;
+      return (got == left);
+    }
+
+    return true;
+  }
+
+  bool binaryStreamHandler::getSize(uint32& size) {
+    if (get(&size,sizeof(size))) {
+      if (swap_) {
+        swapBytes(&size,sizeof(size),1);
+      }
+      return true;
+    }
+    return false;
+  }
+
+  ubyte binaryStreamHandler::peekTag() {
+    if (pendingPos_ < pending_.size()) {
+      return static_cast<ubyte>(pending_[pendingPos_]);
+    }
+    if (isNull(inStream_) || !validInput_) {
+      return NoTag;
+    }
+    const int c = inStream_->peek();
+    return (c == std::char_traits<char>::eof()) ? ubyte(NoTag) : ubyte(c);
+  }
+
+  ubyte binaryStreamHandler::getTag() {
+    ubyte tag;
+    if (get(&tag,1)) {
+      ++tokens_;
+      return tag;
+    }
+    return NoTag;
+  }
+
+  bool binaryStreamHandler::byteCount(const uint32 count,
+                                      const int elemSize,
+                                      int& bytes) const {
+    const uint64 total = static_cast<uint64>(count)*elemSize;
+    if (total > static_cast<uint64>(INT_MAX)) {
+      return false;
+    }
+    if (inputSize_ >= 0) {
+      const int64 unread = inputSize_-position_;
+      const uint64 left = static_cast<uint64>(pending_.size()-pendingPos_) +
+        ((unread > 0) ? static_cast<uint64>(unread) : uint64(0));
+      if (total > left) {
+        return false;
+      }
+    }
+    bytes = static_cast<int>(total);
+    return true;
+  }
+
+  bool binaryStreamHandler::move(std::string* raw,const int size) {
+    if (notNull(raw)) {
+      const std::string::size_type pos = raw->size();
+      raw->resize(pos+size);
+      return (size == 0) || get(&(*raw)[pos],size);
+    }
+
+    // just discard the data
+    static const int chunk = 8192;
+    char buffer[chunk];
+    int left = size;
+    while (left > 0) {
+      const int n = (left < chunk) ? left : chunk;
+      if (!get(buffer,n)) {
+        return false;
+      }
+      left -= n;
+    }
+    return true;
+  }
+
+  ubyte binaryStreamHandler::copyToken(std::string* raw) {
+    const ubyte tag = getTag();
+    if (tag == NoTag) {
+      return NoTag;
+    }
+    if (notNull(raw)) {
+      raw->push_back(static_cast<char>(tag));
+    }
+
+    bool ok = true;
+    switch (tag) {
+      case BeginTag:
+      case EndTag:
+        break;
+      case SymbolTag:
+      case StringTag: {
+        uint32 size;
+        int bytes = 0;
+        ok = getSize(size) && byteCount(size,1,bytes);
+        if (ok) {
+          if (notNull(raw)) {
+            uint32 stored = size;
+            if (swap_) {
+              swapBytes(&stored,sizeof(stored),1);
+            }
+            raw->append(reinterpret_cast<const char*>(&stored),
+                        sizeof(stored));
+          }
+          ok = move(raw,bytes);
+        }
+      } break;
+      case ArrayTag: {
+        ubyte elemTag;
+        uint32 size;
+        int bytes = 0;
+        ok = get(&elemTag,1) && (tagSize(elemTag) > 0) && getSize(size) &&
+          byteCount(size,tagSize(elemTag),bytes);
+        if (ok) {
+          if (notNull(raw)) {
+            uint32 stored = size;
+            if (swap_) {
+              swapBytes(&stored,sizeof(stored),1);
+            }
+            raw->push_back(static_cast<char>(elemTag));
+            raw->append(reinterpret_cast<const char*>(&stored),
+                        sizeof(stored));
+          }
+          ok = move(raw,bytes);
+        }
+      } break;
+      default: {
+        const int size = tagSize(tag);
+        ok = (size > 0) && move(raw,size);
+      }
+    }
+
+    if (!ok) {
+      setStatusString("Corrupted binary stream");
+      appendContextStatus();
+      return NoTag;
+    }
+
+    return tag;
+  }
+
+  bool binaryStreamHandler::completePair(std::string& raw) {
+    int depth = 0;
+    ubyte tag;
+    while ((tag = copyToken(&raw)) != NoTag) {
+      if (tag == BeginTag) {
+        ++depth;
+      } else if (tag == EndTag) {
+        if (depth == 0) {
+          return true;
+        }
+        --depth;
+      }
+    }
+    return false;
+  }
+
+  // -------------------------------------------------------------------
+  // begin and end
+  // -------------------------------------------------------------------
+
+  bool binaryStreamHandler::writeBegin() {
+    ioHandler::writeBegin();
+    return writeToken(BeginTag,0,0);
+  }
+
+  bool binaryStreamHandler::writeEnd() {
+    ioHandler::writeEnd();
+    return writeToken(EndTag,0,0);
+  }
+
+  bool binaryStreamHandler::readBegin() {
+    if (stack_.empty() || stack_.front().level != (getLevel()+1) ||
+        ((!stack_.front().complete) && stack_.front().cache.empty())) {
+      if (peekTag() == BeginTag) {
+        getTag();
+      } else {
+        appendContextStatus();
+        return false;
+      }
+    }
+    // else the begin token was not really read, since the next pair could
+    // be in the cache.  It will be read by trySymbol() if necessary.
+
+    ioHandler::readBegin();
+    lastBeginLevel_ = getLevel();
+    lastBeginTokens_ = tokens_;
+    return true;
+  }
+
+  bool binaryStreamHandler::readEnd() {
+    int depth = 0;
+    ubyte tag;
+
+    // skip everything not read until the end of the current level
+    do {
+      tag = copyToken(0);
+      if (tag == BeginTag) {
+        ++depth;
+      } else if (tag == EndTag) {
+        --depth;
+      }
+    } while ((tag != NoTag) && (depth >= 0));
+
+    if (tag == EndTag) {
+      while (!stack_.empty() && (stack_.front().level > getLevel())) {
+        // pop all unused data (these should already be processed!)
+        stack_.pop_front();
+      }
+      return ioHandler::readEnd();
+    }
+
+    appendContextStatus();
+    return false;
+  }
+
+  bool binaryStreamHandler::tryBegin() {
+    if (peekTag() == BeginTag) {
+      return readBegin();
+    }
+    return false;
+  }
+
+  bool binaryStreamHandler::tryEnd() {
+    if (peekTag() == EndTag) {
+      return readEnd();
+    }
+    return false;
+  }
+
+  // -------------------------------------------------------------------
+  // symbols
+  // -------------------------------------------------------------------
+
+  bool binaryStreamHandler::writeSymbol(const std::string& data) {
+    return writeText(SymbolTag,data);
+  }
+
+  bool binaryStreamHandler::readSymbol(std::string& data) {
+    return readText(data);
+  }
+
+  bool binaryStreamHandler::trySymbol(const std::string& data) {
+    // if the pair began with the last readBegin(), that level has to be
+    // restored if the symbol is not found
+    const bool pairBegin = ((lastBeginLevel_ == getLevel()) &&
+                            (lastBeginTokens_ == tokens_));
+    restoreTo_ = pairBegin ? getLevel()-1 : -1;
+
+    while (!stack_.empty() && stack_.front().level > getLevel()) {
+      // pop all unused data (these should already be processed!)
+      stack_.pop_front();
+    }
+
+    if (stack_.empty() || stack_.front().level < getLevel()) {
+      // no stack for this level there... create one:
+      stackElement elem;
+      elem.level = getLevel();
+      stack_.push_front(elem);
+    } else {
+      stackElement& elem = stack_.front();
+      cacheType::iterator it = elem.cache.find(data);
+      if (it != elem.cache.end()) {
+        // already read: insert the rest of the pair in the input
+        pending_.erase(0,pendingPos_);
+        pendingPos_ = 0;
+        pending_.insert(0,(*it).second);
+        elem.cache.erase(it);
+        restoreTo_ = -1;
+        return true;
+      } else if (elem.complete) {
+        // stack completed and the symbol is not there!
+        return false;
+      }
+
+      if (!elem.cache.empty()) {
+        // read the begin token not really read by the last readBegin()
+        if (peekTag() == BeginTag) {
+          getTag();
+        } else {
+          elem.complete = true;
+          return false;
+        }
+      }
+    }
+
+    stackElement& elem = stack_.front();
+    std::string symb;
+
+    if ((peekTag() != SymbolTag) || !readText(symb)) {
+      elem.complete = true;
+      return false;
+    }
+
+    while (symb != data) {
+      // wrong symbol read... save the rest of its pair for later use
+      std::string raw;
+      if (!completePair(raw)) {
+        elem.complete = true;
+        return false;
+      }
+      elem.cache[symb].swap(raw);
+
+      // try to get the next symbol/value pair
+      if (peekTag() == BeginTag) {
+        getTag();
+        if ((peekTag() != SymbolTag) || !readText(symb)) {
+          elem.complete = true;
+          return false;
+        }
+      } else {
+        // no more pairs in this level
+        elem.complete = true;
+        return false;
+      }
+    }
+
+    restoreTo_ = -1;
+    return true;
+  }
+
+  bool binaryStreamHandler::restoreLevel() {
+    if (restoreTo_ >= 0) {
+      level_ = restoreTo_;
+      restoreTo_ = -1;
+    }
+    return true;
+  }
+
+  // -------------------------------------------------------------------
+  // ignored tokens
+  // -------------------------------------------------------------------
+
+  bool binaryStreamHandler::writeComment(const std::string&) {
+    return true;
+  }
+
+  bool binaryStreamHandler::writeComment(const char*) {
+    return true;
+  }
+
+  bool binaryStreamHandler::writeSpaces(const int) {
+    return true;
+  }
+
+  bool binaryStreamHandler::writeEOL() {
+    return true;
+  }
+
+  bool binaryStreamHandler::writeKeyValueSeparator() {
+    return true;
+  }
+
+  bool binaryStreamHandler::writeDataSeparator() {
+    return true;
+  }
+
+  bool binaryStreamHandler::readKeyValueSeparator() {
+    return true;
+  }
+
+  bool binaryStreamHandler::readDataSeparator() {
+    return true;
+  }
+
+  bool binaryStreamHandler::eof() {
+    return (peekTag() == NoTag);
+  }
+
+  void binaryStreamHandler::appendContextStatus() const {
+    appendStatusString("\n  at byte ");
+    appendStatusString(static_cast<double>(position_));
+    appendStatusString(" of the stream, level ");
+    appendStatusString(getLevel());
+  }
+
+  // -------------------------------------------------------------------
+  // write standard types
+  // -------------------------------------------------------------------
+
+  bool binaryStreamHandler::write(const std::string& data) {
+    return writeText(StringTag,data);
+  }
+
+  bool binaryStreamHandler::write(const char* data) {
+    return writeText(StringTag,std::string(data));
+  }
+
+  bool binaryStreamHandler::write(const double data) {
+    return writeToken(DoubleTag,&data,sizeof(data));
+  }
+
+  bool binaryStreamHandler::write(const float data) {
+    return writeToken(FloatTag,&data,sizeof(data));
+  }
+
+  bool binaryStreamHandler::write(const int data) {
+    const int32 tmp = static_cast<int32>(data);
+    return writeToken(IntTag,&tmp,sizeof(tmp));
+  }
+
+  bool binaryStreamHandler::write(const unsigned int data) {
+    const uint32 tmp = static_cast<uint32>(data);
+    return writeToken(UIntTag,&tmp,sizeof(tmp));
+  }
+
+  bool binaryStreamHandler::write(const char data) {
+    return writeToken(CharTag,&data,sizeof(data));
+  }
+
+  bool binaryStreamHandler::write(const byte data) {
+    return writeToken(ByteTag,&data,sizeof(data));
+  }
+
+  bool binaryStreamHandler::write(const ubyte data) {
+    return writeToken(UByteTag,&data,sizeof(data));
+  }
+
+  bool binaryStreamHandler::write(const bool data) {
+    const ubyte tmp = data ? 1 : 0;
+    return writeToken(BoolTag,&tmp,sizeof(tmp));
+  }
+
+  bool binaryStreamHandler::write(const long data) {
+    const int64 tmp = static_cast<int64>(data);
+    return writeToken(LongTag,&tmp,sizeof(tmp));
+  }
+
+  bool binaryStreamHandler::write(const unsigned long data) {
+    const uint64 tmp = static_cast<uint64>(data);
+    return writeToken(ULongTag,&tmp,sizeof(tmp));
+  }
+
+  bool binaryStreamHandler::write(const short data) {
+    const int16 tmp = static_cast<int16>(data);
+    return writeToken(ShortTag,&tmp,sizeof(tmp));
+  }
+
+  bool binaryStreamHandler::write(const unsigned short data) {
+    const uint16 tmp = static_cast<uint16>(data);
+    return writeToken(UShortTag,&tmp,sizeof(tmp));
+  }
+
+  // -------------------------------------------------------------------
+  // read standard types
+  // -------------------------------------------------------------------
+
+  bool binaryStreamHandler::readText(std::string& data) {
+    const ubyte tag = peekTag();
+    if ((tag != SymbolTag) && (tag != StringTag)) {
+      return false;
+    }
+    getTag();
+
+    uint32 size;
+    int bytes;
+    if (!getSize(size)) {
+      return false;
+    }
+    if (!byteCount(size,1,bytes)) {
+      setStatusString("Corrupted binary stream");
+      appendContextStatus();
+      return false;
+    }
+    data.resize(bytes);
+    return (bytes == 0) || get(&data[0],bytes);
+  }
+
+  template<typename T>
+  bool binaryStreamHandler::convert(const char* src,
+                                    const ubyte tag,
+                                    const int n,
+                                    T* dest) const {
+    const int size = tagSize(tag);
+    const char* const end = src + (size*n);
+    for (;src!=end;src+=size,++dest) {
+      switch (tag) {
+        case CharTag:   convertElement<char>(src,*dest);     break;
+        case BoolTag:   convertElement<ubyte>(src,*dest);    break;
+        case ByteTag:   convertElement<byte>(src,*dest);     break;
+        case UByteTag:  convertElement<ubyte>(src,*dest);    break;
+        case ShortTag:  convertElement<int16>(src,*dest);    break;
+        case UShortTag: convertElement<uint16>(src,*dest);   break;
+        case IntTag:    convertElement<int32>(src,*dest);    break;
+        case UIntTag:   convertElement<uint32>(src,*dest);   break;
+        case LongTag:   convertElement<int64>(src,*dest);    break;
+        case ULongTag:  convertElement<uint64>(src,*dest);   break;
+        case FloatTag:  convertElement<float>(src,*dest);    break;
+        case DoubleTag: convertElement<double>(src,*dest);   break;
+        default:
+          return false;
+      }
+    }
+    return true;
+  }
+
+  bool binaryStreamHandler::readScalar(int64& intValue,
+                                       double& realValue,
+                                       bool& isReal) {
+    const ubyte tag = peekTag();
+    const int size = tagSize(tag);
+    if (size <= 0) {
+      return false;
+    }
+    getTag();
+
+    char buffer[8];
+    if (!get(buffer,size)) {
+      return false;
+    }
+    if (swap_) {
+      swapBytes(buffer,size,1);
+    }
+
+    isReal = ((tag == FloatTag) || (tag == DoubleTag));
+    return isReal ? convert(buffer,tag,1,&realValue) :
+                    convert(buffer,tag,1,&intValue);
+  }
+
+  bool binaryStreamHandler::readInteger(int64& data) {
+    double real;
+    bool isReal;
+    if (readScalar(data,real,isReal)) {
+      if (isReal) {
+        data = static_cast<int64>(real);
+      }
+      return true;
+    }
+    return false;
+  }
+
+  bool binaryStreamHandler::readReal(double& data) {
+    int64 integer;
+    bool isReal;
+    if (readScalar(integer,data,isReal)) {
+      if (!isReal) {
+        data = static_cast<double>(integer);
+      }
+      return true;
+    }
+    return false;
+  }
+
+  bool binaryStreamHandler::read(std::string& data) {
+    return readText(data);
+  }
+
+  bool binaryStreamHandler::read(double& data) {
+    return readReal(data);
+  }
+
+  bool binaryStreamHandler::read(float& data) {
+    double tmp;
+    if (readReal(tmp)) {
+      data = static_cast<float>(tmp);
+      return true;
+    }
+    return false;
+  }
+
+  bool binaryStreamHandler::read(int& data) {
+    int64 tmp;
+    if (readInteger(tmp)) {
+      data = static_cast<int>(tmp);
+      return true;
+    }
+    return false;
+  }
+
+  bool binaryStreamHandler::read(unsigned int& data) {
+    int64 tmp;
+    if (readInteger(tmp)) {
+      data = static_cast<unsigned int>(tmp);
+      return true;
+    }
+    return false;
+  }
+
+  bool binaryStreamHandler::read(char& data) {
+    int64 tmp;
+    if (readInteger(tmp)) {
+      data = static_cast<char>(tmp);
+      return true;
+    }
+    return false;
+  }
+
+  bool binaryStreamHandler::read(byte& data) {
+    int64 tmp;
+    if (readInteger(tmp)) {
+      data = static_cast<byte>(tmp);
+      return true;
+    }
+    return false;
+  }
+
+  bool binaryStreamHandler::read(ubyte& data) {
+    int64 tmp;
+    if (readInteger(tmp)) {
+      data = static_cast<ubyte>(tmp);
+      return true;
+    }
+    return false;
+  }
+
+  bool binaryStreamHandler::read(bool& data) {
+    int64 tmp;
+    if (readInteger(tmp)) {
+      data = (tmp != 0);
+      return true;
+    }
+    return false;
+  }
+
+  bool binaryStreamHandler::read(long& data) {
+    int64 tmp;
+    if (readInteger(tmp)) {
+      data = static_cast<long>(tmp);
+      return true;
+    }
+    return false;
+  }
+
+  bool binaryStreamHandler::read(unsigned long& data) {
+    int64 tmp;
+    if (readInteger(tmp)) {
+      data = static_cast<unsigned long>(tmp);
+      return true;
+    }
+    return false;
+  }
+
+  bool binaryStreamHandler::read(short& data) {
+    int64 tmp;
+    if (readInteger(tmp)) {
+      data = static_cast<short>(tmp);
+      return true;
+    }
+    return false;
+  }
+
+  bool binaryStreamHandler::read(unsigned short& data) {
+    int64 tmp;
+    if (readInteger(tmp)) {
+      data = static_cast<unsigned short>(tmp);
+      return true;
+    }
+    return false;
+  }
+
+  // -------------------------------------------------------------------
+  // arrays
+  // -------------------------------------------------------------------
+
+  bool binaryStreamHandler::writeArray(const double* data,const int n) {
+    return writeBlock(DoubleTag,data,sizeof(double),n);
+  }
+
+  bool binaryStreamHandler::writeArray(const float* data,const int n) {
+    return writeBlock(FloatTag,data,sizeof(float),n);
+  }
+
+  bool binaryStreamHandler::writeArray(const int* data,const int n) {
+    return writeBlock(IntTag,data,sizeof(int),n);
+  }
+
+  bool binaryStreamHandler::writeArray(const unsigned int* data,
+                                       const int n) {
+    return writeBlock(UIntTag,data,sizeof(unsigned int),n);
+  }
+
+  bool binaryStreamHandler::writeArray(const byte* data,const int n) {
+    return writeBlock(ByteTag,data,sizeof(byte),n);
+  }
+
+  bool binaryStreamHandler::writeArray(const ubyte* data,const int n) {
+    return writeBlock(UByteTag,data,sizeof(ubyte),n);
+  }
+
+  bool binaryStreamHandler::writeArray(const short* data,const int n) {
+    return writeBlock(ShortTag,data,sizeof(short),n);
+  }
+
+  bool binaryStreamHandler::writeArray(const unsigned short* data,
+                                       const int n) {
+    return writeBlock(UShortTag,data,sizeof(unsigned short),n);
+  }
+
+  template<typename T>
+  bool binaryStreamHandler::readBlock(T* data,const int n,const ubyte tag) {
+    if (peekTag() != ArrayTag) {
+      // maybe written element by element
+      return ioHandler::readArray(data,n);
+    }
+    getTag();
+
+    ubyte elemTag;
+    uint32 size;
+    int bytes;
+    if (!get(&elemTag,1) || (tagSize(elemTag) <= 0) || !getSize(size) ||
+        !byteCount(size,tagSize(elemTag),bytes)) {
+      setStatusString("Corrupted binary stream");
+      appendContextStatus();
+      return false;
+    }
+
+    if (size != static_cast<uint32>(n)) {
+      // wrong size: skip the data to remain in a consistent state
+      move(0,bytes);
+      setStatusString("Array size mismatch in binary stream");
+      appendContextStatus();
+      return false;
+    }
+
+    if (elemTag == tag) {
+      // the usual case: just copy the block
+      if (!get(data,bytes)) {
+        return false;
+      }
+      if (swap_) {
+        swapBytes(data,sizeof(T),n);
+      }
+      return true;
+    }
+
+    // the elements were written with another type: convert them
+    const int elemSize = tagSize(elemTag);
+    std::vector<char> buffer(bytes);
+    if ((n > 0) && !get(&buffer[0],bytes)) {
+      return false;
+    }
+    if (swap_) {
+      swapBytes(&buffer[0],elemSize,n);
+    }
+    return (n == 0) || convert(&buffer[0],elemTag,n,data);
+  }
+
+  bool binaryStreamHandler::readArray(double* data,const int n) {
+    return readBlock(data,n,DoubleTag);
+  }
+
+  bool binaryStreamHandler::readArray(float* data,const int n) {
+    return readBlock(data,n,FloatTag);
+  }
+
+  bool binaryStreamHandler::readArray(int* data,const int n) {
+    return readBlock(data,n,IntTag);
+  }
+
+  bool binaryStreamHandler::readArray(unsigned int* data,const int n) {
+    return readBlock(data,n,UIntTag);
+  }
+
+  bool binaryStreamHandler::readArray(byte* data,const int n) {
+    return readBlock(data,n,ByteTag);
+  }
+
+  bool binaryStreamHandler::readArray(ubyte* data,const int n) {
+    return readBlock(data,n,UByteTag);
+  }
+
+  bool binaryStreamHandler::readArray(short* data,const int n) {
+    return readBlock(data,n,ShortTag);
+  }
+
+  bool binaryStreamHandler::readArray(unsigned short* data,const int n) {
+    return readBlock(data,n,UShortTag);
+  }
+
+}
@@ -0,0 +1,762 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+
+/**
+ * \file   ltiBinaryStreamHandler.h
+ *         Contains lti::binaryStreamHandler a compact binary ioHandler
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#ifndef _LTI_BINARY_STREAM_HANDLER_H_
+#define _LTI_BINARY_STREAM_HANDLER_H_
+
+
+#include "ltiObject.h"
+#include "ltiIoHandler.h"
+#include <string>
+#include <map>
+#include <list>
+
+#include <iostream>
+
+namespace lti {
+  /**
+   * The binaryStreamHandler class offers an interface for the functor
+   * parameters and other classes to read() and write() them in a compact
+   * binary format.
+   *
+   * It can be used everywhere a lti::lispStreamHandler is used, but it
+   * produces smaller files which are much faster to load, since numbers do
+   * not need to be formatted or parsed.  The arrays written by
+   * lti::genericVector and lti::genericMatrix (and therefore also by all
+   * vectors, matrices, channels and images) are transferred as raw memory
+   * blocks.
+   *
+   * The stream starts with a short header containing the magic string
+   * "LTIb", the version of the format and the byte order of the machine
+   * that wrote it.  All data is written in the native byte order of that
+   * machine, and swapped while reading if the reading machine uses a
+   * different one.  Each token starts with a one-byte tag indicating its
+   * type, so that numbers written with one type can be read as another
+   * one (for example, a float can be read as a double), and the symbol/value
+   * pairs can be read in a different order than they were written, just as
+   * with the lispStreamHandler.
+   *
+   * Comments, spaces, end of lines and separators are not stored at all.
+   *
+   * \warning The given streams must be opened in binary mode
+   * (std::ios::binary), otherwise some platforms will corrupt the data
+   * translating the end of line characters.
+   *
+   * Example:
+   * \code
+   * // the binary stream formatting object
+   * lti::binaryStreamHandler bsh;
+   *
+   * // Write example:
+   *
+   * // open a stream in binary mode
+   * std::ofstream out("testfile.bin",std::ios::out | std::ios::binary);
+   *
+   * // tell the binary stream handler to use the given stream
+   * bsh.use(out);
+   *
+   * lti::dmatrix mat(100,100,1.0);
+   * lti::write(bsh,"aMatrix",mat);
+   * lti::write(bsh,"aString","hello world");
+   *
+   * out.close();
+   *
+   * // Read example
+   *
+   * // Open a stream in binary mode
+   * std::ifstream in("testfile.bin",std::ios::in | std::ios::binary);
+   *
+   * bsh.use(in);
+   * lti::read(bsh,"aMatrix",mat);
+   *
+   * std::string str;
+   * lti::read(bsh,"aString",str);
+   *
+   * in.close();
+   * \endcode
+   *
+   * @ingroup gStorable
+   */
+  class binaryStreamHandler : public ioHandler {
+  public:
+    /**
+     * Default constructor
+     */
+    binaryStreamHandler();
+
+    /**
+     * Constructor for output.
+     *
+     * The stream header is immediately written into the given stream.
+     *
+     * \warning The given stream must be opened in binary mode.
+     */
+    binaryStreamHandler(std::ostream& aStream);
+
+    /**
+     * Constructor for input.
+     *
+     * The stream header is immediately read from the given stream.
+     *
+     * \warning The given stream must be opened in binary mode.
+     */
+    binaryStreamHandler(std::istream& aStream);
+
+    /**
+     * Copy constructor
+     */
+    binaryStreamHandler(const binaryStreamHandler& other);
+
+    /**
+     * Destructor
+     */
+    virtual ~binaryStreamHandler();
+
+    /**
+     * Indicate the output stream to be used.
+     *
+     * Calling this method you will reinitialize the state of the
+     * handler (see also clear()) and the stream header will be written.
+     */
+    void use(std::ostream& aStream);
+
+    /**
+     * Indicate the input stream to be used.
+     *
+     * Calling this method you will reinitialize the state of the
+     * handler (see also clear()) and the stream header will be read.  If
+     * the header is not valid, the status string will explain it and all
+     * further read operations will fail.
+     */
+    void use(std::istream& aStream);
+
+    /**
+     * This method resets all internal state variables in a way that the
+     * next operations behave as if this handler were used for the first
+     * time.  The stream header is not written or read again.  If you use
+     * this method "within" a read/write process, the behaviour will be
+     * unpredictable.
+     */
+    void clear();
+
+    /**
+     * Copy data of "other" handler.
+     * @param other the handler to be copied
+     * @return a reference to this handler object
+     */
+    binaryStreamHandler& copy(const binaryStreamHandler& other);
+
+    /**
+     * Copy data of "other" handler.
+     * @param other the handler to be copied
+     * @return a reference to this handler object
+     */
+    binaryStreamHandler& operator=(const binaryStreamHandler& other);
+
+    /**
+     * Returns the name of this class.
+     */
+    virtual const std::string& name() const;
+
+    /**
+     * Returns a pointer to a clone of this handler.
+     */
+    virtual binaryStreamHandler* clone() const;
+
+    /**
+     * Returns a pointer to a new instance of this handler.
+     */
+    virtual binaryStreamHandler* newInstance() const;
+
+    /**
+     * Write the begin token
+     */
+    virtual bool writeBegin();
+
+    /**
+     * Write the end token
+     */
+    virtual bool writeEnd();
+
+    /**
+     * Read the begin token
+     */
+    virtual bool readBegin();
+
+    /**
+     * Read the end token, skipping all data of the current level not
+     * read yet.
+     */
+    virtual bool readEnd();
+
+    /**
+     * @name Write members
+     */
+    //@{
+    /**
+     * Write a std::string
+     */
+    virtual bool write(const std::string& data);
+
+    /**
+     * Write a character string
+     */
+    virtual bool write(const char* data);
+
+    /**
+     * Write a double value
+     */
+    virtual bool write(const double data);
+
+    /**
+     * Write a float value
+     */
+    virtual bool write(const float data);
+
+    /**
+     * Write an integer value
+     */
+    virtual bool write(const int data);
+
+    /**
+     * Write an unsigned integer value
+     */
+    virtual bool write(const unsigned int data);
+
+    /**
+     * Write a char
+     */
+    virtual bool write(const char data);
+
+    /**
+     * Write an 8-bit signed value
+     */
+    virtual bool write(const byte data);
+
+    /**
+     * Write an unsigned 8-bit value
+     */
+    virtual bool write(const ubyte data);
+
+    /**
+     * Write a boolean
+     */
+    virtual bool write(const bool data);
+
+    /**
+     * Write a long.
+     *
+     * Long values are always stored with 64 bits, independently of the size
+     * of the long type on the writing platform.
+     */
+    virtual bool write(const long data);
+
+    /**
+     * Write an unsigned long.
+     *
+     * Unsigned long values are always stored with 64 bits, independently of
+     * the size of the long type on the writing platform.
+     */
+    virtual bool write(const unsigned long data);
+
+    /**
+     * Write a short
+     */
+    virtual bool write(const short data);
+
+    /**
+     * Write an unsigned short
+     */
+    virtual bool write(const unsigned short data);
+    //@}
+
+    /**
+     * @name Read members
+     *
+     * Numbers can be read as any other numeric type than the one used to
+     * write them.  The value is converted with the usual C++ rules.
+     */
+    //@{
+    /**
+     * Read a std::string.  Symbols can also be read as strings.
+     */
+    virtual bool read(std::string& data);
+
+    /**
+     * Read a double value
+     */
+    virtual bool read(double& data);
+
+    /**
+     * Read a float value
+     */
+    virtual bool read(float& data);
+
+    /**
+     * Read an integer value
+     */
+    virtual bool read(int& data);
+
+    /**
+     * Read an unsigned int value
+     */
+    virtual bool read(unsigned int& data);
+
+    /**
+     * Read a char value
+     */
+    virtual bool read(char& data);
+
+    /**
+     * Read a signed 8-bit value
+     */
+    virtual bool read(byte& data);
+
+    /**
+     * Read an unsigned 8-bit value
+     */
+    virtual bool read(ubyte& data);
+
+    /**
+     * Read a boolean
+     */
+    virtual bool read(bool& data);
+
+    /**
+     * Read a long
+     */
+    virtual bool read(long& data);
+
+    /**
+     * Read an unsigned long
+     */
+    virtual bool read(unsigned long& data);
+
+    /**
+     * Read a short
+     */
+    virtual bool read(short& data);
+
+    /**
+     * Read an unsigned short
+     */
+    virtual bool read(unsigned short& data);
+    //@}
+
+    /**
+     * @name Array write members
+     *
+     * The whole array is written as one block, preceded by its element type
+     * and size.
+     */
+    //@{
+    virtual bool writeArray(const double* data,const int n);
+    virtual bool writeArray(const float* data,const int n);
+    virtual bool writeArray(const int* data,const int n);
+    virtual bool writeArray(const unsigned int* data,const int n);
+    virtual bool writeArray(const byte* data,const int n);
+    virtual bool writeArray(const ubyte* data,const int n);
+    virtual bool writeArray(const short* data,const int n);
+    virtual bool writeArray(const unsigned short* data,const int n);
+    //@}
+
+    /**
+     * @name Array read members
+     *
+     * If the array was written with the same element type, the whole block
+     * is read at once.  Otherwise each element is converted.  Arrays written
+     * element by element can also be read.
+     */
+    //@{
+    virtual bool readArray(double* data,const int n);
+    virtual bool readArray(float* data,const int n);
+    virtual bool readArray(int* data,const int n);
+    virtual bool readArray(unsigned int* data,const int n);
+    virtual bool readArray(byte* data,const int n);
+    virtual bool readArray(ubyte* data,const int n);
+    virtual bool readArray(short* data,const int n);
+    virtual bool readArray(unsigned short* data,const int n);
+    //@}
+
+    /**
+     * Write a symbol
+     */
+    virtual bool writeSymbol(const std::string& data);
+
+    /**
+     * Read a symbol in the given std::string
+     */
+    virtual bool readSymbol(std::string& data);
+
+    /**
+     * Try to read the given symbol from the handler.
+     *
+     * If present, returns true and the token is removed from the
+     * handler.  Symbol/value pairs found before the requested one are kept
+     * in a cache, so that they can be read later.
+     *
+     * @param data the symbol to be read
+     */
+    virtual bool trySymbol(const std::string& data);
+
+    /**
+     * Comments are not stored in binary streams.  This method does nothing.
+     */
+    virtual bool writeComment(const std::string& data);
+
+    /**
+     * Comments are not stored in binary streams.  This method does nothing.
+     */
+    virtual bool writeComment(const char* data);
+
+    /**
+     * Try to read the begin token from the handler.
+     *
+     * If present, returns true and the token is removed from the
+     * handler, if not present returns false and leaves the handler as
+     * it was before calling this member.
+     */
+    virtual bool tryBegin();
+
+    /**
+     * Try to read the end token from the handler.
+     *
+     * If present, returns true and the token is removed from the
+     * handler, if not present returns false and leaves the handler as
+     * it was before calling this member.
+     */
+    virtual bool tryEnd();
+
+    /**
+     * Spaces are not stored in binary streams.  This method does nothing.
+     */
+    virtual bool writeSpaces(const int s=1);
+
+    /**
+     * End of lines are not stored in binary streams.  This method does
+     * nothing.
+     */
+    virtual bool writeEOL();
+
+    /**
+     * Separators are not stored in binary streams.  This method does
+     * nothing.
+     */
+    virtual bool writeKeyValueSeparator();
+
+    /**
+     * Separators are not stored in binary streams.  This method does
+     * nothing.
+     */
+    virtual bool writeDataSeparator();
+
+    /**
+     * Separators are not stored in binary streams.  This method just
+     * returns true.
+     */
+    virtual bool readKeyValueSeparator();
+
+    /**
+     * Separators are not stored in binary streams.  This method just
+     * returns true.
+     */
+    virtual bool readDataSeparator();
+
+    /**
+     * If the input stream is at the end of file return true, otherwise
+     * false.  If the stream hasn't been set yet, this function also returns
+     * true.
+     */
+    virtual bool eof();
+
+    /**
+     * Restore the nesting level changed by the readBegin() that preceded
+     * an unsuccessful trySymbol(), so that the rest of the current level
+     * can still be read.
+     */
+    virtual bool restoreLevel();
+
+    /**
+     * Overload of context status information.
+     *
+     * Appends the position in the input stream and the current nesting
+     * level.
+     */
+    virtual void appendContextStatus() const;
+
+  protected:
+    /**
+     * Tags identifying each token in the stream
+     */
+    enum eTokenTag {
+      NoTag     =  0, /**< No more data available */
+      BeginTag  =  1, /**< Begin of a level */
+      EndTag    =  2, /**< End of a level */
+      SymbolTag =  3, /**< Symbol */
+      StringTag =  4, /**< String */
+      CharTag   =  5, /**< char */
+      BoolTag   =  6, /**< bool */
+      ByteTag   =  7, /**< signed 8-bit */
+      UByteTag  =  8, /**< unsigned 8-bit */
+      ShortTag  =  9, /**< signed 16-bit */
+      UShortTag = 10, /**< unsigned 16-bit */
+      IntTag    = 11, /**< signed 32-bit */
+      UIntTag   = 12, /**< unsigned 32-bit */
+      LongTag   = 13, /**< signed 64-bit */
+      ULongTag  = 14, /**< unsigned 64-bit */
+      FloatTag  = 15, /**< 32-bit floating point */
+      DoubleTag = 16, /**< 64-bit floating point */
+      ArrayTag  = 17  /**< Element tag, uint32 size and raw elements */
+    };
+
+    /**
+     * Pointer to the input stream
+     */
+    std::istream* inStream_;
+
+    /**
+     * Pointer to the output stream
+     */
+    std::ostream* outStream_;
+
+    /**
+     * Bytes to be read before continuing with the input stream.
+     *
+     * Symbol/value pairs taken from the cache are inserted here.
+     */
+    std::string pending_;
+
+    /**
+     * Read position in pending_
+     */
+    std::string::size_type pendingPos_;
+
+    /**
+     * Flag that indicates if the input data has to be byte swapped
+     */
+    bool swap_;
+
+    /**
+     * Flag that indicates if the input header was valid
+     */
+    bool validInput_;
+
+    /**
+     * Number of bytes consumed from the input stream, used for context
+     * information
+     */
+    int64 position_;
+
+    /**
+     * Number of bytes of the input stream, or -1 if the stream cannot seek
+     * and its length is unknown
+     */
+    int64 inputSize_;
+
+    /**
+     * Number of tags consumed from the input
+     */
+    int64 tokens_;
+
+    /**
+     * Nesting level set by the last readBegin()
+     */
+    int lastBeginLevel_;
+
+    /**
+     * Value of tokens_ when the last readBegin() was called
+     */
+    int64 lastBeginTokens_;
+
+    /**
+     * Level to be restored by restoreLevel(), or -1 if nothing has to be
+     * restored.
+     */
+    int restoreTo_;
+
+    /**
+     * Type for the cache of each level, where the raw value of each symbol
+     * is stored
+     */
+    typedef std::map<std::string,std::string> cacheType;
+
+    /**
+     * Type for each element of the stack
+     */
+    struct stackElement {
+      /**
+       * Default constructor
+       */
+      stackElement();
+
+      /**
+       * Contains the symbol/value table
+       */
+      cacheType cache;
+
+      /**
+       * Specify if the input stream contains no more data for this
+       * level
+       */
+      bool complete;
+
+      /**
+       * Level for the cache
+       */
+      int level;
+    };
+
+    /**
+     * The data stack.
+     *
+     * All symbols read in the wrong order and their values are stored here
+     * temporarily to allow a different sorting of the symbols in the stream.
+     */
+    std::list<stackElement> stack_;
+
+    /**
+     * Write the stream header
+     */
+    bool writeHeader();
+
+    /**
+     * Read and check the stream header
+     */
+    bool readHeader();
+
+    /**
+     * Write a tag followed by the given bytes
+     */
+    bool writeToken(const ubyte tag,const void* data,const int size);
+
+    /**
+     * Write a tag followed by the size and the characters of the string
+     */
+    bool writeText(const ubyte tag,const std::string& data);
+
+    /**
+     * Write an array with the given element tag
+     */
+    bool writeBlock(const ubyte elemTag,const void* data,
+                    const int elemSize,const int n);
+
+    /**
+     * Get the given number of bytes, first from pending_ and then from the
+     * input stream.
+     */
+    bool get(void* data,const int size);
+
+    /**
+     * Get a 32-bit size value, swapping it if necessary
+     */
+    bool getSize(uint32& size);
+
+    /**
+     * Return the tag of the next token without consuming it, or NoTag
+     * at the end of the input.
+     */
+    ubyte peekTag();
+
+    /**
+     * Read the tag of the next token, or NoTag at the end of the input
+     */
+    ubyte getTag();
+
+    /**
+     * Read the next token, which must be a symbol or a string
+     */
+    bool readText(std::string& data);
+
+    /**
+     * Read the next token, which must be numeric.  Integer types are
+     * returned in \a intValue, floating point types in \a realValue.
+     *
+     * @return true if successful
+     */
+    bool readScalar(int64& intValue,double& realValue,bool& isReal);
+
+    /**
+     * Read a numeric token and convert it to an integer value
+     */
+    bool readInteger(int64& data);
+
+    /**
+     * Read a numeric token and convert it to a floating point value
+     */
+    bool readReal(double& data);
+
+    /**
+     * Convert \a n elements of the type denoted by \a tag into the
+     * type T
+     */
+    template<typename T>
+    bool convert(const char* src,const ubyte tag,const int n,T* dest) const;
+
+    /**
+     * Read an array of any standard type, which is denoted by \a tag
+     */
+    template<typename T>
+    bool readBlock(T* data,const int n,const ubyte tag);
+
+    /**
+     * Compute the number of bytes of \a count elements of \a elemSize
+     * bytes each, as found in the input.
+     *
+     * @return false if the number of bytes exceeds INT_MAX or the rest of
+     *         the input, i.e. if the stream is corrupted.
+     */
+    bool byteCount(const uint32 count,const int elemSize,int& bytes) const;
+
+    /**
+     * Read the given number of bytes and append them to \a raw, or just
+     * discard them if \a raw is null.
+     */
+    bool move(std::string* raw,const int size);
+
+    /**
+     * Read the raw bytes of the next token, appending them (including the
+     * tag) to the given string, or just discarding them if \a raw is null.
+     *
+     * @return the tag of the token or NoTag if there are no more
+     *         tokens.
+     */
+    ubyte copyToken(std::string* raw);
+
+    /**
+     * Read the raw bytes of the rest of the current symbol/value pair,
+     * including the end token.
+     */
+    bool completePair(std::string& raw);
+  };
+}
+
+#endif
@@ -265,6 +265,141 @@ namespace lti {
     return handler.read(data);
   }
 
+  /*
+   * element-wise array transfer used by the default implementations
+   */
+  template<typename T>
+  static bool writeElements(ioHandler& handler,const T* data,const int n) {
+    bool b = true;
+    if (n > 0) {
+      const T* const last = data + (n-1);
+      for (;data!=last;++data) {
+        b = handler.write(*data) && b;
+        handler.writeDataSeparator();
+      }
+      b = handler.write(*data) && b;
+    }
+    return b;
+  }
+
+  template<typename T>
+  static bool readElements(ioHandler& handler,T* data,const int n) {
+    bool b = true;
+    if (n > 0) {
+      const T* const last = data + (n-1);
+      while (b && (data!=last)) {
+        b = handler.read(*data) && handler.readKeyValueSeparator();
+        ++data;
+      }
+      b = b && handler.read(*data);
+    }
+    return b;
+  }
+
+  /*
+   * array members for standard types
+   */
+  bool ioHandler::writeArray(const double* data,const int n) {
+    return writeElements(*this,data,n);
+  }
+  bool ioHandler::writeArray(const float* data,const int n) {
+    return writeElements(*this,data,n);
+  }
+  bool ioHandler::writeArray(const int* data,const int n) {
+    return writeElements(*this,data,n);
+  }
+  bool ioHandler::writeArray(const unsigned int* data,const int n) {
+    return writeElements(*this,data,n);
+  }
+  bool ioHandler::writeArray(const byte* data,const int n) {
+    return writeElements(*this,data,n);
+  }
+  bool ioHandler::writeArray(const ubyte* data,const int n) {
+    return writeElements(*this,data,n);
+  }
+  bool ioHandler::writeArray(const short* data,const int n) {
+    return writeElements(*this,data,n);
+  }
+  bool ioHandler::writeArray(const unsigned short* data,const int n) {
+    return writeElements(*this,data,n);
+  }
+  bool ioHandler::readArray(double* data,const int n) {
+    return readElements(*this,data,n);
+  }
+  bool ioHandler::readArray(float* data,const int n) {
+    return readElements(*this,data,n);
+  }
+  bool ioHandler::readArray(int* data,const int n) {
+    return readElements(*this,data,n);
+  }
+  bool ioHandler::readArray(unsigned int* data,const int n) {
+    return readElements(*this,data,n);
+  }
+  bool ioHandler::readArray(byte* data,const int n) {
+    return readElements(*this,data,n);
+  }
+  bool ioHandler::readArray(ubyte* data,const int n) {
+    return readElements(*this,data,n);
+  }
+  bool ioHandler::readArray(short* data,const int n) {
+    return readElements(*this,data,n);
+  }
+  bool ioHandler::readArray(unsigned short* data,const int n) {
+    return readElements(*this,data,n);
+  }
+
+  /*
+   * array functions for standard types
+   */
+  bool writeArray(ioHandler& handler,const double* data,const int n) {
+    return handler.writeArray(data,n);
+  }
+  bool writeArray(ioHandler& handler,const float* data,const int n) {
+    return handler.writeArray(data,n);
+  }
+  bool writeArray(ioHandler& handler,const int* data,const int n) {
+    return handler.writeArray(data,n);
+  }
+  bool writeArray(ioHandler& handler,const unsigned int* data,const int n) {
+    return handler.writeArray(data,n);
+  }
+  bool writeArray(ioHandler& handler,const byte* data,const int n) {
+    return handler.writeArray(data,n);
+  }
+  bool writeArray(ioHandler& handler,const ubyte* data,const int n) {
+    return handler.writeArray(data,n);
+  }
+  bool writeArray(ioHandler& handler,const short* data,const int n) {
+    return handler.writeArray(data,n);
+  }
+  bool writeArray(ioHandler& handler,const unsigned short* data,const int n) {
+    return handler.writeArray(data,n);
+  }
+  bool readArray(ioHandler& handler,double* data,const int n) {
+    return handler.readArray(data,n);
+  }
+  bool readArray(ioHandler& handler,float* data,const int n) {
+    return handler.readArray(data,n);
+  }
+  bool readArray(ioHandler& handler,int* data,const int n) {
+    return handler.readArray(data,n);
+  }
+  bool readArray(ioHandler& handler,unsigned int* data,const int n) {
+    return handler.readArray(data,n);
+  }
+  bool readArray(ioHandler& handler,byte* data,const int n) {
+    return handler.readArray(data,n);
+  }
+  bool readArray(ioHandler& handler,ubyte* data,const int n) {
+    return handler.readArray(data,n);
+  }
+  bool readArray(ioHandler& handler,short* data,const int n) {
+    return handler.readArray(data,n);
+  }
+  bool readArray(ioHandler& handler,unsigned short* data,const int n) {
+    return handler.readArray(data,n);
+  }
+
   void ioHandler::appendContextStatus() const {
   }
 
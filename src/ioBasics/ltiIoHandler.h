@@ -228,6 +228,52 @@ namespace lti {
     virtual bool read(const std::string& name, unsigned short& data);
     //@}
 
+    /**
+     * \name Write methods for arrays of standard types
+     *
+     * Containers like lti::genericVector or lti::genericMatrix write their
+     * contiguous elements with these methods.  The default implementation
+     * writes the elements one by one, separated by writeDataSeparator(), so
+     * that text based handlers produce exactly the same output as with
+     * single write() calls.  Binary handlers overload them to transfer
+     * the whole array as one block.
+     */
+    //@{
+    /**
+     * Write the \a n elements of the given array
+     */
+    virtual bool writeArray(const double* data,const int n);
+    virtual bool writeArray(const float* data,const int n);
+    virtual bool writeArray(const int* data,const int n);
+    virtual bool writeArray(const unsigned int* data,const int n);
+    virtual bool writeArray(const byte* data,const int n);
+    virtual bool writeArray(const ubyte* data,const int n);
+    virtual bool writeArray(const short* data,const int n);
+    virtual bool writeArray(const unsigned short* data,const int n);
+    //@}
+
+    /**
+     * \name Read methods for arrays of standard types
+     *
+     * Counterpart of writeArray().  The default implementation reads the
+     * elements one by one, each one followed by readKeyValueSeparator(), as
+     * the containers did before.
+     */
+    //@{
+    /**
+     * Read \a n elements into the given array, which must already have
+     * space enough for them.
+     */
+    virtual bool readArray(double* data,const int n);
+    virtual bool readArray(float* data,const int n);
+    virtual bool readArray(int* data,const int n);
+    virtual bool readArray(unsigned int* data,const int n);
+    virtual bool readArray(byte* data,const int n);
+    virtual bool readArray(ubyte* data,const int n);
+    virtual bool readArray(short* data,const int n);
+    virtual bool readArray(unsigned short* data,const int n);
+    //@}
+
     /**
      * Write a std::string as a symbol token.
      *
@@ -420,6 +466,40 @@ namespace lti {
   bool write(ioHandler& handler,const unsigned short data);
   //@}
 
+  /**
+   * \name Array read and write functions
+   *
+   * Read or write \a n consecutive elements.  For the standard types the
+   * ioHandler::readArray() and ioHandler::writeArray() methods are used,
+   * which allow binary handlers to transfer the whole block at once.  For
+   * all other types the elements are read or written one by one.
+   */
+  //@{
+  bool writeArray(ioHandler& handler,const double* data,const int n);
+  bool writeArray(ioHandler& handler,const float* data,const int n);
+  bool writeArray(ioHandler& handler,const int* data,const int n);
+  bool writeArray(ioHandler& handler,const unsigned int* data,const int n);
+  bool writeArray(ioHandler& handler,const byte* data,const int n);
+  bool writeArray(ioHandler& handler,const ubyte* data,const int n);
+  bool writeArray(ioHandler& handler,const short* data,const int n);
+  bool writeArray(ioHandler& handler,const unsigned short* data,const int n);
+
+  template <class T>
+  bool writeArray(ioHandler& handler,const T* data,const int n);
+
+  bool readArray(ioHandler& handler,double* data,const int n);
+  bool readArray(ioHandler& handler,float* data,const int n);
+  bool readArray(ioHandler& handler,int* data,const int n);
+  bool readArray(ioHandler& handler,unsigned int* data,const int n);
+  bool readArray(ioHandler& handler,byte* data,const int n);
+  bool readArray(ioHandler& handler,ubyte* data,const int n);
+  bool readArray(ioHandler& handler,short* data,const int n);
+  bool readArray(ioHandler& handler,unsigned short* data,const int n);
+
+  template <class T>
+  bool readArray(ioHandler& handler,T* data,const int n);
+  //@}
+
 
 
   /**
@@ -87,4 +87,38 @@ namespace lti {
     return result;
   }
 
+  /**
+   * Element-wise array write for all non-standard types
+   */
+  template <class T>
+  bool writeArray(ioHandler& handler,const T* data,const int n) {
+    bool b = true;
+    if (n > 0) {
+      const T* const last = data + (n-1);
+      for (;data!=last;++data) {
+        b = write(handler,*data) && b;
+        handler.writeDataSeparator();
+      }
+      b = write(handler,*data) && b;
+    }
+    return b;
+  }
+
+  /**
+   * Element-wise array read for all non-standard types
+   */
+  template <class T>
+  bool readArray(ioHandler& handler,T* data,const int n) {
+    bool b = true;
+    if (n > 0) {
+      const T* const last = data + (n-1);
+      while (b && (data!=last)) {
+        b = read(handler,*data) && handler.readKeyValueSeparator();
+        ++data;
+      }
+      b = b && read(handler,*data);
+    }
+    return b;
+  }
+
 }
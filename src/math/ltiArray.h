@@ -193,6 +193,8 @@ namespace lti {
      * @param from initial index
      * @param to   final index
      * @param data a pointer to the memory block to be used
+     * @param alloc the lti::memoryAllocator which provided the block, or
+     *              null if it was allocated with new[] (default).
      *
      * Example:
      * \code
@@ -210,7 +212,8 @@ namespace lti {
      */
     void attach(const int from,
                 const int to,
-                T* data);
+                T* data,
+                memoryAllocator* alloc = 0);
 
     /**
      * Free the data of this object and hand it over to the
@@ -138,8 +138,9 @@ namespace lti {
   template<typename T>
   void array<T>::attach(const int from,
                         const int to,
-                        T* _data) {
-    vector<T>::attach(to-from+1,_data);
+                        T* _data,
+                        memoryAllocator* alloc) {
+    vector<T>::attach(to-from+1,_data,alloc);
 
     offset_ = -from;
     firstArrayElement_ = from;
@@ -155,12 +156,13 @@ namespace lti {
     // accidentally deleted
     if (this->ownData_) {
       receiver.attach(firstArrayElement_,lastArrayElement_,
-                      this->theElements_);
+                      this->theElements_,this->allocator_);
     } else {
       receiver.useExternData(firstArrayElement_,lastArrayElement_,
                              this->theElements_);
     }
     this->ownData_ = false;
+    this->allocator_ = 0;
     allocate(0,0);
   }
 
@@ -277,7 +279,8 @@ namespace lti {
     if (newSize <= 0) {
       // Wrong size! Assume this->size()==0
       if (this->ownData_) {
-	delete[] this->theElements_;
+	internal::releaseElements(this->theElements_,this->vectorSize_,
+                                  this->allocator_);
       } else {
 	this->ownData_ = true;
       }
@@ -296,11 +299,8 @@ namespace lti {
     idxLow = to+1;
     idxHigh = to-1;
 
-    newElements = new T[newSize];
-
-    if (newElements == 0) { // check memory allocation
-      throw allocException();
-    }
+    memoryAllocator* newAllocator;
+    newElements = internal::allocateElements<T>(newSize,newAllocator);
 
     if (((resizeType==Copy)||(resizeType==CopyAndInit))
         && (oldTo>=oldFrom)) { // old data should be copied
@@ -317,12 +317,14 @@ namespace lti {
     
 
     if (this->ownData_) {
-      delete[] this->theElements_;
+      internal::releaseElements(this->theElements_,this->vectorSize_,
+                                this->allocator_);
     } else {
       this->ownData_ = true;
     }
 
     this->theElements_ = newElements;
+    this->allocator_ = newAllocator;
     this->vectorSize_ = newSize;
     this->idxLastElement_ = newSize-1;
     offset_ = -from;
@@ -0,0 +1,629 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiGemm.cpp
+ *         Low-level matrix-matrix (GEMM) and matrix-vector (GEMV) products
+ *         on contiguous row-major memory, used by lti::matrix::multiply().
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include "ltiGemm.h"
+#include "ltiThreadPool.h"
+#include "ltiSimd.h"
+#include <vector>
+#include <cstddef>
+
+#ifndef _LTI_WIN32
+#  include <unistd.h>
+#endif
+
+#undef _LTI_DEBUG
+// #define _LTI_DEBUG 1
+#include "ltiDebug.h"
+
+namespace lti {
+  namespace internal {
+
+    // ------------------------------------------------------------------
+    // Configuration
+    // ------------------------------------------------------------------
+
+    gemmConfiguration::gemmConfiguration()
+      : mc(0),kc(0),nc(0),threads(0),parallelThreshold(128.0*128.0*128.0) {
+    }
+
+    /*
+     * The global configuration
+     */
+    static gemmConfiguration theGemmConfiguration;
+
+    const gemmConfiguration& getGemmConfiguration() {
+      return theGemmConfiguration;
+    }
+
+    void setGemmConfiguration(const gemmConfiguration& config) {
+      theGemmConfiguration = config;
+    }
+
+    /*
+     * Query a cache size in bytes, or return the default value if the
+     * system does not provide it.
+     */
+    static int cacheSize(const int level,const int defaultSize) {
+      long size = 0;
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE) && \
+    defined(_SC_LEVEL3_CACHE_SIZE)
+      switch(level) {
+      case 1:
+        size = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+        break;
+      case 2:
+        size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        break;
+      default:
+        size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+      }
+#endif
+      return (size > 0) ? static_cast<int>(size) : defaultSize;
+    }
+
+    /*
+     * Round value down to a multiple of step and clip it to [low,high]
+     */
+    static int roundBlock(const int value,const int step,
+                          const int low,const int high) {
+      int r = (value/step)*step;
+      if (r < low) {
+        r = low;
+      }
+      if (r > high) {
+        r = high;
+      }
+      return r;
+    }
+
+    // ------------------------------------------------------------------
+    // Register tiles
+    // ------------------------------------------------------------------
+
+#if defined(__AVX__)
+
+    /*
+     * Register tiles: 6 rows times two registers keep 12 of the 16 ymm
+     * registers busy as accumulators.
+     */
+    template<typename T> struct tile {
+      static const int mr = 4;
+      static const int nregs = 1;
+    };
+    template<> struct tile<float> {
+      static const int mr = 6;
+      static const int nregs = 2;
+    };
+    template<> struct tile<double> {
+      static const int mr = 6;
+      static const int nregs = 2;
+    };
+
+#elif defined(__SSE2__)
+
+    /*
+     * Register tiles: 4 rows times two registers use 8 of the 16 xmm
+     * registers as accumulators.
+     */
+    template<typename T> struct tile {
+      static const int mr = 4;
+      static const int nregs = 2;
+    };
+
+#else
+
+    /*
+     * Scalar register tile 4x4
+     */
+    template<typename T> struct tile {
+      static const int mr = 4;
+      static const int nregs = 4;
+    };
+
+#endif
+
+    // ------------------------------------------------------------------
+    // Packing
+    // ------------------------------------------------------------------
+
+    /*
+     * Pack the block A[0:mb,0:kb] into micro-panels of MR rows each.
+     *
+     * Inside a micro-panel the elements are stored column by column, so
+     * that the micro-kernel reads MR consecutive values for each step in
+     * the common dimension.  Missing rows are filled with zeros.
+     */
+    template<typename T,int MR>
+    void packA(const int mb,const int kb,const T* a,const int lda,T* dest) {
+      int i,p,ii;
+      for (i=0;i<mb;i+=MR) {
+        const int rows = (mb-i < MR) ? mb-i : MR;
+        const T* src = a+i*lda;
+        if (rows == MR) {
+          for (p=0;p<kb;++p) {
+            for (ii=0;ii<MR;++ii) {
+              dest[ii]=src[ii*lda+p];
+            }
+            dest+=MR;
+          }
+        } else {
+          for (p=0;p<kb;++p) {
+            for (ii=0;ii<rows;++ii) {
+              dest[ii]=src[ii*lda+p];
+            }
+            for (;ii<MR;++ii) {
+              dest[ii]=T(0);
+            }
+            dest+=MR;
+          }
+        }
+      }
+    }
+
+    /*
+     * Pack the block B[0:kb,0:nb] into micro-panels of NR columns each.
+     *
+     * Inside a micro-panel the elements are stored row by row.  Missing
+     * columns are filled with zeros.
+     */
+    template<typename T,int NR>
+    void packB(const int kb,const int nb,const T* b,const int ldb,T* dest) {
+      int j,p,jj;
+      for (j=0;j<nb;j+=NR) {
+        const int cols = (nb-j < NR) ? nb-j : NR;
+        const T* src = b+j;
+        if (cols == NR) {
+          for (p=0;p<kb;++p) {
+            const T* srow = src+p*ldb;
+            for (jj=0;jj<NR;++jj) {
+              dest[jj]=srow[jj];
+            }
+            dest+=NR;
+          }
+        } else {
+          for (p=0;p<kb;++p) {
+            const T* srow = src+p*ldb;
+            for (jj=0;jj<cols;++jj) {
+              dest[jj]=srow[jj];
+            }
+            for (;jj<NR;++jj) {
+              dest[jj]=T(0);
+            }
+            dest+=NR;
+          }
+        }
+      }
+    }
+
+    // ------------------------------------------------------------------
+    // Micro-kernel
+    // ------------------------------------------------------------------
+
+    /*
+     * Compute the MR x NR tile C = (accumulate ? C : 0) + Ap * Bp, where
+     * Ap and Bp are packed micro-panels with kb elements in the common
+     * dimension.  Only the upper-left mr x nr part of the tile is written.
+     */
+    template<typename T>
+    void microKernel(const int kb,const T* ap,const T* bp,
+                     T* c,const int ldc,
+                     const int mr,const int nr,
+                     const bool accumulate) {
+      typedef simd<T> S;
+      typedef typename S::reg reg;
+      const int MR = tile<T>::mr;
+      const int NV = tile<T>::nregs;
+      const int NR = NV*S::width;
+
+      reg acc[MR][NV];
+      int i,v,p;
+      for (i=0;i<MR;++i) {
+        for (v=0;v<NV;++v) {
+          acc[i][v]=S::zero();
+        }
+      }
+
+      for (p=0;p<kb;++p) {
+        reg bv[NV];
+        for (v=0;v<NV;++v) {
+          bv[v]=S::load(bp+v*S::width);
+        }
+        for (i=0;i<MR;++i) {
+          const reg av = S::set1(ap[i]);
+          for (v=0;v<NV;++v) {
+            acc[i][v]=S::madd(av,bv[v],acc[i][v]);
+          }
+        }
+        ap+=MR;
+        bp+=NR;
+      }
+
+      if ((mr == MR) && (nr == NR)) {
+        // full tile: write directly into C
+        for (i=0;i<MR;++i) {
+          T* crow = c+i*ldc;
+          for (v=0;v<NV;++v) {
+            if (accumulate) {
+              S::store(crow+v*S::width,
+                       S::add(acc[i][v],S::load(crow+v*S::width)));
+            } else {
+              S::store(crow+v*S::width,acc[i][v]);
+            }
+          }
+        }
+      } else {
+        // border tile: go through a small buffer
+        T buffer[MR*NR];
+        int j;
+        for (i=0;i<MR;++i) {
+          for (v=0;v<NV;++v) {
+            S::store(buffer+i*NR+v*S::width,acc[i][v]);
+          }
+        }
+        for (i=0;i<mr;++i) {
+          T* crow = c+i*ldc;
+          const T* brow = buffer+i*NR;
+          if (accumulate) {
+            for (j=0;j<nr;++j) {
+              crow[j]+=brow[j];
+            }
+          } else {
+            for (j=0;j<nr;++j) {
+              crow[j]=brow[j];
+            }
+          }
+        }
+      }
+    }
+
+    // ------------------------------------------------------------------
+    // Blocked GEMM
+    // ------------------------------------------------------------------
+
+    /*
+     * Aligned scratch memory for the packed panels.
+     */
+    template<typename T>
+    class packBuffer {
+    public:
+      packBuffer(const int size) : mem_(size+64/sizeof(T)+1) {
+        const std::size_t addr = reinterpret_cast<std::size_t>(&mem_[0]);
+        data_ = reinterpret_cast<T*>((addr+63) & ~std::size_t(63));
+      }
+      T* data() {
+        return data_;
+      }
+    private:
+      std::vector<T> mem_;
+      T* data_;
+    };
+
+    /*
+     * Job computing the row blocks of C for one packed panel of B.
+     *
+     * Each task packs its own block of A into its private part of the
+     * A buffer and runs the macro-kernel on it.  Since the tasks write
+     * into disjoint rows of C, the result does not depend on the number
+     * of threads.
+     */
+    template<typename T>
+    class gemmJob : public threadPool::job {
+    public:
+      gemmJob(const int m,const int nb,const int kb,const int mc,
+              const T* a,const int lda,
+              const T* bpacked,T* apacked,
+              T* c,const int ldc,const bool accumulate)
+        : m_(m),nb_(nb),kb_(kb),mc_(mc),a_(a),lda_(lda),
+          bpacked_(bpacked),apacked_(apacked),c_(c),ldc_(ldc),
+          accumulate_(accumulate) {
+      }
+
+      virtual void execute(const int task) {
+        const int MR = tile<T>::mr;
+        const int NR = tile<T>::nregs*simd<T>::width;
+
+        const int i0 = task*mc_;
+        const int mb = (m_-i0 < mc_) ? m_-i0 : mc_;
+        T* ap = apacked_ + task*mc_*kb_;
+
+        packA<T,MR>(mb,kb_,a_+i0*lda_,lda_,ap);
+
+        int ir,jr;
+        for (jr=0;jr<nb_;jr+=NR) {
+          const int nr = (nb_-jr < NR) ? nb_-jr : NR;
+          const T* bp = bpacked_ + jr*kb_;
+          for (ir=0;ir<mb;ir+=MR) {
+            const int mr = (mb-ir < MR) ? mb-ir : MR;
+            microKernel<T>(kb_,ap+ir*kb_,bp,
+                           c_+(i0+ir)*ldc_+jr,ldc_,
+                           mr,nr,accumulate_);
+          }
+        }
+      }
+
+    private:
+      const int m_,nb_,kb_,mc_;
+      const T* a_;
+      const int lda_;
+      const T* bpacked_;
+      T* apacked_;
+      T* c_;
+      const int ldc_;
+      const bool accumulate_;
+    };
+
+    template<typename T>
+    void blockedGemm(const int m, const int n, const int k,
+                     const T* a, const int lda,
+                     const T* b, const int ldb,
+                     T* c, const int ldc) {
+
+      if ((m<=0) || (n<=0)) {
+        return;
+      }
+      if (k<=0) {
+        for (int i=0;i<m;++i) {
+          for (int j=0;j<n;++j) {
+            c[i*ldc+j]=T(0);
+          }
+        }
+        return;
+      }
+
+      const int MR = tile<T>::mr;
+      const int NR = tile<T>::nregs*simd<T>::width;
+
+      int mc,kc,nc;
+      getGemmBlocking(sizeof(T),mc,kc,nc);
+
+      // decide how many threads to use
+      const gemmConfiguration& cfg = getGemmConfiguration();
+      int threads = 1;
+      if (double(m)*double(n)*double(k) >= cfg.parallelThreshold) {
+        threads = threadPool::computeThreads(cfg.threads);
+      }
+
+      // with several threads ensure that there are enough row blocks
+      if (threads > 1) {
+        const int perThread = ((m+threads-1)/threads + MR-1)/MR*MR;
+        if (perThread < mc) {
+          mc = perThread;
+        }
+      }
+
+      // the row blocks must consist of complete micro-panels
+      mc = (mc+MR-1)/MR*MR;
+      if (kc > k) {
+        kc = k;
+      }
+      if (nc > n) {
+        nc = (n+NR-1)/NR*NR;
+      }
+
+      const int mblocks = (m+mc-1)/mc;
+      packBuffer<T> abuf(mblocks*mc*kc);
+      packBuffer<T> bbuf(((nc+NR-1)/NR*NR)*kc);
+
+      _lti_debug("gemm " << m << "x" << n << "x" << k << " mc=" << mc <<
+                 " kc=" << kc << " nc=" << nc << " threads=" << threads <<
+                 std::endl);
+
+      int jc,pc;
+      for (jc=0;jc<n;jc+=nc) {
+        const int nb = (n-jc < nc) ? n-jc : nc;
+        for (pc=0;pc<k;pc+=kc) {
+          const int kb = (k-pc < kc) ? k-pc : kc;
+
+          packB<T,NR>(kb,nb,b+pc*ldb+jc,ldb,bbuf.data());
+
+          gemmJob<T> theJob(m,nb,kb,mc,a+pc,lda,bbuf.data(),abuf.data(),
+                            c+jc,ldc,pc>0);
+
+          if (threads > 1) {
+            threadPool::getShared().run(theJob,mblocks,threads);
+          } else {
+            for (int t=0;t<mblocks;++t) {
+              theJob.execute(t);
+            }
+          }
+        }
+      }
+    }
+
+    void getGemmBlocking(const int typeSize, int& mc, int& kc, int& nc) {
+      const gemmConfiguration& cfg = getGemmConfiguration();
+
+      // the panels are sized for the larger of both tiles, which is
+      // always a valid choice
+      const int MR = 8;
+      const int NR = 16;
+
+      const int l1 = cacheSize(1,32*1024);
+      const int l2 = cacheSize(2,256*1024);
+      const int l3 = cacheSize(3,4*1024*1024);
+
+      // a micro-panel of B should occupy about half of L1
+      kc = (cfg.kc > 0) ? cfg.kc :
+        roundBlock(l1/(2*NR*typeSize),8,64,1024);
+
+      // the packed block of A should occupy about half of L2
+      mc = (cfg.mc > 0) ? cfg.mc :
+        roundBlock(l2/(2*kc*typeSize),MR,MR,4096);
+
+      // the packed panel of B should occupy about half of L3
+      nc = (cfg.nc > 0) ? cfg.nc :
+        roundBlock(l3/(2*kc*typeSize),NR,NR,8192);
+    }
+
+    // ------------------------------------------------------------------
+    // GEMV
+    // ------------------------------------------------------------------
+
+    /*
+     * Dot product of four rows with the same vector at once, so that the
+     * elements of x are loaded only once for four rows.
+     */
+    template<typename T>
+    void gemvRows(const int m0, const int m1, const int n,
+                  const T* a, const int lda,
+                  const T* x,
+                  T* y) {
+      typedef simd<T> S;
+      typedef typename S::reg reg;
+      const int W = S::width;
+      const int nv = (n/W)*W;
+
+      int i,j;
+      for (i=m0;i+4<=m1;i+=4) {
+        const T* r0 = a+i*lda;
+        const T* r1 = r0+lda;
+        const T* r2 = r1+lda;
+        const T* r3 = r2+lda;
+        reg s0=S::zero(),s1=S::zero(),s2=S::zero(),s3=S::zero();
+        for (j=0;j<nv;j+=W) {
+          const reg xv = S::load(x+j);
+          s0=S::madd(S::load(r0+j),xv,s0);
+          s1=S::madd(S::load(r1+j),xv,s1);
+          s2=S::madd(S::load(r2+j),xv,s2);
+          s3=S::madd(S::load(r3+j),xv,s3);
+        }
+        T t0=S::sum(s0),t1=S::sum(s1),t2=S::sum(s2),t3=S::sum(s3);
+        for (;j<n;++j) {
+          t0+=r0[j]*x[j];
+          t1+=r1[j]*x[j];
+          t2+=r2[j]*x[j];
+          t3+=r3[j]*x[j];
+        }
+        y[i]=t0;
+        y[i+1]=t1;
+        y[i+2]=t2;
+        y[i+3]=t3;
+      }
+      for (;i<m1;++i) {
+        const T* r0 = a+i*lda;
+        reg s0=S::zero();
+        for (j=0;j<nv;j+=W) {
+          s0=S::madd(S::load(r0+j),S::load(x+j),s0);
+        }
+        T t0=S::sum(s0);
+        for (;j<n;++j) {
+          t0+=r0[j]*x[j];
+        }
+        y[i]=t0;
+      }
+    }
+
+    /*
+     * Job computing a band of rows of y
+     */
+    template<typename T>
+    class gemvJob : public threadPool::job {
+    public:
+      gemvJob(const int m,const int n,const int band,
+              const T* a,const int lda,const T* x,T* y)
+        : m_(m),n_(n),band_(band),a_(a),lda_(lda),x_(x),y_(y) {
+      }
+
+      virtual void execute(const int task) {
+        const int m0 = task*band_;
+        const int m1 = (m0+band_ < m_) ? m0+band_ : m_;
+        gemvRows(m0,m1,n_,a_,lda_,x_,y_);
+      }
+
+    private:
+      const int m_,n_,band_;
+      const T* a_;
+      const int lda_;
+      const T* x_;
+      T* y_;
+    };
+
+    template<typename T>
+    void blockedGemv(const int m, const int n,
+                     const T* a, const int lda,
+                     const T* x,
+                     T* y) {
+      if (m<=0) {
+        return;
+      }
+
+      // GEMV is memory bound, so only really large matrices profit from
+      // several threads
+      const gemmConfiguration& cfg = getGemmConfiguration();
+      int threads = 1;
+      if (double(m)*double(n) >= cfg.parallelThreshold) {
+        threads = threadPool::computeThreads(cfg.threads);
+      }
+
+      if (threads > 1) {
+        const int band = ((m+threads-1)/threads+3)/4*4;
+        gemvJob<T> theJob(m,n,band,a,lda,x,y);
+        threadPool::getShared().run(theJob,(m+band-1)/band,threads);
+      } else {
+        gemvRows(0,m,n,a,lda,x,y);
+      }
+    }
+
+    // ------------------------------------------------------------------
+    // Public overloads
+    // ------------------------------------------------------------------
+
+    void gemm(const int m, const int n, const int k,
+              const float* a, const int lda,
+              const float* b, const int ldb,
+              float* c, const int ldc) {
+      blockedGemm(m,n,k,a,lda,b,ldb,c,ldc);
+    }
+
+    void gemm(const int m, const int n, const int k,
+              const double* a, const int lda,
+              const double* b, const int ldb,
+              double* c, const int ldc) {
+      blockedGemm(m,n,k,a,lda,b,ldb,c,ldc);
+    }
+
+    void gemv(const int m, const int n,
+              const float* a, const int lda,
+              const float* x,
+              float* y) {
+      blockedGemv(m,n,a,lda,x,y);
+    }
+
+    void gemv(const int m, const int n,
+              const double* a, const int lda,
+              const double* x,
+              double* y) {
+      blockedGemv(m,n,a,lda,x,y);
+    }
+
+  }
+}
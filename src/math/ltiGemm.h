@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiGemm.h
+ *         Low-level matrix-matrix (GEMM) and matrix-vector (GEMV) products
+ *         on contiguous row-major memory, used by lti::matrix::multiply().
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#ifndef _LTI_GEMM_H_
+#define _LTI_GEMM_H_
+
+#include "ltiTypes.h"
+
+namespace lti {
+  namespace internal {
+
+    /**
+     * Configuration of the GEMM engine.
+     *
+     * The block sizes determine how the operands are split so that the
+     * packed panels of both factors stay in the caches while the
+     * micro-kernel works on them.  A value of zero means "automatic",
+     * in which case the sizes are computed at runtime from the cache
+     * sizes reported by the system.
+     */
+    struct gemmConfiguration {
+      /**
+       * Default constructor.  Everything automatic.
+       */
+      gemmConfiguration();
+
+      /**
+       * Number of rows of the first factor packed at once (L2 blocking).
+       */
+      int mc;
+
+      /**
+       * Common dimension packed at once (L1 blocking).
+       */
+      int kc;
+
+      /**
+       * Number of columns of the second factor packed at once (L3
+       * blocking).
+       */
+      int nc;
+
+      /**
+       * Maximal number of threads used.
+       *
+       * Zero or negative means all threads of the shared lti::threadPool.
+       * Set to 1 to disable the parallel execution.
+       */
+      int threads;
+
+      /**
+       * Minimal number of multiply-add operations (m*n*k) required to
+       * use several threads.  Smaller products are computed sequentially.
+       *
+       * Default value: 128*128*128
+       */
+      double parallelThreshold;
+    };
+
+    /**
+     * Current configuration of the GEMM engine
+     */
+    const gemmConfiguration& getGemmConfiguration();
+
+    /**
+     * Change the configuration of the GEMM engine.
+     *
+     * This is a global setting and must not be changed while other
+     * threads are multiplying matrices.
+     */
+    void setGemmConfiguration(const gemmConfiguration& config);
+
+    /**
+     * Block sizes effectively used for the type with \p typeSize bytes,
+     * after resolving the automatic values of the configuration.
+     */
+    void getGemmBlocking(const int typeSize, int& mc, int& kc, int& nc);
+
+    /**
+     * Indicates if the GEMM and GEMV kernels for the type T are
+     * optimized (packed, register-tiled and vectorized), or if they are
+     * just the simple generic loops.
+     */
+    template<typename T>
+    struct gemmAccelerated {
+      enum { value = false };
+    };
+
+    template<>
+    struct gemmAccelerated<float> {
+      enum { value = true };
+    };
+
+    template<>
+    struct gemmAccelerated<double> {
+      enum { value = true };
+    };
+
+    /**
+     * Matrix product C = A * B.
+     *
+     * All matrices are stored row-major in contiguous memory.  The
+     * distance between the beginning of two consecutive rows is given by
+     * the \p ldX ("leading dimension") arguments.  C must not overlap with
+     * A or B.
+     *
+     * This generic version just computes the product with an i-k-j loop.
+     * The float and double overloads use a cache-blocked, packed and
+     * SIMD implementation that can run with several threads.
+     *
+     * @param m number of rows of A and C
+     * @param n number of columns of B and C
+     * @param k number of columns of A and rows of B
+     * @param a first factor (m x k)
+     * @param lda leading dimension of A
+     * @param b second factor (k x n)
+     * @param ldb leading dimension of B
+     * @param c result (m x n)
+     * @param ldc leading dimension of C
+     */
+    template<typename T>
+    void gemm(const int m, const int n, const int k,
+              const T* a, const int lda,
+              const T* b, const int ldb,
+              T* c, const int ldc) {
+      int i,j,p;
+      for (i=0;i<m;++i) {
+        T* crow = c+i*ldc;
+        for (j=0;j<n;++j) {
+          crow[j]=T(0);
+        }
+        const T* arow = a+i*lda;
+        for (p=0;p<k;++p) {
+          const T aip = arow[p];
+          const T* brow = b+p*ldb;
+          for (j=0;j<n;++j) {
+            crow[j]+=aip*brow[j];
+          }
+        }
+      }
+    }
+
+    /**
+     * Matrix product C = A * B for single precision values.
+     * @see gemm()
+     */
+    void gemm(const int m, const int n, const int k,
+              const float* a, const int lda,
+              const float* b, const int ldb,
+              float* c, const int ldc);
+
+    /**
+     * Matrix product C = A * B for double precision values.
+     * @see gemm()
+     */
+    void gemm(const int m, const int n, const int k,
+              const double* a, const int lda,
+              const double* b, const int ldb,
+              double* c, const int ldc);
+
+    /**
+     * Matrix-vector product y = A * x.
+     *
+     * A is a m x n row-major matrix with leading dimension \p lda, x has
+     * n elements and y m elements.  y must not overlap with A or x.
+     */
+    template<typename T>
+    void gemv(const int m, const int n,
+              const T* a, const int lda,
+              const T* x,
+              T* y) {
+      int i,j;
+      for (i=0;i<m;++i) {
+        const T* arow = a+i*lda;
+        T acc(0);
+        for (j=0;j<n;++j) {
+          acc+=arow[j]*x[j];
+        }
+        y[i]=acc;
+      }
+    }
+
+    /**
+     * Matrix-vector product y = A * x for single precision values.
+     * @see gemv()
+     */
+    void gemv(const int m, const int n,
+              const float* a, const int lda,
+              const float* x,
+              float* y);
+
+    /**
+     * Matrix-vector product y = A * x for double precision values.
+     * @see gemv()
+     */
+    void gemv(const int m, const int n,
+              const double* a, const int lda,
+              const double* x,
+              double* y);
+  }
+}
+
+#endif
@@ -0,0 +1,534 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiHnswGraph.h
+ *         This file contains the aggregate type hnswGraph, a hierarchical
+ *         navigable small world graph for approximate nearest neighbor
+ *         search in high dimensional spaces.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#ifndef _LTI_HNSW_GRAPH_H_
+#define _LTI_HNSW_GRAPH_H_
+
+#include "ltiContainer.h"
+#include "ltiKdTree.h"
+#include "ltiEuclidianDistantor.h"
+
+#include <list>
+#include <map>
+#include <vector>
+
+namespace lti {
+
+  /**
+   * Hierarchical navigable small world graph.
+   *
+   * This container finds approximately the nearest neighbors of a point in
+   * high dimensional spaces, where the lti::kdTree degenerates to a linear
+   * search.  The points are the nodes of a graph, in which each node is
+   * linked to some of its nearest neighbors.  Searching means walking
+   * greedily through the graph towards the key point.  To find quickly
+   * the region of the key, the graph has several levels: each node belongs
+   * to the lowest level and, with an exponentially decreasing probability,
+   * also to the levels above it, in which the links cover longer distances.
+   *
+   * The algorithm was introduced in:
+   * Malkov, Y.A. and Yashunin, D.A.  Efficient and robust approximate
+   *     nearest neighbor search using Hierarchical Navigable Small World
+   *     graphs.  IEEE Transactions on Pattern Analysis and Machine
+   *     Intelligence, Vol. 42, No. 4, 2020, Pages 824-836
+   *
+   * The interface follows the one of lti::kdTree, whose element type is
+   * also used here, so that both containers can be exchanged easily.  The
+   * types T, D and U have the same meaning and requirements as in the
+   * kdTree.  As there, points are added with add() and the graph is
+   * created with build().
+   *
+   * Three values trade the recall (the fraction of the true nearest
+   * neighbors found) against the search time and the memory:
+   * - the number of links per node, given to build(),
+   * - the breadth of the search used while building the graph, also given
+   *   to build(), and
+   * - the breadth of the search used to find the neighbors of a key, given
+   *   to each search method.  It must be at least the number of neighbors
+   *   searched.
+   *
+   * Example:
+   * \code
+   * typedef lti::hnswGraph<lti::fvector,int> graph_type;
+   *
+   * graph_type graph;
+   * for (int i=0;i<descriptors.rows();++i) {
+   *   graph.add(descriptors.getRow(i),i);
+   * }
+   * graph.build(16,100);
+   *
+   * graph_type::mmap_type neighbors;
+   * graph.searchNearest(5,key,64,neighbors);
+   * \endcode
+   *
+   * @ingroup gAggregate
+   */
+  template <typename T,typename D=int,class U=euclidianSqrDistantor<T> >
+  class hnswGraph : public container, public status {
+  public:
+    /**
+     * Value type at each dimension of the space
+     */
+    typedef typename T::value_type value_type;
+
+    /**
+     * Type of the distance between points
+     */
+    typedef typename U::distance_type distance_type;
+
+    /**
+     * Type of the elements in the graph, the same as in the kdTree
+     */
+    typedef typename kdTree<T,D,U>::element element;
+
+    /**
+     * Multimap used to return the neighbors sorted by their distance
+     */
+    typedef std::multimap<distance_type,element*> mmap_type;
+
+    /**
+     * Return type of the size() member
+     */
+    typedef int size_type;
+
+    /**
+     * Temporary data used by a search.
+     *
+     * The const search methods that receive a search context can be used
+     * concurrently from several threads on the same graph, as long as each
+     * thread uses its own context.  Reusing a context for many searches
+     * avoids allocating memory for each one of them.
+     */
+    class searchContext {
+      // the enclosing class is a friend of mine.
+      friend class hnswGraph<T,D,U>;
+    public:
+      /**
+       * Default constructor
+       */
+      searchContext();
+
+    private:
+      /**
+       * Type of the entries in the heaps
+       */
+      typedef std::pair<distance_type,int> entry_type;
+
+      /**
+       * Mark of the last search that visited each node
+       */
+      std::vector<uint32> visited_;
+
+      /**
+       * Mark of the current search
+       */
+      uint32 mark_;
+
+      /**
+       * Nodes still to be expanded (min-heap)
+       */
+      std::vector<entry_type> candidates_;
+
+      /**
+       * Best nodes found until now (max-heap)
+       */
+      std::vector<entry_type> found_;
+    };
+
+    /**
+     * Default constructor
+     */
+    hnswGraph();
+
+    /**
+     * Copy constructor
+     * @param other the object to be copied
+     */
+    hnswGraph(const hnswGraph<T,D,U>& other);
+
+    /**
+     * Destructor
+     */
+    virtual ~hnswGraph();
+
+    /**
+     * Returns the name of this class.
+     */
+    const std::string& name() const;
+
+    /**
+     * Copy data of "other" graph.
+     * @param other the graph to be copied
+     * @return a reference to this graph object
+     */
+    hnswGraph<T,D,U>& copy(const hnswGraph<T,D,U>& other);
+
+    /**
+     * Alias for copy member
+     * @param other the graph to be copied
+     * @return a reference to this graph object
+     */
+    hnswGraph<T,D,U>& operator=(const hnswGraph<T,D,U>& other);
+
+    /**
+     * Returns a pointer to a clone of this graph.
+     */
+    virtual hnswGraph<T,D,U>* clone() const;
+
+    /**
+     * Returns a pointer to a new instance of this graph.
+     */
+    virtual hnswGraph<T,D,U>* newInstance() const;
+
+    /**
+     * Clear the graph.
+     *
+     * All elements belonging to the graph will be removed.  Also all
+     * elements added until now will be deleted.
+     */
+    virtual void clear();
+
+    /**
+     * Check if the graph is empty
+     */
+    virtual bool empty() const;
+
+    /**
+     * Get the number of elements added with add() which are not yet in
+     * the graph, since neither build() nor rebuild() has been called.
+     */
+    virtual int getNumberOfAddedElements() const;
+
+    /**
+     * Get the number of elements in the graph.
+     */
+    virtual int size() const;
+
+    /**
+     * Get the number of levels of the graph.
+     */
+    int getNumberOfLevels() const;
+
+    /**
+     * Get the number of links of each node in the levels above the lowest
+     * one, as given to build().  The nodes have twice as many links in the
+     * lowest level.
+     */
+    int getNumberOfLinks() const;
+
+    /**
+     * Add a point to the graph.
+     *
+     * The point is not searchable until build() or rebuild() is called.
+     *
+     * @param point n-dimensional point
+     * @param data data associated with the point
+     */
+    void add(const T& point,const D& data);
+
+    /**
+     * Build the graph with the elements added since the last call to
+     * build() or rebuild().  All elements that were already in the graph
+     * are removed.
+     *
+     * @param links number of links of each node in the levels above the
+     *        lowest one.  Typical values are between 8 and 48; larger
+     *        values increase the recall in high dimensional spaces at the
+     *        cost of memory and build time.
+     * @param searchBreadth breadth of the search used to find the
+     *        neighbors of each inserted node.  Larger values result in a
+     *        better graph, but increase the build time.
+     * @return true if successful, false otherwise
+     */
+    bool build(const int links = 16,const int searchBreadth = 100);
+
+    /**
+     * Insert the elements added since the last call to build() or
+     * rebuild() into the graph, with the values given to build().
+     *
+     * Contrary to the kdTree, the graph grows incrementally, i.e. the
+     * already inserted elements are not touched.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool rebuild();
+
+    /**
+     * Search approximately the nearest element to the given key.
+     *
+     * This method uses an internal search context and is therefore not
+     * thread safe.
+     *
+     * @param key point in the n-dimensional space
+     * @param elem pointer to the nearest element found.  You should NEVER
+     *             delete it.
+     * @param dist distance between the key and the element found
+     * @param searchBreadth breadth of the search.  Larger values increase
+     *        the recall.
+     * @return true if an element was found, false if the graph is empty
+     */
+    bool searchNearest(const T& key,
+                       element*& elem,
+                       distance_type& dist,
+                       const int searchBreadth = 32) const;
+
+    /**
+     * Search approximately the nearest k elements to the given key.
+     *
+     * This method uses an internal search context and is therefore not
+     * thread safe.
+     *
+     * @param k number of elements you are looking for
+     * @param key point in the n-dimensional space
+     * @param searchBreadth breadth of the search.  Larger values increase
+     *        the recall.  Values smaller than k are replaced by k.
+     * @param neighbors the k elements found, sorted by their distance to
+     *        the key.  You should NEVER delete these elements.
+     * @return true if k elements were found, or false, if the graph
+     *         contains less than k elements
+     */
+    bool searchNearest(const int k,
+                       const T& key,
+                       const int searchBreadth,
+                       mmap_type& neighbors) const;
+
+    /**
+     * Search approximately the nearest k elements to the given key.
+     *
+     * This method uses an internal search context and is therefore not
+     * thread safe.
+     *
+     * @param k number of elements you are looking for
+     * @param key point in the n-dimensional space
+     * @param searchBreadth breadth of the search.  Larger values increase
+     *        the recall.  Values smaller than k are replaced by k.
+     * @param neighbors the k elements found, sorted by their distance to
+     *        the key.  You should NEVER delete these elements.
+     * @return true if k elements were found, or false, if the graph
+     *         contains less than k elements
+     */
+    bool searchNearest(const int k,
+                       const T& key,
+                       const int searchBreadth,
+                       std::list<element*>& neighbors) const;
+
+    /**
+     * Search approximately the nearest k elements to the given key,
+     * using the temporary data of the given context.
+     *
+     * This method can be called concurrently from several threads, each
+     * one with its own context.
+     *
+     * @see searchNearest(const int,const T&,const int,mmap_type&)
+     */
+    bool searchNearest(const int k,
+                       const T& key,
+                       const int searchBreadth,
+                       mmap_type& neighbors,
+                       searchContext& context) const;
+
+    /**
+     * Write the graph in the given ioHandler.
+     *
+     * The elements added since the last call to build() or rebuild() are
+     * not written.
+     *
+     * @param handler the ioHandler to be used
+     * @param complete if true (the default) the enclosing begin/end will
+     *        be also written, otherwise only the data block will be written.
+     * @return true if write was successful
+     */
+    virtual bool write(ioHandler& handler,const bool complete=true) const;
+
+    /**
+     * Read the graph from the given ioHandler
+     * @param handler the ioHandler to be used
+     * @param complete if true (the default) the enclosing begin/end will
+     *        be also read, otherwise only the data block will be read.
+     * @return true if read was successful
+     */
+    virtual bool read(ioHandler& handler,const bool complete=true);
+
+  protected:
+    /**
+     * Type of the entries in the heaps of the search
+     */
+    typedef typename searchContext::entry_type entry_type;
+
+    /**
+     * All elements in the graph.  The index of an element is the id of its
+     * node.
+     */
+    std::vector<element*> elements_;
+
+    /**
+     * Elements added but not yet inserted
+     */
+    std::list<element*> addedElements_;
+
+    /**
+     * Highest level of each node
+     */
+    std::vector<int> levels_;
+
+    /**
+     * Links of the lowest level.  The links of node i start at
+     * i*(2*links_+1): the first entry is the number of links, followed by
+     * the ids of the linked nodes.
+     */
+    std::vector<int> baseLinks_;
+
+    /**
+     * Links of the upper levels.  For node i, the links of the level l>0
+     * start at (l-1)*(links_+1) in upperLinks_[i], with the same format as
+     * baseLinks_.
+     */
+    std::vector< std::vector<int> > upperLinks_;
+
+    /**
+     * Node where all searches start, one of the nodes in the highest level
+     */
+    int entryPoint_;
+
+    /**
+     * Highest level in the graph
+     */
+    int maxLevel_;
+
+    /**
+     * Number of links per node in the upper levels
+     */
+    int links_;
+
+    /**
+     * Breadth of the search while inserting nodes
+     */
+    int constructionBreadth_;
+
+    /**
+     * State of the pseudo random generator used to assign the levels
+     */
+    uint32 randomState_;
+
+    /**
+     * Distantor used to compute the distances
+     */
+    U distantor_;
+
+  private:
+    /**
+     * Maximal number of links of a node at the given level
+     */
+    inline int maxLinks(const int level) const;
+
+    /**
+     * Pointer to the links of a node at the given level
+     */
+    inline int* linksOf(const int node,const int level);
+
+    /**
+     * Pointer to the links of a node at the given level
+     */
+    inline const int* linksOf(const int node,const int level) const;
+
+    /**
+     * Distance between two nodes
+     */
+    inline distance_type distance(const int a,const int b) const;
+
+    /**
+     * Draw the highest level of a new node
+     */
+    int randomLevel();
+
+    /**
+     * Insert node into the graph
+     */
+    void insert(const int node,searchContext& context);
+
+    /**
+     * Walk greedily from entry towards the key at the given level.
+     *
+     * @return the node at that level nearest to the key, whose distance to
+     *         the key is left in \a dist
+     */
+    int greedySearch(const T& key,
+                     int entry,
+                     distance_type& dist,
+                     const int level) const;
+
+    /**
+     * Search the \a breadth nearest nodes to the key at the given level,
+     * starting at the given entry node.  The nodes found are left in the
+     * context (found_), sorted by increasing distance.
+     */
+    void searchLevel(const T& key,
+                     const int entry,
+                     const distance_type entryDist,
+                     const int breadth,
+                     const int level,
+                     searchContext& context) const;
+
+    /**
+     * Select at most \a maxLinks links out of the given candidates, sorted
+     * by increasing distance to the node.  A candidate is selected only if
+     * it is nearer to the node than to all candidates already selected,
+     * which keeps links in all directions.
+     */
+    void selectLinks(const std::vector<entry_type>& candidates,
+                     const int maxLinks,
+                     std::vector<int>& selected) const;
+
+    /**
+     * Add a link from node to other, pruning the links of node if there are
+     * too many of them.
+     */
+    void link(const int node,const int other,const int level);
+
+    /**
+     * Create the nodes for the added elements and insert them
+     */
+    void insertAddedElements();
+
+    /**
+     * Search context used by the methods without context argument, which
+     * therefore are not thread safe.
+     */
+    mutable searchContext context_;
+  };
+
+}
+
+#include "ltiHnswGraph_template.h"
+
+#endif
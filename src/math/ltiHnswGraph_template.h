@@ -0,0 +1,671 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiHnswGraph_template.h
+ *         Contains the implementation of the class lti::hnswGraph.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#undef min
+#undef max
+
+#include "ltiSTLIoInterface.h"
+
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+namespace lti {
+
+  // --------------------------------------------------
+  // hnswGraph::searchContext
+  // --------------------------------------------------
+
+  template<typename T,typename D,class U>
+  hnswGraph<T,D,U>::searchContext::searchContext() : mark_(0) {
+  }
+
+  // --------------------------------------------------
+  // hnswGraph
+  // --------------------------------------------------
+
+  // default constructor
+  template<typename T,typename D,class U>
+  hnswGraph<T,D,U>::hnswGraph()
+    : container(),status(),entryPoint_(-1),maxLevel_(-1),links_(0),
+      constructionBreadth_(0),randomState_(0) {
+  }
+
+  // copy constructor
+  template<typename T,typename D,class U>
+  hnswGraph<T,D,U>::hnswGraph(const hnswGraph<T,D,U>& other)
+    : container(),status(),entryPoint_(-1),maxLevel_(-1),links_(0),
+      constructionBreadth_(0),randomState_(0) {
+    copy(other);
+  }
+
+  // destructor
+  template<typename T,typename D,class U>
+  hnswGraph<T,D,U>::~hnswGraph() {
+    clear();
+  }
+
+  // name
+  template<typename T,typename D,class U>
+  const std::string& hnswGraph<T,D,U>::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // copy member
+  template<typename T,typename D,class U>
+  hnswGraph<T,D,U>& hnswGraph<T,D,U>::copy(const hnswGraph<T,D,U>& other) {
+    clear();
+
+    elements_.resize(other.elements_.size());
+    for (unsigned int i=0;i<elements_.size();++i) {
+      elements_[i] = other.elements_[i]->clone();
+    }
+
+    typename std::list<element*>::const_iterator it;
+    for (it=other.addedElements_.begin();it!=other.addedElements_.end();++it) {
+      addedElements_.push_back((*it)->clone());
+    }
+
+    levels_ = other.levels_;
+    baseLinks_ = other.baseLinks_;
+    upperLinks_ = other.upperLinks_;
+    entryPoint_ = other.entryPoint_;
+    maxLevel_ = other.maxLevel_;
+    links_ = other.links_;
+    constructionBreadth_ = other.constructionBreadth_;
+    randomState_ = other.randomState_;
+    distantor_ = other.distantor_;
+
+    return *this;
+  }
+
+  // alias for copy member
+  template<typename T,typename D,class U>
+  hnswGraph<T,D,U>&
+  hnswGraph<T,D,U>::operator=(const hnswGraph<T,D,U>& other) {
+    return copy(other);
+  }
+
+  // clone member
+  template<typename T,typename D,class U>
+  hnswGraph<T,D,U>* hnswGraph<T,D,U>::clone() const {
+    return new hnswGraph(*this);
+  }
+
+  // new instance member
+  template<typename T,typename D,class U>
+  hnswGraph<T,D,U>* hnswGraph<T,D,U>::newInstance() const {
+    return new hnswGraph();
+  }
+
+  template<typename T,typename D,class U>
+  void hnswGraph<T,D,U>::clear() {
+    for (unsigned int i=0;i<elements_.size();++i) {
+      delete elements_[i];
+    }
+    elements_.clear();
+
+    typename std::list<element*>::iterator it;
+    for (it=addedElements_.begin();it!=addedElements_.end();++it) {
+      delete (*it);
+    }
+    addedElements_.clear();
+
+    levels_.clear();
+    baseLinks_.clear();
+    upperLinks_.clear();
+    entryPoint_ = -1;
+    maxLevel_ = -1;
+  }
+
+  template<typename T,typename D,class U>
+  bool hnswGraph<T,D,U>::empty() const {
+    return elements_.empty();
+  }
+
+  template<typename T,typename D,class U>
+  int hnswGraph<T,D,U>::getNumberOfAddedElements() const {
+    return static_cast<int>(addedElements_.size());
+  }
+
+  template<typename T,typename D,class U>
+  int hnswGraph<T,D,U>::size() const {
+    return static_cast<int>(elements_.size());
+  }
+
+  template<typename T,typename D,class U>
+  int hnswGraph<T,D,U>::getNumberOfLevels() const {
+    return maxLevel_+1;
+  }
+
+  template<typename T,typename D,class U>
+  int hnswGraph<T,D,U>::getNumberOfLinks() const {
+    return links_;
+  }
+
+  template<typename T,typename D,class U>
+  void hnswGraph<T,D,U>::add(const T& point,const D& data) {
+    addedElements_.push_back(new element(point,data));
+  }
+
+  // -------------------------------------------------------------------
+  // graph construction
+  // -------------------------------------------------------------------
+
+  template<typename T,typename D,class U>
+  inline int hnswGraph<T,D,U>::maxLinks(const int level) const {
+    return (level == 0) ? 2*links_ : links_;
+  }
+
+  template<typename T,typename D,class U>
+  inline int* hnswGraph<T,D,U>::linksOf(const int node,const int level) {
+    return (level == 0) ? &baseLinks_[node*(2*links_+1)] :
+                          &upperLinks_[node][(level-1)*(links_+1)];
+  }
+
+  template<typename T,typename D,class U>
+  inline const int* hnswGraph<T,D,U>::linksOf(const int node,
+                                               const int level) const {
+    return (level == 0) ? &baseLinks_[node*(2*links_+1)] :
+                          &upperLinks_[node][(level-1)*(links_+1)];
+  }
+
+  template<typename T,typename D,class U>
+  inline typename hnswGraph<T,D,U>::distance_type
+  hnswGraph<T,D,U>::distance(const int a,const int b) const {
+    return distantor_(elements_[a]->point,elements_[b]->point);
+  }
+
+  template<typename T,typename D,class U>
+  int hnswGraph<T,D,U>::randomLevel() {
+    // xorshift generator, which makes the graph reproducible
+    randomState_ ^= (randomState_ << 13);
+    randomState_ ^= (randomState_ >> 17);
+    randomState_ ^= (randomState_ << 5);
+
+    // uniform value in (0,1]
+    const double u = (static_cast<double>(randomState_ >> 8)+1.0)/16777216.0;
+
+    // the probability of each level decreases by a factor equal to the
+    // number of links
+    return static_cast<int>(-log(u)/log(static_cast<double>(links_)));
+  }
+
+  template<typename T,typename D,class U>
+  bool hnswGraph<T,D,U>::build(const int links,const int searchBreadth) {
+    if (links < 2) {
+      setStatusString("At least two links per node are required");
+      return false;
+    }
+
+    // remove the old graph, but keep the added elements
+    for (unsigned int i=0;i<elements_.size();++i) {
+      delete elements_[i];
+    }
+    elements_.clear();
+    levels_.clear();
+    baseLinks_.clear();
+    upperLinks_.clear();
+    entryPoint_ = -1;
+    maxLevel_ = -1;
+
+    links_ = links;
+    constructionBreadth_ = max(links,searchBreadth);
+    randomState_ = 2463534242u;
+
+    insertAddedElements();
+    return true;
+  }
+
+  template<typename T,typename D,class U>
+  bool hnswGraph<T,D,U>::rebuild() {
+    if (links_ == 0) {
+      return build();
+    }
+    insertAddedElements();
+    return true;
+  }
+
+  template<typename T,typename D,class U>
+  void hnswGraph<T,D,U>::insertAddedElements() {
+    const int first = size();
+    const int n = first + getNumberOfAddedElements();
+
+    elements_.reserve(n);
+    levels_.reserve(n);
+    baseLinks_.resize(n*(2*links_+1),0);
+    upperLinks_.resize(n);
+
+    typename std::list<element*>::iterator it;
+    for (it=addedElements_.begin();it!=addedElements_.end();++it) {
+      const int level = randomLevel();
+      upperLinks_[elements_.size()].assign(level*(links_+1),0);
+      elements_.push_back(*it);
+      levels_.push_back(level);
+    }
+    addedElements_.clear();
+
+    searchContext context;
+    for (int i=first;i<n;++i) {
+      insert(i,context);
+    }
+  }
+
+  template<typename T,typename D,class U>
+  void hnswGraph<T,D,U>::insert(const int node,searchContext& context) {
+    const int level = levels_[node];
+
+    if (entryPoint_ < 0) {
+      entryPoint_ = node;
+      maxLevel_ = level;
+      return;
+    }
+
+    const T& key = elements_[node]->point;
+    int entry = entryPoint_;
+    distance_type dist = distantor_(key,elements_[entry]->point);
+
+    // find the region of the node in the levels above it
+    int l;
+    for (l=maxLevel_;l>level;--l) {
+      entry = greedySearch(key,entry,dist,l);
+    }
+
+    std::vector<int> selected;
+    for (l=min(level,maxLevel_);l>=0;--l) {
+      searchLevel(key,entry,dist,constructionBreadth_,l,context);
+      selectLinks(context.found_,links_,selected);
+
+      int* const nodeLinks = linksOf(node,l);
+      nodeLinks[0] = static_cast<int>(selected.size());
+      for (unsigned int i=0;i<selected.size();++i) {
+        nodeLinks[i+1] = selected[i];
+        link(selected[i],node,l);
+      }
+
+      entry = context.found_[0].second;
+      dist = context.found_[0].first;
+    }
+
+    if (level > maxLevel_) {
+      entryPoint_ = node;
+      maxLevel_ = level;
+    }
+  }
+
+  template<typename T,typename D,class U>
+  void hnswGraph<T,D,U>::selectLinks(const std::vector<entry_type>& candidates,
+                                     const int maxLinks,
+                                     std::vector<int>& selected) const {
+    selected.clear();
+    const int n = static_cast<int>(candidates.size());
+
+    if (n <= maxLinks) {
+      for (int i=0;i<n;++i) {
+        selected.push_back(candidates[i].second);
+      }
+      return;
+    }
+
+    for (int i=0;(i<n) && (static_cast<int>(selected.size())<maxLinks);++i) {
+      const int c = candidates[i].second;
+      bool keep = true;
+      for (unsigned int j=0;keep && (j<selected.size());++j) {
+        keep = (distance(c,selected[j]) >= candidates[i].first);
+      }
+      if (keep) {
+        selected.push_back(c);
+      }
+    }
+  }
+
+  template<typename T,typename D,class U>
+  void hnswGraph<T,D,U>::link(const int node,const int other,
+                              const int level) {
+    int* const nodeLinks = linksOf(node,level);
+    const int m = maxLinks(level);
+
+    if (nodeLinks[0] < m) {
+      nodeLinks[++nodeLinks[0]] = other;
+      return;
+    }
+
+    // too many links: keep the most useful ones
+    std::vector<entry_type> candidates;
+    candidates.reserve(m+1);
+    for (int i=1;i<=m;++i) {
+      candidates.push_back(entry_type(distance(node,nodeLinks[i]),
+                                      nodeLinks[i]));
+    }
+    candidates.push_back(entry_type(distance(node,other),other));
+    std::sort(candidates.begin(),candidates.end());
+
+    std::vector<int> selected;
+    selectLinks(candidates,m,selected);
+    nodeLinks[0] = static_cast<int>(selected.size());
+    for (unsigned int i=0;i<selected.size();++i) {
+      nodeLinks[i+1] = selected[i];
+    }
+  }
+
+  // -------------------------------------------------------------------
+  // search
+  // -------------------------------------------------------------------
+
+  template<typename T,typename D,class U>
+  int hnswGraph<T,D,U>::greedySearch(const T& key,
+                                     int entry,
+                                     distance_type& dist,
+                                     const int level) const {
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      const int* const l = linksOf(entry,level);
+      for (int i=1;i<=l[0];++i) {
+        const distance_type d = distantor_(key,elements_[l[i]]->point);
+        if (d < dist) {
+          dist = d;
+          entry = l[i];
+          changed = true;
+        }
+      }
+    }
+    return entry;
+  }
+
+  template<typename T,typename D,class U>
+  void hnswGraph<T,D,U>::searchLevel(const T& key,
+                                     const int entry,
+                                     const distance_type entryDist,
+                                     const int breadth,
+                                     const int level,
+                                     searchContext& context) const {
+    const int n = size();
+    std::vector<uint32>& visited = context.visited_;
+    if (static_cast<int>(visited.size()) < n) {
+      visited.resize(n,0);
+    }
+    if (++context.mark_ == 0) {
+      // the marks overflowed, so all old marks must be removed
+      std::fill(visited.begin(),visited.end(),0);
+      context.mark_ = 1;
+    }
+    const uint32 mark = context.mark_;
+
+    // nearest candidate at the front of the candidates, farthest node found
+    // at the front of found
+    std::vector<entry_type>& candidates = context.candidates_;
+    std::vector<entry_type>& found = context.found_;
+    const std::greater<entry_type> nearer;
+
+    candidates.clear();
+    found.clear();
+    candidates.push_back(entry_type(entryDist,entry));
+    found.push_back(entry_type(entryDist,entry));
+    visited[entry] = mark;
+
+    while (!candidates.empty()) {
+      const entry_type c = candidates.front();
+      if (c.first > found.front().first) {
+        // all remaining candidates are farther than the nodes found
+        break;
+      }
+      std::pop_heap(candidates.begin(),candidates.end(),nearer);
+      candidates.pop_back();
+
+      const int* const l = linksOf(c.second,level);
+      for (int i=1;i<=l[0];++i) {
+        const int e = l[i];
+        if (visited[e] == mark) {
+          continue;
+        }
+        visited[e] = mark;
+
+        const distance_type d = distantor_(key,elements_[e]->point);
+        if ((static_cast<int>(found.size()) < breadth) ||
+            (d < found.front().first)) {
+          candidates.push_back(entry_type(d,e));
+          std::push_heap(candidates.begin(),candidates.end(),nearer);
+
+          found.push_back(entry_type(d,e));
+          std::push_heap(found.begin(),found.end());
+          if (static_cast<int>(found.size()) > breadth) {
+            std::pop_heap(found.begin(),found.end());
+            found.pop_back();
+          }
+        }
+      }
+    }
+
+    std::sort_heap(found.begin(),found.end());
+  }
+
+  template<typename T,typename D,class U>
+  bool hnswGraph<T,D,U>::searchNearest(const T& key,
+                                       element*& elem,
+                                       distance_type& dist,
+                                       const int searchBreadth) const {
+    mmap_type neighbors;
+    if (searchNearest(1,key,searchBreadth,neighbors,context_)) {
+      elem = neighbors.begin()->second;
+      dist = neighbors.begin()->first;
+      return true;
+    }
+    elem = 0;
+    return false;
+  }
+
+  template<typename T,typename D,class U>
+  bool hnswGraph<T,D,U>::searchNearest(const int k,
+                                       const T& key,
+                                       const int searchBreadth,
+                                       mmap_type& neighbors) const {
+    return searchNearest(k,key,searchBreadth,neighbors,context_);
+  }
+
+  template<typename T,typename D,class U>
+  bool hnswGraph<T,D,U>::searchNearest(const int k,
+                                       const T& key,
+                                       const int searchBreadth,
+                                       std::list<element*>& neighbors) const {
+    neighbors.clear();
+    mmap_type neigh;
+    if (searchNearest(k,key,searchBreadth,neigh,context_)) {
+      typename mmap_type::const_iterator it;
+      for (it=neigh.begin();it!=neigh.end();++it) {
+        neighbors.push_back(it->second);
+      }
+      return true;
+    }
+    return false;
+  }
+
+  template<typename T,typename D,class U>
+  bool hnswGraph<T,D,U>::searchNearest(const int k,
+                                       const T& key,
+                                       const int searchBreadth,
+                                       mmap_type& neighbors,
+                                       searchContext& context) const {
+    neighbors.clear();
+    if (empty() || (k < 1) || (k > size())) {
+      return false;
+    }
+
+    int entry = entryPoint_;
+    distance_type dist = distantor_(key,elements_[entry]->point);
+    for (int l=maxLevel_;l>0;--l) {
+      entry = greedySearch(key,entry,dist,l);
+    }
+
+    searchLevel(key,entry,dist,max(k,searchBreadth),0,context);
+
+    const std::vector<entry_type>& found = context.found_;
+    const int n = min(k,static_cast<int>(found.size()));
+    for (int i=0;i<n;++i) {
+      neighbors.insert(neighbors.end(),
+                       std::make_pair(found[i].first,
+                                      elements_[found[i].second]));
+    }
+
+    return (n == k);
+  }
+
+  // -------------------------------------------------------------------
+  // storage
+  // -------------------------------------------------------------------
+
+  template<typename T,typename D,class U>
+  bool hnswGraph<T,D,U>::write(ioHandler& handler,
+                               const bool complete) const {
+    bool b = true;
+
+    if (complete) {
+      b = handler.writeBegin();
+    }
+
+    b = b && lti::write(handler,"links",links_);
+    b = b && lti::write(handler,"constructionBreadth",constructionBreadth_);
+    b = b && lti::write(handler,"entryPoint",entryPoint_);
+    b = b && lti::write(handler,"maxLevel",maxLevel_);
+    b = b && lti::write(handler,"levels",levels_);
+    b = b && lti::write(handler,"baseLinks",baseLinks_);
+
+    // the links of the upper levels, one node after the other
+    std::vector<int> upper;
+    for (unsigned int i=0;i<upperLinks_.size();++i) {
+      upper.insert(upper.end(),upperLinks_[i].begin(),upperLinks_[i].end());
+    }
+    b = b && lti::write(handler,"upperLinks",upper);
+
+    b = b && handler.writeBegin();             // elements field
+    b = b && handler.writeSymbol("elements");  //
+    b = b && handler.writeKeyValueSeparator(); //
+    b = b && handler.writeBegin();             // elements data
+    b = b && handler.write("size",size());
+    b = b && handler.writeBegin();             // data block
+    if (!elements_.empty()) {
+      b = b && elements_[0]->write(handler);
+      for (unsigned int i=1;i<elements_.size();++i) {
+        b = b && handler.writeDataSeparator();
+        b = b && elements_[i]->write(handler);
+      }
+    }
+    b = b && handler.writeEnd();               // data block
+    b = b && handler.writeEnd();               // elements data
+    b = b && handler.writeEnd();               // elements field
+
+    if (complete) {
+      b = b && handler.writeEnd();
+    }
+
+    return b;
+  }
+
+  template<typename T,typename D,class U>
+  bool hnswGraph<T,D,U>::read(ioHandler& handler,const bool complete) {
+    bool b = true;
+
+    clear();
+
+    if (complete) {
+      b = handler.readBegin();
+    }
+
+    b = b && lti::read(handler,"links",links_);
+    b = b && lti::read(handler,"constructionBreadth",constructionBreadth_);
+    b = b && lti::read(handler,"entryPoint",entryPoint_);
+    b = b && lti::read(handler,"maxLevel",maxLevel_);
+    b = b && lti::read(handler,"levels",levels_);
+    b = b && lti::read(handler,"baseLinks",baseLinks_);
+
+    std::vector<int> upper;
+    b = b && lti::read(handler,"upperLinks",upper);
+
+    b = b && handler.readBegin();              // elements field
+    b = b && handler.trySymbol("elements");    //
+    b = b && handler.readKeyValueSeparator();  //
+    b = b && handler.readBegin();              // elements data
+    int n = 0;
+    b = b && handler.read("size",n);
+    b = b && handler.readBegin();              // data block
+    if (b && (n > 0)) {
+      elements_.reserve(n);
+      for (int i=0;i<n;++i) {
+        if (i > 0) {
+          b = b && handler.readDataSeparator();
+        }
+        elements_.push_back(new element);
+        b = b && elements_.back()->read(handler);
+      }
+    }
+    b = b && handler.readEnd();                // data block
+    b = b && handler.readEnd();                // elements data
+    b = b && handler.readEnd();                // elements field
+
+    if (complete) {
+      b = b && handler.readEnd();
+    }
+
+    if (!b) {
+      clear();
+      return false;
+    }
+
+    // check the consistency of the links and rebuild the upper levels
+    bool consistent = ((static_cast<int>(levels_.size()) == n) &&
+                       (static_cast<int>(baseLinks_.size()) ==
+                        n*(2*links_+1)) &&
+                       (entryPoint_ < n));
+    if (consistent) {
+      upperLinks_.resize(n);
+      unsigned int pos = 0;
+      for (int i=0;consistent && (i<n);++i) {
+        const unsigned int m = levels_[i]*(links_+1);
+        consistent = (pos+m <= upper.size());
+        if (consistent) {
+          upperLinks_[i].assign(upper.begin()+pos,upper.begin()+pos+m);
+          pos += m;
+        }
+      }
+    }
+    if (!consistent) {
+      handler.setStatusString("Inconsistent graph data");
+      clear();
+      return false;
+    }
+
+    randomState_ = 2463534242u + static_cast<uint32>(n);
+
+    return b;
+  }
+
+}
@@ -41,9 +41,11 @@
 #include "ltiQuickMedian.h"
 #include "ltiEuclidianDistantor.h"
 #include "ltiTypeInfo.h"
+#include "ltiThreadPool.h"
 
 #include <list>
 #include <map>
+#include <vector>
 
 namespace lti {
 
@@ -504,6 +506,100 @@ namespace lti {
      */
     typedef std::multimap<distance_type,element*> mmap_type;
 
+    /**
+     * Temporary data of a search.
+     *
+     * The search methods receiving a searchContext keep all their temporary
+     * data in it, and not in the tree.  Therefore, several threads can
+     * search the same tree at the same time, as long as each one uses its
+     * own context.  A context can be reused for any number of searches
+     * (even in different trees of the same type), which avoids allocating
+     * memory for each one of them.
+     */
+    class searchContext {
+      // the enclosing class is a friend of mine.
+      friend class kdTree<T,D,U>;
+    public:
+      /**
+       * Default constructor
+       */
+      searchContext();
+
+    private:
+      /**
+       * Bounding box of the node being searched (first row min, second
+       * row max)
+       */
+      matrix<value_type> bounds_;
+
+      /**
+       * Distances between the key and the points of the leaf being
+       * examined
+       */
+      vector<distance_type> distances_;
+    };
+
+    /**
+     * Node of the flat layout of the tree (see eLayoutType).
+     *
+     * All flat nodes of a tree are stored in one array in breadth-first
+     * order, and the two children of a node are stored one after the
+     * other.
+     */
+    class flatNode {
+    public:
+      /**
+       * Dimension in which the subnodes are split, or -1 for leaves.
+       */
+      int splitDim;
+
+      /**
+       * Value at the split dimension where the splitting takes place.
+       */
+      value_type partition;
+
+      /**
+       * For inner nodes, index of the left child in the node array (the
+       * right child follows it).  For leaves, index of the first point of
+       * the leaf.
+       */
+      int first;
+
+      /**
+       * For leaves, index after the last point of the leaf.  Unused for
+       * inner nodes.
+       */
+      int last;
+
+      /**
+       * return true if this node is a leaf.
+       */
+      inline bool isLeaf() const;
+    };
+
+    /**
+     * Memory layouts of the tree
+     */
+    enum eLayoutType {
+      /**
+       * Each node is allocated individually and keeps the pointers to its
+       * elements (see kdTree::node).  Elements can be added to a tree built
+       * this way with rebuild() very efficiently.
+       */
+      Linked,
+
+      /**
+       * All nodes are stored in one array (see kdTree::flatNode) and the
+       * coordinates of all points are stored in one matrix, where the
+       * points of a leaf are contiguous in each row.  The nodes are split
+       * at the median of a sample of the points, so that the tree is built
+       * much faster than a Linked one, and the search accesses much less
+       * memory locations.  The tree has no kdTree::node objects, i.e.
+       * getRoot() returns a null pointer.
+       */
+      Flat
+    };
+
 
     // ----------------------------------------------------------------------
     // kdTree Definition
@@ -618,10 +714,16 @@ namespace lti {
     /**
      * Get pointer to root node
      *
-     * Return a null pointer if the tree hasn't been build yet.
+     * Return a null pointer if the tree hasn't been build yet, or if it
+     * has been built with the Flat layout.
      */
     virtual node* getRoot();
 
+    /**
+     * Get the memory layout of the tree
+     */
+    eLayoutType getLayout() const;
+
     /**
      * @name Search methods
      */
@@ -683,12 +785,11 @@ namespace lti {
      *             not found.  You should \b never delete the pointed data.
      * @return true if key was found, otherwise false (i.e. tree empty).
      *
-     * \warning This method is not thread safe.  In order to provide a
-     *          fast search mechanism for the nearest neighbor some
-     *          temporary variables are stored in the tree class itself,
-     *          and therefore it is not possible to search the
-     *          nearest neighbor in the same tree from different
-     *          threads.
+     * \warning This method is not thread safe, since it uses a search
+     *          context stored in the tree itself.  To search the same
+     *          tree from different threads use
+     *          searchNearest(const T&,element*&,distance_type&,searchContext&)
+     *          instead.
      */
     bool searchNearest(const T& key,element*& elem) const;
 
@@ -715,12 +816,11 @@ namespace lti {
      *             of the euclidean distance).
      * @return true if key was found, otherwise false (i.e. tree empty).
      *
-     * \warning This method is not thread safe.  In order to provide a
-     *          fast search mechanism for the nearest neighbor some
-     *          temporary variables are stored in the tree class itself,
-     *          and therefore it is not possible to search the
-     *          nearest neighbor in the same tree from different
-     *          threads.
+     * \warning This method is not thread safe, since it uses a search
+     *          context stored in the tree itself.  To search the same
+     *          tree from different threads use
+     *          searchNearest(const T&,element*&,distance_type&,searchContext&)
+     *          instead.
      */
     bool searchNearest(const T& key,element*& elem,distance_type& dist) const;
 
@@ -734,12 +834,11 @@ namespace lti {
      * @param elem the contents of the found point will be left here.
      * @return true if key was found, otherwise false (i.e. tree empty).
      *
-     * \warning This method is not thread safe.  In order to provide a
-     *          fast search mechanism for the nearest neighbor some
-     *          temporary variables are stored in the tree class itself,
-     *          and therefore it is not possible to search the
-     *          nearest neighbor in the same tree from different
-     *          threads.
+     * \warning This method is not thread safe, since it uses a search
+     *          context stored in the tree itself.  To search the same
+     *          tree from different threads use
+     *          searchNearest(const T&,element*&,distance_type&,searchContext&)
+     *          instead.
      */
     bool searchNearest(const T& key,element& elem) const;
 
@@ -757,12 +856,11 @@ namespace lti {
      *             of the euclidean distance).
      * @return true if key was found, otherwise false (i.e. tree empty).
      *
-     * \warning This method is not thread safe.  In order to provide a
-     *          fast search mechanism for the nearest neighbor some
-     *          temporary variables are stored in the tree class itself,
-     *          and therefore it is not possible to search the
-     *          nearest neighbor in the same tree from different
-     *          threads.
+     * \warning This method is not thread safe, since it uses a search
+     *          context stored in the tree itself.  To search the same
+     *          tree from different threads use
+     *          searchNearest(const T&,element*&,distance_type&,searchContext&)
+     *          instead.
      */
     bool searchNearest(const T& key,element& elem,distance_type& dist) const;
 
@@ -776,12 +874,11 @@ namespace lti {
      * @param data the contents of the found nearest point will be left here.
      * @return true if key was found, otherwise false (i.e. tree empty).
      *
-     * \warning This method is not thread safe.  In order to provide a
-     *          fast search mechanism for the nearest neighbor some
-     *          temporary variables are stored in the tree class itself,
-     *          and therefore it is not possible to search the
-     *          nearest neighbor in the same tree from different
-     *          threads.
+     * \warning This method is not thread safe, since it uses a search
+     *          context stored in the tree itself.  To search the same
+     *          tree from different threads use
+     *          searchNearest(const T&,element*&,distance_type&,searchContext&)
+     *          instead.
      */
     bool searchNearest(const T& key,D& data) const;
 
@@ -936,6 +1033,12 @@ namespace lti {
      *               building the upper limits of the bounding box.
      * @param neighbors list of pointer to the elements found until now.
      * @return true if any element was found.
+     *
+     * \warning This method is not thread safe, since it uses a search
+     *          context stored in the tree itself.  To search the same
+     *          tree from different threads use
+     *          searchRange(const T&,const T&,std::list<element*>&,searchContext&)
+     *          instead.
      */
     bool searchRange(const T& boxMin,
                      const T& boxMax,
@@ -943,6 +1046,163 @@ namespace lti {
 
     //@}
 
+    /**
+     * @name Re-entrant search methods
+     *
+     * These methods keep their temporary data in a searchContext given by
+     * the caller, and not in the tree.  They can be called simultaneously
+     * from several threads on the same tree, as long as each thread uses
+     * its own context and nobody modifies the tree in the mean time.
+     *
+     * Example:
+     * \code
+     * typedef lti::kdTree<lti::dvector,int> tree_type;
+     * tree_type theTree;
+     * // ... add and build the tree ...
+     *
+     * // each thread does:
+     * tree_type::searchContext context;
+     * tree_type::element* elem;
+     * double dist;
+     * for (int i=0;i<myKeys.rows();++i) {
+     *   if (theTree.searchNearest(myKeys.getRow(i),elem,dist,context)) {
+     *     // use elem->data
+     *   }
+     * }
+     * \endcode
+     *
+     * The methods searchWithin() and the methods searchNearest() and
+     * searchBestBinFirst() for k elements without context are also
+     * re-entrant, but they allocate their temporary data on each call.
+     */
+    //@{
+
+    /**
+     * Search for the nearest element in the tree to the given key point.
+     *
+     * @param key point in the n-dimensional space you are looking for.
+     * @param elem pointer to the contents of the point found, or zero if
+     *             not found.  You should \b never delete the pointed data.
+     * @param dist distance between the points, as computed by the distantor
+     *             of the tree.
+     * @param context temporary data of the search.
+     * @return true if key was found, otherwise false (i.e. tree empty).
+     */
+    bool searchNearest(const T& key,
+                       element*& elem,
+                       distance_type& dist,
+                       searchContext& context) const;
+
+    /**
+     * Search for the nearest k elements in the tree to the given key point.
+     *
+     * @param k number of elements you are looking for.
+     * @param key the point in the n-dimensional space you are looking for.
+     * @param neighbors multimap with the found elements, sorted in
+     *                  increasing order of their distance to the key.
+     *                  You should NEVER delete the pointed elements.
+     * @param context temporary data of the search.
+     * @return true if k elements were found, or false, if the tree contains
+     *         less than k elements
+     */
+    bool searchNearest(const int k,
+                       const T& key,
+                       mmap_type& neighbors,
+                       searchContext& context) const;
+
+    /**
+     * Search the approximate k nearest elements with the best-bin-first
+     * algorithm of Beis and Lowe.
+     *
+     * @param k number of elements you are looking for.
+     * @param key the point in the n-dimensional space you are looking for.
+     * @param emax maximal number of visits allowed for leaf nodes.
+     * @param neighbors multimap with the found elements, sorted in
+     *                  increasing order of their distance to the key.
+     *                  You should NEVER delete the pointed elements.
+     * @param context temporary data of the search.
+     * @return true if k elements were found, or false, if the tree contains
+     *         less than k elements
+     */
+    bool searchBestBinFirst(const int k,
+                            const T& key,
+                            const int emax,
+                            mmap_type& neighbors,
+                            searchContext& context) const;
+
+    /**
+     * Search for all points lying within the given hyperbox.
+     * @param boxMin point representing the lowest values at each coordinate
+     *               building the lower limits of the bounding box.
+     * @param boxMax point representing the highest values at each coordinate
+     *               building the upper limits of the bounding box.
+     * @param neighbors list of pointer to the elements found.
+     * @param context temporary data of the search.
+     * @return true if any element was found.
+     */
+    bool searchRange(const T& boxMin,
+                     const T& boxMax,
+                     std::list<element*>& neighbors,
+                     searchContext& context) const;
+    //@}
+
+    /**
+     * @name Batch search methods
+     *
+     * These methods search the neighbors of each row of a matrix of keys,
+     * distributing the rows among the threads of the shared
+     * lti::threadPool.  They can only be used if the points of the tree
+     * are vectors (i.e. T is lti::vector<value_type>), like the
+     * descriptors of the local features of an image.
+     */
+    //@{
+
+    /**
+     * Search for the nearest k elements in the tree to each row of the
+     * given matrix.
+     *
+     * @param k number of elements you are looking for.
+     * @param keys each row is a point in the n-dimensional space whose
+     *             neighbors are searched.
+     * @param neighbors the i-th multimap contains the elements found for
+     *                  the i-th row of \a keys, sorted in increasing order
+     *                  of their distance to it.  You should NEVER delete the
+     *                  pointed elements.
+     * @param numberOfThreads number of threads used.  If zero or negative,
+     *                        all threads of the shared pool are used.
+     * @return true if k elements were found for all keys, or false, if the
+     *         tree contains less than k elements.
+     */
+    bool searchNearest(const int k,
+                       const matrix<value_type>& keys,
+                       std::vector<mmap_type>& neighbors,
+                       const int numberOfThreads = 0) const;
+
+    /**
+     * Search the approximate k nearest elements of each row of the given
+     * matrix with the best-bin-first algorithm of Beis and Lowe.
+     *
+     * @param k number of elements you are looking for.
+     * @param keys each row is a point in the n-dimensional space whose
+     *             neighbors are searched.
+     * @param emax maximal number of visits allowed for leaf nodes in each
+     *             search.
+     * @param neighbors the i-th multimap contains the elements found for
+     *                  the i-th row of \a keys, sorted in increasing order
+     *                  of their distance to it.  You should NEVER delete the
+     *                  pointed elements.
+     * @param numberOfThreads number of threads used.  If zero or negative,
+     *                        all threads of the shared pool are used.
+     * @return true if k elements were found for all keys, or false, if the
+     *         tree contains less than k elements.
+     */
+    bool searchBestBinFirst(const int k,
+                            const matrix<value_type>& keys,
+                            const int emax,
+                            std::vector<mmap_type>& neighbors,
+                            const int numberOfThreads = 0) const;
+    //@}
+
     /**
      * Consider the given element to be inserted in the tree after calling
      * the build(const int) method.
@@ -969,6 +1229,28 @@ namespace lti {
      */
     bool build(const int bucketSize = 1);
 
+    /**
+     * Build the kd-Tree for all nodes added with the add() method, with the
+     * given memory layout.
+     *
+     * The Linked layout results in the same tree as build(const int).  The
+     * Flat layout splits each node at the dimension with the highest
+     * variance of a sample of its points, at the median of that sample.
+     * Exact medians are used if the sample is at least as large as the
+     * number of points at the node.
+     *
+     * @param bucketSize maximum size of elements a node can contain.  For the
+     *                   Flat layout, values between 8 and 32 usually
+     *                   provide the fastest searches.
+     * @param layout memory layout of the tree.
+     * @param sampleSize maximum number of points used in the Flat layout to
+     *                   select the split of each node.
+     * @return true if successful, false otherwise.
+     */
+    bool build(const int bucketSize,
+               const eLayoutType layout,
+               const int sampleSize = 256);
+
     /**
      * Rebuild the kd-Tree for all elements added with the add()
      * method and those already present in the tree, using the given
@@ -982,6 +1264,8 @@ namespace lti {
      * necessary since a kd-tree needs to know the complete set of
      * data for building.
      *  
+     * The new tree has the same layout as the previous one.
+     *
      * @param bucketSize maximum size of elements a node can contain (default
      *                   value is 1).
      * @return true if successful, false otherwise.
@@ -1012,6 +1296,29 @@ namespace lti {
      * The root node
      */
     node* root_;
+
+    /**
+     * Layout of the tree
+     */
+    eLayoutType layout_;
+
+    /**
+     * Nodes of the Flat layout in breadth-first order.  The first one is
+     * the root.
+     */
+    std::vector<flatNode> flatNodes_;
+
+    /**
+     * Coordinates of the points of the Flat layout.  Each row contains one
+     * dimension of all points, sorted by leaf.
+     */
+    matrix<value_type> flatPoints_;
+
+    /**
+     * Elements of the Flat layout, in the same order as the columns of
+     * flatPoints_.
+     */
+    std::vector<element*> flatElements_;
     
     /**
      * Number of levels in the tree
@@ -1075,7 +1382,8 @@ namespace lti {
      * @param elem the contents of the found point will be left here.
      * @return true if key was found, otherwise false.
      */
-    bool searchExactly(const node* nptr,const T& key,element& elem) const;
+    template<class N>
+    bool searchExactly(const N* nptr,const T& key,element& elem) const;
 
     /**
      * Search for all elements with exactly the given position in the
@@ -1093,7 +1401,8 @@ namespace lti {
      *              given keys
      * @return true if at least one key was found, otherwise false.
      */
-    bool searchExactly(const node* nptr,
+    template<class N>
+    bool searchExactly(const N* nptr,
                        const T& key,std::list<element>& elems) const;
 
 
@@ -1125,7 +1434,8 @@ namespace lti {
      *             searched for.
      * @param k number of elements you are looking for
      * @param key the point in the n-dimensional space you are looking for
-     * @param bounds hyperbox where the search is taking place
+     * @param context temporary data, with the hyperbox where the search is
+     *                taking place
      * @param neighbors contains the pointers to the found elements.  You
      *                  should NEVER delete these elements.  As multimap
      *                  it is always sorted after the "distance_typed" key,
@@ -1135,10 +1445,11 @@ namespace lti {
      * @return true if k elements were found, or false, if the tree contains
      *             less than k elements
      */
-    bool searchNearest(const node* nptr,
+    template<class N>
+    bool searchNearest(const N* nptr,
                        const int k,
                        const T& key,
-                       matrix<value_type>& bounds,
+                       searchContext& context,
                        mmap_type& neighbors) const;
 
     /**
@@ -1146,7 +1457,8 @@ namespace lti {
      * @param nptr pointer to the subtree where the elements need to be
      *             searched for.
      * @param key the point in the n-dimensional space you are looking for
-     * @param bounds hyperbox where the search is taking place
+     * @param context temporary data, with the hyperbox where the search is
+     *                taking place
      * @param neighbors contains the pointers to the found elements.  You
      *                  should NEVER delete these elements.  As multimap
      *                  it is always sorted after the "distance_typed" key,
@@ -1155,16 +1467,11 @@ namespace lti {
      * @param neighSize the number of the the neighbors found.
      * @return true if k elements were found, or false, if the tree contains
      *             less than k elements
-     *
-     * \warning This method is not thread safe.  In order to provide a
-     *          fast search mechanism for the nearest neighbor some
-     *          temporary variables are stored in the tree class itself,
-     *          and therefore it is not possible to search the
-     *          nearest neighbor in the same tree from different
-     *          threads.
      */
-    bool searchNearest(const node* nptr,
+    template<class N>
+    bool searchNearest(const N* nptr,
                        const T& key,
+                       searchContext& context,
                        std::pair<distance_type,element*>& neighbors) const;
 
     /**
@@ -1172,15 +1479,17 @@ namespace lti {
      * @param nptr pointer to the node root of the subtree to be evaluated
      * @param key the point in the n-dimensional space you are looking for
      * @param dist distance radius to search point in
-     * @param bounds hyperbox where the search is taking place
+     * @param context temporary data, with the hyperbox where the search is
+     *                taking place
      * @param elems contains pointers to the found elements
      * @return true if k elements were found, or false, if the tree contains
      *             less than k elements
      */
-    bool searchWithin(const node* nptr,
+    template<class N>
+    bool searchWithin(const N* nptr,
 		      const T& key,
 		      const distance_type& dist,
-		      matrix<value_type>& bounds,
+		      searchContext& context,
 		      std::list<element*>& elems) const;
 
     /**
@@ -1188,15 +1497,17 @@ namespace lti {
      * @param nptr pointer to the node root of the subtree to be evaluated
      * @param key the point in the n-dimensional space you are looking for
      * @param dist distance radius to search point in
-     * @param bounds hyperbox where the search is taking place
+     * @param context temporary data, with the hyperbox where the search is
+     *                taking place
      * @param elems contains pointers to the found elements
      * @return true if k elements were found, or false, if the tree contains
      *             less than k elements
      */
-    bool searchWithin(const node* nptr,
+    template<class N>
+    bool searchWithin(const N* nptr,
 		      const T& key,
 		      const distance_type& dist,
-		      matrix<value_type>& bounds,
+		      searchContext& context,
 		      mmap_type& neighbors) const;
 
     /**
@@ -1206,12 +1517,15 @@ namespace lti {
      *               building the lower limits of the bounding box.
      * @param boxMax point representing the highest values at each coordinate
      *               building the upper limits of the bounding box.
+     * @param bounds hyperbox where the search is taking place
      * @param neighbors list of pointer to the elements found until now.
      * @return true if completed.
      */
-    bool searchRange(const node* nptr,
+    template<class N>
+    bool searchRange(const N* nptr,
                      const T& boxMin,
                      const T& boxMax,
+                     matrix<value_type>& bounds,
                      std::list<element*>& neighbors) const;
 
     /**
@@ -1258,45 +1572,195 @@ namespace lti {
      *             searched for.
      * @param k number of elements you are looking for
      * @param key the point in the n-dimensional space you are looking for
+     * @param context temporary data, with the hyperbox where the search is
+     *                taking place
      * @param neighbors contains the pointers to the found elements.  You
      *                  should NEVER delete these elements.
      * @param emax maximum number of leaves to be visited.
      * @return true if k elements were found, or false, if the tree contains
      *             less than k elements
      */
-    bool searchBestBinFirst(const node* root,
+    template<class N>
+    bool searchBestBinFirst(const N* root,
                             const int k,
                             const T& key,
+                            searchContext& context,
                             mmap_type& neighbors,
                             const int emax) const;
 
-  private:
     /**
-     * @name searchNearest Temporary variables
+     * Initialize the bounds of a search with the bounds of the whole tree.
+     *
+     * Memory is only allocated if the size of \a bounds is not the one of
+     * the tree.
+     */
+    inline void initBounds(matrix<value_type>& bounds) const;
+
+    /**
+     * @name Access to the nodes of both layouts
      *
-     * The search of the nearest neighbors is optimized avoiding the
-     * creation of many temporary variables.  
+     * The recursive search methods are templates of the node type, which is
+     * kdTree::node for the Linked layout and kdTree::flatNode for the Flat
+     * one.  These methods give access to the children and the elements of
+     * both node types.
      */
     //@{
-    
+
+    /**
+     * Left child of an inner node
+     */
+    inline const node* leftChild(const node* nptr) const;
+
+    /**
+     * Right child of an inner node
+     */
+    inline const node* rightChild(const node* nptr) const;
+
+    /**
+     * Left child of an inner node
+     */
+    inline const flatNode* leftChild(const flatNode* nptr) const;
+
+    /**
+     * Right child of an inner node
+     */
+    inline const flatNode* rightChild(const flatNode* nptr) const;
+
     /**
-     * Minimum components of the bounding box.
-     * It shares the memory with the first row of boundsBox.
+     * Get the elements of a leaf.
+     *
+     * @param nptr the leaf
+     * @param elems pointer to the first element of the leaf, or null if
+     *              the leaf is empty
+     * @return the number of elements of the leaf
      */
-    mutable vector<value_type> minBounds_;
+    inline int leafElements(const node* nptr,element* const*& elems) const;
 
     /**
-     * Maximum components of the bounding box
-     * It shares the memory with the second row of boundsBox.
+     * Get the elements of a leaf.
+     *
+     * @param nptr the leaf
+     * @param elems pointer to the first element of the leaf, or null if
+     *              the leaf is empty
+     * @return the number of elements of the leaf
      */
-    mutable vector<value_type> maxBounds_;
+    inline int leafElements(const flatNode* nptr,element* const*& elems) const;
 
     /**
-     * Matrix containing the bounding box (first row min, second row max)
+     * Compute the distances between the key and all points of a leaf.
+     *
+     * @param nptr the leaf
+     * @param key the point in the n-dimensional space you are looking for
+     * @param context the distances are left in its distances_ attribute.
+     * @param elems pointer to the first element of the leaf, or null if
+     *              the leaf is empty
+     * @return the number of elements of the leaf
      */
-    mutable matrix<value_type> bounds_;
+    inline int leafDistances(const node* nptr,
+                             const T& key,
+                             searchContext& context,
+                             element* const*& elems) const;
+
+    /**
+     * Compute the distances between the key and all points of a leaf.
+     *
+     * The distances are accumulated dimension by dimension, which runs over
+     * contiguous memory in flatPoints_.
+     *
+     * @param nptr the leaf
+     * @param key the point in the n-dimensional space you are looking for
+     * @param context the distances are left in its distances_ attribute.
+     * @param elems pointer to the first element of the leaf, or null if
+     *              the leaf is empty
+     * @return the number of elements of the leaf
+     */
+    inline int leafDistances(const flatNode* nptr,
+                             const T& key,
+                             searchContext& context,
+                             element* const*& elems) const;
+
+    /**
+     * Root node of the Flat layout
+     */
+    inline const flatNode* flatRoot() const;
     //@}
 
+    /**
+     * Build the Flat layout with the elements in treePoints_.
+     */
+    void buildFlat(const int bucketSize,const int sampleSize);
+
+    /**
+     * Create a Linked subtree with copies of the elements in the given
+     * flat node.  It is used to write trees with Flat layout in the same
+     * format as Linked ones.
+     */
+    node* createLinkedNode(const flatNode& fnode) const;
+
+    /**
+     * Initialize the bounds of the whole tree for points of the given
+     * dimension.
+     */
+    void initTotalBounds(const int dim);
+
+    /**
+     * Delete all nodes and elements of the Flat layout
+     */
+    void clearFlat();
+
+    /**
+     * Search the given number of neighbors for each row of \a keys.  If
+     * emax is negative, an exact k nearest neighbors search is done,
+     * otherwise the best-bin-first search.
+     */
+    bool searchBatch(const int k,
+                     const matrix<value_type>& keys,
+                     const int emax,
+                     std::vector<mmap_type>& neighbors,
+                     const int numberOfThreads) const;
+
+    /**
+     * Job searching the neighbors of a range of keys in each task.
+     */
+    class batchJob : public threadPool::job {
+    public:
+      /**
+       * Constructor
+       */
+      batchJob(const kdTree<T,D,U>& tree,
+               const int k,
+               const matrix<value_type>& keys,
+               const int emax,
+               std::vector<mmap_type>& neighbors,
+               const int numTasks);
+
+      /**
+       * Search the neighbors of the keys corresponding to the task.
+       */
+      virtual void execute(const int task);
+
+      /**
+       * Number of keys of each task for which less than k neighbors were
+       * found.
+       */
+      std::vector<int> failures;
+
+    private:
+      const kdTree<T,D,U>& tree_;
+      const int k_;
+      const matrix<value_type>& keys_;
+      const int emax_;
+      std::vector<mmap_type>& neighbors_;
+      const int numTasks_;
+    };
+
+  private:
+    /**
+     * Search context used by the methods without context argument, which
+     * therefore are not thread safe.
+     */
+    mutable searchContext context_;
+
   };
 
 }
@@ -146,6 +146,15 @@ namespace lti {
     }
   }
 
+  //------------------------------------------------------------------
+  // kdTree::flatNode
+  //------------------------------------------------------------------
+
+  template <typename T, typename D, class U>
+  inline bool kdTree<T,D,U>::flatNode::isLeaf() const {
+    return (splitDim < 0);
+  }
+
   //------------------------------------------------------------------
   // kdTree
   //------------------------------------------------------------------
@@ -288,4 +297,99 @@ namespace lti {
     return true;
   }
 
+  template<class T,class D,class U>
+  inline const typename kdTree<T,D,U>::node*
+  kdTree<T,D,U>::leftChild(const node* nptr) const {
+    return nptr->left;
+  }
+
+  template<class T,class D,class U>
+  inline const typename kdTree<T,D,U>::node*
+  kdTree<T,D,U>::rightChild(const node* nptr) const {
+    return nptr->right;
+  }
+
+  template<class T,class D,class U>
+  inline const typename kdTree<T,D,U>::flatNode*
+  kdTree<T,D,U>::leftChild(const flatNode* nptr) const {
+    return &flatNodes_[nptr->first];
+  }
+
+  template<class T,class D,class U>
+  inline const typename kdTree<T,D,U>::flatNode*
+  kdTree<T,D,U>::rightChild(const flatNode* nptr) const {
+    return &flatNodes_[nptr->first+1];
+  }
+
+  template<class T,class D,class U>
+  inline const typename kdTree<T,D,U>::flatNode*
+  kdTree<T,D,U>::flatRoot() const {
+    return &flatNodes_[0];
+  }
+
+  template<class T,class D,class U>
+  inline int kdTree<T,D,U>::leafElements(const node* nptr,
+                                         element* const*& elems) const {
+    // an empty leaf (e.g. the root of an empty tree) has no first element
+    elems = nptr->points.empty() ? 0 : &nptr->points[0];
+    return static_cast<int>(nptr->points.size());
+  }
+
+  template<class T,class D,class U>
+  inline int kdTree<T,D,U>::leafElements(const flatNode* nptr,
+                                         element* const*& elems) const {
+    elems = (nptr->last > nptr->first) ? &flatElements_[nptr->first] : 0;
+    return nptr->last-nptr->first;
+  }
+
+  template<class T,class D,class U>
+  inline int kdTree<T,D,U>::leafDistances(const node* nptr,
+                                          const T& key,
+                                          searchContext& context,
+                                          element* const*& elems) const {
+    const int n = leafElements(nptr,elems);
+    if (context.distances_.size() < n) {
+      context.distances_.allocate(n);
+    }
+    distance_type* const dist = context.distances_.data();
+    for (int i=0;i<n;++i) {
+      dist[i]=distantor_(key,elems[i]->point);
+    }
+    return n;
+  }
+
+  template<class T,class D,class U>
+  inline int kdTree<T,D,U>::leafDistances(const flatNode* nptr,
+                                          const T& key,
+                                          searchContext& context,
+                                          element* const*& elems) const {
+    const int n = leafElements(nptr,elems);
+    if (n == 0) {
+      return 0; // no column nptr->first in flatPoints_
+    }
+    if (context.distances_.size() < n) {
+      context.distances_.allocate(n);
+    }
+    distance_type* const dist = context.distances_.data();
+    int i;
+    for (i=0;i<n;++i) {
+      dist[i]=distance_type(0);
+    }
+
+    // the points of the leaf are contiguous in each row of flatPoints_
+    const int dim = flatPoints_.rows();
+    for (int d=0;d<dim;++d) {
+      const value_type k = key[d];
+      const value_type* const row = &flatPoints_.at(d,nptr->first);
+      for (i=0;i<n;++i) {
+        distantor_.accumulate(row[i],k,dist[i]);
+      }
+    }
+
+    for (i=0;i<n;++i) {
+      dist[i]=distantor_.computeDistance(dist[i]);
+    }
+    return n;
+  }
+
 }
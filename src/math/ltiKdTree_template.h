@@ -57,6 +57,7 @@
 #undef max
 
 #include <limits>
+#include <algorithm>
 
 
 #ifdef _LTI_DEBUG
@@ -582,14 +583,14 @@ namespace lti {
   // default constructor
   template<typename T,typename D,class U>
   kdTree<T,D,U>::kdTree()
-    : container(),status(),root_(0),levels_(0),
+    : container(),status(),root_(0),layout_(Linked),levels_(0),
       numElements_(0),numAddedElements_(0),numLeaves_(0) {
   }
 
   // copy constructor
   template<typename T,typename D,class U>
   kdTree<T,D,U>::kdTree(const kdTree<T,D,U>& other) 
-    : container(),status(),root_(0),levels_(0),
+    : container(),status(),root_(0),layout_(Linked),levels_(0),
       numElements_(0),numAddedElements_(0),numLeaves_(0) {
     copy(other);
   }
@@ -603,7 +604,7 @@ namespace lti {
   // copy member
   template<typename T,typename D,class U>
   bool kdTree<T,D,U>::empty() const {
-    return (isNull(root_));
+    return (isNull(root_) && flatNodes_.empty());
   }
 
   /*
@@ -624,7 +625,7 @@ namespace lti {
    */
   template<typename T,typename D,class U>
   int kdTree<T,D,U>::getNumberOfLeaves() const {
-    if (isNull(root_)) {
+    if (empty()) {
       return 0;
     } else {
       return numLeaves_;
@@ -636,7 +637,7 @@ namespace lti {
    */
   template<typename T,typename D,class U>
   int kdTree<T,D,U>::getNumberOfLevels() const {
-    if (isNull(root_)) {
+    if (empty()) {
       return 0;
     } else {
       return levels_;
@@ -651,6 +652,14 @@ namespace lti {
       return root_;
   }
 
+  /*
+   * get the memory layout of the tree
+   */
+  template<typename T, typename D, class U>
+  typename kdTree<T,D,U>::eLayoutType kdTree<T,D,U>::getLayout() const {
+    return layout_;
+  }
+
 
   // copy member
   template<typename T,typename D,class U>
@@ -662,13 +671,13 @@ namespace lti {
 
     if (notNull(root_)) {
 
-      if (!other.empty()) {
+      if (notNull(other.root_)) {
         root_->copy(*other.root_);
       }
 
     } else {
 
-      if (!other.empty()) {
+      if (notNull(other.root_)) {
         root_ = other.root_->clone();
       }
 
@@ -687,12 +696,17 @@ namespace lti {
       }
     }
 
-    totalBounds_.copy(other.totalBounds_);
-    bounds_.copy(totalBounds_);
-    minBounds_.useExternData(bounds_.columns(),bounds_.data());
-    maxBounds_.useExternData(bounds_.columns(),&bounds_.at(1,0));
+    // the flat layout
+    flatNodes_ = other.flatNodes_;
+    flatPoints_.copy(other.flatPoints_);
+    flatElements_.resize(other.flatElements_.size());
+    for (unsigned int i=0;i<flatElements_.size();++i) {
+      flatElements_[i] = other.flatElements_[i]->clone();
+    }
 
+    totalBounds_.copy(other.totalBounds_);
 
+    layout_ = other.layout_;
     levels_ = other.levels_;
     numElements_ = other.numElements_;
     numAddedElements_ = other.numAddedElements_;
@@ -731,6 +745,7 @@ namespace lti {
     // delete all nodes
     delete root_;
     root_=0;
+    clearFlat();
 
     // delete unassigned data nodes
     typename std::list<element*>::iterator it,eit;
@@ -769,6 +784,11 @@ namespace lti {
     b = b && handler.writeBegin(); // data in the nodes   |
     if (notNull(root_)) {                         //  |    |
       b = b && root_->write(handler,false);       //  |    |
+    } else if (!flatNodes_.empty()) {             //  |    |
+      // flat trees are written as linked ones    //  |    |
+      node* tmp = createLinkedNode(flatNodes_[0]);//  |    |
+      b = b && tmp->write(handler,false);         //  |    |
+      delete tmp;                                 //  |    |
     }                                            //  |    |
                                                  //  |    |
     b = b && handler.writeEnd();   // data in the nodes   |
@@ -819,38 +839,7 @@ namespace lti {
     // restore the sizes for the rest of the internal data
 
     if (numElements_ > 0) {
-      totalBounds_.allocate(2,dim);
-
-      if (std::numeric_limits<value_type>::is_integer) {
-        // initialize the mins with max
-        totalBounds_.getRow(1).fill(std::numeric_limits<value_type>::max());
-        
-        value_type tmp = std::numeric_limits<value_type>::min();
-        
-        if (tmp == 0) {
-          // initialize the maxs with min --> unsigned types 
-          totalBounds_.getRow(0).fill(tmp);
-        } else {
-          // initialize the maxs with min
-          // don't use the absolute minimum:  it cannot be negated and can
-          // produce arithmetic errors
-          totalBounds_.getRow(0).fill(-std::numeric_limits<value_type>::max());
-        }
-      
-
-      } else {
-        // floating point types
-        value_type tmp = sqrt(std::numeric_limits<value_type>::max());
-        // initialize the mins with max
-        totalBounds_.getRow(1).fill(tmp);
-        // initialize the maxs with min
-        totalBounds_.getRow(0).fill(-tmp);
-      }
-
-      // resize the temporal bounds and indicate memory sharing...
-      bounds_.copy(totalBounds_);
-      minBounds_.useExternData(bounds_.columns(),bounds_.data());
-      maxBounds_.useExternData(bounds_.columns(),&bounds_.at(1,0));
+      initTotalBounds(dim);
     }
 
     return b;
@@ -870,7 +859,7 @@ namespace lti {
     }
 
     if (treePoints_.empty()) {
-      if (isNull(root_)) {
+      if (empty()) {
         setStatusString("no data added to kdTree when trying to rebuild\n");
         return false;
       } else {
@@ -892,9 +881,16 @@ namespace lti {
       delete root_;
       root_=0;
       numAddedElements_+=numElements_;
+    } else if (!flatElements_.empty()) {
+      // the elements of the flat layout can be moved to the new tree
+      treePoints_.insert(treePoints_.end(),
+                         flatElements_.begin(),flatElements_.end());
+      flatElements_.clear();
+      clearFlat();
+      numAddedElements_+=numElements_;
     }
 
-    return build(bucketSize);
+    return build(bucketSize,layout_);
   }
 
   template<typename T,typename D,class U>
@@ -912,6 +908,8 @@ namespace lti {
     //reset
     delete root_;
     root_=0;
+    clearFlat();
+    layout_=Linked;
     numLeaves_=0;
     levels_=0;
     numElements_=numAddedElements_;
@@ -925,6 +923,207 @@ namespace lti {
     // be deleted twice
     treePoints_.clear();
 
+    initTotalBounds(dim);
+
+    return true;
+  }
+
+
+  template<typename T,typename D,class U>
+  bool kdTree<T,D,U>::build(const int bucketSize,
+                            const eLayoutType layout,
+                            const int sampleSize) {
+    if (layout == Linked) {
+      return build(bucketSize);
+    }
+
+    if ((bucketSize<1) || (sampleSize<1)) {
+      return false;
+    }
+
+    if (treePoints_.empty()) {
+      setStatusString("no data added to kdTree when trying to build\n");
+      return false;
+    }
+
+    //reset
+    delete root_;
+    root_=0;
+    clearFlat();
+    layout_=Flat;
+    numLeaves_=0;
+    levels_=0;
+    numElements_=numAddedElements_;
+    numAddedElements_=0;
+
+    const int dim = treePoints_.front()->size();
+    buildFlat(bucketSize,sampleSize);
+    initTotalBounds(dim);
+
+    return true;
+  }
+
+  template<typename T,typename D,class U>
+  void kdTree<T,D,U>::buildFlat(const int bucketSize,const int sampleSize) {
+    // the elements are transfered from treePoints_ to the flat layout
+    std::vector<element*>& elems = flatElements_;
+    elems.assign(treePoints_.begin(),treePoints_.end());
+    treePoints_.clear();
+
+    const int n = static_cast<int>(elems.size());
+    const int dim = elems.front()->size();
+
+    // type for squares
+    typedef typename typeInfo<value_type>::square_accumulation_type
+      sqrType;
+    vector<sqrType> sum(dim);
+    vector<sqrType> var(dim);
+    std::vector<value_type> sample;
+    sample.reserve(min(n,sampleSize));
+
+    flatNode root;
+    root.splitDim = -1;
+    root.partition = value_type();
+    root.first = 0;
+    root.last = n;
+    flatNodes_.push_back(root);
+
+    // the nodes are split level by level, so that the children are
+    // appended to the array in breadth-first order.  The leaves keep the
+    // range of their elements in first and last.
+    int levelBegin = 0;
+    int levelEnd = 1;
+    int i,j,d;
+    while (levelBegin < levelEnd) {
+      ++levels_;
+      for (i=levelBegin;i<levelEnd;++i) {
+        const int first = flatNodes_[i].first;
+        const int last = flatNodes_[i].last;
+        const int m = last-first;
+        if (m <= bucketSize) {
+          ++numLeaves_;
+          continue;
+        }
+
+        // sample of the points of this node, equally spaced in the range
+        const int s = min(m,sampleSize);
+
+        // dimension with the highest variance in the sample (m x variance)
+        sum.fill(sqrType(0));
+        var.fill(sqrType(0));
+        for (j=0;j<s;++j) {
+          const T& pt = elems[first+static_cast<int>((double(j)*m)/s)]->point;
+          for (d=0;d<dim;++d) {
+            const sqrType tmp = static_cast<sqrType>(pt[d]);
+            sum.at(d)+=tmp;
+            var.at(d)+=(tmp*tmp);
+          }
+        }
+        int splitDim = 0;
+        sqrType mx = var.at(0)-(sum.at(0)*sum.at(0)/s);
+        for (d=1;d<dim;++d) {
+          const sqrType tmp = var.at(d)-(sum.at(d)*sum.at(d)/s);
+          if (tmp>mx) {
+            splitDim=d;
+            mx=tmp;
+          }
+        }
+
+        // median of the sample at the split dimension
+        sample.clear();
+        for (j=0;j<s;++j) {
+          sample.push_back(
+            elems[first+static_cast<int>((double(j)*m)/s)]->point[splitDim]);
+        }
+        std::nth_element(sample.begin(),sample.begin()+s/2,sample.end());
+        const value_type p = sample[s/2];
+
+        // three way partition: [first,lt) < p, [lt,gt) == p, [gt,last) > p
+        int lt = first;
+        int gt = last;
+        j = first;
+        while (j<gt) {
+          const value_type v = elems[j]->point[splitDim];
+          if (v < p) {
+            std::swap(elems[lt],elems[j]);
+            ++lt;
+            ++j;
+          } else if (v > p) {
+            --gt;
+            std::swap(elems[j],elems[gt]);
+          } else {
+            ++j;
+          }
+        }
+
+        // the points equal to the partition value are assigned so that
+        // both children get similar numbers of points.  Since p is one of
+        // the points, both children get at least one.
+        const int half = first+m/2;
+        const int mid = (lt < half) ? min(half,gt) : lt;
+
+        flatNode child;
+        child.splitDim = -1;
+        child.partition = value_type();
+        child.first = first;
+        child.last = mid;
+
+        flatNode& nd = flatNodes_[i];
+        nd.splitDim = splitDim;
+        nd.partition = p;
+        nd.first = static_cast<int>(flatNodes_.size());
+        nd.last = 0;
+
+        // nd must not be used after this, since push_back can reallocate
+        flatNodes_.push_back(child);
+        child.first = mid;
+        child.last = last;
+        flatNodes_.push_back(child);
+      }
+      levelBegin = levelEnd;
+      levelEnd = static_cast<int>(flatNodes_.size());
+    }
+
+    // coordinates of the points, sorted by leaf
+    flatPoints_.allocate(dim,n);
+    for (j=0;j<n;++j) {
+      const T& pt = elems[j]->point;
+      for (d=0;d<dim;++d) {
+        flatPoints_.at(d,j) = pt[d];
+      }
+    }
+  }
+
+  template<typename T,typename D,class U>
+  void kdTree<T,D,U>::clearFlat() {
+    typename std::vector<element*>::iterator it;
+    for (it=flatElements_.begin();it!=flatElements_.end();++it) {
+      delete (*it);
+    }
+    flatElements_.clear();
+    flatNodes_.clear();
+    flatPoints_.clear();
+  }
+
+  template<typename T,typename D,class U>
+  typename kdTree<T,D,U>::node*
+  kdTree<T,D,U>::createLinkedNode(const flatNode& fnode) const {
+    node* nptr = new node;
+    if (fnode.isLeaf()) {
+      for (int i=fnode.first;i<fnode.last;++i) {
+        nptr->add(flatElements_[i]->clone());
+      }
+    } else {
+      nptr->splitDim = fnode.splitDim;
+      nptr->partition = fnode.partition;
+      nptr->left = createLinkedNode(flatNodes_[fnode.first]);
+      nptr->right = createLinkedNode(flatNodes_[fnode.first+1]);
+    }
+    return nptr;
+  }
+
+  template<typename T,typename D,class U>
+  void kdTree<T,D,U>::initTotalBounds(const int dim) {
     // initialize the bounds
     // this is somehow tricky.  The distances will be manipulated as square
     // values of euclidean distances.  For integer values, this can easily
@@ -959,16 +1158,8 @@ namespace lti {
       // initialize the maxs with min
       totalBounds_.getRow(0).fill(-tmp);
     }
-
-    // resize the temporal bounds and indicate memory sharing...
-    bounds_.copy(totalBounds_);
-    minBounds_.useExternData(bounds_.columns(),bounds_.data());
-    maxBounds_.useExternData(bounds_.columns(),&bounds_.at(1,0));
-
-    return true;
   }
 
-
   template<typename T,typename D,class U>
   void kdTree<T,D,U>::getDataInSubtree(node* nodePtr,
                                      std::list<element*>& data) const {
@@ -1004,35 +1195,46 @@ namespace lti {
    */
   template<typename T,typename D,class U>
   bool kdTree<T,D,U>::searchExactly(const T& key,element& elem) const {
-    if (notNull(root_)) {
+    if (layout_ == Flat) {
+      return !empty() && searchExactly(flatRoot(),key,elem);
+    } else if (notNull(root_)) {
       return searchExactly(root_,key,elem);
     }
     return false;
   }
 
   template<typename T,typename D,class U>
-  bool kdTree<T,D,U>::searchExactly(const node* nptr,
+  template<class N>
+  bool kdTree<T,D,U>::searchExactly(const N* nptr,
                                   const T& key,element& elem) const {
     if (nptr->isLeaf()) {
       // linearly search for the key in the contained points.
-      return nptr->getPoint(key,elem);
+      element* const* leaf;
+      const int n = leafElements(nptr,leaf);
+      for (int i=0;i<n;++i) {
+        if (leaf[i]->point == key) {
+          elem=*leaf[i];
+          return true;
+        }
+      }
+      return false;
     } else {
-      if ((key[nptr->splitDim]<nptr->partition) && (notNull(nptr->left))) {
+      if ((key[nptr->splitDim]<nptr->partition) && (notNull(leftChild(nptr)))) {
         // if at all there, the key must be on the left subtree
-        return searchExactly(nptr->left,key,elem);
+        return searchExactly(leftChild(nptr),key,elem);
       } 
       else if ((key[nptr->splitDim]>nptr->partition) && 
-               (notNull(nptr->right))) {
+               (notNull(rightChild(nptr)))) {
         // if at all there, the key must be on the right subtree
-        return searchExactly(nptr->right,key,elem);
+        return searchExactly(rightChild(nptr),key,elem);
       } 
       else if (key[nptr->splitDim]==nptr->partition) {
         // the key can be in any subtree, so we need to look for it everywhere
-        if (notNull(nptr->left) && (searchExactly(nptr->left,key,elem))) {
+        if (notNull(leftChild(nptr)) && (searchExactly(leftChild(nptr),key,elem))) {
           return true;
         }
         
-        if (notNull(nptr->right) && (searchExactly(nptr->right,key,elem))) {
+        if (notNull(rightChild(nptr)) && (searchExactly(rightChild(nptr),key,elem))) {
           return true;
         }
       }
@@ -1045,39 +1247,51 @@ namespace lti {
   bool kdTree<T,D,U>::searchExactly(const T& key,
                                   std::list<element>& elem) const {
     elem.clear();
-    if (notNull(root_)) {
+    if (layout_ == Flat) {
+      return !empty() && searchExactly(flatRoot(),key,elem);
+    } else if (notNull(root_)) {
       return searchExactly(root_,key,elem);
     }
     return false;
   }
 
   template<typename T,typename D,class U>
-  bool kdTree<T,D,U>::searchExactly(const node* nptr,
+  template<class N>
+  bool kdTree<T,D,U>::searchExactly(const N* nptr,
                                     const T& key,
                                     std::list<element>& elem) const {
     if (nptr->isLeaf()) {
       // linearly search for the key in the contained points.
-      return nptr->getPoint(key,elem);
+      element* const* leaf;
+      const int n = leafElements(nptr,leaf);
+      bool found=false;
+      for (int i=0;i<n;++i) {
+        if (leaf[i]->point == key) {
+          elem.push_back(*leaf[i]);
+          found=true;
+        }
+      }
+      return found;
     } else {
-      if ((key[nptr->splitDim]<nptr->partition) && (notNull(nptr->left))) {
+      if ((key[nptr->splitDim]<nptr->partition) && (notNull(leftChild(nptr)))) {
         // if at all there, the key must be on the left subtree
-        return searchExactly(nptr->left,key,elem);
+        return searchExactly(leftChild(nptr),key,elem);
       } 
       else if ((key[nptr->splitDim]>nptr->partition) && 
-               (notNull(nptr->right))) {
+               (notNull(rightChild(nptr)))) {
         // if at all there, the key must be on the right subtree
-        return searchExactly(nptr->right,key,elem);
+        return searchExactly(rightChild(nptr),key,elem);
       } 
       else if (key[nptr->splitDim]==nptr->partition) {
         // the key can be in any subtree, so we need to look for it everywhere
         bool res(false);
-        if (notNull(nptr->left)) {
-          res = searchExactly(nptr->left,key,elem);
+        if (notNull(leftChild(nptr))) {
+          res = searchExactly(leftChild(nptr),key,elem);
         }
         
-        if (notNull(nptr->right)) {
+        if (notNull(rightChild(nptr))) {
           // first search the other node, and after that compute res...
-          res = searchExactly(nptr->right,key,elem) || res;
+          res = searchExactly(rightChild(nptr),key,elem) || res;
         }
         return res;
       }   
@@ -1086,40 +1300,55 @@ namespace lti {
   }
 
   /*
-   * search for the nearest element in the tree to the given key point.
-   *
-   * If found, the contents of the element will by copied in the 
-   * elem parameters and true will be returned.   Otherwise false will
-   * be returned.
-   * @param key point in the n-dimensional space you are looking for.
-   * @param elem the contents of the found point will be left here.
-   * @return true if key was found, otherwise false (i.e. tree empty).
+   * initialize the bounds of a search with the bounds of the whole tree
    */
   template<typename T,typename D,class U>
-  bool kdTree<T,D,U>::searchNearest(const T& key,element*& elem) const {
+  inline void kdTree<T,D,U>::initBounds(matrix<value_type>& bounds) const {
+    if (bounds.size() != totalBounds_.size()) {
+      bounds.copy(totalBounds_);
+      return;
+    }
+
+    // the fastest contents copy between the two matrices is required here!
+    // without resize (to avoid new memory allocation).
+    // use pointer arithmetic.
+    // is is equivalent to bounds.fill(totalBounds_), but avoiding
+    // many (here) unnecessary boundary checks.
+    const value_type *pt,*pe;
+    value_type *p;
+    for (pt=totalBounds_.data(),
+           pe=&totalBounds_.at(1,totalBounds_.lastColumn()),
+           p=bounds.data();
+         pt<=pe;++pt,++p) {
+      (*p)=(*pt);
+    }
+  }
+
+  /*
+   * search for the nearest element in the tree to the given key point,
+   * using the temporary data of the given context.
+   */
+  template<typename T,typename D,class U>
+  bool kdTree<T,D,U>::searchNearest(const T& key,
+                                    element*& elem,
+                                    distance_type& dist,
+                                    searchContext& context) const {
     elem = 0;
-    if (notNull(root_)) {
-      // the fastest contents copy between the two matrices is required here!
-      // without resize (to avoid new memory allocation).
-      // use pointer arithmetic.
-      // is is equivalent to bounds_.fill(totalBounds_), but avoiding
-      // many (here) unnecessary boundary checks.
-      const value_type *pt,*pe;
-      value_type *p;
-      for (pt=totalBounds_.data(),
-             pe=&totalBounds_.at(1,maxBounds_.lastIdx()),
-             p=minBounds_.data()
-             ;pt<=pe;++pt,++p) {
-        (*p)=(*pt);
-      }
+    if (!empty()) {
+      initBounds(context.bounds_);
 
       // clear old data
       std::pair<distance_type,element*> 
         neigh(std::numeric_limits<distance_type>::max(),
               static_cast<element*>(0));
-      searchNearest(root_,key,neigh);
+      if (layout_ == Flat) {
+        searchNearest(flatRoot(),key,context,neigh);
+      } else {
+        searchNearest(root_,key,context,neigh);
+      }
       if (notNull(neigh.second)) {
         elem=neigh.second;
+        dist=neigh.first;
         return true; // one neighbor is always found
       }
     }
@@ -1127,6 +1356,22 @@ namespace lti {
     return false;
   }
 
+  /*
+   * search for the nearest element in the tree to the given key point.
+   *
+   * If found, the contents of the element will by copied in the 
+   * elem parameters and true will be returned.   Otherwise false will
+   * be returned.
+   * @param key point in the n-dimensional space you are looking for.
+   * @param elem the contents of the found point will be left here.
+   * @return true if key was found, otherwise false (i.e. tree empty).
+   */
+  template<typename T,typename D,class U>
+  bool kdTree<T,D,U>::searchNearest(const T& key,element*& elem) const {
+    distance_type dist;
+    return searchNearest(key,elem,dist,context_);
+  }
+
   /*
    * search for the nearest element in the tree to the given key point.
    *
@@ -1141,35 +1386,7 @@ namespace lti {
   bool kdTree<T,D,U>::searchNearest(const T& key,
                                     element*& elem,
                                     distance_type& dist) const {
-    elem = 0;
-    if (notNull(root_)) {
-      // the fastest contents copy between the two matrices is required here!
-      // without resize (to avoid new memory allocation).
-      // use pointer arithmetic.
-      // is is equivalent to bounds_.fill(totalBounds_), but avoiding
-      // many (here) unnecessary boundary checks.
-      const value_type *pt,*pe;
-      value_type *p;
-      for (pt=totalBounds_.data(),
-             pe=&totalBounds_.at(1,maxBounds_.lastIdx()),
-             p=minBounds_.data();
-           pt<=pe;++pt,++p) {
-        (*p)=(*pt);
-      }
-
-      // clear old data
-      std::pair<distance_type,element*> 
-        neigh(std::numeric_limits<distance_type>::max(),
-              static_cast<element*>(0));
-      searchNearest(root_,key,neigh);
-      if (notNull(neigh.second)) {
-        elem=neigh.second;
-        dist=neigh.first;
-        return true; // one neighbor is always found
-      }
-    }
-
-    return false;
+    return searchNearest(key,elem,dist,context_);
   }
 
   /*
@@ -1184,33 +1401,12 @@ namespace lti {
    */
   template<typename T,typename D,class U>
   bool kdTree<T,D,U>::searchNearest(const T& key,element& elem) const {
-
-    if (notNull(root_)) {
-      // the fastest contents copy between the two matrices is required here!
-      // without resize (to avoid new memory allocation).
-      // use pointer arithmetic.
-      // is is equivalent to bounds_.fill(totalBounds_), but avoiding
-      // many (here) unnecessary boundary checks.
-      const value_type *pt,*pe;
-      value_type *p;
-      for (pt=totalBounds_.data(),
-             pe=&totalBounds_.at(1,maxBounds_.lastIdx()),
-             p=minBounds_.data();
-           pt<=pe;++pt,++p) {
-        (*p)=(*pt);
-      }
-
-      // clear old data
-      std::pair<distance_type,element*> 
-        neigh(std::numeric_limits<distance_type>::max(),
-              static_cast<element*>(0));
-      searchNearest(root_,key,neigh);
-      if (notNull(neigh.second)) {
-        elem=*(neigh.second);
-        return true; // one neighbor is always found
-      }
+    element* ptr;
+    distance_type dist;
+    if (searchNearest(key,ptr,dist,context_)) {
+      elem=*ptr;
+      return true;
     }
-
     return false;
   }
 
@@ -1228,34 +1424,11 @@ namespace lti {
   bool kdTree<T,D,U>::searchNearest(const T& key,
                                     element& elem,
                                     distance_type& dist) const {
-
-    if (notNull(root_)) {
-      // the fastest contents copy between the two matrices is required here!
-      // without resize (to avoid new memory allocation).
-      // use pointer arithmetic.
-      // is is equivalent to bounds_.fill(totalBounds_), but avoiding
-      // many (here) unnecessary boundary checks.
-      const value_type *pt,*pe;
-      value_type *p;
-      for (pt=totalBounds_.data(),
-             pe=&totalBounds_.at(1,maxBounds_.lastIdx()),
-             p=minBounds_.data();
-           pt<=pe;++pt,++p) {
-        (*p)=(*pt);
-      }
-
-      // clear old data
-      std::pair<distance_type,element*> 
-        neigh(std::numeric_limits<distance_type>::max(),
-              static_cast<element*>(0));
-      searchNearest(root_,key,neigh);
-      if (notNull(neigh.second)) {
-        elem=*(neigh.second);
-        dist=  neigh.first;
-        return true; // one neighbor is always found
-      }
+    element* ptr;
+    if (searchNearest(key,ptr,dist,context_)) {
+      elem=*ptr;
+      return true;
     }
-
     return false;
   }
 
@@ -1271,33 +1444,12 @@ namespace lti {
    */
   template<typename T,typename D,class U>
   bool kdTree<T,D,U>::searchNearest(const T& key,D& data) const {
-
-    if (notNull(root_)) {
-      // the fastest contents copy between the two matrices is required here!
-      // without resize (to avoid new memory allocation).
-      // use pointer arithmetic.
-      // is is equivalent to bounds_.fill(totalBounds_), but avoiding
-      // many (here) unnecessary boundary checks.
-      const value_type *pt,*pe;
-      value_type *p;
-      for (pt=totalBounds_.data(),
-             pe=&totalBounds_.at(1,maxBounds_.lastIdx()),
-             p=minBounds_.data();
-           pt<=pe;++pt,++p) {
-        (*p)=(*pt);
-      }
-
-      // clear old data
-      std::pair<distance_type,element*> 
-        neigh(std::numeric_limits<distance_type>::max(),
-              static_cast<element*>(0));
-      searchNearest(root_,key,neigh);
-      if (notNull(neigh.second)) {
-        data=(neigh.second)->data;
-        return true; // one neighbor is always found
-      }
+    element* ptr;
+    distance_type dist;
+    if (searchNearest(key,ptr,dist,context_)) {
+      data=ptr->data;
+      return true;
     }
-
     return false;
   }
 
@@ -1318,8 +1470,9 @@ namespace lti {
     // clear all data
     neighbors.clear();
 
-    if (notNull(root_) && (k<=numElements_)) {
-      matrix<value_type> bounds(totalBounds_);
+    if (!empty() && (k<=numElements_)) {
+      searchContext context;
+      initBounds(context.bounds_);
 
       // clear old data
       mmap_type neigh;
@@ -1331,7 +1484,11 @@ namespace lti {
         ++nsize;
       }
 
-      searchNearest(root_,k,key,bounds,neigh);
+      if (layout_ == Flat) {
+        searchNearest(flatRoot(),k,key,context,neigh);
+      } else {
+        searchNearest(root_,k,key,context,neigh);
+      }
       typename mmap_type::iterator it;
       for (it=neigh.begin();it!=neigh.end();++it) {
         if (notNull((*it).second)) {
@@ -1361,12 +1518,26 @@ namespace lti {
   kdTree<T,D,U>::searchNearest(const int k,
                           const T& key,
                           mmap_type& neigh) const {
+    searchContext context;
+    return searchNearest(k,key,neigh,context);
+  }
+
+  /*
+   * search for the nearest k elements in the tree to the given key point,
+   * using the temporary data of the given context.
+   */
+  template<typename T,typename D,class U>
+  bool 
+  kdTree<T,D,U>::searchNearest(const int k,
+                               const T& key,
+                               mmap_type& neigh,
+                               searchContext& context) const {
 
     // clear old data
     neigh.clear();
 
-    if (notNull(root_) && (k<=numElements_)) {
-      matrix<value_type> bounds(totalBounds_);
+    if (!empty() && (k<=numElements_)) {
+      initBounds(context.bounds_);
 
       int nsize(0);
       while (nsize<k) {
@@ -1375,7 +1546,9 @@ namespace lti {
         ++nsize;
       }
 
-      return searchNearest(root_,k,key,bounds,neigh);
+      return ((layout_ == Flat) ?
+              searchNearest(flatRoot(),k,key,context,neigh) :
+              searchNearest(root_,k,key,context,neigh));
     }
 
     return false;
@@ -1390,9 +1563,12 @@ namespace lti {
                                    const distance_type& dist,
                                    std::list<element*>& elems) const {
     elems.clear();
-    if (notNull(root_)){
-      matrix<value_type> bounds(totalBounds_);
-      return searchWithin(root_, key, dist, bounds, elems);
+    if (!empty()) {
+      searchContext context;
+      initBounds(context.bounds_);
+      return ((layout_ == Flat) ?
+              searchWithin(flatRoot(), key, dist, context, elems) :
+              searchWithin(root_, key, dist, context, elems));
     }
     return false;
 
@@ -1407,9 +1583,12 @@ namespace lti {
                       const distance_type& dist,
                       mmap_type& neighbors) const {
     neighbors.clear();
-    if (notNull(root_)){
-      matrix<value_type> bounds(totalBounds_);
-      return searchWithin(root_, key, dist, bounds, neighbors);
+    if (!empty()) {
+      searchContext context;
+      initBounds(context.bounds_);
+      return ((layout_ == Flat) ?
+              searchWithin(flatRoot(), key, dist, context, neighbors) :
+              searchWithin(root_, key, dist, context, neighbors));
     }
     return false;
   }
@@ -1424,31 +1603,31 @@ namespace lti {
    *             less than k elements
    */
   template<typename T,typename D,class U>
+  template<class N>
   bool 
-  kdTree<T,D,U>::searchNearest(const node* nptr,
+  kdTree<T,D,U>::searchNearest(const N* nptr,
                       const int k,
                       const T& key,
-                      matrix<value_type>& bounds,
+                      searchContext& context,
                       mmap_type& neighbors) const {
+    matrix<value_type>& bounds = context.bounds_;
     
     // if this is a leaf, elements should be inserted in neighbors...
     if (nptr->isLeaf()) {
       // examine records in bucket, and update the neighbors map if necessary
-      typename node::points_type::const_iterator it,eit;
-      distance_type d;
+      element* const* leaf;
+      const int n = leafDistances(nptr,key,context,leaf);
+      const distance_type* const dist = context.distances_.data();
 
-      _lti_debug3("In leave with size: " << nptr->points.size() << "\n");
+      _lti_debug3("In leave with size: " << n << "\n");
       _lti_debug4("highest distance in neighbors: " << (neighbors.rbegin())->first << "\n");
-      _lti_debug4("key: " << key << "\n");
-
-      for (it=nptr->points.begin(),eit=nptr->points.end();it!=eit;++it) {
+      for (int i=0;i<n;++i) {
         // if neighbors have too few elements or if the farest
         // nearest element have a greater distance than the actual
         // element then insert the elements in the map
-        _lti_debug4("current point: " << (*it)->point << "\n");
-        _lti_debug4("distance: " << distantor_(key,(*it)->point) << "\n");
-        if ((neighbors.rbegin())->first > 
-            (d=distantor_(key,(*it)->point))) {
+        _lti_debug4("current point: " << leaf[i]->point << "\n");
+        _lti_debug4("distance: " << dist[i] << "\n");
+        if ((neighbors.rbegin())->first > dist[i]) {
           
           // delete the last one
           typename mmap_type::iterator mit;
@@ -1463,9 +1642,9 @@ namespace lti {
 #         endif
           neighbors.erase(mit);
 
-          _lti_debug3("Inserting " << (*it)->point << std::endl);
+          _lti_debug3("Inserting " << leaf[i]->point << std::endl);
           // insert one element
-          neighbors.insert(std::make_pair(d,(*it)));
+          neighbors.insert(std::make_pair(dist[i],leaf[i]));
         }
       }
 
@@ -1490,7 +1669,7 @@ namespace lti {
       tmp=boxMax;
       boxMax=p;
       _lti_debug3("Searching closer son left" << std::endl);
-      if (searchNearest(nptr->left,k,key,bounds,neighbors)) {
+      if (searchNearest(leftChild(nptr),k,key,context,neighbors)) {
         _lti_debug3("done." << std::endl);
         boxMax=tmp;
         return true;
@@ -1504,7 +1683,7 @@ namespace lti {
                                         bounds,
                                         (neighbors.rbegin())->first)) {
         _lti_debug3("Searching farther son right" << std::endl);
-        if (searchNearest(nptr->right,k,key,bounds,neighbors)) {
+        if (searchNearest(rightChild(nptr),k,key,context,neighbors)) {
           boxMin=tmp;
           _lti_debug3("done." << std::endl);
           return true;
@@ -1522,7 +1701,7 @@ namespace lti {
       tmp=boxMin;
       boxMin=p;
       _lti_debug3("Searching closer son right" << std::endl);
-      if (searchNearest(nptr->right,k,key,bounds,neighbors)) {
+      if (searchNearest(rightChild(nptr),k,key,context,neighbors)) {
         boxMin=tmp;
         _lti_debug3("done." << std::endl);
         return true;
@@ -1538,7 +1717,7 @@ namespace lti {
                                         (neighbors.rbegin())->first)) {
 
         _lti_debug3("Searching farther son left" << std::endl);
-        if (searchNearest(nptr->left,k,key,bounds,neighbors)) {
+        if (searchNearest(leftChild(nptr),k,key,context,neighbors)) {
           boxMax=tmp;
           _lti_debug3("done." << std::endl);
           return true;
@@ -1564,44 +1743,47 @@ namespace lti {
    *             less than k elements
    */
   template<typename T,typename D,class U>
+  template<class N>
   bool 
-  kdTree<T,D,U>::searchNearest(const node* nptr,
+  kdTree<T,D,U>::searchNearest(const N* nptr,
                              const T& key,
+                             searchContext& context,
                              std::pair<distance_type,element*>& neighbors) const {
+    matrix<value_type>& bounds = context.bounds_;
 
     // if this is a leaf, elements should be inserted in neighbors...
     if (nptr->isLeaf()) {
       // examine records in bucket, and update the neighbors map if necessary
-      typename node::points_type::const_iterator it,eit;
-      distance_type d;
+      element* const* leaf;
+      const int n = leafDistances(nptr,key,context,leaf);
+      const distance_type* const dist = context.distances_.data();
 
-      for (it=nptr->points.begin(),eit=nptr->points.end();it!=eit;++it) {
+      for (int i=0;i<n;++i) {
         // if neighbors have too few elements or if the farest
         // nearest element have a greater distance than the actual
         // element then insert the elements in the map
-        if (neighbors.first > (d=distantor_(key,(*it)->point))) {
+        if (neighbors.first > dist[i]) {
           
-          _lti_debug3("Updating " << (*it)->point << std::endl);
+          _lti_debug3("Updating " << leaf[i]->point << std::endl);
           // insert one element
-          neighbors.first=d;
-          neighbors.second=(*it);
+          neighbors.first=dist[i];
+          neighbors.second=leaf[i];
         }
       }
 
       // check "hypersphere within bounds"
       return (checkHypersphereWithinBounds(key,
-                                           bounds_,
+                                           bounds,
                                            neighbors.first));
     } // end if leaf
 
-    // bounds_ is a matrix containing both vectors maxBounds_ and minBounds_
     value_type tmp;
     const int& d = nptr->splitDim;
     const value_type& p = nptr->partition;
 
-    // save some time avoiding too many accesses to maxBounds_/minBounds_
-    value_type& boxMax = maxBounds_.at(d);
-    value_type& boxMin = minBounds_.at(d);
+    // save some time avoiding too many accesses to the bounds matrix
+    value_type& boxMax = bounds.at(1,d);
+    value_type& boxMin = bounds.at(0,d);
 
     // ------------
     //  left child
@@ -1612,7 +1794,7 @@ namespace lti {
       tmp=boxMax;
       boxMax=p;
       _lti_debug3("Searching closer son left" << std::endl);
-      if (searchNearest(nptr->left,key,neighbors)) {
+      if (searchNearest(leftChild(nptr),key,context,neighbors)) {
         _lti_debug3("done." << std::endl);
         boxMax=tmp;
         return true;
@@ -1623,10 +1805,10 @@ namespace lti {
       tmp=boxMin;
       boxMin=p;
       if (checkBoundsOverlapHypersphere(key,
-                                        bounds_,
+                                        bounds,
                                         neighbors.first)) {
         _lti_debug3("Searching farther son right" << std::endl);
-        if (searchNearest(nptr->right,key,neighbors)) {
+        if (searchNearest(rightChild(nptr),key,context,neighbors)) {
           boxMin=tmp;
           _lti_debug3("done." << std::endl);
           return true;
@@ -1646,7 +1828,7 @@ namespace lti {
       tmp=boxMin;
       boxMin=p;
       _lti_debug3("Searching closer son right" << std::endl);
-      if (searchNearest(nptr->right,key,neighbors)) {
+      if (searchNearest(rightChild(nptr),key,context,neighbors)) {
         boxMin=tmp;
         _lti_debug3("done." << std::endl);
         return true;
@@ -1657,11 +1839,11 @@ namespace lti {
       tmp=boxMax;
       boxMax=p;
       if (checkBoundsOverlapHypersphere(key,
-                                        bounds_,
+                                        bounds,
                                         neighbors.first)) {
 
         _lti_debug3("Searching farther son left" << std::endl);
-        if (searchNearest(nptr->left,key,neighbors)) {
+        if (searchNearest(leftChild(nptr),key,context,neighbors)) {
           boxMax=tmp;
           _lti_debug3("done." << std::endl);
           return true;
@@ -1673,7 +1855,7 @@ namespace lti {
     _lti_debug3("Return or terminate" << std::endl);
     // see if we should return or terminate
     return (checkHypersphereWithinBounds(key,
-                                         bounds_,
+                                         bounds,
                                          neighbors.first));
   }
 
@@ -1687,23 +1869,27 @@ namespace lti {
    * @return true if k elements were found, or false, if the tree contains
    *             less than k elements
    */
-  template<typename T,typename D, class U>
-  bool kdTree<T,D,U>::searchWithin(const node* nptr,
+  template<typename T,typename D,class U>
+  template<class N>
+  bool kdTree<T,D,U>::searchWithin(const N* nptr,
                                    const T& key,
                                    const distance_type& dist,
-                                   matrix<value_type>& bounds,
+                                   searchContext& context,
                                    std::list<element*>& elems) const {
+    matrix<value_type>& bounds = context.bounds_;
     
     // if this is a leaf, elements should be inserted in neighbors...
     if (nptr->isLeaf()) {
      
       // examine records in bucket, and update the elements list if necessary
-      typename node::points_type::const_iterator it,eit;
+      element* const* leaf;
+      const int n = leafDistances(nptr,key,context,leaf);
+      const distance_type* const d = context.distances_.data();
 
-      for (it=nptr->points.begin(),eit=nptr->points.end();it!=eit;++it) {
+      for (int i=0;i<n;++i) {
         // if point is within dist add to list of elements
-        if (dist >= distantor_(key,(*it)->point)) {
-          elems.push_back(*it);
+        if (dist >= d[i]) {
+          elems.push_back(leaf[i]);
         }
       }
       // check "hypersphere within bounds"
@@ -1726,7 +1912,7 @@ namespace lti {
       tmp=boxMax;
       boxMax=p;
       _lti_debug("Searching closer son left" << std::endl);
-      if (searchWithin(nptr->left,key,dist,bounds,elems)) {
+      if (searchWithin(leftChild(nptr),key,dist,context,elems)) {
         _lti_debug("done." << std::endl);
         boxMax=tmp;
         return true;
@@ -1738,7 +1924,7 @@ namespace lti {
       boxMin=p;
       if (checkBoundsOverlapHypersphere(key,bounds,dist)) {
         _lti_debug("Searching farther son right" << std::endl);
-        if (searchWithin(nptr->right,key,dist,bounds,elems)) {
+        if (searchWithin(rightChild(nptr),key,dist,context,elems)) {
           boxMin=tmp;
           _lti_debug("done." << std::endl);
           return true;
@@ -1756,7 +1942,7 @@ namespace lti {
       tmp=boxMin;
       boxMin=p;
       _lti_debug("Searching closer son right" << std::endl);
-      if (searchWithin(nptr->right,key,dist,bounds,elems)) {
+      if (searchWithin(rightChild(nptr),key,dist,context,elems)) {
         boxMin=tmp;
         _lti_debug("done." << std::endl);
         return true;
@@ -1770,7 +1956,7 @@ namespace lti {
       if (checkBoundsOverlapHypersphere(key, bounds,dist)) {
 
         _lti_debug("Searching farther son left" << std::endl);
-        if (searchWithin(nptr->left,key,dist,bounds,elems)) {
+        if (searchWithin(leftChild(nptr),key,dist,context,elems)) {
           boxMax=tmp;
           _lti_debug("done." << std::endl);
           return true;
@@ -1793,24 +1979,27 @@ namespace lti {
    * @return true if k elements were found, or false, if the tree contains
    *             less than k elements
    */
-  template<typename T,typename D, class U>
-  bool kdTree<T,D,U>::searchWithin(const node* nptr,
+  template<typename T,typename D,class U>
+  template<class N>
+  bool kdTree<T,D,U>::searchWithin(const N* nptr,
                                    const T& key,
                                    const distance_type& dist,
-                                   matrix<value_type>& bounds,
+                                   searchContext& context,
                                mmap_type& neigh) const {
+    matrix<value_type>& bounds = context.bounds_;
     
     // if this is a leaf, elements should be inserted in neighbors...
     if (nptr->isLeaf()) {
      
       // examine records in bucket, and update the elements list if necessary
-      typename node::points_type::const_iterator it,eit;
-      distance_type d;
+      element* const* leaf;
+      const int n = leafDistances(nptr,key,context,leaf);
+      const distance_type* const d = context.distances_.data();
 
-      for (it=nptr->points.begin(),eit=nptr->points.end();it!=eit;++it) {
+      for (int i=0;i<n;++i) {
         // if point is within dist add to list of elements
-        if (dist >= (d=distantor_(key,(*it)->point))) {
-          neigh.insert(std::make_pair(d,(*it)));
+        if (dist >= d[i]) {
+          neigh.insert(std::make_pair(d[i],leaf[i]));
         }
       }
       // check "hypersphere within bounds"
@@ -1833,7 +2022,7 @@ namespace lti {
       tmp=boxMax;
       boxMax=p;
       _lti_debug("Searching closer son left" << std::endl);
-      if (searchWithin(nptr->left,key,dist,bounds,neigh)) {
+      if (searchWithin(leftChild(nptr),key,dist,context,neigh)) {
         _lti_debug("done." << std::endl);
         boxMax=tmp;
         return true;
@@ -1845,7 +2034,7 @@ namespace lti {
       boxMin=p;
       if (checkBoundsOverlapHypersphere(key,bounds,dist)) {
         _lti_debug("Searching farther son right" << std::endl);
-        if (searchWithin(nptr->right,key,dist,bounds,neigh)) {
+        if (searchWithin(rightChild(nptr),key,dist,context,neigh)) {
           boxMin=tmp;
           _lti_debug("done." << std::endl);
           return true;
@@ -1863,7 +2052,7 @@ namespace lti {
       tmp=boxMin;
       boxMin=p;
       _lti_debug("Searching closer son right" << std::endl);
-      if (searchWithin(nptr->right,key,dist,bounds,neigh)) {
+      if (searchWithin(rightChild(nptr),key,dist,context,neigh)) {
         boxMin=tmp;
         _lti_debug("done." << std::endl);
         return true;
@@ -1877,7 +2066,7 @@ namespace lti {
       if (checkBoundsOverlapHypersphere(key, bounds,dist)) {
 
         _lti_debug("Searching farther son left" << std::endl);
-        if (searchWithin(nptr->left,key,dist,bounds,neigh)) {
+        if (searchWithin(leftChild(nptr),key,dist,context,neigh)) {
           boxMax=tmp;
           _lti_debug("done." << std::endl);
           return true;
@@ -1915,7 +2104,7 @@ namespace lti {
     // clear all data
     neighbors.clear();
 
-    if (notNull(root_) && (numElements_>=k)) {
+    if (!empty() && (numElements_>=k)) {
 
       // clear old data
       mmap_type neigh;
@@ -1927,7 +2116,11 @@ namespace lti {
         ++nsize;
       }
 
-      if (searchBestBinFirst(root_,k,key,neigh,emax)) {
+      searchContext context;
+      initBounds(context.bounds_);
+      if ((layout_ == Flat) ?
+          searchBestBinFirst(flatRoot(),k,key,context,neigh,emax) :
+          searchBestBinFirst(root_,k,key,context,neigh,emax)) {
         typename mmap_type::iterator it;
         for (it=neigh.begin();it!=neigh.end();++it) {
           neighbors.push_back((*it).second);
@@ -1959,17 +2152,35 @@ namespace lti {
                                   mmap_type& neighbors
                                   ) const {
     
+    searchContext context;
+    return searchBestBinFirst(k,key,emax,neighbors,context);
+  }
+
+  /*
+   * search the best-bin-first algorithm of Beis and Lowe, using the
+   * temporary data of the given context.
+   */
+  template<typename T,typename D,class U>
+  bool
+  kdTree<T,D,U>::searchBestBinFirst(const int k,
+                                    const T& key,
+                                    const int emax,
+                                    mmap_type& neighbors,
+                                    searchContext& context) const {
     // clear all data
     neighbors.clear();
 
-    if (notNull(root_) && (numElements_>=k)) {
+    if (!empty() && (numElements_>=k)) {
       // clear old data
       for (int i=0;i<k;++i) {
         neighbors.insert(std::make_pair(std::numeric_limits<distance_type>::max(),
                                         static_cast<element*>(0)));
       }
 
-      return searchBestBinFirst(root_,k,key,neighbors,emax);
+      initBounds(context.bounds_);
+      return ((layout_ == Flat) ?
+              searchBestBinFirst(flatRoot(),k,key,context,neighbors,emax) :
+              searchBestBinFirst(root_,k,key,context,neighbors,emax));
     }
 
     return false;
@@ -1986,41 +2197,43 @@ namespace lti {
    *         less than k elements
    */
   template<typename T,typename D,class U>
+  template<class N>
   bool 
-  kdTree<T,D,U>::searchBestBinFirst(const node* root,
+  kdTree<T,D,U>::searchBestBinFirst(const N* root,
                                   const int k,
                                   const T& key,
+                                  searchContext& context,
                                   mmap_type& neighbors,
                                   const int emax
                                   ) const {
 
     // priority queue
     typedef
-      std::multimap<distance_type,std::pair< node*,matrix<value_type> > > qtype;
+      std::multimap<distance_type,std::pair<const N*,matrix<value_type> > > qtype;
     qtype pqueue;
     typename qtype::iterator qit;
 
-    matrix<value_type> bounds(totalBounds_);
+    matrix<value_type>& bounds = context.bounds_;
 
     const int maxVisits = min(emax,numLeaves_);// ensure termination
     int nodeVisits(0);                        // number of leaf nodes visited
     int elems(0);                             // number of elements inserted in
                                               // neighbors
-    const node* nptr = root;
+    const N* nptr = root;
 
     while ( notNull(nptr) && ((elems<k) || (nodeVisits<maxVisits)) ) {
       // if this is a leaf, elements should be inserted in neighbors...
       if (nptr->isLeaf()) {
         // examine records in bucket, and update the neighbors map if necessary
-        typename node::points_type::const_iterator it,eit;
-        distance_type d;
+        element* const* leaf;
+        const int n = leafDistances(nptr,key,context,leaf);
+        const distance_type* const dist = context.distances_.data();
         
-        for (it=nptr->points.begin(),eit=nptr->points.end();it!=eit;++it) {
+        for (int i=0;i<n;++i) {
           // if neighbors have too few elements or if the farest
           // nearest element have a greater distance than the actual
           // element then insert the elements in the map
-          if ( (neighbors.rbegin())->first > 
-               (d=distantor_(key,(*it)->point)) ) {
+          if ( (neighbors.rbegin())->first > dist[i] ) {
             
             // delete the last one
             typename mmap_type::iterator mit;
@@ -2035,9 +2248,9 @@ namespace lti {
 #           endif
             neighbors.erase(mit);
             
-            _lti_debug3("Inserting " << (*it)->point << std::endl);
+            _lti_debug3("Inserting " << leaf[i]->point << std::endl);
             // insert one element
-            neighbors.insert(std::make_pair(d,(*it)));
+            neighbors.insert(std::make_pair(dist[i],leaf[i]));
             ++elems;
           }
         }
@@ -2079,13 +2292,13 @@ namespace lti {
           tmp=boxMin;
           boxMin=p;
           pqueue.insert(std::make_pair(minDistancePointToBox(key,bounds),
-                                       std::make_pair(nptr->right,bounds)));
+                                       std::make_pair(rightChild(nptr),bounds)));
           
           boxMin=tmp;
           
           // call on closer son
           boxMax=p;
-          nptr = nptr->left;
+          nptr = leftChild(nptr);
         } else {
           
           // ------------
@@ -2097,13 +2310,13 @@ namespace lti {
           tmp=boxMax;
           boxMax=p;
           pqueue.insert(std::make_pair(minDistancePointToBox(key,bounds),
-                                       std::make_pair(nptr->left,bounds)));
+                                       std::make_pair(leftChild(nptr),bounds)));
           
           boxMax=tmp;
           
           // call on closer son
           boxMin=p;
-          nptr = nptr->right;
+          nptr = rightChild(nptr);
         }
       }
         
@@ -2133,6 +2346,18 @@ namespace lti {
   bool kdTree<T,D,U>::searchRange(const T& boxMin,
                                   const T& boxMax,
                                   std::list<element*>& neighbors) const {
+    return searchRange(boxMin,boxMax,neighbors,context_);
+  }
+
+  /*
+   * Search for all points lying within the given hyperbox, using the
+   * temporary data of the given context.
+   */
+  template<typename T,typename D,class U>
+  bool kdTree<T,D,U>::searchRange(const T& boxMin,
+                                  const T& boxMax,
+                                  std::list<element*>& neighbors,
+                                  searchContext& context) const {
 
     _lti_debug3("Search In Range: from " << boxMin << 
                 " to " << boxMax << std::endl);
@@ -2140,56 +2365,51 @@ namespace lti {
     neighbors.clear();
 
     // if this is a leaf, elements should be inserted in neighbors...
-    if (notNull(root_)) {
-      // the fastest contents copy between the two matrices is required here!
-      // without resize (to avoid new memory allocation).
-      // use pointer arithmetic.
-      // is is equivalent to bounds_.fill(totalBounds_), but avoiding
-      // many (here) unnecessary boundary checks.
-      const value_type *pt,*pe;
-      value_type *p;
-      for (pt=totalBounds_.data(),pe=&totalBounds_.at(1,maxBounds_.lastIdx()),
-             p=minBounds_.data();pt<=pe;++pt,++p) {
-        (*p)=(*pt);
+    if (!empty()) {
+      initBounds(context.bounds_);
+      if (layout_ == Flat) {
+        searchRange(flatRoot(),boxMin,boxMax,context.bounds_,neighbors);
+      } else {
+        searchRange(root_,boxMin,boxMax,context.bounds_,neighbors);
       }
-
-      searchRange(root_,boxMin,boxMax,neighbors);
     }
 
     return !neighbors.empty();
   }
 
   template<typename T,typename D,class U>
-  bool kdTree<T,D,U>::searchRange(const node* nptr,
+  template<class N>
+  bool kdTree<T,D,U>::searchRange(const N* nptr,
                                   const T& boxMin,
                                   const T& boxMax,
+                                  matrix<value_type>& bounds,
                                   std::list<element*>& neighbors) const {
     
     if (nptr->isLeaf()) {
-      typename node::points_type::const_iterator it,eit;
+      element* const* leaf;
+      const int n = leafElements(nptr,leaf);
 
-      _lti_debug3("Leaf node bounds:\n" << bounds_ << endl);
+      _lti_debug3("Leaf node bounds:\n" << bounds << endl);
 
       // examine records in bucket, and update the neighbors map if necessary
-      for (it=nptr->points.begin(),eit=nptr->points.end();it!=eit;++it) {
-        if (withinBox(boxMin,boxMax,(*it)->point)) {
-          _lti_debug3("Inserting (once) " << (*it)->point << endl);
-          neighbors.push_back(*it);
+      for (int i=0;i<n;++i) {
+        if (withinBox(boxMin,boxMax,leaf[i]->point)) {
+          _lti_debug3("Inserting (once) " << leaf[i]->point << endl);
+          neighbors.push_back(leaf[i]);
         }
       }
-      return withinBox(bounds_,boxMin,boxMax);  // false means, still need to
+      return withinBox(bounds,boxMin,boxMax);  // false means, still need to
                                                   // search somewhere else
       
     } // end is leaf.
     
-    // bounds_ is a matrix containing both vectors maxBounds_ and minBounds_
     value_type tmp;
     const int& d = nptr->splitDim;
     const value_type& p = nptr->partition;
 
-    // save some time avoiding too many accesses to maxBounds_/minBounds_
-    value_type& nodeBoxMax = maxBounds_.at(d);
-    value_type& nodeBoxMin = minBounds_.at(d);
+    // save some time avoiding too many accesses to the bounds matrix
+    value_type& nodeBoxMax = bounds.at(1,d);
+    value_type& nodeBoxMin = bounds.at(0,d);
 
     // ------------
     //  left child
@@ -2199,7 +2419,7 @@ namespace lti {
       tmp=nodeBoxMax;
       nodeBoxMax=p;
       _lti_debug3("Searching left child" << std::endl);
-      if (searchRange(nptr->left,boxMin,boxMax,neighbors)) {
+      if (searchRange(leftChild(nptr),boxMin,boxMax,bounds,neighbors)) {
         _lti_debug3("done." << std::endl);
         nodeBoxMax=tmp;
         return true;
@@ -2215,7 +2435,7 @@ namespace lti {
       tmp=nodeBoxMin;
       nodeBoxMin=p;
       _lti_debug3("Searching right child" << std::endl);
-      if (searchRange(nptr->right,boxMin,boxMax,neighbors)) {
+      if (searchRange(rightChild(nptr),boxMin,boxMax,bounds,neighbors)) {
         _lti_debug3("done." << std::endl);
         nodeBoxMin=tmp;
         return true;        
@@ -2223,7 +2443,91 @@ namespace lti {
       nodeBoxMin=tmp;
     }
 
-    return withinBox(bounds_,boxMin,boxMax);
+    return withinBox(bounds,boxMin,boxMax);
+  }
+
+  // ----------------------------------------
+  // Batch search
+  // ----------------------------------------
+
+  template<typename T,typename D,class U>
+  kdTree<T,D,U>::searchContext::searchContext() : bounds_() {
+  }
+
+  template<typename T,typename D,class U>
+  kdTree<T,D,U>::batchJob::batchJob(const kdTree<T,D,U>& tree,
+                                    const int k,
+                                    const matrix<value_type>& keys,
+                                    const int emax,
+                                    std::vector<mmap_type>& neighbors,
+                                    const int numTasks)
+    : failures(numTasks,0),tree_(tree),k_(k),keys_(keys),emax_(emax),
+      neighbors_(neighbors),numTasks_(numTasks) {
+  }
+
+  template<typename T,typename D,class U>
+  void kdTree<T,D,U>::batchJob::execute(const int task) {
+    const int from = (task*keys_.rows())/numTasks_;
+    const int to = ((task+1)*keys_.rows())/numTasks_;
+
+    // one context for all keys of the task
+    searchContext context;
+    int fails = 0;
+    for (int i=from;i<to;++i) {
+      const bool found = (emax_ < 0) ?
+        tree_.searchNearest(k_,keys_.getRow(i),neighbors_[i],context) :
+        tree_.searchBestBinFirst(k_,keys_.getRow(i),emax_,neighbors_[i],
+                                 context);
+      if (!found) {
+        ++fails;
+      }
+    }
+    failures[task] = fails;
+  }
+
+  template<typename T,typename D,class U>
+  bool kdTree<T,D,U>::searchBatch(const int k,
+                                  const matrix<value_type>& keys,
+                                  const int emax,
+                                  std::vector<mmap_type>& neighbors,
+                                  const int numberOfThreads) const {
+    neighbors.clear();
+    neighbors.resize(keys.rows());
+    if (keys.empty()) {
+      return true;
+    }
+
+    // the costs of the searches vary a lot from key to key, therefore more
+    // tasks than threads are used to balance the load
+    const int threads = threadPool::computeThreads(numberOfThreads);
+    const int tasks = min(keys.rows(),(threads > 1) ? 8*threads : 1);
+
+    batchJob job(*this,k,keys,emax,neighbors,tasks);
+    threadPool::getShared().run(job,tasks,threads);
+
+    for (int i=0;i<tasks;++i) {
+      if (job.failures[i] != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template<typename T,typename D,class U>
+  bool kdTree<T,D,U>::searchNearest(const int k,
+                                    const matrix<value_type>& keys,
+                                    std::vector<mmap_type>& neighbors,
+                                    const int numberOfThreads) const {
+    return searchBatch(k,keys,-1,neighbors,numberOfThreads);
+  }
+
+  template<typename T,typename D,class U>
+  bool kdTree<T,D,U>::searchBestBinFirst(const int k,
+                                         const matrix<value_type>& keys,
+                                         const int emax,
+                                         std::vector<mmap_type>& neighbors,
+                                         const int numberOfThreads) const {
+    return searchBatch(k,keys,max(emax,0),neighbors,numberOfThreads);
   }
 
 }
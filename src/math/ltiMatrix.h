@@ -840,6 +840,12 @@ namespace lti {
     /**
      * Multiply this matrix with \a other matrix, and leave result
      * here. The dimensions of this matrix will change if needed!
+     *
+     * Large float and double matrices are multiplied with the packed,
+     * cache-blocked kernels of ltiGemm.h, which use SIMD instructions
+     * and the shared lti::threadPool.  See
+     * lti::internal::gemmConfiguration to control them.
+     *
      * @param other the other matrix to be multiplied with.
      * @return a reference to this matrix.
      */
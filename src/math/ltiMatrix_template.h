@@ -30,6 +30,7 @@
  */
 
 #include "ltiPerformanceConfig.h"
+#include "ltiGemm.h"
 
 namespace lti {
 
@@ -718,7 +719,7 @@ namespace lti {
   }
 
 
-  // multiply this matrix with other (TODO: optimize!)
+  // multiply this matrix with other
   template <typename T>
   matrix<T>& matrix<T>::multiply(const genericMatrix<T>& other) {
     assert(this->columns() == other.rows());
@@ -764,6 +765,21 @@ namespace lti {
         }
       }
 
+    } else if (internal::gemmAccelerated<T>::value) {
+      // packed, cache-blocked product (see ltiGemm.h).  It requires
+      // contiguous memory for the second factor.
+      if (other.getMode() == genericMatrix<T>::Connected) {
+        internal::gemm(tmpRows,other.columns(),tmpCols,
+                       a.data(),tmpCols,
+                       other.data(),other.columns(),
+                       this->data(),this->columns());
+      } else {
+        const matrix<T> b(other);
+        internal::gemm(tmpRows,b.columns(),tmpCols,
+                       a.data(),tmpCols,
+                       b.data(),b.columns(),
+                       this->data(),this->columns());
+      }
     } else {
       // transpose the other matrix first
 
@@ -818,6 +834,22 @@ namespace lti {
           ++itthis;
         }
       }
+    } else if (internal::gemmAccelerated<T>::value &&
+               (first.getMode() == genericMatrix<T>::Connected) &&
+               (second.getMode() == genericMatrix<T>::Connected)) {
+      // packed, cache-blocked product (see ltiGemm.h)
+      internal::gemm(tmpRows,second.columns(),tmpCols,
+                     first.data(),tmpCols,
+                     second.data(),second.columns(),
+                     this->data(),this->columns());
+    } else if (internal::gemmAccelerated<T>::value) {
+      // same as above, but with contiguous copies of the factors
+      const matrix<T> a(first);
+      const matrix<T> b(second);
+      internal::gemm(tmpRows,b.columns(),tmpCols,
+                     a.data(),tmpCols,
+                     b.data(),b.columns(),
+                     this->data(),this->columns());
     } else {
       // transpose the second matrix first
 
@@ -843,8 +875,17 @@ namespace lti {
     int i;
     result.allocate(this->rows());
 
-    for (i=0; i<this->rows(); ++i) {
-      result.at(i)=getRow(i).dot(other);
+    if (internal::gemmAccelerated<T>::value &&
+        (this->getMode() == genericMatrix<T>::Connected)) {
+      // vectorized product of several rows at once (see ltiGemm.h)
+      internal::gemv(this->rows(),this->columns(),
+                     this->data(),this->columns(),
+                     other.data(),
+                     result.data());
+    } else {
+      for (i=0; i<this->rows(); ++i) {
+        result.at(i)=getRow(i).dot(other);
+      }
     }
 
     return (result);
@@ -0,0 +1,438 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiSimd.h
+ *         Thin wrapper of the SIMD instructions used by the vectorized
+ *         kernels of the library.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#ifndef _LTI_SIMD_H_
+#define _LTI_SIMD_H_
+
+#include "ltiTypes.h"
+
+#if defined(__AVX__)
+#  include <immintrin.h>
+#elif defined(__SSE4_1__)
+#  include <smmintrin.h>
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
+namespace lti {
+  namespace internal {
+
+    /**
+     * SIMD register abstraction.
+     *
+     * Each specialization provides the register type \c reg, the number of
+     * elements per register \c width and the few operations needed by the
+     * vectorized kernels of the library.  The instruction set is selected at
+     * compile time (AVX/AVX2, SSE4.1, SSE2).  If no suitable instruction set
+     * is available, this generic version works on single scalars, so that
+     * code written with it always compiles and produces the same results.
+     *
+     * All loads and stores are unaligned.
+     */
+    template<typename T>
+    struct simd {
+      /**
+       * Register type
+       */
+      typedef T reg;
+
+      /**
+       * Number of elements in a register
+       */
+      static const int width = 1;
+
+      /**
+       * True if the operations really use SIMD instructions
+       */
+      static const bool accelerated = false;
+
+      static inline reg zero() { return T(0); }
+      static inline reg load(const T* p) { return *p; }
+      static inline void store(T* p,const reg& r) { *p = r; }
+      static inline reg set1(const T v) { return v; }
+      static inline reg add(const reg& a,const reg& b) { return a+b; }
+      static inline reg sub(const reg& a,const reg& b) { return a-b; }
+      static inline reg mul(const reg& a,const reg& b) { return a*b; }
+      static inline reg madd(const reg& a,const reg& b,const reg& c) {
+        return a*b+c;
+      }
+      static inline T sum(const reg& r) { return r; }
+      static inline reg min(const reg& a,const reg& b) { return b<a ? b : a; }
+      static inline reg max(const reg& a,const reg& b) { return a<b ? b : a; }
+
+      /**
+       * Load \c width unsigned bytes and convert them to T
+       */
+      static inline reg widen(const ubyte* p) { return static_cast<T>(*p); }
+
+      /**
+       * Load \c width elements, each one the given number of elements
+       * (stride) after the previous one
+       */
+      static inline reg gather(const T* p,const int) { return *p; }
+    };
+
+#if defined(__AVX__)
+
+    template<>
+    struct simd<float> {
+      typedef __m256 reg;
+      static const int width = 8;
+      static const bool accelerated = true;
+      static inline reg zero() { return _mm256_setzero_ps(); }
+      static inline reg load(const float* p) { return _mm256_loadu_ps(p); }
+      static inline reg gather(const float* p,const int stride) {
+#  if defined(__AVX2__)
+        const __m256i idx = _mm256_mullo_epi32(_mm256_set1_epi32(stride),
+                                               _mm256_setr_epi32(0,1,2,3,
+                                                                 4,5,6,7));
+        return _mm256_i32gather_ps(p,idx,4);
+#  else
+        return _mm256_setr_ps(p[0],p[stride],p[2*stride],p[3*stride],
+                              p[4*stride],p[5*stride],p[6*stride],
+                              p[7*stride]);
+#  endif
+      }
+      static inline void store(float* p,const reg& r) {
+        _mm256_storeu_ps(p,r);
+      }
+      static inline reg set1(const float v) { return _mm256_set1_ps(v); }
+      static inline reg add(const reg& a,const reg& b) {
+        return _mm256_add_ps(a,b);
+      }
+      static inline reg sub(const reg& a,const reg& b) {
+        return _mm256_sub_ps(a,b);
+      }
+      static inline reg mul(const reg& a,const reg& b) {
+        return _mm256_mul_ps(a,b);
+      }
+      static inline reg madd(const reg& a,const reg& b,const reg& c) {
+#  if defined(__FMA__)
+        return _mm256_fmadd_ps(a,b,c);
+#  else
+        return _mm256_add_ps(_mm256_mul_ps(a,b),c);
+#  endif
+      }
+      static inline float sum(const reg& r) {
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(r),
+                              _mm256_extractf128_ps(r,1));
+        s = _mm_add_ps(s,_mm_movehl_ps(s,s));
+        s = _mm_add_ss(s,_mm_shuffle_ps(s,s,1));
+        return _mm_cvtss_f32(s);
+      }
+      static inline reg min(const reg& a,const reg& b) {
+        return _mm256_min_ps(a,b);
+      }
+      static inline reg max(const reg& a,const reg& b) {
+        return _mm256_max_ps(a,b);
+      }
+    };
+
+    template<>
+    struct simd<double> {
+      typedef __m256d reg;
+      static const int width = 4;
+      static const bool accelerated = true;
+      static inline reg zero() { return _mm256_setzero_pd(); }
+      static inline reg load(const double* p) { return _mm256_loadu_pd(p); }
+      static inline void store(double* p,const reg& r) {
+        _mm256_storeu_pd(p,r);
+      }
+      static inline reg set1(const double v) { return _mm256_set1_pd(v); }
+      static inline reg add(const reg& a,const reg& b) {
+        return _mm256_add_pd(a,b);
+      }
+      static inline reg sub(const reg& a,const reg& b) {
+        return _mm256_sub_pd(a,b);
+      }
+      static inline reg mul(const reg& a,const reg& b) {
+        return _mm256_mul_pd(a,b);
+      }
+      static inline reg madd(const reg& a,const reg& b,const reg& c) {
+#  if defined(__FMA__)
+        return _mm256_fmadd_pd(a,b,c);
+#  else
+        return _mm256_add_pd(_mm256_mul_pd(a,b),c);
+#  endif
+      }
+      static inline double sum(const reg& r) {
+        __m128d s = _mm_add_pd(_mm256_castpd256_pd128(r),
+                               _mm256_extractf128_pd(r,1));
+        s = _mm_add_sd(s,_mm_unpackhi_pd(s,s));
+        return _mm_cvtsd_f64(s);
+      }
+      static inline reg min(const reg& a,const reg& b) {
+        return _mm256_min_pd(a,b);
+      }
+      static inline reg max(const reg& a,const reg& b) {
+        return _mm256_max_pd(a,b);
+      }
+    };
+
+#elif defined(__SSE2__)
+
+    template<>
+    struct simd<float> {
+      typedef __m128 reg;
+      static const int width = 4;
+      static const bool accelerated = true;
+      static inline reg zero() { return _mm_setzero_ps(); }
+      static inline reg load(const float* p) { return _mm_loadu_ps(p); }
+      static inline reg gather(const float* p,const int stride) {
+        return _mm_setr_ps(p[0],p[stride],p[2*stride],p[3*stride]);
+      }
+      static inline void store(float* p,const reg& r) { _mm_storeu_ps(p,r); }
+      static inline reg set1(const float v) { return _mm_set1_ps(v); }
+      static inline reg add(const reg& a,const reg& b) {
+        return _mm_add_ps(a,b);
+      }
+      static inline reg sub(const reg& a,const reg& b) {
+        return _mm_sub_ps(a,b);
+      }
+      static inline reg mul(const reg& a,const reg& b) {
+        return _mm_mul_ps(a,b);
+      }
+      static inline reg madd(const reg& a,const reg& b,const reg& c) {
+        return _mm_add_ps(_mm_mul_ps(a,b),c);
+      }
+      static inline float sum(const reg& r) {
+        __m128 s = _mm_add_ps(r,_mm_movehl_ps(r,r));
+        s = _mm_add_ss(s,_mm_shuffle_ps(s,s,1));
+        return _mm_cvtss_f32(s);
+      }
+      static inline reg min(const reg& a,const reg& b) {
+        return _mm_min_ps(a,b);
+      }
+      static inline reg max(const reg& a,const reg& b) {
+        return _mm_max_ps(a,b);
+      }
+    };
+
+    template<>
+    struct simd<double> {
+      typedef __m128d reg;
+      static const int width = 2;
+      static const bool accelerated = true;
+      static inline reg zero() { return _mm_setzero_pd(); }
+      static inline reg load(const double* p) { return _mm_loadu_pd(p); }
+      static inline void store(double* p,const reg& r) { _mm_storeu_pd(p,r); }
+      static inline reg set1(const double v) { return _mm_set1_pd(v); }
+      static inline reg add(const reg& a,const reg& b) {
+        return _mm_add_pd(a,b);
+      }
+      static inline reg sub(const reg& a,const reg& b) {
+        return _mm_sub_pd(a,b);
+      }
+      static inline reg mul(const reg& a,const reg& b) {
+        return _mm_mul_pd(a,b);
+      }
+      static inline reg madd(const reg& a,const reg& b,const reg& c) {
+        return _mm_add_pd(_mm_mul_pd(a,b),c);
+      }
+      static inline double sum(const reg& r) {
+        return _mm_cvtsd_f64(_mm_add_sd(r,_mm_unpackhi_pd(r,r)));
+      }
+      static inline reg min(const reg& a,const reg& b) {
+        return _mm_min_pd(a,b);
+      }
+      static inline reg max(const reg& a,const reg& b) {
+        return _mm_max_pd(a,b);
+      }
+    };
+
+#endif
+
+#if defined(__AVX2__)
+
+    template<>
+    struct simd<int32> {
+      typedef __m256i reg;
+      static const int width = 8;
+      static const bool accelerated = true;
+      static inline reg zero() { return _mm256_setzero_si256(); }
+      static inline reg load(const int32* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+      }
+      static inline reg gather(const int32* p,const int stride) {
+        const __m256i idx = _mm256_mullo_epi32(_mm256_set1_epi32(stride),
+                                               _mm256_setr_epi32(0,1,2,3,
+                                                                 4,5,6,7));
+        return _mm256_i32gather_epi32(reinterpret_cast<const int*>(p),idx,4);
+      }
+      static inline void store(int32* p,const reg& r) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p),r);
+      }
+      static inline reg set1(const int32 v) { return _mm256_set1_epi32(v); }
+      static inline reg add(const reg& a,const reg& b) {
+        return _mm256_add_epi32(a,b);
+      }
+      static inline reg sub(const reg& a,const reg& b) {
+        return _mm256_sub_epi32(a,b);
+      }
+      static inline reg mul(const reg& a,const reg& b) {
+        return _mm256_mullo_epi32(a,b);
+      }
+      static inline reg madd(const reg& a,const reg& b,const reg& c) {
+        return _mm256_add_epi32(_mm256_mullo_epi32(a,b),c);
+      }
+      static inline int32 sum(const reg& r) {
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(r),
+                                  _mm256_extracti128_si256(r,1));
+        s = _mm_add_epi32(s,_mm_shuffle_epi32(s,0x4e));
+        s = _mm_add_epi32(s,_mm_shuffle_epi32(s,0xb1));
+        return _mm_cvtsi128_si32(s);
+      }
+      static inline reg widen(const ubyte* p) {
+        return _mm256_cvtepu8_epi32(
+                 _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+      }
+      static inline reg min(const reg& a,const reg& b) {
+        return _mm256_min_epi32(a,b);
+      }
+      static inline reg max(const reg& a,const reg& b) {
+        return _mm256_max_epi32(a,b);
+      }
+    };
+
+#elif defined(__SSE4_1__)
+
+    template<>
+    struct simd<int32> {
+      typedef __m128i reg;
+      static const int width = 4;
+      static const bool accelerated = true;
+      static inline reg zero() { return _mm_setzero_si128(); }
+      static inline reg load(const int32* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      }
+      static inline reg gather(const int32* p,const int stride) {
+        return _mm_setr_epi32(p[0],p[stride],p[2*stride],p[3*stride]);
+      }
+      static inline void store(int32* p,const reg& r) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p),r);
+      }
+      static inline reg set1(const int32 v) { return _mm_set1_epi32(v); }
+      static inline reg add(const reg& a,const reg& b) {
+        return _mm_add_epi32(a,b);
+      }
+      static inline reg sub(const reg& a,const reg& b) {
+        return _mm_sub_epi32(a,b);
+      }
+      static inline reg mul(const reg& a,const reg& b) {
+        return _mm_mullo_epi32(a,b);
+      }
+      static inline reg madd(const reg& a,const reg& b,const reg& c) {
+        return _mm_add_epi32(_mm_mullo_epi32(a,b),c);
+      }
+      static inline int32 sum(const reg& r) {
+        __m128i s = _mm_add_epi32(r,_mm_shuffle_epi32(r,0x4e));
+        s = _mm_add_epi32(s,_mm_shuffle_epi32(s,0xb1));
+        return _mm_cvtsi128_si32(s);
+      }
+      static inline reg widen(const ubyte* p) {
+        int32 v;
+        v = static_cast<int32>(p[0]) | (static_cast<int32>(p[1])<<8) |
+            (static_cast<int32>(p[2])<<16) | (static_cast<int32>(p[3])<<24);
+        return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(v));
+      }
+      static inline reg min(const reg& a,const reg& b) {
+        return _mm_min_epi32(a,b);
+      }
+      static inline reg max(const reg& a,const reg& b) {
+        return _mm_max_epi32(a,b);
+      }
+    };
+
+#endif
+
+#if defined(__AVX2__)
+
+    /**
+     * Unsigned bytes are only loaded, stored and compared (no arithmetic)
+     */
+    template<>
+    struct simd<ubyte> {
+      typedef __m256i reg;
+      static const int width = 32;
+      static const bool accelerated = true;
+      static inline reg zero() { return _mm256_setzero_si256(); }
+      static inline reg load(const ubyte* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+      }
+      static inline void store(ubyte* p,const reg& r) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p),r);
+      }
+      static inline reg set1(const ubyte v) {
+        return _mm256_set1_epi8(static_cast<char>(v));
+      }
+      static inline reg min(const reg& a,const reg& b) {
+        return _mm256_min_epu8(a,b);
+      }
+      static inline reg max(const reg& a,const reg& b) {
+        return _mm256_max_epu8(a,b);
+      }
+    };
+
+#elif defined(__SSE2__)
+
+    /**
+     * Unsigned bytes are only loaded, stored and compared (no arithmetic)
+     */
+    template<>
+    struct simd<ubyte> {
+      typedef __m128i reg;
+      static const int width = 16;
+      static const bool accelerated = true;
+      static inline reg zero() { return _mm_setzero_si128(); }
+      static inline reg load(const ubyte* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      }
+      static inline void store(ubyte* p,const reg& r) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p),r);
+      }
+      static inline reg set1(const ubyte v) {
+        return _mm_set1_epi8(static_cast<char>(v));
+      }
+      static inline reg min(const reg& a,const reg& b) {
+        return _mm_min_epu8(a,b);
+      }
+      static inline reg max(const reg& a,const reg& b) {
+        return _mm_max_epu8(a,b);
+      }
+    };
+
+#endif
+
+  }
+}
+
+#endif
@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiThreadPool.cpp
+ *         Contains the class lti::threadPool, a set of worker threads that
+ *         execute the independent tasks of a parallel job.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include "ltiThreadPool.h"
+#include "ltiException.h"
+
+#ifdef _LTI_WIN32
+#  include <windows.h>
+#else
+#  include <unistd.h>
+#endif
+
+#undef _LTI_DEBUG
+// #define _LTI_DEBUG 1
+#include "ltiDebug.h"
+
+namespace lti {
+
+  // --------------------------------------------------------
+  //                        threadPool::job
+  // --------------------------------------------------------
+
+  threadPool::job::~job() {
+  }
+
+  // --------------------------------------------------------
+  //                        threadPool::worker
+  // --------------------------------------------------------
+
+  threadPool::worker::worker(threadPool& pool) : thread(), pool_(pool) {
+  }
+
+  void threadPool::worker::run() {
+    for (;;) {
+      pool_.wake_.wait();
+      if (pool_.terminate_) {
+        break;
+      }
+      pool_.work();
+      pool_.done_.post();
+    }
+  }
+
+  // --------------------------------------------------------
+  //                        threadPool
+  // --------------------------------------------------------
+
+  threadPool::threadPool(const int numThreads)
+    : wake_(0), done_(0), job_(0), numTasks_(0), nextTask_(0),
+      failed_(false), terminate_(false) {
+
+    const int n = (numThreads > 0) ? numThreads : getNumberOfProcessors();
+
+    workers_.resize(n-1,static_cast<worker*>(0));
+    for (unsigned int i=0;i<workers_.size();++i) {
+      workers_[i] = new worker(*this);
+      workers_[i]->start();
+    }
+  }
+
+  threadPool::~threadPool() {
+    runLock_.lock();
+    terminate_ = true;
+    for (unsigned int i=0;i<workers_.size();++i) {
+      wake_.post();
+    }
+    for (unsigned int i=0;i<workers_.size();++i) {
+      workers_[i]->join();
+      delete workers_[i];
+      workers_[i]=0;
+    }
+    runLock_.unlock();
+  }
+
+  int threadPool::getNumberOfThreads() const {
+    return static_cast<int>(workers_.size())+1;
+  }
+
+  void threadPool::work() {
+    int task;
+    for (;;) {
+      taskLock_.lock();
+      task = nextTask_++;
+      taskLock_.unlock();
+
+      if (task >= numTasks_) {
+        break;
+      }
+
+      try {
+        job_->execute(task);
+      } catch (...) {
+        taskLock_.lock();
+        failed_ = true;
+        taskLock_.unlock();
+      }
+    }
+  }
+
+  void threadPool::run(job& theJob, const int numTasks, const int maxThreads) {
+    if (numTasks <= 0) {
+      return;
+    }
+
+    int threads = getNumberOfThreads();
+    if ((maxThreads > 0) && (maxThreads < threads)) {
+      threads = maxThreads;
+    }
+    if (numTasks < threads) {
+      threads = numTasks;
+    }
+
+    // sequential execution if the pool is already busy or there is
+    // nothing to share
+    if ((threads <= 1) || !runLock_.tryLock()) {
+      _lti_debug("threadPool: sequential execution of " << numTasks <<
+                 " tasks" << std::endl);
+      for (int i=0;i<numTasks;++i) {
+        theJob.execute(i);
+      }
+      return;
+    }
+
+    job_ = &theJob;
+    numTasks_ = numTasks;
+    nextTask_ = 0;
+    failed_ = false;
+
+    const int helpers = threads-1;
+    int i;
+    for (i=0;i<helpers;++i) {
+      wake_.post();
+    }
+
+    // the calling thread works as well
+    work();
+
+    for (i=0;i<helpers;++i) {
+      done_.wait();
+    }
+
+    const bool failed = failed_;
+    job_ = 0;
+    runLock_.unlock();
+
+    if (failed) {
+      throw exception("threadPool: a task of the job threw an exception");
+    }
+  }
+
+  threadPool& threadPool::getShared() {
+    static threadPool theSharedPool;
+    return theSharedPool;
+  }
+
+  int threadPool::getNumberOfProcessors() {
+    int n = 1;
+#ifdef _LTI_WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    n = static_cast<int>(info.dwNumberOfProcessors);
+#elif defined(_SC_NPROCESSORS_ONLN)
+    n = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+    return (n > 0) ? n : 1;
+  }
+
+  int threadPool::computeThreads(const int numThreads) {
+    const int available = getShared().getNumberOfThreads();
+    if ((numThreads <= 0) || (numThreads > available)) {
+      return available;
+    }
+    return numThreads;
+  }
+
+}
@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiThreadPool.h
+ *         Contains the class lti::threadPool, a set of worker threads that
+ *         execute the independent tasks of a parallel job.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#ifndef _LTI_THREAD_POOL_H_
+#define _LTI_THREAD_POOL_H_
+
+#include "ltiThread.h"
+#include "ltiMutex.h"
+#include "ltiSemaphore.h"
+#include <vector>
+
+namespace lti {
+
+  /**
+   * Pool of worker threads.
+   *
+   * A thread pool keeps a fixed number of worker threads sleeping until a
+   * parallel job has to be done.  A job is described by an instance of a
+   * class derived from threadPool::job, which reimplements the method
+   * execute(const int) to do the work corresponding to one task index.
+   * The method run() distributes the task indices 0 to n-1 among the
+   * workers and the calling thread, and returns when all tasks have
+   * been executed.
+   *
+   * Tasks of the same job must be independent of each other, since the
+   * order in which they are executed is not defined.  If the results of
+   * the tasks are written into disjoint memory regions, the final result
+   * is identical to the one of a sequential execution.
+   *
+   * Only one job can be executed by a pool at a time.  If run() is
+   * called while the pool is busy (for instance, from within a task of
+   * another job, or simultaneously by another thread), the new job is
+   * executed sequentially in the calling thread.  This avoids deadlocks
+   * in nested parallel code and prevents oversubscription of the CPU.
+   *
+   * Most of the library uses the shared pool returned by getShared(),
+   * which is created the first time it is required with as many threads
+   * as processors are available.
+   *
+   * Example:
+   * \code
+   * class scaleRows : public lti::threadPool::job {
+   * public:
+   *   scaleRows(lti::dmatrix& m) : mat(m) {};
+   *   virtual void execute(const int task) {
+   *     mat.getRow(task).multiply(2.0);
+   *   }
+   *   lti::dmatrix& mat;
+   * };
+   *
+   * lti::dmatrix m(1000,1000,1.0);
+   * scaleRows theJob(m);
+   * lti::threadPool::getShared().run(theJob,m.rows());
+   * \endcode
+   */
+  class threadPool {
+  public:
+    /**
+     * Parent class of all jobs executed by a threadPool.
+     */
+    class job {
+    public:
+      /**
+       * Virtual destructor
+       */
+      virtual ~job();
+
+      /**
+       * Execute the task with the given index.
+       *
+       * This method is called concurrently from several threads, with
+       * task indices between 0 and the number of tasks given to
+       * threadPool::run() minus one.  Each index is used exactly once.
+       */
+      virtual void execute(const int task) = 0;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param numThreads total number of threads used to execute a job,
+     *                   including the calling thread.  The pool creates
+     *                   numThreads-1 worker threads.  If zero or negative,
+     *                   the number of available processors is used.
+     */
+    threadPool(const int numThreads = 0);
+
+    /**
+     * Destructor.
+     *
+     * Waits for the worker threads to terminate.
+     */
+    virtual ~threadPool();
+
+    /**
+     * Execute the tasks 0 to \p numTasks-1 of the given job.
+     *
+     * The tasks are distributed among the workers and the calling
+     * thread.  The method returns when all tasks have been executed.
+     *
+     * If a task throws an exception, the remaining tasks are still
+     * executed and an lti::exception is thrown afterwards.
+     *
+     * @param theJob job to be executed
+     * @param numTasks number of tasks
+     * @param maxThreads maximal number of threads (including the calling
+     *                   one) to be used for this job.  If zero or negative,
+     *                   all threads of the pool are used.
+     */
+    void run(job& theJob, const int numTasks, const int maxThreads = 0);
+
+    /**
+     * Total number of threads used in a job, including the calling thread.
+     */
+    int getNumberOfThreads() const;
+
+    /**
+     * Shared pool of the library.
+     *
+     * The pool is created the first time this method is called, with as
+     * many threads as processors are available.
+     */
+    static threadPool& getShared();
+
+    /**
+     * Number of processors available in the system.
+     *
+     * Returns at least 1.
+     */
+    static int getNumberOfProcessors();
+
+    /**
+     * Compute the number of threads to be used for a given parameter value.
+     *
+     * Many functors and algorithms in the library have a parameter to
+     * select the number of threads, where a value of zero or less means
+     * "automatic", i.e. use all threads of the shared pool.  This method
+     * does the mapping.
+     *
+     * @param numThreads requested number of threads (<=0 means automatic)
+     * @return number of threads to be used, always between 1 and the size
+     *         of the shared pool.
+     */
+    static int computeThreads(const int numThreads);
+
+  private:
+    /**
+     * Worker thread
+     */
+    class worker : public thread {
+    public:
+      /**
+       * Constructor
+       */
+      worker(threadPool& pool);
+
+    protected:
+      /**
+       * Wait for jobs and execute them until the pool terminates
+       */
+      virtual void run();
+
+      /**
+       * Owner pool
+       */
+      threadPool& pool_;
+    };
+
+    friend class worker;
+
+    /**
+     * Disabled copy constructor
+     */
+    threadPool(const threadPool& other);
+
+    /**
+     * Disabled copy operator
+     */
+    threadPool& operator=(const threadPool& other);
+
+    /**
+     * Execute tasks of the current job until all of them have been
+     * taken.
+     */
+    void work();
+
+    /**
+     * Worker threads
+     */
+    std::vector<worker*> workers_;
+
+    /**
+     * Only one job at a time is allowed
+     */
+    mutex runLock_;
+
+    /**
+     * Protects the access to nextTask_ and failed_
+     */
+    mutex taskLock_;
+
+    /**
+     * Posted once for each worker that has to wake up
+     */
+    semaphore wake_;
+
+    /**
+     * Posted by each worker when it has finished its part of the job
+     */
+    semaphore done_;
+
+    /**
+     * Job being executed
+     */
+    job* job_;
+
+    /**
+     * Number of tasks of the current job
+     */
+    int numTasks_;
+
+    /**
+     * Next task to be executed
+     */
+    int nextTask_;
+
+    /**
+     * Flag set if some task threw an exception
+     */
+    bool failed_;
+
+    /**
+     * Flag set by the destructor to terminate the workers
+     */
+    bool terminate_;
+  };
+
+}
+
+#endif
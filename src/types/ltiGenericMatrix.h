@@ -586,6 +586,8 @@ namespace lti {
      * @param rows number of rows
      * @param cols number of columns
      * @param data a pointer to the memory block to be used
+     * @param alloc the lti::memoryAllocator which provided the block, or
+     *              null if it was allocated with new[] (default).
      *
      * Example:
      * \code
@@ -602,7 +604,8 @@ namespace lti {
      *                           //      block2!!
      * \endcode
      */
-    void attach(const int rows,const int cols,T* data);
+    void attach(const int rows,const int cols,T* data,
+                memoryAllocator* alloc = 0);
 
     /**
      * Free the data of this object and hand it over to the
@@ -1711,6 +1714,13 @@ namespace lti {
      * Table of pointers to the rows
      */
     genericVector<T>* rowAddressTable_;
+
+    /**
+     * Allocator which provided theElements_, or null if the block was
+     * allocated with new[] or given with attach().  Only meaningful if
+     * ownData_ is true.
+     */
+    memoryAllocator* allocator_;
   };
 }
 
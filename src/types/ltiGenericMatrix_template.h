@@ -61,7 +61,7 @@ namespace lti {
     : container(),theSize_(0,0),
       lastRowIdx_(theSize_.y-1),lastColIdx_(theSize_.x-1),
       metaNumRows_(0),metaNumColumns_(0),totalSize_(0),
-      ownData_(true),mode_(Connected),theElements_(0),rowAddressTable_(0) {    
+      ownData_(true),mode_(Connected),theElements_(0),rowAddressTable_(0),allocator_(0) {    
   }
 
   // constructor: rows X cols genericMatrix
@@ -71,7 +71,7 @@ namespace lti {
       lastRowIdx_(theSize_.y-1),lastColIdx_(theSize_.x-1),
       metaNumRows_(r),metaNumColumns_(c),
       totalSize_(r*c),ownData_(true),mode_(Connected),theElements_(0),
-      rowAddressTable_(0) {
+      rowAddressTable_(0),allocator_(0) {
 
     if((r<=0)||(c<=0)) {
       return;
@@ -85,7 +85,7 @@ namespace lti {
       throw allocException();
     }
 
-    theElements_ = new T[metaNumRows_*metaNumColumns_];
+    theElements_ = internal::allocateElements<T>(totalSize_,allocator_);
     rowAddressTable_ = allocRows(metaNumRows_);
 
     if ((theElements_ == 0) || (rowAddressTable_ == 0)) {
@@ -110,7 +110,7 @@ namespace lti {
       metaNumRows_(theSize_.y),metaNumColumns_(theSize_.x),
       totalSize_(theSize_.x*theSize_.y),ownData_(true),
       mode_(Connected),theElements_(0),
-      rowAddressTable_(0) {
+      rowAddressTable_(0),allocator_(0) {
 
     if((sz.y<=0)||(sz.x<=0)) {
       return;
@@ -124,7 +124,7 @@ namespace lti {
       throw allocException();
     }
 
-    theElements_ = new T[metaNumRows_*metaNumColumns_];
+    theElements_ = internal::allocateElements<T>(totalSize_,allocator_);
     rowAddressTable_ = allocRows(metaNumRows_);
 
     if ((theElements_ == 0) || (rowAddressTable_ == 0)) {
@@ -149,7 +149,7 @@ namespace lti {
       lastRowIdx_(theSize_.y-1),lastColIdx_(theSize_.x-1),
       metaNumRows_(r),metaNumColumns_(c),
       totalSize_(r*c),ownData_(true),mode_(Connected),theElements_(0),
-      rowAddressTable_(0) {
+      rowAddressTable_(0),allocator_(0) {
 
     if((r<=0)||(c<=0)) {
       return;
@@ -163,7 +163,7 @@ namespace lti {
       throw allocException();
     }
 
-    theElements_ = new T[metaNumRows_*metaNumColumns_];
+    theElements_ = internal::allocateElements<T>(totalSize_,allocator_);
     rowAddressTable_ = allocRows(metaNumRows_);
 
     if ((theElements_ == 0) || (rowAddressTable_ == 0)) {
@@ -190,7 +190,7 @@ namespace lti {
       lastRowIdx_(theSize_.y-1),lastColIdx_(theSize_.x-1),
       metaNumRows_(r),metaNumColumns_(c),
       totalSize_(r*c),ownData_(true),mode_(Connected), theElements_(0),
-      rowAddressTable_(0) {
+      rowAddressTable_(0),allocator_(0) {
     // theSize_.y and theSize_.x are REFERENCES to theSize_ attributes!
 
     if((r<=0)||(c<=0)) {
@@ -205,7 +205,7 @@ namespace lti {
       throw allocException();
     }
 
-    theElements_ = new T[metaNumRows_*metaNumColumns_];
+    theElements_ = internal::allocateElements<T>(totalSize_,allocator_);
     rowAddressTable_ = allocRows(metaNumRows_);
 
     if ((theElements_ == 0) || (rowAddressTable_ == 0)) {
@@ -230,7 +230,7 @@ namespace lti {
     : container(),theSize_(dim),
       lastRowIdx_(theSize_.y-1),lastColIdx_(theSize_.x-1),
       metaNumRows_(dim.y),metaNumColumns_(dim.x),totalSize_(dim.y*dim.x),
-      ownData_(true),mode_(Connected), theElements_(0), rowAddressTable_(0) {
+      ownData_(true),mode_(Connected), theElements_(0), rowAddressTable_(0),allocator_(0) {
 
     if((dim.y<=0)||(dim.x<=0)) {
       return;
@@ -244,7 +244,7 @@ namespace lti {
       throw allocException();
     }
 
-    theElements_ = new T[metaNumRows_*metaNumColumns_];
+    theElements_ = internal::allocateElements<T>(totalSize_,allocator_);
     rowAddressTable_ = allocRows(metaNumRows_);
 
     if ((theElements_ == 0) || (rowAddressTable_ == 0)) {
@@ -275,7 +275,7 @@ namespace lti {
     : container(),theSize_(0,0),
       lastRowIdx_(theSize_.y-1),lastColIdx_(theSize_.x-1),
       metaNumRows_(0),metaNumColumns_(0),totalSize_(0),
-      ownData_(true),mode_(Connected),theElements_(0),rowAddressTable_(0) {
+      ownData_(true),mode_(Connected),theElements_(0),rowAddressTable_(0),allocator_(0) {
 
     int fc,tc,fr,tr;
     fc = fromCol;
@@ -345,7 +345,7 @@ namespace lti {
     : container(),theSize_(0,0),
       lastRowIdx_(theSize_.y-1),lastColIdx_(theSize_.x-1),
       metaNumRows_(0),metaNumColumns_(0),totalSize_(0),
-      ownData_(true),mode_(Connected),theElements_(0),rowAddressTable_(0) {
+      ownData_(true),mode_(Connected),theElements_(0),rowAddressTable_(0),allocator_(0) {
 
     copy(other);
   }
@@ -358,7 +358,7 @@ namespace lti {
     : container(),theSize_(0,0),
       lastRowIdx_(theSize_.y-1),lastColIdx_(theSize_.x-1),
       metaNumRows_(0),metaNumColumns_(0),totalSize_(0),
-      ownData_(true),mode_(Connected),theElements_(0),rowAddressTable_(0) {
+      ownData_(true),mode_(Connected),theElements_(0),rowAddressTable_(0),allocator_(0) {
 
     copy(other,from,to);
   }
@@ -373,7 +373,7 @@ namespace lti {
     : container(),theSize_(0,0),
       lastRowIdx_(theSize_.y-1),lastColIdx_(theSize_.x-1),
       metaNumRows_(0),metaNumColumns_(0),totalSize_(0),
-      ownData_(true),mode_(Connected),theElements_(0),rowAddressTable_(0) {
+      ownData_(true),mode_(Connected),theElements_(0),rowAddressTable_(0),allocator_(0) {
 
     copy(other,fromRow,fromCol,toRow,toCol);
   }
@@ -385,14 +385,14 @@ namespace lti {
     : container(),theSize_(0,0),
       lastRowIdx_(theSize_.y-1),lastColIdx_(theSize_.x-1),
       metaNumRows_(0),metaNumColumns_(0),totalSize_(0),
-      ownData_(true),mode_(Connected),theElements_(0),rowAddressTable_(0) {
+      ownData_(true),mode_(Connected),theElements_(0),rowAddressTable_(0),allocator_(0) {
     copy(other, idx);
   }
 
   template <typename T>
   genericMatrix<T>::~genericMatrix() {
     if (ownData_) {
-      delete[] theElements_;
+      internal::releaseElements(theElements_,totalSize_,allocator_);
     }
 
     delete[] rowAddressTable_;
@@ -421,11 +421,7 @@ namespace lti {
     }
 
 
-    T* newElements = new T[sz];
-
-    if (newElements == 0) { // memory allocation check
-      throw allocException();
-    }
+    T* newElements = internal::allocateElements<T>(sz,allocator_);
 
     // if connected memory then data can be copied at once...
     if ((mode_ == Connected) && (newCols == metaNumColumns_)) {
@@ -477,10 +473,11 @@ namespace lti {
     }
 
     if (ownData_) {
-      delete [] theElements_;
+      internal::releaseElements(theElements_,totalSize_,allocator_);
     }
 
     ownData_ = false;
+    allocator_ = 0;
 
     delete[] rowAddressTable_;
 
@@ -508,9 +505,11 @@ namespace lti {
 
   // attach external memory region to this object
   template <typename T>
-  void genericMatrix<T>::attach(const int r, const int c, T* _data) {
+  void genericMatrix<T>::attach(const int r, const int c, T* _data,
+                                memoryAllocator* alloc) {
     useExternData(r,c,_data);
     ownData_ = true;
+    allocator_ = alloc;
   }
 
   // detach internal memory to an external 'receiver' genericMatrix
@@ -523,12 +522,14 @@ namespace lti {
       // accidentally deleted
       if (ownData_) {
         // with "attach" the receiver will take control of _theElements
-        receiver.attach(metaNumRows_,metaNumColumns_,theElements_);
+        receiver.attach(metaNumRows_,metaNumColumns_,theElements_,
+                        allocator_);
       } else {
         // just use _theElements
         receiver.useExternData(metaNumRows_,metaNumColumns_,theElements_);
       }
       ownData_ = false;  // avoid removing theElements_
+      allocator_ = 0;
       clear();
     } else {
       // lined matrix
@@ -556,6 +557,9 @@ namespace lti {
       receiver.ownData_ = ownData_;
       ownData_ = true;
 
+      receiver.allocator_ = allocator_;
+      allocator_ = 0;
+
       receiver.mode_ = mode_;
       mode_=Connected;
 
@@ -577,11 +581,12 @@ namespace lti {
     // receiver should know whether he owns data, so it is not
     // accidentally deleted
     if (ownData_) {
-      receiver.attach(totalSize_,theElements_);
+      receiver.attach(totalSize_,theElements_,allocator_);
     } else {
       receiver.useExternData(totalSize_,theElements_);
     }
     ownData_ = false;
+    allocator_ = 0;
     clear();
   }
 
@@ -638,6 +643,10 @@ namespace lti {
     tmpVctPtr = rowAddressTable_;
     rowAddressTable_ = other.rowAddressTable_;
     other.rowAddressTable_ = tmpVctPtr;
+
+    memoryAllocator* tmpAlloc = allocator_;
+    allocator_ = other.allocator_;
+    other.allocator_ = tmpAlloc;
   }
 
   // resize genericMatrix
@@ -649,7 +658,7 @@ namespace lti {
     // if the new size is zero then clear all data
     if ((newRows <= 0) || (newCols <= 0)) {
       if (ownData_) {
-        delete[] theElements_;
+        internal::releaseElements(theElements_,totalSize_,allocator_);
       } else {
         ownData_ = true;
       }
@@ -689,12 +698,8 @@ namespace lti {
       throw allocException();
     }
 
-    newElements = new T[newRows*newCols];
-
-    // memory allocation check
-    if (newElements == 0) { 
-      throw allocException();
-    }
+    memoryAllocator* newAllocator;
+    newElements = internal::allocateElements<T>(newRows*newCols,newAllocator);
 
     // old data should be copied
     if (resizeType==Copy || resizeType==CopyAndInit) {
@@ -719,10 +724,11 @@ namespace lti {
     }
 
     if (ownData_) {
-      delete[] theElements_;
+      internal::releaseElements(theElements_,totalSize_,allocator_);
     } else {
       ownData_ = true;
     }
+    allocator_ = newAllocator;
 
     mode_ = Connected;
     theSize_.y    = metaNumRows_    = newRows;
@@ -973,6 +979,8 @@ namespace lti {
      * copied.
      */
     T* delayedElements = 0;
+    const int delayedSize = totalSize_;
+    memoryAllocator* delayedAllocator = allocator_;
 
     // erase old data!
     if (ownData_) {
@@ -984,7 +992,7 @@ namespace lti {
           delayedElements = theElements_;
           theElements_ = 0;
         } else {
-          delete[] theElements_;
+          internal::releaseElements(theElements_,totalSize_,allocator_);
           theElements_ = 0;
         }
 
@@ -1009,7 +1017,8 @@ namespace lti {
       mode_ = Connected;
 
       if (notNull(delayedElements)) {
-        delete[] delayedElements;
+        internal::releaseElements(delayedElements,delayedSize,
+                                  delayedAllocator);
       }
       return (*this);
     }
@@ -1037,12 +1046,12 @@ namespace lti {
         throw allocException();
       }
 
-      theElements_ =  new T[totalSize_];
-      if (theElements_ == 0) { // memory allocation check
-        if (notNull(delayedElements)) {
-          delete[] delayedElements;
-        }
-        throw allocException();
+      try {
+        theElements_ = internal::allocateElements<T>(totalSize_,allocator_);
+      } catch (...) {
+        internal::releaseElements(delayedElements,delayedSize,
+                                  delayedAllocator);
+        throw;
       }
     }
 
@@ -1078,7 +1087,7 @@ namespace lti {
     // Remove the data of the src genericMatrix, in those cases where that data
     // belonged also to this genericMatrix:
     if (notNull(delayedElements)) {
-      delete[] delayedElements;
+      internal::releaseElements(delayedElements,delayedSize,delayedAllocator);
     }
     
     return (*this);
@@ -1129,7 +1138,7 @@ namespace lti {
 
     // erase old data!
     if (ownData_) {
-      delete[] theElements_;
+      internal::releaseElements(theElements_,totalSize_,allocator_);
     } else {
       ownData_ = true;
     }
@@ -1173,11 +1182,7 @@ namespace lti {
     }
 
     // allocate memory
-    theElements_ =  new T[totalSize_];
-
-    if (theElements_ == 0) { // memory allocation check
-      throw allocException();
-    }
+    theElements_ = internal::allocateElements<T>(totalSize_,allocator_);
 
     rowAddressTable_ = allocRows(theSize_.y);
 
@@ -1226,7 +1231,7 @@ namespace lti {
 
     // erase old data!
     if (ownData_) {
-      delete[] theElements_;
+      internal::releaseElements(theElements_,totalSize_,allocator_);
     } else {
       ownData_ = true;
     }
@@ -1273,11 +1278,7 @@ namespace lti {
     }
 
     // allocate memory
-    theElements_ =  new T[totalSize_];
-
-    if (theElements_ == 0) { // memory allocation check
-      throw allocException();
-    }
+    theElements_ = internal::allocateElements<T>(totalSize_,allocator_);
 
     rowAddressTable_ = allocRows(theSize_.y);
 
@@ -1535,7 +1536,7 @@ namespace lti {
   template<typename T>
   bool genericMatrix<T>::write(ioHandler& handler,const bool complete) const {
 
-    ipoint i;
+    int y;
     bool b = true;
 
     if (complete) {
@@ -1550,17 +1551,9 @@ namespace lti {
       handler.writeKeyValueSeparator();
       handler.writeBegin();
 
-      int lastCol = lastColumn();
-
-      for (i.y=0;i.y<rows();++i.y) {
+      for (y=0;y<rows();++y) {
         handler.writeBegin();
-        if (columns() > 0) {
-          for (i.x=0;i.x<lastCol;++i.x) {
-            lti::write(handler,at(i));
-            handler.writeDataSeparator();
-          }
-          lti::write(handler,at(i));
-        }
+        lti::writeArray(handler,getRow(y).data(),columns());
         handler.writeEnd();
         handler.writeEOL();
       }
@@ -1601,32 +1594,18 @@ namespace lti {
         b = b && handler.readKeyValueSeparator();
         b = b && handler.readBegin();
         allocate(sz);
-        if (sz.y > 0) {
-          sz.x--;
-          i.y=0;
-          while (b && (i.y<sz.y)) {
-            b = handler.readBegin();
-            if (b) {
-              i.x=0;
-              while (b && (i.x<sz.x)) {
-                b = b && lti::read(handler,at(i));
-                b = b && handler.readKeyValueSeparator();
-                if (b) {
-                  ++i.x;
-                }
-              }
-
-              b = b && lti::read(handler,at(i));
-              b = b && handler.readEnd();
-              ++i.y;
-            }
+        i.y=0;
+        while (b && (i.y<sz.y)) {
+          b = handler.readBegin();
+          if (b) {
+            b = lti::readArray(handler,getRow(i.y).data(),sz.x);
+            b = b && handler.readEnd();
+            ++i.y;
           }
         }
         if (!b) {
           handler.setStatusString("Error reading genericMatrix at row ");
           handler.appendStatusString(i.y);
-          handler.appendStatusString(", col ");
-          handler.appendStatusString(i.x);
           handler.appendStatusString(".");
         }
       }
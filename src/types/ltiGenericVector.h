@@ -40,6 +40,7 @@
 #include "ltiConstantReferenceType.h"
 #include "ltiConstReferenceException.h"
 #include "ltiAllocException.h"
+#include "ltiMemoryAllocator.h"
 #include "ltiTypes.h"
 #include "ltiAssert.h"
 #include "ltiResizeType.h"
@@ -414,6 +415,8 @@ namespace lti {
      *
      * @param theSize number of elements of the genericVector
      * @param data a pointer to the memory block to be used
+     * @param alloc the lti::memoryAllocator which provided the block, or
+     *              null if it was allocated with new[] (default).
      *
      * Example:
      * \code
@@ -429,7 +432,7 @@ namespace lti {
      *                          //      block2!!
      * \endcode
      */
-    void attach(const int theSize,T* data);
+    void attach(const int theSize,T* data,memoryAllocator* alloc = 0);
 
     /**
      * Free the data of this object and hand it over to the
@@ -1115,6 +1118,13 @@ namespace lti {
      */
     bool ownData_;
 
+    /**
+     * Allocator which provided the data block, or null if the block was
+     * allocated with new[] or given with attach().  Only meaningful if
+     * ownData_ is true.
+     */
+    memoryAllocator* allocator_;
+
     /**
      * If constReference=true, is not possible to resize or change
      * the reference of this genericVector. 
@@ -55,13 +55,13 @@ namespace lti {
   template<typename T>
   genericVector<T>::genericVector()
     : vectorSize_(0),idxLastElement_(-1),
-      theElements_(0),ownData_(true),constReference_(VariableReference) {
+      theElements_(0),ownData_(true),allocator_(0),constReference_(VariableReference) {
   }
 
   template<typename T>
   genericVector<T>::genericVector(const int theSize)
     : vectorSize_(0),idxLastElement_(-1),
-      theElements_(0),ownData_(true),constReference_(VariableReference) {
+      theElements_(0),ownData_(true),allocator_(0),constReference_(VariableReference) {
 
     if (theSize <= 0) {
       return;
@@ -71,17 +71,13 @@ namespace lti {
     idxLastElement_ = theSize-1;
     ownData_ = true;
 
-    theElements_ = new T[vectorSize_];
-
-    if (theElements_ == 0) { // allocation check
-      throw allocException();
-    }
+    theElements_ = internal::allocateElements<T>(vectorSize_,allocator_);
   }
 
   template<typename T>
   genericVector<T>::genericVector(const int theSize,const T& iniValue)
     : vectorSize_(0),idxLastElement_(-1),
-      theElements_(0),ownData_(true),constReference_(VariableReference) {
+      theElements_(0),ownData_(true),allocator_(0),constReference_(VariableReference) {
 
     if (theSize <= 0) {
       return;
@@ -91,11 +87,7 @@ namespace lti {
     idxLastElement_ = theSize-1;
     ownData_ = true;
 
-    theElements_ = new T[vectorSize_];
-
-    if (theElements_ == 0) { // allocation check
-      throw allocException();
-    }
+    theElements_ = internal::allocateElements<T>(vectorSize_,allocator_);
 
     fill(iniValue);
   }
@@ -103,7 +95,7 @@ namespace lti {
   template<typename T>
   genericVector<T>::genericVector(const int theSize,const T* _data)
     : vectorSize_(0),idxLastElement_(-1),
-      theElements_(0),ownData_(true),constReference_(VariableReference) {
+      theElements_(0),ownData_(true),allocator_(0),constReference_(VariableReference) {
 
     if (theSize <= 0) {
       return;
@@ -113,11 +105,7 @@ namespace lti {
     idxLastElement_ = theSize-1;
     ownData_ = true;
 
-    theElements_ = new T[vectorSize_];
-
-    if (theElements_ == 0) { // allocation check
-      throw allocException();
-    }
+    theElements_ = internal::allocateElements<T>(vectorSize_,allocator_);
 
     fill(_data);
   }
@@ -128,7 +116,7 @@ namespace lti {
                                   T* _data,
                                   const eConstantReference constRef)
     : vectorSize_(theSize),idxLastElement_(theSize-1),
-      theElements_(_data),ownData_(false),constReference_(constRef) {
+      theElements_(_data),ownData_(false),allocator_(0),constReference_(constRef) {
 
     if (theSize <= 0) {
       vectorSize_ = 0;
@@ -145,7 +133,7 @@ namespace lti {
   template<typename T>
   genericVector<T>::genericVector(const genericVector<T>& other)
     : container(),vectorSize_(0),idxLastElement_(-1),
-      theElements_(0),ownData_(true),constReference_(VariableReference) {
+      theElements_(0),ownData_(true),allocator_(0),constReference_(VariableReference) {
 
     if (other.vectorSize_ <= 0) {
       return;
@@ -155,11 +143,7 @@ namespace lti {
     idxLastElement_ = vectorSize_-1; // ensure consistent data!
     ownData_ = true;
 
-    theElements_ = new T[vectorSize_];
-
-    if (theElements_ == 0) { // allocation check
-      throw allocException();
-    }
+    theElements_ = internal::allocateElements<T>(vectorSize_,allocator_);
 
     // copy contents of other genericVector
     memcpy(theElements_,other.theElements_,vectorSize_*sizeof(T));    
@@ -171,7 +155,7 @@ namespace lti {
                                   const int from, 
                                   const int to)
     : vectorSize_(0),idxLastElement_(-1),
-      theElements_(0),ownData_(true),constReference_(VariableReference) {
+      theElements_(0),ownData_(true),allocator_(0),constReference_(VariableReference) {
     copy(other, from, to);
   }
 
@@ -180,7 +164,7 @@ namespace lti {
   genericVector<T>::genericVector(const genericVector<T>& other,
                                   const genericVector<int>& idx)
     : vectorSize_(0),idxLastElement_(-1),
-      theElements_(0),ownData_(true),constReference_(VariableReference) {
+      theElements_(0),ownData_(true),allocator_(0),constReference_(VariableReference) {
     copy(other, idx);
   }
 
@@ -188,7 +172,7 @@ namespace lti {
   template<typename T>
   genericVector<T>::genericVector(const std::vector<T>& other)
     : vectorSize_(0),idxLastElement_(-1),
-      theElements_(0),ownData_(true),constReference_(VariableReference) {
+      theElements_(0),ownData_(true),allocator_(0),constReference_(VariableReference) {
 
     if (other.size() <= 0) {
       return;
@@ -198,11 +182,7 @@ namespace lti {
     idxLastElement_ = vectorSize_-1;
     ownData_ = true;
 
-    theElements_ = new T[vectorSize_];
-
-    if (theElements_ == 0) { // allocation check
-      throw allocException();
-    }
+    theElements_ = internal::allocateElements<T>(vectorSize_,allocator_);
 
     // copy contents of other genericVector
     typename std::vector<T>::const_iterator it;
@@ -216,7 +196,7 @@ namespace lti {
   template<typename T>
   genericVector<T>::~genericVector() {
     if (ownData_) {
-      delete[] theElements_;
+      internal::releaseElements(theElements_,vectorSize_,allocator_);
     }
     theElements_ = 0;
     vectorSize_ = 0;
@@ -239,11 +219,7 @@ namespace lti {
       throw constReferenceException();
     }
 
-    T* newElements = new T[newSize];
-
-    if (newElements == 0) { // check memory allocation
-      throw allocException();
-    }
+    T* newElements = internal::allocateElements<T>(newSize,allocator_);
 
     if (newSize>0) {
       memcpy(newElements,theElements_,newSize*sizeof(T));
@@ -266,23 +242,26 @@ namespace lti {
       throw constReferenceException();
     }
 
-    vectorSize_ = theSize;
-    idxLastElement_ = theSize-1;
-
     if (ownData_) {
-      delete[] theElements_;
+      internal::releaseElements(theElements_,vectorSize_,allocator_);
     }
 
+    vectorSize_ = theSize;
+    idxLastElement_ = theSize-1;
+
     theElements_ = _data;
+    allocator_ = 0;
     ownData_ = false; // do not delete data!
     constReference_ = constRef;
   }
 
   // attach external memory region to this object
   template <typename T>
-  void genericVector<T>::attach(const int theSize, T* _data) {
+  void genericVector<T>::attach(const int theSize, T* _data,
+                                memoryAllocator* alloc) {
     useExternData(theSize,_data);
     ownData_ = true;
+    allocator_ = alloc;
   }
 
   // detach internal memory to an external 'receiver' genericVector
@@ -291,11 +270,12 @@ namespace lti {
     // receiver should know whether he owns data, so it is not
     // accidentally deleted
     if (ownData_) {
-      receiver.attach(vectorSize_,theElements_);
+      receiver.attach(vectorSize_,theElements_,allocator_);
     } else {
       receiver.useExternData(vectorSize_,theElements_);
     }
     ownData_ = false;
+    allocator_ = 0;
     allocate(0);
   }
 
@@ -329,6 +309,10 @@ namespace lti {
     tmpBool = ownData_;
     ownData_ = other.ownData_;
     other.ownData_ = tmpBool;
+
+    memoryAllocator* tmpAlloc = allocator_;
+    allocator_ = other.allocator_;
+    other.allocator_ = tmpAlloc;
   }
 
   template<typename T>
@@ -352,7 +336,7 @@ namespace lti {
 
     if (newSize <= 0) {
       if (ownData_) {
-        delete[] theElements_;
+        internal::releaseElements(theElements_,vectorSize_,allocator_);
       } else {
         ownData_ = true;
       }
@@ -364,11 +348,8 @@ namespace lti {
       return; // ready!!!
     }
 
-    newElements = new T[newSize];
-
-    if (newElements == 0) { // check memory allocation
-      throw allocException();
-    }
+    memoryAllocator* newAllocator;
+    newElements = internal::allocateElements<T>(newSize,newAllocator);
 
     if (resizeType==Copy || resizeType==CopyAndInit) {
       // old data should be copied
@@ -379,16 +360,17 @@ namespace lti {
       from = top;
     }
 
-    vectorSize_ = newSize;
-    idxLastElement_ = newSize-1;
-
     if (ownData_) {
-      delete[] theElements_;
+      internal::releaseElements(theElements_,vectorSize_,allocator_);
     } else {
       ownData_ = true;
     }
 
+    vectorSize_ = newSize;
+    idxLastElement_ = newSize-1;
+
     theElements_ = newElements;
+    allocator_ = newAllocator;
 
     if (resizeType==Init || resizeType==CopyAndInit) {
       fill(iniValue,from,idxLastElement_);
@@ -402,7 +384,7 @@ namespace lti {
     }
 
     if (ownData_) {
-      delete[] theElements_;
+      internal::releaseElements(theElements_,vectorSize_,allocator_);
     } else {
       ownData_ = true;
     }
@@ -519,7 +501,7 @@ namespace lti {
     } else {
       if (ownData_) {
         if (vectorSize_ != other.size()) {
-          delete[] theElements_;
+          internal::releaseElements(theElements_,vectorSize_,allocator_);
           theElements_ = 0;
         }
       } else {
@@ -532,11 +514,8 @@ namespace lti {
 
       if (vectorSize_ > 0) {
         if (isNull(theElements_)) {
-          theElements_ = new T[vectorSize_];
-
-          if (isNull(theElements_)) { // memory allocation check
-              throw allocException();
-          }
+          theElements_ =
+            internal::allocateElements<T>(vectorSize_,allocator_);
         }
 
         memcpy(theElements_,other.data(),sizeof(T)*vectorSize_);
@@ -587,7 +566,7 @@ namespace lti {
     } else {
       if (ownData_) {
         if (vectorSize_ != nsize) {
-          delete[] theElements_;
+          internal::releaseElements(theElements_,vectorSize_,allocator_);
           theElements_ = 0;
         }
       } else {
@@ -601,11 +580,7 @@ namespace lti {
 
     if (vectorSize_ > 0) {
       if (isNull(theElements_)) {
-        theElements_ = new T[vectorSize_];
-
-        if (isNull(theElements_)) { // memory allocation check
-          throw allocException();
-        }
+        theElements_ = internal::allocateElements<T>(vectorSize_,allocator_);
       }
 
       memcpy(theElements_,&other.at(f),sizeof(T)*vectorSize_);
@@ -638,7 +613,7 @@ namespace lti {
     } else {
       if (ownData_) {
         if (vectorSize_ != idx.size()) {
-          delete[] theElements_;
+          internal::releaseElements(theElements_,vectorSize_,allocator_);
           theElements_ = 0;
         }
       } else {
@@ -652,11 +627,7 @@ namespace lti {
 
     if (vectorSize_ > 0) {
       if (isNull(theElements_)) {
-        theElements_ = new T[vectorSize_];
-
-        if (isNull(theElements_)) { // memory allocation check
-          throw allocException();
-        }
+        theElements_ = internal::allocateElements<T>(vectorSize_,allocator_);
       }
       typename genericVector<T>::iterator it=begin();
       typename genericVector<T>::iterator eit=end();
@@ -934,7 +905,6 @@ namespace lti {
   template<typename T>
   bool genericVector<T>::write(ioHandler& handler,const bool complete) const {
 
-    int i;
     bool b = true;
 
     if (complete) {
@@ -950,13 +920,7 @@ namespace lti {
       handler.writeKeyValueSeparator(); //
                                         //
       handler.writeBegin();             // Data             (2)
-      if (size() > 0) {                 //
-        for (i=0;i<idxLastElement_;++i){//
-          lti::write(handler,at(i));    //
-          handler.writeDataSeparator(); //
-        }                               //
-        lti::write(handler,at(i));      //
-      }                                 //
+      lti::writeArray(handler,theElements_,vectorSize_);
       handler.writeEnd();               // Data             (1)
                                         //
       handler.writeEnd();               // Data block scope (0)
@@ -976,7 +940,7 @@ namespace lti {
   bool genericVector<T>::read(ioHandler& handler,const bool complete) {
 
 
-    int i,sz;
+    int sz;
     bool b = true;
 
     if (complete) {
@@ -994,14 +958,7 @@ namespace lti {
         handler.readKeyValueSeparator();     //
         handler.readBegin();                 // Data       (2)
         allocate(sz);                        //
-        if (sz > 0) {                        //
-          sz--;                              //
-          for (i=0;i<sz;++i) {               // 
-            lti::read(handler,at(i));        //
-            handler.readKeyValueSeparator(); //
-          }                                  //
-          lti::read(handler,at(i));          //
-        }                                    //
+        lti::readArray(handler,theElements_,sz);
         handler.readEnd();                   // Data       (1)
       }                                      //
                                              //
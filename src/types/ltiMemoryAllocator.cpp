@@ -0,0 +1,445 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiMemoryAllocator.cpp
+ *         Contains the class lti::memoryAllocator, which provides the memory
+ *         blocks of vectors and matrices, and its implementations
+ *         lti::heapAllocator and lti::poolAllocator.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#include "ltiMemoryAllocator.h"
+#include "ltiMutex.h"
+
+#include <cstdlib>
+#include <vector>
+
+#ifdef _LTI_WIN32
+#  include <windows.h>
+#  include <malloc.h>
+#else
+#  include <pthread.h>
+#endif
+
+namespace lti {
+
+  namespace {
+
+    /*
+     * Request an aligned block to the system
+     */
+    void* alignedMalloc(const size_t bytes) {
+      void* ptr = 0;
+#ifdef _LTI_WIN32
+      ptr = _aligned_malloc(bytes,memoryAllocator::Alignment);
+#else
+      if (posix_memalign(&ptr,memoryAllocator::Alignment,bytes) != 0) {
+        ptr = 0;
+      }
+#endif
+      if (ptr == 0) {
+        throw allocException();
+      }
+      return ptr;
+    }
+
+    /*
+     * Return a block obtained with alignedMalloc() to the system
+     */
+    void alignedFree(void* ptr) {
+#ifdef _LTI_WIN32
+      _aligned_free(ptr);
+#else
+      free(ptr);
+#endif
+    }
+
+    /*
+     * The counters of a thread cache are written only by its own thread,
+     * but getStatistics() reads them from any thread.  They are therefore
+     * loaded and stored atomically, without any ordering, which costs no
+     * more than a plain load or store on the usual platforms.
+     */
+    template<typename T>
+    inline T loadCounter(const T& counter) {
+#ifdef _LTI_WIN32
+      return *static_cast<const volatile T*>(&counter);
+#else
+      return __atomic_load_n(&counter,__ATOMIC_RELAXED);
+#endif
+    }
+
+    /*
+     * Store a counter of a thread cache (see loadCounter())
+     */
+    template<typename T>
+    inline void storeCounter(T& counter,const T value) {
+#ifdef _LTI_WIN32
+      *static_cast<volatile T*>(&counter) = value;
+#else
+      __atomic_store_n(&counter,value,__ATOMIC_RELAXED);
+#endif
+    }
+
+    /*
+     * Add delta to a counter of a thread cache.  Only the thread owning
+     * the counter may call this.
+     */
+    template<typename T>
+    inline void addCounter(T& counter,const T delta) {
+      storeCounter(counter,static_cast<T>(loadCounter(counter)+delta));
+    }
+
+    /*
+     * Add the counters of b to a.  The peaks are not accumulated.
+     */
+    void accumulate(memoryAllocator::statistics& a,
+                    const memoryAllocator::statistics& b) {
+      a.allocations       += loadCounter(b.allocations);
+      a.deallocations     += loadCounter(b.deallocations);
+      a.reused            += loadCounter(b.reused);
+      a.systemAllocations += loadCounter(b.systemAllocations);
+      a.bytesInUse        += loadCounter(b.bytesInUse);
+      a.bytesCached       += loadCounter(b.bytesCached);
+    }
+
+    /*
+     * The default allocator.  It is never destroyed, since containers
+     * with static storage may release their memory at any time during the
+     * termination of the program.
+     */
+    memoryAllocator& defaultPool() {
+      static poolAllocator* thePool = new poolAllocator;
+      return *thePool;
+    }
+  }
+
+  // --------------------------------------------------------
+  //                     memoryAllocator
+  // --------------------------------------------------------
+
+  const int memoryAllocator::Alignment;
+
+  memoryAllocator* memoryAllocator::default_ = 0;
+
+  memoryAllocator::statistics::statistics()
+    : allocations(0),deallocations(0),reused(0),systemAllocations(0),
+      bytesInUse(0),peakBytesInUse(0),bytesCached(0) {
+  }
+
+  memoryAllocator::memoryAllocator() {
+  }
+
+  memoryAllocator::~memoryAllocator() {
+  }
+
+  void memoryAllocator::releaseCache() {
+  }
+
+  memoryAllocator& memoryAllocator::getDefault() {
+    if (default_ == 0) {
+      default_ = &defaultPool();
+    }
+    return *default_;
+  }
+
+  void memoryAllocator::setDefault(memoryAllocator& alloc) {
+    default_ = &alloc;
+  }
+
+  // --------------------------------------------------------
+  //                      heapAllocator
+  // --------------------------------------------------------
+
+  heapAllocator::heapAllocator() : memoryAllocator(), lock_(new mutex) {
+  }
+
+  heapAllocator::~heapAllocator() {
+    delete lock_;
+  }
+
+  void* heapAllocator::allocate(const size_t bytes) {
+    void* ptr = alignedMalloc(bytes);
+    lock_->lock();
+    ++stats_.allocations;
+    ++stats_.systemAllocations;
+    stats_.bytesInUse += bytes;
+    if (stats_.bytesInUse > stats_.peakBytesInUse) {
+      stats_.peakBytesInUse = stats_.bytesInUse;
+    }
+    lock_->unlock();
+    return ptr;
+  }
+
+  void heapAllocator::deallocate(void* ptr,const size_t bytes) {
+    alignedFree(ptr);
+    lock_->lock();
+    ++stats_.deallocations;
+    stats_.bytesInUse -= bytes;
+    lock_->unlock();
+  }
+
+  void heapAllocator::getStatistics(statistics& stats) const {
+    lock_->lock();
+    stats = stats_;
+    lock_->unlock();
+  }
+
+  // --------------------------------------------------------
+  //                      poolAllocator
+  // --------------------------------------------------------
+
+  /*
+   * The released blocks of each size class are kept in a singly linked
+   * list, whose links are stored in the first bytes of the blocks.
+   *
+   * stats.bytesInUse is the number of bytes allocated minus the number of
+   * bytes released by this thread, which is negative if the thread
+   * released blocks of other threads.  Only the sum over all threads is
+   * meaningful.  stats.peakBytesInUse is not used.
+   */
+  struct poolAllocator::threadCache {
+    threadCache(poolAllocator* theOwner,const int numClasses)
+      : owner(theOwner),heads(numClasses,static_cast<void*>(0)),
+        cachedBytes(0),prev(0),next(0) {
+    }
+
+    poolAllocator* owner;
+    std::vector<void*> heads;
+    size_t cachedBytes;
+    statistics stats;
+    threadCache* prev;
+    threadCache* next;
+  };
+
+  struct poolAllocator::threadKey {
+#ifdef _LTI_WIN32
+    DWORD key;
+#else
+    pthread_key_t key;
+#endif
+  };
+
+  poolAllocator::poolAllocator(const size_t maxCachedBytes,
+                               const size_t maxPooledSize)
+    : memoryAllocator(),maxCachedBytes_(maxCachedBytes),
+      key_(new threadKey),lock_(new mutex),caches_(0),peak_(0) {
+
+    // round the maximal pooled size to a power of two, at least 1 KB
+    int m = 10;
+    while ((m < 30) && ((size_t(1) << m) < maxPooledSize)) {
+      ++m;
+    }
+    maxPooledSize_ = size_t(1) << m;
+    numClasses_ = 16 + 4*(m-10);
+
+#ifdef _LTI_WIN32
+    // the caches of finished threads are released by the destructor only
+    key_->key = TlsAlloc();
+#else
+    pthread_key_create(&key_->key,&poolAllocator::threadExit);
+#endif
+  }
+
+  poolAllocator::~poolAllocator() {
+#ifdef _LTI_WIN32
+    TlsFree(key_->key);
+#else
+    pthread_key_delete(key_->key);
+#endif
+    while (caches_ != 0) {
+      retire(caches_);
+    }
+    delete lock_;
+    delete key_;
+  }
+
+  size_t poolAllocator::getMaxCachedBytes() const {
+    return maxCachedBytes_;
+  }
+
+  size_t poolAllocator::getMaxPooledSize() const {
+    return maxPooledSize_;
+  }
+
+  int poolAllocator::sizeClass(const size_t bytes) const {
+    if (bytes <= 1024) {
+      // multiples of 64 bytes
+      return static_cast<int>((bytes+63)/64) - 1;
+    }
+
+    // four classes in (2^p,2^(p+1)], with sizes 2^p + k*2^(p-2)
+    const size_t b = bytes-1;
+    int p = 10;
+    while ((b >> (p+1)) != 0) {
+      ++p;
+    }
+    const int k = static_cast<int>(b >> (p-2)) - 3;
+    return 16 + 4*(p-10) + (k-1);
+  }
+
+  size_t poolAllocator::classSize(const int sizeClass) const {
+    if (sizeClass < 16) {
+      return size_t(sizeClass+1)*64;
+    }
+    const int q = sizeClass-16;
+    const int p = 10 + q/4;
+    const int k = q%4 + 1;
+    return (size_t(1) << p) + (size_t(k) << (p-2));
+  }
+
+  poolAllocator::threadCache& poolAllocator::getCache() {
+#ifdef _LTI_WIN32
+    threadCache* cache = static_cast<threadCache*>(TlsGetValue(key_->key));
+#else
+    threadCache* cache =
+      static_cast<threadCache*>(pthread_getspecific(key_->key));
+#endif
+    if (cache == 0) {
+      cache = new threadCache(this,numClasses_);
+#ifdef _LTI_WIN32
+      TlsSetValue(key_->key,cache);
+#else
+      pthread_setspecific(key_->key,cache);
+#endif
+      lock_->lock();
+      cache->next = caches_;
+      if (caches_ != 0) {
+        caches_->prev = cache;
+      }
+      caches_ = cache;
+      lock_->unlock();
+    }
+    return *cache;
+  }
+
+  void poolAllocator::threadExit(void* cache) {
+    threadCache* theCache = static_cast<threadCache*>(cache);
+    theCache->owner->retire(theCache);
+  }
+
+  void poolAllocator::retire(threadCache* cache) {
+    lock_->lock();
+    if (cache->prev != 0) {
+      cache->prev->next = cache->next;
+    } else {
+      caches_ = cache->next;
+    }
+    if (cache->next != 0) {
+      cache->next->prev = cache->prev;
+    }
+    accumulate(retired_,cache->stats);
+    lock_->unlock();
+
+    for (unsigned int c=0;c<cache->heads.size();++c) {
+      void* block = cache->heads[c];
+      while (block != 0) {
+        void* next = *static_cast<void**>(block);
+        alignedFree(block);
+        block = next;
+      }
+    }
+    delete cache;
+  }
+
+  void* poolAllocator::allocate(const size_t bytes) {
+    threadCache& cache = getCache();
+    void* block;
+    size_t size;
+
+    if (bytes > maxPooledSize_) {
+      size = bytes;
+      block = alignedMalloc(size);
+      addCounter(cache.stats.systemAllocations,uint64(1));
+    } else {
+      const int c = sizeClass(bytes);
+      size = classSize(c);
+      block = cache.heads[c];
+      if (block != 0) {
+        cache.heads[c] = *static_cast<void**>(block);
+        storeCounter(cache.cachedBytes,cache.cachedBytes-size);
+        addCounter(cache.stats.reused,uint64(1));
+      } else {
+        block = alignedMalloc(size);
+        addCounter(cache.stats.systemAllocations,uint64(1));
+      }
+    }
+
+    addCounter(cache.stats.allocations,uint64(1));
+    addCounter(cache.stats.bytesInUse,static_cast<int64>(size));
+    return block;
+  }
+
+  void poolAllocator::deallocate(void* ptr,const size_t bytes) {
+    threadCache& cache = getCache();
+    addCounter(cache.stats.deallocations,uint64(1));
+
+    if (bytes > maxPooledSize_) {
+      addCounter(cache.stats.bytesInUse,-static_cast<int64>(bytes));
+      alignedFree(ptr);
+      return;
+    }
+
+    const int c = sizeClass(bytes);
+    const size_t size = classSize(c);
+    addCounter(cache.stats.bytesInUse,-static_cast<int64>(size));
+    if (cache.cachedBytes+size > maxCachedBytes_) {
+      alignedFree(ptr);
+    } else {
+      *static_cast<void**>(ptr) = cache.heads[c];
+      cache.heads[c] = ptr;
+      storeCounter(cache.cachedBytes,cache.cachedBytes+size);
+    }
+  }
+
+  void poolAllocator::getStatistics(statistics& stats) const {
+    lock_->lock();
+    stats = retired_;
+    for (const threadCache* cache=caches_;cache!=0;cache=cache->next) {
+      accumulate(stats,cache->stats);
+      stats.bytesCached += loadCounter(cache->cachedBytes);
+    }
+    if (stats.bytesInUse > peak_) {
+      peak_ = stats.bytesInUse;
+    }
+    stats.peakBytesInUse = peak_;
+    lock_->unlock();
+  }
+
+  void poolAllocator::releaseCache() {
+    threadCache& cache = getCache();
+    for (unsigned int c=0;c<cache.heads.size();++c) {
+      void* block = cache.heads[c];
+      while (block != 0) {
+        void* next = *static_cast<void**>(block);
+        alignedFree(block);
+        block = next;
+      }
+      cache.heads[c] = 0;
+    }
+    storeCounter(cache.cachedBytes,size_t(0));
+  }
+}
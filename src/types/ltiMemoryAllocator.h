@@ -0,0 +1,495 @@
+/*
+ * Copyright (C) 2026
+ * LTI-Lib contributors
+ *
+ * This file is part of the LTI-Computer Vision Library (LTI-Lib)
+ *
+ * The LTI-Lib is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License (LGPL)
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * The LTI-Lib is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the LTI-Lib; see the file LICENSE.  If
+ * not, write to the Free Software Foundation, Inc., 59 Temple Place -
+ * Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * \file   ltiMemoryAllocator.h
+ *         Contains the class lti::memoryAllocator, which provides the memory
+ *         blocks of vectors and matrices, and its implementations
+ *         lti::heapAllocator and lti::poolAllocator.
+ * \author LTI
+ * \date   16.10.2026
+ *
+ * $Id$
+ */
+
+#ifndef _LTI_MEMORY_ALLOCATOR_H_
+#define _LTI_MEMORY_ALLOCATOR_H_
+
+#include "ltiTypes.h"
+#include "ltiAllocException.h"
+#include <cstddef>
+#include <new>
+
+namespace lti {
+
+  class mutex;
+
+  /**
+   * Allocation policy for the data of vectors and matrices.
+   *
+   * All memory blocks owned by lti::genericVector and lti::genericMatrix
+   * (and therefore by all vectors, matrices, images and channels) are
+   * obtained from a memoryAllocator.  Each container remembers the
+   * allocator that provided its block, so that the block is always
+   * returned to it, even if the default allocator is changed in between.
+   *
+   * The blocks returned by all allocators of the library are aligned to
+   * memoryAllocator::Alignment bytes, which is enough for any SIMD
+   * instruction set and avoids sharing cache lines between the data of
+   * different containers.
+   *
+   * The default allocator is a lti::poolAllocator.  It can be replaced
+   * with setDefault(), for instance with a lti::heapAllocator to debug
+   * memory problems with external tools.  The given allocator must exist
+   * as long as any block allocated with it.
+   *
+   * Memory given to the containers with attach() without an allocator
+   * must have been allocated with new[] and is released with delete[], as
+   * always.  Memory given with useExternData() is never released by the
+   * containers.
+   */
+  class memoryAllocator {
+  public:
+    /**
+     * Alignment in bytes of all blocks returned by allocate().
+     */
+    static const int Alignment = 64;
+
+    /**
+     * Allocation statistics.
+     *
+     * All byte counts include the rounding of the requested sizes done by
+     * the allocator.
+     */
+    struct statistics {
+      /**
+       * Default constructor.  All counters are set to zero.
+       */
+      statistics();
+
+      /**
+       * Number of calls to allocate().
+       */
+      uint64 allocations;
+
+      /**
+       * Number of calls to deallocate().
+       */
+      uint64 deallocations;
+
+      /**
+       * Number of allocations served from previously released blocks,
+       * without requesting new memory to the system.
+       */
+      uint64 reused;
+
+      /**
+       * Number of blocks requested to the system.
+       */
+      uint64 systemAllocations;
+
+      /**
+       * Bytes in blocks currently given to the containers.
+       */
+      int64 bytesInUse;
+
+      /**
+       * Maximum value reached by bytesInUse.  The poolAllocator counts
+       * without synchronizing the threads, and cannot check the total on
+       * each allocation.  It reports the largest bytesInUse seen by its
+       * getStatistics() so far, which is a lower bound.
+       */
+      int64 peakBytesInUse;
+
+      /**
+       * Bytes in released blocks kept for later use.
+       */
+      int64 bytesCached;
+    };
+
+    /**
+     * Default constructor
+     */
+    memoryAllocator();
+
+    /**
+     * Destructor
+     */
+    virtual ~memoryAllocator();
+
+    /**
+     * Allocate a block of the given size.
+     *
+     * @param bytes size of the block in bytes (greater than zero)
+     * @return pointer to the block, aligned to Alignment bytes.
+     * @throw allocException if the memory could not be allocated
+     */
+    virtual void* allocate(const size_t bytes) = 0;
+
+    /**
+     * Release a block returned by allocate().
+     *
+     * @param ptr pointer to the block
+     * @param bytes size given to allocate() for this block
+     */
+    virtual void deallocate(void* ptr,const size_t bytes) = 0;
+
+    /**
+     * Get the allocation statistics.
+     *
+     * While other threads are allocating memory, the values are just
+     * approximations.
+     */
+    virtual void getStatistics(statistics& stats) const = 0;
+
+    /**
+     * Return the memory kept for later use to the system, as far as
+     * possible.  The default implementation does nothing.
+     */
+    virtual void releaseCache();
+
+    /**
+     * Allocator used for all new blocks of vectors and matrices.
+     */
+    static memoryAllocator& getDefault();
+
+    /**
+     * Set the allocator used for all new blocks of vectors and matrices.
+     *
+     * The blocks allocated before keep being released with their own
+     * allocator, which therefore must not be destroyed before them.
+     */
+    static void setDefault(memoryAllocator& alloc);
+
+  private:
+    /**
+     * Allocators are not copyable
+     */
+    memoryAllocator(const memoryAllocator&);
+
+    /**
+     * Allocators are not copyable
+     */
+    memoryAllocator& operator=(const memoryAllocator&);
+
+    /**
+     * Current default allocator
+     */
+    static memoryAllocator* default_;
+  };
+
+  /**
+   * Allocator that requests each block directly to the system.
+   *
+   * This is the behaviour of the library before the introduction of the
+   * memory allocators, except for the alignment of the blocks.
+   */
+  class heapAllocator : public memoryAllocator {
+  public:
+    /**
+     * Default constructor
+     */
+    heapAllocator();
+
+    /**
+     * Destructor
+     */
+    virtual ~heapAllocator();
+
+    /**
+     * Allocate a block of the given size.
+     */
+    virtual void* allocate(const size_t bytes);
+
+    /**
+     * Release a block returned by allocate().
+     */
+    virtual void deallocate(void* ptr,const size_t bytes);
+
+    /**
+     * Get the allocation statistics.
+     */
+    virtual void getStatistics(statistics& stats) const;
+
+  private:
+    /**
+     * Counters, protected by lock_
+     */
+    statistics stats_;
+
+    /**
+     * Protects stats_
+     */
+    mutex* lock_;
+  };
+
+  /**
+   * Thread-local pool of memory blocks grouped in size classes.
+   *
+   * The requested sizes are rounded up to a size class: multiples of 64
+   * bytes up to 1 KB, and four classes per power of two above it (which
+   * wastes at most 25% of the block).  Released blocks are not returned
+   * to the system, but kept in a list per size class, from which the
+   * next allocations of that class are served.  Since algorithms usually
+   * create temporary containers of the same sizes over and over (e.g.
+   * for each frame of a video), almost all allocations are served from
+   * these lists after the first iterations.
+   *
+   * Each thread has its own lists, so that no synchronization is required
+   * to allocate or release a block.  A block released by another thread
+   * than the one that allocated it just goes into the lists of the
+   * releasing thread.  The lists of a thread are returned to the system
+   * when the thread finishes.
+   *
+   * Blocks larger than getMaxPooledSize() are always requested to and
+   * returned to the system.  The memory cached by each thread is limited
+   * to getMaxCachedBytes(); blocks released beyond that limit are
+   * returned to the system as well.
+   */
+  class poolAllocator : public memoryAllocator {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param maxCachedBytes maximal number of bytes kept in the lists of
+     *                       each thread.
+     * @param maxPooledSize blocks larger than this are not pooled.  The
+     *                      value is rounded up to the next power of two
+     *                      and must be at least 1 KB.
+     */
+    poolAllocator(const size_t maxCachedBytes = 64*1024*1024,
+                  const size_t maxPooledSize = 16*1024*1024);
+
+    /**
+     * Destructor.
+     *
+     * Returns all cached blocks to the system.  Blocks still in use must
+     * not be released after the destruction of the allocator.
+     */
+    virtual ~poolAllocator();
+
+    /**
+     * Allocate a block of the given size.
+     */
+    virtual void* allocate(const size_t bytes);
+
+    /**
+     * Release a block returned by allocate().
+     */
+    virtual void deallocate(void* ptr,const size_t bytes);
+
+    /**
+     * Get the allocation statistics, accumulated over all threads.
+     *
+     * Blocks can be released by other threads than the ones that
+     * allocated them, so only the totals are available, not the bytes in
+     * use by each thread.  See statistics::peakBytesInUse for the peak.
+     */
+    virtual void getStatistics(statistics& stats) const;
+
+    /**
+     * Return the blocks cached by the calling thread to the system.
+     */
+    virtual void releaseCache();
+
+    /**
+     * Maximal number of bytes cached by each thread.
+     */
+    size_t getMaxCachedBytes() const;
+
+    /**
+     * Size of the largest pooled blocks.
+     */
+    size_t getMaxPooledSize() const;
+
+  private:
+    /**
+     * Per-thread lists and counters
+     */
+    struct threadCache;
+
+    /**
+     * Thread specific storage key
+     */
+    struct threadKey;
+
+    /**
+     * Lists of the calling thread (created if necessary)
+     */
+    threadCache& getCache();
+
+    /**
+     * Release all blocks of the given cache and remove it from the
+     * registry of caches.  Its counters are kept in retired_.
+     */
+    void retire(threadCache* cache);
+
+    /**
+     * Called when a thread with a cache finishes
+     */
+    static void threadExit(void* cache);
+
+    /**
+     * Index of the size class for the given size
+     */
+    int sizeClass(const size_t bytes) const;
+
+    /**
+     * Size in bytes of the blocks of a size class
+     */
+    size_t classSize(const int sizeClass) const;
+
+    /**
+     * Number of size classes
+     */
+    int numClasses_;
+
+    /**
+     * Bytes cached by each thread at most
+     */
+    size_t maxCachedBytes_;
+
+    /**
+     * Size of the largest pooled blocks
+     */
+    size_t maxPooledSize_;
+
+    /**
+     * Thread specific storage key for the caches
+     */
+    threadKey* key_;
+
+    /**
+     * Protects the registry of caches, retired_ and peak_
+     */
+    mutex* lock_;
+
+    /**
+     * First cache of the doubly linked registry of all caches
+     */
+    threadCache* caches_;
+
+    /**
+     * Counters of the caches of finished threads, protected by lock_
+     */
+    statistics retired_;
+
+    /**
+     * Largest bytesInUse computed by getStatistics(), protected by lock_
+     */
+    mutable int64 peak_;
+  };
+
+  namespace internal {
+
+    /**
+     * Indicates if the elements of type T can be left uninitialized after
+     * the allocation, and need no destruction.  This holds for the
+     * fundamental types; all other types are constructed and destroyed
+     * in place, as new[] and delete[] would do.
+     */
+    template<typename T>
+    struct trivialElements {
+      enum { value = false };
+    };
+
+    template<> struct trivialElements<char>   { enum { value = true }; };
+    template<> struct trivialElements<byte>   { enum { value = true }; };
+    template<> struct trivialElements<ubyte>  { enum { value = true }; };
+    template<> struct trivialElements<int16>  { enum { value = true }; };
+    template<> struct trivialElements<uint16> { enum { value = true }; };
+    template<> struct trivialElements<int32>  { enum { value = true }; };
+    template<> struct trivialElements<uint32> { enum { value = true }; };
+    template<> struct trivialElements<int64>  { enum { value = true }; };
+    template<> struct trivialElements<uint64> { enum { value = true }; };
+    template<> struct trivialElements<float>  { enum { value = true }; };
+    template<> struct trivialElements<double> { enum { value = true }; };
+    template<> struct trivialElements<bool>   { enum { value = true }; };
+
+    /**
+     * Construction and destruction of the elements of a block
+     */
+    template<typename T,bool trivial>
+    struct elementLifetime {
+      static void construct(T* data,const int n) {
+        int i=0;
+        try {
+          for (;i<n;++i) {
+            new (data+i) T;
+          }
+        } catch (...) {
+          destroy(data,i);
+          throw;
+        }
+      }
+      static void destroy(T* data,const int n) {
+        for (int i=0;i<n;++i) {
+          data[i].~T();
+        }
+      }
+    };
+
+    template<typename T>
+    struct elementLifetime<T,true> {
+      static void construct(T*,const int) {}
+      static void destroy(T*,const int) {}
+    };
+
+    /**
+     * Allocate a block of \p n elements with the default allocator,
+     * which is returned in \p alloc.  For \p n <= 0 the null pointer is
+     * returned.
+     */
+    template<typename T>
+    inline T* allocateElements(const int n,memoryAllocator*& alloc) {
+      if (n <= 0) {
+        alloc = 0;
+        return 0;
+      }
+      alloc = &memoryAllocator::getDefault();
+      T* data = static_cast<T*>(alloc->allocate(n*sizeof(T)));
+      try {
+        elementLifetime<T,trivialElements<T>::value>::construct(data,n);
+      } catch (...) {
+        alloc->deallocate(data,n*sizeof(T));
+        throw;
+      }
+      return data;
+    }
+
+    /**
+     * Release a block of \p n elements.  If \p alloc is null, the block
+     * was allocated with new[].
+     */
+    template<typename T>
+    inline void releaseElements(T* data,const int n,memoryAllocator* alloc) {
+      if (alloc == 0) {
+        delete[] data;
+      } else if (data != 0) {
+        elementLifetime<T,trivialElements<T>::value>::destroy(data,n);
+        alloc->deallocate(data,n*sizeof(T));
+      }
+    }
+  }
+}
+
+#endif